@@ -40,6 +40,8 @@ public:
 private:
     AssetCache::Error WaitRequest();
     AssetCache::Error CheckStatusSynchronously();
+    AssetCache::Error QueryStoredChunksSynchronously(const AssetCache::CacheItemKey& key, const AssetCache::CachedItemValue::FileChunks& chunks, UnorderedSet<MD5::MD5Digest, AssetCache::ContentChunker::DigestHash>& storedChunks);
+    AssetCache::Error SendAddRequestSynchronously(const AssetCache::CacheItemKey& key, const AssetCache::CachedItemValue& value, const AssetCache::CachedItemValue::FileChunks& chunks, const UnorderedSet<MD5::MD5Digest, AssetCache::ContentChunker::DigestHash>& storedChunks);
     void ProcessNetwork();
 
     //ClientNetProxyListener
@@ -47,6 +49,7 @@ private:
     void OnReceivedFromCache(const AssetCache::CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const Vector<uint8>& chunkData) override;
     void OnRemovedFromCache(const AssetCache::CacheItemKey& key, bool removed) override;
     void OnCacheCleared(bool cleared) override;
+    void OnChunksQueryReceived(const AssetCache::CacheItemKey& key, const Vector<uint8>& storedFlags) override;
     void OnServerStatusReceived() override;
     void OnIncorrectPacketReceived(AssetCache::IncorrectPacketType) override;
     void OnClientProxyStateChanged() override;
@@ -117,11 +120,13 @@ private:
         void Reset()
         {
             serializedData->Truncate(0);
+            storedChunkFlags.clear();
             chunksSent = 0;
             chunksOverall = 0;
         }
 
         ScopedPtr<DynamicMemoryFile> serializedData;
+        Vector<uint8> storedChunkFlags;
         uint32 chunksSent = 0;
         uint32 chunksOverall = 0;
     };
@@ -138,6 +143,8 @@ private:
         uint32 addRequestsFailedCount = 0;
         uint32 addRequestsTimeoutCount = 0;
         uint32 addRequestsSucceedCount = 0;
+        uint64 addDataSize = 0; // size of added values
+        uint64 addSentSize = 0; // size of data sent to server after deduplication of chunks
 
         uint32 incorrectPacketsCount = 0;
     };
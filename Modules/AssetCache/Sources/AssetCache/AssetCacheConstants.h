@@ -28,6 +28,8 @@ enum ePacketID : uint8
     PACKET_REMOVE_RESPONSE,
     PACKET_CLEAR_REQUEST,
     PACKET_CLEAR_RESPONSE,
+    PACKET_CHUNKS_QUERY_REQUEST,
+    PACKET_CHUNKS_QUERY_RESPONSE,
     PACKET_COUNT
 };
 
@@ -219,5 +219,36 @@ public:
     bool cleared = false;
 };
 
+//////////////////////////////////////////////////////////////////////////
+// Asks server which chunks of data are already stored, so only missing chunks are sent with add request
+class ChunksQueryRequestPacket : public CachePacket
+{
+public:
+    ChunksQueryRequestPacket();
+    ChunksQueryRequestPacket(const CacheItemKey& key, const Vector<MD5::MD5Digest>& digests);
+
+protected:
+    bool DeserializeFromBuffer(File* file) override;
+
+public:
+    CacheItemKey key;
+    Vector<MD5::MD5Digest> digests;
+};
+
+//////////////////////////////////////////////////////////////////////////
+class ChunksQueryResponsePacket : public CachePacket
+{
+public:
+    ChunksQueryResponsePacket();
+    ChunksQueryResponsePacket(const CacheItemKey& key, const Vector<uint8>& storedFlags);
+
+protected:
+    bool DeserializeFromBuffer(File* file) override;
+
+public:
+    CacheItemKey key;
+    Vector<uint8> storedFlags; // one flag for each queried digest
+};
+
 } // end of namespace AssetCache
 } // end of namespace DAVA
@@ -1,9 +1,12 @@
 #ifndef __DAVAENGINE_ASSET_CACHE_CACHED_ITEM_VALUE_H__
 #define __DAVAENGINE_ASSET_CACHE_CACHED_ITEM_VALUE_H__
 
+#include "AssetCache/ContentChunker.h"
+
 #include "Base/BaseTypes.h"
 #include "Base/Data.h"
 #include "FileSystem/FilePath.h"
+#include "Functional/Function.h"
 #include "Utils/MD5.h"
 
 namespace DAVA
@@ -35,6 +38,8 @@ public:
         uint64 filesDataSize = 0;
     };
 
+    using FileChunks = Map<String, Vector<ContentChunker::Chunk>>;
+
 public:
     CachedItemValue() = default;
     ~CachedItemValue();
@@ -58,13 +63,29 @@ public:
     bool Serialize(File* file) const;
     bool Deserialize(File* file);
 
+    /** Split data of files into content defined chunks. Value should be fetched. */
+    FileChunks SplitIntoChunks() const;
+
+    /**
+        Serialize value with data of chunks, that are unknown for receiver.
+        Known chunks and repeated chunks of value are written as digests only.
+    */
+    bool SerializeChunked(File* file, const FileChunks& chunks, const Function<bool(const MD5::MD5Digest&)>& isChunkKnown) const;
+
+    /** Deserialize value written by SerializeChunked. `readKnownChunk` should read `size` bytes of known chunk into `data`. */
+    bool DeserializeChunked(File* file, const Function<bool(const MD5::MD5Digest&, uint8* data, uint32 size)>& readKnownChunk);
+
     bool operator==(const CachedItemValue& right) const;
 
     bool Fetch(const FilePath& folder);
+    bool Fetch(const Function<bool(const String& name, Vector<uint8>& data)>& loadData);
     void Free();
 
     size_type GetItemCount() const;
 
+    /** Data of file with given name, nullptr if there is no such file or value is not fetched. */
+    const Vector<uint8>* GetFileData(const String& name) const;
+
     bool ExportToFolder(const FilePath& folder) const;
     bool ExportToFile(const FilePath& filePath) const;
 
@@ -77,6 +98,9 @@ public:
 private:
     ValueData LoadFile(const FilePath& pathname);
 
+    bool SerializeDescription(File* file) const;
+    bool DeserializeDescription(File* file);
+
     bool IsDataLoaded(const ValueData& data) const;
 
 private:
@@ -3,6 +3,8 @@
 #include "AssetCache/Connection.h"
 #include "AssetCache/CacheItemKey.h"
 
+#include <Utils/MD5.h>
+
 #include <Base/BaseTypes.h>
 #include <Network/IChannel.h>
 #include <Network/Base/AddressResolver.h>
@@ -30,6 +32,7 @@ public:
     virtual void OnReceivedFromCache(const CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const Vector<uint8>& chunkData){};
     virtual void OnRemovedFromCache(const CacheItemKey& key, bool removed){};
     virtual void OnCacheCleared(bool cleared){};
+    virtual void OnChunksQueryReceived(const CacheItemKey& key, const Vector<uint8>& storedFlags){};
     virtual void OnServerStatusReceived(){};
     virtual void OnIncorrectPacketReceived(IncorrectPacketType){};
 };
@@ -56,6 +59,7 @@ public:
     bool RequestWarmingUp(const CacheItemKey& key);
     bool RequestRemoveData(const CacheItemKey& key);
     bool RequestClearCache();
+    bool RequestChunksQuery(const CacheItemKey& key, const Vector<MD5::MD5Digest>& digests);
 
     Connection* GetConnection() const;
 
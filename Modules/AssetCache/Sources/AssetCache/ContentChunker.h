@@ -0,0 +1,42 @@
+#pragma once
+
+#include <Base/BaseTypes.h>
+#include <Base/Hash.h>
+#include <Utils/MD5.h>
+
+namespace DAVA
+{
+namespace AssetCache
+{
+/**
+    Content defined chunking of data.
+    Chunk boundaries are found by rolling gear hash of data, so they depend on local content only:
+    insertion or removal of bytes moves boundaries near the change, all other chunks keep their digests.
+    It allows to find identical parts of files even if they are shifted, e.g. in textures converted for different GPUs.
+*/
+namespace ContentChunker
+{
+static const uint32 MIN_CHUNK_SIZE = 2 * 1024;
+static const uint32 AVERAGE_CHUNK_SIZE = 8 * 1024;
+static const uint32 MAX_CHUNK_SIZE = 64 * 1024;
+
+struct Chunk
+{
+    MD5::MD5Digest digest;
+    uint32 offset = 0;
+    uint32 size = 0;
+};
+
+struct DigestHash
+{
+    size_t operator()(const MD5::MD5Digest& digest) const
+    {
+        return BufferHash(digest.digest.data(), static_cast<uint32>(digest.digest.size()));
+    }
+};
+
+/** Split data into chunks with sizes in range [MIN_CHUNK_SIZE, MAX_CHUNK_SIZE], only last chunk can be smaller. */
+Vector<Chunk> Split(const uint8* data, uint32 size);
+}
+} // namespace AssetCache
+} // namespace DAVA
@@ -98,6 +98,89 @@ AssetCache::Error AssetCacheClient::CheckStatusSynchronously()
 }
 
 AssetCache::Error AssetCacheClient::AddToCacheSynchronously(const AssetCache::CacheItemKey& key, const AssetCache::CachedItemValue& value)
+{
+    // server keeps chunks of added data, so chunks stored on server are not sent again
+    AssetCache::CachedItemValue::FileChunks chunks = value.SplitIntoChunks();
+    UnorderedSet<MD5::MD5Digest, AssetCache::ContentChunker::DigestHash> storedChunks;
+
+    AssetCache::Error resultCode = QueryStoredChunksSynchronously(key, chunks, storedChunks);
+    if (resultCode == AssetCache::Error::NO_ERRORS)
+    {
+        resultCode = SendAddRequestSynchronously(key, value, chunks, storedChunks);
+        if (resultCode == AssetCache::Error::SERVER_ERROR && !storedChunks.empty())
+        {
+            Logger::FrameworkDebug("Chunks could be removed from server after query. Sending data with all chunks");
+            storedChunks.clear();
+            resultCode = SendAddRequestSynchronously(key, value, chunks, storedChunks);
+        }
+    }
+
+    { //process stats
+        ++stats.addRequestsCount;
+        switch (resultCode)
+        {
+        case AssetCache::Error::NO_ERRORS:
+            ++stats.addRequestsSucceedCount;
+            break;
+        case AssetCache::Error::OPERATION_TIMEOUT:
+            ++stats.addRequestsTimeoutCount;
+            break;
+
+        default:
+            ++stats.addRequestsFailedCount;
+            break;
+        }
+    }
+
+    return resultCode;
+}
+
+AssetCache::Error AssetCacheClient::QueryStoredChunksSynchronously(const AssetCache::CacheItemKey& key, const AssetCache::CachedItemValue::FileChunks& chunks, UnorderedSet<MD5::MD5Digest, AssetCache::ContentChunker::DigestHash>& storedChunks)
+{
+    Vector<MD5::MD5Digest> digests;
+    for (const auto& fileChunks : chunks)
+    {
+        for (const AssetCache::ContentChunker::Chunk& chunk : fileChunks.second)
+        {
+            digests.push_back(chunk.digest);
+        }
+    }
+
+    {
+        LockGuard<Mutex> guard(requestLocker);
+        request = Request(AssetCache::PACKET_CHUNKS_QUERY_REQUEST, key);
+        addFilesRequest.Reset();
+    }
+
+    AssetCache::Error resultCode = AssetCache::Error::CANNOT_SEND_REQUEST;
+
+    bool requestSent = client.RequestChunksQuery(key, digests);
+    if (requestSent)
+    {
+        resultCode = WaitRequest();
+    }
+
+    {
+        LockGuard<Mutex> guard(requestLocker);
+        request.Reset();
+
+        const Vector<uint8>& flags = addFilesRequest.storedChunkFlags;
+        if (resultCode == AssetCache::Error::NO_ERRORS && flags.size() == digests.size())
+        {
+            for (size_t i = 0; i < digests.size(); ++i)
+            {
+                if (flags[i] != 0)
+                {
+                    storedChunks.insert(digests[i]);
+                }
+            }
+        }
+    }
+
+    return resultCode;
+}
+
+AssetCache::Error AssetCacheClient::SendAddRequestSynchronously(const AssetCache::CacheItemKey& key, const AssetCache::CachedItemValue& value, const AssetCache::CachedItemValue::FileChunks& chunks, const UnorderedSet<MD5::MD5Digest, AssetCache::ContentChunker::DigestHash>& storedChunks)
 {
     uint64 dataSizeOverall = 0;
     uint32 chunksOverall = 0;
@@ -105,12 +188,17 @@ AssetCache::Error AssetCacheClient::AddToCacheSynchronously(const AssetCache::Ca
         LockGuard<Mutex> guard(requestLocker);
         request = Request(AssetCache::PACKET_ADD_CHUNK_REQUEST, key);
         addFilesRequest.Reset();
-        value.Serialize(addFilesRequest.serializedData);
+        value.SerializeChunked(addFilesRequest.serializedData, chunks, [&storedChunks](const MD5::MD5Digest& digest) {
+            return storedChunks.count(digest) > 0;
+        });
         dataSizeOverall = addFilesRequest.serializedData->GetSize();
         chunksOverall = AssetCache::ChunkSplitter::GetNumberOfChunks(dataSizeOverall);
         addFilesRequest.chunksSent = 0;
     }
 
+    stats.addDataSize += value.GetSize();
+    stats.addSentSize += dataSizeOverall;
+
     AssetCache::Error resultCode = AssetCache::Error::CANNOT_SEND_REQUEST;
 
     for (uint32 currentChunk = 0; currentChunk < chunksOverall; ++currentChunk)
@@ -141,23 +229,6 @@ AssetCache::Error AssetCacheClient::AddToCacheSynchronously(const AssetCache::Ca
         }
     }
 
-    { //process stats
-        ++stats.addRequestsCount;
-        switch (resultCode)
-        {
-        case AssetCache::Error::NO_ERRORS:
-            ++stats.addRequestsSucceedCount;
-            break;
-        case AssetCache::Error::OPERATION_TIMEOUT:
-            ++stats.addRequestsTimeoutCount;
-            break;
-
-        default:
-            ++stats.addRequestsFailedCount;
-            break;
-        }
-    }
-
     return resultCode;
 }
 
@@ -385,6 +456,23 @@ void AssetCacheClient::OnAddedToCache(const AssetCache::CacheItemKey& key, bool
     }
 }
 
+void AssetCacheClient::OnChunksQueryReceived(const AssetCache::CacheItemKey& key, const Vector<uint8>& storedFlags)
+{
+    LockGuard<Mutex> guard(requestLocker);
+
+    if ((request.requestID == AssetCache::PACKET_CHUNKS_QUERY_REQUEST) && request.key == key)
+    {
+        addFilesRequest.storedChunkFlags = storedFlags;
+        request.result = AssetCache::Error::NO_ERRORS;
+        request.recieved = true;
+        request.processingRequest = false;
+    }
+    else
+    {
+        //skip this request, because it was canceled by timeout
+    }
+}
+
 void AssetCacheClient::OnReceivedFromCache(const AssetCache::CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const Vector<uint8>& chunkData)
 {
     LockGuard<Mutex> guard(requestLocker);
@@ -562,6 +650,8 @@ void AssetCacheClient::DumpStats() const
                 Logger::Info("  timeout: %d", stats.addRequestsTimeoutCount);
             if (stats.addRequestsFailedCount > 0)
                 Logger::Info("  failed: %d", stats.addRequestsFailedCount);
+            if (stats.addDataSize > 0)
+                Logger::Info("  sent %llu bytes for %llu bytes of data", stats.addSentSize, stats.addDataSize);
 
             DVASSERT(stats.addRequestsCount == (stats.addRequestsFailedCount + stats.addRequestsTimeoutCount + stats.addRequestsSucceedCount));
         }
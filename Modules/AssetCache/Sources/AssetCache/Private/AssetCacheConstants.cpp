@@ -29,7 +29,9 @@ String PacketToString(ePacketID packet)
     { ePacketID::PACKET_REMOVE_REQUEST, "PACKET_REMOVE_REQUEST" },
     { ePacketID::PACKET_REMOVE_RESPONSE, "PACKET_REMOVE_RESPONSE" },
     { ePacketID::PACKET_CLEAR_REQUEST, "PACKET_CLEAR_REQUEST" },
-    { ePacketID::PACKET_CLEAR_RESPONSE, "PACKET_CLEAR_RESPONSE" }
+    { ePacketID::PACKET_CLEAR_RESPONSE, "PACKET_CLEAR_RESPONSE" },
+    { ePacketID::PACKET_CHUNKS_QUERY_REQUEST, "PACKET_CHUNKS_QUERY_REQUEST" },
+    { ePacketID::PACKET_CHUNKS_QUERY_RESPONSE, "PACKET_CHUNKS_QUERY_RESPONSE" }
     } };
 
     DVASSERT(static_cast<uint32>(ePacketID::PACKET_COUNT) == packetStrings.size());
@@ -9,7 +9,7 @@ namespace DAVA
 namespace AssetCache
 {
 const uint16 PACKET_HEADER = 0xACCA;
-const uint8 PACKET_VERSION = 3;
+const uint8 PACKET_VERSION = 4;
 
 Map<const uint8*, ScopedPtr<DynamicMemoryFile>> CachePacket::sendingPackets;
 
@@ -128,6 +128,10 @@ std::unique_ptr<CachePacket> CachePacket::CreateByType(ePacketID type)
         return std::unique_ptr<CachePacket>(new ClearRequestPacket());
     case PACKET_CLEAR_RESPONSE:
         return std::unique_ptr<CachePacket>(new ClearResponsePacket());
+    case PACKET_CHUNKS_QUERY_REQUEST:
+        return std::unique_ptr<CachePacket>(new ChunksQueryRequestPacket());
+    case PACKET_CHUNKS_QUERY_RESPONSE:
+        return std::unique_ptr<CachePacket>(new ChunksQueryResponsePacket());
     default:
     {
         Logger::Error("[CachePacket::%s] Wrong packet type: %d", __FUNCTION__, type);
@@ -370,5 +374,74 @@ bool ClearResponsePacket::DeserializeFromBuffer(File* file)
     return ((file->Read(&cleared) == sizeof(cleared)));
 }
 
+//////////////////////////////////////////////////////////////////////////
+ChunksQueryRequestPacket::ChunksQueryRequestPacket(const CacheItemKey& key_, const Vector<MD5::MD5Digest>& digests_)
+    : CachePacket(PACKET_CHUNKS_QUERY_REQUEST, CREATE_SENDING_BUFFER)
+{
+    WriteHeader(serializationBuffer);
+
+    uint32 digestsCount = static_cast<uint32>(digests_.size());
+    serializationBuffer->Write(key_.data(), static_cast<uint32>(key_.size()));
+    serializationBuffer->Write(&digestsCount, sizeof(digestsCount));
+    for (const MD5::MD5Digest& digest : digests_)
+    {
+        serializationBuffer->Write(digest.digest.data(), MD5::MD5Digest::DIGEST_SIZE);
+    }
+}
+
+ChunksQueryRequestPacket::ChunksQueryRequestPacket()
+    : CachePacket(PACKET_CHUNKS_QUERY_REQUEST, DO_NOT_CREATE_SENDING_BUFFER)
+{
+}
+
+bool ChunksQueryRequestPacket::DeserializeFromBuffer(File* buffer)
+{
+    using namespace CachePacketDetails;
+
+    uint32 digestsCount = 0;
+    if (!ReadFromBuffer(buffer, key) || !ReadFromBuffer(buffer, digestsCount))
+    {
+        return false;
+    }
+
+    digests.resize(digestsCount);
+    for (MD5::MD5Digest& digest : digests)
+    {
+        if (buffer->Read(digest.digest.data(), MD5::MD5Digest::DIGEST_SIZE) != MD5::MD5Digest::DIGEST_SIZE)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+ChunksQueryResponsePacket::ChunksQueryResponsePacket(const CacheItemKey& key_, const Vector<uint8>& storedFlags_)
+    : CachePacket(PACKET_CHUNKS_QUERY_RESPONSE, CREATE_SENDING_BUFFER)
+{
+    WriteHeader(serializationBuffer);
+
+    uint32 flagsCount = static_cast<uint32>(storedFlags_.size());
+    serializationBuffer->Write(key_.data(), static_cast<uint32>(key_.size()));
+    serializationBuffer->Write(&flagsCount, sizeof(flagsCount));
+    if (flagsCount > 0)
+    {
+        serializationBuffer->Write(storedFlags_.data(), flagsCount);
+    }
+}
+
+ChunksQueryResponsePacket::ChunksQueryResponsePacket()
+    : CachePacket(PACKET_CHUNKS_QUERY_RESPONSE, DO_NOT_CREATE_SENDING_BUFFER)
+{
+}
+
+bool ChunksQueryResponsePacket::DeserializeFromBuffer(File* buffer)
+{
+    using namespace CachePacketDetails;
+
+    uint32 flagsCount = 0;
+    return ReadFromBuffer(buffer, key) && ReadFromBuffer(buffer, flagsCount) && ReadFromBuffer(buffer, storedFlags, flagsCount);
+}
+
 } //AssetCache
 } //DAVA
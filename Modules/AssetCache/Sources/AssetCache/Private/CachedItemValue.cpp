@@ -182,25 +182,7 @@ bool CachedItemValue::Serialize(File* buffer) const
             return false;
     }
 
-    //Description
-    if (buffer->WriteString(description.machineName) == false)
-        return false;
-    if (buffer->WriteString(description.creationDate) == false)
-        return false;
-    if (buffer->WriteString(description.addingChain) == false)
-        return false;
-    if (buffer->WriteString(description.receivingChain) == false)
-        return false;
-    if (buffer->WriteString(description.comment) == false)
-        return false;
-
-    //Validation
-    if (buffer->Write(&validationDetails.filesCount) != sizeof(validationDetails.filesCount))
-        return false;
-    if (buffer->Write(&validationDetails.filesDataSize) != sizeof(validationDetails.filesDataSize))
-        return false;
-
-    return true;
+    return SerializeDescription(buffer);
 }
 
 bool CachedItemValue::Deserialize(File* file)
@@ -248,6 +230,34 @@ bool CachedItemValue::Deserialize(File* file)
         size = fetchedSize;
     }
 
+    return DeserializeDescription(file);
+}
+
+bool CachedItemValue::SerializeDescription(File* buffer) const
+{
+    //Description
+    if (buffer->WriteString(description.machineName) == false)
+        return false;
+    if (buffer->WriteString(description.creationDate) == false)
+        return false;
+    if (buffer->WriteString(description.addingChain) == false)
+        return false;
+    if (buffer->WriteString(description.receivingChain) == false)
+        return false;
+    if (buffer->WriteString(description.comment) == false)
+        return false;
+
+    //Validation
+    if (buffer->Write(&validationDetails.filesCount) != sizeof(validationDetails.filesCount))
+        return false;
+    if (buffer->Write(&validationDetails.filesDataSize) != sizeof(validationDetails.filesDataSize))
+        return false;
+
+    return true;
+}
+
+bool CachedItemValue::DeserializeDescription(File* file)
+{
     //Description
     if (file->ReadString(description.machineName) == false)
         return false;
@@ -269,6 +279,162 @@ bool CachedItemValue::Deserialize(File* file)
     return true;
 }
 
+CachedItemValue::FileChunks CachedItemValue::SplitIntoChunks() const
+{
+    DVASSERT(isFetched == true);
+
+    FileChunks chunks;
+    for (const auto& dc : dataContainer)
+    {
+        const Vector<uint8>& data = *dc.second;
+        chunks[dc.first] = ContentChunker::Split(data.data(), static_cast<uint32>(data.size()));
+    }
+    return chunks;
+}
+
+bool CachedItemValue::SerializeChunked(File* buffer, const FileChunks& chunks, const Function<bool(const MD5::MD5Digest&)>& isChunkKnown) const
+{
+    DVASSERT(buffer);
+    DVASSERT(isFetched == true);
+    DVASSERT(chunks.size() == dataContainer.size());
+
+    if (buffer->Write(&size) != sizeof(size))
+        return false;
+
+    uint64 count = dataContainer.size();
+    if (buffer->Write(&count) != sizeof(count))
+        return false;
+
+    UnorderedSet<MD5::MD5Digest, ContentChunker::DigestHash> writtenChunks;
+    for (const auto& entry : dataContainer)
+    {
+        auto found = chunks.find(entry.first);
+        if (found == chunks.end())
+            return false;
+
+        const Vector<ContentChunker::Chunk>& fileChunks = found->second;
+        uint32 fileSize = static_cast<uint32>(entry.second->size());
+        uint32 chunksCount = static_cast<uint32>(fileChunks.size());
+        if (buffer->WriteString(entry.first) == false)
+            return false;
+        if (buffer->Write(&fileSize) != sizeof(fileSize))
+            return false;
+        if (buffer->Write(&chunksCount) != sizeof(chunksCount))
+            return false;
+
+        for (const ContentChunker::Chunk& chunk : fileChunks)
+        {
+            DVASSERT(chunk.offset + chunk.size <= fileSize);
+
+            uint8 hasData = (writtenChunks.count(chunk.digest) == 0 && !isChunkKnown(chunk.digest)) ? 1 : 0;
+            if (buffer->Write(chunk.digest.digest.data(), MD5::MD5Digest::DIGEST_SIZE) != MD5::MD5Digest::DIGEST_SIZE)
+                return false;
+            if (buffer->Write(&chunk.size) != sizeof(chunk.size))
+                return false;
+            if (buffer->Write(&hasData) != sizeof(hasData))
+                return false;
+
+            if (hasData)
+            {
+                if (buffer->Write(entry.second->data() + chunk.offset, chunk.size) != chunk.size)
+                    return false;
+                writtenChunks.insert(chunk.digest);
+            }
+        }
+    }
+
+    return SerializeDescription(buffer);
+}
+
+bool CachedItemValue::DeserializeChunked(File* file, const Function<bool(const MD5::MD5Digest&, uint8* data, uint32 size)>& readKnownChunk)
+{
+    DVASSERT(file);
+    DVASSERT(isFetched == false);
+    DVASSERT(dataContainer.empty());
+
+    if (file->Read(&size) != sizeof(size))
+        return false;
+
+    uint64 count = 0;
+    if (file->Read(&count) != sizeof(count))
+        return false;
+
+    // chunks received in this value, they can be referenced by digest later
+    UnorderedMap<MD5::MD5Digest, const uint8*, ContentChunker::DigestHash> receivedChunks;
+
+    uint64 fetchedSize = 0;
+    for (; count > 0; --count)
+    {
+        String name;
+        if (!file->ReadString(name))
+            return false;
+
+        uint32 fileSize = 0;
+        uint32 chunksCount = 0;
+        if (file->Read(&fileSize) != sizeof(fileSize))
+            return false;
+        if (file->Read(&chunksCount) != sizeof(chunksCount))
+            return false;
+
+        ValueData data = std::make_shared<Vector<uint8>>(fileSize);
+        uint32 offset = 0;
+        for (; chunksCount > 0; --chunksCount)
+        {
+            MD5::MD5Digest digest;
+            uint32 chunkSize = 0;
+            uint8 hasData = 0;
+            if (file->Read(digest.digest.data(), MD5::MD5Digest::DIGEST_SIZE) != MD5::MD5Digest::DIGEST_SIZE)
+                return false;
+            if (file->Read(&chunkSize) != sizeof(chunkSize))
+                return false;
+            if (file->Read(&hasData) != sizeof(hasData))
+                return false;
+            if (chunkSize > fileSize - offset)
+                return false;
+
+            uint8* chunkData = data->data() + offset;
+            if (hasData)
+            {
+                if (file->Read(chunkData, chunkSize) != chunkSize)
+                    return false;
+                receivedChunks.emplace(digest, chunkData);
+            }
+            else
+            {
+                auto received = receivedChunks.find(digest);
+                if (received != receivedChunks.end())
+                {
+                    Memcpy(chunkData, received->second, chunkSize);
+                }
+                else if (!readKnownChunk(digest, chunkData, chunkSize))
+                {
+                    Logger::Error("[%s] Chunk %s of file %s is not available", __FUNCTION__, MD5::HashToString(digest).c_str(), name.c_str());
+                    return false;
+                }
+            }
+            offset += chunkSize;
+        }
+
+        if (offset != fileSize)
+            return false;
+
+        if (fileSize > 0)
+        {
+            isFetched = true;
+            fetchedSize += fileSize;
+        }
+        dataContainer[name] = data;
+    }
+
+    if (isFetched && fetchedSize != size)
+    {
+        Logger::Error("[%s] Fetched size %llu differs from stored %llu", __FUNCTION__, fetchedSize, size);
+        size = fetchedSize;
+    }
+
+    return DeserializeDescription(file);
+}
+
 bool CachedItemValue::operator==(const CachedItemValue& right) const
 {
     if ((isFetched == right.isFetched) && (size == right.size) && (dataContainer.size() == right.dataContainer.size()) && (validationDetails == right.validationDetails) && (description == right.description))
@@ -324,14 +490,23 @@ CachedItemValue& CachedItemValue::operator=(CachedItemValue&& right)
 bool CachedItemValue::Fetch(const FilePath& folder)
 {
     DVASSERT(folder.IsDirectoryPathname());
+
+    return Fetch([this, &folder](const String& name, Vector<uint8>& data) {
+        data = std::move(*LoadFile(folder + name));
+        return true;
+    });
+}
+
+bool CachedItemValue::Fetch(const Function<bool(const String& name, Vector<uint8>& data)>& loadData)
+{
     DVASSERT(isFetched == false);
 
     isFetched = true;
     for (auto& dc : dataContainer)
     {
         DVASSERT(IsDataLoaded(dc.second) == false);
-        dc.second = LoadFile(folder + dc.first);
-        if (false == IsDataLoaded(dc.second))
+        dc.second = std::make_shared<Vector<uint8>>();
+        if (false == loadData(dc.first, *dc.second) || false == IsDataLoaded(dc.second))
         {
             Free();
             return false;
@@ -392,6 +567,16 @@ size_type CachedItemValue::GetItemCount() const
     return dataContainer.size();
 }
 
+const Vector<uint8>* CachedItemValue::GetFileData(const String& name) const
+{
+    auto found = dataContainer.find(name);
+    if (found != dataContainer.end() && IsDataLoaded(found->second))
+    {
+        return found->second.get();
+    }
+    return nullptr;
+}
+
 bool CachedItemValue::ExportToFile(const FilePath& exportToPath) const
 {
     if (GetItemCount() != 1)
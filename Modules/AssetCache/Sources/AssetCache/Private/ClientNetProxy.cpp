@@ -156,6 +156,18 @@ bool ClientNetProxy::RequestClearCache()
     return false;
 }
 
+bool ClientNetProxy::RequestChunksQuery(const CacheItemKey& key, const Vector<MD5::MD5Digest>& digests)
+{
+    //Logger::FrameworkDebug("Requesting stored chunks");
+    if (openedChannel)
+    {
+        ChunksQueryRequestPacket packet(key, digests);
+        return packet.SendTo(openedChannel);
+    }
+
+    return false;
+}
+
 void ClientNetProxy::OnChannelOpen(const std::shared_ptr<DAVA::Net::IChannel>& channel)
 {
     Logger::FrameworkDebug("Connection established");
@@ -240,6 +252,13 @@ void ClientNetProxy::OnPacketReceived(const std::shared_ptr<DAVA::Net::IChannel>
                     listener->OnCacheCleared(p->cleared);
                 return;
             }
+            case PACKET_CHUNKS_QUERY_RESPONSE:
+            {
+                ChunksQueryResponsePacket* p = static_cast<ChunksQueryResponsePacket*>(packet.get());
+                for (ClientNetProxyListener* listener : listeners)
+                    listener->OnChunksQueryReceived(p->key, p->storedFlags);
+                return;
+            }
             default:
             {
                 Logger::Error("%s: Unexpected packet type: %d", __FUNCTION__, packet->type);
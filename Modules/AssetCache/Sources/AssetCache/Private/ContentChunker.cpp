@@ -0,0 +1,89 @@
+#include "AssetCache/ContentChunker.h"
+
+namespace DAVA
+{
+namespace AssetCache
+{
+namespace ContentChunker
+{
+namespace ContentChunkerDetails
+{
+Array<uint64, 256> CreateGearTable()
+{
+    // table should be the same on all machines, so it is generated by splitmix64 with fixed seed
+    Array<uint64, 256> table;
+    uint64 state = 0x9E3779B97F4A7C15ULL;
+    for (uint64& value : table)
+    {
+        state += 0x9E3779B97F4A7C15ULL;
+        uint64 z = state;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        value = z ^ (z >> 31);
+    }
+    return table;
+}
+
+const Array<uint64, 256> GEAR_TABLE = CreateGearTable();
+
+// Normalized chunking: before average size boundary condition is harder than after it,
+// so sizes of chunks are concentrated around average. Upper bits of gear hash depend on last 64 bytes.
+const uint64 MASK_BEFORE_AVERAGE = ((1ULL << 15) - 1) << (64 - 15);
+const uint64 MASK_AFTER_AVERAGE = ((1ULL << 11) - 1) << (64 - 11);
+
+uint32 FindChunkSize(const uint8* data, uint32 size)
+{
+    if (size <= MIN_CHUNK_SIZE)
+    {
+        return size;
+    }
+
+    const uint32 end = std::min(size, MAX_CHUNK_SIZE);
+    const uint32 average = std::min(end, AVERAGE_CHUNK_SIZE);
+
+    uint64 hash = 0;
+    uint32 i = MIN_CHUNK_SIZE;
+    for (; i < average; ++i)
+    {
+        hash = (hash << 1) + GEAR_TABLE[data[i]];
+        if ((hash & MASK_BEFORE_AVERAGE) == 0)
+        {
+            return i + 1;
+        }
+    }
+
+    for (; i < end; ++i)
+    {
+        hash = (hash << 1) + GEAR_TABLE[data[i]];
+        if ((hash & MASK_AFTER_AVERAGE) == 0)
+        {
+            return i + 1;
+        }
+    }
+
+    return end;
+}
+}
+
+Vector<Chunk> Split(const uint8* data, uint32 size)
+{
+    Vector<Chunk> chunks;
+    chunks.reserve(size / AVERAGE_CHUNK_SIZE + 1);
+
+    uint32 offset = 0;
+    while (offset < size)
+    {
+        Chunk chunk;
+        chunk.offset = offset;
+        chunk.size = ContentChunkerDetails::FindChunkSize(data + offset, size - offset);
+        MD5::ForData(data + offset, chunk.size, chunk.digest);
+        chunks.push_back(chunk);
+
+        offset += chunk.size;
+    }
+
+    return chunks;
+}
+}
+} // namespace AssetCache
+} // namespace DAVA
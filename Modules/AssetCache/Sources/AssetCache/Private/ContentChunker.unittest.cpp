@@ -0,0 +1,272 @@
+#include "UnitTests/UnitTests.h"
+
+#include "AssetCache/CachedItemValue.h"
+#include "AssetCache/ContentChunker.h"
+
+#include <FileSystem/DynamicMemoryFile.h>
+#include <FileSystem/FileList.h>
+#include <FileSystem/FileSystem.h>
+#include <Logger/Logger.h>
+#include <Time/SystemTimer.h>
+
+#include <random>
+
+namespace ContentChunkerTestDetails
+{
+using namespace DAVA;
+using namespace DAVA::AssetCache;
+
+using DigestSet = UnorderedSet<MD5::MD5Digest, ContentChunker::DigestHash>;
+
+const uint64 MAX_CORPUS_SIZE = 64 * 1024 * 1024;
+
+Vector<uint8> CreateRandomData(uint32 seed, uint32 size)
+{
+    std::mt19937 random(seed);
+    Vector<uint8> data(size);
+    for (uint8& byte : data)
+    {
+        byte = static_cast<uint8>(random());
+    }
+    return data;
+}
+
+// Insert few bytes into the middle of data and change its header, like converter does for another GPU or quality
+Vector<uint8> CreateModifiedCopy(const Vector<uint8>& data)
+{
+    Vector<uint8> copy = data;
+    for (size_t i = 0; i < std::min<size_t>(copy.size(), 16); ++i)
+    {
+        copy[i] ^= 0xFF;
+    }
+    const uint8 inserted[] = { 'D', 'A', 'V', 'A', 0, 1, 2, 3 };
+    copy.insert(copy.begin() + copy.size() / 3, std::begin(inserted), std::end(inserted));
+    return copy;
+}
+
+void CollectFiles(const FilePath& dirPath, Vector<Vector<uint8>>& contents, uint64& overallSize)
+{
+    ScopedPtr<FileList> fileList(new FileList(dirPath));
+    for (uint32 i = 0; i < fileList->GetCount() && overallSize < MAX_CORPUS_SIZE; ++i)
+    {
+        if (fileList->IsNavigationDirectory(i))
+        {
+            continue;
+        }
+
+        if (fileList->IsDirectory(i))
+        {
+            CollectFiles(fileList->GetPathname(i), contents, overallSize);
+        }
+        else
+        {
+            Vector<uint8> content;
+            if (FileSystem::Instance()->ReadFileContents(fileList->GetPathname(i), content) && !content.empty())
+            {
+                overallSize += content.size();
+                contents.push_back(std::move(content));
+            }
+        }
+    }
+}
+
+Vector<ContentChunker::Chunk> SplitIntoFixedChunks(const Vector<uint8>& data)
+{
+    Vector<ContentChunker::Chunk> chunks;
+    for (uint32 offset = 0; offset < data.size(); offset += ContentChunker::AVERAGE_CHUNK_SIZE)
+    {
+        ContentChunker::Chunk chunk;
+        chunk.offset = offset;
+        chunk.size = std::min(static_cast<uint32>(data.size()) - offset, ContentChunker::AVERAGE_CHUNK_SIZE);
+        MD5::ForData(data.data() + offset, chunk.size, chunk.digest);
+        chunks.push_back(chunk);
+    }
+    return chunks;
+}
+
+// Returns size of chunks, that are not in storage yet
+uint64 AddToStorage(const Vector<ContentChunker::Chunk>& chunks, DigestSet& storage)
+{
+    uint64 storedSize = 0;
+    for (const ContentChunker::Chunk& chunk : chunks)
+    {
+        if (storage.insert(chunk.digest).second)
+        {
+            storedSize += chunk.size;
+        }
+    }
+    return storedSize;
+}
+
+Vector<uint8> SerializeValue(const CachedItemValue& value)
+{
+    ScopedPtr<DynamicMemoryFile> file(DynamicMemoryFile::Create(File::CREATE | File::WRITE));
+    value.Serialize(file);
+    return file->GetDataVector();
+}
+}
+
+DAVA_TESTCLASS (ContentChunkerTest)
+{
+    DAVA_TEST (ChunksCoverData)
+    {
+        using namespace DAVA;
+        using namespace DAVA::AssetCache;
+        using namespace ContentChunkerTestDetails;
+
+        Vector<uint8> data = CreateRandomData(1234, 1024 * 1024 + 123);
+
+        Vector<ContentChunker::Chunk> chunks = ContentChunker::Split(data.data(), static_cast<uint32>(data.size()));
+        TEST_VERIFY(chunks.size() > 1);
+
+        uint32 offset = 0;
+        for (size_t i = 0; i < chunks.size(); ++i)
+        {
+            const ContentChunker::Chunk& chunk = chunks[i];
+            TEST_VERIFY(chunk.offset == offset);
+            TEST_VERIFY(chunk.size <= ContentChunker::MAX_CHUNK_SIZE);
+            TEST_VERIFY(chunk.size >= ContentChunker::MIN_CHUNK_SIZE || i + 1 == chunks.size());
+
+            MD5::MD5Digest digest;
+            MD5::ForData(data.data() + chunk.offset, chunk.size, digest);
+            TEST_VERIFY(digest == chunk.digest);
+            offset += chunk.size;
+        }
+        TEST_VERIFY(offset == data.size());
+
+        Vector<ContentChunker::Chunk> chunksOfSmallData = ContentChunker::Split(data.data(), 100);
+        TEST_VERIFY(chunksOfSmallData.size() == 1 && chunksOfSmallData[0].size == 100);
+        TEST_VERIFY(ContentChunker::Split(data.data(), 0).empty());
+    }
+
+    DAVA_TEST (ChunksSurviveInsertion)
+    {
+        using namespace DAVA;
+        using namespace DAVA::AssetCache;
+        using namespace ContentChunkerTestDetails;
+
+        Vector<uint8> data = CreateRandomData(4321, 4 * 1024 * 1024);
+        Vector<uint8> modified = CreateModifiedCopy(data);
+
+        DigestSet storage;
+        uint64 originalSize = AddToStorage(ContentChunker::Split(data.data(), static_cast<uint32>(data.size())), storage);
+        uint64 modifiedSize = AddToStorage(ContentChunker::Split(modified.data(), static_cast<uint32>(modified.size())), storage);
+        TEST_VERIFY(originalSize == data.size());
+        // only chunks around header and insertion are changed
+        TEST_VERIFY(modifiedSize < 4 * ContentChunker::MAX_CHUNK_SIZE);
+
+        DigestSet fixedStorage;
+        AddToStorage(SplitIntoFixedChunks(data), fixedStorage);
+        uint64 fixedModifiedSize = AddToStorage(SplitIntoFixedChunks(modified), fixedStorage);
+        TEST_VERIFY(fixedModifiedSize > modified.size() / 2);
+    }
+
+    DAVA_TEST (ChunkedSerializationSkipsKnownChunks)
+    {
+        using namespace DAVA;
+        using namespace DAVA::AssetCache;
+        using namespace ContentChunkerTestDetails;
+
+        std::shared_ptr<Vector<uint8>> texture = std::make_shared<Vector<uint8>>(CreateRandomData(5678, 512 * 1024));
+        std::shared_ptr<Vector<uint8>> otherGpuTexture = std::make_shared<Vector<uint8>>(CreateModifiedCopy(*texture));
+
+        CachedItemValue::Description description;
+        description.machineName = "test";
+
+        CachedItemValue firstValue;
+        firstValue.Add("texture.pvr", texture);
+        firstValue.SetDescription(description);
+        firstValue.UpdateValidationData();
+
+        CachedItemValue secondValue;
+        secondValue.Add("texture.dds", otherGpuTexture);
+        secondValue.Add("texture_copy.dds", otherGpuTexture);
+        secondValue.SetDescription(description);
+        secondValue.UpdateValidationData();
+
+        // chunks of first value are known by receiver
+        UnorderedMap<MD5::MD5Digest, Vector<uint8>, ContentChunker::DigestHash> receiverChunks;
+        for (const auto& fileChunks : firstValue.SplitIntoChunks())
+        {
+            for (const ContentChunker::Chunk& chunk : fileChunks.second)
+            {
+                receiverChunks[chunk.digest].assign(texture->begin() + chunk.offset, texture->begin() + chunk.offset + chunk.size);
+            }
+        }
+
+        ScopedPtr<DynamicMemoryFile> file(DynamicMemoryFile::Create(File::CREATE | File::WRITE | File::READ));
+        bool serialized = secondValue.SerializeChunked(file, secondValue.SplitIntoChunks(), [&](const MD5::MD5Digest& digest) {
+            return receiverChunks.count(digest) > 0;
+        });
+        TEST_VERIFY(serialized);
+        // data of second file repeats the first one, and most of chunks of the first one are known
+        TEST_VERIFY(file->GetSize() < otherGpuTexture->size() / 4);
+
+        CachedItemValue receivedValue;
+        file->Seek(0, File::SEEK_FROM_START);
+        bool deserialized = receivedValue.DeserializeChunked(file, [&](const MD5::MD5Digest& digest, uint8* data, uint32 size) {
+            auto found = receiverChunks.find(digest);
+            if (found == receiverChunks.end() || found->second.size() != size)
+            {
+                return false;
+            }
+            Memcpy(data, found->second.data(), size);
+            return true;
+        });
+        TEST_VERIFY(deserialized);
+        TEST_VERIFY(receivedValue.IsValid());
+        TEST_VERIFY(SerializeValue(receivedValue) == SerializeValue(secondValue));
+
+        // receiver without known chunks can't restore value
+        CachedItemValue brokenValue;
+        file->Seek(0, File::SEEK_FROM_START);
+        TEST_VERIFY(!brokenValue.DeserializeChunked(file, [](const MD5::MD5Digest&, uint8*, uint32) { return false; }));
+    }
+
+    DAVA_TEST (DeduplicationOfResources)
+    {
+        using namespace DAVA;
+        using namespace DAVA::AssetCache;
+        using namespace ContentChunkerTestDetails;
+
+        Vector<Vector<uint8>> corpus;
+        uint64 corpusSize = 0;
+        CollectFiles("~res:/", corpus, corpusSize);
+        if (corpus.empty())
+        {
+            return;
+        }
+
+        // each resource is added to cache twice: as is and as converted for another GPU
+        DigestSet storage;
+        DigestSet fixedStorage;
+        uint64 dataSize = 0;
+        uint64 storedSize = 0;
+        uint64 fixedStoredSize = 0;
+        uint64 chunksCount = 0;
+
+        int64 startTime = SystemTimer::GetUs();
+        for (const Vector<uint8>& content : corpus)
+        {
+            Vector<uint8> modified = CreateModifiedCopy(content);
+            for (const Vector<uint8>* variant : Vector<const Vector<uint8>*>{ &content, &modified })
+            {
+                Vector<ContentChunker::Chunk> chunks = ContentChunker::Split(variant->data(), static_cast<uint32>(variant->size()));
+                chunksCount += chunks.size();
+                storedSize += AddToStorage(chunks, storage);
+                fixedStoredSize += AddToStorage(SplitIntoFixedChunks(*variant), fixedStorage);
+                dataSize += variant->size();
+            }
+        }
+        int64 chunkingTime = std::max<int64>(1, SystemTimer::GetUs() - startTime);
+
+        TEST_VERIFY(storedSize <= dataSize);
+
+        Logger::Info("Deduplication of %u files with modified copies: %llu bytes of data, %llu chunks",
+                     static_cast<uint32>(corpus.size()), dataSize, chunksCount);
+        Logger::Info("  content defined chunks: stored %llu bytes, saved %llu bytes, deduplication ratio %.2f, chunking speed %.1f Mb/s",
+                     storedSize, dataSize - storedSize, static_cast<float64>(dataSize) / std::max<uint64>(storedSize, 1), dataSize / static_cast<float64>(chunkingTime));
+        Logger::Info("  fixed size chunks: stored %llu bytes, saved %llu bytes, deduplication ratio %.2f",
+                     fixedStoredSize, dataSize - fixedStoredSize, static_cast<float64>(dataSize) / std::max<uint64>(fixedStoredSize, 1));
+    }
+};
@@ -89,6 +89,12 @@ void ServerNetProxy::OnPacketReceived(const std::shared_ptr<Net::IChannel>& chan
                 listener->OnStatusRequested(channel);
                 return;
             }
+            case PACKET_CHUNKS_QUERY_REQUEST:
+            {
+                ChunksQueryRequestPacket* p = static_cast<ChunksQueryRequestPacket*>(packet.get());
+                listener->OnChunksQuery(channel, p->key, p->digests);
+                return;
+            }
             default:
             {
                 Logger::Error("%s: Unexpected packet type: %d", __FUNCTION__, packet->type);
@@ -171,5 +177,16 @@ bool ServerNetProxy::SendStatus(const std::shared_ptr<Net::IChannel>& channel)
     return false;
 }
 
+bool ServerNetProxy::SendStoredChunks(const std::shared_ptr<Net::IChannel>& channel, const CacheItemKey& key, const Vector<uint8>& storedFlags)
+{
+    if (channel)
+    {
+        ChunksQueryResponsePacket packet(key, storedFlags);
+        return packet.SendTo(channel);
+    }
+
+    return false;
+}
+
 }; // end of namespace AssetCache
 }; // end of namespace DAVA
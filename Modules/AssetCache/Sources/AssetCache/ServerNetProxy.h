@@ -7,6 +7,7 @@
 
 #include <Base/BaseTypes.h>
 #include <Network/IChannel.h>
+#include <Utils/MD5.h>
 
 namespace DAVA
 {
@@ -25,6 +26,7 @@ public:
     virtual void OnClearCache(const std::shared_ptr<Net::IChannel>& channel) = 0;
     virtual void OnWarmingUp(const std::shared_ptr<Net::IChannel>& channel, const CacheItemKey& key) = 0;
     virtual void OnStatusRequested(const std::shared_ptr<Net::IChannel>& channel) = 0;
+    virtual void OnChunksQuery(const std::shared_ptr<Net::IChannel>& channel, const CacheItemKey& key, const Vector<MD5::MD5Digest>& digests) = 0;
 
     virtual void OnChannelClosed(const std::shared_ptr<Net::IChannel>& channel, const char8* message){};
 };
@@ -48,6 +50,7 @@ public:
     bool SendCleared(const std::shared_ptr<Net::IChannel>& channel, bool cleared);
     bool SendChunk(const std::shared_ptr<Net::IChannel>& channel, const CacheItemKey& key, uint64 dataSize, uint32 numOfChunks, uint32 chunkNumber, const Vector<uint8>& chunkData);
     bool SendStatus(const std::shared_ptr<Net::IChannel>& channel);
+    bool SendStoredChunks(const std::shared_ptr<Net::IChannel>& channel, const CacheItemKey& key, const Vector<uint8>& storedFlags);
 
     //Net::IChannelListener
     // Channel is open (underlying transport has connection) and can receive and send data through IChannel interface
@@ -1,5 +1,6 @@
 #include "FBXAnimationImport.h"
 
+#include "Animation/AnimationChannelEncoder.h"
 #include "Animation/AnimationClip.h"
 #include "FileSystem/File.h"
 #include "Logger/Logger.h"
@@ -9,6 +10,11 @@ namespace DAVA
 {
 namespace FBXAnimationImportDetails
 {
+//max errors of keys reduction: in scene units for position and scale, in radians for orientation
+const float32 POSITION_MAX_ERROR = 0.0005f;
+const float32 ORIENTATION_MAX_ERROR = 0.001f;
+const float32 SCALE_MAX_ERROR = 0.0005f;
+
 //namespace declarations
 
 template <class T>
@@ -79,24 +85,18 @@ void SaveAnimation(const FBXAnimationStackData& fbxStackAnimationData, const Fil
     using namespace FBXAnimationImportDetails;
 
     //binary file format described in 'AnimationBinaryFormat.md'
-    struct ChannelHeader
+    struct ChannelTarget
     {
-        //Track part
         uint8 target;
         uint8 pad0[3];
-
-        //Channel part
-        uint32 signature = AnimationChannel::ANIMATION_CHANNEL_DATA_SIGNATURE;
-        uint8 dimension = 0;
-        uint8 interpolation = 0;
-        uint16 compression = 0;
-        uint32 keyCount = 0;
-    } channelHeader;
+    } channelTarget = {};
 
     ScopedPtr<File> file(File::Create(filePath, File::CREATE | File::WRITE));
     if (file)
     {
         Vector<uint8> animationData;
+        AnimationChannelEncoder::Report report;
+        Array<float32, AnimationTrack::CHANNEL_TARGET_COUNT> maxErrors = {};
 
         float32 animationDuration = fbxStackAnimationData.maxTimeStamp - fbxStackAnimationData.minTimeStamp;
         WriteToBuffer(animationData, &animationDuration);
@@ -132,51 +132,52 @@ void SaveAnimation(const FBXAnimationStackData& fbxStackAnimationData, const Fil
             {
                 if (!fbxChannelData.animationKeys.empty())
                 {
-                    channelHeader.target = fbxChannelData.channel;
-                    channelHeader.keyCount = uint32(fbxChannelData.animationKeys.size());
-
-                    if (channelHeader.target == AnimationTrack::CHANNEL_TARGET_POSITION)
+                    channelTarget.target = fbxChannelData.channel;
+                    WriteToBuffer(animationData, &channelTarget);
+
+                    uint32 dimension = 0;
+                    AnimationChannel::eInterpolation interpolation = AnimationChannel::INTERPOLATION_LINEAR;
+                    AnimationChannel::eCompression compression = AnimationChannel::COMPRESSION_QUANTIZED;
+                    float32 maxError = 0.f;
+                    if (channelTarget.target == AnimationTrack::CHANNEL_TARGET_POSITION)
                     {
-                        channelHeader.dimension = 3;
-                        channelHeader.interpolation = uint8(AnimationChannel::INTERPOLATION_LINEAR);
+                        dimension = 3;
+                        maxError = POSITION_MAX_ERROR;
                     }
-                    else if (channelHeader.target == AnimationTrack::CHANNEL_TARGET_ORIENTATION)
+                    else if (channelTarget.target == AnimationTrack::CHANNEL_TARGET_ORIENTATION)
                     {
-                        channelHeader.dimension = 4;
-                        channelHeader.interpolation = uint8(AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR);
+                        dimension = 4;
+                        interpolation = AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR;
+                        compression = AnimationChannel::COMPRESSION_SMALLEST_THREE;
+                        maxError = ORIENTATION_MAX_ERROR;
                     }
-                    else if (channelHeader.target == AnimationTrack::CHANNEL_TARGET_SCALE)
+                    else if (channelTarget.target == AnimationTrack::CHANNEL_TARGET_SCALE)
                     {
-                        channelHeader.dimension = 1;
-                        channelHeader.interpolation = uint8(AnimationChannel::INTERPOLATION_LINEAR);
+                        dimension = 1;
+                        maxError = SCALE_MAX_ERROR;
                     }
 
-                    WriteToBuffer(animationData, &channelHeader);
-
-                    for (uint32 k = 0; k < channelHeader.keyCount; ++k)
+                    Vector<AnimationChannelEncoder::Key> keys(fbxChannelData.animationKeys.size());
+                    for (size_t k = 0; k < keys.size(); ++k)
                     {
                         const FBXAnimationKey& key = fbxChannelData.animationKeys[k];
+                        keys[k].time = key.time - fbxStackAnimationData.minTimeStamp;
+                        keys[k].value = { key.value.x, key.value.y, key.value.z, key.value.w };
 
-                        float32 relativeKeyTime = key.time - fbxStackAnimationData.minTimeStamp;
-                        WriteToBuffer(animationData, &relativeKeyTime);
-
-                        if (channelHeader.target == AnimationTrack::CHANNEL_TARGET_POSITION)
-                        {
-                            Vector3 position = Vector3(key.value.data);
-                            WriteToBuffer(animationData, &position);
-                        }
-                        else if (channelHeader.target == AnimationTrack::CHANNEL_TARGET_ORIENTATION)
+                        if (channelTarget.target == AnimationTrack::CHANNEL_TARGET_ORIENTATION)
                         {
                             Quaternion orientation = Quaternion(key.value.data);
                             orientation.Normalize();
-                            WriteToBuffer(animationData, &orientation);
-                        }
-                        else if (channelHeader.target == AnimationTrack::CHANNEL_TARGET_SCALE)
-                        {
-                            float32 scale = key.value.x;
-                            WriteToBuffer(animationData, &scale);
+                            keys[k].value = { orientation.x, orientation.y, orientation.z, orientation.w };
                         }
                     }
+
+                    AnimationChannelEncoder::Report channelReport = AnimationChannelEncoder::Encode(keys, dimension, interpolation, compression, maxError, animationData);
+                    report.sourceKeysCount += channelReport.sourceKeysCount;
+                    report.encodedKeysCount += channelReport.encodedKeysCount;
+                    report.sourceDataSize += channelReport.sourceDataSize;
+                    report.encodedDataSize += channelReport.encodedDataSize;
+                    maxErrors[channelTarget.target] = Max(maxErrors[channelTarget.target], channelReport.maxError);
                 }
             }
         }
@@ -196,6 +197,10 @@ void SaveAnimation(const FBXAnimationStackData& fbxStackAnimationData, const Fil
         file->Write(animationData.data(), animationDataSize);
 
         file->Flush();
+
+        Logger::Info("[FBXImporter] Animation '%s': %u keys reduced to %u, channels data %u bytes compressed to %u bytes. Max error: position %f, orientation %f rad, scale %f",
+                     fbxStackAnimationData.name.c_str(), report.sourceKeysCount, report.encodedKeysCount, report.sourceDataSize, report.encodedDataSize,
+                     maxErrors[AnimationTrack::CHANNEL_TARGET_POSITION], maxErrors[AnimationTrack::CHANNEL_TARGET_ORIENTATION], maxErrors[AnimationTrack::CHANNEL_TARGET_SCALE]);
     }
     else
     {
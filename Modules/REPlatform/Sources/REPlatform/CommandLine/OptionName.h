@@ -40,6 +40,7 @@ public:
     static const String Yaml;
 
     static const String GPU;
+    static const String Api;
     static const String Quality;
     static const String Force;
     static const String Mipmaps;
@@ -64,6 +65,7 @@ public:
     static const String Camera;
 
     static const String Validate;
+    static const String RemoveSource;
     static const String Count;
 
     static const String Tag;
@@ -14,6 +14,7 @@
 #include <Utils/CRC32.h>
 #include <Compression/LZ4Compressor.h>
 #include <Compression/ZipCompressor.h>
+#include <Compression/ZstdCompressor.h>
 #include <Platform/DeviceInfo.h>
 #include <Time/DateTime.h>
 #include <Logger/Logger.h>
@@ -28,6 +29,7 @@ ENUM_DECLARE(DAVA::Compressor::Type)
     ENUM_ADD_DESCR(static_cast<int>(DAVA::Compressor::Type::Lz4), "lz4");
     ENUM_ADD_DESCR(static_cast<int>(DAVA::Compressor::Type::Lz4HC), "lz4hc");
     ENUM_ADD_DESCR(static_cast<int>(DAVA::Compressor::Type::RFC1951), "rfc1951");
+    ENUM_ADD_DESCR(static_cast<int>(DAVA::Compressor::Type::Zstd), "zstd");
     ENUM_ADD_DESCR(static_cast<int>(DAVA::Compressor::Type::None), "none");
 };
 
@@ -35,6 +37,13 @@ namespace DAVA
 {
 namespace ResourceArchiver
 {
+// Count of files compressed by worker threads while previous files are written
+const uint32 FILES_PER_PACK_WINDOW = 512;
+// Only small files are used to train zstd dictionary, big ones are compressed well without it
+const uint64 ZSTD_DICTIONARY_SAMPLE_MAX_SIZE = 64 * 1024;
+// Total size of training samples, zstd recommends about 100 times of dictionary size
+const uint64 ZSTD_DICTIONARY_SAMPLES_MAX_SIZE = 100 * ZstdCompressor::DEFAULT_DICTIONARY_CAPACITY;
+
 struct CollectedFile
 {
     FilePath absPath;
@@ -425,6 +434,7 @@ const Compressor* GetCompressor(Compressor::Type compressorType)
     static const std::unique_ptr<Compressor> lz4Compressor(new LZ4Compressor);
     static const std::unique_ptr<Compressor> lz4HCCompressor(new LZ4HCCompressor);
     static const std::unique_ptr<Compressor> zipCompressor(new ZipCompressor);
+    static const std::unique_ptr<Compressor> zstdCompressor(new ZstdCompressor);
 
     switch (compressorType)
     {
@@ -434,6 +444,8 @@ const Compressor* GetCompressor(Compressor::Type compressorType)
         return lz4HCCompressor.get();
     case Compressor::Type::RFC1951:
         return zipCompressor.get();
+    case Compressor::Type::Zstd:
+        return zstdCompressor.get();
     default:
     {
         DVASSERT(false, Format("Unexpected compressor type: %u", compressorType).c_str());
@@ -442,6 +454,46 @@ const Compressor* GetCompressor(Compressor::Type compressorType)
     }
 }
 
+Vector<uint8> TrainZstdDictionary(const Vector<CollectedFile>& collectedFiles)
+{
+    FileSystem* fs = FileSystem::Instance();
+
+    Vector<uint32> smallFiles;
+    uint64 smallFilesSize = 0;
+    for (uint32 fileIndex = 0; fileIndex < collectedFiles.size(); ++fileIndex)
+    {
+        uint64 fileSize = 0;
+        if (fs->GetFileSize(collectedFiles[fileIndex].absPath, fileSize) && fileSize > 0 && fileSize <= ZSTD_DICTIONARY_SAMPLE_MAX_SIZE)
+        {
+            smallFiles.push_back(fileIndex);
+            smallFilesSize += fileSize;
+        }
+    }
+
+    // take samples evenly from sorted list of files, so content of all directories is presented
+    uint64 step = std::max<uint64>(1, (smallFilesSize + ZSTD_DICTIONARY_SAMPLES_MAX_SIZE - 1) / ZSTD_DICTIONARY_SAMPLES_MAX_SIZE);
+    Vector<Vector<uint8>> samples;
+    for (size_t i = 0; i < smallFiles.size(); i += static_cast<size_t>(step))
+    {
+        Vector<uint8> sample;
+        if (fs->ReadFileContents(collectedFiles[smallFiles[i]].absPath, sample))
+        {
+            samples.push_back(std::move(sample));
+        }
+    }
+
+    Vector<uint8> dictionary = ZstdCompressor::TrainDictionary(samples);
+    if (dictionary.empty())
+    {
+        Logger::Warning("zstd dictionary is not trained on %u samples, files will be compressed without dictionary", static_cast<uint32>(samples.size()));
+    }
+    else
+    {
+        Logger::Info("zstd dictionary of %u bytes is trained on %u samples", static_cast<uint32>(dictionary.size()), static_cast<uint32>(samples.size()));
+    }
+    return dictionary;
+}
+
 bool Pack(const Vector<CollectedFile>& collectedFiles,
           const DAVA::Compressor::Type compressionType,
           const FilePath& metaDb,
@@ -493,7 +545,20 @@ bool Pack(const Vector<CollectedFile>& collectedFiles,
         return false;
     }
 
-    const size_t numOfFiles = collectedFiles.size();
+    // zstd dictionary is shared by all files of pack and is stored in meta
+    std::unique_ptr<ZstdCompressor> zstdCompressor;
+    if (compressionType == Compressor::Type::Zstd && !dummyFileData)
+    {
+        Vector<uint8> dictionary = TrainZstdDictionary(collectedFiles);
+        if (!dictionary.empty())
+        {
+            zstdCompressor.reset(new ZstdCompressor(dictionary));
+            compressor = zstdCompressor.get();
+            meta->SetCompressionDictionary(std::move(dictionary));
+        }
+    }
+
+    const uint32 numOfFiles = static_cast<uint32>(collectedFiles.size());
     PackFormat::PackFile packFile;
     packFile.filesTable.data.files.resize(numOfFiles);
     Vector<Vector<uint8>> useBuffers;
@@ -503,128 +568,153 @@ bool Pack(const Vector<CollectedFile>& collectedFiles,
     JobManager* jobManager = GetEngineContext()->jobManager;
     DVASSERT(jobManager != nullptr);
 
-    std::atomic<uint32> countLoadedFiles{ 0 };
-
-    for (uint32 fileIndex = 0; fileIndex < numOfFiles; ++fileIndex)
-    {
-        jobManager->CreateWorkerJob([&, fileIndex]()
-                                    {
-                                        const CollectedFile& collectedFile = collectedFiles[fileIndex];
-                                        PackFormat::FileTableEntry& fileEntry = packFile.filesTable.data.files[fileIndex];
-
-                                        Vector<uint8> origFileBuffer;
-                                        Vector<uint8> compressedFileBuffer;
-
-                                        bool useCompressedBuffer = (compressionType != Compressor::Type::None);
-                                        Compressor::Type useCompression = compressionType;
-
-                                        if (dummyFileData)
-                                        {
-                                            origFileBuffer.resize(1);
-                                            origFileBuffer[0] = 0;
-
-                                            useCompressedBuffer = false;
-                                            useCompression = Compressor::Type::None;
-                                        }
-                                        else
-                                        {
-                                            if (!fs->ReadFileContents(collectedFile.absPath, origFileBuffer))
-                                            {
-                                                Logger::Error("Can't read contents of: ", collectedFile.absPath.GetAbsolutePathname().c_str());
-                                                return;
-                                            }
-
-                                            if (origFileBuffer.empty())
-                                            {
-                                                useCompressedBuffer = false;
-                                                useCompression = Compressor::Type::None;
-                                            }
-
-                                            if (useCompressedBuffer)
-                                            {
-                                                if (!compressor->Compress(origFileBuffer, compressedFileBuffer))
-                                                {
-                                                    Logger::Error("Can't compress contents of: %s", collectedFile.absPath.GetAbsolutePathname().c_str());
-                                                    return;
-                                                }
-
-                                                if (compressedFileBuffer.size() < origFileBuffer.size())
-                                                {
-                                                    useCompressedBuffer = true;
-                                                }
-                                                else
-                                                {
-                                                    useCompressedBuffer = false;
-                                                    useCompression = Compressor::Type::None;
-                                                }
-                                            }
-                                        }
-
-                                        Vector<uint8>& useBuffer = (useCompressedBuffer ? compressedFileBuffer : origFileBuffer);
-
-                                        fileEntry.startPosition = 0; // later fill this field
-                                        fileEntry.originalSize = static_cast<uint32>(origFileBuffer.size());
-                                        fileEntry.compressedSize = static_cast<uint32>(useBuffer.size());
-                                        fileEntry.type = useCompression;
-                                        fileEntry.compressedCrc32 = CRC32::ForBuffer(useBuffer.data(), useBuffer.size());
-                                        fileEntry.originalCrc32 = CRC32::ForBuffer(origFileBuffer.data(), origFileBuffer.size());
-                                        if (!meta)
-                                        {
-                                            fileEntry.metaIndex = 0; // do it or your crc32 randomly change on same files
-                                        }
-                                        else
-                                        {
-                                            // we have PackArchive with vector of FileInfo's
-                                            // from PackArchive we can get fileIndex
-                                            // with fileIndex from PackMetaData we can get packIndex
-                                            // and later use metaIndex(packIndex) directly from FileInfo
-                                            // files table example
-                                            //|--------------------------------------|
-                                            //|file_path(sorted)----------|pack_index|
-                                            //|3d/gfx/uber_file.pvr       |         0|
-                                            //|--------------------------------------|
-                                            // packs table example
-                                            //|--------------------------------------|
-                                            //|pack_index|pack_name-----|pack_dep----|
-                                            //|         0|group_pack_1  |group_pack_0|
-                                            //|--------------------------------------|
-                                            // so packIndex(metaIndex) is duplicated in FileInfo's for now.
-                                            fileEntry.metaIndex = meta->GetPackIndexForFile(fileIndex);
-                                        }
-                                        useBuffers[fileIndex] = std::move(useBuffer);
-                                        ++countLoadedFiles;
-                                    });
-
-        //HACK wait jobs executed (internaly 1024 max jobs)
-        if (fileIndex > 0 && fileIndex % 1000 == 0)
-        {
-            jobManager->WaitWorkerJobs();
+    // each job sets only its own flag
+    Vector<uint8> loadedFiles(numOfFiles, 0);
+
+    auto prepareFile = [&](uint32 fileIndex)
+    {
+        const CollectedFile& collectedFile = collectedFiles[fileIndex];
+        PackFormat::FileTableEntry& fileEntry = packFile.filesTable.data.files[fileIndex];
+
+        Vector<uint8> origFileBuffer;
+        Vector<uint8> compressedFileBuffer;
+
+        bool useCompressedBuffer = (compressionType != Compressor::Type::None);
+        Compressor::Type useCompression = compressionType;
+
+        if (dummyFileData)
+        {
+            origFileBuffer.resize(1);
+            origFileBuffer[0] = 0;
+
+            useCompressedBuffer = false;
+            useCompression = Compressor::Type::None;
         }
-    } // end for fileIndex
+        else
+        {
+            if (!fs->ReadFileContents(collectedFile.absPath, origFileBuffer))
+            {
+                Logger::Error("Can't read contents of: ", collectedFile.absPath.GetAbsolutePathname().c_str());
+                return;
+            }
 
-    jobManager->WaitWorkerJobs();
+            if (origFileBuffer.empty())
+            {
+                useCompressedBuffer = false;
+                useCompression = Compressor::Type::None;
+            }
 
-    if (numOfFiles != countLoadedFiles)
-    {
-        return false;
-    }
+            if (useCompressedBuffer)
+            {
+                if (!compressor->Compress(origFileBuffer, compressedFileBuffer))
+                {
+                    Logger::Error("Can't compress contents of: %s", collectedFile.absPath.GetAbsolutePathname().c_str());
+                    return;
+                }
+
+                if (compressedFileBuffer.size() < origFileBuffer.size())
+                {
+                    useCompressedBuffer = true;
+                }
+                else
+                {
+                    useCompressedBuffer = false;
+                    useCompression = Compressor::Type::None;
+                }
+            }
+        }
+
+        Vector<uint8>& useBuffer = (useCompressedBuffer ? compressedFileBuffer : origFileBuffer);
 
-    // write all compressed content to output file and set startPosition fileEntry
-    for (size_t fileIndex = 0, dataOffset = 0; fileIndex < numOfFiles; ++fileIndex)
+        fileEntry.startPosition = 0; // later fill this field
+        fileEntry.originalSize = static_cast<uint32>(origFileBuffer.size());
+        fileEntry.compressedSize = static_cast<uint32>(useBuffer.size());
+        fileEntry.type = useCompression;
+        fileEntry.compressedCrc32 = CRC32::ForBuffer(useBuffer.data(), useBuffer.size());
+        fileEntry.originalCrc32 = CRC32::ForBuffer(origFileBuffer.data(), origFileBuffer.size());
+        if (!meta)
+        {
+            fileEntry.metaIndex = 0; // do it or your crc32 randomly change on same files
+        }
+        else
+        {
+            // we have PackArchive with vector of FileInfo's
+            // from PackArchive we can get fileIndex
+            // with fileIndex from PackMetaData we can get packIndex
+            // and later use metaIndex(packIndex) directly from FileInfo
+            // files table example
+            //|--------------------------------------|
+            //|file_path(sorted)----------|pack_index|
+            //|3d/gfx/uber_file.pvr       |         0|
+            //|--------------------------------------|
+            // packs table example
+            //|--------------------------------------|
+            //|pack_index|pack_name-----|pack_dep----|
+            //|         0|group_pack_1  |group_pack_0|
+            //|--------------------------------------|
+            // so packIndex(metaIndex) is duplicated in FileInfo's for now.
+            fileEntry.metaIndex = meta->GetPackIndexForFile(fileIndex);
+        }
+        useBuffers[fileIndex] = std::move(useBuffer);
+        loadedFiles[fileIndex] = 1;
+    };
+
+    // Files are processed by windows: while worker threads read and compress files of the next window,
+    // content of the current one is written in order of files. So output doesn't depend on jobs order
+    // and only two windows of content are kept in memory.
+    const uint32 windowsCount = (numOfFiles + FILES_PER_PACK_WINDOW - 1) / FILES_PER_PACK_WINDOW;
+    JobGroup windowGroups[2];
+    auto startWindow = [&](uint32 windowIndex)
+    {
+        uint32 begin = windowIndex * FILES_PER_PACK_WINDOW;
+        uint32 end = std::min(begin + FILES_PER_PACK_WINDOW, numOfFiles);
+        for (uint32 fileIndex = begin; fileIndex < end; ++fileIndex)
+        {
+            jobManager->CreateWorkerJob([&prepareFile, fileIndex]() { prepareFile(fileIndex); }, &windowGroups[windowIndex % 2]);
+        }
+    };
+
+    bool packOk = true;
+    uint64 dataOffset = 0;
+    startWindow(0);
+    for (uint32 windowIndex = 0; windowIndex < windowsCount; ++windowIndex)
     {
-        PackFormat::FileTableEntry& fileEntry = packFile.filesTable.data.files[fileIndex];
-        fileEntry.startPosition = dataOffset;
+        if (windowIndex + 1 < windowsCount)
+        {
+            startWindow(windowIndex + 1);
+        }
+        jobManager->WaitWorkerJobs(&windowGroups[windowIndex % 2]);
+
+        uint32 begin = windowIndex * FILES_PER_PACK_WINDOW;
+        uint32 end = std::min(begin + FILES_PER_PACK_WINDOW, numOfFiles);
 
-        const Vector<uint8>& useBuffer = useBuffers[fileIndex];
-        if (!WriteRawData(outputFile, useBuffer))
+        // after error keep waiting for started jobs, they reference local variables
+        packOk = packOk && std::all_of(loadedFiles.begin() + begin, loadedFiles.begin() + end, [](uint8 loaded) { return loaded != 0; });
+
+        // write compressed content to output file and set startPosition fileEntry
+        for (uint32 fileIndex = begin; fileIndex < end; ++fileIndex)
         {
-            Logger::Error("can't write buffer to output file");
-            return false;
+            Vector<uint8>& useBuffer = useBuffers[fileIndex];
+            if (packOk)
+            {
+                PackFormat::FileTableEntry& fileEntry = packFile.filesTable.data.files[fileIndex];
+                fileEntry.startPosition = dataOffset;
+
+                if (!WriteRawData(outputFile, useBuffer))
+                {
+                    Logger::Error("can't write buffer to output file");
+                    packOk = false;
+                }
+                dataOffset += useBuffer.size();
+            }
+            Vector<uint8>().swap(useBuffer); // free memory
         }
-        dataOffset += useBuffer.size();
     }
-    useBuffers.clear();
-    useBuffers.shrink_to_fit(); // free memory
+
+    if (!packOk)
+    {
+        return false;
+    }
 
     Vector<uint8> metaBytes;
     if (meta)
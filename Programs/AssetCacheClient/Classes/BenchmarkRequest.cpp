@@ -0,0 +1,368 @@
+#include "BenchmarkRequest.h"
+
+#include <AssetCache/AssetCacheClient.h>
+
+#include <Base/ScopedPtr.h>
+#include <Engine/Engine.h>
+#include <FileSystem/FileSystem.h>
+#include <FileSystem/KeyedArchive.h>
+#include <Logger/Logger.h>
+#include <Platform/Process.h>
+#include <Time/SystemTimer.h>
+#include <Utils/MD5.h>
+#include <Utils/Random.h>
+#include <Utils/StringFormat.h>
+
+#include <algorithm>
+
+using namespace DAVA;
+
+namespace BenchmarkRequestDetails
+{
+AssetCache::CacheItemKey CreateKey(uint32 index)
+{
+    String keyName = Format("benchmark_key_%u", index);
+
+    MD5::MD5Digest digest;
+    MD5::ForData(reinterpret_cast<const uint8*>(keyName.data()), static_cast<uint32>(keyName.size()), digest);
+
+    AssetCache::CacheItemKey key;
+    key.SetPrimaryKey(digest);
+    key.SetSecondaryKey(digest);
+    return key;
+}
+
+AssetCache::CachedItemValue CreateValue(uint32 index, uint32 size)
+{
+    std::shared_ptr<Vector<uint8>> data = std::make_shared<Vector<uint8>>(size);
+    for (uint32 i = 0; i < size; ++i)
+    {
+        (*data)[i] = static_cast<uint8>(i * 31 + index);
+    }
+
+    AssetCache::CachedItemValue::Description description;
+    description.machineName = "benchmark";
+    description.comment = "Asset Cache Client benchmark";
+
+    AssetCache::CachedItemValue value;
+    value.Add(Format("benchmark_%u.bin", index), data);
+    value.SetDescription(description);
+    value.UpdateValidationData();
+    return value;
+}
+
+struct LatencyStats
+{
+    void Add(uint64 latencyUs)
+    {
+        latencies.push_back(latencyUs);
+    }
+
+    void Dump(const char* name)
+    {
+        if (latencies.empty())
+        {
+            return;
+        }
+
+        uint64 sum = 0;
+        for (uint64 latency : latencies)
+        {
+            sum += latency;
+        }
+
+        size_t percentileIndex = latencies.size() * 95 / 100;
+        std::nth_element(latencies.begin(), latencies.begin() + percentileIndex, latencies.end());
+        uint64 percentile95 = latencies[percentileIndex];
+        uint64 maxLatency = *std::max_element(latencies.begin(), latencies.end());
+
+        Logger::Info("  %s: %u requests, average %llu us, 95%% %llu us, max %llu us",
+                     name, static_cast<uint32>(latencies.size()), sum / latencies.size(), percentile95, maxLatency);
+    }
+
+    void Save(KeyedArchive* archive, const String& key) const
+    {
+        archive->SetByteArray(key, reinterpret_cast<const uint8*>(latencies.data()), static_cast<int32>(latencies.size() * sizeof(uint64)));
+    }
+
+    void Load(const KeyedArchive* archive, const String& key)
+    {
+        const uint64* data = reinterpret_cast<const uint64*>(archive->GetByteArray(key));
+        size_t count = archive->GetByteArraySize(key) / sizeof(uint64);
+        latencies.assign(data, data + count);
+    }
+
+    Vector<uint64> latencies;
+};
+
+struct ClientResults
+{
+    void Merge(const ClientResults& results)
+    {
+        addStats.latencies.insert(addStats.latencies.end(), results.addStats.latencies.begin(), results.addStats.latencies.end());
+        getStats.latencies.insert(getStats.latencies.end(), results.getStats.latencies.begin(), results.getStats.latencies.end());
+        getHitsCount += results.getHitsCount;
+        failedCount += results.failedCount;
+        bytesCount += results.bytesCount;
+        // clients are run at once, so benchmark lasts as long as the slowest of them
+        elapsedUs = std::max(elapsedUs, results.elapsedUs);
+    }
+
+    void Dump(uint32 clientsCount, uint32 keysCount, uint32 dataSize)
+    {
+        uint32 requestsCount = static_cast<uint32>(addStats.latencies.size() + getStats.latencies.size());
+        uint64 durationUs = std::max<uint64>(elapsedUs, 1);
+
+        Logger::Info("Benchmark: %u clients, %u requests, %u keys, %u bytes per item", clientsCount, requestsCount, keysCount, dataSize);
+        Logger::Info("  elapsed %llu ms, %.1f requests/s, %.2f MB/s, %u failed requests",
+                     durationUs / 1000, requestsCount * 1000000.0 / durationUs, bytesCount / (1024.0 * 1024.0) * 1000000.0 / durationUs, failedCount);
+        addStats.Dump("add");
+        getStats.Dump("get");
+        Logger::Info("  get hits: %u of %u", getHitsCount, static_cast<uint32>(getStats.latencies.size()));
+    }
+
+    bool Save(const FilePath& path) const
+    {
+        ScopedPtr<KeyedArchive> archive(new KeyedArchive());
+        addStats.Save(archive, "add");
+        getStats.Save(archive, "get");
+        archive->SetUInt32("getHits", getHitsCount);
+        archive->SetUInt32("failed", failedCount);
+        archive->SetUInt64("bytes", bytesCount);
+        archive->SetUInt64("elapsed", elapsedUs);
+        return archive->Save(path);
+    }
+
+    bool Load(const FilePath& path)
+    {
+        ScopedPtr<KeyedArchive> archive(new KeyedArchive());
+        if (!archive->Load(path))
+        {
+            return false;
+        }
+        addStats.Load(archive, "add");
+        getStats.Load(archive, "get");
+        getHitsCount = archive->GetUInt32("getHits");
+        failedCount = archive->GetUInt32("failed");
+        bytesCount = archive->GetUInt64("bytes");
+        elapsedUs = archive->GetUInt64("elapsed");
+        return true;
+    }
+
+    LatencyStats addStats;
+    LatencyStats getStats;
+    uint32 getHitsCount = 0;
+    uint32 failedCount = 0;
+    uint64 bytesCount = 0;
+    uint64 elapsedUs = 0;
+};
+
+AssetCache::Error RunClient(AssetCacheClient& client, const ProgramOptions& options, ClientResults& results)
+{
+    const uint32 requestsCount = options.GetOption("-requests").AsUInt32();
+    const uint32 keysCount = options.GetOption("-keys").AsUInt32();
+    const uint32 dataSize = options.GetOption("-size").AsUInt32();
+    const uint32 getPercent = options.GetOption("-get").AsUInt32();
+
+    Vector<AssetCache::CacheItemKey> keys;
+    keys.reserve(keysCount);
+    for (uint32 i = 0; i < keysCount; ++i)
+    {
+        keys.push_back(CreateKey(i));
+    }
+
+    Random random(options.GetOption("-seed").AsUInt32());
+    AssetCache::Error resultCode = AssetCache::Error::NO_ERRORS;
+
+    uint64 startTime = SystemTimer::GetUs();
+    for (uint32 i = 0; i < requestsCount; ++i)
+    {
+        uint32 keyIndex = random.Rand(keysCount - 1);
+        bool isGet = random.Rand(99) < getPercent;
+
+        AssetCache::Error requestResult = AssetCache::Error::NO_ERRORS;
+        uint64 requestStartTime = SystemTimer::GetUs();
+        if (isGet)
+        {
+            AssetCache::CachedItemValue value;
+            requestResult = client.RequestFromCacheSynchronously(keys[keyIndex], &value);
+            results.getStats.Add(SystemTimer::GetUs() - requestStartTime);
+            if (requestResult == AssetCache::Error::NO_ERRORS)
+            {
+                ++results.getHitsCount;
+                results.bytesCount += value.GetSize();
+            }
+            else if (requestResult == AssetCache::Error::NOT_FOUND_ON_SERVER)
+            {
+                requestResult = AssetCache::Error::NO_ERRORS;
+            }
+        }
+        else
+        {
+            AssetCache::CachedItemValue value = CreateValue(keyIndex, dataSize);
+            requestStartTime = SystemTimer::GetUs();
+            requestResult = client.AddToCacheSynchronously(keys[keyIndex], value);
+            results.addStats.Add(SystemTimer::GetUs() - requestStartTime);
+            results.bytesCount += dataSize;
+        }
+
+        if (requestResult != AssetCache::Error::NO_ERRORS)
+        {
+            // only the first failure is logged, so output of client process stays small
+            if (results.failedCount == 0)
+            {
+                Logger::Error("[BenchmarkRequest::%s] Request %u failed: %s", __FUNCTION__, i, AssetCache::ErrorToString(requestResult).c_str());
+            }
+            ++results.failedCount;
+            resultCode = requestResult;
+        }
+    }
+    results.elapsedUs = SystemTimer::GetUs() - startTime;
+
+    return resultCode;
+}
+
+FilePath GetExecutablePath()
+{
+#if defined(__DAVAENGINE_WIN32__)
+    return FileSystem::Instance()->GetCurrentExecutableDirectory() + "AssetCacheClient.exe";
+#else
+    return FileSystem::Instance()->GetCurrentExecutableDirectory() + "AssetCacheClient";
+#endif
+}
+}
+
+BenchmarkRequest::BenchmarkRequest()
+    : CacheRequest("bench")
+{
+    options.AddOption("-clients", VariantType(static_cast<uint32>(4)), "Count of clients, each of them sends requests from its own process");
+    options.AddOption("-requests", VariantType(static_cast<uint32>(1000)), "Count of requests sent by each client");
+    options.AddOption("-keys", VariantType(static_cast<uint32>(256)), "Count of different keys used in requests");
+    options.AddOption("-size", VariantType(static_cast<uint32>(64 * 1024)), "Size of data in bytes added with each key");
+    options.AddOption("-get", VariantType(static_cast<uint32>(80)), "Percent of get requests, other requests are add requests");
+    options.AddOption("-seed", VariantType(static_cast<uint32>(12345)), "Seed of random sequence of requests, clients use consecutive seeds");
+    options.AddOption("-report", VariantType(String("")), "Internal: path to file with results of one client, written by client process");
+}
+
+AssetCache::Error BenchmarkRequest::SendRequest(AssetCacheClient& cacheClient)
+{
+    using namespace BenchmarkRequestDetails;
+
+    const uint32 clientsCount = options.GetOption("-clients").AsUInt32();
+    const FilePath reportPath = options.GetOption("-report").AsString();
+    if (clientsCount > 1 && reportPath.IsEmpty())
+    {
+        return RunConcurrentClients(clientsCount);
+    }
+
+    if (!reportPath.IsEmpty())
+    {
+        // process of one client from several ones, it shouldn't flood output with info about each request
+        GetEngineContext()->logger->SetLogLevel(Logger::LEVEL_ERROR);
+    }
+
+    ClientResults results;
+    AssetCache::Error resultCode = RunClient(cacheClient, options, results);
+
+    if (!reportPath.IsEmpty())
+    {
+        // missing report is reported by process, that runs clients
+        if (!results.Save(reportPath))
+        {
+            Logger::Error("[BenchmarkRequest::%s] Can't save report %s", __FUNCTION__, reportPath.GetAbsolutePathname().c_str());
+        }
+    }
+    else
+    {
+        results.Dump(1, options.GetOption("-keys").AsUInt32(), options.GetOption("-size").AsUInt32());
+    }
+
+    return resultCode;
+}
+
+AssetCache::Error BenchmarkRequest::RunConcurrentClients(uint32 clientsCount)
+{
+    using namespace BenchmarkRequestDetails;
+
+#if defined(__DAVAENGINE_WIN32__) || defined(__DAVAENGINE_MACOS__)
+    const FilePath reportsFolder("~doc:/Benchmark/");
+    FileSystem::Instance()->DeleteDirectory(reportsFolder, true);
+    FileSystem::Instance()->CreateDirectory(reportsFolder, true);
+
+    const uint32 seed = options.GetOption("-seed").AsUInt32();
+    Vector<String> commonArgs =
+    {
+      "bench",
+      "-clients", "1",
+      "-ip", options.GetOption("-ip").AsString(),
+      "-p", Format("%u", options.GetOption("-p").AsUInt32()),
+      "-t", Format("%llu", options.GetOption("-t").AsUInt64()),
+      "-requests", Format("%u", options.GetOption("-requests").AsUInt32()),
+      "-keys", Format("%u", options.GetOption("-keys").AsUInt32()),
+      "-size", Format("%u", options.GetOption("-size").AsUInt32()),
+      "-get", Format("%u", options.GetOption("-get").AsUInt32())
+    };
+
+    // all processes are started before waiting for any of them, so their requests are sent to server at once
+    // Process is qualified, as CacheRequest::Process hides it
+    Vector<std::unique_ptr<DAVA::Process>> processes;
+    Vector<FilePath> reportPaths;
+    for (uint32 i = 0; i < clientsCount; ++i)
+    {
+        reportPaths.push_back(reportsFolder + Format("client_%u.report", i));
+
+        Vector<String> args = commonArgs;
+        args.insert(args.end(), { "-seed", Format("%u", seed + i), "-report", reportPaths.back().GetAbsolutePathname() });
+
+        processes.emplace_back(new DAVA::Process(GetExecutablePath(), args));
+        if (!processes.back()->Run(false))
+        {
+            Logger::Error("[BenchmarkRequest::%s] Can't run client process %s", __FUNCTION__, GetExecutablePath().GetAbsolutePathname().c_str());
+            processes.pop_back();
+            break;
+        }
+    }
+
+    AssetCache::Error resultCode = (processes.size() == clientsCount) ? AssetCache::Error::NO_ERRORS : AssetCache::Error::CANNOT_SEND_REQUEST;
+    ClientResults results;
+    for (size_t i = 0; i < processes.size(); ++i)
+    {
+        processes[i]->Wait();
+
+        ClientResults clientResults;
+        bool loaded = clientResults.Load(reportPaths[i]);
+        int exitCode = processes[i]->GetExitCode();
+        if (exitCode != static_cast<int>(AssetCache::Error::NO_ERRORS) || !loaded)
+        {
+            Logger::Error("[BenchmarkRequest::%s] Client %u failed with code %d:\n%s", __FUNCTION__, static_cast<uint32>(i), exitCode, processes[i]->GetOutput().c_str());
+            resultCode = (exitCode > 0 && exitCode < static_cast<int>(AssetCache::Error::ERRORS_COUNT)) ? static_cast<AssetCache::Error>(exitCode) : AssetCache::Error::READ_FILES_ERROR;
+        }
+        results.Merge(clientResults);
+    }
+
+    results.Dump(static_cast<uint32>(processes.size()), options.GetOption("-keys").AsUInt32(), options.GetOption("-size").AsUInt32());
+
+    FileSystem::Instance()->DeleteDirectory(reportsFolder, true);
+    return resultCode;
+#else
+    Logger::Error("[BenchmarkRequest::%s] Several clients are not supported on this platform", __FUNCTION__);
+    return AssetCache::Error::WRONG_COMMAND_LINE;
+#endif
+}
+
+AssetCache::Error BenchmarkRequest::CheckOptionsInternal() const
+{
+    if (options.GetOption("-clients").AsUInt32() == 0 || options.GetOption("-keys").AsUInt32() == 0)
+    {
+        Logger::Error("[BenchmarkRequest::%s] Count of clients and keys should be greater than zero", __FUNCTION__);
+        return AssetCache::Error::WRONG_COMMAND_LINE;
+    }
+
+    if (options.GetOption("-get").AsUInt32() > 100)
+    {
+        Logger::Error("[BenchmarkRequest::%s] Percent of get requests should be in range [0, 100]", __FUNCTION__);
+        return AssetCache::Error::WRONG_COMMAND_LINE;
+    }
+
+    return AssetCache::Error::NO_ERRORS;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "CacheRequest.h"
+
+namespace DAVA
+{
+class AssetCacheClient;
+}
+
+/**
+    Load generator for Asset Cache Server.
+    Issues random mix of add and get requests over a pool of keys, then logs throughput and latency of requests.
+    Client sends its requests synchronously and network of AssetCacheClient is pumped by the calling thread,
+    so each of several clients is run in its own child process and all of them send requests to server at once.
+    Child process writes its results into report file, and results of all clients are summed up.
+*/
+class BenchmarkRequest : public CacheRequest
+{
+public:
+    BenchmarkRequest();
+
+protected:
+    DAVA::AssetCache::Error SendRequest(DAVA::AssetCacheClient& cacheClient) override;
+    DAVA::AssetCache::Error CheckOptionsInternal() const override;
+
+private:
+    DAVA::AssetCache::Error RunConcurrentClients(DAVA::uint32 clientsCount);
+};
@@ -25,12 +25,7 @@ AssetCache::Error CacheRequest::Process(AssetCacheClient& cacheClient)
         GetEngineContext()->logger->SetLogLevel(Logger::LEVEL_FRAMEWORK);
     }
 
-    AssetCacheClient::ConnectionParams params;
-    params.ip = options.GetOption("-ip").AsString();
-    params.port = static_cast<uint16>(options.GetOption("-p").AsUInt32());
-    params.timeoutms = options.GetOption("-t").AsUInt64() * 1000; // convert to ms
-
-    AssetCache::Error exitCode = cacheClient.ConnectSynchronously(params);
+    AssetCache::Error exitCode = cacheClient.ConnectSynchronously(GetConnectionParams());
     if (AssetCache::Error::NO_ERRORS == exitCode)
     {
         exitCode = SendRequest(cacheClient);
@@ -40,6 +35,15 @@ AssetCache::Error CacheRequest::Process(AssetCacheClient& cacheClient)
     return exitCode;
 }
 
+AssetCacheClient::ConnectionParams CacheRequest::GetConnectionParams() const
+{
+    AssetCacheClient::ConnectionParams params;
+    params.ip = options.GetOption("-ip").AsString();
+    params.port = static_cast<uint16>(options.GetOption("-p").AsUInt32());
+    params.timeoutms = options.GetOption("-t").AsUInt64() * 1000; // convert to ms
+    return params;
+}
+
 AssetCache::Error CacheRequest::CheckOptions() const
 {
     return CheckOptionsInternal();
@@ -22,6 +22,8 @@ protected:
     virtual DAVA::AssetCache::Error SendRequest(DAVA::AssetCacheClient& cacheClient) = 0;
     virtual DAVA::AssetCache::Error CheckOptionsInternal() const = 0;
 
+    DAVA::AssetCacheClient::ConnectionParams GetConnectionParams() const;
+
 public:
     DAVA::ProgramOptions options;
 };
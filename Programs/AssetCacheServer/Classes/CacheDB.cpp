@@ -4,6 +4,7 @@
 
 #include <AssetCache/CachedItemValue.h>
 
+#include <Concurrency/LockGuard.h>
 #include <FileSystem/File.h>
 #include <FileSystem/FileSystem.h>
 #include <FileSystem/KeyedArchive.h>
@@ -13,10 +14,39 @@
 #include <Logger/Logger.h>
 
 const DAVA::String CacheDB::DB_FILE_NAME = "cache.dat";
-const DAVA::uint32 CacheDB::VERSION = 1;
+const DAVA::uint32 CacheDB::VERSION = 2;
+const DAVA::uint32 CacheDB::VERSION_WITH_ITEM_FOLDERS = 1;
+
+// Locks shards in order of their indexes, so two threads locking all shards can't deadlock
+class CacheDB::AllShardsLock final
+{
+public:
+    AllShardsLock(CacheDB& db_)
+        : db(db_)
+    {
+        for (Shard& shard : db.shards)
+        {
+            shard.mutex.Lock();
+        }
+    }
+
+    ~AllShardsLock()
+    {
+        for (auto it = db.shards.rbegin(); it != db.shards.rend(); ++it)
+        {
+            it->mutex.Unlock();
+        }
+    }
+
+private:
+    CacheDB& db;
+};
 
 CacheDB::CacheDB(CacheDBOwner& _owner)
     : owner(_owner)
+    , occupiedSize(0)
+    , itemsInMemory(0)
+    , nextNodeId(1)
     , dbStateChanged(false)
 {
 }
@@ -31,6 +61,17 @@ void CacheDB::NotifySizeChanged()
     owner.OnStorageSizeChanged(occupiedSize, maxStorageSize);
 }
 
+DAVA::uint32 CacheDB::GetShardIndex(const DAVA::AssetCache::CacheItemKey& key)
+{
+    // keys are md5 digests, so any byte of them is distributed uniformly
+    return key[0] % SHARDS_COUNT;
+}
+
+CacheDB::Shard& CacheDB::GetShard(const DAVA::AssetCache::CacheItemKey& key)
+{
+    return shards[GetShardIndex(key)];
+}
+
 void CacheDB::UpdateSettings(const DAVA::FilePath& folderPath, const DAVA::uint64 size, const DAVA::uint32 newMaxItemsInMemory, const DAVA::uint64 _autoSaveTimeout)
 {
     bool fullCacheChanged = false;
@@ -48,6 +89,7 @@ void CacheDB::UpdateSettings(const DAVA::FilePath& folderPath, const DAVA::uint6
 
         cacheRootFolder = newCacheRootFolder;
         cacheSettings = cacheRootFolder + DB_FILE_NAME;
+        chunkStorage.SetFolder(cacheRootFolder + "chunks/");
 
         Load();
         fullCacheChanged = true;
@@ -56,22 +98,18 @@ void CacheDB::UpdateSettings(const DAVA::FilePath& folderPath, const DAVA::uint6
     if (maxStorageSize != size)
     {
         ReduceFullCacheToSize(size);
-        fullCacheChanged = true;
-
         maxStorageSize = size;
+        fullCacheChanged = true;
         NotifySizeChanged();
     }
 
     if (maxItemsInMemory != newMaxItemsInMemory)
     {
-        DAVA::int32 reducedByCount = maxItemsInMemory - newMaxItemsInMemory;
-        if (reducedByCount > 0)
+        if (newMaxItemsInMemory > 0)
         {
-            ReduceFastCacheByCount(reducedByCount);
+            ReduceFastCacheToCount(newMaxItemsInMemory);
         }
-
         maxItemsInMemory = newMaxItemsInMemory;
-        fastCache.reserve(maxItemsInMemory);
     }
 
     autoSaveTimeout = _autoSaveTimeout;
@@ -84,8 +122,10 @@ void CacheDB::UpdateSettings(const DAVA::FilePath& folderPath, const DAVA::uint6
 
 void CacheDB::Load()
 {
-    DVASSERT(fastCache.empty());
-    DVASSERT(fullCache.empty());
+    AllShardsLock lock(*this);
+
+    DVASSERT(itemsInMemory == 0);
+    DVASSERT(std::all_of(shards.begin(), shards.end(), [](const Shard& shard) { return shard.fullCache.empty(); }));
 
     DAVA::ScopedPtr<DAVA::File> file(DAVA::File::Create(cacheSettings, DAVA::File::OPEN | DAVA::File::READ));
     if (!file)
@@ -102,14 +142,18 @@ void CacheDB::Load()
         return;
     }
 
-    if (header->GetUInt32("version") != VERSION)
+    const DAVA::uint32 version = header->GetUInt32("version");
+    if (version != VERSION && version != VERSION_WITH_ITEM_FOLDERS)
     {
         DVASSERT(false, "cachedb file version is changed. Versions load functions should be implemented");
         return;
     }
 
     DAVA::uint64 cacheSize = header->GetUInt64("itemsCount");
-    fullCache.reserve(static_cast<size_t>(cacheSize));
+    for (Shard& shard : shards)
+    {
+        shard.fullCache.reserve(static_cast<size_t>(cacheSize / SHARDS_COUNT));
+    }
 
     DAVA::ScopedPtr<DAVA::KeyedArchive> cache(new DAVA::KeyedArchive());
     if (!cache->Load(file))
@@ -118,7 +162,9 @@ void CacheDB::Load()
         return;
     }
 
-    occupiedSize = 0;
+    DAVA::Vector<std::pair<Shard*, CacheNode*>> loadedNodes;
+    loadedNodes.reserve(static_cast<size_t>(cacheSize));
+
     for (DAVA::uint64 index = 0; index < cacheSize; ++index)
     {
         DAVA::KeyedArchive* itemArchieve = cache->GetArchive(DAVA::Format("item_%d", index));
@@ -127,173 +173,341 @@ void CacheDB::Load()
         DAVA::AssetCache::CacheItemKey key;
         key.Deserialize(itemArchieve);
 
-        ServerCacheEntry entry;
-        entry.Deserialize(itemArchieve);
+        Shard& shard = GetShard(key);
+        auto inserted = shard.fullCache.emplace(key, CacheNode()).first;
+        CacheNode& node = inserted->second;
+        node.key = &inserted->first;
+        node.id = nextNodeId++;
+        node.entry.Deserialize(itemArchieve);
+
+        if (version == VERSION)
+        {
+            RestoreChunks(node.entry);
+        }
+        else if (!MoveToChunkStorage(key, node.entry))
+        {
+            shard.fullCache.erase(inserted);
+            continue;
+        }
+        loadedNodes.emplace_back(&shard, &node);
+    }
+
+    if (version == VERSION)
+    {
+        chunkStorage.RemoveUnreferencedFiles();
+    }
 
-        occupiedSize += entry.GetValue().GetSize();
-        fullCache[key] = std::move(entry);
+    // restore LRU order from saved access timestamps, the most recent item is pushed last
+    std::sort(loadedNodes.begin(), loadedNodes.end(), [](const std::pair<Shard*, CacheNode*>& left, const std::pair<Shard*, CacheNode*>& right) {
+        return left.second->entry.GetTimestamp() < right.second->entry.GetTimestamp();
+    });
+    for (const std::pair<Shard*, CacheNode*>& loaded : loadedNodes)
+    {
+        loaded.first->fullLRU.PushFront(loaded.second);
     }
 
+    occupiedSize = chunkStorage.GetStoredSize();
     NotifySizeChanged();
-    dbStateChanged = false;
+    dbStateChanged = (version != VERSION);
+}
+
+bool CacheDB::MoveToChunkStorage(const DAVA::AssetCache::CacheItemKey& key, ServerCacheEntry& entry)
+{
+    DAVA::FilePath itemFolder = CreateFolderPath(key);
+    bool fetched = entry.Fetch(itemFolder);
+    if (fetched)
+    {
+        entry.SetChunks(entry.GetValue().SplitIntoChunks());
+        bool stored = StoreChunks(entry);
+        entry.Free();
+        if (!stored)
+        {
+            // files of item are kept, so item can be converted on next load
+            DAVA::Logger::Error("[CacheDB::%s] Store error. Entry '%s' will be removed from cache", __FUNCTION__, Brief(key).c_str());
+            return false;
+        }
+    }
+    else
+    {
+        DAVA::Logger::Error("[CacheDB::%s] Fetch error. Entry '%s' will be removed from cache", __FUNCTION__, Brief(key).c_str());
+    }
+
+    DAVA::FileSystem::Instance()->DeleteDirectory(itemFolder);
+    return fetched;
+}
+
+bool CacheDB::StoreChunks(const ServerCacheEntry& entry)
+{
+    DAVA::Vector<const DAVA::AssetCache::ContentChunker::Chunk*> storedChunks;
+    for (const auto& fileChunks : entry.GetChunks())
+    {
+        const DAVA::Vector<DAVA::uint8>* data = entry.GetValue().GetFileData(fileChunks.first);
+        DVASSERT(data != nullptr);
+        for (const DAVA::AssetCache::ContentChunker::Chunk& chunk : fileChunks.second)
+        {
+            DAVA::uint64 writtenSize = 0;
+            if (!chunkStorage.AddReference(chunk.digest, data->data() + chunk.offset, chunk.size, writtenSize))
+            {
+                // references added before the failure are removed, so storage doesn't reference chunks of entry
+                for (const DAVA::AssetCache::ContentChunker::Chunk* storedChunk : storedChunks)
+                {
+                    occupiedSize -= chunkStorage.RemoveReference(storedChunk->digest);
+                }
+                return false;
+            }
+            occupiedSize += writtenSize;
+            storedChunks.push_back(&chunk);
+        }
+    }
+    return true;
+}
+
+DAVA::uint64 CacheDB::ReleaseChunks(const ServerCacheEntry& entry)
+{
+    DAVA::uint64 freedSize = 0;
+    for (const auto& fileChunks : entry.GetChunks())
+    {
+        for (const DAVA::AssetCache::ContentChunker::Chunk& chunk : fileChunks.second)
+        {
+            freedSize += chunkStorage.RemoveReference(chunk.digest);
+        }
+    }
+    return freedSize;
+}
+
+void CacheDB::RestoreChunks(const ServerCacheEntry& entry)
+{
+    for (const auto& fileChunks : entry.GetChunks())
+    {
+        for (const DAVA::AssetCache::ContentChunker::Chunk& chunk : fileChunks.second)
+        {
+            chunkStorage.RestoreReference(chunk.digest, chunk.size);
+        }
+    }
+}
+
+void CacheDB::FindStoredChunks(const DAVA::Vector<DAVA::MD5::MD5Digest>& digests, DAVA::Vector<DAVA::uint8>& storedFlags) const
+{
+    storedFlags.resize(digests.size());
+    for (size_t i = 0; i < digests.size(); ++i)
+    {
+        storedFlags[i] = chunkStorage.Contains(digests[i]) ? 1 : 0;
+    }
+}
+
+bool CacheDB::ReadChunk(const DAVA::MD5::MD5Digest& digest, DAVA::uint8* data, DAVA::uint32 size) const
+{
+    return chunkStorage.Read(digest, data, size);
 }
 
 void CacheDB::Unload()
 {
     Save();
 
-    for (auto& entry : fastCache)
     {
-        entry.second->Free();
+        AllShardsLock lock(*this);
+        for (Shard& shard : shards)
+        {
+            while (CacheNode* node = shard.fastLRU.GetLeastRecentlyUsed())
+            {
+                RemoveFromFastCache(shard, *node);
+            }
+            shard.fullLRU.Clear();
+            shard.fullCache.clear();
+        }
+        chunkStorage.Unload();
+        occupiedSize = 0;
     }
-
-    fastCache.clear();
-    fullCache.clear();
-    occupiedSize = 0;
     NotifySizeChanged();
 }
 
 void CacheDB::Save()
 {
+    DAVA::ScopedPtr<DAVA::KeyedArchive> cache(new DAVA::KeyedArchive());
+    DAVA::uint64 itemsCount = 0;
+    {
+        // items are serialized into memory under lock, file is written after shards are unlocked
+        AllShardsLock lock(*this);
+        for (const Shard& shard : shards)
+        {
+            for (auto& item : shard.fullCache)
+            {
+                DAVA::ScopedPtr<DAVA::KeyedArchive> itemArchieve(new DAVA::KeyedArchive());
+                item.first.Serialize(itemArchieve);
+                item.second.entry.Serialize(itemArchieve);
+
+                cache->SetArchive(DAVA::Format("item_%d", itemsCount++), itemArchieve);
+            }
+        }
+        dbStateChanged = false;
+    }
+
+    DAVA::ScopedPtr<DAVA::KeyedArchive> header(new DAVA::KeyedArchive());
+    header->SetString("signature", "cache");
+    header->SetUInt32("version", VERSION);
+    header->SetUInt64("itemsCount", itemsCount);
+
     DAVA::FileSystem::Instance()->CreateDirectory(cacheRootFolder, true);
 
     DAVA::ScopedPtr<DAVA::File> file(DAVA::File::Create(cacheSettings, DAVA::File::CREATE | DAVA::File::WRITE));
     if (!file)
     {
         DAVA::Logger::Error("[CacheDB::%s] Cannot create file %s", __FUNCTION__, cacheSettings.GetStringValue().c_str());
+        dbStateChanged = true;
         return;
     }
 
-    DAVA::ScopedPtr<DAVA::KeyedArchive> header(new DAVA::KeyedArchive());
-    header->SetString("signature", "cache");
-    header->SetUInt32("version", VERSION);
-    header->SetUInt64("itemsCount", fullCache.size());
     header->Save(file);
-
-    DAVA::ScopedPtr<DAVA::KeyedArchive> cache(new DAVA::KeyedArchive());
-    DAVA::uint64 index = 0;
-    for (auto& item : fullCache)
-    {
-        DAVA::ScopedPtr<DAVA::KeyedArchive> itemArchieve(new DAVA::KeyedArchive());
-        item.first.Serialize(itemArchieve);
-        item.second.Serialize(itemArchieve);
-
-        cache->SetArchive(DAVA::Format("item_%d", index++), itemArchieve);
-    }
     cache->Save(file);
 
-    dbStateChanged = false;
+    DAVA::uint64 itemsDataSize = chunkStorage.GetReferencedSize();
+    DAVA::uint64 storedSize = chunkStorage.GetStoredSize();
+    DAVA::Logger::Info("Cache saved: %llu items, %llu bytes of data stored in %llu bytes of chunks (deduplication ratio %.2f)",
+                       itemsCount, itemsDataSize, storedSize, (storedSize > 0) ? static_cast<DAVA::float64>(itemsDataSize) / storedSize : 1.0);
+
     lastSaveTime = DAVA::SystemTimer::GetMs();
 }
 
+template <typename TList>
+CacheDB::Shard* CacheDB::FindShardWithOldestItem(TList Shard::*list)
+{
+    // shards are locked one by one, so search doesn't stop requests to all of them at once
+    Shard* oldestShard = nullptr;
+    DAVA::uint64 oldestTimestamp = 0;
+    for (Shard& shard : shards)
+    {
+        DAVA::LockGuard<DAVA::Mutex> lock(shard.mutex);
+        CacheNode* node = (shard.*list).GetLeastRecentlyUsed();
+        if (node != nullptr && (oldestShard == nullptr || node->entry.GetTimestamp() < oldestTimestamp))
+        {
+            oldestShard = &shard;
+            oldestTimestamp = node->entry.GetTimestamp();
+        }
+    }
+    return oldestShard;
+}
+
 void CacheDB::ReduceFullCacheToSize(DAVA::uint64 toSize)
 {
     while (occupiedSize > toSize)
     {
-        const auto& found = std::min_element(fullCache.begin(), fullCache.end(), [](const CacheMap::value_type& left, const CacheMap::value_type& right) -> bool
-                                             {
-                                                 return left.second.GetTimestamp() < right.second.GetTimestamp();
-                                             });
-        if (found != fullCache.end())
+        // global least recently used item is the oldest one among least recently used items of shards
+        Shard* oldestShard = FindShardWithOldestItem(&Shard::fullLRU);
+        if (oldestShard == nullptr)
         {
-            Remove(found);
+            // chunks of items being inserted right now are already counted in occupied size
+            break;
         }
-        else
+
+        ServerCacheEntry removedEntry;
         {
-            if (occupiedSize > 0)
+            // shard could be changed after search, its least recently used item is evicted anyway
+            DAVA::LockGuard<DAVA::Mutex> lock(oldestShard->mutex);
+            CacheNode* node = oldestShard->fullLRU.GetLeastRecentlyUsed();
+            if (node == nullptr)
             {
-                DAVA::Logger::Warning("Occupied size is %u, should be 0", occupiedSize);
-                occupiedSize = 0;
-                NotifySizeChanged();
-                break;
+                continue;
             }
+            removedEntry = Detach(*oldestShard, oldestShard->fullCache.find(*node->key));
         }
+        Release(removedEntry);
     }
 }
 
-void CacheDB::ReduceFastCacheByCount(DAVA::uint32 countToRemove)
+void CacheDB::ReduceFastCacheToCount(DAVA::uint32 toCount)
 {
-    for (; countToRemove > 0; --countToRemove)
+    while (itemsInMemory > toCount)
     {
-        const auto& oldestFound = std::min_element(fastCache.begin(), fastCache.end(), [](const FastCacheMap::value_type& left, const FastCacheMap::value_type& right) -> bool
-                                                   {
-                                                       return left.second->GetTimestamp() < right.second->GetTimestamp();
-                                                   });
-
-        if (oldestFound != fastCache.end())
+        Shard* oldestShard = FindShardWithOldestItem(&Shard::fastLRU);
+        if (oldestShard == nullptr)
         {
-            RemoveFromFastCache(oldestFound);
+            return;
         }
-        else
+
+        DAVA::LockGuard<DAVA::Mutex> lock(oldestShard->mutex);
+        CacheNode* node = oldestShard->fastLRU.GetLeastRecentlyUsed();
+        if (node != nullptr)
         {
-            return;
+            RemoveFromFastCache(*oldestShard, *node);
         }
     }
 }
 
-ServerCacheEntry* CacheDB::Get(const DAVA::AssetCache::CacheItemKey& key)
+void CacheDB::ReduceIfNeeded()
 {
-    ServerCacheEntry* entry = FindInFastCache(key);
-
-    if (nullptr == entry)
+    if (occupiedSize > maxStorageSize)
     {
-        entry = FindInFullCache(key);
-        if (nullptr != entry)
-        {
-            const DAVA::FilePath path = CreateFolderPath(key);
-
-            if (true == entry->Fetch(path))
-            {
-                InsertInFastCache(key, entry);
-            }
-            else
-            {
-                DAVA::Logger::Error("[CacheDB::%s] Fetch error. Entry '%s' will be removed from cache", __FUNCTION__, Brief(key).c_str());
-                if (false == Remove(key))
-                {
-                    DAVA::Logger::Error("[CacheDB::%s] Cannot find item in cache");
-                }
-                entry = nullptr;
-            }
-        }
+        ReduceFullCacheToSize(maxStorageSize);
+    }
+    if (maxItemsInMemory > 0 && itemsInMemory > maxItemsInMemory)
+    {
+        ReduceFastCacheToCount(maxItemsInMemory);
     }
-
-    UpdateAccessTimestamp(entry);
-
-    return entry;
 }
 
-ServerCacheEntry* CacheDB::FindInFastCache(const DAVA::AssetCache::CacheItemKey& key) const
+bool CacheDB::Get(const DAVA::AssetCache::CacheItemKey& key, DAVA::AssetCache::CachedItemValue& value)
 {
-    auto found = fastCache.find(key);
-    if (found != fastCache.cend())
+    Shard& shard = GetShard(key);
+
+    ServerCacheEntry fetchedEntry;
+    DAVA::uint64 nodeId = 0;
     {
-        return found->second;
+        DAVA::LockGuard<DAVA::Mutex> lock(shard.mutex);
+
+        auto found = shard.fullCache.find(key);
+        if (found == shard.fullCache.end())
+        {
+            return false;
+        }
+
+        CacheNode& node = found->second;
+        Touch(shard, node);
+        if (shard.fastLRU.IsLinked(&node))
+        {
+            value = node.entry.GetValue();
+            return true;
+        }
+
+        // value without data and list of chunks are copied, chunks are read after lock is released
+        DAVA::AssetCache::CachedItemValue::FileChunks chunks = node.entry.GetChunks();
+        fetchedEntry = ServerCacheEntry(node.entry.GetValue(), std::move(chunks));
+        nodeId = node.id;
     }
 
-    return nullptr;
-}
+    bool fetched = fetchedEntry.Fetch(chunkStorage);
 
-ServerCacheEntry* CacheDB::FindInFullCache(const DAVA::AssetCache::CacheItemKey& key)
-{
-    auto found = fullCache.find(key);
-    if (found != fullCache.cend())
+    ServerCacheEntry removedEntry;
     {
-        return &found->second;
-    }
+        DAVA::LockGuard<DAVA::Mutex> lock(shard.mutex);
 
-    return nullptr;
-}
+        // item could be removed or replaced while chunks were read
+        auto found = shard.fullCache.find(key);
+        bool isSameNode = (found != shard.fullCache.end() && found->second.id == nodeId);
+        if (!fetched)
+        {
+            DAVA::Logger::Error("[CacheDB::%s] Fetch error. Entry '%s' will be removed from cache", __FUNCTION__, Brief(key).c_str());
+            if (isSameNode)
+            {
+                removedEntry = Detach(shard, found);
+            }
+        }
+        else if (isSameNode && !shard.fastLRU.IsLinked(&found->second))
+        {
+            found->second.entry.GetValue() = fetchedEntry.GetValue();
+            shard.fastLRU.PushFront(&found->second);
+            ++itemsInMemory;
+        }
+    }
 
-const ServerCacheEntry* CacheDB::FindInFullCache(const DAVA::AssetCache::CacheItemKey& key) const
-{
-    auto found = fullCache.find(key);
-    if (found != fullCache.cend())
+    if (!fetched)
     {
-        return &found->second;
+        Release(removedEntry);
+        return false;
     }
 
-    return nullptr;
+    value = fetchedEntry.GetValue();
+    ReduceIfNeeded();
+    return true;
 }
 
 void CacheDB::ClearStorage()
@@ -303,130 +517,138 @@ void CacheDB::ClearStorage()
 
 void CacheDB::Insert(const DAVA::AssetCache::CacheItemKey& key, const DAVA::AssetCache::CachedItemValue& value)
 {
-    ServerCacheEntry entry(value);
-    Insert(key, std::forward<ServerCacheEntry>(entry));
-}
-
-void CacheDB::Insert(const DAVA::AssetCache::CacheItemKey& key, ServerCacheEntry&& entry)
-{
-    if (entry.GetValue().GetSize() > maxStorageSize)
+    if (value.GetSize() > maxStorageSize)
     {
         if (maxStorageSize > 0)
         {
-            DAVA::Logger::Warning("Inserted data size %llu is bigger than max storage size %llu", entry.GetValue().GetSize(), maxStorageSize);
+            DAVA::Logger::Warning("Inserted data size %llu is bigger than max storage size %llu", value.GetSize(), maxStorageSize);
         }
         return;
     }
 
-    auto found = fullCache.find(key);
-    if (found != fullCache.end())
+    // chunking and writing of chunks are done before lock, so they don't block requests to other items of shard
+    ServerCacheEntry entry(value, value.SplitIntoChunks());
+    if (!StoreChunks(entry))
     {
-        Remove(found);
+        DAVA::Logger::Error("[CacheDB::%s] Store error. Entry '%s' is not inserted into cache", __FUNCTION__, Brief(key).c_str());
+        NotifySizeChanged();
+        return;
     }
 
-    DAVA::Logger::Debug("Inserting into cache: key %s", Brief(key).c_str());
-    fullCache[key] = std::move(entry);
-    ServerCacheEntry* insertedEntry = &fullCache[key];
-    DAVA::FilePath savedPath = CreateFolderPath(key);
-    insertedEntry->GetValue().ExportToFolder(savedPath);
-    insertedEntry->UpdateAccessTimestamp();
-    occupiedSize += insertedEntry->GetValue().GetSize();
-    NotifySizeChanged();
-
-    InsertInFastCache(key, insertedEntry);
-
-    if (occupiedSize > maxStorageSize)
+    ServerCacheEntry replacedEntry;
+    Shard& shard = GetShard(key);
     {
-        ReduceFullCacheToSize(maxStorageSize);
-        DVASSERT(fullCache.find(key) != fullCache.end());
-    }
+        DAVA::LockGuard<DAVA::Mutex> lock(shard.mutex);
 
-    dbStateChanged = true;
-}
+        auto found = shard.fullCache.find(key);
+        if (found != shard.fullCache.end())
+        {
+            replacedEntry = Detach(shard, found);
+        }
 
-void CacheDB::InsertInFastCache(const DAVA::AssetCache::CacheItemKey& key, ServerCacheEntry* entry)
-{
-    if (fastCache.count(key) != 0)
-    {
-        return;
+        DAVA::Logger::Debug("Inserting into cache: key %s", Brief(key).c_str());
+        auto inserted = shard.fullCache.emplace(key, CacheNode()).first;
+        CacheNode& node = inserted->second;
+        node.key = &inserted->first;
+        node.id = nextNodeId++;
+        node.entry = std::move(entry);
+
+        shard.fullLRU.PushFront(&node);
+        DVASSERT(node.entry.GetValue().IsFetched() == true);
+        shard.fastLRU.PushFront(&node);
+        ++itemsInMemory;
+        Touch(shard, node);
     }
 
-    if (maxItemsInMemory == fastCache.size() && maxItemsInMemory > 0)
-    {
-        ReduceFastCacheByCount(1);
-    }
+    // chunks shared by old and new values are referenced by new one already, so they are not deleted
+    Release(replacedEntry);
+    NotifySizeChanged();
 
-    DVASSERT(entry->GetValue().IsFetched() == true);
+    // inserted item is the most recently used, so it is not evicted
+    ReduceIfNeeded();
 
-    fastCache[key] = entry;
+    dbStateChanged = true;
 }
 
 void CacheDB::UpdateAccessTimestamp(const DAVA::AssetCache::CacheItemKey& key)
 {
-    ServerCacheEntry* entry = FindInFastCache(key);
-    if (nullptr == entry)
+    Shard& shard = GetShard(key);
+    DAVA::LockGuard<DAVA::Mutex> lock(shard.mutex);
+
+    auto found = shard.fullCache.find(key);
+    if (found != shard.fullCache.end())
     {
-        entry = FindInFullCache(key);
+        Touch(shard, found->second);
     }
-
-    UpdateAccessTimestamp(entry);
 }
 
-void CacheDB::UpdateAccessTimestamp(ServerCacheEntry* entry)
+void CacheDB::Touch(Shard& shard, CacheNode& node)
 {
-    if (nullptr != entry)
+    node.entry.UpdateAccessTimestamp();
+    shard.fullLRU.Touch(&node);
+    if (shard.fastLRU.IsLinked(&node))
     {
-        entry->UpdateAccessTimestamp();
-        dbStateChanged = true;
+        shard.fastLRU.Touch(&node);
     }
+    dbStateChanged = true;
 }
 
 bool CacheDB::Remove(const DAVA::AssetCache::CacheItemKey& key)
 {
-    auto found = fullCache.find(key);
-    if (found != fullCache.end())
+    ServerCacheEntry removedEntry;
+    Shard& shard = GetShard(key);
     {
-        Remove(found);
-        return true;
+        DAVA::LockGuard<DAVA::Mutex> lock(shard.mutex);
+
+        auto found = shard.fullCache.find(key);
+        if (found == shard.fullCache.end())
+        {
+            return false;
+        }
+        removedEntry = Detach(shard, found);
     }
 
-    return false;
+    Release(removedEntry);
+    return true;
 }
 
-void CacheDB::Remove(const CacheMap::iterator& it)
+ServerCacheEntry CacheDB::Detach(Shard& shard, CacheMap::iterator it)
 {
-    auto found = fastCache.find(it->first);
-    if (found != fastCache.end())
+    DVASSERT(it != shard.fullCache.end());
+
+    CacheNode& node = it->second;
+    if (shard.fastLRU.IsLinked(&node))
     {
-        RemoveFromFastCache(found);
+        RemoveFromFastCache(shard, node);
     }
+    shard.fullLRU.Remove(&node);
 
-    RemoveFromFullCache(it);
+    DAVA::Logger::Debug("Removing from full cache: key %s", Brief(it->first).c_str());
+    ServerCacheEntry entry(std::move(node.entry));
+    shard.fullCache.erase(it);
     dbStateChanged = true;
+    return entry;
 }
 
-void CacheDB::RemoveFromFullCache(const CacheMap::iterator& it)
+void CacheDB::Release(const ServerCacheEntry& entry)
 {
-    DVASSERT(it != fullCache.end());
-
-    DAVA::FilePath dataPath = CreateFolderPath(it->first);
-    DAVA::FileSystem::Instance()->DeleteDirectory(dataPath);
+    if (entry.GetChunks().empty())
+    {
+        return;
+    }
 
-    DAVA::uint64 itemSize = it->second.GetValue().GetSize();
-    DVASSERT(itemSize <= occupiedSize);
-    occupiedSize -= itemSize;
-    DAVA::Logger::Debug("Removing from full cache: key %s", Brief(it->first).c_str());
-    fullCache.erase(it);
+    DAVA::uint64 freedSize = ReleaseChunks(entry);
+    DVASSERT(freedSize <= occupiedSize);
+    occupiedSize -= freedSize;
     NotifySizeChanged();
 }
 
-void CacheDB::RemoveFromFastCache(const FastCacheMap::iterator& it)
+void CacheDB::RemoveFromFastCache(Shard& shard, CacheNode& node)
 {
-    DVASSERT(it != fastCache.end());
-
-    DVASSERT(it->second->GetValue().IsFetched() == true);
-    it->second->Free();
-    fastCache.erase(it);
+    DVASSERT(node.entry.GetValue().IsFetched() == true);
+    node.entry.Free();
+    shard.fastLRU.Remove(&node);
+    --itemsInMemory;
 }
 
 DAVA::FilePath CacheDB::CreateFolderPath(const DAVA::AssetCache::CacheItemKey& key) const
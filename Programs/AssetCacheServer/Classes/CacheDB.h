@@ -1,8 +1,13 @@
 #pragma once
 
+#include "ChunkStorage.h"
+#include "LRUList.h"
+#include "ServerCacheEntry.h"
+
 #include <AssetCache/CacheItemKey.h>
 
 #include <Base/BaseTypes.h>
+#include <Concurrency/Mutex.h>
 #include <FileSystem/FilePath.h>
 
 #include <atomic>
@@ -15,22 +20,54 @@ class CachedItemValue;
 }
 }
 
-class ServerCacheEntry;
-
 struct CacheDBOwner
 {
     virtual void OnStorageSizeChanged(DAVA::uint64 occupied, DAVA::uint64 overall) = 0;
 };
 
+/**
+    Storage of cached items.
+    Items are distributed over shards by key, each shard has its own lock, so requests with different keys
+    don't wait for each other. Items of shard are kept in two intrusive LRU lists: all items and items fetched into memory.
+    Eviction takes the least recently used item among tails of shard lists, so it is O(shards count) instead of scan of all items.
+    Shard locks guard only maps and lists: chunks of items are read, written and deleted after the lock is released.
+    Data of items is split into content defined chunks and kept in chunk storage, so identical parts of items are stored once.
+    Occupied size is size of unique chunks.
+    All public methods can be called from several threads.
+*/
 class CacheDB final
 {
     static const DAVA::String DB_FILE_NAME;
     static const DAVA::uint32 VERSION;
-
-    using CacheMap = DAVA::UnorderedMap<DAVA::AssetCache::CacheItemKey, ServerCacheEntry>;
-    using FastCacheMap = DAVA::UnorderedMap<DAVA::AssetCache::CacheItemKey, ServerCacheEntry*>;
+    static const DAVA::uint32 VERSION_WITH_ITEM_FOLDERS; // files of items were stored in folder per item
+
+    struct CacheNode
+    {
+        ServerCacheEntry entry;
+        const DAVA::AssetCache::CacheItemKey* key = nullptr; // key of node in shard map
+        DAVA::uint64 id = 0; // unique for each inserted item, to find the same node after shard lock was released
+        LRUListHook<CacheNode> fullHook;
+        LRUListHook<CacheNode> fastHook; // linked while value is fetched into memory
+    };
+
+    using CacheMap = DAVA::UnorderedMap<DAVA::AssetCache::CacheItemKey, CacheNode>;
+    using FullLRUList = LRUList<CacheNode, &CacheNode::fullHook>;
+    using FastLRUList = LRUList<CacheNode, &CacheNode::fastHook>;
+
+    struct Shard
+    {
+        DAVA::Mutex mutex;
+        CacheMap fullCache; //stored on disk, strong storage
+        FullLRUList fullLRU;
+        FastLRUList fastLRU; //runtime, week storage
+    };
 
 public:
+    static const DAVA::uint32 SHARDS_COUNT = 16;
+
+    /** Index of shard, that keeps item with `key`. */
+    static DAVA::uint32 GetShardIndex(const DAVA::AssetCache::CacheItemKey& key);
+
     CacheDB(CacheDBOwner& owner);
     ~CacheDB();
 
@@ -39,42 +76,56 @@ public:
     void Save();
     void Load();
 
-    ServerCacheEntry* Get(const DAVA::AssetCache::CacheItemKey& key);
+    /** Copy value of item into `value`, value data is shared with cache, so copy is cheap. */
+    bool Get(const DAVA::AssetCache::CacheItemKey& key, DAVA::AssetCache::CachedItemValue& value);
 
     void Insert(const DAVA::AssetCache::CacheItemKey& key, const DAVA::AssetCache::CachedItemValue& value);
     bool Remove(const DAVA::AssetCache::CacheItemKey& key);
     void ClearStorage();
     void UpdateAccessTimestamp(const DAVA::AssetCache::CacheItemKey& key);
 
+    /** Set flag for each of `digests`, if chunk with such digest is stored. */
+    void FindStoredChunks(const DAVA::Vector<DAVA::MD5::MD5Digest>& digests, DAVA::Vector<DAVA::uint8>& storedFlags) const;
+    bool ReadChunk(const DAVA::MD5::MD5Digest& digest, DAVA::uint8* data, DAVA::uint32 size) const;
+
     const DAVA::FilePath& GetPath() const;
     const DAVA::uint64 GetStorageSize() const;
     const DAVA::uint64 GetAvailableSize() const;
     const DAVA::uint64 GetOccupiedSize() const;
+    /** Size of items data without deduplication */
+    const DAVA::uint64 GetItemsDataSize() const;
 
     void Update();
 
 private:
-    void Insert(const DAVA::AssetCache::CacheItemKey& key, ServerCacheEntry&& entry);
+    class AllShardsLock;
+
+    Shard& GetShard(const DAVA::AssetCache::CacheItemKey& key);
 
     DAVA::FilePath CreateFolderPath(const DAVA::AssetCache::CacheItemKey& key) const;
 
     void Unload();
 
-    ServerCacheEntry* FindInFastCache(const DAVA::AssetCache::CacheItemKey& key) const;
-    ServerCacheEntry* FindInFullCache(const DAVA::AssetCache::CacheItemKey& key);
-    const ServerCacheEntry* FindInFullCache(const DAVA::AssetCache::CacheItemKey& key) const;
-
-    void InsertInFastCache(const DAVA::AssetCache::CacheItemKey& key, ServerCacheEntry* entry);
+    void Touch(Shard& shard, CacheNode& node);
 
-    void UpdateAccessTimestamp(ServerCacheEntry* entry);
+    bool StoreChunks(const ServerCacheEntry& entry);
+    DAVA::uint64 ReleaseChunks(const ServerCacheEntry& entry);
+    void RestoreChunks(const ServerCacheEntry& entry);
+    bool MoveToChunkStorage(const DAVA::AssetCache::CacheItemKey& key, ServerCacheEntry& entry);
 
+    // should be called without locks of shards, each victim is chosen under lock of its shard
+    template <typename TList>
+    Shard* FindShardWithOldestItem(TList Shard::*list);
     void ReduceFullCacheToSize(DAVA::uint64 toSize);
-    void ReduceFastCacheByCount(DAVA::uint32 countToRemove);
+    void ReduceFastCacheToCount(DAVA::uint32 toCount);
+    void ReduceIfNeeded();
 
-    void RemoveFromFastCache(const FastCacheMap::iterator& it);
-    void RemoveFromFullCache(const CacheMap::iterator& it);
+    // should be called with lock of shard
+    void RemoveFromFastCache(Shard& shard, CacheNode& node);
+    ServerCacheEntry Detach(Shard& shard, CacheMap::iterator it);
 
-    void Remove(const CacheMap::iterator& it);
+    // should be called without locks of shards, as chunk files of detached entry are deleted
+    void Release(const ServerCacheEntry& entry);
 
     void NotifySizeChanged();
 
@@ -87,14 +138,15 @@ private:
     DAVA::uint64 maxStorageSize = 0; //maximum cache size
     DAVA::uint32 maxItemsInMemory = 0; //count of items in memory, to use for fast access
 
-    DAVA::uint64 occupiedSize = 0; //used by CacheItemValues
-    DAVA::uint64 nextItemID = 0; //item counter, used as last access time token
+    std::atomic<DAVA::uint64> occupiedSize; //used by CacheItemValues
+    std::atomic<DAVA::uint32> itemsInMemory; //count of fetched items in all shards
+    std::atomic<DAVA::uint64> nextNodeId;
 
     DAVA::uint64 autoSaveTimeout = 0;
     DAVA::uint64 lastSaveTime = 0;
 
-    FastCacheMap fastCache; //runtime, week storage
-    CacheMap fullCache; //stored on disk, strong storage
+    DAVA::Array<Shard, SHARDS_COUNT> shards;
+    ChunkStorage chunkStorage;
 
     std::atomic<bool> dbStateChanged; //flag about changes in db
 };
@@ -113,3 +165,8 @@ inline const DAVA::uint64 CacheDB::GetOccupiedSize() const
 {
     return occupiedSize;
 }
+
+inline const DAVA::uint64 CacheDB::GetItemsDataSize() const
+{
+    return chunkStorage.GetReferencedSize();
+}
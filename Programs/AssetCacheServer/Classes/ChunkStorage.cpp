@@ -0,0 +1,202 @@
+#include "ChunkStorage.h"
+
+#include <Concurrency/LockGuard.h>
+#include <Debug/DVAssert.h>
+#include <FileSystem/File.h>
+#include <FileSystem/FileList.h>
+#include <FileSystem/FileSystem.h>
+#include <Logger/Logger.h>
+
+void ChunkStorage::SetFolder(const DAVA::FilePath& folder_)
+{
+    DAVA::LockGuard<DAVA::Mutex> lock(mutex);
+    DVASSERT(chunks.empty());
+
+    folder = folder_;
+    folder.MakeDirectoryPathname();
+}
+
+bool ChunkStorage::AddReference(const DAVA::MD5::MD5Digest& digest, const DAVA::uint8* data, DAVA::uint32 size, DAVA::uint64& writtenSize)
+{
+    writtenSize = 0;
+
+    // file lock of digest is held until chunk is registered, so the same chunk can't be written or deleted concurrently
+    DAVA::LockGuard<DAVA::Mutex> fileLock(GetFileMutex(digest));
+    {
+        DAVA::LockGuard<DAVA::Mutex> lock(mutex);
+
+        auto found = chunks.find(digest);
+        if (found != chunks.end())
+        {
+            DVASSERT(found->second.size == size);
+            ++found->second.referencesCount;
+            referencedSize += size;
+            return true;
+        }
+    }
+
+    DAVA::FilePath path = GetChunkPath(digest);
+    DAVA::FileSystem::Instance()->CreateDirectory(path.GetDirectory(), true);
+    bool written = false;
+    {
+        DAVA::ScopedPtr<DAVA::File> file(DAVA::File::Create(path, DAVA::File::CREATE | DAVA::File::WRITE));
+        written = (file && file->Write(data, size) == size);
+    }
+    if (!written)
+    {
+        DAVA::Logger::Error("[ChunkStorage::%s] Cannot write chunk %s", __FUNCTION__, path.GetStringValue().c_str());
+        DAVA::FileSystem::Instance()->DeleteFile(path);
+        return false;
+    }
+
+    {
+        DAVA::LockGuard<DAVA::Mutex> lock(mutex);
+
+        ChunkInfo& info = chunks[digest];
+        info.size = size;
+        info.referencesCount = 1;
+        storedSize += size;
+        referencedSize += size;
+    }
+    writtenSize = size;
+    return true;
+}
+
+DAVA::uint64 ChunkStorage::RemoveReference(const DAVA::MD5::MD5Digest& digest)
+{
+    DAVA::LockGuard<DAVA::Mutex> fileLock(GetFileMutex(digest));
+
+    DAVA::uint64 freedSize = 0;
+    {
+        DAVA::LockGuard<DAVA::Mutex> lock(mutex);
+
+        auto found = chunks.find(digest);
+        if (found == chunks.end())
+        {
+            DVASSERT(false, "Reference to unknown chunk is removed");
+            return 0;
+        }
+
+        ChunkInfo& info = found->second;
+        DVASSERT(info.referencesCount > 0);
+        referencedSize -= info.size;
+        if (--info.referencesCount > 0)
+        {
+            return 0;
+        }
+
+        freedSize = info.size;
+        storedSize -= freedSize;
+        chunks.erase(found);
+    }
+
+    DAVA::FileSystem::Instance()->DeleteFile(GetChunkPath(digest));
+    return freedSize;
+}
+
+void ChunkStorage::RestoreReference(const DAVA::MD5::MD5Digest& digest, DAVA::uint32 size)
+{
+    DAVA::LockGuard<DAVA::Mutex> lock(mutex);
+
+    referencedSize += size;
+
+    ChunkInfo& info = chunks[digest];
+    if (info.referencesCount++ == 0)
+    {
+        info.size = size;
+        storedSize += size;
+    }
+}
+
+void ChunkStorage::RemoveUnreferencedFiles()
+{
+    DAVA::LockGuard<DAVA::Mutex> lock(mutex);
+
+    DAVA::ScopedPtr<DAVA::FileList> directories(new DAVA::FileList(folder));
+    for (DAVA::uint32 i = 0; i < directories->GetCount(); ++i)
+    {
+        if (!directories->IsDirectory(i) || directories->IsNavigationDirectory(i))
+        {
+            continue;
+        }
+
+        DAVA::ScopedPtr<DAVA::FileList> files(new DAVA::FileList(directories->GetPathname(i)));
+        for (DAVA::uint32 j = 0; j < files->GetCount(); ++j)
+        {
+            if (files->IsDirectory(j))
+            {
+                continue;
+            }
+
+            const DAVA::String& name = files->GetFilename(j);
+            DAVA::MD5::MD5Digest digest;
+            if (name.size() == DAVA::MD5::MD5Digest::DIGEST_SIZE * 2)
+            {
+                DAVA::MD5::CharToHash(name.c_str(), digest);
+            }
+
+            if (chunks.count(digest) == 0)
+            {
+                DAVA::Logger::Info("Removing unreferenced chunk %s", files->GetPathname(j).GetStringValue().c_str());
+                DAVA::FileSystem::Instance()->DeleteFile(files->GetPathname(j));
+            }
+        }
+    }
+}
+
+void ChunkStorage::Unload()
+{
+    DAVA::LockGuard<DAVA::Mutex> lock(mutex);
+
+    chunks.clear();
+    storedSize = 0;
+    referencedSize = 0;
+}
+
+bool ChunkStorage::Contains(const DAVA::MD5::MD5Digest& digest) const
+{
+    DAVA::LockGuard<DAVA::Mutex> lock(mutex);
+    return chunks.count(digest) > 0;
+}
+
+bool ChunkStorage::Read(const DAVA::MD5::MD5Digest& digest, DAVA::uint8* data, DAVA::uint32 size) const
+{
+    // file lock is held while reading, so the chunk file can't be deleted by concurrent removal
+    DAVA::LockGuard<DAVA::Mutex> fileLock(GetFileMutex(digest));
+    {
+        DAVA::LockGuard<DAVA::Mutex> lock(mutex);
+
+        auto found = chunks.find(digest);
+        if (found == chunks.end() || found->second.size != size)
+        {
+            return false;
+        }
+    }
+
+    DAVA::ScopedPtr<DAVA::File> file(DAVA::File::Create(GetChunkPath(digest), DAVA::File::OPEN | DAVA::File::READ));
+    return (file && file->Read(data, size) == size);
+}
+
+DAVA::uint64 ChunkStorage::GetStoredSize() const
+{
+    DAVA::LockGuard<DAVA::Mutex> lock(mutex);
+    return storedSize;
+}
+
+DAVA::uint64 ChunkStorage::GetReferencedSize() const
+{
+    DAVA::LockGuard<DAVA::Mutex> lock(mutex);
+    return referencedSize;
+}
+
+DAVA::FilePath ChunkStorage::GetChunkPath(const DAVA::MD5::MD5Digest& digest) const
+{
+    DAVA::String digestString = DAVA::MD5::HashToString(digest);
+    return folder + (digestString.substr(0, 2) + "/" + digestString);
+}
+
+DAVA::Mutex& ChunkStorage::GetFileMutex(const DAVA::MD5::MD5Digest& digest) const
+{
+    // digests are distributed uniformly, so any byte of them selects lock
+    return fileMutexes[digest.digest[0] % FILE_LOCKS_COUNT];
+}
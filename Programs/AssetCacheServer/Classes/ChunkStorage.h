@@ -0,0 +1,61 @@
+#pragma once
+
+#include <AssetCache/ContentChunker.h>
+
+#include <Base/BaseTypes.h>
+#include <Concurrency/Mutex.h>
+#include <FileSystem/FilePath.h>
+#include <Utils/MD5.h>
+
+/**
+    Content addressed storage of data chunks.
+    Each unique chunk is kept in one file named by its digest and is shared by all cache items, that contain it.
+    Chunk file is deleted when the last item referencing it is removed.
+    All methods can be called from several threads. Index of chunks is locked only to update it,
+    files are written, read and deleted under one of file locks selected by digest, so I/O of different chunks goes concurrently.
+*/
+class ChunkStorage final
+{
+public:
+    void SetFolder(const DAVA::FilePath& folder);
+
+    /**
+        Add reference to chunk, chunk file is written if chunk is new. `writtenSize` is set to count of bytes written to disk.
+        Returns false if chunk file can't be written, reference is not added in that case.
+    */
+    bool AddReference(const DAVA::MD5::MD5Digest& digest, const DAVA::uint8* data, DAVA::uint32 size, DAVA::uint64& writtenSize);
+    /** Remove reference to chunk. Returns count of bytes freed on disk. */
+    DAVA::uint64 RemoveReference(const DAVA::MD5::MD5Digest& digest);
+    /** Restore reference to chunk, that is already written to disk. */
+    void RestoreReference(const DAVA::MD5::MD5Digest& digest, DAVA::uint32 size);
+    /** Delete chunk files without references, e.g. left after crash of server. */
+    void RemoveUnreferencedFiles();
+    /** Forget all references, chunk files are kept on disk. */
+    void Unload();
+
+    bool Contains(const DAVA::MD5::MD5Digest& digest) const;
+    bool Read(const DAVA::MD5::MD5Digest& digest, DAVA::uint8* data, DAVA::uint32 size) const;
+
+    DAVA::uint64 GetStoredSize() const;
+    DAVA::uint64 GetReferencedSize() const;
+
+private:
+    static const DAVA::uint32 FILE_LOCKS_COUNT = 64;
+
+    struct ChunkInfo
+    {
+        DAVA::uint32 size = 0;
+        DAVA::uint32 referencesCount = 0;
+    };
+
+    DAVA::FilePath GetChunkPath(const DAVA::MD5::MD5Digest& digest) const;
+    DAVA::Mutex& GetFileMutex(const DAVA::MD5::MD5Digest& digest) const;
+
+    mutable DAVA::Mutex mutex; // guards index of chunks and sizes
+    mutable DAVA::Array<DAVA::Mutex, FILE_LOCKS_COUNT> fileMutexes; // taken before `mutex`, when file of chunk is accessed
+    DAVA::UnorderedMap<DAVA::MD5::MD5Digest, ChunkInfo, DAVA::AssetCache::ContentChunker::DigestHash> chunks;
+    DAVA::FilePath folder;
+
+    DAVA::uint64 storedSize = 0; // size of unique chunks on disk
+    DAVA::uint64 referencedSize = 0; // size of chunks counting each reference, i.e. size of data without deduplication
+};
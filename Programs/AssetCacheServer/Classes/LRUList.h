@@ -0,0 +1,110 @@
+#pragma once
+
+#include <Debug/DVAssert.h>
+
+/**
+    Hook, that should be a member of objects kept in LRUList.
+    One object can be in several lists at once, if it has a hook per list.
+*/
+template <typename T>
+struct LRUListHook
+{
+    T* prev = nullptr;
+    T* next = nullptr;
+    bool linked = false;
+};
+
+/**
+    Intrusive doubly linked list ordered from most to least recently used.
+    Touch, insertion, removal and access to the least recently used object take O(1) and don't allocate memory.
+    List doesn't own objects, object should be removed from list before destruction.
+*/
+template <typename T, LRUListHook<T> T::*hook>
+class LRUList final
+{
+public:
+    bool IsLinked(const T* object) const
+    {
+        return (object->*hook).linked;
+    }
+
+    void PushFront(T* object)
+    {
+        LRUListHook<T>& objectHook = object->*hook;
+        DVASSERT(!objectHook.linked);
+
+        objectHook.prev = nullptr;
+        objectHook.next = head;
+        objectHook.linked = true;
+        if (head != nullptr)
+        {
+            (head->*hook).prev = object;
+        }
+        head = object;
+        if (tail == nullptr)
+        {
+            tail = object;
+        }
+        ++count;
+    }
+
+    void Remove(T* object)
+    {
+        LRUListHook<T>& objectHook = object->*hook;
+        DVASSERT(objectHook.linked);
+
+        if (objectHook.prev != nullptr)
+        {
+            (objectHook.prev->*hook).next = objectHook.next;
+        }
+        else
+        {
+            head = objectHook.next;
+        }
+
+        if (objectHook.next != nullptr)
+        {
+            (objectHook.next->*hook).prev = objectHook.prev;
+        }
+        else
+        {
+            tail = objectHook.prev;
+        }
+
+        objectHook = LRUListHook<T>();
+        --count;
+    }
+
+    // Mark object as the most recently used
+    void Touch(T* object)
+    {
+        if (head != object)
+        {
+            Remove(object);
+            PushFront(object);
+        }
+    }
+
+    T* GetLeastRecentlyUsed() const
+    {
+        return tail;
+    }
+
+    size_t GetCount() const
+    {
+        return count;
+    }
+
+    void Clear()
+    {
+        while (tail != nullptr)
+        {
+            Remove(tail);
+        }
+    }
+
+private:
+    T* head = nullptr;
+    T* tail = nullptr;
+    size_t count = 0;
+};
@@ -1,6 +1,8 @@
 #include "ServerCacheEntry.h"
+#include "ChunkStorage.h"
 
 #include "FileSystem/KeyedArchive.h"
+#include "Utils/StringFormat.h"
 
 #include "Debug/DVAssert.h"
 
@@ -13,8 +15,15 @@ ServerCacheEntry::ServerCacheEntry(const DAVA::AssetCache::CachedItemValue& _val
 {
 }
 
+ServerCacheEntry::ServerCacheEntry(const DAVA::AssetCache::CachedItemValue& _value, DAVA::AssetCache::CachedItemValue::FileChunks&& _chunks)
+    : value(_value)
+    , chunks(std::move(_chunks))
+{
+}
+
 ServerCacheEntry::ServerCacheEntry(ServerCacheEntry&& right)
     : value(std::move(right.value))
+    , chunks(std::move(right.chunks))
     , accessTimestamp(right.accessTimestamp)
 {
 }
@@ -24,6 +33,7 @@ ServerCacheEntry& ServerCacheEntry::operator=(ServerCacheEntry&& right)
     if (this != &right)
     {
         value = std::move(right.value);
+        chunks = std::move(right.chunks);
         accessTimestamp = right.accessTimestamp;
     }
 
@@ -44,6 +54,25 @@ void ServerCacheEntry::Serialize(DAVA::KeyedArchive* archieve) const
     DAVA::ScopedPtr<DAVA::KeyedArchive> valueArchieve(new DAVA::KeyedArchive());
     value.Serialize(valueArchieve, false);
     archieve->SetArchive("value", valueArchieve);
+
+    // digests and sizes of chunks are packed into byte array per file
+    archieve->SetUInt32("chunksFilesCount", static_cast<DAVA::uint32>(chunks.size()));
+    DAVA::uint32 index = 0;
+    for (const auto& fileChunks : chunks)
+    {
+        DAVA::Vector<DAVA::uint8> packedChunks;
+        packedChunks.reserve(fileChunks.second.size() * (DAVA::MD5::MD5Digest::DIGEST_SIZE + sizeof(DAVA::uint32)));
+        for (const DAVA::AssetCache::ContentChunker::Chunk& chunk : fileChunks.second)
+        {
+            const DAVA::uint8* sizeBytes = reinterpret_cast<const DAVA::uint8*>(&chunk.size);
+            packedChunks.insert(packedChunks.end(), chunk.digest.digest.begin(), chunk.digest.digest.end());
+            packedChunks.insert(packedChunks.end(), sizeBytes, sizeBytes + sizeof(chunk.size));
+        }
+
+        archieve->SetString(DAVA::Format("chunksFile_%u", index), fileChunks.first);
+        archieve->SetByteArray(DAVA::Format("chunks_%u", index), packedChunks.data(), static_cast<DAVA::int32>(packedChunks.size()));
+        ++index;
+    }
 }
 
 void ServerCacheEntry::Deserialize(DAVA::KeyedArchive* archieve)
@@ -55,6 +84,35 @@ void ServerCacheEntry::Deserialize(DAVA::KeyedArchive* archieve)
     DAVA::KeyedArchive* valueArchieve = archieve->GetArchive("value");
     DVASSERT(valueArchieve);
     value.Deserialize(valueArchieve);
+
+    const DAVA::uint32 recordSize = DAVA::MD5::MD5Digest::DIGEST_SIZE + sizeof(DAVA::uint32);
+    chunks.clear();
+    DAVA::uint32 filesCount = archieve->GetUInt32("chunksFilesCount");
+    for (DAVA::uint32 index = 0; index < filesCount; ++index)
+    {
+        DAVA::Vector<DAVA::AssetCache::ContentChunker::Chunk>& fileChunks = chunks[archieve->GetString(DAVA::Format("chunksFile_%u", index))];
+
+        DAVA::String key = DAVA::Format("chunks_%u", index);
+        const DAVA::uint8* packedChunks = archieve->GetByteArray(key);
+        DAVA::uint32 chunksCount = static_cast<DAVA::uint32>(archieve->GetByteArraySize(key)) / recordSize;
+        fileChunks.resize(chunksCount);
+
+        DAVA::uint32 offset = 0;
+        for (DAVA::AssetCache::ContentChunker::Chunk& chunk : fileChunks)
+        {
+            Memcpy(chunk.digest.digest.data(), packedChunks, DAVA::MD5::MD5Digest::DIGEST_SIZE);
+            Memcpy(&chunk.size, packedChunks + DAVA::MD5::MD5Digest::DIGEST_SIZE, sizeof(chunk.size));
+            chunk.offset = offset;
+
+            offset += chunk.size;
+            packedChunks += recordSize;
+        }
+    }
+}
+
+void ServerCacheEntry::SetChunks(DAVA::AssetCache::CachedItemValue::FileChunks&& chunks_)
+{
+    chunks = std::move(chunks_);
 }
 
 bool ServerCacheEntry::Fetch(const DAVA::FilePath& folder)
@@ -62,6 +120,28 @@ bool ServerCacheEntry::Fetch(const DAVA::FilePath& folder)
     return value.Fetch(folder);
 }
 
+bool ServerCacheEntry::Fetch(const ChunkStorage& storage)
+{
+    return value.Fetch([this, &storage](const DAVA::String& name, DAVA::Vector<DAVA::uint8>& data) {
+        auto found = chunks.find(name);
+        if (found == chunks.end() || found->second.empty())
+        {
+            return false;
+        }
+
+        const DAVA::AssetCache::ContentChunker::Chunk& lastChunk = found->second.back();
+        data.resize(lastChunk.offset + lastChunk.size);
+        for (const DAVA::AssetCache::ContentChunker::Chunk& chunk : found->second)
+        {
+            if (!storage.Read(chunk.digest, data.data() + chunk.offset, chunk.size))
+            {
+                return false;
+            }
+        }
+        return true;
+    });
+}
+
 void ServerCacheEntry::Free()
 {
     value.Free();
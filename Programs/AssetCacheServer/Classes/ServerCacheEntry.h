@@ -9,11 +9,14 @@ namespace DAVA
 class KeyedArchive;
 }
 
+class ChunkStorage;
+
 class ServerCacheEntry final
 {
 public:
     ServerCacheEntry();
     explicit ServerCacheEntry(const DAVA::AssetCache::CachedItemValue& value);
+    ServerCacheEntry(const DAVA::AssetCache::CachedItemValue& value, DAVA::AssetCache::CachedItemValue::FileChunks&& chunks);
 
     ServerCacheEntry(const ServerCacheEntry& right) = delete;
     ServerCacheEntry(ServerCacheEntry&& right);
@@ -32,12 +35,18 @@ public:
     DAVA::uint64 GetTimestamp() const;
 
     DAVA::AssetCache::CachedItemValue& GetValue();
+    const DAVA::AssetCache::CachedItemValue& GetValue() const;
+
+    const DAVA::AssetCache::CachedItemValue::FileChunks& GetChunks() const;
+    void SetChunks(DAVA::AssetCache::CachedItemValue::FileChunks&& chunks);
 
     bool Fetch(const DAVA::FilePath& folder);
+    bool Fetch(const ChunkStorage& storage);
     void Free();
 
 private:
     DAVA::AssetCache::CachedItemValue value;
+    DAVA::AssetCache::CachedItemValue::FileChunks chunks; // files of value are assembled from these chunks
 
 private:
     DAVA::uint64 accessTimestamp = 0;
@@ -57,3 +66,13 @@ inline DAVA::AssetCache::CachedItemValue& ServerCacheEntry::GetValue()
 {
     return value;
 }
+
+inline const DAVA::AssetCache::CachedItemValue& ServerCacheEntry::GetValue() const
+{
+    return value;
+}
+
+inline const DAVA::AssetCache::CachedItemValue::FileChunks& ServerCacheEntry::GetChunks() const
+{
+    return chunks;
+}
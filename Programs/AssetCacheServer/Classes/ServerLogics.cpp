@@ -92,10 +92,13 @@ void ServerLogics::OnAddChunkToCache(const std::shared_ptr<DAVA::Net::IChannel>&
             return;
         }
 
+        // chunks, that were reported as stored by chunks query, are not sent by client and are read from db
         AssetCache::CachedItemValue value;
         task.receivedData->Seek(0, File::SEEK_FROM_START);
-        value.Deserialize(task.receivedData);
-        if (value.IsEmpty() || !value.IsValid())
+        bool deserialized = value.DeserializeChunked(task.receivedData, [this](const MD5::MD5Digest& digest, uint8* data, uint32 size) {
+            return dataBase->ReadChunk(digest, data, size);
+        });
+        if (!deserialized || value.IsEmpty() || !value.IsValid())
         {
             Error("Received data is empty or invalid");
             return;
@@ -148,15 +151,14 @@ ServerLogics::DataGetMap::iterator ServerLogics::GetOrCreateGetTask(const DAVA::
     DataGetMap::iterator taskIter = dataGetTasks.find(key);
     if (taskIter == dataGetTasks.end())
     {
-        ServerCacheEntry* entry = dataBase->Get(key);
-        if (nullptr != entry)
+        AssetCache::CachedItemValue value;
+        if (dataBase->Get(key, value))
         { // Found in db.
             Logger::Debug("Creating get task using local data");
             taskIter = dataGetTasks.emplace(key, DataGetTask()).first;
             DataGetTask& task = taskIter->second;
             task.serializedData = DynamicMemoryFile::Create(File::CREATE | File::READ | File::WRITE);
 
-            AssetCache::CachedItemValue& value = entry->GetValue();
             AssetCache::CachedItemValue::Description description = value.GetDescription();
             description.receivingChain += "/" + serverName;
             value.SetDescription(description);
@@ -277,6 +279,17 @@ void ServerLogics::OnStatusRequested(const std::shared_ptr<DAVA::Net::IChannel>&
     serverProxy->SendStatus(channel);
 }
 
+void ServerLogics::OnChunksQuery(const std::shared_ptr<DAVA::Net::IChannel>& channel, const DAVA::AssetCache::CacheItemKey& key, const DAVA::Vector<DAVA::MD5::MD5Digest>& digests)
+{
+    hasIncomingRequestsRecently = true;
+
+    DAVA::Vector<DAVA::uint8> storedFlags;
+    dataBase->FindStoredChunks(digests, storedFlags);
+
+    DAVA::Logger::Debug("Received chunks query: key %s, %u chunks, %u of them are stored", Brief(key).c_str(), static_cast<DAVA::uint32>(digests.size()), static_cast<DAVA::uint32>(std::count(storedFlags.begin(), storedFlags.end(), 1)));
+    serverProxy->SendStoredChunks(channel, key, storedFlags);
+}
+
 void ServerLogics::OnChannelClosed(const std::shared_ptr<DAVA::Net::IChannel>& channel, const DAVA::char8*)
 {
     DAVA::Logger::Debug("Channel %p is closed", channel.get());
@@ -522,12 +535,12 @@ bool ServerLogics::SendFirstChunkToRemote(DataRemoteAddMap::iterator taskIt)
     const AssetCache::CacheItemKey& key = taskIt->first;
     DataRemoteAddTask& task = taskIt->second;
 
-    ServerCacheEntry* entry = dataBase->Get(key);
-    if (entry)
+    AssetCache::CachedItemValue value;
+    if (dataBase->Get(key, value))
     {
+        // remote server is not queried for stored chunks, all chunks are sent
         task.serializedData = DynamicMemoryFile::Create(File::CREATE | File::READ | File::WRITE);
-        AssetCache::CachedItemValue& value = entry->GetValue();
-        value.Serialize(task.serializedData);
+        value.SerializeChunked(task.serializedData, value.SplitIntoChunks(), [](const MD5::MD5Digest&) { return false; });
         task.bytesOverall = task.serializedData->GetSize();
         task.chunksOverall = AssetCache::ChunkSplitter::GetNumberOfChunks(task.bytesOverall);
         task.chunksSent = 0;
@@ -24,6 +24,7 @@ public:
     void OnWarmingUp(const std::shared_ptr<DAVA::Net::IChannel>& channel, const DAVA::AssetCache::CacheItemKey& key) override;
     void OnChannelClosed(const std::shared_ptr<DAVA::Net::IChannel>& channel, const DAVA::char8* message) override;
     void OnStatusRequested(const std::shared_ptr<DAVA::Net::IChannel>& channel) override;
+    void OnChunksQuery(const std::shared_ptr<DAVA::Net::IChannel>& channel, const DAVA::AssetCache::CacheItemKey& key, const DAVA::Vector<DAVA::MD5::MD5Digest>& digests) override;
 
     //ClientNetProxyListener
     void OnClientProxyStateChanged() override;
@@ -20,7 +20,7 @@ ArchivePackTool::ArchivePackTool()
 {
     using namespace DAVA;
 
-    options.AddOption(OptionNames::Compression, VariantType(String("lz4hc")), "default compression method, lz4hc - default");
+    options.AddOption(OptionNames::Compression, VariantType(String("lz4hc")), "compression method: none, lz4, lz4hc, rfc1951 or zstd (with dictionary trained on files of pack), lz4hc - default");
     options.AddOption(OptionNames::BaseDir, VariantType(String("")), "source base directory");
     options.AddOption(OptionNames::MetaDbFile, VariantType(String("")), "sqlite db with metadata");
     options.AddOption(OptionNames::DummyFileData, VariantType(false), "write dummy single-byte files instead of actual file data, useful if you are interested in pack footer only");
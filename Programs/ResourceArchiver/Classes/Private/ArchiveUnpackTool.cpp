@@ -8,12 +8,14 @@
 #include <Engine/Engine.h>
 #include <Compression/LZ4Compressor.h>
 #include <Compression/ZipCompressor.h>
+#include <Compression/ZstdCompressor.h>
 
 #include "ResultCodes.h"
 
 static int UnpackFile(const DAVA::FilePath& archivePath,
                       const DAVA::PackFormat::PackFile::FilesTableBlock::FilesData::Data& fileInfo,
                       const DAVA::String& relativeFilePath,
+                      const DAVA::ZstdCompressor& zstdCompressor,
                       const bool extractInDvplFormat);
 
 ArchiveUnpackTool::ArchiveUnpackTool()
@@ -92,6 +94,8 @@ int ArchiveUnpackTool::ProcessInternal()
 
         const auto& fileInfoBase = packArchive.GetFilesInfo();
 
+        const ZstdCompressor zstdCompressor(packArchive.HasMeta() ? packArchive.GetMeta().GetCompressionDictionary() : Vector<uint8>());
+
         for (size_t i = 0; i < packFile.filesTable.data.files.size(); ++i)
         {
             jobManager->CreateWorkerJob([&, i]()
@@ -99,7 +103,7 @@ int ArchiveUnpackTool::ProcessInternal()
                                             const auto& fileInfoFromArchive = packFile.filesTable.data.files[i];
                                             const auto& fileInfo = fileInfoBase[i];
 
-                                            if (UnpackFile(packFilename, fileInfoFromArchive, fileInfo.relativeFilePath, extractInDvplFormat) == OK)
+                                            if (UnpackFile(packFilename, fileInfoFromArchive, fileInfo.relativeFilePath, zstdCompressor, extractInDvplFormat) == OK)
                                             {
                                                 ++countExtractedFiles;
                                             }
@@ -135,6 +139,7 @@ int ArchiveUnpackTool::ProcessInternal()
 static int UnpackFile(const DAVA::FilePath& archivePath,
                       const DAVA::PackFormat::PackFile::FilesTableBlock::FilesData::Data& fileInfo,
                       const DAVA::String& relativeFilePath,
+                      const DAVA::ZstdCompressor& zstdCompressor,
                       const bool extractInDvplFormat)
 {
     using namespace DAVA;
@@ -172,6 +177,12 @@ static int UnpackFile(const DAVA::FilePath& archivePath,
 
     if (extractInDvplFormat)
     {
+        if (!PackFormat::LitePack::IsCompressionTypeSupported(fileInfo.type))
+        {
+            Logger::Error("dvpl can't be loaded with compression type %d, file: %s", static_cast<int32>(fileInfo.type), relativeFilePath.c_str());
+            return ERROR_CANT_EXTRACT_FILE;
+        }
+
         PackFormat::LitePack::Footer liteFooter;
         liteFooter.type = fileInfo.type;
         liteFooter.crc32Compressed = fileInfo.compressedCrc32;
@@ -234,6 +245,13 @@ static int UnpackFile(const DAVA::FilePath& archivePath,
             return ERROR_CANT_EXTRACT_FILE;
         }
         break;
+    case Compressor::Type::Zstd:
+        content.resize(fileInfo.originalSize);
+        if (!zstdCompressor.Decompress(compressedContent, content))
+        {
+            return ERROR_CANT_EXTRACT_FILE;
+        }
+        break;
     default:
         Logger::Error("unknown compression type: %d", fileInfo.type);
         return ERROR_CANT_EXTRACT_FILE;
@@ -0,0 +1,244 @@
+#include "Classes/CommandLine/ShaderCacheTool.h"
+
+#include <REPlatform/CommandLine/OptionName.h>
+#include <REPlatform/CommandLine/SceneConsoleHelper.h>
+#include <REPlatform/Scene/SceneHelper.h>
+
+#include <TArc/Utils/ModuleCollection.h>
+
+#include <Base/ScopedPtr.h>
+#include <Engine/Engine.h>
+#include <Engine/EngineContext.h>
+#include <FileSystem/File.h>
+#include <FileSystem/FileSystem.h>
+#include <Job/JobManager.h>
+#include <Logger/Logger.h>
+#include <Render/Material/NMaterial.h>
+#include <Render/RHI/rhi_Public.h>
+#include <Render/RHI/rhi_ShaderSource.h>
+#include <Render/ShaderCache.h>
+#include <Scene3D/Scene.h>
+#include <Time/SystemTimer.h>
+#include <Utils/StringUtils.h>
+
+namespace ShaderCacheToolDetails
+{
+using namespace DAVA;
+
+struct ApiName
+{
+    rhi::Api api;
+    const char* name;
+};
+
+const ApiName API_NAMES[] = {
+    { rhi::RHI_DX11, "dx11" },
+    { rhi::RHI_DX9, "dx9" },
+    { rhi::RHI_GLES2, "gles2" },
+    { rhi::RHI_METAL, "metal" },
+};
+
+rhi::Api GetApiByName(const String& name)
+{
+    for (const ApiName& apiName : API_NAMES)
+    {
+        if (name == apiName.name)
+            return apiName.api;
+    }
+    return rhi::RHI_API_COUNT;
+}
+
+Vector<FilePath> ReadScenesListFile(const FilePath& listFilePath)
+{
+    Vector<FilePath> scenes;
+    ScopedPtr<File> listFile(File::Create(listFilePath, File::OPEN | File::READ));
+    if (listFile)
+    {
+        while (!listFile->IsEof())
+        {
+            String str = StringUtils::Trim(listFile->ReadLine());
+            if (!str.empty())
+            {
+                scenes.push_back(str);
+            }
+        }
+    }
+    else
+    {
+        Logger::Error("Can't open scenes listfile %s", listFilePath.GetAbsolutePathname().c_str());
+    }
+
+    return scenes;
+}
+
+bool CollectShaderVariants(const FilePath& scenePath, Vector<ShaderDescriptorCache::ShaderVariant>& variants)
+{
+    // scene is loaded without systems, so materials don't compile their shaders
+    ScopedPtr<Scene> scene(new Scene(0));
+    if (scene->LoadScene(scenePath) != SceneFileV2::eError::ERROR_NO_ERROR)
+    {
+        Logger::Error("Cannot load scene %s", scenePath.GetAbsolutePathname().c_str());
+        return false;
+    }
+
+    Set<NMaterial*> materials;
+    SceneHelper::EnumerateMaterialInstances(scene, materials);
+    for (NMaterial* material : materials)
+    {
+        material->CollectShaderVariants(variants);
+    }
+    return true;
+}
+}
+
+ShaderCacheTool::ShaderCacheTool(const DAVA::Vector<DAVA::String>& commandLine)
+    : CommandLineModule(commandLine, "-shadercache")
+{
+    using namespace DAVA;
+
+    options.AddOption(OptionName::ProcessFile, VariantType(String("")), "Full pathname to scene file *.sc2");
+    options.AddOption(OptionName::ProcessFileList, VariantType(String("")), "Path to file with the list of scenes");
+    options.AddOption(OptionName::QualityConfig, VariantType(String("")), "Full path for quality.yaml file");
+    options.AddOption(OptionName::OutFile, VariantType(String("")), "Full pathname of shader cache file");
+    options.AddOption(OptionName::Api, VariantType(String("")), "Target render api: dx11, dx9, gles2, metal. Current api is used by default");
+    options.AddOption(OptionName::Mode, VariantType(String("build")), "build - translate variants in parallel, compare - also translate them serially and report times");
+}
+
+bool ShaderCacheTool::PostInitInternal()
+{
+    using namespace DAVA;
+    using namespace ShaderCacheToolDetails;
+
+    FilePath scenePath = options.GetOption(OptionName::ProcessFile).AsString();
+    FilePath scenesListPath = options.GetOption(OptionName::ProcessFileList).AsString();
+    if (scenePath.IsEmpty() == scenesListPath.IsEmpty())
+    {
+        Logger::Error("Either '%s' or '%s' param should be specified", OptionName::ProcessFile.c_str(), OptionName::ProcessFileList.c_str());
+        return false;
+    }
+
+    scenes = scenePath.IsEmpty() ? ReadScenesListFile(scenesListPath) : Vector<FilePath>(1, scenePath);
+    if (scenes.empty())
+    {
+        Logger::Error("Scenes list is empty");
+        return false;
+    }
+
+    outFile = options.GetOption(OptionName::OutFile).AsString();
+    if (outFile.IsEmpty())
+    {
+        Logger::Error("'%s' param should be specified", OptionName::OutFile.c_str());
+        return false;
+    }
+
+    String apiName = options.GetOption(OptionName::Api).AsString();
+    targetApi = apiName.empty() ? rhi::HostApi() : GetApiByName(apiName);
+    if (targetApi == rhi::RHI_API_COUNT)
+    {
+        Logger::Error("Unknown render api: %s", apiName.c_str());
+        return false;
+    }
+
+    String mode = options.GetOption(OptionName::Mode).AsString();
+    if (mode == "compare")
+    {
+        compareWithSerial = true;
+    }
+    else if (mode != "build")
+    {
+        Logger::Error("Wrong mode was selected: %s", mode.c_str());
+        return false;
+    }
+
+    bool qualityInitialized = SceneConsoleHelper::InitializeQualitySystem(options, scenes.front());
+    if (!qualityInitialized)
+    {
+        Logger::Error("Cannot create path to quality.yaml from %s", scenes.front().GetAbsolutePathname().c_str());
+        return false;
+    }
+
+    return true;
+}
+
+DAVA::ConsoleModule::eFrameResult ShaderCacheTool::OnFrameInternal()
+{
+    using namespace DAVA;
+    using namespace ShaderCacheToolDetails;
+
+    Vector<ShaderDescriptorCache::ShaderVariant> variants;
+    for (const FilePath& scenePath : scenes)
+    {
+        if (!CollectShaderVariants(scenePath, variants))
+        {
+            result = Result::RESULT_ERROR;
+        }
+    }
+
+    JobManager* jobManager = GetEngineContext()->jobManager;
+    uint32 workersCount = (jobManager != nullptr) ? jobManager->GetWorkersCount() : 0;
+
+    // without cache application translates each variant on its first use, as serial translation does
+    int64 serialTime = 0;
+    if (compareWithSerial)
+    {
+        rhi::ShaderSourceCache::Clear();
+        int64 startTime = SystemTimer::GetMs();
+        ShaderDescriptorCache::PrecompileShaders(variants, targetApi, false);
+        serialTime = SystemTimer::GetMs() - startTime;
+    }
+
+    rhi::ShaderSourceCache::Clear();
+    int64 startTime = SystemTimer::GetMs();
+    ShaderDescriptorCache::PrecompileReport report = ShaderDescriptorCache::PrecompileShaders(variants, targetApi, true);
+    int64 parallelTime = SystemTimer::GetMs() - startTime;
+
+    FileSystem::Instance()->CreateDirectory(outFile.GetDirectory(), true);
+    rhi::ShaderSourceCache::Save(outFile.GetAbsolutePathname().c_str());
+    if (!FileSystem::Instance()->IsFile(outFile))
+    {
+        Logger::Error("Cannot save shader cache %s", outFile.GetAbsolutePathname().c_str());
+        result = Result::RESULT_ERROR;
+        return DAVA::ConsoleModule::eFrameResult::FINISHED;
+    }
+
+    rhi::ShaderSourceCache::Clear();
+    startTime = SystemTimer::GetMs();
+    rhi::ShaderSourceCache::Load(outFile.GetAbsolutePathname().c_str());
+    int64 loadTime = SystemTimer::GetMs() - startTime;
+    rhi::ShaderSourceCache::Clear();
+
+    // materials share programs, so count of collected variants is reported apart from count of unique ones
+    Logger::Info("Shader cache %s: material variants collected: %u, unique variants: %u, unique variants compiled: %u in %lld ms with %u workers",
+                 outFile.GetAbsolutePathname().c_str(), uint32(variants.size()), report.uniqueCount, report.compiledCount, parallelTime, workersCount);
+    if (compareWithSerial)
+    {
+        Logger::Info("Cold start shaders time: %lld ms without cache (serial translation), %lld ms with cache (loading)", serialTime, loadTime);
+    }
+    else
+    {
+        Logger::Info("Cold start shaders time with cache (loading): %lld ms", loadTime);
+    }
+
+    if (report.compiledCount == 0 && !variants.empty())
+    {
+        result = Result::RESULT_ERROR;
+    }
+
+    return DAVA::ConsoleModule::eFrameResult::FINISHED;
+}
+
+void ShaderCacheTool::BeforeDestroyedInternal()
+{
+    DAVA::SceneConsoleHelper::FlushRHI();
+}
+
+void ShaderCacheTool::ShowHelpInternal()
+{
+    CommandLineModule::ShowHelpInternal();
+
+    DAVA::Logger::Info("Examples:");
+    DAVA::Logger::Info("\t-shadercache -processfile /Users/Test/DataSource/3d/Maps/scene.sc2 -outfile /Users/Test/Data/ShaderSource.bin");
+    DAVA::Logger::Info("\t-shadercache -processfilelist /Users/Test/scenes.txt -outfile /Users/Test/Data/ShaderSource.bin -api metal -mode compare");
+}
+
+DECL_TARC_MODULE(ShaderCacheTool);
@@ -0,0 +1,149 @@
+#include "Classes/CommandLine/ShaderCacheTool.h"
+
+#include <REPlatform/CommandLine/CommandLineModuleTestUtils.h>
+#include <REPlatform/Scene/SceneHelper.h>
+
+#include <TArc/Testing/ConsoleModuleTestExecution.h>
+#include <TArc/Testing/TArcUnitTests.h>
+
+#include <Base/BaseTypes.h>
+#include <Base/ScopedPtr.h>
+#include <FileSystem/File.h>
+#include <FileSystem/FileSystem.h>
+#include <Render/Material/NMaterial.h>
+#include <Render/RHI/rhi_ShaderSource.h>
+#include <Render/ShaderCache.h>
+#include <Scene3D/Scene.h>
+
+namespace SCTestDetail
+{
+const DAVA::String projectStr = "~doc:/Test/ShaderCacheTool/";
+const DAVA::String scenePathnameStr = projectStr + "DataSource/3d/Scene/testScene.sc2";
+const DAVA::String cachePathnameStr = projectStr + "Data/ShaderSource.bin";
+
+struct CachedProgram
+{
+    rhi::Api api;
+    DAVA::uint32 srcHash;
+    DAVA::String sourceCode;
+};
+
+DAVA::Map<DAVA::String, CachedProgram> GetCachedPrograms()
+{
+    DAVA::Map<DAVA::String, CachedProgram> programs;
+    for (const rhi::ShaderSourceCache::EntryDesc& entry : rhi::ShaderSourceCache::GetEntries())
+    {
+        programs[entry.uid.c_str()] = { entry.api, entry.srcHash, entry.src->GetSourceCode(entry.api) };
+    }
+    return programs;
+}
+
+bool IsSamePrograms(const DAVA::Map<DAVA::String, CachedProgram>& a, const DAVA::Map<DAVA::String, CachedProgram>& b)
+{
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](const std::pair<const DAVA::String, CachedProgram>& x, const std::pair<const DAVA::String, CachedProgram>& y) {
+               return x.first == y.first && x.second.api == y.second.api && x.second.srcHash == y.second.srcHash && x.second.sourceCode == y.second.sourceCode;
+           });
+}
+
+// programs translated in memory, as the tool does, without saving them
+DAVA::Map<DAVA::String, CachedProgram> TranslateScenePrograms(const DAVA::FilePath& scenePath)
+{
+    using namespace DAVA;
+
+    Vector<ShaderDescriptorCache::ShaderVariant> variants;
+    ScopedPtr<Scene> scene(new Scene(0));
+    if (scene->LoadScene(scenePath) == SceneFileV2::eError::ERROR_NO_ERROR)
+    {
+        Set<NMaterial*> materials;
+        SceneHelper::EnumerateMaterialInstances(scene, materials);
+        for (NMaterial* material : materials)
+        {
+            material->CollectShaderVariants(variants);
+        }
+    }
+
+    rhi::ShaderSourceCache::Clear();
+    ShaderDescriptorCache::PrecompileShaders(variants, rhi::HostApi());
+    Map<String, CachedProgram> programs = GetCachedPrograms();
+    rhi::ShaderSourceCache::Clear();
+    return programs;
+}
+}
+
+DAVA_TARC_TESTCLASS(ShaderCacheToolTest)
+{
+    BEGIN_FILES_COVERED_BY_TESTS()
+    FIND_FILES_IN_TARGET(TArc)
+    DECLARE_COVERED_FILES("ShaderCacheTool.cpp")
+    END_FILES_COVERED_BY_TESTS();
+
+    DAVA_TEST (BuildCache)
+    {
+        using namespace DAVA;
+
+        std::unique_ptr<CommandLineModuleTestUtils::TextureLoadingGuard> guard = CommandLineModuleTestUtils::CreateTextureGuard({ eGPUFamily::GPU_ORIGIN });
+        CommandLineModuleTestUtils::CreateProjectInfrastructure(SCTestDetail::projectStr);
+        CommandLineModuleTestUtils::SceneBuilder::CreateFullScene(SCTestDetail::scenePathnameStr, SCTestDetail::projectStr);
+
+        Vector<String> cmdLine =
+        {
+          "ResourceEditor",
+          "-shadercache",
+          "-processfile",
+          FilePath(SCTestDetail::scenePathnameStr).GetAbsolutePathname(),
+          "-outfile",
+          FilePath(SCTestDetail::cachePathnameStr).GetAbsolutePathname(),
+          "-mode",
+          "compare"
+        };
+
+        std::unique_ptr<CommandLineModule> tool = std::make_unique<ShaderCacheTool>(cmdLine);
+        DAVA::ConsoleModuleTestExecution::ExecuteModule(tool.get());
+        TEST_VERIFY(tool->GetExitCode() == 0);
+
+        // loaded cache contains the same programs, which are translated from scene materials
+        Map<String, SCTestDetail::CachedProgram> translated = SCTestDetail::TranslateScenePrograms(SCTestDetail::scenePathnameStr);
+        TEST_VERIFY(translated.empty() == false);
+
+        String cachePathname = FilePath(SCTestDetail::cachePathnameStr).GetAbsolutePathname();
+        rhi::ShaderSourceCache::Load(cachePathname.c_str());
+        Map<String, SCTestDetail::CachedProgram> loaded = SCTestDetail::GetCachedPrograms();
+        TEST_VERIFY(SCTestDetail::IsSamePrograms(translated, loaded));
+
+        // loaded cache is saved without changes
+        FilePath resavedPath = SCTestDetail::projectStr + "Data/ShaderSourceResaved.bin";
+        rhi::ShaderSourceCache::Save(resavedPath.GetAbsolutePathname().c_str());
+        rhi::ShaderSourceCache::Clear();
+        rhi::ShaderSourceCache::Load(resavedPath.GetAbsolutePathname().c_str());
+        TEST_VERIFY(SCTestDetail::IsSamePrograms(loaded, SCTestDetail::GetCachedPrograms()));
+
+        // entry is stale when source of program has changed, so runtime translates program again
+        for (const auto& program : loaded)
+        {
+            if (program.second.api == rhi::HostApi())
+            {
+                TEST_VERIFY(rhi::ShaderSourceCache::Get(FastName(program.first), program.second.srcHash) != nullptr);
+                TEST_VERIFY(rhi::ShaderSourceCache::Get(FastName(program.first), program.second.srcHash + 1) == nullptr);
+            }
+        }
+
+        // cache of other format version is ignored
+        {
+            ScopedPtr<File> cacheFile(File::Create(resavedPath, File::OPEN | File::READ | File::WRITE));
+            TEST_VERIFY(cacheFile);
+            if (cacheFile)
+            {
+                uint32 formatVersion = 0;
+                TEST_VERIFY(cacheFile->Read(&formatVersion, sizeof(formatVersion)) == sizeof(formatVersion));
+                formatVersion += 1;
+                TEST_VERIFY(cacheFile->Seek(0, File::SEEK_FROM_START));
+                TEST_VERIFY(cacheFile->Write(&formatVersion, sizeof(formatVersion)) == sizeof(formatVersion));
+            }
+        }
+        rhi::ShaderSourceCache::Load(resavedPath.GetAbsolutePathname().c_str());
+        TEST_VERIFY(rhi::ShaderSourceCache::GetEntries().empty());
+
+        CommandLineModuleTestUtils::ClearTestFolder(SCTestDetail::projectStr);
+    }
+}
+;
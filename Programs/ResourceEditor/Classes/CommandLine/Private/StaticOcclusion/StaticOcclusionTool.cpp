@@ -27,6 +27,7 @@ StaticOcclusionTool::StaticOcclusionTool(const DAVA::Vector<DAVA::String>& comma
     options.AddOption(OptionName::Build, VariantType(false), "Enables build of static occlusion");
     options.AddOption(OptionName::ProcessFile, VariantType(String("")), "Full pathname to scene file *.sc2");
     options.AddOption(OptionName::QualityConfig, VariantType(String("")), "Full path for quality.yaml file");
+    options.AddOption(OptionName::Mode, VariantType(String("gpu")), "gpu - render occluders with occlusion queries, software - rasterize them on CPU without compiling shaders and rendering frames");
 }
 
 bool StaticOcclusionTool::PostInitInternal()
@@ -43,6 +44,17 @@ bool StaticOcclusionTool::PostInitInternal()
         return false;
     }
 
+    String mode = options.GetOption(OptionName::Mode).AsString();
+    if (mode == "software")
+    {
+        softwareRasterization = true;
+    }
+    else if (mode != "gpu")
+    {
+        Logger::Error("Wrong mode was selected: %s", mode.c_str());
+        return false;
+    }
+
     scenePathname = options.GetOption(OptionName::ProcessFile).AsString();
     if (scenePathname.IsEmpty())
     {
@@ -61,6 +73,7 @@ bool StaticOcclusionTool::PostInitInternal()
     {
         scene.reset(new Scene());
         staticOcclusionBuildSystem = new StaticOcclusionBuildSystem(scene);
+        staticOcclusionBuildSystem->SetSoftwareRasterizationEnabled(softwareRasterization);
         scene->AddSystem(staticOcclusionBuildSystem, ComponentUtils::MakeMask<StaticOcclusionComponent>() | ComponentUtils::MakeMask<TransformComponent>(), Scene::SCENE_SYSTEM_REQUIRE_PROCESS, scene->renderUpdateSystem);
 
         if (scene->LoadScene(scenePathname) != SceneFileV2::eError::ERROR_NO_ERROR)
@@ -83,7 +96,10 @@ bool StaticOcclusionTool::PostInitInternal()
 
         scene->Update(0.1f); // we need to call update to initialize (at least) QuadTree.
         staticOcclusionBuildSystem->Build();
-        SceneConsoleHelper::FlushRHI();
+        if (!softwareRasterization)
+        {
+            SceneConsoleHelper::FlushRHI();
+        }
     }
 
     return true;
@@ -95,6 +111,13 @@ DAVA::ConsoleModule::eFrameResult StaticOcclusionTool::OnFrameInternal()
     {
         if (staticOcclusionBuildSystem != nullptr && staticOcclusionBuildSystem->IsInBuild())
         {
+            if (softwareRasterization)
+            {
+                // occluders are rasterized by worker threads inside scene update, no frame is rendered
+                scene->Update(0.1f);
+                return DAVA::ConsoleModule::eFrameResult::CONTINUE;
+            }
+
             const rhi::HTexture nullTexture;
             const rhi::Viewport nullViewport(0, 0, 1, 1);
 
@@ -140,6 +163,7 @@ void StaticOcclusionTool::ShowHelpInternal()
 
     DAVA::Logger::Info("Examples:");
     DAVA::Logger::Info("\t-staticocclusion -build -processfile /Users/Test/DataSource/3d/Maps/scene.sc2");
+    DAVA::Logger::Info("\t-staticocclusion -build -mode software -processfile /Users/Test/DataSource/3d/Maps/scene.sc2");
 }
 
 DECL_TARC_MODULE(StaticOcclusionTool);
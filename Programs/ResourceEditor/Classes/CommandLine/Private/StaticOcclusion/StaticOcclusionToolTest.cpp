@@ -72,5 +72,34 @@ DAVA_TARC_TESTCLASS(StaticOcclusionToolTest)
 
         CommandLineModuleTestUtils::ClearTestFolder(SOTestDetail::projectStr);
     }
+
+    DAVA_TEST (BuildOcclusionInSoftware)
+    {
+        using namespace DAVA;
+
+        std::unique_ptr<CommandLineModuleTestUtils::TextureLoadingGuard> guard = CommandLineModuleTestUtils::CreateTextureGuard({ eGPUFamily::GPU_ORIGIN });
+        CommandLineModuleTestUtils::CreateProjectInfrastructure(SOTestDetail::projectStr);
+        CommandLineModuleTestUtils::SceneBuilder::CreateFullScene(SOTestDetail::scenePathnameStr, SOTestDetail::projectStr);
+
+        Vector<String> cmdLine =
+        {
+          "ResourceEditor",
+          "-staticocclusion",
+          "-build",
+          "-mode",
+          "software",
+          "-processfile",
+          FilePath(SOTestDetail::scenePathnameStr).GetAbsolutePathname()
+        };
+
+        TEST_VERIFY(CountSODataComponents(SOTestDetail::scenePathnameStr) == 0);
+
+        std::unique_ptr<CommandLineModule> tool = std::make_unique<StaticOcclusionTool>(cmdLine);
+        DAVA::ConsoleModuleTestExecution::ExecuteModule(tool.get());
+
+        TEST_VERIFY(CountSODataComponents(SOTestDetail::scenePathnameStr) == 1);
+
+        CommandLineModuleTestUtils::ClearTestFolder(SOTestDetail::projectStr);
+    }
 }
 ;
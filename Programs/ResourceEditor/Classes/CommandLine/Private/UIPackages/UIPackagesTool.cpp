@@ -0,0 +1,142 @@
+#include "Classes/CommandLine/UIPackagesTool.h"
+
+#include <REPlatform/CommandLine/OptionName.h>
+
+#include <TArc/Utils/ModuleCollection.h>
+
+#include <FileSystem/FileSystem.h>
+#include <FileSystem/YamlNode.h>
+#include <FileSystem/YamlParser.h>
+#include <Logger/Logger.h>
+#include <Time/SystemTimer.h>
+#include <UI/DefaultUIPackageBuilder.h>
+#include <UI/UIPackageBinaryReader.h>
+#include <UI/UIPackageBinaryWriter.h>
+#include <UI/UIPackageLoader.h>
+
+namespace UIPackagesToolDetails
+{
+using namespace DAVA;
+
+// other yaml files, like fonts configs, are placed with packages too
+bool IsUIPackage(const FilePath& path)
+{
+    RefPtr<YamlParser> parser(YamlParser::Create(path));
+    return parser.Valid() && parser->GetRootNode() != nullptr && parser->GetRootNode()->Get("Header") != nullptr;
+}
+
+int64 MeasureLoadTime(const FilePath& path)
+{
+    int64 startTime = SystemTimer::GetUs();
+    DefaultUIPackageBuilder builder;
+    UIPackageLoader().LoadPackage(path, &builder);
+    return SystemTimer::GetUs() - startTime;
+}
+}
+
+UIPackagesTool::UIPackagesTool(const DAVA::Vector<DAVA::String>& commandLine)
+    : CommandLineModule(commandLine, "-uipackages")
+{
+    using namespace DAVA;
+
+    options.AddOption(OptionName::ProcessDir, VariantType(String("")), "Full path to folder with yaml UI packages");
+    options.AddOption(OptionName::Validate, VariantType(false), "Don't compile packages, check that compiled packages match content of yaml packages");
+    options.AddOption(OptionName::RemoveSource, VariantType(false), "Remove yaml packages after compilation, compiled packages are used without checking yaml");
+}
+
+bool UIPackagesTool::PostInitInternal()
+{
+    using namespace DAVA;
+
+    folder = options.GetOption(OptionName::ProcessDir).AsString();
+    validate = options.GetOption(OptionName::Validate).AsBool();
+    removeSource = options.GetOption(OptionName::RemoveSource).AsBool();
+    if (folder.IsEmpty())
+    {
+        Logger::Error("'%s' param should be specified", OptionName::ProcessDir.c_str());
+        return false;
+    }
+
+    folder.MakeDirectoryPathname();
+    if (!FileSystem::Instance()->IsDirectory(folder))
+    {
+        Logger::Error("Folder %s doesn't exist", folder.GetAbsolutePathname().c_str());
+        return false;
+    }
+
+    return true;
+}
+
+DAVA::ConsoleModule::eFrameResult UIPackagesTool::OnFrameInternal()
+{
+    using namespace DAVA;
+    using namespace UIPackagesToolDetails;
+
+    uint32 compiledCount = 0;
+    int64 yamlTime = 0;
+    int64 compiledTime = 0;
+
+    Vector<FilePath> files = FileSystem::Instance()->EnumerateFilesInDirectory(folder);
+    if (validate)
+    {
+        uint32 outdatedCount = 0;
+        for (const FilePath& path : files)
+        {
+            if (path.IsEqualToExtension(".yaml") && IsUIPackage(path) && !UIPackageBinaryReader(nullptr).Open(path))
+            {
+                Logger::Error("Compiled UI package for %s is missing or outdated", path.GetAbsolutePathname().c_str());
+                ++outdatedCount;
+            }
+        }
+
+        if (outdatedCount > 0)
+        {
+            result = Result::RESULT_ERROR;
+        }
+        Logger::Info("%u compiled UI packages are missing or outdated in %s", outdatedCount, folder.GetAbsolutePathname().c_str());
+        return DAVA::ConsoleModule::eFrameResult::FINISHED;
+    }
+
+    for (const FilePath& path : files)
+    {
+        if (!path.IsEqualToExtension(".yaml") || !IsUIPackage(path))
+            continue;
+
+        FilePath binaryPath = UIPackageBinaryReader::GetBinaryPath(path);
+        FileSystem::Instance()->DeleteFile(binaryPath);
+        yamlTime += MeasureLoadTime(path);
+
+        if (UIPackageBinaryWriter::Compile(path, binaryPath, removeSource))
+        {
+            if (removeSource && !FileSystem::Instance()->DeleteFile(path))
+            {
+                Logger::Error("Can't remove UI package %s", path.GetAbsolutePathname().c_str());
+                result = Result::RESULT_ERROR;
+            }
+            compiledTime += MeasureLoadTime(path);
+            ++compiledCount;
+        }
+        else
+        {
+            Logger::Error("Can't compile UI package %s", path.GetAbsolutePathname().c_str());
+            result = Result::RESULT_ERROR;
+        }
+    }
+
+    Logger::Info("%u UI packages compiled in %s", compiledCount, folder.GetAbsolutePathname().c_str());
+    Logger::Info("Packages loading time: %lld us from yaml, %lld us from compiled packages", yamlTime, compiledTime);
+
+    return DAVA::ConsoleModule::eFrameResult::FINISHED;
+}
+
+void UIPackagesTool::ShowHelpInternal()
+{
+    CommandLineModule::ShowHelpInternal();
+
+    DAVA::Logger::Info("Examples:");
+    DAVA::Logger::Info("\t-uipackages -processdir /Users/Test/Data/UI/");
+    DAVA::Logger::Info("\t-uipackages -processdir /Users/Test/Data/UI/ -validate");
+    DAVA::Logger::Info("\t-uipackages -processdir /Users/Test/Data/UI/ -removesource");
+}
+
+DECL_TARC_MODULE(UIPackagesTool);
@@ -0,0 +1,106 @@
+#include "Classes/CommandLine/UIPackagesTool.h"
+
+#include <REPlatform/CommandLine/CommandLineModuleTestUtils.h>
+
+#include <TArc/Testing/ConsoleModuleTestExecution.h>
+#include <TArc/Testing/TArcUnitTests.h>
+
+#include <Base/BaseTypes.h>
+#include <Base/ScopedPtr.h>
+#include <FileSystem/File.h>
+#include <FileSystem/FileSystem.h>
+#include <UI/UIPackageBinaryReader.h>
+
+namespace UIPTestDetail
+{
+const DAVA::String testFolderStr = "~doc:/Test/UIPackagesTool/";
+const DAVA::String packagePathnameStr = testFolderStr + "Package.yaml";
+const DAVA::String fontsPathnameStr = testFolderStr + "fonts.yaml";
+
+const char* PACKAGE_TEXT =
+"Header:\n"
+"    version: \"17\"\n"
+"StyleSheets:\n"
+"-   selector: \".red\"\n"
+"    properties:\n"
+"        bg-color: [1.000000, 0.000000, 0.000000, 1.000000]\n"
+"Prototypes:\n"
+"-   class: \"UIControl\"\n"
+"    name: \"Proto\"\n"
+"    size: [32.000000, 32.000000]\n"
+"Controls:\n"
+"-   prototype: \"Proto\"\n"
+"    name: \"Root\"\n"
+"    children:\n"
+"    -   class: \"UIControl\"\n"
+"        name: \"Child\"\n"
+"        classes: \"red\"\n";
+
+void WriteFile(const DAVA::String& pathname, const DAVA::String& text)
+{
+    DAVA::ScopedPtr<DAVA::File> file(DAVA::File::Create(pathname, DAVA::File::CREATE | DAVA::File::WRITE));
+    if (file)
+    {
+        file->WriteNonTerminatedString(text);
+    }
+}
+}
+
+DAVA_TARC_TESTCLASS(UIPackagesToolTest)
+{
+    BEGIN_FILES_COVERED_BY_TESTS()
+    FIND_FILES_IN_TARGET(TArc)
+    DECLARE_COVERED_FILES("UIPackagesTool.cpp")
+    END_FILES_COVERED_BY_TESTS();
+
+    DAVA_TEST (CompilePackages)
+    {
+        using namespace DAVA;
+
+        CommandLineModuleTestUtils::CreateTestFolder(UIPTestDetail::testFolderStr);
+        UIPTestDetail::WriteFile(UIPTestDetail::packagePathnameStr, UIPTestDetail::PACKAGE_TEXT);
+        UIPTestDetail::WriteFile(UIPTestDetail::fontsPathnameStr, "fonts: {}\n");
+
+        Vector<String> cmdLine =
+        {
+          "ResourceEditor",
+          "-uipackages",
+          "-processdir",
+          FilePath(UIPTestDetail::testFolderStr).GetAbsolutePathname()
+        };
+
+        std::unique_ptr<CommandLineModule> tool = std::make_unique<UIPackagesTool>(cmdLine);
+        DAVA::ConsoleModuleTestExecution::ExecuteModule(tool.get());
+        TEST_VERIFY(tool->GetExitCode() == 0);
+
+        // only UI packages are compiled
+        TEST_VERIFY(UIPackageBinaryReader(nullptr).Open(UIPTestDetail::packagePathnameStr));
+        TEST_VERIFY(!FileSystem::Instance()->Exists(UIPackageBinaryReader::GetBinaryPath(UIPTestDetail::fontsPathnameStr)));
+
+        cmdLine.push_back("-validate");
+        tool = std::make_unique<UIPackagesTool>(cmdLine);
+        DAVA::ConsoleModuleTestExecution::ExecuteModule(tool.get());
+        TEST_VERIFY(tool->GetExitCode() == 0);
+
+        // content is changed, size is kept
+        String changedText = UIPTestDetail::PACKAGE_TEXT;
+        changedText.replace(changedText.find("Child"), 5, "Other");
+        UIPTestDetail::WriteFile(UIPTestDetail::packagePathnameStr, changedText);
+
+        tool = std::make_unique<UIPackagesTool>(cmdLine);
+        DAVA::ConsoleModuleTestExecution::ExecuteModule(tool.get());
+        TEST_VERIFY(tool->GetExitCode() != 0);
+
+        // packer removes yaml, compiled package is used without it
+        cmdLine.back() = "-removesource";
+        tool = std::make_unique<UIPackagesTool>(cmdLine);
+        DAVA::ConsoleModuleTestExecution::ExecuteModule(tool.get());
+        TEST_VERIFY(tool->GetExitCode() == 0);
+        TEST_VERIFY(!FileSystem::Instance()->Exists(UIPTestDetail::packagePathnameStr));
+        TEST_VERIFY(FileSystem::Instance()->Exists(UIPTestDetail::fontsPathnameStr));
+        TEST_VERIFY(UIPackageBinaryReader(nullptr).Open(UIPTestDetail::packagePathnameStr));
+
+        CommandLineModuleTestUtils::ClearTestFolder(UIPTestDetail::testFolderStr);
+    }
+}
+;
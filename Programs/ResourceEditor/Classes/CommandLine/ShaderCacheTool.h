@@ -0,0 +1,35 @@
+#pragma once
+
+#include <REPlatform/Global/CommandLineModule.h>
+
+#include <FileSystem/FilePath.h>
+#include <Reflection/ReflectionRegistrator.h>
+#include <Render/RHI/rhi_Type.h>
+
+/**
+    Builds shader cache for material variants used by scenes, so application doesn't translate shaders on first use.
+    Variants are translated in parallel and saved in format of rhi::ShaderSourceCache, which is loaded by engine on startup.
+*/
+class ShaderCacheTool : public DAVA::CommandLineModule
+{
+public:
+    ShaderCacheTool(const DAVA::Vector<DAVA::String>& commandLine);
+
+private:
+    bool PostInitInternal() override;
+    eFrameResult OnFrameInternal() override;
+    void BeforeDestroyedInternal() override;
+    void ShowHelpInternal() override;
+
+    DAVA::Vector<DAVA::FilePath> scenes;
+    DAVA::FilePath outFile;
+    rhi::Api targetApi = rhi::RHI_API_COUNT;
+    bool compareWithSerial = false;
+
+    DAVA_VIRTUAL_REFLECTION_IN_PLACE(ShaderCacheTool, DAVA::CommandLineModule)
+    {
+        DAVA::ReflectionRegistrator<ShaderCacheTool>::Begin()[DAVA::M::CommandName("-shadercache")]
+        .ConstructorByPointer<DAVA::Vector<DAVA::String>>()
+        .End();
+    }
+};
@@ -33,6 +33,7 @@ protected:
         ACTION_BUILD,
     };
     eAction commandAction = ACTION_NONE;
+    bool softwareRasterization = false;
 
     DAVA_VIRTUAL_REFLECTION_IN_PLACE(StaticOcclusionTool, DAVA::CommandLineModule)
     {
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <REPlatform/Global/CommandLineModule.h>
+
+#include <FileSystem/FilePath.h>
+#include <Reflection/ReflectionRegistrator.h>
+
+/**
+    Compiles yaml UI packages of folder into binary packages (*.uib), which are placed next to yaml packages
+    and loaded by UIPackageLoader without yaml parsing. With '-removesource' yaml packages are removed after compilation,
+    and compiled packages are used without checking yaml. With '-validate' compiled packages are checked against content of yaml packages.
+*/
+class UIPackagesTool : public DAVA::CommandLineModule
+{
+public:
+    UIPackagesTool(const DAVA::Vector<DAVA::String>& commandLine);
+
+private:
+    bool PostInitInternal() override;
+    eFrameResult OnFrameInternal() override;
+    void ShowHelpInternal() override;
+
+    DAVA::FilePath folder;
+    bool validate = false;
+    bool removeSource = false;
+
+    DAVA_VIRTUAL_REFLECTION_IN_PLACE(UIPackagesTool, DAVA::CommandLineModule)
+    {
+        DAVA::ReflectionRegistrator<UIPackagesTool>::Begin()[DAVA::M::CommandName("-uipackages")]
+        .ConstructorByPointer<DAVA::Vector<DAVA::String>>()
+        .End();
+    }
+};
@@ -2,12 +2,161 @@
 #include <FileSystem/Private/PackArchive.h>
 #include <FileSystem/Private/ZipArchive.h>
 #include <FileSystem/FileSystem.h>
+#include <FileSystem/ResourceArchive.h>
+#include <Compression/LZ4Compressor.h>
+#include <Compression/ZstdCompressor.h>
 #include <Logger/Logger.h>
+#include <Time/SystemTimer.h>
+#include <Utils/CRC32.h>
+#include <Utils/StringFormat.h>
 
 #include <cstring>
 
+#if defined(__DAVAENGINE_POSIX__)
+#include <sys/resource.h>
+#endif
+
 using namespace DAVA;
 
+namespace ArchiveTestDetails
+{
+#if defined(__DAVAENGINE_WIN32__) || defined(__DAVAENGINE_MACOS__) || defined(__DAVAENGINE_LINUX__)
+#define ARCHIVE_TEST_MEMORY_MAPPED_PACK
+#endif
+
+// Benchmark pack: 512 stored files 4 Mb each, 2 Gb total
+// Benchmark is run only if ARCHIVE_TEST_MAPPED_PACK_BENCHMARK is defined, see UNIT_TESTS_MAPPED_PACK_BENCHMARK option in UnitTests CMakeLists.txt
+const uint32 BENCHMARK_FILES_COUNT = 512;
+const uint32 BENCHMARK_FILE_SIZE = 4 * 1024 * 1024;
+
+String GetPackedFileName(uint32 index)
+{
+    return Format("data/file_%u.bin", index);
+}
+
+// Files count and size for LoadFiles benchmark
+const uint32 LOAD_FILES_BENCHMARK_COUNT = 256;
+const uint32 LOAD_FILES_BENCHMARK_SIZE = 1024 * 1024;
+
+/*
+    Write dvpk with files named by GetPackedFileName, compressed with `compressionType` (stored for Compressor::Type::None).
+    Content of files is produced by `getContent` one by one, so big packs can be written without holding all content in memory.
+*/
+bool WritePack(const FilePath& packPath, uint32 filesCount, Compressor::Type compressionType, const Function<void(uint32, Vector<uint8>&)>& getContent)
+{
+    ScopedPtr<File> file(File::Create(packPath, File::CREATE | File::WRITE));
+    if (!file)
+    {
+        return false;
+    }
+
+    PackFormat::PackFile packFile;
+    Vector<PackFormat::FileTableEntry>& entries = packFile.filesTable.data.files;
+    entries.resize(filesCount);
+
+    String names;
+    Vector<uint8> content;
+    Vector<uint8> compressed;
+    uint64 dataOffset = 0;
+    for (uint32 i = 0; i < filesCount; ++i)
+    {
+        content.clear();
+        getContent(i, content);
+
+        const Vector<uint8>* packed = &content;
+        if (compressionType == Compressor::Type::Lz4 || compressionType == Compressor::Type::Zstd)
+        {
+            compressed.clear();
+            bool compressedOk = (compressionType == Compressor::Type::Lz4) ? LZ4Compressor().Compress(content, compressed) : ZstdCompressor().Compress(content, compressed);
+            if (!compressedOk)
+            {
+                return false;
+            }
+            packed = &compressed;
+        }
+        else if (compressionType != Compressor::Type::None)
+        {
+            return false; // other compressors are not needed by tests
+        }
+
+        uint32 packedSize = static_cast<uint32>(packed->size());
+        if (file->Write(packed->data(), packedSize) != packedSize)
+        {
+            return false;
+        }
+
+        PackFormat::FileTableEntry& entry = entries[i];
+        entry.startPosition = dataOffset;
+        entry.compressedSize = packedSize;
+        entry.originalSize = static_cast<uint32>(content.size());
+        entry.compressedCrc32 = CRC32::ForBuffer(packed->data(), packed->size());
+        entry.originalCrc32 = CRC32::ForBuffer(content.data(), content.size());
+        entry.type = compressionType;
+        entry.metaIndex = 0;
+        dataOffset += packedSize;
+
+        names += GetPackedFileName(i);
+        names += '\0';
+    }
+
+    Vector<uint8> namesOriginal(names.begin(), names.end());
+    Vector<uint8> namesCompressed;
+    if (!LZ4HCCompressor().Compress(namesOriginal, namesCompressed))
+    {
+        return false;
+    }
+    uint32 namesCrc32 = CRC32::ForBuffer(namesCompressed.data(), namesCompressed.size());
+
+    // files table: entries, compressed names and crc32 of compressed names
+    uint32 entriesSize = static_cast<uint32>(entries.size() * sizeof(PackFormat::FileTableEntry));
+    Vector<uint8> filesTable(entriesSize + namesCompressed.size() + sizeof(namesCrc32));
+    std::memcpy(filesTable.data(), entries.data(), entriesSize);
+    std::memcpy(filesTable.data() + entriesSize, namesCompressed.data(), namesCompressed.size());
+    std::memcpy(filesTable.data() + entriesSize + namesCompressed.size(), &namesCrc32, sizeof(namesCrc32));
+    if (file->Write(filesTable.data(), static_cast<uint32>(filesTable.size())) != filesTable.size())
+    {
+        return false;
+    }
+
+    PackFormat::PackFile::FooterBlock& footer = packFile.footer;
+    footer.info.numFiles = filesCount;
+    footer.info.namesSizeCompressed = static_cast<uint32>(namesCompressed.size());
+    footer.info.namesSizeOriginal = static_cast<uint32>(namesOriginal.size());
+    footer.info.filesTableSize = static_cast<uint32>(filesTable.size());
+    footer.info.filesTableCrc32 = CRC32::ForBuffer(filesTable.data(), filesTable.size());
+    footer.info.packArchiveMarker = PackFormat::FILE_MARKER;
+    footer.infoCrc32 = CRC32::ForBuffer(&footer.info, sizeof(footer.info));
+
+    return file->Write(&footer, sizeof(footer)) == sizeof(footer);
+}
+
+void GenerateContent(uint32 index, uint32 size, Vector<uint8>& content)
+{
+    content.resize(size);
+    for (uint32 k = 0; k < size; ++k)
+    {
+        content[k] = static_cast<uint8>((k * 31 + index * 7) ^ (k >> 8));
+    }
+}
+
+// Peak resident set size of the process in bytes, 0 if not supported
+uint64 GetPeakRSS()
+{
+#if defined(__DAVAENGINE_POSIX__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+#if defined(__DAVAENGINE_APPLE__)
+        return static_cast<uint64>(usage.ru_maxrss);
+#else
+        return static_cast<uint64>(usage.ru_maxrss) * 1024;
+#endif
+    }
+#endif
+    return 0;
+}
+}
+
 DAVA_TESTCLASS (ArchiveTest)
 {
     DAVA_TEST (TestDavaArchive)
@@ -96,4 +245,196 @@ DAVA_TESTCLASS (ArchiveTest)
             TEST_VERIFY(false && "can't open zip file");
         }
     }
+
+    DAVA_TEST (TestPackArchiveFileView)
+    {
+        using namespace ArchiveTestDetails;
+
+        const uint32 filesCount = 16;
+        FilePath packPath("~doc:/TestData/ArchiveTest/stored.dvpk");
+        FileSystem::Instance()->CreateDirectory(packPath.GetDirectory(), true);
+        TEST_VERIFY(WritePack(packPath, filesCount, Compressor::Type::None, [](uint32 index, Vector<uint8>& content) {
+            GenerateContent(index, 1000 + index * 4097, content);
+        }));
+
+        Vector<ResourceArchive::FileView> views(filesCount);
+        for (bool useMemoryMapping : { false, true })
+        {
+            {
+                ResourceArchive archive(packPath, useMemoryMapping);
+                for (uint32 i = 0; i < filesCount; ++i)
+                {
+                    TEST_VERIFY(archive.LoadFileView(GetPackedFileName(i), views[i]));
+
+                    Vector<uint8> loaded;
+                    TEST_VERIFY(archive.LoadFile(GetPackedFileName(i), loaded));
+                    TEST_VERIFY(loaded.size() == views[i].size);
+                    TEST_VERIFY(std::equal(loaded.begin(), loaded.end(), views[i].data));
+                }
+
+                ResourceArchive::FileView missingView;
+                TEST_VERIFY(!archive.LoadFileView("data/missing.bin", missingView));
+            }
+
+            // views keep their memory alive after archive is destroyed
+            Vector<uint8> expected;
+            for (uint32 i = 0; i < filesCount; ++i)
+            {
+                GenerateContent(i, 1000 + i * 4097, expected);
+                TEST_VERIFY(expected.size() == views[i].size);
+                TEST_VERIFY(std::equal(expected.begin(), expected.end(), views[i].data));
+                views[i] = ResourceArchive::FileView();
+            }
+        }
+
+#if defined(ARCHIVE_TEST_MEMORY_MAPPED_PACK)
+        {
+            RefPtr<File> packFile(File::Create(packPath, File::OPEN | File::READ));
+            PackArchive archive(packFile, packPath, true);
+            TEST_VERIFY(archive.IsMemoryMapped());
+        }
+#endif
+
+        FileSystem::Instance()->DeleteFile(packPath);
+    }
+
+    DAVA_TEST (TestPackArchiveMemoryMappedBenchmark)
+    {
+        using namespace ArchiveTestDetails;
+
+#if defined(ARCHIVE_TEST_MEMORY_MAPPED_PACK) && defined(ARCHIVE_TEST_MAPPED_PACK_BENCHMARK)
+        if (sizeof(void*) < 8)
+        {
+            return; // multi-Gb pack can't be mapped into 32-bit address space
+        }
+
+        FilePath packPath("~doc:/TestData/ArchiveTest/benchmark.dvpk");
+        FileSystem::Instance()->CreateDirectory(packPath.GetDirectory(), true);
+        if (!WritePack(packPath, BENCHMARK_FILES_COUNT, Compressor::Type::None, [](uint32 index, Vector<uint8>& content) {
+                GenerateContent(index, BENCHMARK_FILE_SIZE, content);
+            }))
+        {
+            Logger::Warning("can't write %u Mb benchmark pack, skip benchmark", (BENCHMARK_FILES_COUNT * (BENCHMARK_FILE_SIZE / 1024)) / 1024);
+            FileSystem::Instance()->DeleteFile(packPath);
+            return;
+        }
+
+        // peak RSS never decreases, so mode with smaller expected footprint goes first
+        for (bool useMemoryMapping : { true, false })
+        {
+            uint64 peakRSSBefore = GetPeakRSS();
+            int64 startTime = SystemTimer::GetMs();
+
+            uint64 loadedBytes = 0;
+            {
+                ResourceArchive archive(packPath, useMemoryMapping);
+                ResourceArchive::FileView view;
+                Vector<uint8> content;
+                for (uint32 i = 0; i < BENCHMARK_FILES_COUNT; ++i)
+                {
+                    // view of memory mapped pack avoids both copy and crc32 of content, pages are loaded on access only
+                    bool loaded = useMemoryMapping ? archive.LoadFileView(GetPackedFileName(i), view) : archive.LoadFile(GetPackedFileName(i), content);
+                    TEST_VERIFY(loaded);
+                    loadedBytes += useMemoryMapping ? view.size : content.size();
+                }
+            }
+
+            int64 loadTime = SystemTimer::GetMs() - startTime;
+            uint64 peakRSSAfter = GetPeakRSS();
+
+            Logger::Info("PackArchive %s: loaded %llu Mb in %lld ms, peak RSS grew by %llu Mb",
+                         useMemoryMapping ? "memory mapped LoadFileView" : "LoadFile",
+                         loadedBytes / (1024 * 1024), loadTime, (peakRSSAfter - peakRSSBefore) / (1024 * 1024));
+        }
+
+        FileSystem::Instance()->DeleteFile(packPath);
+#endif
+    }
+
+    DAVA_TEST (TestPackArchiveLoadFiles)
+    {
+        using namespace ArchiveTestDetails;
+
+        const uint32 filesCount = 24;
+        FilePath packPath("~doc:/TestData/ArchiveTest/compressed.dvpk");
+        FileSystem::Instance()->CreateDirectory(packPath.GetDirectory(), true);
+
+        // request files in order different from their order in pack
+        Vector<String> fileNames;
+        for (uint32 i = 0; i < filesCount; ++i)
+        {
+            fileNames.push_back(GetPackedFileName((i * 7) % filesCount));
+        }
+
+        Vector<Compressor::Type> compressionTypes = { Compressor::Type::Lz4, Compressor::Type::Zstd };
+        for (Compressor::Type compressionType : compressionTypes)
+        {
+            TEST_VERIFY(WritePack(packPath, filesCount, compressionType, [](uint32 index, Vector<uint8>& content) {
+                GenerateContent(index, 1000 + index * 4097, content);
+            }));
+
+            for (bool useMemoryMapping : { false, true })
+            {
+                ResourceArchive archive(packPath, useMemoryMapping);
+
+                Vector<Vector<uint8>> contents;
+                TEST_VERIFY(archive.LoadFiles(fileNames, contents));
+                TEST_VERIFY(contents.size() == fileNames.size());
+
+                Vector<uint8> expected;
+                for (uint32 i = 0; i < filesCount; ++i)
+                {
+                    uint32 index = (i * 7) % filesCount;
+                    GenerateContent(index, 1000 + index * 4097, expected);
+                    TEST_VERIFY(expected == contents[i]);
+
+                    Vector<uint8> loaded;
+                    TEST_VERIFY(archive.LoadFile(fileNames[i], loaded));
+                    TEST_VERIFY(loaded == contents[i]);
+                }
+
+                Vector<String> withMissing = { fileNames[0], "data/missing.bin" };
+                TEST_VERIFY(!archive.LoadFiles(withMissing, contents));
+            }
+
+            FileSystem::Instance()->DeleteFile(packPath);
+        }
+    }
+
+    DAVA_TEST (TestPackArchiveLoadFilesBenchmark)
+    {
+        using namespace ArchiveTestDetails;
+
+        FilePath packPath("~doc:/TestData/ArchiveTest/lz4_benchmark.dvpk");
+        FileSystem::Instance()->CreateDirectory(packPath.GetDirectory(), true);
+        TEST_VERIFY(WritePack(packPath, LOAD_FILES_BENCHMARK_COUNT, Compressor::Type::Lz4, [](uint32 index, Vector<uint8>& content) {
+            GenerateContent(index, LOAD_FILES_BENCHMARK_SIZE, content);
+        }));
+
+        Vector<String> fileNames;
+        for (uint32 i = 0; i < LOAD_FILES_BENCHMARK_COUNT; ++i)
+        {
+            fileNames.push_back(GetPackedFileName(i));
+        }
+
+        ResourceArchive archive(packPath);
+
+        int64 startTime = SystemTimer::GetMs();
+        Vector<uint8> content;
+        for (const String& fileName : fileNames)
+        {
+            TEST_VERIFY(archive.LoadFile(fileName, content));
+        }
+        int64 sequentialTime = SystemTimer::GetMs() - startTime;
+
+        startTime = SystemTimer::GetMs();
+        Vector<Vector<uint8>> contents;
+        TEST_VERIFY(archive.LoadFiles(fileNames, contents));
+        int64 parallelTime = SystemTimer::GetMs() - startTime;
+
+        Logger::Info("PackArchive %u lz4 files %u Kb each: LoadFile one by one %lld ms, LoadFiles %lld ms",
+                     LOAD_FILES_BENCHMARK_COUNT, LOAD_FILES_BENCHMARK_SIZE / 1024, sequentialTime, parallelTime);
+
+        FileSystem::Instance()->DeleteFile(packPath);
+    }
 };
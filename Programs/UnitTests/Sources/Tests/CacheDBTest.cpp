@@ -0,0 +1,217 @@
+#include "UnitTests/UnitTests.h"
+
+#if defined(__DAVAENGINE_WIN32__) || defined(__DAVAENGINE_MACOS__)
+
+#include "CacheDB.h"
+
+#include <AssetCache/CachedItemValue.h>
+#include <Base/ScopedPtr.h>
+#include <Concurrency/Thread.h>
+#include <FileSystem/FileSystem.h>
+
+#include <random>
+
+namespace CacheDBTestDetails
+{
+using namespace DAVA;
+
+const FilePath CACHE_FOLDER("~doc:/TestData/CacheDBTest/");
+const String FILE_NAME = "data.bin";
+const uint32 ITEM_SIZE = 4096;
+
+struct SizeListener : public CacheDBOwner
+{
+    void OnStorageSizeChanged(uint64 occupied, uint64 overall) override
+    {
+    }
+};
+
+AssetCache::CacheItemKey CreateKey(uint8 first, uint8 second)
+{
+    AssetCache::CacheItemKey key;
+    key.fill(0);
+    key[0] = first;
+    key[1] = second;
+    return key;
+}
+
+// random data, so chunks of different items are not shared and each item occupies ITEM_SIZE
+std::shared_ptr<Vector<uint8>> CreateData(uint32 seed)
+{
+    std::mt19937 generator(seed);
+    std::shared_ptr<Vector<uint8>> data = std::make_shared<Vector<uint8>>(ITEM_SIZE);
+    for (uint8& byte : *data)
+    {
+        byte = static_cast<uint8>(generator());
+    }
+    return data;
+}
+
+AssetCache::CachedItemValue CreateValue(uint32 seed)
+{
+    AssetCache::CachedItemValue value;
+    value.Add(FILE_NAME, CreateData(seed));
+    return value;
+}
+
+bool HasItem(CacheDB& db, const AssetCache::CacheItemKey& key, uint32 seed)
+{
+    AssetCache::CachedItemValue value;
+    if (!db.Get(key, value))
+    {
+        return false;
+    }
+    const Vector<uint8>* data = value.GetFileData(FILE_NAME);
+    return data != nullptr && *data == *CreateData(seed);
+}
+}
+
+DAVA_TESTCLASS (CacheDBTest)
+{
+    CacheDBTest()
+    {
+        DAVA::FileSystem::Instance()->DeleteDirectory(CacheDBTestDetails::CACHE_FOLDER, true);
+    }
+
+    ~CacheDBTest()
+    {
+        DAVA::FileSystem::Instance()->DeleteDirectory(CacheDBTestDetails::CACHE_FOLDER, true);
+    }
+
+    DAVA_TEST (ShardIsSelectedByFirstByteOfKey)
+    {
+        using namespace DAVA;
+        using namespace CacheDBTestDetails;
+
+        for (uint32 first = 0; first < 256; ++first)
+        {
+            uint32 shardIndex = CacheDB::GetShardIndex(CreateKey(static_cast<uint8>(first), 0));
+            TEST_VERIFY(shardIndex == first % CacheDB::SHARDS_COUNT);
+            TEST_VERIFY(shardIndex == CacheDB::GetShardIndex(CreateKey(static_cast<uint8>(first), 0xff)));
+        }
+    }
+
+    DAVA_TEST (LeastRecentlyUsedItemIsEvicted)
+    {
+        using namespace DAVA;
+        using namespace CacheDBTestDetails;
+
+        SizeListener listener;
+        CacheDB db(listener);
+        // three and a half items fit into storage, two items are kept in memory
+        db.UpdateSettings(CACHE_FOLDER + "Eviction/", ITEM_SIZE * 3 + ITEM_SIZE / 2, 2, 0);
+
+        Array<AssetCache::CacheItemKey, 5> keys = { {
+        CreateKey(0, 0), CreateKey(1, 1), CreateKey(2, 2), CreateKey(3, 3),
+        CreateKey(CacheDB::SHARDS_COUNT, 4) // same shard as the first key
+        } };
+        TEST_VERIFY(CacheDB::GetShardIndex(keys[0]) == CacheDB::GetShardIndex(keys[4]));
+
+        for (uint32 i = 0; i < 3; ++i)
+        {
+            db.Insert(keys[i], CreateValue(i));
+        }
+        TEST_VERIFY(db.GetOccupiedSize() == ITEM_SIZE * 3);
+
+        // item 0 was unloaded from memory as the least recently used one, data is read from chunks
+        TEST_VERIFY(HasItem(db, keys[0], 0));
+
+        // item 1 is the least recently used
+        db.Insert(keys[3], CreateValue(3));
+        TEST_VERIFY(db.GetOccupiedSize() == ITEM_SIZE * 3);
+        TEST_VERIFY(!HasItem(db, keys[1], 1));
+
+        // order is 0, 3, 2 after timestamp update, item 0 is evicted by item of its own shard
+        db.UpdateAccessTimestamp(keys[2]);
+        db.Insert(keys[4], CreateValue(4));
+        TEST_VERIFY(db.GetOccupiedSize() == ITEM_SIZE * 3);
+        TEST_VERIFY(!HasItem(db, keys[0], 0));
+        TEST_VERIFY(HasItem(db, keys[2], 2));
+        TEST_VERIFY(HasItem(db, keys[3], 3));
+        TEST_VERIFY(HasItem(db, keys[4], 4));
+        TEST_VERIFY(db.GetItemsDataSize() == ITEM_SIZE * 3);
+
+        TEST_VERIFY(db.Remove(keys[3]));
+        TEST_VERIFY(!db.Remove(keys[3]));
+        TEST_VERIFY(db.GetOccupiedSize() == ITEM_SIZE * 2);
+
+        db.ClearStorage();
+        TEST_VERIFY(db.GetOccupiedSize() == 0);
+        TEST_VERIFY(!HasItem(db, keys[4], 4));
+    }
+
+    DAVA_TEST (LRUOrderIsRestoredOnLoad)
+    {
+        using namespace DAVA;
+        using namespace CacheDBTestDetails;
+
+        const FilePath folder = CACHE_FOLDER + "Load/";
+        Array<AssetCache::CacheItemKey, 3> keys = { { CreateKey(0, 0), CreateKey(1, 1), CreateKey(2, 2) } };
+        {
+            SizeListener listener;
+            CacheDB db(listener);
+            db.UpdateSettings(folder, ITEM_SIZE * 3, 0, 0);
+            for (uint32 i = 0; i < 3; ++i)
+            {
+                db.Insert(keys[i], CreateValue(i));
+            }
+            db.UpdateAccessTimestamp(keys[0]);
+            db.Save();
+        }
+
+        SizeListener listener;
+        CacheDB db(listener);
+        db.UpdateSettings(folder, ITEM_SIZE * 3, 0, 0);
+        TEST_VERIFY(db.GetOccupiedSize() == ITEM_SIZE * 3);
+
+        // order is 1, 2, 0 as before save
+        db.Insert(CreateKey(3, 3), CreateValue(3));
+        TEST_VERIFY(!HasItem(db, keys[1], 1));
+        TEST_VERIFY(HasItem(db, keys[2], 2));
+        TEST_VERIFY(HasItem(db, keys[0], 0));
+    }
+
+    DAVA_TEST (ConcurrentRequestsToAllShards)
+    {
+        using namespace DAVA;
+        using namespace CacheDBTestDetails;
+
+        const uint32 threadsCount = 4;
+        const uint32 itemsPerThread = 64;
+
+        SizeListener listener;
+        CacheDB db(listener);
+        // half of items are evicted while threads work
+        db.UpdateSettings(CACHE_FOLDER + "Concurrent/", ITEM_SIZE * threadsCount * itemsPerThread / 2, 16, 0);
+
+        Atomic<uint32> failedCount(0);
+        Vector<ScopedPtr<Thread>> threads;
+        for (uint32 t = 0; t < threadsCount; ++t)
+        {
+            threads.emplace_back(Thread::Create([&db, &failedCount, t, itemsPerThread]() {
+                for (uint32 i = 0; i < itemsPerThread; ++i)
+                {
+                    AssetCache::CacheItemKey key = CreateKey(static_cast<uint8>(i), static_cast<uint8>(t));
+                    uint32 seed = t * itemsPerThread + i;
+                    db.Insert(key, CreateValue(seed));
+                    // just inserted item is the most recently used one in its shard
+                    if (!HasItem(db, key, seed))
+                    {
+                        ++failedCount;
+                    }
+                }
+            }));
+            threads.back()->Start();
+        }
+        for (ScopedPtr<Thread>& thread : threads)
+        {
+            thread->Join();
+        }
+
+        TEST_VERIFY(failedCount == 0);
+        TEST_VERIFY(db.GetOccupiedSize() <= db.GetStorageSize());
+        TEST_VERIFY(db.GetOccupiedSize() == db.GetItemsDataSize());
+    }
+};
+
+#endif // __DAVAENGINE_WIN32__ || __DAVAENGINE_MACOS__
@@ -0,0 +1,121 @@
+#include "UnitTests/UnitTests.h"
+
+#if defined(__DAVAENGINE_WIN32__) || defined(__DAVAENGINE_MACOS__)
+
+#include "ChunkStorage.h"
+
+#include <Base/ScopedPtr.h>
+#include <FileSystem/File.h>
+#include <FileSystem/FileSystem.h>
+#include <Utils/MD5.h>
+
+namespace ChunkStorageTestDetails
+{
+using namespace DAVA;
+
+const FilePath STORAGE_FOLDER("~doc:/TestData/ChunkStorageTest/");
+
+Vector<uint8> CreateChunkData(uint32 size, uint8 seed)
+{
+    Vector<uint8> data(size);
+    for (uint32 i = 0; i < size; ++i)
+    {
+        data[i] = static_cast<uint8>(seed + i * 7);
+    }
+    return data;
+}
+
+MD5::MD5Digest GetDigest(const Vector<uint8>& data)
+{
+    MD5::MD5Digest digest;
+    MD5::ForData(data.data(), static_cast<uint32>(data.size()), digest);
+    return digest;
+}
+}
+
+DAVA_TESTCLASS (ChunkStorageTest)
+{
+    ChunkStorageTest()
+    {
+        DAVA::FileSystem::Instance()->DeleteDirectory(ChunkStorageTestDetails::STORAGE_FOLDER, true);
+        DAVA::FileSystem::Instance()->CreateDirectory(ChunkStorageTestDetails::STORAGE_FOLDER, true);
+    }
+
+    ~ChunkStorageTest()
+    {
+        DAVA::FileSystem::Instance()->DeleteDirectory(ChunkStorageTestDetails::STORAGE_FOLDER, true);
+    }
+
+    DAVA_TEST (SharedChunkIsStoredOnce)
+    {
+        using namespace DAVA;
+        using namespace ChunkStorageTestDetails;
+
+        ChunkStorage storage;
+        storage.SetFolder(STORAGE_FOLDER);
+
+        Vector<uint8> data = CreateChunkData(1024, 1);
+        MD5::MD5Digest digest = GetDigest(data);
+
+        uint64 writtenSize = 0;
+        TEST_VERIFY(storage.AddReference(digest, data.data(), 1024, writtenSize));
+        TEST_VERIFY(writtenSize == 1024);
+        TEST_VERIFY(storage.AddReference(digest, data.data(), 1024, writtenSize));
+        TEST_VERIFY(writtenSize == 0);
+        TEST_VERIFY(storage.GetStoredSize() == 1024);
+        TEST_VERIFY(storage.GetReferencedSize() == 2048);
+
+        Vector<uint8> readData(1024);
+        TEST_VERIFY(storage.Read(digest, readData.data(), 1024));
+        TEST_VERIFY(readData == data);
+
+        TEST_VERIFY(storage.RemoveReference(digest) == 0);
+        TEST_VERIFY(storage.Contains(digest));
+        TEST_VERIFY(storage.RemoveReference(digest) == 1024);
+        TEST_VERIFY(!storage.Contains(digest));
+        TEST_VERIFY(storage.GetStoredSize() == 0);
+        TEST_VERIFY(storage.GetReferencedSize() == 0);
+        TEST_VERIFY(!storage.Read(digest, readData.data(), 1024));
+    }
+
+    DAVA_TEST (FailedWriteDoesNotAddReference)
+    {
+        using namespace DAVA;
+        using namespace ChunkStorageTestDetails;
+
+        ChunkStorage storage;
+        storage.SetFolder(STORAGE_FOLDER);
+
+        Vector<uint8> data = CreateChunkData(512, 2);
+        MD5::MD5Digest digest = GetDigest(data);
+
+        // regular file in place of chunk directory makes chunk file impossible to create
+        FilePath obstacle = STORAGE_FOLDER + MD5::HashToString(digest).substr(0, 2);
+        {
+            ScopedPtr<File> file(File::Create(obstacle, File::CREATE | File::WRITE));
+            TEST_VERIFY(file);
+        }
+
+        uint64 writtenSize = 0;
+        TEST_VERIFY(!storage.AddReference(digest, data.data(), 512, writtenSize));
+        TEST_VERIFY(writtenSize == 0);
+        TEST_VERIFY(!storage.Contains(digest));
+        TEST_VERIFY(storage.GetStoredSize() == 0);
+        TEST_VERIFY(storage.GetReferencedSize() == 0);
+
+        // failed chunk is written again from scratch, when write becomes possible
+        TEST_VERIFY(FileSystem::Instance()->DeleteFile(obstacle));
+        TEST_VERIFY(storage.AddReference(digest, data.data(), 512, writtenSize));
+        TEST_VERIFY(writtenSize == 512);
+
+        Vector<uint8> readData(512);
+        TEST_VERIFY(storage.Read(digest, readData.data(), 512));
+        TEST_VERIFY(readData == data);
+
+        TEST_VERIFY(storage.RemoveReference(digest) == 512);
+        TEST_VERIFY(storage.GetStoredSize() == 0);
+        TEST_VERIFY(storage.GetReferencedSize() == 0);
+    }
+};
+
+#endif // __DAVAENGINE_WIN32__ || __DAVAENGINE_MACOS__
@@ -1,10 +1,88 @@
 #include <Compression/ZipCompressor.h>
 #include <Compression/LZ4Compressor.h>
+#include <Compression/ZstdCompressor.h>
+#include <FileSystem/FileList.h>
+#include <FileSystem/FileSystem.h>
+#include <Logger/Logger.h>
+#include <Time/SystemTimer.h>
 
 #include "UnitTests/UnitTests.h"
 
 using namespace DAVA;
 
+namespace CompressorTestDetails
+{
+const uint32 DECOMPRESS_ITERATIONS_COUNT = 20;
+
+// Collect contents of small text resources, like yaml configs and scenes in packs
+void CollectTextFiles(const FilePath& dirPath, Vector<Vector<uint8>>& contents)
+{
+    ScopedPtr<FileList> fileList(new FileList(dirPath));
+    for (uint32 i = 0; i < fileList->GetCount(); ++i)
+    {
+        if (fileList->IsNavigationDirectory(i))
+        {
+            continue;
+        }
+
+        FilePath path = fileList->GetPathname(i);
+        if (fileList->IsDirectory(i))
+        {
+            CollectTextFiles(path, contents);
+        }
+        else if (path.IsEqualToExtension(".yaml") || path.IsEqualToExtension(".txt"))
+        {
+            Vector<uint8> content;
+            if (FileSystem::Instance()->ReadFileContents(path, content) && !content.empty() && content.size() <= 64 * 1024)
+            {
+                contents.push_back(std::move(content));
+            }
+        }
+    }
+}
+
+struct CompressionResult
+{
+    uint64 compressedSize = 0;
+    float64 decompressMbPerSecond = 0.0;
+    bool contentMatches = true;
+};
+
+CompressionResult MeasureCompressor(const Compressor& compressor, const Vector<Vector<uint8>>& contents)
+{
+    CompressionResult result;
+
+    uint64 originalSize = 0;
+    Vector<Vector<uint8>> compressed(contents.size());
+    for (size_t i = 0; i < contents.size(); ++i)
+    {
+        compressor.Compress(contents[i], compressed[i]);
+        result.compressedSize += compressed[i].size();
+        originalSize += contents[i].size();
+    }
+
+    Vector<Vector<uint8>> decompressed(contents.size());
+    for (size_t i = 0; i < contents.size(); ++i)
+    {
+        decompressed[i].resize(contents[i].size());
+    }
+
+    int64 startTime = SystemTimer::GetUs();
+    for (uint32 iteration = 0; iteration < DECOMPRESS_ITERATIONS_COUNT; ++iteration)
+    {
+        for (size_t i = 0; i < contents.size(); ++i)
+        {
+            compressor.Decompress(compressed[i], decompressed[i]);
+        }
+    }
+    int64 decompressTime = std::max<int64>(1, SystemTimer::GetUs() - startTime);
+
+    result.contentMatches = (decompressed == contents);
+    result.decompressMbPerSecond = (static_cast<float64>(originalSize) * DECOMPRESS_ITERATIONS_COUNT / (1024.0 * 1024.0)) / (decompressTime / 1000000.0);
+    return result;
+}
+}
+
 DAVA_TESTCLASS (CompressorTest)
 {
     DAVA_TEST (TestLZ4_LZ4HC_ZIP)
@@ -60,4 +138,67 @@ DAVA_TESTCLASS (CompressorTest)
             TEST_VERIFY(uncompressedZip == in);
         }
     }
+
+    DAVA_TEST (TestZstd)
+    {
+        using namespace CompressorTestDetails;
+
+        Vector<Vector<uint8>> contents;
+        CollectTextFiles("~res:/", contents);
+        TEST_VERIFY(!contents.empty());
+
+        Vector<uint8> dictionary = ZstdCompressor::TrainDictionary(contents, 16 * 1024);
+        const ZstdCompressor plainZstd;
+        const ZstdCompressor dictionaryZstd(dictionary);
+        TEST_VERIFY(!plainZstd.HasDictionary());
+        TEST_VERIFY(dictionaryZstd.HasDictionary() == !dictionary.empty());
+
+        for (const ZstdCompressor* zstd : { &plainZstd, &dictionaryZstd })
+        {
+            for (const Vector<uint8>& content : contents)
+            {
+                Vector<uint8> compressed;
+                TEST_VERIFY(zstd->Compress(content, compressed));
+
+                Vector<uint8> decompressed(content.size());
+                TEST_VERIFY(zstd->Decompress(compressed, decompressed));
+                TEST_VERIFY(decompressed == content);
+
+                // wrong expected size is an error
+                Vector<uint8> wrongSize(content.size() + 1);
+                TEST_VERIFY(!zstd->Decompress(compressed, wrongSize));
+            }
+        }
+    }
+
+    DAVA_TEST (ZstdAndLZ4Benchmark)
+    {
+        using namespace CompressorTestDetails;
+
+        Vector<Vector<uint8>> contents;
+        CollectTextFiles("~res:/", contents);
+
+        uint64 originalSize = 0;
+        for (const Vector<uint8>& content : contents)
+        {
+            originalSize += content.size();
+        }
+
+        const LZ4HCCompressor lz4hc;
+        const ZstdCompressor plainZstd;
+        const ZstdCompressor dictionaryZstd(ZstdCompressor::TrainDictionary(contents));
+        std::pair<const char*, const Compressor*> compressors[] = {
+            { "lz4hc", &lz4hc }, { "zstd", &plainZstd }, { "zstd with dictionary", &dictionaryZstd }
+        };
+
+        for (auto& compressor : compressors)
+        {
+            CompressionResult result = MeasureCompressor(*compressor.second, contents);
+            TEST_VERIFY(result.contentMatches);
+
+            Logger::Info("%s on %u text files of %llu bytes: compressed to %llu bytes (ratio %.2f), decompress %.1f Mb/s",
+                         compressor.first, static_cast<uint32>(contents.size()), originalSize, result.compressedSize,
+                         static_cast<float64>(originalSize) / std::max<uint64>(1, result.compressedSize), result.decompressMbPerSecond);
+        }
+    }
 };
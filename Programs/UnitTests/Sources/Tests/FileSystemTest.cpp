@@ -534,6 +534,66 @@ DAVA_TESTCLASS (FileSystemTest)
         }
     }
 
+    DAVA_TEST (LoadCompressedMiniPackFileOfEachCompressionType)
+    {
+        FileSystem* fs = FileSystem::Instance();
+
+        Vector<uint8> buff(1024);
+        for (size_t i = 0; i < buff.size(); ++i)
+        {
+            buff[i] = static_cast<uint8>(i % 17);
+        }
+
+        for (Compressor::Type type : { Compressor::Type::None, Compressor::Type::Lz4, Compressor::Type::Lz4HC, Compressor::Type::Zstd })
+        {
+            Vector<uint8> compressedBuff;
+            if (type == Compressor::Type::Lz4)
+            {
+                LZ4Compressor().Compress(buff, compressedBuff);
+            }
+            else if (type == Compressor::Type::Lz4HC)
+            {
+                LZ4HCCompressor().Compress(buff, compressedBuff);
+            }
+            else
+            {
+                // content of zstd file doesn't matter, such dvpl is rejected by footer
+                compressedBuff = buff;
+            }
+
+            FilePath filePath = tempDir + "file.bin";
+            {
+                ScopedPtr<File> file(File::Create(filePath + ".dvpl", File::CREATE | File::WRITE));
+                TEST_VERIFY(file);
+                if (!file)
+                {
+                    continue;
+                }
+                file->Write(compressedBuff.data(), static_cast<uint32>(compressedBuff.size()));
+
+                PackFormat::LitePack::Footer footer;
+                footer.sizeCompressed = static_cast<uint32>(compressedBuff.size());
+                footer.sizeUncompressed = static_cast<uint32>(buff.size());
+                footer.type = type;
+                footer.crc32Compressed = CRC32::ForBuffer(compressedBuff.data(), compressedBuff.size());
+                footer.packMarkerLite = PackFormat::FILE_MARKER_LITE;
+                file->Write(&footer, sizeof(footer));
+            }
+
+            ScopedPtr<File> file(File::Create(filePath, File::OPEN | File::READ));
+            bool supported = PackFormat::LitePack::IsCompressionTypeSupported(type);
+            TEST_VERIFY((file.get() != nullptr) == supported);
+            if (file)
+            {
+                Vector<uint8> content(static_cast<size_t>(file->GetSize()));
+                TEST_VERIFY(file->Read(content.data(), static_cast<uint32>(content.size())) == content.size());
+                TEST_VERIFY(content == buff);
+            }
+
+            fs->DeleteFile(filePath + ".dvpl");
+        }
+    }
+
     DAVA_TEST (TagsTest)
     {
         FileSystem* fs = FileSystem::Instance();
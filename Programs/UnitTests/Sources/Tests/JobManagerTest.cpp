@@ -4,6 +4,7 @@
 using namespace DAVA;
 
 #define JOBS_COUNT 500
+#define BENCHMARK_JOBS_COUNT 200000
 
 struct JobManagerTestData
 {
@@ -83,8 +84,103 @@ DAVA_TESTCLASS (JobManagerTest)
 
     DAVA_TEST (TestWorkerJobs)
     {
-        // TODO:
-        // ...
+        JobManager* jobManager = GetEngineContext()->jobManager;
+
+        Atomic<int32> counter;
+        JobGroup group;
+        for (uint32 i = 0; i < JOBS_COUNT; ++i)
+        {
+            jobManager->CreateWorkerJob([&counter]() { counter.Increment(); }, &group);
+        }
+        jobManager->WaitWorkerJobs(&group);
+
+        TEST_VERIFY(group.IsFinished());
+        TEST_VERIFY(counter.Get() == JOBS_COUNT);
+    }
+
+    DAVA_TEST (TestChildWorkerJobs)
+    {
+        JobManager* jobManager = GetEngineContext()->jobManager;
+
+        const int32 childrenCount = 10;
+        Atomic<int32> counter;
+        JobGroup group;
+        for (uint32 i = 0; i < JOBS_COUNT; ++i)
+        {
+            jobManager->CreateWorkerJob([jobManager, &counter, childrenCount]() {
+                for (int32 j = 0; j < childrenCount; ++j)
+                {
+                    jobManager->CreateChildWorkerJob([&counter]() { counter.Increment(); });
+                }
+                counter.Increment();
+            },
+                                        &group);
+        }
+        jobManager->WaitWorkerJobs(&group);
+
+        // group is finished only after all children are finished
+        TEST_VERIFY(counter.Get() == JOBS_COUNT * (childrenCount + 1));
+    }
+
+    DAVA_TEST (TestParallelFor)
+    {
+        JobManager* jobManager = GetEngineContext()->jobManager;
+
+        Vector<uint32> values(100000, 0);
+        jobManager->ParallelFor(0, static_cast<uint32>(values.size()), [&values](uint32 begin, uint32 end) {
+            for (uint32 i = begin; i < end; ++i)
+            {
+                values[i] += i * 2;
+            }
+        });
+
+        bool allDone = true;
+        for (uint32 i = 0; i < values.size(); ++i)
+        {
+            allDone &= (values[i] == i * 2);
+        }
+        TEST_VERIFY(allDone);
+    }
+
+    DAVA_TEST (TestWorkerJobsThroughput)
+    {
+        // Micro-benchmark: how many jobs per millisecond can be pushed and popped
+        // with different count of worker-threads. Jobs are pushed from the main thread
+        // into the shared queue and from the worker-thread into its own queue.
+        uint32 maxWorkersCount = Max(1, DeviceInfo::GetCpuCount());
+        for (uint32 workersCount = 1; workersCount <= maxWorkersCount; ++workersCount)
+        {
+            JobManager jobManager(Engine::Instance(), workersCount);
+
+            Atomic<int32> counter;
+            JobGroup mainGroup;
+            int64 startTime = SystemTimer::GetUs();
+            for (uint32 i = 0; i < BENCHMARK_JOBS_COUNT; ++i)
+            {
+                jobManager.CreateWorkerJob([&counter]() { counter.Increment(); }, &mainGroup);
+            }
+            jobManager.WaitWorkerJobs(&mainGroup);
+            int64 mainTime = Max<int64>(1, SystemTimer::GetUs() - startTime);
+
+            JobGroup workerGroup;
+            startTime = SystemTimer::GetUs();
+            jobManager.CreateWorkerJob([&jobManager, &counter]() {
+                for (uint32 i = 0; i < BENCHMARK_JOBS_COUNT; ++i)
+                {
+                    jobManager.CreateChildWorkerJob([&counter]() { counter.Increment(); });
+                }
+            },
+                                       &workerGroup);
+            jobManager.WaitWorkerJobs(&workerGroup);
+            int64 workerTime = Max<int64>(1, SystemTimer::GetUs() - startTime);
+
+            TEST_VERIFY(counter.Get() == 2 * BENCHMARK_JOBS_COUNT);
+
+            Logger::Info("JobManager throughput with %u workers: %.1f jobs/ms pushed from main thread, %.1f jobs/ms pushed from worker",
+                         workersCount,
+                         BENCHMARK_JOBS_COUNT * 1000.0 / mainTime,
+                         BENCHMARK_JOBS_COUNT * 1000.0 / workerTime);
+        }
     }
 
     void ThreadFunc(JobManagerTestData * data)
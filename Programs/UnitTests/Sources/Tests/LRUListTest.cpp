@@ -0,0 +1,149 @@
+#include "UnitTests/UnitTests.h"
+
+#if defined(__DAVAENGINE_WIN32__) || defined(__DAVAENGINE_MACOS__)
+
+#include "LRUList.h"
+
+#include <Base/BaseTypes.h>
+
+namespace LRUListTestDetails
+{
+using namespace DAVA;
+
+struct Item
+{
+    int32 value = 0;
+    LRUListHook<Item> firstHook;
+    LRUListHook<Item> secondHook;
+};
+
+using FirstList = LRUList<Item, &Item::firstHook>;
+using SecondList = LRUList<Item, &Item::secondHook>;
+
+// values of items from the least to the most recently used, list is emptied
+template <typename TList>
+Vector<int32> PopAll(TList& list)
+{
+    Vector<int32> values;
+    while (Item* item = list.GetLeastRecentlyUsed())
+    {
+        values.push_back(item->value);
+        list.Remove(item);
+    }
+    return values;
+}
+}
+
+DAVA_TESTCLASS (LRUListTest)
+{
+    DAVA_TEST (LeastRecentlyUsedIsFirstPushed)
+    {
+        using namespace DAVA;
+        using namespace LRUListTestDetails;
+
+        Array<Item, 4> items;
+        FirstList list;
+        TEST_VERIFY(list.GetLeastRecentlyUsed() == nullptr);
+        TEST_VERIFY(list.GetCount() == 0);
+
+        for (size_t i = 0; i < items.size(); ++i)
+        {
+            items[i].value = static_cast<int32>(i);
+            list.PushFront(&items[i]);
+            TEST_VERIFY(list.IsLinked(&items[i]));
+        }
+        TEST_VERIFY(list.GetCount() == 4);
+        TEST_VERIFY(list.GetLeastRecentlyUsed() == &items[0]);
+
+        TEST_VERIFY(PopAll(list) == Vector<int32>({ 0, 1, 2, 3 }));
+        TEST_VERIFY(list.GetCount() == 0);
+        for (const Item& item : items)
+        {
+            TEST_VERIFY(!list.IsLinked(&item));
+        }
+    }
+
+    DAVA_TEST (TouchMovesItemToFront)
+    {
+        using namespace DAVA;
+        using namespace LRUListTestDetails;
+
+        Array<Item, 4> items;
+        FirstList list;
+        for (size_t i = 0; i < items.size(); ++i)
+        {
+            items[i].value = static_cast<int32>(i);
+            list.PushFront(&items[i]);
+        }
+
+        list.Touch(&items[0]); // tail
+        list.Touch(&items[2]); // middle
+        list.Touch(&items[2]); // head already
+        TEST_VERIFY(list.GetCount() == 4);
+        TEST_VERIFY(list.GetLeastRecentlyUsed() == &items[1]);
+        TEST_VERIFY(PopAll(list) == Vector<int32>({ 1, 3, 0, 2 }));
+    }
+
+    DAVA_TEST (RemoveKeepsOrderOfOthers)
+    {
+        using namespace DAVA;
+        using namespace LRUListTestDetails;
+
+        Array<Item, 5> items;
+        FirstList list;
+        for (size_t i = 0; i < items.size(); ++i)
+        {
+            items[i].value = static_cast<int32>(i);
+            list.PushFront(&items[i]);
+        }
+
+        list.Remove(&items[0]); // tail
+        list.Remove(&items[4]); // head
+        list.Remove(&items[2]); // middle
+        TEST_VERIFY(list.GetCount() == 2);
+        TEST_VERIFY(!list.IsLinked(&items[2]));
+
+        // removed item can be pushed again
+        list.PushFront(&items[2]);
+        TEST_VERIFY(PopAll(list) == Vector<int32>({ 1, 3, 2 }));
+
+        for (Item& item : items)
+        {
+            list.PushFront(&item);
+        }
+        list.Clear();
+        TEST_VERIFY(list.GetCount() == 0);
+        TEST_VERIFY(list.GetLeastRecentlyUsed() == nullptr);
+    }
+
+    DAVA_TEST (ItemIsInSeveralListsAtOnce)
+    {
+        using namespace DAVA;
+        using namespace LRUListTestDetails;
+
+        Array<Item, 3> items;
+        FirstList first;
+        SecondList second;
+        for (size_t i = 0; i < items.size(); ++i)
+        {
+            items[i].value = static_cast<int32>(i);
+            first.PushFront(&items[i]);
+        }
+        second.PushFront(&items[2]);
+        second.PushFront(&items[0]);
+
+        // order of one list doesn't depend on other
+        first.Touch(&items[0]);
+        second.Touch(&items[2]);
+        TEST_VERIFY(!second.IsLinked(&items[1]));
+        TEST_VERIFY(first.GetLeastRecentlyUsed() == &items[1]);
+        TEST_VERIFY(second.GetLeastRecentlyUsed() == &items[0]);
+
+        second.Remove(&items[0]);
+        TEST_VERIFY(first.IsLinked(&items[0]));
+        TEST_VERIFY(PopAll(first) == Vector<int32>({ 1, 2, 0 }));
+        TEST_VERIFY(PopAll(second) == Vector<int32>({ 2 }));
+    }
+};
+
+#endif // __DAVAENGINE_WIN32__ || __DAVAENGINE_MACOS__
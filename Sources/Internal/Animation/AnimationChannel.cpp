@@ -9,6 +9,7 @@ uint32 AnimationChannel::Bind(const uint8* _data)
     keysData = nullptr;
     dimension = 0;
     keyStride = keysCount = 0;
+    compression = COMPRESSION_NONE;
 
     const uint8* dataptr = _data;
     if (_data != nullptr && *reinterpret_cast<const uint32*>(_data) == ANIMATION_CHANNEL_DATA_SIGNATURE)
@@ -21,72 +22,142 @@ uint32 AnimationChannel::Bind(const uint8* _data)
         interpolation = eInterpolation(*dataptr);
         dataptr += 1;
 
-        compression = *reinterpret_cast<const uint16*>(dataptr);
+        compression = eCompression(*reinterpret_cast<const uint16*>(dataptr));
         dataptr += 2;
 
         keysCount = *reinterpret_cast<const uint32*>(dataptr);
         dataptr += 4;
 
-        keysData = dataptr;
+        if (dimension > MAX_DIMENSION || compression >= COMPRESSION_COUNT || (compression != COMPRESSION_NONE && interpolation == INTERPOLATION_BEZIER))
+        {
+            DVASSERT(false, "Unsupported animation channel data");
+            keysCount = 0;
+            return 0;
+        }
+
+        if (compression != COMPRESSION_NONE)
+        {
+            const float32* rangeData = reinterpret_cast<const float32*>(dataptr);
+            timeStart = rangeData[0];
+            timeScale = rangeData[1] / float32(AnimationChannelDetails::QUANTIZED_MAX);
+            dataptr += 2 * sizeof(float32);
+        }
+
+        switch (compression)
+        {
+        case COMPRESSION_NONE:
+            keyStride = uint32(sizeof(float32)) * (dimension + 1);
+            if (interpolation == INTERPOLATION_BEZIER)
+                keyStride += uint32(sizeof(float32) * 4); //four float32 as tangents
+            break;
+
+        case COMPRESSION_QUANTIZED:
+        {
+            const float32* rangeData = reinterpret_cast<const float32*>(dataptr);
+            for (uint32 d = 0; d < uint32(dimension); ++d)
+            {
+                valueStart[d] = rangeData[d];
+                valueScale[d] = rangeData[dimension + d] / float32(AnimationChannelDetails::QUANTIZED_MAX);
+            }
+            dataptr += 2 * dimension * sizeof(float32);
 
-        keyStride = uint32(sizeof(float32)) * (dimension + 1);
-        if (interpolation == INTERPOLATION_BEZIER)
-            keyStride += uint32(sizeof(float32) * 4); //four float32 as tangents
+            keyStride = uint32(sizeof(uint16)) * (dimension + 1);
+        }
+        break;
+
+        case COMPRESSION_SMALLEST_THREE:
+            DVASSERT(dimension == 4); //should be quaternion
+            keyStride = uint32(sizeof(uint16)) * 4;
+            break;
+
+        default:
+            break;
+        }
+
+        keysData = dataptr;
     }
 
-    return uint32(keysData - _data) + keysCount * keyStride;
-}
+    uint32 dataSize = uint32(keysData - _data) + keysCount * keyStride;
+    if (compression != COMPRESSION_NONE)
+        dataSize = (dataSize + 3) & ~3u; //compressed keys are padded to keep next data aligned
 
-#define KEY_DATA_SIZE (dimension * sizeof(float32))
-#define KEY_TIME(keyIndex) (*reinterpret_cast<const float32*>(keysData + (keyIndex)*keyStride))
-#define KEY_DATA(keyIndex) (reinterpret_cast<const float32*>(keysData + (keyIndex)*keyStride + sizeof(float32)))
-#define KEY_META(keyIndex) (KEY_DATA(keyIndex) + KEY_DATA_SIZE) //tangents for bezier interpolation
+    return dataSize;
+}
 
-void AnimationChannel::Evaluate(float32 time, float32* outData, uint32 dataSize) const
+void AnimationChannel::GetKeyValue(uint32 key, float32* outValue) const
 {
-    DVASSERT(dataSize >= GetDimension());
+    DVASSERT(key < keysCount);
 
-    uint32 k = startKey;
+    const uint8* keyData = keysData + key * keyStride;
+    switch (compression)
+    {
+    case COMPRESSION_NONE:
+        Memcpy(outValue, keyData + sizeof(float32), dimension * sizeof(float32));
+        break;
 
-    if (KEY_TIME(k) > time)
+    case COMPRESSION_QUANTIZED:
     {
-        k = 0;
+        const uint16* quantized = reinterpret_cast<const uint16*>(keyData) + 1;
+        for (uint32 d = 0; d < uint32(dimension); ++d)
+            outValue[d] = valueStart[d] + valueScale[d] * float32(quantized[d]);
     }
+    break;
 
-    for (; k < keysCount; ++k)
+    case COMPRESSION_SMALLEST_THREE:
     {
-        if (KEY_TIME(k) > time)
-            break;
+        using namespace AnimationChannelDetails;
+
+        //highest bits of first two components keep index of dropped largest component
+        const uint16* quantized = reinterpret_cast<const uint16*>(keyData) + 1;
+        uint32 largest = ((quantized[0] >> 15) << 1) | (quantized[1] >> 15);
 
-        startKey = k;
+        const float32 scale = 2.f * SMALLEST_THREE_RANGE / float32(SMALLEST_THREE_MAX);
+        float32 sumSquares = 0.f;
+        for (uint32 c = 0, i = 0; c < 4; ++c)
+        {
+            if (c != largest)
+            {
+                float32 value = float32(quantized[i++] & SMALLEST_THREE_MAX) * scale - SMALLEST_THREE_RANGE;
+                outValue[c] = value;
+                sumSquares += value * value;
+            }
+        }
+        outValue[largest] = std::sqrt(Max(0.f, 1.f - sumSquares));
     }
+    break;
 
-    if (k == 0)
-    {
-        Memcpy(outData, KEY_DATA(0), KEY_DATA_SIZE);
-        return;
+    default:
+        break;
     }
+}
+
+#define KEY_DATA_SIZE (dimension * sizeof(float32))
+#define KEY_TIME(keyIndex) GetKeyTime(keyIndex)
 
-    if (k == keysCount)
+void AnimationChannel::Evaluate(float32 time, float32* outData, uint32 dataSize) const
+{
+    Cursor cursor;
+    Evaluate(time, cursor, outData, dataSize);
+}
+
+void AnimationChannel::Evaluate(float32 time, Cursor& cursor, float32* outData, uint32 dataSize) const
+{
+    DVASSERT(dataSize >= GetDimension());
+
+    Segment segment = FindSegment(time, cursor);
+    if (segment.singleKey)
     {
-        Memcpy(outData, KEY_DATA(keysCount - 1), KEY_DATA_SIZE);
+        Memcpy(outData, segment.value0.data(), KEY_DATA_SIZE);
         return;
     }
 
-    uint32 k0 = k - 1;
-    float32 time0 = KEY_TIME(k0);
-    float32 time1 = KEY_TIME(k);
-    float32 t = (time - time0) / (time1 - time0);
-
     switch (interpolation)
     {
     case INTERPOLATION_LINEAR:
     {
         for (uint32 d = 0; d < uint32(dimension); ++d)
         {
-            float32 v0 = *(KEY_DATA(k0) + d);
-            float32 v1 = *(KEY_DATA(k) + d);
-            *(outData + d) = Lerp(v0, v1, t);
+            *(outData + d) = Lerp(segment.value0[d], segment.value1[d], segment.factor);
         }
     }
     break;
@@ -95,9 +166,9 @@ void AnimationChannel::Evaluate(float32 time, float32* outData, uint32 dataSize)
     {
         DVASSERT(dimension == 4); //should be quaternion
 
-        Quaternion q0(KEY_DATA(k0));
-        Quaternion q(KEY_DATA(k));
-        q.Slerp(q0, q, t);
+        Quaternion q0(segment.value0.data());
+        Quaternion q(segment.value1.data());
+        q.Slerp(q0, q, segment.factor);
         q.Normalize();
 
         Memcpy(outData, q.data, KEY_DATA_SIZE);
@@ -115,8 +186,73 @@ void AnimationChannel::Evaluate(float32 time, float32* outData, uint32 dataSize)
     }
 }
 
+AnimationChannel::Segment AnimationChannel::FindSegment(float32 time, Cursor& cursor) const
+{
+    DVASSERT(keysCount > 0);
+
+    uint32 k = FindKey(time, cursor.key);
+    cursor.key = (k > 0) ? k - 1 : 0;
+
+    Segment segment;
+    if (k == 0 || k == keysCount)
+    {
+        GetKeyValue(cursor.key, segment.value0.data());
+        segment.singleKey = true;
+        return segment;
+    }
+
+    uint32 k0 = k - 1;
+    float32 time0 = KEY_TIME(k0);
+    float32 time1 = KEY_TIME(k);
+
+    GetKeyValue(k0, segment.value0.data());
+    GetKeyValue(k, segment.value1.data());
+    segment.factor = (time - time0) / (time1 - time0);
+    return segment;
+}
+
+//returns index of the first key with time greater than `time`
+uint32 AnimationChannel::FindKey(float32 time, uint32 hintKey) const
+{
+    //sequential playback moves by few keys per frame, so keys next to hint are checked first
+    static const uint32 HINT_SEARCH_KEYS_COUNT = 4;
+
+    uint32 first = 0;
+    uint32 last = keysCount;
+    if (hintKey < keysCount && KEY_TIME(hintKey) <= time)
+    {
+        uint32 hintEnd = Min(hintKey + HINT_SEARCH_KEYS_COUNT, keysCount);
+        for (uint32 k = hintKey + 1; k < hintEnd; ++k)
+        {
+            if (KEY_TIME(k) > time)
+                return k;
+        }
+        first = hintEnd;
+    }
+    else if (hintKey < keysCount)
+    {
+        last = hintKey;
+    }
+
+    uint32 count = last - first;
+    while (count > 0)
+    {
+        uint32 step = count / 2;
+        uint32 k = first + step;
+        if (KEY_TIME(k) <= time)
+        {
+            first = k + 1;
+            count -= step + 1;
+        }
+        else
+        {
+            count = step;
+        }
+    }
+
+    return first;
+}
+
 #undef KEY_DATA_SIZE
 #undef KEY_TIME
-#undef KEY_DATA
-#undef KEY_META
 }
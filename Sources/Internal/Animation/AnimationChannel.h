@@ -18,25 +18,111 @@ public:
         INTERPOLATION_COUNT
     };
 
+    /**
+        Storage of keys, described in 'AnimationBinaryFormat.md'.
+        Compressed keys have 16-bit time quantized in time range of channel.
+    */
+    enum eCompression : uint16
+    {
+        COMPRESSION_NONE = 0,
+        COMPRESSION_QUANTIZED, //16-bit values quantized in per-channel value range, for linear channels
+        COMPRESSION_SMALLEST_THREE, //three smallest components of quaternion with 15 bits each, for spherical channels
+
+        COMPRESSION_COUNT
+    };
+
+    static const uint32 MAX_DIMENSION = 4;
+
+    /**
+        Position of last evaluation in channel keys.
+        Cursor is kept by evaluating side (e.g. by each animation instance), so channel itself is immutable
+        and may be evaluated from several threads at once. Sequential evaluation with cursor checks keys next
+        to previous position before binary search.
+    */
+    struct Cursor
+    {
+        uint32 key = 0;
+    };
+
+    /**
+        Decoded values of keys to interpolate between at some time.
+        If time is out of keys range, `singleKey` is set and only `value0` is filled with value of the boundary key.
+    */
+    struct Segment
+    {
+        Array<float32, MAX_DIMENSION> value0;
+        Array<float32, MAX_DIMENSION> value1;
+        float32 factor = 0.f;
+        bool singleKey = false;
+    };
+
     AnimationChannel() = default;
 
     uint32 Bind(const uint8* data);
     void Evaluate(float32 time, float32* outData, uint32 dataSize) const;
+    void Evaluate(float32 time, Cursor& cursor, float32* outData, uint32 dataSize) const;
+
+    Segment FindSegment(float32 time, Cursor& cursor) const;
 
     uint32 GetDimension() const;
+    eInterpolation GetInterpolation() const;
+    eCompression GetCompression() const;
+
+    uint32 GetKeysCount() const;
+    float32 GetKeyTime(uint32 key) const;
+    void GetKeyValue(uint32 key, float32* outValue) const;
 
 private:
+    uint32 FindKey(float32 time, uint32 hintKey) const;
+
     const DAVA::uint8* keysData = nullptr;
-    mutable uint32 startKey = 0;
     uint32 keysCount = 0;
     uint32 keyStride = 0;
-    uint16 compression = 0;
+    eCompression compression = COMPRESSION_NONE;
     uint8 dimension = 0;
     eInterpolation interpolation = INTERPOLATION_COUNT;
+
+    //dequantization parameters of compressed keys
+    float32 timeStart = 0.f;
+    float32 timeScale = 0.f;
+    Array<float32, MAX_DIMENSION> valueStart;
+    Array<float32, MAX_DIMENSION> valueScale;
 };
 
+namespace AnimationChannelDetails
+{
+//components of smallest-three quaternion are in range [-1/sqrt(2), 1/sqrt(2)]
+const float32 SMALLEST_THREE_RANGE = 0.70710678f;
+const uint32 SMALLEST_THREE_MAX = (1 << 15) - 1;
+const uint32 QUANTIZED_MAX = (1 << 16) - 1;
+}
+
 inline uint32 AnimationChannel::GetDimension() const
 {
     return uint32(dimension);
 }
+
+inline AnimationChannel::eInterpolation AnimationChannel::GetInterpolation() const
+{
+    return interpolation;
+}
+
+inline AnimationChannel::eCompression AnimationChannel::GetCompression() const
+{
+    return compression;
+}
+
+inline uint32 AnimationChannel::GetKeysCount() const
+{
+    return keysCount;
+}
+
+inline float32 AnimationChannel::GetKeyTime(uint32 key) const
+{
+    const uint8* keyData = keysData + key * keyStride;
+    if (compression == COMPRESSION_NONE)
+        return *reinterpret_cast<const float32*>(keyData);
+    else
+        return timeStart + timeScale * float32(*reinterpret_cast<const uint16*>(keyData));
+}
 }
\ No newline at end of file
@@ -0,0 +1,369 @@
+#include "Animation/AnimationChannelEncoder.h"
+
+#include "Base/BaseMath.h"
+#include "Debug/DVAssert.h"
+
+namespace DAVA
+{
+namespace AnimationChannelEncoderDetails
+{
+const uint32 MAX_SPLIT_PASSES = 8;
+
+template <typename T>
+void Write(Vector<uint8>& data, const T& value)
+{
+    const uint8* bytes = reinterpret_cast<const uint8*>(&value);
+    data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+uint16 Quantize(float32 value, float32 start, float32 extent, uint32 maxValue)
+{
+    if (extent <= 0.f)
+        return 0;
+
+    float32 normalized = Clamp((value - start) / extent, 0.f, 1.f);
+    return uint16(std::round(normalized * float32(maxValue)));
+}
+
+// Rotation from `origin` to `q` as rotation vector (axis scaled by angle), so slerp from `origin` is linear in it
+Vector3 GetRotationVector(const Quaternion& origin, const float32* value)
+{
+    Quaternion q(value);
+    q.Normalize();
+    Quaternion relative = origin.GetInverse() * q;
+    if (relative.w < 0.f)
+    {
+        relative.Set(-relative.x, -relative.y, -relative.z, -relative.w);
+    }
+
+    Vector3 axis(relative.x, relative.y, relative.z);
+    float32 sinHalfAngle = axis.Length();
+    if (sinHalfAngle < EPSILON)
+        return 2.f * axis;
+
+    return axis * (2.f * std::atan2(sinHalfAngle, relative.w) / sinHalfAngle);
+}
+
+/*
+    Greedy removal of keys in single pass: segment from the last kept key is extended while all skipped keys are interpolated with allowed error.
+    Each skipped key bounds slope of segment in every component, so candidate end of segment is checked against intersection of bounds only.
+    Spherical channels are handled in rotation vectors relative to segment start. Distance of rotations doesn't exceed distance of their rotation vectors,
+    and component error of `maxError / sqrt(3)` keeps rotation vectors within `maxError`, so the check is conservative for them.
+*/
+Vector<uint32> SelectKeys(const Vector<AnimationChannelEncoder::Key>& keys, uint32 dimension, AnimationChannel::eInterpolation interpolation, float32 maxError)
+{
+    Vector<uint32> selected;
+    if (keys.empty())
+        return selected;
+
+    selected.push_back(0);
+
+    bool spherical = (interpolation == AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR);
+    uint32 components = spherical ? 3 : dimension;
+    float32 componentError = spherical ? maxError / std::sqrt(3.f) : maxError;
+
+    Quaternion anchorRotation;
+    Array<float32, AnimationChannel::MAX_DIMENSION> anchorValue = {};
+    Array<float32, AnimationChannel::MAX_DIMENSION> minSlope;
+    Array<float32, AnimationChannel::MAX_DIMENSION> maxSlope;
+
+    //value of key relative to anchor, in rotation vectors for spherical channels
+    auto getOffset = [&](uint32 k, float32* offset) {
+        if (spherical)
+        {
+            Vector3 rotation = GetRotationVector(anchorRotation, keys[k].value.data());
+            Memcpy(offset, rotation.data, sizeof(rotation.data));
+        }
+        else
+        {
+            for (uint32 d = 0; d < components; ++d)
+                offset[d] = keys[k].value[d] - anchorValue[d];
+        }
+    };
+
+    auto setAnchor = [&](uint32 anchor) {
+        if (spherical)
+        {
+            anchorRotation = Quaternion(keys[anchor].value.data());
+            anchorRotation.Normalize();
+        }
+        else
+        {
+            anchorValue = keys[anchor].value;
+        }
+        minSlope.fill(-std::numeric_limits<float32>::max());
+        maxSlope.fill(std::numeric_limits<float32>::max());
+    };
+
+    uint32 keysCount = uint32(keys.size());
+    uint32 anchor = 0;
+    setAnchor(anchor);
+    for (uint32 candidate = 1; candidate < keysCount; ++candidate)
+    {
+        float32 offset[AnimationChannel::MAX_DIMENSION];
+        getOffset(candidate, offset);
+        float32 duration = keys[candidate].time - keys[anchor].time;
+        DVASSERT(duration > 0.f, "Keys should have different times");
+
+        bool fits = true;
+        for (uint32 d = 0; d < components && fits; ++d)
+        {
+            float32 slope = offset[d] / duration;
+            fits = (slope >= minSlope[d] && slope <= maxSlope[d]);
+        }
+
+        if (!fits)
+        {
+            anchor = candidate - 1;
+            selected.push_back(anchor);
+            setAnchor(anchor);
+            getOffset(candidate, offset);
+            duration = keys[candidate].time - keys[anchor].time;
+        }
+
+        //candidate becomes skipped key for next candidates
+        for (uint32 d = 0; d < components; ++d)
+        {
+            minSlope[d] = Max(minSlope[d], (offset[d] - componentError) / duration);
+            maxSlope[d] = Min(maxSlope[d], (offset[d] + componentError) / duration);
+        }
+    }
+
+    if (keysCount > 1)
+    {
+        selected.push_back(keysCount - 1);
+    }
+
+    //constant channel is stored as single key
+    if (selected.size() == 2)
+    {
+        bool isConstant = true;
+        for (uint32 k = 1; k < keysCount && isConstant; ++k)
+            isConstant = AnimationChannelEncoder::GetError(keys[0].value.data(), keys[k].value.data(), dimension, interpolation) <= maxError;
+
+        if (isConstant)
+            selected.pop_back();
+    }
+
+    return selected;
+}
+
+void WriteSmallestThree(Vector<uint8>& data, const float32* value)
+{
+    using namespace AnimationChannelDetails;
+
+    Quaternion q(value);
+    q.Normalize();
+
+    uint32 largest = 0;
+    for (uint32 c = 1; c < 4; ++c)
+    {
+        if (Abs(q.data[c]) > Abs(q.data[largest]))
+            largest = c;
+    }
+
+    //q and -q are the same rotation, so dropped component is always positive
+    float32 sign = (q.data[largest] < 0.f) ? -1.f : 1.f;
+
+    uint16 quantized[3];
+    for (uint32 c = 0, i = 0; c < 4; ++c)
+    {
+        if (c != largest)
+            quantized[i++] = Quantize(sign * q.data[c], -SMALLEST_THREE_RANGE, 2.f * SMALLEST_THREE_RANGE, SMALLEST_THREE_MAX);
+    }
+    quantized[0] |= uint16((largest >> 1) << 15);
+    quantized[1] |= uint16((largest & 1) << 15);
+
+    for (uint16 component : quantized)
+        Write(data, component);
+}
+
+void WriteChannel(const Vector<AnimationChannelEncoder::Key>& keys, const Vector<uint32>& selected, uint32 dimension, AnimationChannel::eInterpolation interpolation, AnimationChannel::eCompression compression, Vector<uint8>& outData)
+{
+    using namespace AnimationChannelDetails;
+
+    size_t channelStart = outData.size();
+    uint32 keysCount = uint32(selected.size());
+    Write(outData, uint32(AnimationChannel::ANIMATION_CHANNEL_DATA_SIGNATURE));
+    Write(outData, uint8(dimension));
+    Write(outData, uint8(interpolation));
+    Write(outData, uint16(compression));
+    Write(outData, keysCount);
+
+    float32 timeStart = keys[selected.front()].time;
+    float32 timeExtent = keys[selected.back()].time - timeStart;
+    if (compression != AnimationChannel::COMPRESSION_NONE)
+    {
+        Write(outData, timeStart);
+        Write(outData, timeExtent);
+    }
+
+    Array<float32, AnimationChannel::MAX_DIMENSION> valueStart;
+    Array<float32, AnimationChannel::MAX_DIMENSION> valueExtent;
+    if (compression == AnimationChannel::COMPRESSION_QUANTIZED)
+    {
+        for (uint32 d = 0; d < dimension; ++d)
+        {
+            float32 minValue = keys[selected.front()].value[d];
+            float32 maxValue = minValue;
+            for (uint32 k : selected)
+            {
+                minValue = Min(minValue, keys[k].value[d]);
+                maxValue = Max(maxValue, keys[k].value[d]);
+            }
+            valueStart[d] = minValue;
+            valueExtent[d] = maxValue - minValue;
+        }
+
+        for (uint32 d = 0; d < dimension; ++d)
+            Write(outData, valueStart[d]);
+        for (uint32 d = 0; d < dimension; ++d)
+            Write(outData, valueExtent[d]);
+    }
+
+    uint32 prevTime = 0;
+    for (uint32 i = 0; i < keysCount; ++i)
+    {
+        const AnimationChannelEncoder::Key& key = keys[selected[i]];
+        if (compression == AnimationChannel::COMPRESSION_NONE)
+        {
+            Write(outData, key.time);
+            for (uint32 d = 0; d < dimension; ++d)
+                Write(outData, key.value[d]);
+        }
+        else
+        {
+            //keys with close times may be quantized to the same time, so they are moved apart
+            uint32 time = Quantize(key.time, timeStart, timeExtent, QUANTIZED_MAX);
+            if (i > 0)
+                time = Min(Max(time, prevTime + 1), QUANTIZED_MAX - (keysCount - 1 - i));
+            Write(outData, uint16(time));
+            prevTime = time;
+
+            if (compression == AnimationChannel::COMPRESSION_QUANTIZED)
+            {
+                for (uint32 d = 0; d < dimension; ++d)
+                    Write(outData, Quantize(key.value[d], valueStart[d], valueExtent[d], QUANTIZED_MAX));
+            }
+            else
+            {
+                WriteSmallestThree(outData, key.value.data());
+            }
+        }
+    }
+
+    if (compression != AnimationChannel::COMPRESSION_NONE)
+    {
+        while ((outData.size() - channelStart) & 0x3)
+            outData.push_back(0);
+    }
+}
+}
+
+AnimationChannelEncoder::Report AnimationChannelEncoder::Encode(const Vector<Key>& keys, uint32 dimension, AnimationChannel::eInterpolation interpolation, AnimationChannel::eCompression compression, float32 maxError, Vector<uint8>& outData)
+{
+    using namespace AnimationChannelEncoderDetails;
+    using namespace AnimationChannelDetails;
+
+    DVASSERT(!keys.empty());
+    DVASSERT(dimension > 0 && dimension <= AnimationChannel::MAX_DIMENSION);
+    DVASSERT(interpolation != AnimationChannel::INTERPOLATION_BEZIER, "Bezier not supported yet");
+    DVASSERT(compression != AnimationChannel::COMPRESSION_QUANTIZED || interpolation == AnimationChannel::INTERPOLATION_LINEAR);
+    DVASSERT(compression != AnimationChannel::COMPRESSION_SMALLEST_THREE || interpolation == AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR);
+
+    Report report;
+    report.sourceKeysCount = uint32(keys.size());
+    report.sourceDataSize = uint32(sizeof(uint32) * 3) + report.sourceKeysCount * uint32(sizeof(float32)) * (dimension + 1);
+
+    Vector<uint32> selected = SelectKeys(keys, dimension, interpolation, maxError);
+    Vector<bool> isSelected(keys.size(), false);
+    for (uint32 k : selected)
+        isSelected[k] = true;
+
+    /*
+        Quantization adds error to reduction error, so decoded channel is checked against `maxError`.
+        Segments are split at source keys exceeding it. If error remains at kept keys or splits don't converge,
+        quantization itself is too coarse for the channel and it is written uncompressed.
+    */
+    size_t channelStart = outData.size();
+    for (uint32 pass = 0;; ++pass)
+    {
+        if (selected.size() > QUANTIZED_MAX + 1)
+        {
+            //time can't be quantized without keys collision
+            compression = AnimationChannel::COMPRESSION_NONE;
+        }
+
+        outData.resize(channelStart);
+        WriteChannel(keys, selected, dimension, interpolation, compression, outData);
+
+        AnimationChannel channel;
+        uint32 boundSize = channel.Bind(outData.data() + channelStart);
+        DVASSERT(boundSize == outData.size() - channelStart);
+
+        report.maxError = 0.f;
+        Vector<uint32> splits;
+        bool keptKeysExceed = false;
+        AnimationChannel::Cursor cursor;
+        for (uint32 k = 0; k < report.sourceKeysCount; ++k)
+        {
+            float32 value[AnimationChannel::MAX_DIMENSION];
+            channel.Evaluate(keys[k].time, cursor, value, AnimationChannel::MAX_DIMENSION);
+            float32 error = GetError(value, keys[k].value.data(), dimension, interpolation);
+            report.maxError = Max(report.maxError, error);
+            if (error > maxError)
+            {
+                if (isSelected[k])
+                    keptKeysExceed = true;
+                else
+                    splits.push_back(k);
+            }
+        }
+
+        if (report.maxError <= maxError || (compression == AnimationChannel::COMPRESSION_NONE && splits.empty()))
+            break;
+
+        if (!keptKeysExceed && !splits.empty() && pass < MAX_SPLIT_PASSES)
+        {
+            for (uint32 k : splits)
+                isSelected[k] = true;
+
+            Vector<uint32> merged;
+            merged.reserve(selected.size() + splits.size());
+            std::merge(selected.begin(), selected.end(), splits.begin(), splits.end(), std::back_inserter(merged));
+            selected = std::move(merged);
+        }
+        else if (compression != AnimationChannel::COMPRESSION_NONE)
+        {
+            compression = AnimationChannel::COMPRESSION_NONE;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    report.compression = compression;
+    report.encodedKeysCount = uint32(selected.size());
+    report.encodedDataSize = uint32(outData.size() - channelStart);
+
+    return report;
+}
+
+float32 AnimationChannelEncoder::GetError(const float32* value0, const float32* value1, uint32 dimension, AnimationChannel::eInterpolation interpolation)
+{
+    if (interpolation == AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR)
+    {
+        Quaternion q0(value0);
+        Quaternion q1(value1);
+        q0.Normalize();
+        q1.Normalize();
+        return 2.f * std::acos(Min(Abs(q0.DotProduct(q1)), 1.f));
+    }
+
+    float32 error = 0.f;
+    for (uint32 d = 0; d < dimension; ++d)
+        error = Max(error, Abs(value0[d] - value1[d]));
+    return error;
+}
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Animation/AnimationChannel.h"
+#include "Base/BaseTypes.h"
+
+namespace DAVA
+{
+/**
+    Writer of animation channel data in format described in 'AnimationBinaryFormat.md'.
+    Keys, which can be interpolated from neighbour keys with error less than `maxError`, are removed.
+    Remained keys are written with requested compression. Decoded channel is checked against `maxError`:
+    keys exceeding it are kept, and channel is written uncompressed if quantization alone exceeds it.
+    Error is measured as absolute difference of components for linear channels, and as angle in radians for spherical channels.
+*/
+class AnimationChannelEncoder
+{
+public:
+    struct Key
+    {
+        float32 time = 0.f;
+        Array<float32, AnimationChannel::MAX_DIMENSION> value;
+    };
+
+    struct Report
+    {
+        uint32 sourceKeysCount = 0;
+        uint32 encodedKeysCount = 0;
+        uint32 sourceDataSize = 0; //size of uncompressed channel with all keys
+        uint32 encodedDataSize = 0;
+        float32 maxError = 0.f; //max error of decoded channel at times of source keys
+        AnimationChannel::eCompression compression = AnimationChannel::COMPRESSION_NONE; //compression actually written
+    };
+
+    /** Append channel data to `outData`. Keys should be sorted by time. */
+    static Report Encode(const Vector<Key>& keys, uint32 dimension, AnimationChannel::eInterpolation interpolation, AnimationChannel::eCompression compression, float32 maxError, Vector<uint8>& outData);
+
+    /** Error between two values of channel. */
+    static float32 GetError(const float32* value0, const float32* value1, uint32 dimension, AnimationChannel::eInterpolation interpolation);
+};
+}
@@ -0,0 +1,132 @@
+#include "Animation/AnimationKernels.h"
+
+#include "Base/BaseMath.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define DAVA_ANIMATION_SSE
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define DAVA_ANIMATION_NEON
+#include <arm_neon.h>
+#endif
+
+namespace DAVA
+{
+namespace AnimationKernelsDetails
+{
+// Same as weights computation of Quaternion::Slerp for non-negative `cosom`
+void GetSlerpScales(float32 cosom, float32 t, float32& scale0, float32& scale1)
+{
+    if ((1.0f - cosom) > 0.05f)
+    {
+        float32 omega = std::acos(cosom);
+        float32 sinom = std::sin(omega);
+        scale0 = std::sin((1.0f - t) * omega) / sinom;
+        scale1 = std::sin(t * omega) / sinom;
+    }
+    else
+    {
+        scale0 = 1.0f - t;
+        scale1 = t;
+    }
+}
+}
+
+namespace AnimationKernels
+{
+void Lerp(float32* result, const float32* values0, const float32* values1, const float32* factors, uint32 count)
+{
+    uint32 i = 0;
+
+// multiply and add separately to get the same rounding as scalar code
+#if defined(DAVA_ANIMATION_SSE)
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 v0 = _mm_loadu_ps(values0 + i);
+        __m128 delta = _mm_sub_ps(_mm_loadu_ps(values1 + i), v0);
+        _mm_storeu_ps(result + i, _mm_add_ps(v0, _mm_mul_ps(_mm_loadu_ps(factors + i), delta)));
+    }
+#elif defined(DAVA_ANIMATION_NEON)
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4_t v0 = vld1q_f32(values0 + i);
+        float32x4_t delta = vsubq_f32(vld1q_f32(values1 + i), v0);
+        vst1q_f32(result + i, vaddq_f32(v0, vmulq_f32(vld1q_f32(factors + i), delta)));
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        result[i] = DAVA::Lerp(values0[i], values1[i], factors[i]);
+    }
+}
+
+void Slerp(const QuaternionArrays& result, const QuaternionArrays& q0, const QuaternionArrays& q1, const float32* factors, uint32 count)
+{
+    using namespace AnimationKernelsDetails;
+
+    uint32 i = 0;
+
+#if defined(DAVA_ANIMATION_SSE)
+    // only weights are computed per quaternion, trigonometry has no SSE instructions
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    alignas(16) float32 cosoms[4];
+    alignas(16) float32 scales0[4];
+    alignas(16) float32 scales1[4];
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x0 = _mm_loadu_ps(q0.x + i);
+        __m128 y0 = _mm_loadu_ps(q0.y + i);
+        __m128 z0 = _mm_loadu_ps(q0.z + i);
+        __m128 w0 = _mm_loadu_ps(q0.w + i);
+        __m128 x1 = _mm_loadu_ps(q1.x + i);
+        __m128 y1 = _mm_loadu_ps(q1.y + i);
+        __m128 z1 = _mm_loadu_ps(q1.z + i);
+        __m128 w1 = _mm_loadu_ps(q1.w + i);
+
+        __m128 cosom = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x0, x1), _mm_mul_ps(y0, y1)), _mm_mul_ps(z0, z1)), _mm_mul_ps(w0, w1));
+
+        // take shortest arc: negate second quaternion if angle between quaternions is obtuse
+        __m128 negate = _mm_and_ps(_mm_cmplt_ps(cosom, _mm_setzero_ps()), signMask);
+        x1 = _mm_xor_ps(x1, negate);
+        y1 = _mm_xor_ps(y1, negate);
+        z1 = _mm_xor_ps(z1, negate);
+        w1 = _mm_xor_ps(w1, negate);
+        _mm_store_ps(cosoms, _mm_xor_ps(cosom, negate));
+
+        for (uint32 k = 0; k < 4; ++k)
+        {
+            GetSlerpScales(cosoms[k], factors[i + k], scales0[k], scales1[k]);
+        }
+        __m128 s0 = _mm_load_ps(scales0);
+        __m128 s1 = _mm_load_ps(scales1);
+
+        __m128 x = _mm_add_ps(_mm_mul_ps(s0, x0), _mm_mul_ps(s1, x1));
+        __m128 y = _mm_add_ps(_mm_mul_ps(s0, y0), _mm_mul_ps(s1, y1));
+        __m128 z = _mm_add_ps(_mm_mul_ps(s0, z0), _mm_mul_ps(s1, z1));
+        __m128 w = _mm_add_ps(_mm_mul_ps(s0, w0), _mm_mul_ps(s1, w1));
+
+        __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)), _mm_mul_ps(w, w)));
+        _mm_storeu_ps(result.x + i, _mm_div_ps(x, length));
+        _mm_storeu_ps(result.y + i, _mm_div_ps(y, length));
+        _mm_storeu_ps(result.z + i, _mm_div_ps(z, length));
+        _mm_storeu_ps(result.w + i, _mm_div_ps(w, length));
+    }
+#endif
+    // NEON has no precise division and square root, so scalar loop is used
+
+    for (; i < count; ++i)
+    {
+        Quaternion from(q0.x[i], q0.y[i], q0.z[i], q0.w[i]);
+        Quaternion q(q1.x[i], q1.y[i], q1.z[i], q1.w[i]);
+        q.Slerp(from, q, factors[i]);
+        q.Normalize();
+
+        result.x[i] = q.x;
+        result.y[i] = q.y;
+        result.z[i] = q.z;
+        result.w[i] = q.w;
+    }
+}
+}
+}
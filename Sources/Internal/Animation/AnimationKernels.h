@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+
+namespace DAVA
+{
+/**
+    Interpolation kernels for batches of animation channel values, vectorized with SSE or NEON when available.
+    Results are equal to results of scalar `Lerp` and `Quaternion::Slerp` used by AnimationChannel.
+    All kernels process elements in range [0, count).
+*/
+namespace AnimationKernels
+{
+/** Quaternions stored by components in separate arrays, quaternion `i` is (x[i], y[i], z[i], w[i]). */
+struct QuaternionArrays
+{
+    float32* x = nullptr;
+    float32* y = nullptr;
+    float32* z = nullptr;
+    float32* w = nullptr;
+};
+
+/** result[i] = Lerp(values0[i], values1[i], factors[i]) */
+void Lerp(float32* result, const float32* values0, const float32* values1, const float32* factors, uint32 count);
+/** result[i] = normalized Slerp(q0[i], q1[i], factors[i]). `result` may be the same as `q0` or `q1`. */
+void Slerp(const QuaternionArrays& result, const QuaternionArrays& q0, const QuaternionArrays& q1, const float32* factors, uint32 count);
+}
+}
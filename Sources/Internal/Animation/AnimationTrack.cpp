@@ -47,6 +47,12 @@ void AnimationTrack::Evaluate(float32 time, uint32 channel, float32* outData, ui
     channels[channel].channel.Evaluate(time, outData, dataSize);
 }
 
+void AnimationTrack::Evaluate(float32 time, uint32 channel, AnimationChannel::Cursor& cursor, float32* outData, uint32 dataSize) const
+{
+    DVASSERT(channel < GetChannelsCount());
+    channels[channel].channel.Evaluate(time, cursor, outData, dataSize);
+}
+
 uint32 AnimationTrack::GetChannelsCount() const
 {
     return uint32(channels.size());
@@ -58,6 +64,12 @@ AnimationTrack::eChannelTarget AnimationTrack::GetChannelTarget(uint32 channel)
     return channels[channel].target;
 }
 
+const AnimationChannel& AnimationTrack::GetChannel(uint32 channel) const
+{
+    DVASSERT(channel < GetChannelsCount());
+    return channels[channel].channel;
+}
+
 uint32 AnimationTrack::GetChannelValueSize(uint32 channel) const
 {
     DVASSERT(channel < GetChannelsCount());
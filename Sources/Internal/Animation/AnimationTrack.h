@@ -20,9 +20,11 @@ public:
 
     uint32 Bind(const uint8* data);
     void Evaluate(float32 time, uint32 channel, float32* outData, uint32 dataSize) const;
+    void Evaluate(float32 time, uint32 channel, AnimationChannel::Cursor& cursor, float32* outData, uint32 dataSize) const;
 
     uint32 GetChannelsCount() const;
     eChannelTarget GetChannelTarget(uint32 channel) const;
+    const AnimationChannel& GetChannel(uint32 channel) const;
 
     uint32 GetChannelValueSize(uint32 channel) const;
     uint32 GetMaxChannelValueSize() const;
@@ -0,0 +1,107 @@
+#include "Base/Radix/RadixSort64.h"
+
+#include <cstring>
+
+namespace DAVA
+{
+namespace RadixSort64Details
+{
+const uint32 BYTES_COUNT = 8;
+const uint32 DIGITS_COUNT = 256;
+const uint32 INSERTION_SORT_MAX_COUNT = 32;
+
+// Insertion sort which gives up after `maxMoves` moves of items, items remain permuted stably in that case
+bool InsertionSort(RadixSortItem64* items, uint32 count, uint32 maxMoves)
+{
+    uint32 moves = 0;
+    for (uint32 i = 1; i < count; ++i)
+    {
+        RadixSortItem64 item = items[i];
+        uint32 j = i;
+        while (j > 0 && items[j - 1].key > item.key)
+        {
+            if (++moves > maxMoves)
+            {
+                items[j] = item;
+                return false;
+            }
+
+            items[j] = items[j - 1];
+            --j;
+        }
+        items[j] = item;
+    }
+    return true;
+}
+}
+
+void RadixSort64(RadixSortItem64* items, RadixSortItem64* buffer, uint32 count)
+{
+    using namespace RadixSort64Details;
+
+    uint32 descents = 0;
+    for (uint32 i = 1; i < count; ++i)
+    {
+        descents += (items[i - 1].key > items[i].key) ? 1 : 0;
+    }
+
+    if (descents == 0)
+    {
+        return;
+    }
+
+    // Each descent needs at least one move, so a few descents don't mean few moves,
+    // budget of moves keeps the worst case linear before falling back to radix sort
+    if (count <= INSERTION_SORT_MAX_COUNT || descents <= count / INSERTION_SORT_MAX_COUNT)
+    {
+        uint32 maxMoves = (count <= INSERTION_SORT_MAX_COUNT) ? count * count : count * 4;
+        if (InsertionSort(items, count, maxMoves))
+        {
+            return;
+        }
+    }
+
+    uint32 histograms[BYTES_COUNT][DIGITS_COUNT];
+    std::memset(histograms, 0, sizeof(histograms));
+    for (uint32 i = 0; i < count; ++i)
+    {
+        uint64 key = items[i].key;
+        for (uint32 b = 0; b < BYTES_COUNT; ++b)
+        {
+            ++histograms[b][(key >> (b * 8)) & 0xFF];
+        }
+    }
+
+    RadixSortItem64* source = items;
+    RadixSortItem64* destination = buffer;
+    for (uint32 b = 0; b < BYTES_COUNT; ++b)
+    {
+        uint32* histogram = histograms[b];
+        uint32 shift = b * 8;
+        if (histogram[(source[0].key >> shift) & 0xFF] == count)
+        {
+            continue;
+        }
+
+        uint32 offset = 0;
+        for (uint32 d = 0; d < DIGITS_COUNT; ++d)
+        {
+            uint32 digitCount = histogram[d];
+            histogram[d] = offset;
+            offset += digitCount;
+        }
+
+        for (uint32 i = 0; i < count; ++i)
+        {
+            destination[histogram[(source[i].key >> shift) & 0xFF]++] = source[i];
+        }
+
+        std::swap(source, destination);
+    }
+
+    if (source != items)
+    {
+        std::memcpy(items, source, count * sizeof(RadixSortItem64));
+    }
+}
+}
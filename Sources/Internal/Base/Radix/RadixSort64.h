@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+
+namespace DAVA
+{
+/** Pair of 64-bit sorting key and index of sorted object. */
+struct RadixSortItem64
+{
+    uint64 key;
+    uint32 index;
+};
+
+/**
+    Stable sort of `count` items by key in ascending order.
+    LSD radix sort by bytes of key: histograms of all bytes are built in one pass,
+    and passes over bytes which are the same for all keys are skipped.
+    Already sorted items are detected in one pass, nearly sorted ones are finished by insertion sort.
+    `buffer` should have space for at least `count` items, result is placed into `items`.
+*/
+void RadixSort64(RadixSortItem64* items, RadixSortItem64* buffer, uint32 count);
+}
@@ -13,6 +13,7 @@ public:
         Lz4,
         Lz4HC,
         RFC1951, // deflate, inflate
+        Zstd,
     };
 
     virtual ~Compressor();
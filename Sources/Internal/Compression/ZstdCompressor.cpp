@@ -0,0 +1,122 @@
+#include "Compression/ZstdCompressor.h"
+#include "Logger/Logger.h"
+
+#include <zstd/zstd.h>
+#include <zstd/zdict.h>
+
+namespace DAVA
+{
+ZstdCompressor::ZstdCompressor(int32 compressionLevel_)
+    : compressionLevel(compressionLevel_)
+{
+}
+
+ZstdCompressor::ZstdCompressor(const Vector<uint8>& dictionary, int32 compressionLevel_)
+    : compressionLevel(compressionLevel_)
+{
+    if (!dictionary.empty())
+    {
+        compressionDictionary = ZSTD_createCDict(dictionary.data(), dictionary.size(), compressionLevel);
+        decompressionDictionary = ZSTD_createDDict(dictionary.data(), dictionary.size());
+        if (compressionDictionary == nullptr || decompressionDictionary == nullptr)
+        {
+            Logger::Error("Zstd can't create dictionary");
+        }
+    }
+}
+
+ZstdCompressor::~ZstdCompressor()
+{
+    ZSTD_freeCDict(compressionDictionary);
+    ZSTD_freeDDict(decompressionDictionary);
+}
+
+bool ZstdCompressor::Compress(const Vector<uint8>& in, Vector<uint8>& out) const
+{
+    size_t maxSize = ZSTD_compressBound(in.size());
+    if (out.size() < maxSize)
+    {
+        out.resize(maxSize);
+    }
+
+    size_t compressedSize = 0;
+    if (compressionDictionary != nullptr)
+    {
+        // context is created per call, so one compressor can be used from several threads
+        ZSTD_CCtx* context = ZSTD_createCCtx();
+        compressedSize = ZSTD_compress_usingCDict(context, out.data(), out.size(), in.data(), in.size(), compressionDictionary);
+        ZSTD_freeCCtx(context);
+    }
+    else
+    {
+        compressedSize = ZSTD_compress(out.data(), out.size(), in.data(), in.size(), compressionLevel);
+    }
+
+    if (ZSTD_isError(compressedSize))
+    {
+        Logger::Error("Zstd compress failed: %s", ZSTD_getErrorName(compressedSize));
+        return false;
+    }
+    out.resize(compressedSize);
+    return true;
+}
+
+bool ZstdCompressor::Decompress(const Vector<uint8>& in, Vector<uint8>& out) const
+{
+    size_t decompressedSize = 0;
+    if (decompressionDictionary != nullptr)
+    {
+        ZSTD_DCtx* context = ZSTD_createDCtx();
+        decompressedSize = ZSTD_decompress_usingDDict(context, out.data(), out.size(), in.data(), in.size(), decompressionDictionary);
+        ZSTD_freeDCtx(context);
+    }
+    else
+    {
+        decompressedSize = ZSTD_decompress(out.data(), out.size(), in.data(), in.size());
+    }
+
+    if (ZSTD_isError(decompressedSize))
+    {
+        Logger::Error("Zstd decompress failed: %s", ZSTD_getErrorName(decompressedSize));
+        return false;
+    }
+    if (decompressedSize != out.size())
+    {
+        Logger::Error("Zstd decompress failed: size of content %u doesn't match expected %u", static_cast<uint32>(decompressedSize), static_cast<uint32>(out.size()));
+        return false;
+    }
+    return true;
+}
+
+Vector<uint8> ZstdCompressor::TrainDictionary(const Vector<Vector<uint8>>& samples, uint32 dictionaryCapacity)
+{
+    // zdict expects samples concatenated in one buffer
+    Vector<uint8> samplesBuffer;
+    Vector<size_t> samplesSizes;
+    samplesSizes.reserve(samples.size());
+    for (const Vector<uint8>& sample : samples)
+    {
+        if (!sample.empty())
+        {
+            samplesBuffer.insert(samplesBuffer.end(), sample.begin(), sample.end());
+            samplesSizes.push_back(sample.size());
+        }
+    }
+
+    if (samplesSizes.empty())
+    {
+        return Vector<uint8>();
+    }
+
+    Vector<uint8> dictionary(dictionaryCapacity);
+    size_t dictionarySize = ZDICT_trainFromBuffer(dictionary.data(), dictionary.size(), samplesBuffer.data(), samplesSizes.data(), static_cast<unsigned>(samplesSizes.size()));
+    if (ZDICT_isError(dictionarySize))
+    {
+        Logger::Warning("Zstd dictionary training failed: %s", ZDICT_getErrorName(dictionarySize));
+        return Vector<uint8>();
+    }
+    dictionary.resize(dictionarySize);
+    return dictionary;
+}
+
+} // end namespace DAVA
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Compression/Compressor.h"
+
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
+namespace DAVA
+{
+/**
+    Zstandard compressor.
+    Optional dictionary trained on typical content (see TrainDictionary) noticeably improves ratio
+    and speed for small files. Content compressed with dictionary can be decompressed only with the same one.
+    Compress and Decompress can be called from several threads at once.
+*/
+class ZstdCompressor : public Compressor
+{
+public:
+    static const int32 DEFAULT_COMPRESSION_LEVEL = 12;
+    static const uint32 DEFAULT_DICTIONARY_CAPACITY = 112 * 1024;
+
+    explicit ZstdCompressor(int32 compressionLevel = DEFAULT_COMPRESSION_LEVEL);
+    explicit ZstdCompressor(const Vector<uint8>& dictionary, int32 compressionLevel = DEFAULT_COMPRESSION_LEVEL);
+    ~ZstdCompressor() override;
+
+    bool Compress(const Vector<uint8>& in, Vector<uint8>& out) const override;
+    // you should resize output to correct size before call this method
+    bool Decompress(const Vector<uint8>& in, Vector<uint8>& out) const override;
+
+    bool HasDictionary() const;
+
+    /**
+        Train dictionary on `samples`, return empty vector if there are not enough samples or training failed.
+        Samples should be whole files of the kind that will be compressed later.
+    */
+    static Vector<uint8> TrainDictionary(const Vector<Vector<uint8>>& samples, uint32 dictionaryCapacity = DEFAULT_DICTIONARY_CAPACITY);
+
+private:
+    ZstdCompressor(const ZstdCompressor&) = delete;
+    ZstdCompressor& operator=(const ZstdCompressor&) = delete;
+
+    int32 compressionLevel = DEFAULT_COMPRESSION_LEVEL;
+    ZSTD_CDict_s* compressionDictionary = nullptr;
+    ZSTD_DDict_s* decompressionDictionary = nullptr;
+};
+
+inline bool ZstdCompressor::HasDictionary() const
+{
+    return decompressionDictionary != nullptr;
+}
+
+} // end namespace DAVA
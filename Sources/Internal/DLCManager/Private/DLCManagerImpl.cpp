@@ -1149,6 +1149,15 @@ bool DLCManagerImpl::ReadContentAndExtractFileNames()
         return false;
     }
 
+    // downloaded files are stored as dvpl with compressed content of superpack
+    for (const PackFormat::FileTableEntry& fileEntry : usedPackFile.filesTable.data.files)
+    {
+        if (!PackFormat::LitePack::IsCompressionTypeSupported(fileEntry.type))
+        {
+            DAVA_THROW(Exception, "on server bad superpack!!! dvpl can't be loaded with compression type " + std::to_string(static_cast<int32>(fileEntry.type)));
+        }
+    }
+
     FillFileNameIndexes();
 
     initState = InitState::CalculateLocalDBHashAndCompare;
@@ -506,6 +506,7 @@ bool PackRequest::UpdateFileRequests()
 bool PackRequest::DVPLWriter::OpenFile()
 {
     DVASSERT(!fout.is_open());
+    DVASSERT(PackFormat::LitePack::IsCompressionTypeSupported(compressionType), "dvpl with this compression type can't be loaded");
     // create intermediate directories
     FileSystem* fs = GetEngineContext()->fileSystem;
 
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Debug/DebugOverlayItem.h"
+
+namespace DAVA
+{
+class Scene;
+
+/**
+    Shows how scene systems were processed in the last frame: processing time, time of serial processing
+    and the critical path, i.e. the longest chain of dependent systems (see SceneSystemScheduler).
+    Item isn't registered in `DebugOverlay` by default, application registers it for its scene.
+    Scene should outlive the item or be reset with `SetScene(nullptr)`.
+*/
+class DebugOverlayItemSceneSystems final : public DebugOverlayItem
+{
+public:
+    DebugOverlayItemSceneSystems(Scene* scene_ = nullptr);
+    ~DebugOverlayItemSceneSystems() = default;
+
+    void SetScene(Scene* scene_);
+
+    String GetName() const override;
+    void Draw() override;
+
+private:
+    void AddTimeStat(const char* name, int64 value);
+
+    Scene* scene = nullptr;
+};
+}
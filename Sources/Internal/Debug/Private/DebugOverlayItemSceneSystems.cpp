@@ -0,0 +1,92 @@
+#include "Debug/DebugOverlayItemSceneSystems.h"
+#include "Debug/Backtrace.h"
+#include "Debug/DebugOverlay.h"
+#include "Debug/Private/ImGui.h"
+#include "Engine/Engine.h"
+#include "Entity/SceneSystem.h"
+#include "Scene3D/Scene.h"
+#include "Scene3D/SceneSystemScheduler.h"
+
+#include <typeinfo>
+
+namespace DAVA
+{
+namespace DebugOverlayItemSceneSystemsDetails
+{
+String GetSystemName(SceneSystem* system)
+{
+    const char* typeName = typeid(*system).name();
+    String name = Debug::DemangleFrameSymbol(typeName);
+    return name.empty() ? String(typeName) : name;
+}
+}
+
+DebugOverlayItemSceneSystems::DebugOverlayItemSceneSystems(Scene* scene_)
+    : scene(scene_)
+{
+}
+
+void DebugOverlayItemSceneSystems::SetScene(Scene* scene_)
+{
+    scene = scene_;
+}
+
+String DebugOverlayItemSceneSystems::GetName() const
+{
+    return "Scene systems";
+}
+
+void DebugOverlayItemSceneSystems::Draw()
+{
+    using namespace DebugOverlayItemSceneSystemsDetails;
+
+    bool shown = true;
+    ImGui::SetNextWindowSizeConstraints(ImVec2(300.0f, 200.0f), ImVec2(FLOAT_MAX, FLOAT_MAX));
+
+    if (ImGui::Begin("SceneSystemsWindow", &shown, ImGuiWindowFlags_NoFocusOnAppearing))
+    {
+        if (scene != nullptr)
+        {
+            SceneSystemScheduler* scheduler = scene->GetSystemScheduler();
+
+            bool parallelProcessing = scheduler->IsParallelProcessingEnabled();
+            if (ImGui::Checkbox("Parallel processing", &parallelProcessing))
+            {
+                scheduler->SetParallelProcessingEnabled(parallelProcessing);
+            }
+
+            const SceneSystemScheduler::FrameStatistics& statistics = scheduler->GetLastFrameStatistics();
+            AddTimeStat("Processing time", statistics.processTime);
+            AddTimeStat("Serial processing time", statistics.systemsTime);
+            AddTimeStat("Critical path time", statistics.criticalPathTime);
+
+            if (ImGui::CollapsingHeader("Critical path", ImGuiTreeNodeFlags_DefaultOpen))
+            {
+                for (const std::pair<SceneSystem*, int64>& system : statistics.criticalPath)
+                {
+                    AddTimeStat(GetSystemName(system.first).c_str(), system.second);
+                }
+            }
+        }
+        else
+        {
+            ImGui::Text("Scene is not set");
+        }
+    }
+
+    ImGui::End();
+
+    if (!shown)
+    {
+        GetEngineContext()->debugOverlay->HideItem(this);
+    }
+}
+
+void DebugOverlayItemSceneSystems::AddTimeStat(const char* name, int64 value)
+{
+    String valuestr = Format("%lld us", value);
+    ImGui::TextUnformatted(name);
+    ImGui::SameLine(ImGui::GetWindowContentRegionMax().x - ImGui::CalcTextSize(valuestr.c_str()).x);
+    ImGui::TextUnformatted(valuestr.c_str());
+}
+}
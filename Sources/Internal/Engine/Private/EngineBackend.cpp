@@ -809,7 +809,11 @@ void EngineBackend::InitRenderer(Window* w)
 
     w->InitCustomRenderParams(rendererParams);
 
-    rhi::ShaderSourceCache::Load("~doc:/ShaderSource.bin");
+    // cache saved by application on previous run is used if present, otherwise cache precompiled by ResourceEditor '-shadercache' tool
+    if (context->fileSystem->IsFile("~doc:/ShaderSource.bin"))
+        rhi::ShaderSourceCache::Load("~doc:/ShaderSource.bin");
+    else
+        rhi::ShaderSourceCache::Load("~res:/ShaderSource.bin");
     Renderer::Initialize(renderer, rendererParams);
     context->renderSystem2D->Init();
 
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+#include "Base/UnordererMap.h"
+#include "Base/Vector.h"
+
+namespace DAVA
+{
+class Component;
+class Entity;
+
+/**
+    Groups scene entities into archetypes by signature of their `EntityFamily` (mask of component types).
+    Archetype keeps, for each component type, an array of pointers to components of its entities, parallel to array of entities.
+    Components themselves are still owned and allocated by entities, so query doesn't look up components of each entity,
+    but still dereferences a pointer per component.
+
+    Storage is owned by system, which queries several components of its entities every frame: system adds and removes entities
+    in `AddEntity` and `RemoveEntity`, marks them changed in `RegisterComponent` and `UnregisterComponent`.
+    Changes of entity components are applied before the next query or by `ApplyChanges`.
+    For entities with several components of the same type only the first one is stored.
+
+    Example (see SpeedTreeUpdateSystem):
+    \code
+    void MySystem::AddEntity(Entity* entity)
+    {
+        storage.AddEntity(entity);
+    }
+    ...
+    void MySystem::Process(float32 timeElapsed)
+    {
+        storage.ForEach<TransformComponent, RenderComponent>([](Entity* entity, TransformComponent* transform, RenderComponent* render) {
+            ...
+        });
+    }
+    \endcode
+*/
+class ArchetypeStorage
+{
+public:
+    /** Entities with the same mask of component types and their components. */
+    class Archetype
+    {
+    public:
+        const ComponentMask& GetComponentsMask() const;
+        uint32 GetEntitiesCount() const;
+        Entity* const* GetEntities() const;
+
+        /** Return components of type with `runtimeId` in order of entities, nullptr if archetype has no such components. */
+        Component* const* GetComponents(uint32 runtimeId) const;
+
+    private:
+        friend class ArchetypeStorage;
+
+        ComponentMask componentsMask;
+        Vector<Entity*> entities;
+        Vector<Vector<Component*>> components; ///< Indexed by runtime id of component type.
+    };
+
+    ArchetypeStorage() = default;
+    ArchetypeStorage(const ArchetypeStorage&) = delete;
+    ArchetypeStorage& operator=(const ArchetypeStorage&) = delete;
+
+    void AddEntity(Entity* entity);
+    void RemoveEntity(Entity* entity);
+
+    /** Mark that components of `entity` are changed, entity is moved to archetype of its new family before the next query. */
+    void MarkEntityChanged(Entity* entity);
+    /** Move changed entities to archetypes of their current families. */
+    void ApplyChanges();
+    /** Remove all entities, archetypes are kept. */
+    void Clear();
+
+    /** Call `fn(Entity*, T*...)` for each entity having components of all types `T`. */
+    template <typename... T, typename Fn>
+    void ForEach(Fn&& fn);
+
+    /** Call `fn(const Archetype&)` for each non-empty archetype having components of all types `T`. */
+    template <typename... T, typename Fn>
+    void ForEachArchetype(Fn&& fn);
+
+    uint32 GetArchetypesCount() const;
+    uint32 GetEntitiesCount() const;
+    uint32 GetChangedEntitiesCount() const;
+
+private:
+    struct EntityLocation
+    {
+        Archetype* archetype = nullptr;
+        uint32 index = 0;
+        bool changed = false; ///< Entity is in `changedEntities`.
+    };
+
+    void Insert(Entity* entity);
+    void Erase(const EntityLocation& location);
+    Archetype* GetOrCreateArchetype(const ComponentMask& componentsMask);
+
+    Vector<std::unique_ptr<Archetype>> archetypes;
+    UnorderedMap<ComponentMask, Archetype*> archetypesByMask;
+    UnorderedMap<Entity*, EntityLocation> locations;
+    Vector<Entity*> changedEntities;
+};
+
+inline const ComponentMask& ArchetypeStorage::Archetype::GetComponentsMask() const
+{
+    return componentsMask;
+}
+
+inline uint32 ArchetypeStorage::Archetype::GetEntitiesCount() const
+{
+    return static_cast<uint32>(entities.size());
+}
+
+inline Entity* const* ArchetypeStorage::Archetype::GetEntities() const
+{
+    return entities.data();
+}
+
+inline Component* const* ArchetypeStorage::Archetype::GetComponents(uint32 runtimeId) const
+{
+    return (runtimeId < components.size() && componentsMask.test(runtimeId)) ? components[runtimeId].data() : nullptr;
+}
+
+inline uint32 ArchetypeStorage::GetArchetypesCount() const
+{
+    return static_cast<uint32>(archetypes.size());
+}
+
+inline uint32 ArchetypeStorage::GetEntitiesCount() const
+{
+    return static_cast<uint32>(locations.size());
+}
+
+inline uint32 ArchetypeStorage::GetChangedEntitiesCount() const
+{
+    return static_cast<uint32>(changedEntities.size());
+}
+}
+
+#include "Entity/Private/ArchetypeStorage_impl.h"
@@ -0,0 +1,161 @@
+#include "Entity/ArchetypeStorage.h"
+#include "Entity/ComponentUtils.h"
+#include "Scene3D/Entity.h"
+#include "Scene3D/EntityFamily.h"
+#include "Debug/DVAssert.h"
+
+namespace DAVA
+{
+void ArchetypeStorage::AddEntity(Entity* entity)
+{
+    DVASSERT(entity != nullptr);
+    DVASSERT(locations.find(entity) == locations.end());
+
+    Insert(entity);
+}
+
+void ArchetypeStorage::RemoveEntity(Entity* entity)
+{
+    auto iter = locations.find(entity);
+    if (iter != locations.end())
+    {
+        if (iter->second.changed)
+        {
+            auto changedIter = std::find(changedEntities.begin(), changedEntities.end(), entity);
+            DVASSERT(changedIter != changedEntities.end());
+            *changedIter = changedEntities.back();
+            changedEntities.pop_back();
+        }
+
+        Erase(iter->second);
+        locations.erase(iter);
+    }
+}
+
+void ArchetypeStorage::MarkEntityChanged(Entity* entity)
+{
+    // entities not in storage yet are inserted with their current family, so only stored ones are queued, each once
+    auto iter = locations.find(entity);
+    if (iter != locations.end() && !iter->second.changed)
+    {
+        iter->second.changed = true;
+        changedEntities.push_back(entity);
+    }
+}
+
+void ArchetypeStorage::ApplyChanges()
+{
+    for (Entity* entity : changedEntities)
+    {
+        auto iter = locations.find(entity);
+        DVASSERT(iter != locations.end() && iter->second.changed);
+        iter->second.changed = false;
+
+        Archetype* archetype = iter->second.archetype;
+        if (archetype->componentsMask != entity->GetFamily()->GetComponentsMask())
+        {
+            Erase(iter->second);
+            locations.erase(iter);
+            Insert(entity);
+        }
+        else
+        {
+            // same archetype, but components could be replaced
+            uint32 index = iter->second.index;
+            for (uint32 runtimeId = 0; runtimeId < archetype->components.size(); ++runtimeId)
+            {
+                if (archetype->componentsMask.test(runtimeId))
+                {
+                    archetype->components[runtimeId][index] = entity->GetComponent(ComponentUtils::GetType(runtimeId));
+                }
+            }
+        }
+    }
+    changedEntities.clear();
+}
+
+void ArchetypeStorage::Clear()
+{
+    for (const std::unique_ptr<Archetype>& archetype : archetypes)
+    {
+        archetype->entities.clear();
+        for (Vector<Component*>& components : archetype->components)
+        {
+            components.clear();
+        }
+    }
+    locations.clear();
+    changedEntities.clear();
+}
+
+void ArchetypeStorage::Insert(Entity* entity)
+{
+    Archetype* archetype = GetOrCreateArchetype(entity->GetFamily()->GetComponentsMask());
+
+    EntityLocation& location = locations[entity];
+    location.archetype = archetype;
+    location.index = static_cast<uint32>(archetype->entities.size());
+
+    archetype->entities.push_back(entity);
+    for (uint32 runtimeId = 0; runtimeId < archetype->components.size(); ++runtimeId)
+    {
+        if (archetype->componentsMask.test(runtimeId))
+        {
+            archetype->components[runtimeId].push_back(entity->GetComponent(ComponentUtils::GetType(runtimeId)));
+        }
+    }
+}
+
+void ArchetypeStorage::Erase(const EntityLocation& location)
+{
+    // entity is replaced with the last one to keep arrays contiguous
+    Archetype* archetype = location.archetype;
+    uint32 index = location.index;
+    uint32 lastIndex = static_cast<uint32>(archetype->entities.size()) - 1;
+
+    if (index != lastIndex)
+    {
+        Entity* lastEntity = archetype->entities[lastIndex];
+        archetype->entities[index] = lastEntity;
+        locations[lastEntity].index = index;
+    }
+    archetype->entities.pop_back();
+
+    for (uint32 runtimeId = 0; runtimeId < archetype->components.size(); ++runtimeId)
+    {
+        if (archetype->componentsMask.test(runtimeId))
+        {
+            Vector<Component*>& components = archetype->components[runtimeId];
+            components[index] = components[lastIndex];
+            components.pop_back();
+        }
+    }
+}
+
+ArchetypeStorage::Archetype* ArchetypeStorage::GetOrCreateArchetype(const ComponentMask& componentsMask)
+{
+    auto iter = archetypesByMask.find(componentsMask);
+    if (iter != archetypesByMask.end())
+    {
+        return iter->second;
+    }
+
+    // arrays are created only for types of archetype, but indexed by runtime id
+    uint32 componentsArraysCount = 0;
+    for (uint32 runtimeId = 0; runtimeId < componentsMask.size(); ++runtimeId)
+    {
+        if (componentsMask.test(runtimeId))
+        {
+            componentsArraysCount = runtimeId + 1;
+        }
+    }
+
+    Archetype* archetype = new Archetype();
+    archetype->componentsMask = componentsMask;
+    archetype->components.resize(componentsArraysCount);
+
+    archetypes.emplace_back(archetype);
+    archetypesByMask[componentsMask] = archetype;
+    return archetype;
+}
+}
@@ -0,0 +1,234 @@
+#include "UnitTests/UnitTests.h"
+
+#include "Base/ScopedPtr.h"
+#include "Entity/ArchetypeStorage.h"
+#include "Entity/SceneSystem.h"
+#include "Logger/Logger.h"
+#include "Scene3D/Components/RenderComponent.h"
+#include "Scene3D/Components/TransformComponent.h"
+#include "Scene3D/Components/WindComponent.h"
+#include "Scene3D/Entity.h"
+#include "Scene3D/Scene.h"
+#include "Time/SystemTimer.h"
+
+namespace ArchetypeStorageTestDetails
+{
+using namespace DAVA;
+
+const uint32 BENCHMARK_ENTITIES_COUNT = 100000;
+const uint32 BENCHMARK_ITERATIONS_COUNT = 20;
+
+// storage isn't kept by scene, system that queries entities owns it, any entity fits empty mask of required components
+class StorageSystem : public SceneSystem
+{
+public:
+    StorageSystem(Scene* scene)
+        : SceneSystem(scene)
+    {
+    }
+
+    void AddEntity(Entity* entity) override
+    {
+        storage.AddEntity(entity);
+    }
+
+    void RemoveEntity(Entity* entity) override
+    {
+        storage.RemoveEntity(entity);
+    }
+
+    void RegisterComponent(Entity* entity, Component* component) override
+    {
+        storage.MarkEntityChanged(entity);
+    }
+
+    void UnregisterComponent(Entity* entity, Component* component) override
+    {
+        storage.MarkEntityChanged(entity);
+    }
+
+    void Process(float32 timeElapsed) override
+    {
+        storage.ApplyChanges();
+    }
+
+    void PrepareForRemove() override
+    {
+    }
+
+    ArchetypeStorage storage;
+};
+
+ArchetypeStorage* CreateStorage(Scene* scene)
+{
+    StorageSystem* system = new StorageSystem(scene);
+    scene->AddSystem(system, ComponentMask(), Scene::SCENE_SYSTEM_REQUIRE_PROCESS);
+    return &system->storage;
+}
+
+// every second entity has render component, every third one has wind component
+Vector<Entity*> AddEntities(Scene* scene, uint32 count)
+{
+    Vector<Entity*> entities;
+    entities.reserve(count);
+    for (uint32 i = 0; i < count; ++i)
+    {
+        ScopedPtr<Entity> entity(new Entity());
+        entity->GetComponent<TransformComponent>()->SetLocalTranslation(Vector3(static_cast<float32>(i % 100), 0.0f, 0.0f));
+        if (i % 2 == 0)
+        {
+            entity->AddComponent(new RenderComponent());
+        }
+        if (i % 3 == 0)
+        {
+            entity->AddComponent(new WindComponent());
+        }
+
+        scene->AddNode(entity);
+        entities.push_back(entity);
+    }
+    return entities;
+}
+
+Set<Entity*> QueryRenderEntities(ArchetypeStorage* storage)
+{
+    Set<Entity*> result;
+    storage->ForEach<TransformComponent, RenderComponent>([&result](Entity* entity, TransformComponent* transform, RenderComponent* render) {
+        TEST_VERIFY(entity->GetComponent<TransformComponent>() == transform);
+        TEST_VERIFY(entity->GetComponent<RenderComponent>() == render);
+        result.insert(entity);
+    });
+    return result;
+}
+
+Set<Entity*> FilterRenderEntities(const Vector<Entity*>& entities)
+{
+    Set<Entity*> result;
+    for (Entity* entity : entities)
+    {
+        if (entity->GetComponentCount<RenderComponent>() > 0)
+        {
+            result.insert(entity);
+        }
+    }
+    return result;
+}
+}
+
+DAVA_TESTCLASS (ArchetypeStorageTest)
+{
+    BEGIN_FILES_COVERED_BY_TESTS()
+    FIND_FILES_IN_TARGET(DavaFramework)
+    DECLARE_COVERED_FILES("ArchetypeStorage.cpp")
+    END_FILES_COVERED_BY_TESTS();
+
+    DAVA_TEST (QueryFollowsComponentsChanges)
+    {
+        using namespace DAVA;
+        using namespace ArchetypeStorageTestDetails;
+
+        ScopedPtr<Scene> scene(new Scene(0));
+        ArchetypeStorage* storage = CreateStorage(scene);
+        Vector<Entity*> entities = AddEntities(scene, 30);
+
+        // transform only, transform + render, transform + wind, all of them
+        TEST_VERIFY(storage->GetArchetypesCount() == 4);
+        TEST_VERIFY(storage->GetEntitiesCount() == 30);
+        TEST_VERIFY(QueryRenderEntities(storage) == FilterRenderEntities(entities));
+
+        entities[0]->RemoveComponent<RenderComponent>();
+        entities[1]->AddComponent(new RenderComponent());
+        entities[3]->RemoveComponent<WindComponent>();
+        TEST_VERIFY(QueryRenderEntities(storage) == FilterRenderEntities(entities));
+
+        scene->RemoveNode(entities[2]);
+        entities.erase(entities.begin() + 2);
+        TEST_VERIFY(storage->GetEntitiesCount() == 29);
+        TEST_VERIFY(QueryRenderEntities(storage) == FilterRenderEntities(entities));
+
+        uint32 windEntitiesCount = 0;
+        storage->ForEach<WindComponent>([&windEntitiesCount](Entity* entity, WindComponent* wind) {
+            ++windEntitiesCount;
+        });
+        TEST_VERIFY(windEntitiesCount == 9);
+
+        storage->Clear();
+        TEST_VERIFY(storage->GetEntitiesCount() == 0);
+        TEST_VERIFY(QueryRenderEntities(storage).empty());
+    }
+
+    DAVA_TEST (ChangedEntitiesAreQueuedOnce)
+    {
+        using namespace DAVA;
+        using namespace ArchetypeStorageTestDetails;
+
+        ScopedPtr<Scene> scene(new Scene(0));
+        ArchetypeStorage* storage = CreateStorage(scene);
+        Vector<Entity*> entities = AddEntities(scene, 6);
+
+        for (uint32 i = 0; i < 100; ++i)
+        {
+            entities[0]->RemoveComponent<RenderComponent>();
+            entities[0]->AddComponent(new RenderComponent());
+            entities[1]->AddComponent(new WindComponent());
+            entities[1]->RemoveComponent<WindComponent>();
+        }
+        TEST_VERIFY(storage->GetChangedEntitiesCount() == 2);
+
+        // removed entity leaves the queue with the storage
+        scene->RemoveNode(entities[0]);
+        entities.erase(entities.begin());
+        TEST_VERIFY(storage->GetChangedEntitiesCount() == 1);
+
+        // changes are applied by system owning the storage, even if nobody queries it
+        scene->Update(0.1f);
+        TEST_VERIFY(storage->GetChangedEntitiesCount() == 0);
+        TEST_VERIFY(QueryRenderEntities(storage) == FilterRenderEntities(entities));
+    }
+
+    DAVA_TEST (IterationBenchmark)
+    {
+        using namespace DAVA;
+        using namespace ArchetypeStorageTestDetails;
+
+        ScopedPtr<Scene> scene(new Scene(0));
+        ArchetypeStorage* storage = CreateStorage(scene);
+        Vector<Entity*> entities = AddEntities(scene, BENCHMARK_ENTITIES_COUNT);
+
+        // systems used to keep list of their own components and look up other components of each entity
+        Vector<RenderComponent*> renderComponents;
+        for (Entity* entity : entities)
+        {
+            RenderComponent* render = entity->GetComponent<RenderComponent>();
+            if (render != nullptr)
+            {
+                renderComponents.push_back(render);
+            }
+        }
+
+        float64 entitiesSum = 0.0;
+        int64 startTime = SystemTimer::GetUs();
+        for (uint32 i = 0; i < BENCHMARK_ITERATIONS_COUNT; ++i)
+        {
+            for (RenderComponent* render : renderComponents)
+            {
+                entitiesSum += render->GetEntity()->GetComponent<TransformComponent>()->GetLocalTransform().GetTranslation().x;
+            }
+        }
+        int64 entitiesTime = (SystemTimer::GetUs() - startTime) / BENCHMARK_ITERATIONS_COUNT;
+
+        float64 archetypesSum = 0.0;
+        startTime = SystemTimer::GetUs();
+        for (uint32 i = 0; i < BENCHMARK_ITERATIONS_COUNT; ++i)
+        {
+            storage->ForEach<TransformComponent, RenderComponent>([&archetypesSum](Entity* entity, TransformComponent* transform, RenderComponent* render) {
+                archetypesSum += transform->GetLocalTransform().GetTranslation().x;
+            });
+        }
+        int64 archetypesTime = (SystemTimer::GetUs() - startTime) / BENCHMARK_ITERATIONS_COUNT;
+
+        TEST_VERIFY(entitiesSum == archetypesSum);
+        Logger::Info("Iteration of %u entities with transform and render components: %lld us with list of render components and Entity::GetComponent, %lld us with ArchetypeStorage",
+                     BENCHMARK_ENTITIES_COUNT, entitiesTime, archetypesTime);
+    }
+};
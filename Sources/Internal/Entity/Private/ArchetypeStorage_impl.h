@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Entity/ComponentUtils.h"
+
+#include <utility>
+
+namespace DAVA
+{
+namespace ArchetypeStorageDetails
+{
+template <typename... T, typename Fn, size_t... I>
+void ForEachEntity(Fn& fn, const ArchetypeStorage::Archetype& archetype, Component* const* const* components, std::index_sequence<I...>)
+{
+    Entity* const* entities = archetype.GetEntities();
+    uint32 count = archetype.GetEntitiesCount();
+    for (uint32 i = 0; i < count; ++i)
+    {
+        fn(entities[i], static_cast<T*>(components[I][i])...);
+    }
+}
+}
+
+template <typename... T, typename Fn>
+void ArchetypeStorage::ForEach(Fn&& fn)
+{
+    const uint32 runtimeIds[] = { ComponentUtils::GetRuntimeId<T>()... };
+
+    ForEachArchetype<T...>([&fn, &runtimeIds](const Archetype& archetype) {
+        Component* const* components[sizeof...(T)];
+        for (size_t i = 0; i < sizeof...(T); ++i)
+        {
+            components[i] = archetype.GetComponents(runtimeIds[i]);
+        }
+        ArchetypeStorageDetails::ForEachEntity<T...>(fn, archetype, components, std::index_sequence_for<T...>());
+    });
+}
+
+template <typename... T, typename Fn>
+void ArchetypeStorage::ForEachArchetype(Fn&& fn)
+{
+    ApplyChanges();
+
+    const ComponentMask mask = ComponentUtils::MakeMask<T...>();
+    for (const std::unique_ptr<Archetype>& archetype : archetypes)
+    {
+        if (!archetype->entities.empty() && (archetype->componentsMask & mask) == mask)
+        {
+            fn(*archetype);
+        }
+    }
+}
+}
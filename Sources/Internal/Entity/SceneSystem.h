@@ -25,6 +25,20 @@ public:
     inline void SetRequiredComponents(const ComponentMask& requiredComponents);
     inline const ComponentMask& GetRequiredComponents() const;
 
+    /**
+        \brief Declares components which are read and written by Process of this system.
+                Scene processes systems which don't write components accessed by each other concurrently, see SceneSystemScheduler.
+                Access should be declared before system is added to scene. System without declared access is processed exclusively.
+        \param[in] readComponents components read by the system.
+        \param[in] writeComponents components modified by the system.
+        \param[in] mainThreadRequired system uses engine services which are not thread-safe (like sound) and should be processed on the main thread.
+     */
+    inline void SetComponentsAccess(const ComponentMask& readComponents, const ComponentMask& writeComponents, bool mainThreadRequired = false);
+    inline bool HasComponentsAccess() const;
+    inline const ComponentMask& GetReadComponents() const;
+    inline const ComponentMask& GetWriteComponents() const;
+    inline bool IsMainThreadRequired() const;
+
     /**
         \brief  This function is called when any entity registered to scene.
                 It sorts out is entity has all necessary components and we need to call AddEntity.
@@ -133,8 +147,13 @@ protected:
 
 private:
     ComponentMask requiredComponents;
+    ComponentMask readComponents;
+    ComponentMask writeComponents;
     Scene* scene = nullptr;
 
+    bool componentsAccessDeclared = false;
+    bool mainThreadRequired = false;
+
     bool locked = false;
 };
 
@@ -153,4 +172,32 @@ inline const ComponentMask& SceneSystem::GetRequiredComponents() const
 {
     return requiredComponents;
 }
+
+inline void SceneSystem::SetComponentsAccess(const ComponentMask& readComponents_, const ComponentMask& writeComponents_, bool mainThreadRequired_)
+{
+    readComponents = readComponents_;
+    writeComponents = writeComponents_;
+    mainThreadRequired = mainThreadRequired_;
+    componentsAccessDeclared = true;
+}
+
+inline bool SceneSystem::HasComponentsAccess() const
+{
+    return componentsAccessDeclared;
+}
+
+inline const ComponentMask& SceneSystem::GetReadComponents() const
+{
+    return readComponents;
+}
+
+inline const ComponentMask& SceneSystem::GetWriteComponents() const
+{
+    return writeComponents;
+}
+
+inline bool SceneSystem::IsMainThreadRequired() const
+{
+    return mainThreadRequired;
+}
 }
@@ -0,0 +1,119 @@
+#include "FileSystem/Private/MappedFile.h"
+#include "FileSystem/FilePath.h"
+#include "Logger/Logger.h"
+
+#if defined(__DAVAENGINE_WINDOWS__)
+#include "Base/Platform.h"
+#include "Utils/UTF8Utils.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace DAVA
+{
+std::shared_ptr<MappedFile> MappedFile::Create(const FilePath& filePath)
+{
+    String fileName = filePath.GetAbsolutePathname();
+    std::shared_ptr<MappedFile> mappedFile(new MappedFile());
+
+#if defined(__DAVAENGINE_WIN32__)
+
+    WideString wideFileName = UTF8Utils::EncodeToWideString(fileName);
+    HANDLE fileHandle = ::CreateFileW(wideFileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+    {
+        Logger::Warning("can't open file for mapping: %s", fileName.c_str());
+        return nullptr;
+    }
+    mappedFile->fileHandle = fileHandle;
+
+    LARGE_INTEGER fileSize;
+    if (::GetFileSizeEx(fileHandle, &fileSize) == FALSE || fileSize.QuadPart == 0)
+    {
+        Logger::Warning("can't get size of file for mapping: %s", fileName.c_str());
+        return nullptr;
+    }
+    mappedFile->size = static_cast<uint64>(fileSize.QuadPart);
+
+    HANDLE mappingHandle = ::CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle == nullptr)
+    {
+        Logger::Warning("can't create mapping of file: %s", fileName.c_str());
+        return nullptr;
+    }
+    mappedFile->mappingHandle = mappingHandle;
+
+    mappedFile->data = static_cast<const uint8*>(::MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (mappedFile->data == nullptr)
+    {
+        Logger::Warning("can't map view of file: %s", fileName.c_str());
+        return nullptr;
+    }
+
+#elif defined(__DAVAENGINE_WIN_UAP__)
+
+    // not implemented, caller falls back to reading through File
+    return nullptr;
+
+#else
+
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        Logger::Warning("can't open file for mapping: %s", fileName.c_str());
+        return nullptr;
+    }
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0 || static_cast<uint64>(fileStat.st_size) > std::numeric_limits<size_t>::max())
+    {
+        Logger::Warning("can't map file with size %lld: %s", static_cast<long long>(fileStat.st_size), fileName.c_str());
+        close(fd);
+        return nullptr;
+    }
+
+    void* address = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    // descriptor is not needed after mmap, mapping keeps reference to the file
+    close(fd);
+
+    if (address == MAP_FAILED)
+    {
+        Logger::Warning("can't map file: %s", fileName.c_str());
+        return nullptr;
+    }
+
+    mappedFile->data = static_cast<const uint8*>(address);
+    mappedFile->size = static_cast<uint64>(fileStat.st_size);
+
+#endif
+
+    return mappedFile;
+}
+
+MappedFile::~MappedFile()
+{
+#if defined(__DAVAENGINE_WINDOWS__)
+    if (data != nullptr)
+    {
+        ::UnmapViewOfFile(data);
+    }
+    if (mappingHandle != nullptr)
+    {
+        ::CloseHandle(mappingHandle);
+    }
+    if (fileHandle != nullptr)
+    {
+        ::CloseHandle(fileHandle);
+    }
+#else
+    if (data != nullptr)
+    {
+        munmap(const_cast<uint8*>(data), static_cast<size_t>(size));
+    }
+#endif
+}
+
+} // end namespace DAVA
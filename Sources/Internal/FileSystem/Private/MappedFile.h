@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+
+namespace DAVA
+{
+class FilePath;
+
+/**
+    Read-only memory mapping of whole file.
+    Mapping is released when last owner of MappedFile is destroyed, so views
+    into mapped memory are valid while they keep shared pointer to it.
+*/
+class MappedFile final
+{
+public:
+    /**
+        Map file into memory.
+        Return nullptr if file can't be mapped (file is absent, is inside of apk, platform doesn't support mapping etc).
+    */
+    static std::shared_ptr<MappedFile> Create(const FilePath& filePath);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8* GetData() const;
+    uint64 GetSize() const;
+
+private:
+    MappedFile() = default;
+
+    const uint8* data = nullptr;
+    uint64 size = 0;
+#if defined(__DAVAENGINE_WINDOWS__)
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
+
+inline const uint8* MappedFile::GetData() const
+{
+    return data;
+}
+
+inline uint64 MappedFile::GetSize() const
+{
+    return size;
+}
+
+} // end namespace DAVA
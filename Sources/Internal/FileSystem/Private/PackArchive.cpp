@@ -1,12 +1,17 @@
 #include "FileSystem/Private/PackArchive.h"
+#include "FileSystem/Private/MappedFile.h"
 #include "Compression/ZipCompressor.h"
 #include "Compression/LZ4Compressor.h"
 #include "FileSystem/FileSystem.h"
 #include "Utils/CRC32.h"
 #include "Logger/Logger.h"
 #include "Base/Exception.h"
+#include "Engine/Engine.h"
+#include "Engine/EngineContext.h"
+#include "Job/JobManager.h"
 
 #include <mutex>
+#include <numeric>
 
 namespace DAVA
 {
@@ -86,7 +91,7 @@ void PackArchive::FillFilesInfo(const PackFormat::PackFile& packFile,
                   });
 }
 
-PackArchive::PackArchive(RefPtr<File>& file_, const FilePath& archiveName_)
+PackArchive::PackArchive(RefPtr<File>& file_, const FilePath& archiveName_, bool useMemoryMapping)
     : archiveName(archiveName_)
     , file(file_)
 {
@@ -174,6 +179,28 @@ PackArchive::PackArchive(RefPtr<File>& file_, const FilePath& archiveName_)
         }
         packMeta.reset(new PackMetaData(&metaBlock[0], metaBlock.size(), fileNames));
     }
+
+    if (packMeta && !packMeta->GetCompressionDictionary().empty())
+    {
+        zstdCompressor.reset(new ZstdCompressor(packMeta->GetCompressionDictionary()));
+    }
+    else
+    {
+        zstdCompressor.reset(new ZstdCompressor());
+    }
+
+    if (useMemoryMapping)
+    {
+        mappedFile = MappedFile::Create(archiveName);
+        if (!mappedFile)
+        {
+            Logger::Warning("can't map pack file into memory, it will be read by file: %s", fileName.c_str());
+        }
+        else if (mappedFile->GetSize() != size)
+        {
+            DAVA_THROW(DAVA::Exception, "size of mapped pack file not match: " + fileName);
+        }
+    }
 }
 
 const Vector<ResourceArchive::FileInfo>& PackArchive::GetFilesInfo() const
@@ -202,18 +229,19 @@ bool PackArchive::HasFile(const String& relativeFilePath) const
     return iterator != mapFileData.end();
 }
 
-bool PackArchive::LoadFile(const String& relativeFilePath, Vector<uint8>& output) const
+bool PackArchive::ReadContent(const PackFormat::FileTableEntry& fileEntry, uint32 size, uint8* output, const String& relativeFilePath) const
 {
-    using namespace PackFormat;
-
-    if (!HasFile(relativeFilePath))
+    if (mappedFile)
     {
-        return false;
+        if (fileEntry.startPosition + size > mappedFile->GetSize())
+        {
+            Logger::Error("can't load file: %s course: content is out of mapped pack file", relativeFilePath.c_str());
+            return false;
+        }
+        std::copy_n(mappedFile->GetData() + fileEntry.startPosition, size, output);
+        return true;
     }
 
-    const FileTableEntry& fileEntry = *mapFileData.find(relativeFilePath)->second;
-    output.resize(fileEntry.originalSize);
-
     if (!file)
     {
         DAVA_THROW(DAVA::Exception, "can't open: " + relativeFilePath + " from pack: " + archiveName.GetStringValue());
@@ -226,67 +254,227 @@ bool PackArchive::LoadFile(const String& relativeFilePath, Vector<uint8>& output
         return false;
     }
 
+    uint32 readOk = file->Read(output, size);
+    if (readOk != size)
+    {
+        Logger::Error("can't load file: %s course: can't read content", relativeFilePath.c_str());
+        return false;
+    }
+    return true;
+}
+
+void PackArchive::CheckOriginalCrc32(const PackFormat::FileTableEntry& fileEntry, const uint8* content, const String& relativeFilePath) const
+{
+    if (fileEntry.originalCrc32 != 0 && fileEntry.originalCrc32 != CRC32::ForBuffer(content, fileEntry.originalSize))
+    {
+        String msg = "original crc32 not match for: " + relativeFilePath + " during decompress from pack: " + archiveName.GetStringValue();
+        throw FileCrc32FromPackNotMatch(msg, __FILE__, __LINE__);
+    }
+}
+
+bool PackArchive::ReadEntry(const PackFormat::FileTableEntry& fileEntry, Vector<uint8>& packed, Vector<uint8>& output, const String& relativeFilePath) const
+{
+    output.resize(fileEntry.originalSize);
+
+    // stored content is read directly into output
+    if (fileEntry.type == Compressor::Type::None)
+    {
+        return ReadContent(fileEntry, fileEntry.originalSize, output.data(), relativeFilePath);
+    }
+
+    packed.resize(fileEntry.compressedSize);
+    return ReadContent(fileEntry, fileEntry.compressedSize, packed.data(), relativeFilePath);
+}
+
+bool PackArchive::UnpackEntry(const PackFormat::FileTableEntry& fileEntry, const Vector<uint8>& packed, Vector<uint8>& output, const String& relativeFilePath) const
+{
     switch (fileEntry.type)
     {
     case Compressor::Type::None:
+        break;
+    case Compressor::Type::Lz4:
+    case Compressor::Type::Lz4HC:
     {
-        uint32 readOk = file->Read(output.data(), fileEntry.originalSize);
-        if (readOk != fileEntry.originalSize)
+        if (!LZ4Compressor().Decompress(packed, output))
         {
-            Logger::Error("can't load file: %s course: can't read uncompressed content", relativeFilePath.c_str());
+            Logger::Error("can't load file: %s  course: decompress error", relativeFilePath.c_str());
             return false;
         }
     }
     break;
-    case Compressor::Type::Lz4:
-    case Compressor::Type::Lz4HC:
+    case Compressor::Type::RFC1951:
     {
-        Vector<uint8> packedBuf(fileEntry.compressedSize);
-
-        uint32 readOk = file->Read(packedBuf.data(), fileEntry.compressedSize);
-        if (readOk != fileEntry.compressedSize)
+        if (!ZipCompressor().Decompress(packed, output))
         {
-            Logger::Error("can't load file: %s course: can't read compressed content", relativeFilePath.c_str());
+            Logger::Error("can't load file: %s  course: decompress error", relativeFilePath.c_str());
             return false;
         }
-
-        if (!LZ4Compressor().Decompress(packedBuf, output))
+    }
+    break;
+    case Compressor::Type::Zstd:
+    {
+        if (!zstdCompressor->Decompress(packed, output))
         {
             Logger::Error("can't load file: %s  course: decompress error", relativeFilePath.c_str());
             return false;
         }
     }
     break;
-    case Compressor::Type::RFC1951:
+    } // end switch
+
+    // check crc32 for file content
+    CheckOriginalCrc32(fileEntry, output.data(), relativeFilePath);
+
+    return true;
+}
+
+bool PackArchive::LoadFile(const String& relativeFilePath, Vector<uint8>& output) const
+{
+    using namespace PackFormat;
+
+    if (!HasFile(relativeFilePath))
+    {
+        return false;
+    }
+
+    const FileTableEntry& fileEntry = *mapFileData.find(relativeFilePath)->second;
+
+    Vector<uint8> packedBuf;
+    if (!ReadEntry(fileEntry, packedBuf, output, relativeFilePath))
+    {
+        return false;
+    }
+
+    return UnpackEntry(fileEntry, packedBuf, output, relativeFilePath);
+}
+
+bool PackArchive::LoadFiles(const Vector<String>& relativeFilePaths, Vector<Vector<uint8>>& output) const
+{
+    using namespace PackFormat;
+
+    const uint32 count = static_cast<uint32>(relativeFilePaths.size());
+    output.resize(count);
+
+    JobManager* jobManager = GetEngineContext()->jobManager;
+    if (jobManager == nullptr || count < 2)
     {
-        Vector<uint8> packedBuf(fileEntry.compressedSize);
+        return ResourceArchiveImpl::LoadFiles(relativeFilePaths, output);
+    }
 
-        uint32 readOk = file->Read(packedBuf.data(), fileEntry.compressedSize);
-        if (readOk != fileEntry.compressedSize)
+    Vector<const FileTableEntry*> entries(count);
+    for (uint32 i = 0; i < count; ++i)
+    {
+        auto it = mapFileData.find(relativeFilePaths[i]);
+        if (it == mapFileData.end())
         {
-            Logger::Error("can't load file: %s course: can't read compressed content", relativeFilePath.c_str());
             return false;
         }
+        entries[i] = it->second;
+    }
+
+    // read files in order of their content in pack, so reading through file is sequential
+    Vector<uint32> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&entries](uint32 l, uint32 r) {
+        return entries[l]->startPosition < entries[r]->startPosition;
+    });
 
-        if (!ZipCompressor().Decompress(packedBuf, output))
+    Vector<Vector<uint8>> packedBuffers(count);
+    Vector<uint8> results(count, 0);
+    Vector<std::exception_ptr> errors(count);
+    JobGroup group;
+
+    auto unpack = [&](uint32 i) {
+        try
         {
-            Logger::Error("can't load file: %s  course: decompress error", relativeFilePath.c_str());
-            return false;
+            results[i] = UnpackEntry(*entries[i], packedBuffers[i], output[i], relativeFilePaths[i]) ? 1 : 0;
+        }
+        catch (...)
+        {
+            // crc32 mismatch exception is rethrown in calling thread
+            errors[i] = std::current_exception();
+        }
+        Vector<uint8>().swap(packedBuffers[i]);
+    };
+
+    for (uint32 i : order)
+    {
+        if (mappedFile)
+        {
+            // mapped memory can be read from any thread
+            jobManager->CreateWorkerJob([&, i]() {
+                if (ReadEntry(*entries[i], packedBuffers[i], output[i], relativeFilePaths[i]))
+                {
+                    unpack(i);
+                }
+            },
+                                        &group);
+        }
+        else
+        {
+            // file is read in this thread while previous files are decompressed by workers,
+            // exception is not thrown from here because running jobs reference local variables
+            try
+            {
+                if (ReadEntry(*entries[i], packedBuffers[i], output[i], relativeFilePaths[i]))
+                {
+                    jobManager->CreateWorkerJob([&unpack, i]() { unpack(i); }, &group);
+                }
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception();
+            }
         }
     }
-    break;
-    } // end switch
+    jobManager->WaitWorkerJobs(&group);
 
-    // check crc32 for file content
-    if (fileEntry.originalCrc32 != 0 && fileEntry.originalCrc32 != CRC32::ForBuffer(output.data(), output.size()))
+    for (const std::exception_ptr& error : errors)
     {
-        String msg = "original crc32 not match for: " + relativeFilePath + " during decompress from pack: " + archiveName.GetStringValue();
-        throw FileCrc32FromPackNotMatch(msg, __FILE__, __LINE__);
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    return std::all_of(results.begin(), results.end(), [](uint8 result) { return result != 0; });
+}
+
+bool PackArchive::LoadFileView(const String& relativeFilePath, ResourceArchive::FileView& output) const
+{
+    using namespace PackFormat;
+
+    auto it = mapFileData.find(relativeFilePath);
+    if (it == mapFileData.end())
+    {
+        return false;
+    }
+
+    const FileTableEntry& fileEntry = *it->second;
+    if (!mappedFile || fileEntry.type != Compressor::Type::None)
+    {
+        return ResourceArchiveImpl::LoadFileView(relativeFilePath, output);
+    }
+
+    if (fileEntry.startPosition + fileEntry.originalSize > mappedFile->GetSize())
+    {
+        Logger::Error("can't load file: %s course: content is out of mapped pack file", relativeFilePath.c_str());
+        return false;
     }
 
+    // Content crc32 is not checked here: it would touch every page of the view and defeat lazy mapping.
+    // Integrity of mapped pack relies on crc32 of footer and files table checked on open.
+    output.data = mappedFile->GetData() + fileEntry.startPosition;
+    output.size = fileEntry.originalSize;
+    output.holder = mappedFile;
     return true;
 }
 
+bool PackArchive::IsMemoryMapped() const
+{
+    return mappedFile != nullptr;
+}
+
 uint32 PackArchive::GetFileIndex(const String& releativeFilePath) const
 {
     uint32 result = std::numeric_limits<uint32>::max();
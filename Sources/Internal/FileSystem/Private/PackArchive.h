@@ -4,18 +4,35 @@
 #include "FileSystem/Private/PackFormatSpec.h"
 #include "FileSystem/Private/PackMetaData.h"
 #include "FileSystem/File.h"
+#include "Compression/ZstdCompressor.h"
+
+#include <memory>
 
 namespace DAVA
 {
+class MappedFile;
+
 class PackArchive final : public ResourceArchiveImpl
 {
 public:
-    PackArchive(RefPtr<File>& file_, const FilePath& archiveName);
+    PackArchive(RefPtr<File>& file_, const FilePath& archiveName, bool useMemoryMapping = false);
 
     const Vector<ResourceArchive::FileInfo>& GetFilesInfo() const override;
     const ResourceArchive::FileInfo* GetFileInfo(const String& relativeFilePath) const override;
     bool HasFile(const String& relativeFilePath) const override;
     bool LoadFile(const String& relativeFilePath, Vector<uint8>& output) const override;
+    /**
+		for stored files of memory mapped archive returns view into mapping without copy
+		and without crc32 check of content, other files are loaded into buffer
+	*/
+    bool LoadFileView(const String& relativeFilePath, ResourceArchive::FileView& output) const override;
+
+    /**
+		load several files, decompression of them is done in parallel on JobManager worker threads
+	*/
+    bool LoadFiles(const Vector<String>& relativeFilePaths, Vector<Vector<uint8>>& output) const override;
+
+    bool IsMemoryMapped() const;
 
     /**
 		return index of struct with file info, usefull for meta data
@@ -43,10 +60,17 @@ public:
                               Vector<ResourceArchive::FileInfo>& filesInfo);
 
 private:
+    bool ReadContent(const PackFormat::FileTableEntry& fileEntry, uint32 size, uint8* output, const String& relativeFilePath) const;
+    bool ReadEntry(const PackFormat::FileTableEntry& fileEntry, Vector<uint8>& packed, Vector<uint8>& output, const String& relativeFilePath) const;
+    bool UnpackEntry(const PackFormat::FileTableEntry& fileEntry, const Vector<uint8>& packed, Vector<uint8>& output, const String& relativeFilePath) const;
+    void CheckOriginalCrc32(const PackFormat::FileTableEntry& fileEntry, const uint8* content, const String& relativeFilePath) const;
+
     const FilePath archiveName;
     mutable RefPtr<File> file;
+    std::shared_ptr<MappedFile> mappedFile;
     PackFormat::PackFile packFile;
     std::unique_ptr<PackMetaData> packMeta;
+    std::unique_ptr<ZstdCompressor> zstdCompressor; // with dictionary from meta if pack has one
     UnorderedMap<String, const PackFormat::FileTableEntry*> mapFileData;
     Vector<ResourceArchive::FileInfo> filesInfo;
 };
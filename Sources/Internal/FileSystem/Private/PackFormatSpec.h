@@ -89,6 +89,12 @@ struct LitePack
         Compressor::Type type;
         Array<char8, 4> packMarkerLite;
     };
+
+    // File::Create can't decompress other types, zstd content may also depend on dictionary of the whole pack
+    static bool IsCompressionTypeSupported(Compressor::Type type)
+    {
+        return type == Compressor::Type::None || type == Compressor::Type::Lz4 || type == Compressor::Type::Lz4HC;
+    }
 };
 
 static_assert(sizeof(LitePack::Footer) == 20, "footer block size changed");
@@ -367,6 +367,10 @@ Vector<uint8> PackMetaData::Serialize() const
     // (4b) - num_childs
     // (4*num_childs) - dependent_child_indexes
     // WHILE (num_packs_with_childs)
+    // optional, older readers stop before it:
+    // (4b) - header - "zdic"
+    // (4b) - dictionary_size
+    // (dictionary_size b) - zstd_dictionary
 
     ScopedPtr<DynamicMemoryFile> file(DynamicMemoryFile::Create(File::READ | File::WRITE));
     if (4 != file->Write("met2", 4))
@@ -436,6 +440,23 @@ Vector<uint8> PackMetaData::Serialize() const
         }
     }
 
+    if (!compressionDictionary.empty())
+    {
+        if (4 != file->Write("zdic", 4))
+        {
+            DAVA_THROW(Exception, "write dictionary header failed");
+        }
+        uint32 dictionarySize = static_cast<uint32>(compressionDictionary.size());
+        if (4 != file->Write(&dictionarySize, sizeof(dictionarySize)))
+        {
+            DAVA_THROW(Exception, "write dictionarySize failed");
+        }
+        if (dictionarySize != file->Write(&compressionDictionary[0], dictionarySize))
+        {
+            DAVA_THROW(Exception, "write dictionary failed");
+        }
+    }
+
     return file->GetDataVector();
 }
 
@@ -473,6 +494,10 @@ void PackMetaData::Deserialize(const void* ptr, size_t size)
     // (4b) - num_childs
     // (4*num_childs) - dependent_child_indexes
     // WHILE (num_packs_with_childs)
+    // optional, older readers stop before it:
+    // (4b) - header - "zdic"
+    // (4b) - dictionary_size
+    // (dictionary_size b) - zstd_dictionary
 
     array<char, 4> header;
     file.read(&header[0], 4);
@@ -592,6 +617,31 @@ void PackMetaData::Deserialize(const void* ptr, size_t size)
 
         SortAndEraseDuplicates(dependenciesRow);
     }
+
+    // read optional dictionary
+    compressionDictionary.clear();
+    array<char, 4> dictionaryHeader;
+    file.read(&dictionaryHeader[0], 4);
+    if (file && dictionaryHeader == array<char, 4>{ 'z', 'd', 'i', 'c' })
+    {
+        uint32 dictionarySize = 0;
+        file.read(reinterpret_cast<char*>(&dictionarySize), sizeof(dictionarySize));
+        if (!file || dictionarySize == 0)
+        {
+            DAVA_THROW(Exception, "read dictionarySize failed");
+        }
+        compressionDictionary.resize(dictionarySize);
+        file.read(reinterpret_cast<char*>(&compressionDictionary[0]), dictionarySize);
+        if (!file)
+        {
+            DAVA_THROW(Exception, "read dictionary failed");
+        }
+    }
+}
+
+void PackMetaData::SetCompressionDictionary(Vector<uint8> dictionary)
+{
+    compressionDictionary = std::move(dictionary);
 }
 
 bool PackMetaData::HasDependency(uint32 packWithDependency, uint32 dependency) const
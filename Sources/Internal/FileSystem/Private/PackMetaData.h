@@ -79,6 +79,13 @@ public:
 
     const Dependencies& GetDependencies(uint32 packIndex) const;
 
+    /**
+        Zstd dictionary shared by all files of pack compressed with Compressor::Type::Zstd,
+        empty if files are compressed without dictionary
+     */
+    const Vector<uint8>& GetCompressionDictionary() const;
+    void SetCompressionDictionary(Vector<uint8> dictionary);
+
 private:
     void GenerateDependencyMatrix(size_t numPacks);
     void GenerateDependencyMatrixRow(uint32 packIndex, Dependencies& out) const;
@@ -100,6 +107,8 @@ private:
 
     // all file names to check if file belong to this meta
     FileNamesTree namesTree;
+
+    Vector<uint8> compressionDictionary;
 };
 
 inline size_t PackMetaData::GetFileCount() const
@@ -112,4 +121,9 @@ inline size_t PackMetaData::GetPacksCount() const
     return packDependencies.size();
 }
 
+inline const Vector<uint8>& PackMetaData::GetCompressionDictionary() const
+{
+    return compressionDictionary;
+}
+
 } // end namespace DAVA
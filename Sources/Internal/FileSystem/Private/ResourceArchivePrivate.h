@@ -13,6 +13,10 @@ public:
     virtual const ResourceArchive::FileInfo* GetFileInfo(const String& relativeFilePath) const = 0;
     virtual bool HasFile(const String& relativeFilePath) const = 0;
     virtual bool LoadFile(const String& relativeFilePath, Vector<uint8>& output) const = 0;
+    // default implementation loads file into buffer owned by view
+    virtual bool LoadFileView(const String& relativeFilePath, ResourceArchive::FileView& output) const;
+    // default implementation loads files one by one
+    virtual bool LoadFiles(const Vector<String>& relativeFilePaths, Vector<Vector<uint8>>& output) const;
 };
 
 } // end namespace DAVA
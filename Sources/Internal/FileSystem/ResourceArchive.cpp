@@ -19,7 +19,7 @@
 
 namespace DAVA
 {
-ResourceArchive::ResourceArchive(const FilePath& archiveName)
+ResourceArchive::ResourceArchive(const FilePath& archiveName, bool useMemoryMapping)
 {
     const String& fileName = archiveName.GetAbsolutePathname();
 
@@ -51,7 +51,7 @@ ResourceArchive::ResourceArchive(const FilePath& archiveName)
 
     if (PackFormat::FILE_MARKER == lastFourBytes)
     {
-        impl.reset(new PackArchive(f, fileName));
+        impl.reset(new PackArchive(f, fileName, useMemoryMapping));
     }
     else
     {
@@ -97,6 +97,43 @@ bool ResourceArchive::LoadFile(const String& relativeFilePath,
     return impl->LoadFile(relativeFilePath, output);
 }
 
+bool ResourceArchive::LoadFileView(const String& relativeFilePath, FileView& output) const
+{
+    return impl->LoadFileView(relativeFilePath, output);
+}
+
+bool ResourceArchiveImpl::LoadFileView(const String& relativeFilePath, ResourceArchive::FileView& output) const
+{
+    std::shared_ptr<Vector<uint8>> content = std::make_shared<Vector<uint8>>();
+    if (!LoadFile(relativeFilePath, *content))
+    {
+        return false;
+    }
+
+    output.data = content->data();
+    output.size = static_cast<uint32>(content->size());
+    output.holder = std::move(content);
+    return true;
+}
+
+bool ResourceArchive::LoadFiles(const Vector<String>& relativeFilePaths, Vector<Vector<uint8>>& output) const
+{
+    return impl->LoadFiles(relativeFilePaths, output);
+}
+
+bool ResourceArchiveImpl::LoadFiles(const Vector<String>& relativeFilePaths, Vector<Vector<uint8>>& output) const
+{
+    output.resize(relativeFilePaths.size());
+    for (size_t i = 0; i < relativeFilePaths.size(); ++i)
+    {
+        if (!LoadFile(relativeFilePaths[i], output[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool ResourceArchive::UnpackToFolder(const FilePath& dir) const
 {
     Vector<uint8> content;
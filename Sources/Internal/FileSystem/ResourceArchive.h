@@ -23,7 +23,12 @@ class FilePath;
 class ResourceArchive final
 {
 public:
-    explicit ResourceArchive(const FilePath& filePath);
+    /**
+        If `useMemoryMapping` is true, dvpk archive is mapped into memory and
+        stored (not compressed) files can be accessed without copying with LoadFileView.
+        Archive falls back to usual reading if file can't be mapped.
+    */
+    explicit ResourceArchive(const FilePath& filePath, bool useMemoryMapping = false);
     ~ResourceArchive();
 
     struct FileInfo
@@ -39,10 +44,31 @@ public:
         Compressor::Type compressionType = Compressor::Type::None;
     };
 
+    /**
+        Read-only content of file from archive.
+        For stored files of memory mapped archive it points directly into the mapping,
+        in other cases it points to buffer with loaded content. In both cases `holder`
+        keeps memory alive, so view remains valid even after archive is destroyed.
+        Content of view into the mapping is not verified by crc32, only footer and files table of archive are.
+    */
+    struct FileView
+    {
+        const uint8* data = nullptr;
+        uint32 size = 0;
+        std::shared_ptr<const void> holder;
+    };
+
     const Vector<FileInfo>& GetFilesInfo() const;
     const FileInfo* GetFileInfo(const String& relativeFilePath) const;
     bool HasFile(const String& relativeFilePath) const;
     bool LoadFile(const String& relativeFilePath, Vector<uint8>& outputFileContent) const;
+    bool LoadFileView(const String& relativeFilePath, FileView& outputView) const;
+    /**
+        Load several files at once, `outputFilesContent[i]` receives content of `relativeFilePaths[i]`.
+        Dvpk archive decompresses files in parallel on JobManager worker threads.
+        Return false if any of files can't be loaded.
+    */
+    bool LoadFiles(const Vector<String>& relativeFilePaths, Vector<Vector<uint8>>& outputFilesContent) const;
 
     bool UnpackToFolder(const FilePath& dir) const;
 
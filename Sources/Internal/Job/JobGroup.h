@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+#include "Concurrency/Atomic.h"
+
+namespace DAVA
+{
+/*! Counter of unfinished worker jobs. Jobs are added into group with JobManager::CreateWorkerJob
+    and user can wait for them with JobManager::WaitWorkerJobs(JobGroup*).
+    Group should outlive all jobs that were added into it.
+
+    \code
+    JobGroup group;
+    for (Entity* e : entities)
+    {
+        jobManager->CreateWorkerJob([e]() { Process(e); }, &group);
+    }
+    jobManager->WaitWorkerJobs(&group);
+    \endcode
+*/
+class JobGroup
+{
+public:
+    JobGroup() = default;
+    JobGroup(const JobGroup&) = delete;
+    JobGroup& operator=(const JobGroup&) = delete;
+
+    /*! Returns true if all jobs added into group are finished. */
+    bool IsFinished() const;
+
+private:
+    friend class JobManager;
+    Atomic<int32> unfinishedCount;
+};
+
+inline bool JobGroup::IsFinished() const
+{
+    return (0 == unfinishedCount.Get());
+}
+}
@@ -5,24 +5,46 @@
 #include "Debug/ProfilerMarkerNames.h"
 #include "Engine/Engine.h"
 #include "Concurrency/LockGuard.h"
+#include "Concurrency/ThreadLocalPtr.h"
 #include "Concurrency/UniqueLock.h"
 #include "Job/JobThread.h"
 #include "Platform/DeviceInfo.h"
 
 namespace DAVA
 {
-JobManager::JobManager(Engine* e)
+namespace JobManagerDetails
+{
+void KeepWorkerJob(WorkerJob*)
+{
+}
+
+// worker job that is executed by the current thread, used to bind child jobs
+ThreadLocalPtr<WorkerJob> currentWorkerJob(&KeepWorkerJob);
+}
+
+JobManager::JobManager(Engine* e, uint32 workersCount)
     : engine(e)
     , mainJobIDCounter(1)
     , mainJobLastExecutedID(0)
     , workerDoneSem(0)
+    , workerWakeSem(0)
 {
-    uint32 cpuCoresCount = DeviceInfo::GetCpuCount();
-    workerThreads.reserve(cpuCoresCount);
+    if (0 == workersCount)
+    {
+        workersCount = DeviceInfo::GetCpuCount();
+    }
 
-    for (uint32 i = 0; i < cpuCoresCount; ++i)
+    // queues should exist before threads are started
+    workerQueues.reserve(workersCount + 1);
+    for (uint32 i = 0; i <= workersCount; ++i)
     {
-        JobThread* thread = new JobThread(&workerQueue, &workerDoneSem);
+        workerQueues.push_back(new JobQueueWorker());
+    }
+
+    workerThreads.reserve(workersCount);
+    for (uint32 i = 0; i < workersCount; ++i)
+    {
+        JobThread* thread = new JobThread(this, i);
         workerThreads.push_back(thread);
     }
 
@@ -41,12 +63,30 @@ JobManager::~JobManager()
     mainJobIDCounter = 0;
     mainCV.NotifyAll();
 
+    for (JobThread* thread : workerThreads)
+    {
+        thread->Cancel();
+    }
+    WakeUpWorkers(static_cast<uint32>(workerThreads.size()));
+
     for (uint32 i = 0; i < workerThreads.size(); ++i)
     {
         SafeDelete(workerThreads[i]);
     }
 
     workerThreads.clear();
+
+    // jobs that weren't executed are just released
+    for (JobQueueWorker* queue : workerQueues)
+    {
+        for (WorkerJob* job = queue->Pop(); nullptr != job; job = queue->Pop())
+        {
+            SafeDelete(job);
+        }
+        SafeDelete(queue);
+    }
+
+    workerQueues.clear();
 }
 
 void JobManager::Update(float32 /*frameDelta*/)
@@ -237,8 +277,18 @@ bool JobManager::HasMainJobID(uint32 mainJobID)
 
 void JobManager::CreateWorkerJob(const Function<void()>& fn)
 {
-    workerQueue.Push(fn);
-    workerQueue.Signal();
+    PushWorkerJob(fn, nullptr, nullptr);
+}
+
+void JobManager::CreateWorkerJob(const Function<void()>& fn, JobGroup* group)
+{
+    PushWorkerJob(fn, group, nullptr);
+}
+
+void JobManager::CreateChildWorkerJob(const Function<void()>& fn)
+{
+    WorkerJob* parent = JobManagerDetails::currentWorkerJob.Get();
+    PushWorkerJob(fn, (nullptr != parent) ? parent->group : nullptr, parent);
 }
 
 void JobManager::WaitWorkerJobs()
@@ -262,8 +312,201 @@ void JobManager::WaitWorkerJobs()
     }
 }
 
+void JobManager::WaitWorkerJobs(JobGroup* group)
+{
+    DVASSERT(nullptr != group);
+
+    while (!group->IsFinished())
+    {
+        // help workers instead of sleeping: execute jobs of the same group
+        WorkerJob* job = FindWorkerJob(group);
+        if (nullptr != job)
+        {
+            ExecuteWorkerJob(job);
+        }
+        else if (Thread::IsMainThread())
+        {
+            // rest of group jobs are in progress and some of them
+            // can wait for main-thread jobs, so execute them
+            Update();
+        }
+        else
+        {
+            Thread::Yield();
+        }
+    }
+}
+
 bool JobManager::HasWorkerJobs()
 {
-    return !workerQueue.IsEmpty();
+    return (workerJobsCount.Get() > 0);
+}
+
+void JobManager::ParallelFor(uint32 begin, uint32 end, const Function<void(uint32, uint32)>& fn, uint32 grainSize)
+{
+    if (begin >= end)
+    {
+        return;
+    }
+
+    uint32 count = end - begin;
+    if (0 == grainSize)
+    {
+        // several chunks per thread to let stealing balance uneven chunks
+        uint32 chunksCount = (GetWorkersCount() + 1) * 4;
+        grainSize = Max(1u, (count + chunksCount - 1) / chunksCount);
+    }
+
+    if (count <= grainSize)
+    {
+        fn(begin, end);
+        return;
+    }
+
+    // first chunk is executed by the calling thread
+    JobGroup group;
+    uint32 chunkEnd = 0;
+    for (uint32 chunkBegin = begin + grainSize; chunkBegin < end; chunkBegin = chunkEnd)
+    {
+        chunkEnd = chunkBegin + Min(grainSize, end - chunkBegin);
+        CreateWorkerJob([&fn, chunkBegin, chunkEnd]() { fn(chunkBegin, chunkEnd); }, &group);
+    }
+
+    fn(begin, begin + grainSize);
+    WaitWorkerJobs(&group);
+}
+
+void JobManager::PushWorkerJob(const Function<void()>& fn, JobGroup* group, WorkerJob* parent)
+{
+    if (fn == nullptr)
+    {
+        return;
+    }
+
+    WorkerJob* job = new WorkerJob();
+    job->fn = fn;
+    job->group = group;
+    job->parent = parent;
+    job->unfinishedCount = 1;
+
+    // only top-level jobs are counted in group,
+    // children are counted in their parent
+    if (nullptr != parent)
+    {
+        parent->unfinishedCount.Increment();
+    }
+    else if (nullptr != group)
+    {
+        group->unfinishedCount.Increment();
+    }
+    workerJobsCount.Increment();
+
+    workerQueues[GetCurrentQueueIndex()]->Push(job);
+    WakeUpWorkers(1);
+}
+
+WorkerJob* JobManager::FindWorkerJob(uint32 queueIndex)
+{
+    WorkerJob* job = workerQueues[queueIndex]->Pop();
+
+    // own queue is empty, try to steal from neighbours
+    uint32 queuesCount = static_cast<uint32>(workerQueues.size());
+    for (uint32 i = 1; i < queuesCount && nullptr == job; ++i)
+    {
+        job = workerQueues[(queueIndex + i) % queuesCount]->Steal();
+    }
+
+    return job;
+}
+
+WorkerJob* JobManager::FindWorkerJob(const JobGroup* group)
+{
+    WorkerJob* job = nullptr;
+
+    uint32 queueIndex = GetCurrentQueueIndex();
+    uint32 queuesCount = static_cast<uint32>(workerQueues.size());
+    for (uint32 i = 0; i < queuesCount && nullptr == job; ++i)
+    {
+        job = workerQueues[(queueIndex + i) % queuesCount]->StealFromGroup(group);
+    }
+
+    return job;
+}
+
+void JobManager::ExecuteWorkerJob(WorkerJob* job)
+{
+    // jobs can be executed recursively while waiting for the group
+    WorkerJob* prevJob = JobManagerDetails::currentWorkerJob.Get();
+    JobManagerDetails::currentWorkerJob.Reset(job);
+
+    job->fn();
+
+    JobManagerDetails::currentWorkerJob.Reset(prevJob);
+    FinishWorkerJob(job);
+}
+
+void JobManager::FinishWorkerJob(WorkerJob* job)
+{
+    while (nullptr != job && 0 == job->unfinishedCount.Decrement())
+    {
+        WorkerJob* parent = job->parent;
+        if (nullptr == parent && nullptr != job->group)
+        {
+            job->group->unfinishedCount.Decrement();
+        }
+        SafeDelete(job);
+
+        if (0 == workerJobsCount.Decrement())
+        {
+            workerDoneSem.Post();
+        }
+
+        job = parent;
+    }
+}
+
+bool JobManager::HasQueuedWorkerJobs()
+{
+    for (JobQueueWorker* queue : workerQueues)
+    {
+        if (!queue->IsEmpty())
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void JobManager::WaitQueuedWorkerJobs()
+{
+    // increment sleepers count before checking queues, so
+    // pushing thread either sees us sleeping or we see its job
+    sleepingWorkersCount.Increment();
+    if (!HasQueuedWorkerJobs())
+    {
+        workerWakeSem.Wait();
+    }
+    sleepingWorkersCount.Decrement();
+}
+
+void JobManager::WakeUpWorkers(uint32 count)
+{
+    if (sleepingWorkersCount.Get() > 0)
+    {
+        workerWakeSem.Post(count);
+    }
+}
+
+uint32 JobManager::GetCurrentQueueIndex() const
+{
+    JobThread* jobThread = JobThread::GetCurrent();
+    if (nullptr != jobThread && jobThread->GetJobManager() == this)
+    {
+        return jobThread->GetWorkerIndex();
+    }
+
+    // shared queue for main and other threads
+    return static_cast<uint32>(workerQueues.size()) - 1;
 }
 }
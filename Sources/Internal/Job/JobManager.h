@@ -2,10 +2,12 @@
 
 #include "Base/BaseTypes.h"
 #include "Concurrency/Atomic.h"
+#include "Concurrency/ConditionVariable.h"
 #include "Concurrency/Mutex.h"
 #include "Concurrency/Semaphore.h"
 #include "Concurrency/Thread.h"
 #include "Functional/Function.h"
+#include "Job/JobGroup.h"
 #include "Job/JobQueue.h"
 
 namespace DAVA
@@ -24,7 +26,8 @@ public:
     };
 
 public:
-    JobManager(Engine* e);
+    /*! Create job manager with `workersCount` worker-threads. If `workersCount` is 0, number of CPU cores is used. */
+    JobManager(Engine* e, uint32 workersCount = 0);
     virtual ~JobManager();
 
     /*! This function should be called periodically from the main thread. All main-thread jobs added to the queue
@@ -62,14 +65,44 @@ public:
 	*/
     void CreateWorkerJob(const Function<void()>& fn);
 
+    /*! Add function to execute in the worker-thread and count it in the given group.
+        Job created from the worker-thread is pushed into queue of that thread, other idle
+        worker-threads will steal it from there.
+		\param [in] fn Function to execute.
+		\param [in] group Group to count job in, can be nullptr.
+	*/
+    void CreateWorkerJob(const Function<void()>& fn, JobGroup* group);
+
+    /*! Add child job to the worker job that is executed by the current thread. Parent job is considered
+        finished only when all of its children are finished, so waiting for the parent's group waits for
+        children too. If there is no executing worker job in the current thread, works as CreateWorkerJob(fn).
+		\param [in] fn Function to execute.
+	*/
+    void CreateChildWorkerJob(const Function<void()>& fn);
+
     /*! Wait until all worker-thread jobs are executed. */
     void WaitWorkerJobs();
 
+    /*! Wait until all jobs of the given group, including their children, are executed.
+        Waiting thread doesn't sleep, but executes jobs of this group meanwhile.
+		\param [in] group Group to wait for.
+	*/
+    void WaitWorkerJobs(JobGroup* group);
+
     /*!  Check in there are some not executed worker-thread jobs.
 		\return Return true if there are some jobs, otherwise false.
 	*/
     bool HasWorkerJobs();
 
+    /*! Split range [begin, end) into chunks and execute `fn(chunkBegin, chunkEnd)` for each of them in the worker-threads.
+        Calling thread takes part in execution and returns when all chunks are executed.
+		\param [in] begin First index of range.
+		\param [in] end Index after the last one in range.
+		\param [in] fn Function to execute for each chunk.
+		\param [in] grainSize Max size of the chunk. If 0, it is chosen by number of worker-threads.
+	*/
+    void ParallelFor(uint32 begin, uint32 end, const Function<void(uint32, uint32)>& fn, uint32 grainSize = 0);
+
 protected:
     struct MainJob
     {
@@ -98,7 +131,23 @@ protected:
     MainJob curMainJob;
 
     Semaphore workerDoneSem;
-    JobQueueWorker workerQueue;
+    Semaphore workerWakeSem;
+    Atomic<int32> workerJobsCount;
+    Atomic<int32> sleepingWorkersCount;
+    Vector<JobQueueWorker*> workerQueues; ///< queue per worker-thread and the last one shared by other threads
     Vector<JobThread*> workerThreads;
+
+private:
+    friend class JobThread;
+
+    void PushWorkerJob(const Function<void()>& fn, JobGroup* group, WorkerJob* parent);
+    WorkerJob* FindWorkerJob(uint32 queueIndex);
+    WorkerJob* FindWorkerJob(const JobGroup* group);
+    void ExecuteWorkerJob(WorkerJob* job);
+    void FinishWorkerJob(WorkerJob* job);
+    bool HasQueuedWorkerJobs();
+    void WaitQueuedWorkerJobs();
+    void WakeUpWorkers(uint32 count);
+    uint32 GetCurrentQueueIndex() const;
 };
 }
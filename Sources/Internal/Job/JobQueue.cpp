@@ -1,91 +1,66 @@
 #include "Job/JobQueue.h"
-#include "Job/JobManager.h"
 #include "Concurrency/LockGuard.h"
+#include "Debug/DVAssert.h"
 
 namespace DAVA
 {
-JobQueueWorker::JobQueueWorker(uint32 maxCount /* = 1024 */)
-    : jobsMaxCount(maxCount)
-    , nextPushIndex(0)
-    , nextPopIndex(0)
-    , processingCount(0)
+void JobQueueWorker::Push(WorkerJob* job)
 {
-    jobs = new Function<void()>[jobsMaxCount];
-}
+    DVASSERT(job != nullptr);
 
-JobQueueWorker::~JobQueueWorker()
-{
-    SafeDeleteArray(jobs);
+    LockGuard<Spinlock> guard(lock);
+    jobs.push_back(job);
 }
 
-void JobQueueWorker::Push(const Function<void()>& fn)
+WorkerJob* JobQueueWorker::Pop()
 {
-    if (fn != nullptr)
-    {
-        LockGuard<Spinlock> guard(lock);
-        if (nextPushIndex == nextPopIndex && 0 == processingCount)
-        {
-            nextPushIndex = 0;
-            nextPopIndex = 0;
-        }
+    WorkerJob* job = nullptr;
 
-        DVASSERT(nextPushIndex < jobsMaxCount);
-
-        jobs[nextPushIndex++] = fn;
-        processingCount++;
+    LockGuard<Spinlock> guard(lock);
+    if (!jobs.empty())
+    {
+        job = jobs.back();
+        jobs.pop_back();
     }
+
+    return job;
 }
 
-bool JobQueueWorker::PopAndExec()
+WorkerJob* JobQueueWorker::Steal()
 {
-    bool ret = false;
-    Function<void()> fn;
+    WorkerJob* job = nullptr;
 
+    LockGuard<Spinlock> guard(lock);
+    if (!jobs.empty())
     {
-        LockGuard<Spinlock> guard(lock);
-        if (nextPopIndex < nextPushIndex)
-        {
-            fn = std::move(jobs[nextPopIndex++]);
-        }
+        job = jobs.front();
+        jobs.pop_front();
     }
 
-    if (fn != nullptr)
-    {
-        fn();
+    return job;
+}
 
+WorkerJob* JobQueueWorker::StealFromGroup(const JobGroup* group)
+{
+    WorkerJob* job = nullptr;
+
+    LockGuard<Spinlock> guard(lock);
+    for (auto i = jobs.begin(), end = jobs.end(); i != end; ++i)
+    {
+        if ((*i)->group == group)
         {
-            LockGuard<Spinlock> guard(lock);
-            DVASSERT(processingCount > 0);
-            processingCount--;
+            job = *i;
+            jobs.erase(i);
+            break;
         }
-
-        ret = true;
     }
 
-    return ret;
+    return job;
 }
 
 bool JobQueueWorker::IsEmpty()
 {
     LockGuard<Spinlock> guard(lock);
-    return (nextPopIndex == nextPushIndex && 0 == processingCount);
-}
-
-void JobQueueWorker::Signal()
-{
-    LockGuard<Mutex> guard(jobsInQueueMutex);
-    jobsInQueueCV.NotifyOne();
-}
-
-void JobQueueWorker::Broadcast()
-{
-    LockGuard<Mutex> guard(jobsInQueueMutex);
-    jobsInQueueCV.NotifyAll();
-}
-
-void JobQueueWorker::Wait()
-{
-    UniqueLock<Mutex> lock(jobsInQueueMutex);
-    jobsInQueueCV.Wait(lock);
+    return jobs.empty();
 }
 }
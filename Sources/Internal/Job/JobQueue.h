@@ -2,37 +2,46 @@
 
 #include "Base/BaseTypes.h"
 #include "Functional/Function.h"
-#include "Concurrency/ConditionVariable.h"
-#include "Concurrency/Mutex.h"
+#include "Concurrency/Atomic.h"
 #include "Concurrency/Spinlock.h"
 
 namespace DAVA
 {
+class JobGroup;
+
+/*! Single worker job. Job is considered finished when its function was executed
+    and all its child jobs are finished.
+*/
+struct WorkerJob
+{
+    Function<void()> fn;
+    JobGroup* group = nullptr;
+    WorkerJob* parent = nullptr;
+    Atomic<int32> unfinishedCount; ///< 1 for job itself + count of unfinished children
+};
+
+/*! Per-thread queue of worker jobs.
+    Owner thread pushes and pops jobs from the back (LIFO, hot in cache), other threads steal
+    jobs from the front (FIFO, oldest and usually the biggest pieces of work).
+*/
 class JobQueueWorker
 {
 public:
-    JobQueueWorker(uint32 maxCount = 1024);
-    virtual ~JobQueueWorker();
+    JobQueueWorker() = default;
+    JobQueueWorker(const JobQueueWorker&) = delete;
+    JobQueueWorker& operator=(const JobQueueWorker&) = delete;
 
-    void Push(const Function<void()>& fn);
-    bool PopAndExec();
+    void Push(WorkerJob* job);
+    WorkerJob* Pop();
+    WorkerJob* Steal();
 
-    bool IsEmpty();
+    /*! Steal the oldest job that belongs to given `group`. Used by threads waiting for the group. */
+    WorkerJob* StealFromGroup(const JobGroup* group);
 
-    void Signal();
-    void Broadcast();
-    void Wait();
+    bool IsEmpty();
 
 protected:
-    uint32 jobsMaxCount;
-    Function<void()>* jobs;
-
-    uint32 nextPushIndex;
-    uint32 nextPopIndex;
-    int32 processingCount;
-
     Spinlock lock;
-    ConditionVariable jobsInQueueCV;
-    Mutex jobsInQueueMutex;
+    Deque<WorkerJob*> jobs;
 };
 }
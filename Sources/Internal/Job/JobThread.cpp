@@ -1,10 +1,21 @@
-#include "JobThread.h"
+#include "Job/JobThread.h"
+#include "Job/JobManager.h"
+#include "Concurrency/ThreadLocalPtr.h"
 
 namespace DAVA
 {
-JobThread::JobThread(JobQueueWorker* _workerQueue, Semaphore* _workerDoneSem)
-    : workerQueue(_workerQueue)
-    , workerDoneSem(_workerDoneSem)
+namespace JobThreadDetails
+{
+void KeepJobThread(JobThread*)
+{
+}
+
+ThreadLocalPtr<JobThread> currentJobThread(&KeepJobThread);
+}
+
+JobThread::JobThread(JobManager* _jobManager, uint32 _workerIndex)
+    : jobManager(_jobManager)
+    , workerIndex(_workerIndex)
     , threadCancel(false)
     , threadFinished(false)
 {
@@ -16,10 +27,10 @@ JobThread::JobThread(JobQueueWorker* _workerQueue, Semaphore* _workerDoneSem)
 JobThread::~JobThread()
 {
     // cancel thread
-    threadCancel = true;
+    Cancel();
     while (!threadFinished)
     {
-        workerQueue->Broadcast();
+        jobManager->WakeUpWorkers(1);
         Thread::Sleep(10); // sleep 10 ms until other check
     }
 
@@ -28,21 +39,36 @@ JobThread::~JobThread()
     SafeRelease(thread);
 }
 
+void JobThread::Cancel()
+{
+    threadCancel = true;
+}
+
+JobThread* JobThread::GetCurrent()
+{
+    return JobThreadDetails::currentJobThread.Get();
+}
+
 void JobThread::ThreadFunc()
 {
+    JobThreadDetails::currentJobThread.Reset(this);
+
     while (!threadCancel)
     {
-        workerQueue->Wait();
-
-        while (workerQueue->PopAndExec())
+        // take job from own queue or steal it from others,
+        // sleep only if there is nothing to do at all
+        WorkerJob* job = jobManager->FindWorkerJob(workerIndex);
+        if (nullptr != job)
         {
+            jobManager->ExecuteWorkerJob(job);
+        }
+        else
+        {
+            jobManager->WaitQueuedWorkerJobs();
         }
-
-        workerDoneSem->Post();
     }
 
+    JobThreadDetails::currentJobThread.Release();
     threadFinished = true;
 }
-
 };
-;
\ No newline at end of file
@@ -1,26 +1,42 @@
 #pragma once
 
-#include "Concurrency/Semaphore.h"
+#include "Base/BaseTypes.h"
 #include "Concurrency/Thread.h"
-#include "JobQueue.h"
 
 namespace DAVA
 {
+class JobManager;
 class JobThread
 {
 public:
-    JobThread(JobQueueWorker* workerQueue, Semaphore* workerDoneSem);
+    JobThread(JobManager* jobManager, uint32 workerIndex);
     ~JobThread();
 
     void Cancel();
 
+    /*! Returns JobThread that is running in the current thread or nullptr if current thread isn't a JobThread. */
+    static JobThread* GetCurrent();
+
+    JobManager* GetJobManager() const;
+    uint32 GetWorkerIndex() const;
+
 protected:
     Thread* thread;
-    JobQueueWorker* workerQueue;
-    Semaphore* workerDoneSem;
+    JobManager* jobManager;
+    uint32 workerIndex;
     volatile bool threadCancel;
     volatile bool threadFinished;
 
     void ThreadFunc();
 };
+
+inline JobManager* JobThread::GetJobManager() const
+{
+    return jobManager;
+}
+
+inline uint32 JobThread::GetWorkerIndex() const
+{
+    return workerIndex;
+}
 }
@@ -91,7 +91,7 @@ void ParticleDebugRenderPass::PrepareParticlesVisibilityArray(Camera* camera, Re
         currVisibilityCriteria &= ~RenderObject::VISIBLE_STATIC_OCCLUSION;
 
     visibilityArray.clear();
-    renderSystem->GetRenderHierarchy()->Clip(camera, visibilityArray, currVisibilityCriteria);
+    renderSystem->Clip(camera, visibilityArray, currVisibilityCriteria);
     visibilityArray.erase(std::remove_if(visibilityArray.begin(), visibilityArray.end(),
                                          [this](RenderObject* obj)
                                          {
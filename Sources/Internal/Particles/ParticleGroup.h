@@ -2,7 +2,8 @@
 
 #include "ParticleEmitter.h"
 #include "ParticleLayer.h"
-#include "Particle.h"
+#include "ParticlePool.h"
+#include "ParticlesRandom.h"
 #include "Render/Material/NMaterial.h"
 
 namespace DAVA
@@ -42,7 +43,7 @@ struct ParticleGroup
     ParticleEmitter* emitter = nullptr;
     ParticleLayer* layer = nullptr;
     NMaterial* material = nullptr;
-    Particle* head = nullptr;
+    ParticlePool particles;
 
     Vector3 spawnPosition;
 
@@ -56,9 +57,11 @@ struct ParticleGroup
     float32 particlesToGenerate = 0.0f;
 
     uint16 particlesGenerated = 0;
+    uint32 randomSequenceOffset = 0; // offset of group in low discrepancy sequences of emitter positions
 
     bool finishingGroup = false;
     bool visibleLod = true;
+    bool materialPending = false; // group is started during parallel update, material is acquired after it
 
     StripeData stripe;
 };
@@ -73,5 +76,6 @@ struct ParticleEffectData
 {
     Vector<ParentInfo> infoSources;
     List<ParticleGroup> groups;
+    ParticlesRandom::Generator random;
 };
 }
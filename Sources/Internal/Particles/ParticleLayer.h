@@ -6,7 +6,6 @@
 #include "Render/2D/Sprite.h"
 
 #include "FileSystem/YamlParser.h"
-#include "Particles/Particle.h"
 #include "Particles/ParticleForceSimplified.h"
 #include "Particles/ParticlePropertyLine.h"
 #include "FileSystem/FilePath.h"
@@ -0,0 +1,273 @@
+#include "Particles/ParticlePool.h"
+
+#include "Debug/DVAssert.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define DAVA_PARTICLES_SSE
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define DAVA_PARTICLES_NEON
+#include <arm_neon.h>
+#endif
+
+namespace DAVA
+{
+template <typename Fn>
+void ParticlePool::ForEachArray(Fn fn)
+{
+    fn(positionX);
+    fn(positionY);
+    fn(positionZ);
+    fn(speedX);
+    fn(speedY);
+    fn(speedZ);
+    fn(life);
+    fn(lifeTime);
+    fn(angle);
+    fn(spin);
+    fn(baseSize);
+    fn(currSize);
+    fn(currRadius);
+    fn(color);
+    fn(frame);
+    fn(animTime);
+    fn(currFlowSpeed);
+    fn(currFlowOffset);
+    fn(baseNoiseScale);
+    fn(currNoiseScale);
+    fn(baseNoiseUScrollSpeed);
+    fn(currNoiseUOffset);
+    fn(baseNoiseVScrollSpeed);
+    fn(currNoiseVOffset);
+    fn(alphaRemap);
+    fn(positionTarget);
+    fn(seed);
+}
+
+uint32 ParticlePool::Add()
+{
+    ForEachArray([](auto& values) {
+        values.emplace_back();
+    });
+    return count++;
+}
+
+void ParticlePool::Remove(uint32 index)
+{
+    DVASSERT(index < count);
+
+    uint32 last = count - 1;
+    ForEachArray([index, last](auto& values) {
+        values[index] = values[last];
+        values.pop_back();
+    });
+    --count;
+}
+
+void ParticlePool::Clear()
+{
+    ForEachArray([](auto& values) {
+        values.clear();
+    });
+    count = 0;
+}
+
+namespace ParticleKernels
+{
+void Add(float32* values, float32 delta, uint32 count)
+{
+    uint32 i = 0;
+
+#if defined(DAVA_PARTICLES_SSE)
+    const __m128 d = _mm_set1_ps(delta);
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(values + i, _mm_add_ps(_mm_loadu_ps(values + i), d));
+    }
+#elif defined(DAVA_PARTICLES_NEON)
+    const float32x4_t d = vdupq_n_f32(delta);
+    for (; i + 4 <= count; i += 4)
+    {
+        vst1q_f32(values + i, vaddq_f32(vld1q_f32(values + i), d));
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        values[i] += delta;
+    }
+}
+
+void MultiplyAdd(float32* values, const float32* deltas, float32 scale, uint32 count)
+{
+    uint32 i = 0;
+
+// multiply and add separately to get the same rounding as scalar code
+#if defined(DAVA_PARTICLES_SSE)
+    const __m128 s = _mm_set1_ps(scale);
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(values + i, _mm_add_ps(_mm_loadu_ps(values + i), _mm_mul_ps(_mm_loadu_ps(deltas + i), s)));
+    }
+#elif defined(DAVA_PARTICLES_NEON)
+    const float32x4_t s = vdupq_n_f32(scale);
+    for (; i + 4 <= count; i += 4)
+    {
+        vst1q_f32(values + i, vaddq_f32(vld1q_f32(values + i), vmulq_f32(vld1q_f32(deltas + i), s)));
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        values[i] += deltas[i] * scale;
+    }
+}
+
+void MultiplyAdd(float32* values, const float32* deltas, const float32* scales, uint32 count)
+{
+    uint32 i = 0;
+
+#if defined(DAVA_PARTICLES_SSE)
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(values + i, _mm_add_ps(_mm_loadu_ps(values + i), _mm_mul_ps(_mm_loadu_ps(deltas + i), _mm_loadu_ps(scales + i))));
+    }
+#elif defined(DAVA_PARTICLES_NEON)
+    for (; i + 4 <= count; i += 4)
+    {
+        vst1q_f32(values + i, vaddq_f32(vld1q_f32(values + i), vmulq_f32(vld1q_f32(deltas + i), vld1q_f32(scales + i))));
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        values[i] += deltas[i] * scales[i];
+    }
+}
+
+void Divide(float32* result, const float32* dividends, const float32* divisors, uint32 count)
+{
+    uint32 i = 0;
+
+#if defined(DAVA_PARTICLES_SSE)
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(result + i, _mm_div_ps(_mm_loadu_ps(dividends + i), _mm_loadu_ps(divisors + i)));
+    }
+#endif
+    // NEON has no precise division, so scalar loop is used
+
+    for (; i < count; ++i)
+    {
+        result[i] = dividends[i] / divisors[i];
+    }
+}
+
+void AddCubesToBox(const float32* x, const float32* y, const float32* z, const float32* radius, uint32 count, AABBox3& bbox)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    Vector3 minPoint(x[0] - radius[0], y[0] - radius[0], z[0] - radius[0]);
+    Vector3 maxPoint(x[0] + radius[0], y[0] + radius[0], z[0] + radius[0]);
+    uint32 i = 1;
+
+#if defined(DAVA_PARTICLES_SSE)
+    if (count >= 5)
+    {
+        __m128 minX = _mm_set1_ps(minPoint.x);
+        __m128 minY = _mm_set1_ps(minPoint.y);
+        __m128 minZ = _mm_set1_ps(minPoint.z);
+        __m128 maxX = _mm_set1_ps(maxPoint.x);
+        __m128 maxY = _mm_set1_ps(maxPoint.y);
+        __m128 maxZ = _mm_set1_ps(maxPoint.z);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 r = _mm_loadu_ps(radius + i);
+            __m128 px = _mm_loadu_ps(x + i);
+            __m128 py = _mm_loadu_ps(y + i);
+            __m128 pz = _mm_loadu_ps(z + i);
+            minX = _mm_min_ps(minX, _mm_sub_ps(px, r));
+            minY = _mm_min_ps(minY, _mm_sub_ps(py, r));
+            minZ = _mm_min_ps(minZ, _mm_sub_ps(pz, r));
+            maxX = _mm_max_ps(maxX, _mm_add_ps(px, r));
+            maxY = _mm_max_ps(maxY, _mm_add_ps(py, r));
+            maxZ = _mm_max_ps(maxZ, _mm_add_ps(pz, r));
+        }
+
+        alignas(16) float32 lanes[6][4];
+        _mm_store_ps(lanes[0], minX);
+        _mm_store_ps(lanes[1], minY);
+        _mm_store_ps(lanes[2], minZ);
+        _mm_store_ps(lanes[3], maxX);
+        _mm_store_ps(lanes[4], maxY);
+        _mm_store_ps(lanes[5], maxZ);
+        for (uint32 k = 0; k < 4; ++k)
+        {
+            minPoint.x = Min(minPoint.x, lanes[0][k]);
+            minPoint.y = Min(minPoint.y, lanes[1][k]);
+            minPoint.z = Min(minPoint.z, lanes[2][k]);
+            maxPoint.x = Max(maxPoint.x, lanes[3][k]);
+            maxPoint.y = Max(maxPoint.y, lanes[4][k]);
+            maxPoint.z = Max(maxPoint.z, lanes[5][k]);
+        }
+    }
+#elif defined(DAVA_PARTICLES_NEON)
+    if (count >= 5)
+    {
+        float32x4_t minX = vdupq_n_f32(minPoint.x);
+        float32x4_t minY = vdupq_n_f32(minPoint.y);
+        float32x4_t minZ = vdupq_n_f32(minPoint.z);
+        float32x4_t maxX = vdupq_n_f32(maxPoint.x);
+        float32x4_t maxY = vdupq_n_f32(maxPoint.y);
+        float32x4_t maxZ = vdupq_n_f32(maxPoint.z);
+        for (; i + 4 <= count; i += 4)
+        {
+            float32x4_t r = vld1q_f32(radius + i);
+            float32x4_t px = vld1q_f32(x + i);
+            float32x4_t py = vld1q_f32(y + i);
+            float32x4_t pz = vld1q_f32(z + i);
+            minX = vminq_f32(minX, vsubq_f32(px, r));
+            minY = vminq_f32(minY, vsubq_f32(py, r));
+            minZ = vminq_f32(minZ, vsubq_f32(pz, r));
+            maxX = vmaxq_f32(maxX, vaddq_f32(px, r));
+            maxY = vmaxq_f32(maxY, vaddq_f32(py, r));
+            maxZ = vmaxq_f32(maxZ, vaddq_f32(pz, r));
+        }
+
+        float32 lanes[6][4];
+        vst1q_f32(lanes[0], minX);
+        vst1q_f32(lanes[1], minY);
+        vst1q_f32(lanes[2], minZ);
+        vst1q_f32(lanes[3], maxX);
+        vst1q_f32(lanes[4], maxY);
+        vst1q_f32(lanes[5], maxZ);
+        for (uint32 k = 0; k < 4; ++k)
+        {
+            minPoint.x = Min(minPoint.x, lanes[0][k]);
+            minPoint.y = Min(minPoint.y, lanes[1][k]);
+            minPoint.z = Min(minPoint.z, lanes[2][k]);
+            maxPoint.x = Max(maxPoint.x, lanes[3][k]);
+            maxPoint.y = Max(maxPoint.y, lanes[4][k]);
+            maxPoint.z = Max(maxPoint.z, lanes[5][k]);
+        }
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        minPoint.x = Min(minPoint.x, x[i] - radius[i]);
+        minPoint.y = Min(minPoint.y, y[i] - radius[i]);
+        minPoint.z = Min(minPoint.z, z[i] - radius[i]);
+        maxPoint.x = Max(maxPoint.x, x[i] + radius[i]);
+        maxPoint.y = Max(maxPoint.y, y[i] + radius[i]);
+        maxPoint.z = Max(maxPoint.z, z[i] + radius[i]);
+    }
+
+    bbox.AddPoint(minPoint);
+    bbox.AddPoint(maxPoint);
+}
+}
+}
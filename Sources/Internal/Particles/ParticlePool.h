@@ -0,0 +1,135 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+#include "Base/BaseMath.h"
+#include "Math/AABBox3.h"
+
+namespace DAVA
+{
+/**
+    Particles of one ParticleGroup in structure-of-arrays layout.
+    Values of particle `i` are stored at index `i` of each array, so simulation kernels process
+    tightly packed values of all particles of group at once.
+    Particle is removed by moving the last particle to its place, so order of particles is not preserved.
+*/
+class ParticlePool final
+{
+public:
+    /** Append particle with default values. Returns index of the particle. */
+    uint32 Add();
+    /** Remove particle `index`, the last particle gets its index. */
+    void Remove(uint32 index);
+    void Clear();
+
+    uint32 GetCount() const;
+    bool IsEmpty() const;
+
+    Vector3 GetPosition(uint32 index) const;
+    void SetPosition(uint32 index, const Vector3& position);
+    Vector3 GetSpeed(uint32 index) const;
+    void SetSpeed(uint32 index, const Vector3& speed);
+
+    /** Mark particle as dead, it will be removed on next update. */
+    void Kill(uint32 index);
+
+    Vector<float32> positionX;
+    Vector<float32> positionY;
+    Vector<float32> positionZ;
+    Vector<float32> speedX;
+    Vector<float32> speedY;
+    Vector<float32> speedZ;
+
+    Vector<float32> life;
+    Vector<float32> lifeTime;
+
+    Vector<float32> angle;
+    Vector<float32> spin;
+
+    Vector<Vector2> baseSize;
+    Vector<Vector2> currSize;
+    Vector<float32> currRadius; //for bbox computation
+
+    Vector<Color> color;
+
+    Vector<int32> frame;
+    Vector<float32> animTime;
+
+    Vector<float32> currFlowSpeed;
+    Vector<float32> currFlowOffset;
+
+    Vector<float32> baseNoiseScale;
+    Vector<float32> currNoiseScale;
+    Vector<float32> baseNoiseUScrollSpeed;
+    Vector<float32> currNoiseUOffset;
+    Vector<float32> baseNoiseVScrollSpeed;
+    Vector<float32> currNoiseVOffset;
+
+    Vector<float32> alphaRemap;
+
+    Vector<int32> positionTarget; //superemitter particles only
+    Vector<uint32> seed; //random number of particle, used by forces to vary their effect between particles
+
+private:
+    template <typename Fn>
+    void ForEachArray(Fn fn);
+
+    uint32 count = 0;
+};
+
+/**
+    Simulation kernels for arrays of particle values, vectorized with SSE or NEON when available.
+    All kernels process elements in range [0, count).
+*/
+namespace ParticleKernels
+{
+/** values[i] += delta */
+void Add(float32* values, float32 delta, uint32 count);
+/** values[i] += deltas[i] * scale */
+void MultiplyAdd(float32* values, const float32* deltas, float32 scale, uint32 count);
+/** values[i] += deltas[i] * scales[i] */
+void MultiplyAdd(float32* values, const float32* deltas, const float32* scales, uint32 count);
+/** result[i] = dividends[i] / divisors[i] */
+void Divide(float32* result, const float32* dividends, const float32* divisors, uint32 count);
+/** Extend `bbox` by cubes with centers (x[i], y[i], z[i]) and half sizes radius[i]. */
+void AddCubesToBox(const float32* x, const float32* y, const float32* z, const float32* radius, uint32 count, AABBox3& bbox);
+}
+
+inline uint32 ParticlePool::GetCount() const
+{
+    return count;
+}
+
+inline bool ParticlePool::IsEmpty() const
+{
+    return count == 0;
+}
+
+inline Vector3 ParticlePool::GetPosition(uint32 index) const
+{
+    return Vector3(positionX[index], positionY[index], positionZ[index]);
+}
+
+inline void ParticlePool::SetPosition(uint32 index, const Vector3& position)
+{
+    positionX[index] = position.x;
+    positionY[index] = position.y;
+    positionZ[index] = position.z;
+}
+
+inline Vector3 ParticlePool::GetSpeed(uint32 index) const
+{
+    return Vector3(speedX[index], speedY[index], speedZ[index]);
+}
+
+inline void ParticlePool::SetSpeed(uint32 index, const Vector3& speed)
+{
+    speedX[index] = speed.x;
+    speedY[index] = speed.y;
+    speedZ[index] = speed.z;
+}
+
+inline void ParticlePool::Kill(uint32 index)
+{
+    life[index] = lifeTime[index] + 0.1f;
+}
+}
@@ -12,6 +12,18 @@ ParticleRenderObject::ParticleRenderObject(ParticleEffectData* effect)
     , sortingOffset(15)
 {
     AddFlag(RenderObject::CUSTOM_PREPARE_TO_RENDER);
+    AddFlag(RenderObject::DEFERRED_RENDER_DATA);
+
+    basisVectors[8] = Vector3(0, 1, 0);
+    basisVectors[9] = Vector3(0, 0, 1);
+    basisVectors[10] = Vector3(1, 0, 0);
+    basisVectors[11] = Vector3(0, 0, 1);
+    basisVectors[12] = Vector3(0, 1, 0);
+    basisVectors[13] = Vector3(1, 0, 0);
+
+    stripeBasisVectors[4] = Vector3(1, 0, 0);
+    stripeBasisVectors[5] = Vector3(0, 1, 0);
+    stripeBasisVectors[6] = Vector3(0, 0, 1);
 
     layoutsData[1 << FRAME_BLEND] = { rhi::VS_TEXCOORD, 1, rhi::VDT_FLOAT, 3 };
     layoutsData[1 << FLOW] = { rhi::VS_TEXCOORD, 2, rhi::VDT_FLOAT, 4 }; // uv, speed, offset
@@ -53,6 +65,16 @@ ParticleRenderObject::~ParticleRenderObject()
 
 void ParticleRenderObject::PrepareToRender(Camera* camera)
 {
+    ReserveRenderData(camera);
+    FillRenderData();
+}
+
+void ParticleRenderObject::ReserveRenderData(Camera* camera)
+{
+    quadsRanges.clear();
+    quadsRuns.clear();
+    stripesBuffers.clear();
+
     if (!Renderer::GetOptions()->IsOptionEnabled(RenderOptions::PARTICLES_PREPARE_BUFFERS))
         return;
 
@@ -65,6 +87,19 @@ void ParticleRenderObject::PrepareToRender(Camera* camera)
     }
 }
 
+void ParticleRenderObject::FillRenderData()
+{
+    // Only particles data and buffers reserved by this object are touched here, so different objects are filled concurrently
+    for (const QuadGroupsRun& run : quadsRuns)
+    {
+        FillParticleGroup(run);
+    }
+    for (const StripeBuffers& buffers : stripesBuffers)
+    {
+        FillStripeParticle(buffers);
+    }
+}
+
 void ParticleRenderObject::SetSortingOffset(uint32 offset)
 {
     sortingOffset = offset;
@@ -74,21 +109,12 @@ void ParticleRenderObject::SetSortingOffset(uint32 offset)
 
 void ParticleRenderObject::PrepareRenderData(Camera* camera)
 {
-    //camera_facing, x_emitter, y_emitter, z_emitter, x_world, y_world, z_world
-    static Vector3 basisVectors[7 * 2] = { Vector3(), Vector3(),
-                                           Vector3(), Vector3(),
-                                           Vector3(), Vector3(),
-                                           Vector3(), Vector3(),
-                                           Vector3(0, 1, 0), Vector3(0, 0, 1),
-                                           Vector3(1, 0, 0), Vector3(0, 0, 1),
-                                           Vector3(0, 1, 0), Vector3(1, 0, 0) };
-
     activeRenderBatchArray.clear();
     currRenderBatchId = 0;
 
     DVASSERT(worldTransform);
 
-    Vector3 currCamDirection = camera->GetDirection();
+    cameraDirection = camera->GetDirection();
 
     /*prepare effect basises*/
     const Matrix4& mv = camera->GetMatrix();
@@ -109,13 +135,6 @@ void ParticleRenderObject::PrepareRenderData(Camera* camera)
     basisVectors[6] = ey;
     basisVectors[7] = ex;
 
-    static Vector3 stripeBasisVectors[7] = { Vector3(),
-                                             Vector3(),
-                                             Vector3(),
-                                             Vector3(),
-                                             Vector3(1, 0, 0),
-                                             Vector3(0, 1, 0),
-                                             Vector3(0, 0, 1) };
     stripeBasisVectors[0] = basisVectors[0];
     stripeBasisVectors[1] = ex;
     stripeBasisVectors[2] = ey;
@@ -135,9 +154,9 @@ void ParticleRenderObject::PrepareRenderData(Camera* camera)
         if (itGroupStart->material != itGroupCurr->material || isLayerTypesDifferent)
         {
             if (itGroupStart->layer->type == ParticleLayer::TYPE_PARTICLE_STRIPE)
-                AppendStripeParticle(itGroupStart, itGroupCurr, camera, stripeBasisVectors);
+                ReserveStripeParticles(itGroupStart, itGroupCurr);
             else
-                AppendParticleGroup(itGroupStart, itGroupCurr, particlesInGroup, camera->GetDirection(), basisVectors);
+                ReserveParticleGroup(itGroupStart, itGroupCurr, particlesInGroup);
             itGroupStart = itGroupCurr;
             particlesInGroup = 0;
         }
@@ -146,13 +165,13 @@ void ParticleRenderObject::PrepareRenderData(Camera* camera)
     if (itGroupStart != effectData->groups.end())
     {
         if (itGroupStart->layer->type == ParticleLayer::TYPE_PARTICLE_STRIPE)
-            AppendStripeParticle(itGroupStart, effectData->groups.end(), camera, stripeBasisVectors);
+            ReserveStripeParticles(itGroupStart, effectData->groups.end());
         else
-            AppendParticleGroup(itGroupStart, effectData->groups.end(), particlesInGroup, camera->GetDirection(), basisVectors);
+            ReserveParticleGroup(itGroupStart, effectData->groups.end(), particlesInGroup);
     }
 }
 
-uint32 ParticleRenderObject::GetVertexStride(ParticleLayer* layer)
+uint32 ParticleRenderObject::GetVertexStride(ParticleLayer* layer) const
 {
     uint32 vertexStride = (3 + 2 + 1) * sizeof(float); // vertex*3 + texcoord0*2 + color * 1;
     if (layer->enableFrameBlend && layer->type != ParticleLayer::TYPE_PARTICLE_STRIPE)
@@ -191,7 +210,7 @@ uint32 ParticleRenderObject::SelectLayout(const ParticleLayer& layer)
     return layoutMap[key];
 }
 
-void ParticleRenderObject::UpdateStripeVertex(float32*& dataPtr, Vector3& position, Vector3& uv, float32* color, ParticleLayer* layer, Particle* particle, float32 fresToAlpha)
+void ParticleRenderObject::UpdateStripeVertex(float32*& dataPtr, Vector3& position, Vector3& uv, float32* color, ParticleLayer* layer, const ParticlePool& particles, uint32 index, float32 fresToAlpha)
 {
     *dataPtr++ = position.x;
     *dataPtr++ = position.y;
@@ -206,28 +225,28 @@ void ParticleRenderObject::UpdateStripeVertex(float32*& dataPtr, Vector3& positi
     {
         *dataPtr++ = uv.x;
         *dataPtr++ = uv.y;
-        *dataPtr++ = particle->currFlowSpeed;
-        *dataPtr++ = particle->currFlowOffset;
+        *dataPtr++ = particles.currFlowSpeed[index];
+        *dataPtr++ = particles.currFlowOffset[index];
     }
     if (layer->enableNoise && layer->noise.get() != nullptr)
     {
         float32 offsetU = uv.x;
         if (layer->enableNoiseScroll)
-            offsetU += layer->usePerspectiveMapping ? particle->currNoiseUOffset * uv.z : particle->currNoiseUOffset;
+            offsetU += layer->usePerspectiveMapping ? particles.currNoiseUOffset[index] * uv.z : particles.currNoiseUOffset[index];
 
         *dataPtr++ = offsetU;
 
         float32 offsetV = uv.y;
         if (layer->enableNoiseScroll)
-            offsetV += layer->usePerspectiveMapping ? particle->currNoiseVOffset * uv.z : particle->currNoiseVOffset;
+            offsetV += layer->usePerspectiveMapping ? particles.currNoiseVOffset[index] * uv.z : particles.currNoiseVOffset[index];
         *dataPtr++ = offsetV;
 
-        *dataPtr++ = particle->currNoiseScale;
+        *dataPtr++ = particles.currNoiseScale[index];
     }
     if (layer->enableAlphaRemap || layer->usePerspectiveMapping || layer->useFresnelToAlpha)
     {
         *dataPtr++ = fresToAlpha;
-        *dataPtr++ = particle->alphaRemap;
+        *dataPtr++ = particles.alphaRemap[index];
         *dataPtr++ = uv.z;
     }
 }
@@ -247,6 +266,14 @@ int32 ParticleRenderObject::PrepareBasisIndexes(const ParticleGroup& group, int3
     return basisCount;
 }
 
+int32 ParticleRenderObject::PrepareStripeBasisIndexes(const ParticleGroup& group, int32(&basises)[4]) const
+{
+    int32 basisCount = PrepareBasisIndexes(group, basises);
+    if (group.layer->particleOrientation & ParticleLayer::PARTICLE_ORIENTATION_CAMERA_FACING_STRIPE_SPHERICAL)
+        ++basisCount;
+    return basisCount;
+}
+
 void ParticleRenderObject::AppendRenderBatch(NMaterial* material, uint32 indexCount, uint32 vertexLayout, const DynamicBufferAllocator::AllocResultVB& vBuffer)
 {
     AppendRenderBatch(material, indexCount, vertexLayout, vBuffer, DynamicBufferAllocator::AllocateQuadListIndexBuffer(indexCount), 0);
@@ -281,24 +308,58 @@ void ParticleRenderObject::AppendRenderBatch(NMaterial* material, uint32 indexCo
     currRenderBatchId++;
 }
 
-void ParticleRenderObject::AppendParticleGroup(List<ParticleGroup>::iterator begin, List<ParticleGroup>::iterator end, uint32 particlesCount, const Vector3& cameraDirection, Vector3* basisVectors)
+void ParticleRenderObject::ReserveParticleGroup(List<ParticleGroup>::iterator begin, List<ParticleGroup>::iterator end, uint32 particlesCount)
 {
     if (!particlesCount)
         return; //hmmm?
 
     uint32 vertexStride = GetVertexStride(begin->layer); // If you change vertex layout, don't forget to change the stride.
+    uint32 vLayout = SelectLayout(*begin->layer);
 
-    uint32 verteciesToAllocate = particlesCount * 4;
-    DynamicBufferAllocator::AllocResultVB target = DynamicBufferAllocator::AllocateVertexBuffer(vertexStride, verteciesToAllocate);
-    uint8* currpos = target.data;
+    if (begin->material && begin->layer->useThreePointGradient)
+        SetupThreePontGradient(*begin, begin->material);
 
-    uint32 verteciesAppended = 0;
+    QuadGroupsRun run;
+    run.begin = begin;
+    run.end = end;
+    run.firstRange = static_cast<uint32>(quadsRanges.size());
+
+    // allocator may return less vertices than requested, so each allocated part gets its own batch
+    uint32 quadsToAllocate = particlesCount;
+    while (quadsToAllocate > 0)
+    {
+        DynamicBufferAllocator::AllocResultVB target = DynamicBufferAllocator::AllocateVertexBuffer(vertexStride, quadsToAllocate * 4);
+        uint32 quadsCount = Min(target.allocatedVertices / 4, quadsToAllocate);
+        if (quadsCount == 0)
+        {
+            DVASSERT(false, "Dynamic vertex buffer can't fit single particle");
+            break;
+        }
+
+        AppendRenderBatch(begin->material, quadsCount * 6, vLayout, target);
+        quadsRanges.push_back({ target.data, quadsCount });
+        quadsToAllocate -= quadsCount;
+    }
+
+    run.rangesCount = static_cast<uint32>(quadsRanges.size()) - run.firstRange;
+    if (run.rangesCount > 0)
+    {
+        quadsRuns.push_back(run);
+    }
+}
+
+void ParticleRenderObject::FillParticleGroup(const QuadGroupsRun& run)
+{
+    List<ParticleGroup>::iterator begin = run.begin;
+    uint32 vertexStride = GetVertexStride(begin->layer);
     uint32 particleStride = vertexStride * 4;
 
-    if (begin->material && begin->layer->useThreePointGradient)
-        SetupThreePontGradient(*begin, begin->material);
+    uint32 rangeIndex = run.firstRange;
+    uint32 rangesEnd = run.firstRange + run.rangesCount;
+    uint8* currpos = quadsRanges[rangeIndex].data;
+    uint32 quadsLeft = quadsRanges[rangeIndex].quadsCount;
 
-    for (auto it = begin; it != end; ++it)
+    for (auto it = begin; it != run.end; ++it)
     {
         const ParticleGroup& group = *it;
         if (!CheckGroup(group))
@@ -309,31 +370,29 @@ void ParticleRenderObject::AppendParticleGroup(List<ParticleGroup>::iterator beg
         int32 basises[4]; //4 basises max per particle
         basisCount = PrepareBasisIndexes(group, basises);
 
-        Particle* current = group.head;
-        while (current)
+        const ParticlePool& particles = group.particles;
+        for (uint32 p = 0, count = particles.GetCount(); p < count; ++p)
         {
-            float32* pT = group.layer->sprite->GetTextureVerts(current->frame);
-            Color currColor = current->color;
+            float32* pT = group.layer->sprite->GetTextureVerts(particles.frame[p]);
+            Color currColor = particles.color[p];
             if (group.layer->colorOverLife)
-                currColor = group.layer->colorOverLife->GetValue(current->life / current->lifeTime);
+                currColor = group.layer->colorOverLife->GetValue(particles.life[p] / particles.lifeTime[p]);
             if (group.layer->alphaOverLife)
-                currColor.a = group.layer->alphaOverLife->GetValue(current->life / current->lifeTime);
+                currColor.a = group.layer->alphaOverLife->GetValue(particles.life[p] / particles.lifeTime[p]);
             uint32 color = rhi::NativeColorRGBA(currColor.r, currColor.g, currColor.b, Min(currColor.a, 1.0f));
             float32 sin_angle;
             float32 cos_angle;
-            SinCosFast(-current->angle, sin_angle, cos_angle); //- is because artists consider positive rotation to be clockwise
+            SinCosFast(-particles.angle[p], sin_angle, cos_angle); //- is because artists consider positive rotation to be clockwise
 
             for (int32 i = 0; i < basisCount; i++)
             {
-                if (verteciesAppended + 4 > target.allocatedVertices)
+                if (quadsLeft == 0)
                 {
-                    uint32 vLayout = SelectLayout(*group.layer);
-                    AppendRenderBatch(group.material, verteciesAppended / 4 * 6, vLayout, target);
-                    verteciesToAllocate -= verteciesAppended;
-                    verteciesAppended = 0;
+                    if (++rangeIndex == rangesEnd)
+                        return; // particles are counted on reserve, so it shouldn't happen
 
-                    target = DynamicBufferAllocator::AllocateVertexBuffer(vertexStride, verteciesToAllocate);
-                    currpos = target.data;
+                    currpos = quadsRanges[rangeIndex].data;
+                    quadsLeft = quadsRanges[rangeIndex].quadsCount;
                 }
 
                 float32* verts[4];
@@ -347,7 +406,7 @@ void ParticleRenderObject::AppendParticleGroup(List<ParticleGroup>::iterator beg
                 //TODO: rethink this code - it should be easier
                 if (group.layer->isLong) //note that for now it's just a copy of long implementatio - later rethink it;
                 {
-                    ey = current->speed;
+                    ey = particles.GetSpeed(p);
                     float32 vel = ey.Length();
                     float32 base = 0.0f;
                     if (vel < EPSILON)
@@ -373,12 +432,12 @@ void ParticleRenderObject::AppendParticleGroup(List<ParticleGroup>::iterator beg
                     fresnelToAlpha = FresnelShlick(dot, group.layer->fresnelToAlphaBias, group.layer->fresnelToAlphaPower);
                 }
 
-                left *= 0.5f * current->currSize.x * (1 + group.layer->layerPivotPoint.x);
-                right *= 0.5f * current->currSize.x * (1 - group.layer->layerPivotPoint.x);
-                top *= 0.5f * current->currSize.y * (1 + group.layer->layerPivotPoint.y);
-                bot *= 0.5f * current->currSize.y * (1 - group.layer->layerPivotPoint.y);
+                left *= 0.5f * particles.currSize[p].x * (1 + group.layer->layerPivotPoint.x);
+                right *= 0.5f * particles.currSize[p].x * (1 - group.layer->layerPivotPoint.x);
+                top *= 0.5f * particles.currSize[p].y * (1 + group.layer->layerPivotPoint.y);
+                bot *= 0.5f * particles.currSize[p].y * (1 - group.layer->layerPivotPoint.y);
 
-                Vector3 particlePosition = current->position;
+                Vector3 particlePosition = particles.GetPosition(p);
                 if (group.layer->GetInheritPosition())
                     particlePosition += effectData->infoSources[group.positionSource].position;
                 Array<Vector3, 4> quadPos = { particlePosition + left + bot, particlePosition + right + bot, particlePosition + left + top, particlePosition + right + top };
@@ -399,7 +458,7 @@ void ParticleRenderObject::AppendParticleGroup(List<ParticleGroup>::iterator beg
 
                 if (begin->layer->enableFrameBlend)
                 {
-                    int32 nextFrame = current->frame + 1;
+                    int32 nextFrame = particles.frame[p] + 1;
                     if (nextFrame >= group.layer->sprite->GetFrameCount())
                     {
                         if (group.layer->loopSpriteAnimation)
@@ -413,34 +472,34 @@ void ParticleRenderObject::AppendParticleGroup(List<ParticleGroup>::iterator beg
                     {
                         verts[i][ptrOffset] = *(pT++);
                         verts[i][ptrOffset + 1] = *(pT++);
-                        verts[i][ptrOffset + 2] = current->animTime;
+                        verts[i][ptrOffset + 2] = particles.animTime[p];
                     }
                     ptrOffset += 3;
                 }
                 if (begin->layer->enableFlow && begin->layer->flowmap.get() != nullptr)
                 {
-                    float32* flowUV = group.layer->flowmap->GetTextureVerts(current->frame);
+                    float32* flowUV = group.layer->flowmap->GetTextureVerts(particles.frame[p]);
                     for (int32 i = 0; i < 4; i++) // VS_TEXCOORD2.xy, z - speed, w - offset.
                     {
                         verts[i][ptrOffset + 0] = flowUV[i * 2];
                         verts[i][ptrOffset + 1] = flowUV[i * 2 + 1];
-                        verts[i][ptrOffset + 2] = current->currFlowSpeed;
-                        verts[i][ptrOffset + 3] = current->currFlowOffset;
+                        verts[i][ptrOffset + 2] = particles.currFlowSpeed[p];
+                        verts[i][ptrOffset + 3] = particles.currFlowOffset[p];
                     }
                     ptrOffset += 4;
                 }
                 if (begin->layer->enableNoise && begin->layer->noise.get() != nullptr)
                 {
-                    float32* noiseUV = group.layer->noise->GetTextureVerts(current->frame);
+                    float32* noiseUV = group.layer->noise->GetTextureVerts(particles.frame[p]);
                     for (int32 i = 0; i < 4; ++i)
                     {
                         verts[i][ptrOffset + 0] = noiseUV[i * 2]; // VS_TEXCOORD0 xy + color.
                         verts[i][ptrOffset + 1] = noiseUV[i * 2 + 1];
-                        verts[i][ptrOffset + 2] = current->currNoiseScale;
+                        verts[i][ptrOffset + 2] = particles.currNoiseScale[p];
                         if (begin->layer->enableNoiseScroll)
                         {
-                            verts[i][ptrOffset + 0] += current->currNoiseUOffset;
-                            verts[i][ptrOffset + 1] += current->currNoiseVOffset;
+                            verts[i][ptrOffset + 0] += particles.currNoiseUOffset[p];
+                            verts[i][ptrOffset + 1] += particles.currNoiseVOffset[p];
                         }
                     }
                     ptrOffset += 3;
@@ -450,28 +509,23 @@ void ParticleRenderObject::AppendParticleGroup(List<ParticleGroup>::iterator beg
                     for (int32 i = 0; i < 4; ++i)
                     {
                         verts[i][ptrOffset + 0] = fresnelToAlpha;
-                        verts[i][ptrOffset + 1] = current->alphaRemap;
+                        verts[i][ptrOffset + 1] = particles.alphaRemap[p];
                         verts[i][ptrOffset + 2] = 0.0f;
                     }
                     ptrOffset += 3;
                 }
                 currpos += particleStride;
-                verteciesAppended += 4;
+                --quadsLeft;
             }
-            current = current->next;
         }
     }
-
-    if (verteciesAppended)
-    {
-        AppendRenderBatch(begin->material, verteciesAppended / 4 * 6, SelectLayout(*begin->layer), target);
-    }
 }
 
-void ParticleRenderObject::AppendStripeParticle(List<ParticleGroup>::iterator begin, List<ParticleGroup>::iterator end, Camera* camera, Vector3* basisVectors)
+
+void ParticleRenderObject::ReserveStripeParticles(List<ParticleGroup>::iterator begin, List<ParticleGroup>::iterator end)
 {
     uint32 vertexStride = GetVertexStride(begin->layer); // If you change vertex layout, don't forget to change the stride.
-    Vector3 cameraDirection = camera->GetDirection();
+    uint32 vLayout = SelectLayout(*begin->layer);
 
     for (auto it = begin; it != end; ++it)
     {
@@ -479,203 +533,211 @@ void ParticleRenderObject::AppendStripeParticle(List<ParticleGroup>::iterator be
         if (!CheckGroup(group))
             continue; //if no material was set up, or empty group, or layer rendering is disabled or sprite is removed - don't draw anyway
 
-        int32 basisCount = 0;
         int32 basises[4]; //4 basises max per particle
-
-        basisCount = PrepareBasisIndexes(group, basises);
-        if (group.layer->particleOrientation & ParticleLayer::PARTICLE_ORIENTATION_CAMERA_FACING_STRIPE_SPHERICAL)
-            ++basisCount;
-
+        int32 basisCount = PrepareStripeBasisIndexes(group, basises);
         if (basisCount == 0)
             continue;
 
-        Particle* currentParticle = group.head;
-        while (currentParticle)
-        {
-            StripeData& data = group.stripe;
-            if (!data.isActive)
-            {
-                currentParticle = currentParticle->next;
-                continue;
-            }
-
-            float32* pT = group.layer->sprite->GetTextureVerts(currentParticle->frame);
-            Color currColor = currentParticle->color;
-            if (group.layer->colorOverLife)
-                currColor = group.layer->colorOverLife->GetValue(currentParticle->life / currentParticle->lifeTime);
-            if (group.layer->alphaOverLife)
-                currColor.a = group.layer->alphaOverLife->GetValue(currentParticle->life / currentParticle->lifeTime);
-
-            StripeNode& base = data.baseNode;
-            List<StripeNode>& nodes = data.stripeNodes;
-            if (nodes.empty())
-                break;
-
-            int32 vCountInBasis = static_cast<int32>((nodes.size() + 1) * 2);
-            int32 vCount = vCountInBasis * basisCount;
-            uint32 iCount = static_cast<int32>(nodes.size()) * 6 * basisCount;
-            uint32 baseVertex = 0;
+        const StripeData& data = group.stripe;
+        if (!data.isActive || data.stripeNodes.empty())
+            continue;
 
+        uint32 nodesCount = static_cast<uint32>(data.stripeNodes.size());
+        uint32 vCount = (nodesCount + 1) * 2 * basisCount;
+        uint32 iCount = nodesCount * 6 * basisCount;
+        for (uint32 p = 0, count = group.particles.GetCount(); p < count; ++p)
+        {
             DynamicBufferAllocator::AllocResultVB vb = DynamicBufferAllocator::AllocateVertexBuffer(vertexStride, vCount);
             DynamicBufferAllocator::AllocResultIB ib = DynamicBufferAllocator::AllocateIndexBuffer(iCount);
 
-            uint16* indexBufferData = ib.data;
-            float* vertexBufferData = reinterpret_cast<float*>(vb.data);
+            StripeBuffers buffers;
+            buffers.group = &group;
+            buffers.runLayer = begin->layer;
+            buffers.particleIndex = p;
+            buffers.vertices = reinterpret_cast<float32*>(vb.data);
+            buffers.indices = ib.data;
+            stripesBuffers.push_back(buffers);
 
-            for (int32 i = 0; i < basisCount; i++)
-            {
-                float32 height = nodes.back().distanceFromBase;
-                Vector3 basisVector;
-                bool isSphericalBasis = (group.layer->particleOrientation & ParticleLayer::PARTICLE_ORIENTATION_CAMERA_FACING_STRIPE_SPHERICAL) && i == basisCount - 1;
+            AppendRenderBatch(begin->material, iCount, vLayout, vb, ib.buffer, ib.baseIndex);
+        }
+    }
+}
 
-                // We calculating particle basis using only velocity of base vertex. It's good for every real case for now. In the future calculating velocities as (nextNode.position - currentNode.position) can be better.
-                Vector3 stripeSpeed;
-                if (isSphericalBasis || begin->layer->useFresnelToAlpha)
-                    stripeSpeed = GetStripeNormalizedSpeed(data);
+void ParticleRenderObject::FillStripeParticle(const StripeBuffers& buffers)
+{
+    const ParticleGroup& group = *buffers.group;
+    ParticleLayer* runLayer = buffers.runLayer;
+    const ParticlePool& particles = group.particles;
+    const StripeData& data = group.stripe;
+    const StripeNode& base = data.baseNode;
+    const List<StripeNode>& nodes = data.stripeNodes;
+    uint32 p = buffers.particleIndex;
+
+    int32 basises[4]; //4 basises max per particle
+    int32 basisCount = PrepareStripeBasisIndexes(group, basises);
+
+    Color currColor = particles.color[p];
+    if (group.layer->colorOverLife)
+        currColor = group.layer->colorOverLife->GetValue(particles.life[p] / particles.lifeTime[p]);
+    if (group.layer->alphaOverLife)
+        currColor.a = group.layer->alphaOverLife->GetValue(particles.life[p] / particles.lifeTime[p]);
+
+    int32 vCountInBasis = static_cast<int32>((nodes.size() + 1) * 2);
+    uint32 baseVertex = 0;
+
+    uint16* indexBufferData = buffers.indices;
+    float* vertexBufferData = buffers.vertices;
+
+    for (int32 i = 0; i < basisCount; i++)
+    {
+        float32 height = nodes.back().distanceFromBase;
+        Vector3 basisVector;
+        bool isSphericalBasis = (group.layer->particleOrientation & ParticleLayer::PARTICLE_ORIENTATION_CAMERA_FACING_STRIPE_SPHERICAL) && i == basisCount - 1;
 
-                if (isSphericalBasis)
-                {
-                    basisVector = cameraDirection.CrossProduct(stripeSpeed);
-                    basisVector.Normalize();
-                }
-                else
-                {
-                    basisVector = basisVectors[basises[i]];
-                }
+        // We calculating particle basis using only velocity of base vertex. It's good for every real case for now. In the future calculating velocities as (nextNode.position - currentNode.position) can be better.
+        Vector3 stripeSpeed;
+        if (isSphericalBasis || runLayer->useFresnelToAlpha)
+            stripeSpeed = GetStripeNormalizedSpeed(data);
 
-                float32 fresnelToAlpha = 0.0f;
-                if (begin->layer->useFresnelToAlpha)
-                {
-                    Vector3 viewNormal;
-                    float32 dot = 0.0f;
+        if (isSphericalBasis)
+        {
+            basisVector = cameraDirection.CrossProduct(stripeSpeed);
+            basisVector.Normalize();
+        }
+        else
+        {
+            basisVector = stripeBasisVectors[basises[i]];
+        }
 
-                    viewNormal = basisVector.CrossProduct(stripeSpeed);
+        float32 fresnelToAlpha = 0.0f;
+        if (runLayer->useFresnelToAlpha)
+        {
+            Vector3 viewNormal;
+            float32 dot = 0.0f;
 
-                    viewNormal.Normalize();
-                    dot = cameraDirection.DotProduct(viewNormal);
-                    fresnelToAlpha = FresnelShlick(1.0f - Abs(dot), group.layer->fresnelToAlphaBias, group.layer->fresnelToAlphaPower);
-                }
+            viewNormal = basisVector.CrossProduct(stripeSpeed);
 
-                float32 size = group.layer->stripeStartSize * 0.5f;
-                if (group.layer->stripeSizeOverLife)
-                    size *= group.layer->stripeSizeOverLife->GetValue(0.0f);
-                Vector3 scaledBasis = basisVector * size;
-                float32 fullEdgeSize = size + size;
-                Vector3 left = base.position + data.inheritPositionOffset + scaledBasis;
-                Vector3 right = base.position + data.inheritPositionOffset - scaledBasis;
-
-                float32 tile = 1.0f;
-                if (group.layer->stripeTextureTileOverLife)
-                    tile = group.layer->stripeTextureTileOverLife->GetValue(0.0f);
-                float32 startU = currentParticle->life * group.layer->stripeUScrollSpeed;
-                float32 startV = currentParticle->life * group.layer->stripeVScrollSpeed;
-                if (Abs(data.uvOffset) > EPSILON)
-                    startV += data.uvOffset * tile + currentParticle->life * group.layer->stripeVScrollSpeed;
-
-                Vector3 uv1 = Vector3(startU, startV, 0.0f);
-                Vector3 uv2 = Vector3(startU + 1.0f, startV, 0.0f);
-                if (group.layer->usePerspectiveMapping)
-                {
-                    uv1.x *= fullEdgeSize;
-                    uv1.y *= fullEdgeSize;
-                    uv1.z = fullEdgeSize;
+            viewNormal.Normalize();
+            dot = cameraDirection.DotProduct(viewNormal);
+            fresnelToAlpha = FresnelShlick(1.0f - Abs(dot), group.layer->fresnelToAlphaBias, group.layer->fresnelToAlphaPower);
+        }
 
-                    uv2.x *= fullEdgeSize;
-                    uv2.y *= fullEdgeSize;
-                    uv2.z = fullEdgeSize;
-                }
+        float32 size = group.layer->stripeStartSize * 0.5f;
+        if (group.layer->stripeSizeOverLife)
+            size *= group.layer->stripeSizeOverLife->GetValue(0.0f);
+        Vector3 scaledBasis = basisVector * size;
+        float32 fullEdgeSize = size + size;
+        Vector3 left = base.position + data.inheritPositionOffset + scaledBasis;
+        Vector3 right = base.position + data.inheritPositionOffset - scaledBasis;
+
+        float32 tile = 1.0f;
+        if (group.layer->stripeTextureTileOverLife)
+            tile = group.layer->stripeTextureTileOverLife->GetValue(0.0f);
+        float32 startU = particles.life[p] * group.layer->stripeUScrollSpeed;
+        float32 startV = particles.life[p] * group.layer->stripeVScrollSpeed;
+        if (Abs(data.uvOffset) > EPSILON)
+            startV += data.uvOffset * tile + particles.life[p] * group.layer->stripeVScrollSpeed;
+
+        Vector3 uv1 = Vector3(startU, startV, 0.0f);
+        Vector3 uv2 = Vector3(startU + 1.0f, startV, 0.0f);
+        if (group.layer->usePerspectiveMapping)
+        {
+            uv1.x *= fullEdgeSize;
+            uv1.y *= fullEdgeSize;
+            uv1.z = fullEdgeSize;
 
-                Color colOverLife = Color::White;
-                if (group.layer->stripeColorOverLife)
-                    colOverLife = group.layer->stripeColorOverLife->GetValue(0.0f);
+            uv2.x *= fullEdgeSize;
+            uv2.y *= fullEdgeSize;
+            uv2.z = fullEdgeSize;
+        }
 
-                float32 fadeFromTop = 1.0f;
-                float32 distToUp = 0.0f;
-                if (group.layer->stripeFadeDistanceFromTop > EPSILON)
-                {
-                    distToUp = height - base.distanceFromBase;
-                    distToUp = Clamp(distToUp, 0.0f, group.layer->stripeFadeDistanceFromTop);
-                    distToUp = group.layer->stripeFadeDistanceFromTop - distToUp;
-                    fadeFromTop = 1.0f - distToUp / group.layer->stripeFadeDistanceFromTop;
-                }
+        Color colOverLife = Color::White;
+        if (group.layer->stripeColorOverLife)
+            colOverLife = group.layer->stripeColorOverLife->GetValue(0.0f);
 
-                uint32 col = rhi::NativeColorRGBA(Saturate(currColor.r * colOverLife.r), Saturate(currColor.g * colOverLife.g), Saturate(currColor.b * colOverLife.b), Saturate(currColor.a * colOverLife.a * fadeFromTop));
-                float32* color = reinterpret_cast<float32*>(&col);
-                UpdateStripeVertex(vertexBufferData, left, uv1, color, group.layer, currentParticle, fresnelToAlpha);
-                UpdateStripeVertex(vertexBufferData, right, uv2, color, group.layer, currentParticle, fresnelToAlpha);
+        float32 fadeFromTop = 1.0f;
+        float32 distToUp = 0.0f;
+        if (group.layer->stripeFadeDistanceFromTop > EPSILON)
+        {
+            distToUp = height - base.distanceFromBase;
+            distToUp = Clamp(distToUp, 0.0f, group.layer->stripeFadeDistanceFromTop);
+            distToUp = group.layer->stripeFadeDistanceFromTop - distToUp;
+            fadeFromTop = 1.0f - distToUp / group.layer->stripeFadeDistanceFromTop;
+        }
 
-                float32 distance = 0.0f;
+        uint32 col = rhi::NativeColorRGBA(Saturate(currColor.r * colOverLife.r), Saturate(currColor.g * colOverLife.g), Saturate(currColor.b * colOverLife.b), Saturate(currColor.a * colOverLife.a * fadeFromTop));
+        float32* color = reinterpret_cast<float32*>(&col);
+        UpdateStripeVertex(vertexBufferData, left, uv1, color, group.layer, particles, p, fresnelToAlpha);
+        UpdateStripeVertex(vertexBufferData, right, uv2, color, group.layer, particles, p, fresnelToAlpha);
 
-                for (auto& node : nodes)
-                {
-                    if ((group.layer->particleOrientation & ParticleLayer::PARTICLE_ORIENTATION_CAMERA_FACING_STRIPE_SPHERICAL) && i == basisCount - 1)
-                    {
-                        basisVector = cameraDirection.CrossProduct(node.speed);
-                        basisVector.Normalize();
-                    }
+        float32 distance = 0.0f;
 
-                    if (group.layer->stripeFadeDistanceFromTop > EPSILON)
-                    {
-                        distToUp = height - node.distanceFromBase;
-                        distToUp = Clamp(distToUp, 0.0f, group.layer->stripeFadeDistanceFromTop);
-                        distToUp = group.layer->stripeFadeDistanceFromTop - distToUp;
-                        fadeFromTop = 1.0f - distToUp / group.layer->stripeFadeDistanceFromTop;
-                    }
+        for (auto& node : nodes)
+        {
+            if ((group.layer->particleOrientation & ParticleLayer::PARTICLE_ORIENTATION_CAMERA_FACING_STRIPE_SPHERICAL) && i == basisCount - 1)
+            {
+                basisVector = cameraDirection.CrossProduct(node.speed);
+                basisVector.Normalize();
+            }
 
-                    float32 overLifeTime = node.lifeime / group.layer->stripeLifetime;
-                    size = group.layer->stripeStartSize * 0.5f;
-                    if (group.layer->stripeSizeOverLife)
-                        size *= group.layer->stripeSizeOverLife->GetValue(overLifeTime);
-                    fullEdgeSize = size + size;
-                    scaledBasis = basisVector * size;
-                    left = node.position + data.inheritPositionOffset + scaledBasis;
-                    right = node.position + data.inheritPositionOffset - scaledBasis;
+            if (group.layer->stripeFadeDistanceFromTop > EPSILON)
+            {
+                distToUp = height - node.distanceFromBase;
+                distToUp = Clamp(distToUp, 0.0f, group.layer->stripeFadeDistanceFromTop);
+                distToUp = group.layer->stripeFadeDistanceFromTop - distToUp;
+                fadeFromTop = 1.0f - distToUp / group.layer->stripeFadeDistanceFromTop;
+            }
 
-                    colOverLife = Color::White;
-                    if (group.layer->stripeColorOverLife)
-                        colOverLife = group.layer->stripeColorOverLife->GetValue(overLifeTime);
+            float32 overLifeTime = node.lifeime / group.layer->stripeLifetime;
+            size = group.layer->stripeStartSize * 0.5f;
+            if (group.layer->stripeSizeOverLife)
+                size *= group.layer->stripeSizeOverLife->GetValue(overLifeTime);
+            fullEdgeSize = size + size;
+            scaledBasis = basisVector * size;
+            left = node.position + data.inheritPositionOffset + scaledBasis;
+            right = node.position + data.inheritPositionOffset - scaledBasis;
 
-                    col = rhi::NativeColorRGBA(Saturate(currColor.r * colOverLife.r), Saturate(currColor.g * colOverLife.g), Saturate(currColor.b * colOverLife.b), Saturate(currColor.a * colOverLife.a * fadeFromTop));
+            colOverLife = Color::White;
+            if (group.layer->stripeColorOverLife)
+                colOverLife = group.layer->stripeColorOverLife->GetValue(overLifeTime);
 
-                    distance += node.distanceFromPrevNode;
+            col = rhi::NativeColorRGBA(Saturate(currColor.r * colOverLife.r), Saturate(currColor.g * colOverLife.g), Saturate(currColor.b * colOverLife.b), Saturate(currColor.a * colOverLife.a * fadeFromTop));
 
-                    tile = 1.0f;
-                    if (group.layer->stripeTextureTileOverLife)
-                        tile = group.layer->stripeTextureTileOverLife->GetValue(overLifeTime);
-                    float32 v = distance * tile + currentParticle->life * group.layer->stripeVScrollSpeed;
-                    if (Abs(data.uvOffset) > EPSILON)
-                        v += data.uvOffset * tile + currentParticle->life * group.layer->stripeVScrollSpeed;
+            distance += node.distanceFromPrevNode;
 
-                    if (group.layer->usePerspectiveMapping)
-                    {
-                        uv1.x = startU * fullEdgeSize;
-                        v *= fullEdgeSize;
-                        uv1.z = fullEdgeSize;
-                        uv2.x = (startU + 1.0f) * fullEdgeSize;
-                        uv2.z = fullEdgeSize;
-                    }
-                    uv1.y = v;
-                    uv2.y = v;
+            tile = 1.0f;
+            if (group.layer->stripeTextureTileOverLife)
+                tile = group.layer->stripeTextureTileOverLife->GetValue(overLifeTime);
+            float32 v = distance * tile + particles.life[p] * group.layer->stripeVScrollSpeed;
+            if (Abs(data.uvOffset) > EPSILON)
+                v += data.uvOffset * tile + particles.life[p] * group.layer->stripeVScrollSpeed;
 
-                    UpdateStripeVertex(vertexBufferData, left, uv1, color, group.layer, currentParticle, fresnelToAlpha);
-                    UpdateStripeVertex(vertexBufferData, right, uv2, color, group.layer, currentParticle, fresnelToAlpha);
-                }
-                for (uint32 i = 0; i < static_cast<uint32>(nodes.size()); ++i)
-                {
-                    uint32 twoI = i * 2;
-                    *(indexBufferData++) = twoI + 0 + baseVertex;
-                    *(indexBufferData++) = twoI + 3 + baseVertex;
-                    *(indexBufferData++) = twoI + 1 + baseVertex;
-
-                    *(indexBufferData++) = twoI + 0 + baseVertex;
-                    *(indexBufferData++) = twoI + 2 + baseVertex;
-                    *(indexBufferData++) = twoI + 3 + baseVertex;
-                }
-                baseVertex += vCountInBasis;
+            if (group.layer->usePerspectiveMapping)
+            {
+                uv1.x = startU * fullEdgeSize;
+                v *= fullEdgeSize;
+                uv1.z = fullEdgeSize;
+                uv2.x = (startU + 1.0f) * fullEdgeSize;
+                uv2.z = fullEdgeSize;
             }
-            AppendRenderBatch(begin->material, iCount, SelectLayout(*begin->layer), vb, ib.buffer, ib.baseIndex);
-            currentParticle = currentParticle->next;
+            uv1.y = v;
+            uv2.y = v;
+
+            UpdateStripeVertex(vertexBufferData, left, uv1, color, group.layer, particles, p, fresnelToAlpha);
+            UpdateStripeVertex(vertexBufferData, right, uv2, color, group.layer, particles, p, fresnelToAlpha);
+        }
+        for (uint32 i = 0; i < static_cast<uint32>(nodes.size()); ++i)
+        {
+            uint32 twoI = i * 2;
+            *(indexBufferData++) = twoI + 0 + baseVertex;
+            *(indexBufferData++) = twoI + 3 + baseVertex;
+            *(indexBufferData++) = twoI + 1 + baseVertex;
+
+            *(indexBufferData++) = twoI + 0 + baseVertex;
+            *(indexBufferData++) = twoI + 2 + baseVertex;
+            *(indexBufferData++) = twoI + 3 + baseVertex;
         }
+        baseVertex += vCountInBasis;
     }
 }
 
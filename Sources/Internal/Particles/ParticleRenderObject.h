@@ -19,8 +19,8 @@ class ParticleRenderObject : public RenderObject
     ParticleEffectData* effectData;
     Vector<RenderBatch*> renderBatchCache;
 
-    void AppendParticleGroup(List<ParticleGroup>::iterator begin, List<ParticleGroup>::iterator end, uint32 particlesCount, const Vector3& cameraDirection, Vector3* basisVectors);
-    void AppendStripeParticle(List<ParticleGroup>::iterator begin, List<ParticleGroup>::iterator end, Camera* camera, Vector3* basisVectors);
+    void ReserveParticleGroup(List<ParticleGroup>::iterator begin, List<ParticleGroup>::iterator end, uint32 particlesCount);
+    void ReserveStripeParticles(List<ParticleGroup>::iterator begin, List<ParticleGroup>::iterator end);
     void AppendRenderBatch(NMaterial* material, uint32 particlesCount, uint32 vertexLayout, const DynamicBufferAllocator::AllocResultVB& vBuffer);
     void AppendRenderBatch(NMaterial* material, uint32 particlesCount, uint32 vertexLayout, const DynamicBufferAllocator::AllocResultVB& vBuffer, const rhi::HIndexBuffer iBuffer, uint32 startIndex);
     void PrepareRenderData(Camera* camera);
@@ -37,6 +37,8 @@ public:
     ~ParticleRenderObject();
 
     void PrepareToRender(Camera* camera) override;
+    void ReserveRenderData(Camera* camera) override;
+    void FillRenderData() override;
 
     void SetSortingOffset(uint32 offset);
 
@@ -73,10 +75,49 @@ private:
     };
     Map<uint32, LayoutElement> layoutsData;
 
-    uint32 GetVertexStride(ParticleLayer* layer);
+    // Vertex buffer range for `quadsCount` particle quads, reserved for one render batch
+    struct QuadsBufferRange
+    {
+        uint8* data = nullptr;
+        uint32 quadsCount = 0;
+    };
+
+    // Groups with common material, which quads are written to `rangesCount` ranges starting from `firstRange`
+    struct QuadGroupsRun
+    {
+        List<ParticleGroup>::iterator begin;
+        List<ParticleGroup>::iterator end;
+        uint32 firstRange = 0;
+        uint32 rangesCount = 0;
+    };
+
+    // Buffers reserved for stripe of particle `particleIndex` of `group`
+    struct StripeBuffers
+    {
+        ParticleGroup* group = nullptr;
+        ParticleLayer* runLayer = nullptr;
+        uint32 particleIndex = 0;
+        float32* vertices = nullptr;
+        uint16* indices = nullptr;
+    };
+
+    void FillParticleGroup(const QuadGroupsRun& run);
+    void FillStripeParticle(const StripeBuffers& buffers);
+    int32 PrepareStripeBasisIndexes(const ParticleGroup& group, int32(&basises)[4]) const;
+
+    Vector<QuadsBufferRange> quadsRanges;
+    Vector<QuadGroupsRun> quadsRuns;
+    Vector<StripeBuffers> stripesBuffers;
+
+    //camera_facing, x_emitter, y_emitter, z_emitter, x_world, y_world, z_world
+    Vector3 basisVectors[7 * 2];
+    Vector3 stripeBasisVectors[7];
+    Vector3 cameraDirection;
+
+    uint32 GetVertexStride(ParticleLayer* layer) const;
     int32 CalculateParticleCount(const ParticleGroup& group);
     uint32 SelectLayout(const ParticleLayer& layer);
-    void UpdateStripeVertex(float32*& dataPtr, Vector3& position, Vector3& uv, float32* color, ParticleLayer* layer, Particle* particle, float32 fresToAlpha);
+    void UpdateStripeVertex(float32*& dataPtr, Vector3& position, Vector3& uv, float32* color, ParticleLayer* layer, const ParticlePool& particles, uint32 index, float32 fresToAlpha);
     Vector3 GetStripeNormalizedSpeed(const StripeData& data);
 
     Map<uint32, uint32> layoutMap;
@@ -107,6 +148,6 @@ inline bool ParticleRenderObject::CheckIfSimpleParticle(ParticleLayer* layer) co
 
 inline bool ParticleRenderObject::CheckGroup(const ParticleGroup& group) const
 {
-    return group.material && group.head && !group.layer->isDisabled && group.layer->sprite;
+    return group.material && !group.particles.IsEmpty() && !group.layer->isDisabled && group.layer->sprite;
 }
 }
@@ -43,5 +43,25 @@ float32 VanDerCorputRnd(float32 min, float32 max, uint32 n, uint32 base)
 {
     return (max - min) * VanDerCorputRnd(n, base) + min;
 }
+
+void Generator::Seed(uint32 seed)
+{
+    // state must not be zero, so seed is mixed with non-zero constant
+    state = (static_cast<uint64>(seed) << 32) ^ 0x853C49E6748FEA9BULL;
+}
+
+uint32 Generator::Rand()
+{
+    // xorshift64*
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return static_cast<uint32>((state * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+float32 Generator::RandFloat()
+{
+    return static_cast<float32>(static_cast<float64>(Rand()) * (1.0 / 4294967295.0));
+}
+}
 }
-}
\ No newline at end of file
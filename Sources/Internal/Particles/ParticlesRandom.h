@@ -10,5 +10,21 @@ float32 HammersleyRnd(uint32 n);
 float32 HammersleyRnd(float32 min, float32 max, uint32 n);
 float32 VanDerCorputRnd(uint32 n, uint32 base);
 float32 VanDerCorputRnd(float32 min, float32 max, uint32 n, uint32 base);
+
+/**
+    Small xorshift generator. Each effect owns one, so effects can be simulated in parallel
+    and random values of effect don't depend on other effects and threads scheduling.
+*/
+class Generator
+{
+public:
+    void Seed(uint32 seed);
+    uint32 Rand();
+    /** Returns real number in [0, 1]. */
+    float32 RandFloat();
+
+private:
+    uint64 state = 0x853C49E6748FEA9BULL;
+};
 }
 }
@@ -0,0 +1,587 @@
+#include "Render/Highlevel/BVHRenderHierarchy.h"
+#include "Render/Highlevel/RenderObject.h"
+#include "Render/Highlevel/VisibilityQuadTree.h"
+#include "Render/Highlevel/RenderBatchArray.h"
+#include "Render/Highlevel/Camera.h"
+#include "Render/Highlevel/Frustum.h"
+#include "Render/Highlevel/GeometryOctTree.h"
+#include "Render/Highlevel/Landscape.h"
+#include "Debug/DVAssert.h"
+
+namespace DAVA
+{
+namespace BVHRenderHierarchyDetails
+{
+// Enlargement of leaf box relative to size of object box
+const float32 FAT_BOX_MARGIN = 0.1f;
+// Tree is rebuilt when count of insertions and refits exceeds this part of objects count
+const float32 REBUILD_CHANGES_RATIO = 0.1f;
+const uint32 REBUILD_MIN_CHANGES = 64;
+const uint32 SAH_BINS_COUNT = 16;
+
+inline float32 SurfaceArea(const AABBox3& box)
+{
+    if (box.IsEmpty())
+        return 0.0f;
+
+    Vector3 size = box.max - box.min;
+    return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+inline AABBox3 Union(const AABBox3& a, const AABBox3& b)
+{
+    AABBox3 result = a;
+    result.AddAABBox(b);
+    return result;
+}
+}
+
+BVHRenderHierarchy::BVHRenderHierarchy()
+{
+    worldBox = AABBox3(Vector3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 0.0f, 0.0f));
+}
+
+AABBox3 BVHRenderHierarchy::GetFatBox(const AABBox3& box)
+{
+    Vector3 margin = box.GetSize() * BVHRenderHierarchyDetails::FAT_BOX_MARGIN;
+    return AABBox3(box.min - margin, box.max + margin);
+}
+
+int32 BVHRenderHierarchy::AllocateNode()
+{
+    if (!freeNodes.empty())
+    {
+        int32 nodeIndex = freeNodes.back();
+        freeNodes.pop_back();
+        nodes[nodeIndex] = Node();
+        return nodeIndex;
+    }
+
+    nodes.emplace_back();
+    return static_cast<int32>(nodes.size() - 1);
+}
+
+void BVHRenderHierarchy::FreeNode(int32 nodeIndex)
+{
+    nodes[nodeIndex].object = nullptr;
+    freeNodes.push_back(nodeIndex);
+}
+
+void BVHRenderHierarchy::AddRenderObject(RenderObject* renderObject)
+{
+    DVASSERT(renderObject->GetTreeNodeIndex() == QuadTree::INVALID_TREE_NODE_INDEX);
+    DVASSERT(preparedForShutdown == false);
+
+    // leaf index doesn't fit into 16-bit tree node index, so it is stored in objectLeaves;
+    // tree node index only marks object as added to the hierarchy
+    renderObject->SetTreeNodeIndex(0);
+
+    //ALWAYS_CLIPPING_VISIBLE objects are kept out of the tree to prevent being clipped by it
+    if (renderObject->GetFlags() & RenderObject::ALWAYS_CLIPPING_VISIBLE)
+    {
+        alwaysVisibleObjects.push_back(renderObject);
+        objectLeaves[renderObject] = NULL_NODE;
+        return;
+    }
+
+    DVASSERT(!renderObject->GetWorldBoundingBox().IsEmpty());
+
+    int32 leaf = AllocateNode();
+    nodes[leaf].object = renderObject;
+    nodes[leaf].bbox = GetFatBox(renderObject->GetWorldBoundingBox());
+    InsertLeaf(leaf);
+
+    objectLeaves[renderObject] = leaf;
+    ++changesSinceRebuild;
+}
+
+void BVHRenderHierarchy::RemoveRenderObject(RenderObject* renderObject)
+{
+    if (preparedForShutdown == true)
+    {
+        DVASSERT(nodes.empty() == true);
+        return;
+    }
+
+    auto it = objectLeaves.find(renderObject);
+    DVASSERT(it != objectLeaves.end());
+    int32 leaf = it->second;
+    objectLeaves.erase(it);
+    renderObject->SetTreeNodeIndex(QuadTree::INVALID_TREE_NODE_INDEX);
+
+    if (leaf == NULL_NODE)
+    {
+        auto visibleIt = std::find(alwaysVisibleObjects.begin(), alwaysVisibleObjects.end(), renderObject);
+        DVASSERT(visibleIt != alwaysVisibleObjects.end());
+        *visibleIt = alwaysVisibleObjects.back();
+        alwaysVisibleObjects.pop_back();
+        return;
+    }
+
+    RemoveLeaf(leaf);
+    FreeNode(leaf);
+}
+
+void BVHRenderHierarchy::ObjectUpdated(RenderObject* renderObject)
+{
+    if (renderObject->GetFlags() & RenderObject::ALWAYS_CLIPPING_VISIBLE)
+        return;
+
+    auto it = objectLeaves.find(renderObject);
+    DVASSERT(it != objectLeaves.end());
+    int32 leaf = it->second;
+    if (leaf == NULL_NODE)
+        return;
+
+    // object is still inside of enlarged box - nothing to do
+    const AABBox3& objBox = renderObject->GetWorldBoundingBox();
+    if (nodes[leaf].bbox.IsInside(objBox))
+        return;
+
+    nodes[leaf].bbox = GetFatBox(objBox);
+    RefitAncestors(nodes[leaf].parent);
+    ++changesSinceRebuild;
+}
+
+void BVHRenderHierarchy::InsertLeaf(int32 leaf)
+{
+    using namespace BVHRenderHierarchyDetails;
+
+    if (root == NULL_NODE)
+    {
+        root = leaf;
+        nodes[leaf].parent = NULL_NODE;
+        return;
+    }
+
+    // find best sibling: descend to child with less cost of inserted leaf,
+    // stop if creating new parent at current node is cheaper
+    const AABBox3 leafBox = nodes[leaf].bbox;
+    int32 index = root;
+    while (!nodes[index].IsLeaf())
+    {
+        const Node& node = nodes[index];
+        float32 area = SurfaceArea(node.bbox);
+        float32 combinedArea = SurfaceArea(Union(node.bbox, leafBox));
+
+        float32 cost = 2.0f * combinedArea;
+        float32 inheritanceCost = 2.0f * (combinedArea - area);
+
+        float32 childCost[2];
+        int32 children[2] = { node.left, node.right };
+        for (uint32 i = 0; i < 2; ++i)
+        {
+            const Node& child = nodes[children[i]];
+            float32 unionArea = SurfaceArea(Union(child.bbox, leafBox));
+            childCost[i] = (child.IsLeaf() ? unionArea : unionArea - SurfaceArea(child.bbox)) + inheritanceCost;
+        }
+
+        if (cost < childCost[0] && cost < childCost[1])
+            break;
+
+        index = (childCost[0] < childCost[1]) ? children[0] : children[1];
+    }
+
+    int32 sibling = index;
+    int32 oldParent = nodes[sibling].parent;
+    int32 newParent = AllocateNode();
+
+    Node& parentNode = nodes[newParent];
+    parentNode.parent = oldParent;
+    parentNode.left = sibling;
+    parentNode.right = leaf;
+    parentNode.bbox = Union(nodes[sibling].bbox, leafBox);
+
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    if (oldParent == NULL_NODE)
+    {
+        root = newParent;
+    }
+    else
+    {
+        if (nodes[oldParent].left == sibling)
+            nodes[oldParent].left = newParent;
+        else
+            nodes[oldParent].right = newParent;
+
+        RefitAncestors(oldParent);
+    }
+}
+
+void BVHRenderHierarchy::RemoveLeaf(int32 leaf)
+{
+    if (leaf == root)
+    {
+        root = NULL_NODE;
+        return;
+    }
+
+    // sibling of the leaf takes place of their parent
+    int32 parent = nodes[leaf].parent;
+    int32 grandParent = nodes[parent].parent;
+    int32 sibling = (nodes[parent].left == leaf) ? nodes[parent].right : nodes[parent].left;
+
+    nodes[sibling].parent = grandParent;
+    if (grandParent == NULL_NODE)
+    {
+        root = sibling;
+    }
+    else
+    {
+        if (nodes[grandParent].left == parent)
+            nodes[grandParent].left = sibling;
+        else
+            nodes[grandParent].right = sibling;
+
+        RefitAncestors(grandParent);
+    }
+
+    FreeNode(parent);
+    nodes[leaf].parent = NULL_NODE;
+}
+
+void BVHRenderHierarchy::RefitAncestors(int32 nodeIndex)
+{
+    while (nodeIndex != NULL_NODE)
+    {
+        Node& node = nodes[nodeIndex];
+        AABBox3 bbox = BVHRenderHierarchyDetails::Union(nodes[node.left].bbox, nodes[node.right].bbox);
+        if (bbox == node.bbox)
+            break; // boxes of upper nodes are not changed too
+
+        node.bbox = bbox;
+        nodeIndex = node.parent;
+    }
+}
+
+void BVHRenderHierarchy::Rebuild()
+{
+    // collect leaves and release inner nodes, they will be reused by the build
+    buildLeaves.clear();
+    if (root != NULL_NODE)
+    {
+        traverseStack.clear();
+        traverseStack.push_back(root);
+        while (!traverseStack.empty())
+        {
+            int32 nodeIndex = traverseStack.back();
+            traverseStack.pop_back();
+
+            const Node& node = nodes[nodeIndex];
+            if (node.IsLeaf())
+            {
+                buildLeaves.push_back(nodeIndex);
+            }
+            else
+            {
+                traverseStack.push_back(node.right);
+                traverseStack.push_back(node.left);
+                FreeNode(nodeIndex);
+            }
+        }
+    }
+
+    if (buildLeaves.empty())
+    {
+        root = NULL_NODE;
+    }
+    else
+    {
+        root = BuildNode(0, static_cast<uint32>(buildLeaves.size()));
+        nodes[root].parent = NULL_NODE;
+    }
+
+    changesSinceRebuild = 0;
+}
+
+int32 BVHRenderHierarchy::BuildNode(uint32 begin, uint32 end)
+{
+    using namespace BVHRenderHierarchyDetails;
+
+    if (end - begin == 1)
+        return buildLeaves[begin];
+
+    AABBox3 centroidsBox;
+    for (uint32 i = begin; i < end; ++i)
+    {
+        centroidsBox.AddPoint(nodes[buildLeaves[i]].bbox.GetCenter());
+    }
+
+    Vector3 extent = centroidsBox.max - centroidsBox.min;
+    uint32 axis = 0;
+    if (extent.y > extent.data[axis])
+        axis = 1;
+    if (extent.z > extent.data[axis])
+        axis = 2;
+
+    uint32 mid = begin;
+    float32 axisMin = centroidsBox.min.data[axis];
+    float32 axisExtent = extent.data[axis];
+    if (axisExtent > EPSILON)
+    {
+        // binned SAH: choose split between bins with minimal sum of `count * area` of both sides
+        float32 binScale = static_cast<float32>(SAH_BINS_COUNT) / axisExtent;
+        auto getBin = [this, axis, axisMin, binScale](int32 nodeIndex) {
+            uint32 bin = static_cast<uint32>((nodes[nodeIndex].bbox.GetCenter().data[axis] - axisMin) * binScale);
+            return Min(bin, SAH_BINS_COUNT - 1);
+        };
+
+        AABBox3 binBoxes[SAH_BINS_COUNT];
+        uint32 binCounts[SAH_BINS_COUNT] = {};
+        for (uint32 i = begin; i < end; ++i)
+        {
+            uint32 bin = getBin(buildLeaves[i]);
+            binBoxes[bin].AddAABBox(nodes[buildLeaves[i]].bbox);
+            ++binCounts[bin];
+        }
+
+        float32 rightCosts[SAH_BINS_COUNT];
+        AABBox3 rightBox;
+        uint32 rightCount = 0;
+        for (uint32 bin = SAH_BINS_COUNT - 1; bin > 0; --bin)
+        {
+            rightBox.AddAABBox(binBoxes[bin]);
+            rightCount += binCounts[bin];
+            rightCosts[bin] = static_cast<float32>(rightCount) * SurfaceArea(rightBox);
+        }
+
+        AABBox3 leftBox;
+        uint32 leftCount = 0;
+        uint32 bestSplit = 0;
+        float32 bestCost = FLOAT_MAX;
+        for (uint32 bin = 0; bin < SAH_BINS_COUNT - 1; ++bin)
+        {
+            leftBox.AddAABBox(binBoxes[bin]);
+            leftCount += binCounts[bin];
+            float32 cost = static_cast<float32>(leftCount) * SurfaceArea(leftBox) + rightCosts[bin + 1];
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                bestSplit = bin;
+            }
+        }
+
+        auto midIt = std::partition(buildLeaves.begin() + begin, buildLeaves.begin() + end, [&getBin, bestSplit](int32 nodeIndex) {
+            return getBin(nodeIndex) <= bestSplit;
+        });
+        mid = static_cast<uint32>(midIt - buildLeaves.begin());
+    }
+
+    if (mid == begin || mid == end)
+    {
+        // all centroids are in one bin - split by median
+        mid = (begin + end) / 2;
+        std::nth_element(buildLeaves.begin() + begin, buildLeaves.begin() + mid, buildLeaves.begin() + end, [this, axis](int32 l, int32 r) {
+            return nodes[l].bbox.GetCenter().data[axis] < nodes[r].bbox.GetCenter().data[axis];
+        });
+    }
+
+    int32 nodeIndex = AllocateNode();
+    int32 left = BuildNode(begin, mid);
+    int32 right = BuildNode(mid, end);
+
+    Node& node = nodes[nodeIndex];
+    node.left = left;
+    node.right = right;
+    node.bbox = Union(nodes[left].bbox, nodes[right].bbox);
+    nodes[left].parent = nodeIndex;
+    nodes[right].parent = nodeIndex;
+    return nodeIndex;
+}
+
+void BVHRenderHierarchy::Initialize()
+{
+    DVASSERT(preparedForShutdown == false);
+    Rebuild();
+    Update();
+}
+
+void BVHRenderHierarchy::PrepareForShutdown()
+{
+    broadPhaseCollisions.clear();
+    nodes.clear();
+    freeNodes.clear();
+    objectLeaves.clear();
+    alwaysVisibleObjects.clear();
+    root = NULL_NODE;
+    preparedForShutdown = true;
+}
+
+void BVHRenderHierarchy::Update()
+{
+    using namespace BVHRenderHierarchyDetails;
+
+    uint32 objectsCount = static_cast<uint32>(objectLeaves.size());
+    uint32 maxChanges = Max(REBUILD_MIN_CHANGES, static_cast<uint32>(static_cast<float32>(objectsCount) * REBUILD_CHANGES_RATIO));
+    if (changesSinceRebuild > maxChanges)
+    {
+        Rebuild();
+    }
+
+    if (root != NULL_NODE)
+        worldBox = nodes[root].bbox;
+}
+
+void BVHRenderHierarchy::Clip(Camera* camera, Vector<RenderObject*>& visibilityArray, uint32 visibilityCriteria)
+{
+    Frustum* frustum = camera->GetFrustum();
+
+    for (RenderObject* obj : alwaysVisibleObjects)
+    {
+        if ((obj->GetFlags() & visibilityCriteria) == visibilityCriteria)
+            visibilityArray.push_back(obj);
+    }
+
+    if (root == NULL_NODE)
+        return;
+
+    // stack keeps node and mask of planes, that intersect box of its parent
+    clipStack.clear();
+    clipStack.emplace_back(root, 0x3f);
+    while (!clipStack.empty())
+    {
+        int32 nodeIndex = clipStack.back().first;
+        uint8 planeMask = clipStack.back().second;
+        clipStack.pop_back();
+
+        Node& node = nodes[nodeIndex];
+        if (planeMask && frustum->Classify(node.bbox, planeMask, node.startClipPlane) == Frustum::EFR_OUTSIDE)
+            continue;
+
+        if (node.IsLeaf())
+        {
+            RenderObject* obj = node.object;
+            uint32 flags = obj->GetFlags();
+            if ((flags & visibilityCriteria) == visibilityCriteria)
+            {
+                //box of the leaf is enlarged, so object itself should be tested if leaf is not fully inside
+                if (!planeMask || (flags & RenderObject::ALWAYS_CLIPPING_VISIBLE)
+                    || frustum->IsInside(obj->GetWorldBoundingBox(), planeMask, obj->startClippingPlane))
+                {
+                    visibilityArray.push_back(obj);
+#if defined(__DAVAENGINE_RENDERSTATS__)
+                    ++Renderer::GetRenderStats().visibleRenderObjects;
+#endif
+                }
+            }
+        }
+        else
+        {
+            clipStack.emplace_back(node.right, planeMask);
+            clipStack.emplace_back(node.left, planeMask);
+        }
+    }
+}
+
+void BVHRenderHierarchy::GetAllObjectsInBBox(const AABBox3& bbox, Vector<RenderObject*>& visibilityArray)
+{
+    for (RenderObject* obj : alwaysVisibleObjects)
+    {
+        if (bbox.IntersectsWithBox(obj->GetWorldBoundingBox()))
+            visibilityArray.push_back(obj);
+    }
+
+    if (root == NULL_NODE)
+        return;
+
+    traverseStack.clear();
+    traverseStack.push_back(root);
+    while (!traverseStack.empty())
+    {
+        const Node& node = nodes[traverseStack.back()];
+        traverseStack.pop_back();
+
+        if (!bbox.IntersectsWithBox(node.bbox))
+            continue;
+
+        if (node.IsLeaf())
+        {
+            if (bbox.IntersectsWithBox(node.object->GetWorldBoundingBox()))
+                visibilityArray.push_back(node.object);
+        }
+        else
+        {
+            traverseStack.push_back(node.right);
+            traverseStack.push_back(node.left);
+        }
+    }
+}
+
+void BVHRenderHierarchy::BroadPhaseCollisions(const Ray3& rayInWorldSpace, Vector<BroadPhaseCollision>& broadPhaseCollisions)
+{
+    float32 tMin, tMax;
+    for (RenderObject* obj : alwaysVisibleObjects)
+    {
+        if (Intersection::RayBox(rayInWorldSpace, obj->GetWorldBoundingBox(), tMin, tMax))
+            broadPhaseCollisions.emplace_back(tMin, obj);
+    }
+
+    if (root != NULL_NODE)
+    {
+        traverseStack.clear();
+        traverseStack.push_back(root);
+        while (!traverseStack.empty())
+        {
+            const Node& node = nodes[traverseStack.back()];
+            traverseStack.pop_back();
+
+            if (!Intersection::RayBox(rayInWorldSpace, node.bbox, tMin, tMax))
+                continue;
+
+            if (node.IsLeaf())
+            {
+                if (Intersection::RayBox(rayInWorldSpace, node.object->GetWorldBoundingBox(), tMin, tMax))
+                    broadPhaseCollisions.emplace_back(tMin, node.object);
+            }
+            else
+            {
+                traverseStack.push_back(node.right);
+                traverseStack.push_back(node.left);
+            }
+        }
+    }
+
+    std::sort(broadPhaseCollisions.begin(), broadPhaseCollisions.end(), [](const BroadPhaseCollision& l, const BroadPhaseCollision& r) {
+        return l.first < r.first;
+    });
+}
+
+bool BVHRenderHierarchy::RayTrace(const Ray3& ray, RayTraceCollision& collision, const Vector<RenderObject*>& ignoreObjects)
+{
+    broadPhaseCollisions.clear();
+    BroadPhaseCollisions(ray, broadPhaseCollisions);
+
+    return RayTraceObjects(ray, broadPhaseCollisions, ignoreObjects, FLOAT_MAX, collision);
+}
+
+uint32 BVHRenderHierarchy::GetObjectsCount() const
+{
+    return static_cast<uint32>(objectLeaves.size());
+}
+
+uint32 BVHRenderHierarchy::GetTreeDepth() const
+{
+    if (root == NULL_NODE)
+        return 0;
+
+    uint32 depth = 0;
+    Vector<std::pair<int32, uint32>> stack;
+    stack.emplace_back(root, 1);
+    while (!stack.empty())
+    {
+        int32 nodeIndex = stack.back().first;
+        uint32 nodeDepth = stack.back().second;
+        stack.pop_back();
+
+        depth = Max(depth, nodeDepth);
+        if (!nodes[nodeIndex].IsLeaf())
+        {
+            stack.emplace_back(nodes[nodeIndex].left, nodeDepth + 1);
+            stack.emplace_back(nodes[nodeIndex].right, nodeDepth + 1);
+        }
+    }
+    return depth;
+}
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+#include "Math/AABBox3.h"
+#include "Render/Highlevel/RenderHierarchy.h"
+
+namespace DAVA
+{
+class Frustum;
+class RenderObject;
+
+/**
+    Dynamic bounding volume hierarchy of render objects.
+    Each leaf holds one object with its world box enlarged by a margin, so small movements don't touch the tree.
+    Moved objects, that leave their enlarged box, are refitted in place: leaf box and boxes of its ancestors are recalculated.
+    Refits and insertions degrade quality of the tree, so it is periodically rebuilt with binned surface area heuristic.
+    Leaf nodes are kept on rebuild, only inner nodes are recreated.
+*/
+class BVHRenderHierarchy : public RenderHierarchy
+{
+public:
+    BVHRenderHierarchy();
+
+    void AddRenderObject(RenderObject* renderObject) override;
+    void RemoveRenderObject(RenderObject* renderObject) override;
+    void ObjectUpdated(RenderObject* renderObject) override;
+    void Clip(Camera* camera, Vector<RenderObject*>& visibilityArray, uint32 visibilityCriteria) override;
+    void GetAllObjectsInBBox(const AABBox3& bbox, Vector<RenderObject*>& visibilityArray) override;
+    bool RayTrace(const Ray3& ray, RayTraceCollision& collision,
+                  const Vector<RenderObject*>& ignoreObjects) override;
+    const AABBox3& GetWorldBoundingBox() const override;
+
+    void Initialize() override;
+    void PrepareForShutdown() override;
+    void Update() override;
+
+    /** Rebuild inner nodes of the tree with surface area heuristic. */
+    void Rebuild();
+
+    uint32 GetObjectsCount() const;
+    uint32 GetTreeDepth() const;
+
+private:
+    static const int32 NULL_NODE = -1;
+
+    struct Node
+    {
+        AABBox3 bbox;
+        RenderObject* object = nullptr; // only for leaves
+        int32 parent = NULL_NODE;
+        int32 left = NULL_NODE; // NULL_NODE for leaves
+        int32 right = NULL_NODE;
+        uint8 startClipPlane = 0;
+
+        bool IsLeaf() const
+        {
+            return left == NULL_NODE;
+        }
+    };
+
+    int32 AllocateNode();
+    void FreeNode(int32 nodeIndex);
+
+    void InsertLeaf(int32 leaf);
+    void RemoveLeaf(int32 leaf);
+    void RefitAncestors(int32 nodeIndex);
+    int32 BuildNode(uint32 begin, uint32 end);
+
+    void BroadPhaseCollisions(const Ray3& rayInWorldSpace, Vector<BroadPhaseCollision>& broadPhaseCollisions);
+
+    static AABBox3 GetFatBox(const AABBox3& box);
+
+    Vector<Node> nodes;
+    Vector<int32> freeNodes;
+    UnorderedMap<RenderObject*, int32> objectLeaves;
+    Vector<RenderObject*> alwaysVisibleObjects;
+
+    Vector<std::pair<int32, uint8>> clipStack;
+    Vector<int32> traverseStack;
+    Vector<int32> buildLeaves;
+    Vector<BroadPhaseCollision> broadPhaseCollisions;
+
+    AABBox3 worldBox;
+    int32 root = NULL_NODE;
+    uint32 changesSinceRebuild = 0;
+    bool preparedForShutdown = false;
+};
+
+inline const AABBox3& BVHRenderHierarchy::GetWorldBoundingBox() const
+{
+    return worldBox;
+}
+}
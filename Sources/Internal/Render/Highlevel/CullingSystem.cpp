@@ -1,70 +1,313 @@
-#include "Render/Highlevel/CullingSystem.h"
-#include "Scene3D/Entity.h"
-#include "Render/Highlevel/RenderLayer.h"
-#include "Render/Highlevel/RenderPass.h"
-#include "Render/Highlevel/RenderBatch.h"
-#include "Render/Highlevel/Camera.h"
-#include "Scene3D/Components/RenderComponent.h"
-#include "Scene3D/Components/TransformComponent.h"
-#include "Scene3D/Components/ComponentHelpers.h"
-#include "Render/Highlevel/Frustum.h"
-#include "Logger/Logger.h"
-
-namespace DAVA
-{
-CullingSystem::CullingSystem(Scene* scene)
-    : SceneSystem(scene)
-{
-}
-
-CullingSystem::~CullingSystem()
-{
-}
-
-void CullingSystem::ImmediateUpdate(Entity* entity)
-{
-    RenderObject* renderObject = GetRenderObject(entity);
-    if (!renderObject)
-        return;
-
-    if (renderObject->GetRemoveIndex() == static_cast<uint32>(-1)) // FAIL, SHOULD NOT HAPPEN
-    {
-        Logger::Error("Object in entity was replaced suddenly. ");
-    }
-
-    // Do we need updates???
-}
-
-void CullingSystem::AddEntity(Entity* entity)
-{
-}
-
-void CullingSystem::RemoveEntity(Entity* entity)
-{
-}
-
-void CullingSystem::SetCamera(Camera* _camera)
-{
-    camera = _camera;
-}
-
-void CullingSystem::Process(float32 timeElapsed)
-{
-    int32 objectsCulled = 0;
-
-    //Frustum * frustum = camera->GetFrustum();
-
-    uint32 size = static_cast<uint32>(renderObjectArray.size());
-    for (uint32 pos = 0; pos < size; ++pos)
-    {
-        //RenderObject * node = renderObjectArray[pos];
-        //node->AddFlag(RenderObject::VISIBLE_AFTER_CLIPPING_THIS_FRAME);
-        //Logger::FrameworkDebug("Cull Node: %s rc: %d", node->GetFullName().c_str(), node->GetRetainCount());
-        //if (!frustum->IsInside(node->GetWorldTransformedBox()))
-        {
-            //node->RemoveFlag(RenderObject::VISIBLE_AFTER_CLIPPING_THIS_FRAME);
-            objectsCulled++;
-        }
-    }
-}
-};
+#include "Render/Highlevel/CullingSystem.h"
+#include "Scene3D/Entity.h"
+#include "Render/Highlevel/RenderLayer.h"
+#include "Render/Highlevel/RenderPass.h"
+#include "Render/Highlevel/RenderBatch.h"
+#include "Render/Highlevel/Camera.h"
+#include "Scene3D/Components/RenderComponent.h"
+#include "Scene3D/Components/TransformComponent.h"
+#include "Scene3D/Components/ComponentHelpers.h"
+#include "Render/Highlevel/Frustum.h"
+#include "Render/Highlevel/RenderSystem.h"
+#include "Render/Renderer.h"
+#include "Scene3D/Scene.h"
+#include "Engine/Engine.h"
+#include "Engine/EngineContext.h"
+#include "Job/JobManager.h"
+#include "Logger/Logger.h"
+#include "Concurrency/LockGuard.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define DAVA_CULLING_SSE
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define DAVA_CULLING_NEON
+#include <arm_neon.h>
+#endif
+
+namespace DAVA
+{
+namespace CullingSystemDetails
+{
+// Min count of objects to test them in the worker-threads
+const uint32 PARALLEL_MIN_OBJECTS_COUNT = 4096;
+// Count of 4-boxes batches tested by one job
+const uint32 BATCHES_PER_JOB = 256;
+const uint32 MAX_PLANES_COUNT = 6;
+
+inline void AppendVisible(uint32 visibleMask, uint32 first, uint32 end, Vector<uint32>& visibleIndices)
+{
+    for (uint32 k = 0; k < 4 && first + k < end; ++k)
+    {
+        if (visibleMask & (1 << k))
+        {
+            visibleIndices.push_back(first + k);
+        }
+    }
+}
+
+inline void SetObjectBox(CullingSystem::BoundingBoxes& boxes, uint32 index, RenderObject* renderObject)
+{
+    if (renderObject->GetFlags() & RenderObject::ALWAYS_CLIPPING_VISIBLE)
+    {
+        // infinite box is inside of any frustum
+        const float32 inf = std::numeric_limits<float32>::max();
+        boxes.Set(index, AABBox3(Vector3(-inf, -inf, -inf), Vector3(inf, inf, inf)));
+    }
+    else
+    {
+        boxes.Set(index, renderObject->GetWorldBoundingBox());
+    }
+}
+}
+
+void CullingSystem::BoundingBoxes::Resize(uint32 count_)
+{
+    count = count_;
+
+    // pad arrays, so last batch can be loaded without bounds checks
+    uint32 paddedCount = (count + 3) & ~3u;
+    minX.resize(paddedCount, 0.0f);
+    minY.resize(paddedCount, 0.0f);
+    minZ.resize(paddedCount, 0.0f);
+    maxX.resize(paddedCount, 0.0f);
+    maxY.resize(paddedCount, 0.0f);
+    maxZ.resize(paddedCount, 0.0f);
+}
+
+void CullingSystem::BoundingBoxes::Set(uint32 index, const AABBox3& box)
+{
+    minX[index] = box.min.x;
+    minY[index] = box.min.y;
+    minZ[index] = box.min.z;
+    maxX[index] = box.max.x;
+    maxY[index] = box.max.y;
+    maxZ[index] = box.max.z;
+}
+
+CullingSystem::CullingSystem(Scene* scene)
+    : SceneSystem(scene)
+    , visibilityCriteria(RenderObject::CLIPPING_VISIBILITY_CRITERIA)
+{
+}
+
+CullingSystem::~CullingSystem()
+{
+}
+
+void CullingSystem::PrepareForRemove()
+{
+    RenderSystem* renderSystem = GetScene()->GetRenderSystem();
+    if (renderSystem->GetCullingSystem() == this)
+    {
+        renderSystem->SetCullingSystem(nullptr);
+    }
+}
+
+void CullingSystem::SetCamera(Camera* _camera)
+{
+    camera = _camera;
+}
+
+void CullingSystem::AddObject(RenderObject* renderObject)
+{
+    uint32 index = renderObject->GetRemoveIndex();
+    DVASSERT(index == boxes.count);
+
+    boxes.Resize(boxes.count + 1);
+    CullingSystemDetails::SetObjectBox(boxes, index, renderObject);
+}
+
+void CullingSystem::RemoveObject(RenderObject* renderObject)
+{
+    uint32 index = renderObject->GetRemoveIndex();
+    uint32 last = boxes.count - 1;
+    DVASSERT(index <= last);
+
+    // same swap with the last one as in RenderSystem::RemoveFromRender
+    boxes.minX[index] = boxes.minX[last];
+    boxes.minY[index] = boxes.minY[last];
+    boxes.minZ[index] = boxes.minZ[last];
+    boxes.maxX[index] = boxes.maxX[last];
+    boxes.maxY[index] = boxes.maxY[last];
+    boxes.maxZ[index] = boxes.maxZ[last];
+    boxes.Resize(last);
+}
+
+void CullingSystem::UpdateObject(RenderObject* renderObject)
+{
+    uint32 index = renderObject->GetRemoveIndex();
+    DVASSERT(index < boxes.count);
+
+    CullingSystemDetails::SetObjectBox(boxes, index, renderObject);
+}
+
+void CullingSystem::RebuildObjects()
+{
+    const Vector<RenderObject*>& renderObjects = GetScene()->GetRenderSystem()->GetRenderObjects();
+    boxes.Resize(static_cast<uint32>(renderObjects.size()));
+    for (uint32 i = 0; i < boxes.count; ++i)
+    {
+        CullingSystemDetails::SetObjectBox(boxes, i, renderObjects[i]);
+    }
+}
+
+void CullingSystem::Process(float32 timeElapsed)
+{
+    visibleObjects.clear();
+    if (camera != nullptr)
+    {
+        Clip(camera, visibleObjects, visibilityCriteria);
+    }
+}
+
+void CullingSystem::Clip(Camera* clipCamera, Vector<RenderObject*>& visibilityArray, uint32 criteria)
+{
+    using namespace CullingSystemDetails;
+
+#if defined(__DAVAENGINE_RENDERSTATS__)
+    size_t initialSize = visibilityArray.size();
+#endif
+
+    const Vector<RenderObject*>& renderObjects = GetScene()->GetRenderSystem()->GetRenderObjects();
+    DVASSERT(renderObjects.size() == boxes.count);
+
+    LockGuard<Mutex> guard(clipMutex);
+
+    Frustum* frustum = clipCamera->GetFrustum();
+    uint32 count = boxes.count;
+    visibleIndices.clear();
+
+    JobManager* jobManager = GetEngineContext()->jobManager;
+    if (parallelCullingEnabled && nullptr != jobManager && count >= PARALLEL_MIN_OBJECTS_COUNT)
+    {
+        // each job writes into its own array, arrays are merged in order of chunks
+        uint32 batchesCount = (count + 3) / 4;
+        uint32 chunksCount = (batchesCount + BATCHES_PER_JOB - 1) / BATCHES_PER_JOB;
+        if (chunkVisibleIndices.size() < chunksCount)
+        {
+            chunkVisibleIndices.resize(chunksCount);
+        }
+        for (uint32 i = 0; i < chunksCount; ++i)
+        {
+            chunkVisibleIndices[i].clear();
+        }
+
+        jobManager->ParallelFor(0, batchesCount, [this, frustum, count](uint32 begin, uint32 end) {
+            Vector<uint32>& chunkIndices = chunkVisibleIndices[begin / BATCHES_PER_JOB];
+            ClipBoxes(frustum, boxes, begin * 4, Min(end * 4, count), chunkIndices);
+        },
+                                BATCHES_PER_JOB);
+
+        for (uint32 i = 0; i < chunksCount; ++i)
+        {
+            visibleIndices.insert(visibleIndices.end(), chunkVisibleIndices[i].begin(), chunkVisibleIndices[i].end());
+        }
+    }
+    else
+    {
+        ClipBoxes(frustum, boxes, 0, count, visibleIndices);
+    }
+
+    // ALWAYS_CLIPPING_VISIBLE objects have infinite boxes, so they are among visible ones
+    for (uint32 index : visibleIndices)
+    {
+        RenderObject* renderObject = renderObjects[index];
+        if ((renderObject->GetFlags() & criteria) == criteria)
+        {
+            visibilityArray.push_back(renderObject);
+        }
+    }
+
+#if defined(__DAVAENGINE_RENDERSTATS__)
+    Renderer::GetRenderStats().visibleRenderObjects += static_cast<uint32>(visibilityArray.size() - initialSize);
+#endif
+}
+
+void CullingSystem::ClipBoxes(Frustum* frustum, const BoundingBoxes& boxes, uint32 begin, uint32 end, Vector<uint32>& visibleIndices)
+{
+    using namespace CullingSystemDetails;
+
+    DVASSERT((begin & 3) == 0);
+    DVASSERT(end <= boxes.count);
+
+    // For each plane select corner of the box, that is the farthest in the direction opposite to plane normal.
+    // Box is outside if this corner is in front of any plane. Same test as in Frustum::IsInside.
+    uint32 planesCount = Min(static_cast<uint32>(frustum->GetPlaneCount()), MAX_PLANES_COUNT);
+    const float32* cornerX[MAX_PLANES_COUNT];
+    const float32* cornerY[MAX_PLANES_COUNT];
+    const float32* cornerZ[MAX_PLANES_COUNT];
+    Plane planes[MAX_PLANES_COUNT];
+    for (uint32 p = 0; p < planesCount; ++p)
+    {
+        planes[p] = frustum->GetPlane(p);
+        cornerX[p] = (planes[p].n.x >= 0.0f) ? boxes.minX.data() : boxes.maxX.data();
+        cornerY[p] = (planes[p].n.y >= 0.0f) ? boxes.minY.data() : boxes.maxY.data();
+        cornerZ[p] = (planes[p].n.z >= 0.0f) ? boxes.minZ.data() : boxes.maxZ.data();
+    }
+
+#if defined(DAVA_CULLING_SSE)
+
+    const __m128 zero = _mm_setzero_ps();
+    for (uint32 i = begin; i < end; i += 4)
+    {
+        __m128 outside = zero;
+        for (uint32 p = 0; p < planesCount; ++p)
+        {
+            __m128 distance = _mm_mul_ps(_mm_set1_ps(planes[p].n.x), _mm_loadu_ps(cornerX[p] + i));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(planes[p].n.y), _mm_loadu_ps(cornerY[p] + i)));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(planes[p].n.z), _mm_loadu_ps(cornerZ[p] + i)));
+            distance = _mm_add_ps(distance, _mm_set1_ps(planes[p].d));
+            outside = _mm_or_ps(outside, _mm_cmpgt_ps(distance, zero));
+        }
+
+        uint32 visibleMask = ~static_cast<uint32>(_mm_movemask_ps(outside)) & 0xf;
+        AppendVisible(visibleMask, i, end, visibleIndices);
+    }
+
+#elif defined(DAVA_CULLING_NEON)
+
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    for (uint32 i = begin; i < end; i += 4)
+    {
+        uint32x4_t outside = vdupq_n_u32(0);
+        for (uint32 p = 0; p < planesCount; ++p)
+        {
+            // multiply and add separately to get the same rounding as scalar code
+            float32x4_t distance = vmulq_f32(vdupq_n_f32(planes[p].n.x), vld1q_f32(cornerX[p] + i));
+            distance = vaddq_f32(distance, vmulq_f32(vdupq_n_f32(planes[p].n.y), vld1q_f32(cornerY[p] + i)));
+            distance = vaddq_f32(distance, vmulq_f32(vdupq_n_f32(planes[p].n.z), vld1q_f32(cornerZ[p] + i)));
+            distance = vaddq_f32(distance, vdupq_n_f32(planes[p].d));
+            outside = vorrq_u32(outside, vcgtq_f32(distance, zero));
+        }
+
+        uint32 visibleMask = 0;
+        visibleMask |= (vgetq_lane_u32(outside, 0) == 0) ? 1 : 0;
+        visibleMask |= (vgetq_lane_u32(outside, 1) == 0) ? 2 : 0;
+        visibleMask |= (vgetq_lane_u32(outside, 2) == 0) ? 4 : 0;
+        visibleMask |= (vgetq_lane_u32(outside, 3) == 0) ? 8 : 0;
+        AppendVisible(visibleMask, i, end, visibleIndices);
+    }
+
+#else
+
+    for (uint32 i = begin; i < end; i += 4)
+    {
+        uint32 visibleMask = 0xf;
+        for (uint32 k = 0; k < 4; ++k)
+        {
+            for (uint32 p = 0; p < planesCount; ++p)
+            {
+                if (planes[p].DistanceToPoint(cornerX[p][i + k], cornerY[p][i + k], cornerZ[p][i + k]) > 0.0f)
+                {
+                    visibleMask &= ~(1 << k);
+                    break;
+                }
+            }
+        }
+        AppendVisible(visibleMask, i, end, visibleIndices);
+    }
+
+#endif
+}
+};
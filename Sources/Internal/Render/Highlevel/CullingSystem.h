@@ -1,36 +1,124 @@
-#ifndef __DAVAENGINE_RENDER_CULLINGSYSTEM_H__
-#define __DAVAENGINE_RENDER_CULLINGSYSTEM_H__
-
-#include "Base/BaseTypes.h"
-#include "Entity/SceneSystem.h"
-
-namespace DAVA
-{
-class RenderPass;
-class RenderLayer;
-class RenderObject;
-class Entity;
-class Camera;
-
-class CullingSystem : public SceneSystem
-{
-public:
-    CullingSystem(Scene* scene);
-    virtual ~CullingSystem();
-
-    virtual void AddEntity(Entity* entity);
-    virtual void RemoveEntity(Entity* entity);
-    virtual void ImmediateUpdate(Entity* entity);
-
-    virtual void Process(float32 timeElapsed);
-
-    void SetCamera(Camera* camera);
-
-private:
-    Vector<RenderObject*> renderObjectArray;
-    Camera* camera = nullptr;
-};
-
-} // ns
-
-#endif /* __DAVAENGINE_RENDER_CULLINGSYSTEM_H__ */
+#ifndef __DAVAENGINE_RENDER_CULLINGSYSTEM_H__
+#define __DAVAENGINE_RENDER_CULLINGSYSTEM_H__
+
+#include "Base/BaseTypes.h"
+#include "Entity/SceneSystem.h"
+#include "Concurrency/Mutex.h"
+#include "Math/AABBox3.h"
+
+namespace DAVA
+{
+class RenderPass;
+class RenderLayer;
+class RenderObject;
+class Entity;
+class Camera;
+class Frustum;
+
+/**
+    Frustum culling of scene render objects.
+    World bounding boxes are kept in structure-of-arrays layout and tested against
+    frustum planes four at once with SSE or NEON (scalar code is used on other platforms).
+    Big arrays are split into chunks which are tested in the worker-threads.
+
+    Scene registers the system and sets it to its RenderSystem. RenderSystem keeps boxes in sync with its
+    render objects: box of each object has index of the object in RenderSystem::GetRenderObjects and is updated
+    when object is added, removed or its world bounding box is recalculated. With RenderOptions::BATCHED_CULLING
+    render passes clip all render objects of the scene with it instead of traversing quad tree (see RenderSystem::Clip).
+*/
+class CullingSystem : public SceneSystem
+{
+public:
+    /** Bounding boxes in structure-of-arrays layout. Arrays are padded to multiple of 4. */
+    struct BoundingBoxes
+    {
+        Vector<float32> minX;
+        Vector<float32> minY;
+        Vector<float32> minZ;
+        Vector<float32> maxX;
+        Vector<float32> maxY;
+        Vector<float32> maxZ;
+        uint32 count = 0;
+
+        void Resize(uint32 count);
+        void Set(uint32 index, const AABBox3& box);
+    };
+
+    CullingSystem(Scene* scene);
+    virtual ~CullingSystem();
+
+    void PrepareForRemove() override;
+    void Process(float32 timeElapsed) override;
+
+    void SetCamera(Camera* camera);
+
+    /** Only objects with all of `criteria` flags are tested. Default is RenderObject::CLIPPING_VISIBILITY_CRITERIA. */
+    void SetVisibilityCriteria(uint32 criteria);
+
+    /** Enable or disable testing of big object arrays in the worker-threads. Enabled by default. */
+    void SetParallelCullingEnabled(bool enabled);
+
+    /** Objects that passed culling by camera set with SetCamera in the last Process call. */
+    const Vector<RenderObject*>& GetVisibleObjects() const;
+
+    /** Called by RenderSystem when `renderObject` is added to the end of its render objects. */
+    void AddObject(RenderObject* renderObject);
+    /** Called by RenderSystem before `renderObject` is replaced with the last render object and removed. */
+    void RemoveObject(RenderObject* renderObject);
+    /** Called by RenderSystem when world bounding box of `renderObject` is recalculated. */
+    void UpdateObject(RenderObject* renderObject);
+    /** Fill boxes from all render objects of the scene. */
+    void RebuildObjects();
+    const BoundingBoxes& GetBoundingBoxes() const;
+
+    /**
+        Append render objects of the scene with all of `visibilityCriteria` flags, which are inside of `camera` frustum
+        or have RenderObject::ALWAYS_CLIPPING_VISIBLE flag, to `visibilityArray`.
+        Index arrays of the system are reused between calls, so calls for several cameras from different threads
+        are serialized. Objects shouldn't be added, removed or updated meanwhile.
+    */
+    void Clip(Camera* camera, Vector<RenderObject*>& visibilityArray, uint32 visibilityCriteria);
+
+    /**
+        Test boxes with indices in range [begin, end) against frustum planes and append indices
+        of visible boxes to `visibleIndices` in ascending order. `begin` should be multiple of 4.
+        Result is the same as Frustum::IsInside for each box.
+    */
+    static void ClipBoxes(Frustum* frustum, const BoundingBoxes& boxes, uint32 begin, uint32 end, Vector<uint32>& visibleIndices);
+
+private:
+    Camera* camera = nullptr;
+    uint32 visibilityCriteria;
+    bool parallelCullingEnabled = true;
+
+    Vector<RenderObject*> visibleObjects;
+
+    BoundingBoxes boxes; ///< Boxes of RenderSystem objects, ALWAYS_CLIPPING_VISIBLE objects have infinite boxes.
+    Vector<uint32> visibleIndices;
+    Vector<Vector<uint32>> chunkVisibleIndices;
+    Mutex clipMutex; ///< Guards index arrays in Clip.
+};
+
+inline void CullingSystem::SetVisibilityCriteria(uint32 criteria)
+{
+    visibilityCriteria = criteria;
+}
+
+inline void CullingSystem::SetParallelCullingEnabled(bool enabled)
+{
+    parallelCullingEnabled = enabled;
+}
+
+inline const Vector<RenderObject*>& CullingSystem::GetVisibleObjects() const
+{
+    return visibleObjects;
+}
+
+inline const CullingSystem::BoundingBoxes& CullingSystem::GetBoundingBoxes() const
+{
+    return boxes;
+}
+
+} // ns
+
+#endif /* __DAVAENGINE_RENDER_CULLINGSYSTEM_H__ */
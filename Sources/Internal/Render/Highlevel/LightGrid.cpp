@@ -0,0 +1,517 @@
+#include "Render/Highlevel/LightGrid.h"
+#include "Render/Highlevel/Light.h"
+#include "Render/Highlevel/RenderObject.h"
+#include "Debug/DVAssert.h"
+#include "Utils/Utils.h"
+
+namespace DAVA
+{
+const float32 LightGrid::DEFAULT_CELL_SIZE = 50.0f;
+
+LightGrid::LightGrid(float32 cellSize_)
+    : cellSize(cellSize_)
+{
+    DVASSERT(cellSize > 0.0f);
+}
+
+void LightGrid::SetCellSize(float32 cellSize_)
+{
+    DVASSERT(cellSize_ > 0.0f);
+
+    Vector<Light*> lights;
+    lights.reserve(lightCells.size());
+    for (const auto& lightCell : lightCells)
+    {
+        lights.push_back(lightCell.first);
+    }
+
+    Vector<RenderObject*> objects;
+    objects.reserve(objectCellKeys.size());
+    for (const auto& objectCellKey : objectCellKeys)
+    {
+        objects.push_back(objectCellKey.first);
+    }
+
+    Clear();
+    cellSize = cellSize_;
+    for (Light* light : lights)
+    {
+        InsertLight(light);
+    }
+    for (RenderObject* object : objects)
+    {
+        UpdateObject(object);
+    }
+}
+
+void LightGrid::UpdateLight(Light* light)
+{
+    if (!light->IsDynamic())
+    {
+        RemoveLight(light);
+        return;
+    }
+
+    InsertLight(light);
+    RelightObjects(light);
+    AttractObjects(light);
+}
+
+void LightGrid::UpdateLights(const Vector<Light*>& lights)
+{
+    for (Light* light : lights)
+    {
+        if (light->IsDynamic())
+        {
+            InsertLight(light);
+        }
+        else
+        {
+            EraseLight(light);
+        }
+    }
+
+    // like on loading of level, one query for each object is cheaper than search of objects around each light
+    if (lights.size() > 1 && 2 * lights.size() >= lightCells.size())
+    {
+        RelightAllObjects();
+        return;
+    }
+
+    for (Light* light : lights)
+    {
+        RelightObjects(light);
+        if (Contains(light))
+        {
+            AttractObjects(light);
+        }
+    }
+}
+
+void LightGrid::RemoveLight(Light* light)
+{
+    EraseLight(light);
+    RelightObjects(light);
+}
+
+void LightGrid::UpdateObject(RenderObject* object)
+{
+    Vector3 position = object->GetWorldBoundingBox().GetCenter();
+    int32 x = GetCellCoord(position.x);
+    int32 y = GetCellCoord(position.y);
+    uint64 key = MakeCellKey(x, y);
+
+    LitObject litObject;
+    litObject.object = object;
+
+    auto it = objectCellKeys.find(object);
+    if (it != objectCellKeys.end())
+    {
+        uint32 index = 0;
+        ObjectCell& cell = GetObjectCell(object, index);
+        if (it->second == key)
+        {
+            cell.objects[index].position = position;
+            SetObjectLight(cell.objects[index], cell, FindNearestLight(position));
+            return;
+        }
+
+        // object keeps its light until the query in new cell
+        litObject = cell.objects[index];
+        RemoveExchangingWithLast(cell.objects, index);
+        if (cell.objects.empty())
+        {
+            objectCells.erase(it->second);
+            objectBoundsChanged = true;
+        }
+    }
+
+    litObject.position = position;
+    objectCellKeys[object] = key;
+    objectBounds.Include(x, y);
+
+    ObjectCell& cell = objectCells[key];
+    cell.objects.push_back(litObject);
+    SetObjectLight(cell.objects.back(), cell, FindNearestLight(position));
+}
+
+void LightGrid::RemoveObject(RenderObject* object)
+{
+    auto it = objectCellKeys.find(object);
+    if (it == objectCellKeys.end())
+    {
+        return;
+    }
+
+    uint32 index = 0;
+    ObjectCell& cell = GetObjectCell(object, index);
+    LinkObject(cell.objects[index], nullptr);
+    RemoveExchangingWithLast(cell.objects, index);
+    if (cell.objects.empty())
+    {
+        objectCells.erase(it->second);
+        objectBoundsChanged = true;
+    }
+    objectCellKeys.erase(it);
+}
+
+void LightGrid::Clear()
+{
+    for (const auto& cell : objectCells)
+    {
+        for (const LitObject& litObject : cell.second.objects)
+        {
+            litObject.object->SetLight(0, nullptr);
+        }
+    }
+
+    cells.clear();
+    lightCells.clear();
+    bounds = CellBounds();
+
+    objectCells.clear();
+    objectCellKeys.clear();
+    litObjects.clear();
+    objectBounds = CellBounds();
+    objectBoundsChanged = false;
+    maxSquareLightDistance = 0.0f;
+}
+
+Light* LightGrid::FindNearestLight(const Vector3& position) const
+{
+    if (cells.empty())
+    {
+        return nullptr;
+    }
+
+    int32 cx = GetCellCoord(position.x);
+    int32 cy = GetCellCoord(position.y);
+    float32 borderDistance = GetBorderDistance(position, cx, cy);
+
+    int32 firstRing = 0;
+    int32 lastRing = 0;
+    GetRings(bounds, cx, cy, firstRing, lastRing);
+
+    Light* nearestLight = nullptr;
+    float32 squareMinDistance = std::numeric_limits<float32>::max();
+
+    auto visitCell = [&](int32 x, int32 y) {
+        auto cell = cells.find(MakeCellKey(x, y));
+        if (cell != cells.end())
+        {
+            for (Light* light : cell->second)
+            {
+                float32 squareDistance = (position - light->GetPosition()).SquareLength();
+                if (squareDistance < squareMinDistance)
+                {
+                    squareMinDistance = squareDistance;
+                    nearestLight = light;
+                }
+            }
+        }
+    };
+
+    for (int32 r = firstRing; r <= lastRing; ++r)
+    {
+        if (nearestLight != nullptr && r > 0)
+        {
+            // any point of ring `r` and further rings is at least that far
+            float32 ringDistance = borderDistance + static_cast<float32>(r - 1) * cellSize;
+            if (ringDistance * ringDistance >= squareMinDistance)
+            {
+                break;
+            }
+        }
+
+        ForEachCellInRing(bounds, cx, cy, r, visitCell);
+    }
+
+    return nearestLight;
+}
+
+void LightGrid::CellBounds::Include(int32 x, int32 y)
+{
+    if (minX > maxX)
+    {
+        minX = maxX = x;
+        minY = maxY = y;
+    }
+    else
+    {
+        minX = Min(minX, x);
+        minY = Min(minY, y);
+        maxX = Max(maxX, x);
+        maxY = Max(maxY, y);
+    }
+}
+
+int32 LightGrid::GetCellCoord(float32 value) const
+{
+    // clamp to keep coordinates of far away positions and their rings in range of int32
+    const float32 maxCoord = static_cast<float32>(1 << 28);
+    return static_cast<int32>(Clamp(std::floor(value / cellSize), -maxCoord, maxCoord));
+}
+
+float32 LightGrid::GetBorderDistance(const Vector3& position, int32 cx, int32 cy) const
+{
+    float32 fx = position.x - static_cast<float32>(cx) * cellSize;
+    float32 fy = position.y - static_cast<float32>(cy) * cellSize;
+    return Max(0.0f, Min(Min(fx, cellSize - fx), Min(fy, cellSize - fy)));
+}
+
+uint64 LightGrid::MakeCellKey(int32 x, int32 y)
+{
+    return (static_cast<uint64>(static_cast<uint32>(x)) << 32) | static_cast<uint32>(y);
+}
+
+void LightGrid::GetRings(const CellBounds& bounds, int32 cx, int32 cy, int32& firstRing, int32& lastRing)
+{
+    // ring `r` consists of cells at Chebyshev distance `r` from cell (cx, cy), rings outside of bounds are empty
+    firstRing = Max(Max(bounds.minX - cx, cx - bounds.maxX), Max(bounds.minY - cy, cy - bounds.maxY));
+    firstRing = Max(firstRing, 0);
+    lastRing = Max(Max(Abs(cx - bounds.minX), Abs(cx - bounds.maxX)), Max(Abs(cy - bounds.minY), Abs(cy - bounds.maxY)));
+}
+
+template <typename T>
+void LightGrid::UpdateBounds(const UnorderedMap<uint64, T>& cells, CellBounds& bounds)
+{
+    bounds = CellBounds();
+    for (const auto& cell : cells)
+    {
+        int32 x = static_cast<int32>(static_cast<uint32>(cell.first >> 32));
+        int32 y = static_cast<int32>(static_cast<uint32>(cell.first));
+        bounds.Include(x, y);
+    }
+}
+
+template <typename Fn>
+void LightGrid::ForEachCellInRing(const CellBounds& bounds, int32 cx, int32 cy, int32 ring, Fn fn)
+{
+    if (ring == 0)
+    {
+        fn(cx, cy);
+        return;
+    }
+
+    int32 x0 = Max(cx - ring, bounds.minX);
+    int32 x1 = Min(cx + ring, bounds.maxX);
+    for (int32 y : { cy - ring, cy + ring })
+    {
+        if (y >= bounds.minY && y <= bounds.maxY)
+        {
+            for (int32 x = x0; x <= x1; ++x)
+            {
+                fn(x, y);
+            }
+        }
+    }
+
+    int32 y0 = Max(cy - ring + 1, bounds.minY);
+    int32 y1 = Min(cy + ring - 1, bounds.maxY);
+    for (int32 x : { cx - ring, cx + ring })
+    {
+        if (x >= bounds.minX && x <= bounds.maxX)
+        {
+            for (int32 y = y0; y <= y1; ++y)
+            {
+                fn(x, y);
+            }
+        }
+    }
+}
+
+void LightGrid::InsertLight(Light* light)
+{
+    const Vector3& position = light->GetPosition();
+    int32 x = GetCellCoord(position.x);
+    int32 y = GetCellCoord(position.y);
+    uint64 key = MakeCellKey(x, y);
+
+    auto it = lightCells.find(light);
+    if (it != lightCells.end())
+    {
+        if (it->second == key)
+        {
+            return;
+        }
+        EraseLight(light);
+    }
+
+    cells[key].push_back(light);
+    lightCells[light] = key;
+    bounds.Include(x, y);
+}
+
+void LightGrid::EraseLight(Light* light)
+{
+    auto it = lightCells.find(light);
+    if (it == lightCells.end())
+    {
+        return;
+    }
+
+    auto cell = cells.find(it->second);
+    DVASSERT(cell != cells.end());
+    FindAndRemoveExchangingWithLast(cell->second, light);
+    lightCells.erase(it);
+
+    if (cell->second.empty())
+    {
+        cells.erase(cell);
+        UpdateBounds(cells, bounds);
+    }
+}
+
+LightGrid::ObjectCell& LightGrid::GetObjectCell(RenderObject* object, uint32& index)
+{
+    auto key = objectCellKeys.find(object);
+    DVASSERT(key != objectCellKeys.end());
+    auto cell = objectCells.find(key->second);
+    DVASSERT(cell != objectCells.end());
+
+    Vector<LitObject>& objects = cell->second.objects;
+    auto it = std::find_if(objects.begin(), objects.end(), [object](const LitObject& litObject) {
+        return litObject.object == object;
+    });
+    DVASSERT(it != objects.end());
+
+    index = static_cast<uint32>(it - objects.begin());
+    return cell->second;
+}
+
+void LightGrid::LinkObject(LitObject& litObject, Light* light)
+{
+    if (litObject.light != light)
+    {
+        if (litObject.light != nullptr)
+        {
+            auto lit = litObjects.find(litObject.light);
+            DVASSERT(lit != litObjects.end());
+            FindAndRemoveExchangingWithLast(lit->second, litObject.object);
+            if (lit->second.empty())
+            {
+                litObjects.erase(lit);
+            }
+        }
+        if (light != nullptr)
+        {
+            litObjects[light].push_back(litObject.object);
+        }
+        litObject.light = light;
+    }
+    litObject.object->SetLight(0, light);
+}
+
+void LightGrid::SetObjectLight(LitObject& litObject, ObjectCell& cell, Light* light)
+{
+    LinkObject(litObject, light);
+
+    litObject.squareLightDistance = (light != nullptr) ? (litObject.position - light->GetPosition()).SquareLength() : std::numeric_limits<float32>::max();
+    cell.maxSquareLightDistance = Max(cell.maxSquareLightDistance, litObject.squareLightDistance);
+    maxSquareLightDistance = Max(maxSquareLightDistance, litObject.squareLightDistance);
+}
+
+void LightGrid::RelightObjects(Light* light)
+{
+    auto lit = litObjects.find(light);
+    if (lit == litObjects.end())
+    {
+        return;
+    }
+
+    // list of light is changed while its objects are queried
+    Vector<RenderObject*> objects = lit->second;
+    for (RenderObject* object : objects)
+    {
+        uint32 index = 0;
+        ObjectCell& cell = GetObjectCell(object, index);
+        SetObjectLight(cell.objects[index], cell, FindNearestLight(cell.objects[index].position));
+    }
+}
+
+void LightGrid::AttractObjects(Light* light)
+{
+    if (objectBoundsChanged)
+    {
+        UpdateBounds(objectCells, objectBounds);
+        objectBoundsChanged = false;
+    }
+    if (objectCells.empty())
+    {
+        return;
+    }
+
+    const Vector3& position = light->GetPosition();
+    int32 cx = GetCellCoord(position.x);
+    int32 cy = GetCellCoord(position.y);
+    float32 borderDistance = GetBorderDistance(position, cx, cy);
+
+    int32 firstRing = 0;
+    int32 lastRing = 0;
+    GetRings(objectBounds, cx, cy, firstRing, lastRing);
+
+    // object switches to light only if light is closer than its current one
+    float32 visitedMaxSquareDistance = 0.0f;
+    auto visitCell = [&](int32 x, int32 y) {
+        auto it = objectCells.find(MakeCellKey(x, y));
+        if (it == objectCells.end())
+        {
+            return;
+        }
+
+        ObjectCell& cell = it->second;
+        float32 dx = Max(0.0f, Max(static_cast<float32>(x) * cellSize - position.x, position.x - static_cast<float32>(x + 1) * cellSize));
+        float32 dy = Max(0.0f, Max(static_cast<float32>(y) * cellSize - position.y, position.y - static_cast<float32>(y + 1) * cellSize));
+        if (dx * dx + dy * dy < cell.maxSquareLightDistance)
+        {
+            float32 cellMaxSquareDistance = 0.0f;
+            for (LitObject& litObject : cell.objects)
+            {
+                if ((litObject.position - position).SquareLength() < litObject.squareLightDistance)
+                {
+                    SetObjectLight(litObject, cell, light);
+                }
+                cellMaxSquareDistance = Max(cellMaxSquareDistance, litObject.squareLightDistance);
+            }
+            cell.maxSquareLightDistance = cellMaxSquareDistance;
+        }
+        visitedMaxSquareDistance = Max(visitedMaxSquareDistance, cell.maxSquareLightDistance);
+    };
+
+    bool allCellsVisited = true;
+    for (int32 r = firstRing; r <= lastRing; ++r)
+    {
+        if (r > 0)
+        {
+            // objects of ring `r` and further rings are at least that far from light
+            float32 ringDistance = borderDistance + static_cast<float32>(r - 1) * cellSize;
+            if (ringDistance * ringDistance >= maxSquareLightDistance)
+            {
+                allCellsVisited = false;
+                break;
+            }
+        }
+
+        ForEachCellInRing(objectBounds, cx, cy, r, visitCell);
+    }
+
+    if (allCellsVisited)
+    {
+        maxSquareLightDistance = visitedMaxSquareDistance;
+    }
+}
+
+void LightGrid::RelightAllObjects()
+{
+    maxSquareLightDistance = 0.0f;
+    for (auto& it : objectCells)
+    {
+        ObjectCell& cell = it.second;
+        cell.maxSquareLightDistance = 0.0f;
+        for (LitObject& litObject : cell.objects)
+        {
+            SetObjectLight(litObject, cell, FindNearestLight(litObject.position));
+        }
+    }
+}
+}
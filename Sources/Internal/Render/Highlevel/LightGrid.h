@@ -0,0 +1,132 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+#include "Base/UnordererMap.h"
+#include "Math/Vector.h"
+
+namespace DAVA
+{
+class Light;
+class RenderObject;
+
+/**
+    Uniform grid of dynamic lights and render objects lit by them on XY plane, light of each object is the nearest one.
+    Only non-empty cells are stored, so grid has no fixed bounds, and moved lights and objects are transferred between cells incrementally.
+    Query visits rings of cells around the given position until the nearest found light is closer than any unvisited cell.
+
+    When light is changed, objects lit by it are queried again, and only objects in cells around the light,
+    which are closer to it than to their current lights, switch to it. Objects are placed at position of their last update.
+*/
+class LightGrid
+{
+public:
+    static const float32 DEFAULT_CELL_SIZE;
+
+    explicit LightGrid(float32 cellSize = DEFAULT_CELL_SIZE);
+
+    /** Change size of cells, lights and objects are redistributed. */
+    void SetCellSize(float32 cellSize);
+    float32 GetCellSize() const;
+
+    /**
+        Add `light` or move it to cell of its current position, lights of objects are updated.
+        Light which is not dynamic is removed from grid.
+    */
+    void UpdateLight(Light* light);
+    /** Update several lights at once, if most of lights are changed, all objects are queried again instead. */
+    void UpdateLights(const Vector<Light*>& lights);
+    /** Remove `light`, objects lit by it are queried again. */
+    void RemoveLight(Light* light);
+
+    /** Add `object` or move it to cell of its current position, the nearest light is set to object. */
+    void UpdateObject(RenderObject* object);
+    /** Remove `object`, its light is reset. */
+    void RemoveObject(RenderObject* object);
+
+    /** Remove all lights and objects. */
+    void Clear();
+
+    bool Contains(Light* light) const;
+    uint32 GetLightsCount() const;
+    uint32 GetObjectsCount() const;
+
+    /** Return the nearest to `position` light from grid, nullptr if grid is empty. */
+    Light* FindNearestLight(const Vector3& position) const;
+
+private:
+    struct CellBounds
+    {
+        int32 minX = 0;
+        int32 minY = 0;
+        int32 maxX = -1;
+        int32 maxY = -1;
+
+        void Include(int32 x, int32 y);
+    };
+
+    struct LitObject
+    {
+        RenderObject* object = nullptr;
+        Light* light = nullptr;
+        Vector3 position;
+        float32 squareLightDistance = 0.0f;
+    };
+
+    struct ObjectCell
+    {
+        Vector<LitObject> objects;
+        float32 maxSquareLightDistance = 0.0f; ///< Not less than distance of any object of cell to its light.
+    };
+
+    int32 GetCellCoord(float32 value) const;
+    float32 GetBorderDistance(const Vector3& position, int32 cx, int32 cy) const;
+    static uint64 MakeCellKey(int32 x, int32 y);
+    static void GetRings(const CellBounds& bounds, int32 cx, int32 cy, int32& firstRing, int32& lastRing);
+    template <typename T>
+    static void UpdateBounds(const UnorderedMap<uint64, T>& cells, CellBounds& bounds);
+    template <typename Fn>
+    static void ForEachCellInRing(const CellBounds& bounds, int32 cx, int32 cy, int32 ring, Fn fn);
+
+    void InsertLight(Light* light);
+    void EraseLight(Light* light);
+
+    ObjectCell& GetObjectCell(RenderObject* object, uint32& index);
+    void LinkObject(LitObject& litObject, Light* light);
+    void SetObjectLight(LitObject& litObject, ObjectCell& cell, Light* light);
+    void RelightObjects(Light* light);
+    void AttractObjects(Light* light);
+    void RelightAllObjects();
+
+    float32 cellSize;
+    UnorderedMap<uint64, Vector<Light*>> cells;
+    UnorderedMap<Light*, uint64> lightCells;
+    CellBounds bounds; ///< Bounds of non-empty cells of lights.
+
+    UnorderedMap<uint64, ObjectCell> objectCells;
+    UnorderedMap<RenderObject*, uint64> objectCellKeys;
+    UnorderedMap<Light*, Vector<RenderObject*>> litObjects;
+    CellBounds objectBounds; ///< Could include empty cells after removal of objects, until the next search of objects.
+    bool objectBoundsChanged = false;
+    float32 maxSquareLightDistance = 0.0f; ///< Not less than distance of any object to its light.
+};
+
+inline float32 LightGrid::GetCellSize() const
+{
+    return cellSize;
+}
+
+inline bool LightGrid::Contains(Light* light) const
+{
+    return lightCells.count(light) > 0;
+}
+
+inline uint32 LightGrid::GetLightsCount() const
+{
+    return static_cast<uint32>(lightCells.size());
+}
+
+inline uint32 LightGrid::GetObjectsCount() const
+{
+    return static_cast<uint32>(objectCellKeys.size());
+}
+}
@@ -0,0 +1,284 @@
+#include "Render/Highlevel/OcclusionRasterizer.h"
+#include "Debug/DVAssert.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define DAVA_OCCLUSION_RASTERIZER_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace DAVA
+{
+namespace OcclusionRasterizerDetails
+{
+// Count of set bits in 4-bit mask
+const uint32 MASK_BITS_COUNT[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+
+// Linear function of screen position `a * x + b * y + c`
+struct LinearFunction
+{
+    float32 a;
+    float32 b;
+    float32 c;
+
+    float32 At(float32 x, float32 y) const
+    {
+        return a * x + b * y + c;
+    }
+};
+
+// Positive inside of triangle with counter-clockwise order of vertices `v0`, `v1`, ...
+// Function is computed from vertices in the same order for both directions of edge, so adjacent triangles
+// get exactly negated values of their shared edge, and each pixel of the edge is covered by one of them.
+template <typename T>
+LinearFunction MakeEdgeFunction(const T& v0, const T& v1)
+{
+    bool reversed = (v1.y < v0.y) || (v1.y == v0.y && v1.x < v0.x);
+    const T& from = reversed ? v1 : v0;
+    const T& to = reversed ? v0 : v1;
+
+    LinearFunction edge;
+    edge.a = from.y - to.y;
+    edge.b = to.x - from.x;
+    edge.c = -(edge.a * from.x + edge.b * from.y);
+    if (reversed)
+    {
+        edge.a = -edge.a;
+        edge.b = -edge.b;
+        edge.c = -edge.c;
+    }
+    return edge;
+}
+
+// Top-left fill rule: pixel centers lying exactly on the edge are covered only by left and top edges of triangle
+bool IsTopLeftEdge(const LinearFunction& edge)
+{
+    return edge.a > 0.0f || (edge.a == 0.0f && edge.b < 0.0f);
+}
+
+bool IsCovered(float32 edgeValue, bool topLeft)
+{
+    return edgeValue > 0.0f || (edgeValue == 0.0f && topLeft);
+}
+}
+
+OcclusionRasterizer::OcclusionRasterizer(uint32 size_)
+    : size((size_ + 3) & ~3u)
+    , depthBuffer(size * size, 0.0f)
+{
+    DVASSERT(size > 0);
+}
+
+void OcclusionRasterizer::Begin(const Matrix4& viewProjection_, float32 zNear_, float32 zFar)
+{
+    DVASSERT(zNear_ > 0.0f && zFar > zNear_);
+
+    viewProjection = viewProjection_;
+    zNear = zNear_;
+    clearDepth = 1.0f / zFar;
+    std::fill(depthBuffer.begin(), depthBuffer.end(), clearDepth);
+}
+
+uint32 OcclusionRasterizer::DrawTriangles(const Vector3* vertices, uint32 verticesCount, bool depthWrite)
+{
+    using namespace OcclusionRasterizerDetails;
+
+    DVASSERT(verticesCount % 3 == 0);
+
+    uint32 passedPixels = 0;
+    for (uint32 i = 0; i + 2 < verticesCount; i += 3)
+    {
+        Vector4 clipVertices[3] = { Vector4(vertices[i], 1.0f) * viewProjection, Vector4(vertices[i + 1], 1.0f) * viewProjection, Vector4(vertices[i + 2], 1.0f) * viewProjection };
+
+        // whole triangle is outside of one of side planes
+        bool outside = false;
+        for (uint32 axis = 0; axis < 2 && !outside; ++axis)
+        {
+            outside = (clipVertices[0].data[axis] > clipVertices[0].w && clipVertices[1].data[axis] > clipVertices[1].w && clipVertices[2].data[axis] > clipVertices[2].w) ||
+            (clipVertices[0].data[axis] < -clipVertices[0].w && clipVertices[1].data[axis] < -clipVertices[1].w && clipVertices[2].data[axis] < -clipVertices[2].w);
+        }
+
+        if (!outside)
+        {
+            passedPixels += DrawClippedTriangle(clipVertices, depthWrite);
+        }
+    }
+    return passedPixels;
+}
+
+uint32 OcclusionRasterizer::DrawClippedTriangle(const Vector4* clipVertices, bool depthWrite)
+{
+    // Clip polygon by near plane `w >= zNear`, w of clip vertex is its depth in view space
+    Vector4 polygon[4];
+    uint32 polygonSize = 0;
+    for (uint32 i = 0; i < 3; ++i)
+    {
+        const Vector4& current = clipVertices[i];
+        const Vector4& next = clipVertices[(i + 1) % 3];
+        bool currentInside = current.w >= zNear;
+        bool nextInside = next.w >= zNear;
+
+        if (currentInside)
+        {
+            polygon[polygonSize++] = current;
+        }
+        if (currentInside != nextInside)
+        {
+            // intersection is found from inner vertex, so adjacent triangles get the same point on their shared edge
+            const Vector4& inner = currentInside ? current : next;
+            const Vector4& outer = currentInside ? next : current;
+            float32 t = (zNear - inner.w) / (outer.w - inner.w);
+            polygon[polygonSize++] = inner + (outer - inner) * t;
+        }
+    }
+
+    if (polygonSize < 3)
+    {
+        return 0;
+    }
+
+    ScreenVertex screenVertices[4];
+    for (uint32 i = 0; i < polygonSize; ++i)
+    {
+        screenVertices[i] = ToScreen(polygon[i]);
+    }
+
+    uint32 passedPixels = RasterizeTriangle(screenVertices[0], screenVertices[1], screenVertices[2], depthWrite);
+    if (polygonSize == 4)
+    {
+        passedPixels += RasterizeTriangle(screenVertices[0], screenVertices[2], screenVertices[3], depthWrite);
+    }
+    return passedPixels;
+}
+
+OcclusionRasterizer::ScreenVertex OcclusionRasterizer::ToScreen(const Vector4& clipVertex) const
+{
+    ScreenVertex result;
+    result.invW = 1.0f / clipVertex.w;
+    result.x = (clipVertex.x * result.invW * 0.5f + 0.5f) * static_cast<float32>(size);
+    result.y = (clipVertex.y * result.invW * 0.5f + 0.5f) * static_cast<float32>(size);
+    return result;
+}
+
+uint32 OcclusionRasterizer::RasterizeTriangle(const ScreenVertex& a, const ScreenVertex& b_, const ScreenVertex& c_, bool depthWrite)
+{
+    using namespace OcclusionRasterizerDetails;
+
+    float32 area = (b_.x - a.x) * (c_.y - a.y) - (b_.y - a.y) * (c_.x - a.x);
+    if (Abs(area) < EPSILON)
+    {
+        return 0;
+    }
+
+    // make order of vertices counter-clockwise
+    const ScreenVertex& b = (area > 0.0f) ? b_ : c_;
+    const ScreenVertex& c = (area > 0.0f) ? c_ : b_;
+    area = Abs(area);
+
+    // bounds of pixels with centers inside of triangle
+    float32 maxCoord = static_cast<float32>(size - 1);
+    int32 minX = static_cast<int32>(Clamp(std::floor(Min(a.x, Min(b.x, c.x)) - 0.5f), 0.0f, maxCoord));
+    int32 maxX = static_cast<int32>(Clamp(std::ceil(Max(a.x, Max(b.x, c.x)) - 0.5f), 0.0f, maxCoord));
+    int32 minY = static_cast<int32>(Clamp(std::floor(Min(a.y, Min(b.y, c.y)) - 0.5f), 0.0f, maxCoord));
+    int32 maxY = static_cast<int32>(Clamp(std::ceil(Max(a.y, Max(b.y, c.y)) - 0.5f), 0.0f, maxCoord));
+
+    // edge opposite to vertex is its barycentric coordinate multiplied by area
+    LinearFunction edgeA = MakeEdgeFunction(b, c);
+    LinearFunction edgeB = MakeEdgeFunction(c, a);
+    LinearFunction edgeC = MakeEdgeFunction(a, b);
+    bool topLeftA = IsTopLeftEdge(edgeA);
+    bool topLeftB = IsTopLeftEdge(edgeB);
+    bool topLeftC = IsTopLeftEdge(edgeC);
+
+    LinearFunction depth;
+    depth.a = (edgeA.a * a.invW + edgeB.a * b.invW + edgeC.a * c.invW) / area;
+    depth.b = (edgeA.b * a.invW + edgeB.b * b.invW + edgeC.b * c.invW) / area;
+    depth.c = (edgeA.c * a.invW + edgeB.c * b.invW + edgeC.c * c.invW) / area;
+
+    // rows are processed by four pixels starting from aligned one
+    minX &= ~3;
+    uint32 passedPixels = 0;
+
+#if defined(DAVA_OCCLUSION_RASTERIZER_SSE)
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+    const __m128 four = _mm_set1_ps(4.0f);
+    const __m128 coefA = _mm_set1_ps(edgeA.a);
+    const __m128 coefB = _mm_set1_ps(edgeB.a);
+    const __m128 coefC = _mm_set1_ps(edgeC.a);
+    const __m128 coefDepth = _mm_set1_ps(depth.a);
+    // edge value equal to zero covers pixel only for top-left edges
+    const __m128 allBits = _mm_cmpeq_ps(zero, zero);
+    const __m128 zeroCoveredA = topLeftA ? allBits : zero;
+    const __m128 zeroCoveredB = topLeftB ? allBits : zero;
+    const __m128 zeroCoveredC = topLeftC ? allBits : zero;
+
+    for (int32 y = minY; y <= maxY; ++y)
+    {
+        float32 py = static_cast<float32>(y) + 0.5f;
+        __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float32>(minX)), offsets);
+
+        __m128 rowA = _mm_set1_ps(edgeA.b * py + edgeA.c);
+        __m128 rowB = _mm_set1_ps(edgeB.b * py + edgeB.c);
+        __m128 rowC = _mm_set1_ps(edgeC.b * py + edgeC.c);
+        __m128 rowDepth = _mm_set1_ps(depth.b * py + depth.c);
+
+        float32* row = depthBuffer.data() + y * size;
+        for (int32 x = minX; x <= maxX; x += 4)
+        {
+            // edge values are computed for each pixel instead of incrementally, so they don't depend on bounds of triangle
+            __m128 valueA = _mm_add_ps(_mm_mul_ps(coefA, px), rowA);
+            __m128 valueB = _mm_add_ps(_mm_mul_ps(coefB, px), rowB);
+            __m128 valueC = _mm_add_ps(_mm_mul_ps(coefC, px), rowC);
+            __m128 insideA = _mm_or_ps(_mm_cmpgt_ps(valueA, zero), _mm_and_ps(_mm_cmpeq_ps(valueA, zero), zeroCoveredA));
+            __m128 insideB = _mm_or_ps(_mm_cmpgt_ps(valueB, zero), _mm_and_ps(_mm_cmpeq_ps(valueB, zero), zeroCoveredB));
+            __m128 insideC = _mm_or_ps(_mm_cmpgt_ps(valueC, zero), _mm_and_ps(_mm_cmpeq_ps(valueC, zero), zeroCoveredC));
+            __m128 inside = _mm_and_ps(_mm_and_ps(insideA, insideB), insideC);
+            if (_mm_movemask_ps(inside) != 0)
+            {
+                __m128 valueDepth = _mm_add_ps(_mm_mul_ps(coefDepth, px), rowDepth);
+                __m128 bufferDepth = _mm_loadu_ps(row + x);
+                __m128 passed = _mm_and_ps(inside, _mm_cmpgt_ps(valueDepth, bufferDepth));
+                int32 mask = _mm_movemask_ps(passed);
+                if (mask != 0)
+                {
+                    passedPixels += MASK_BITS_COUNT[mask];
+                    if (depthWrite)
+                    {
+                        _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(passed, valueDepth), _mm_andnot_ps(passed, bufferDepth)));
+                    }
+                }
+            }
+
+            px = _mm_add_ps(px, four);
+        }
+    }
+#else
+    for (int32 y = minY; y <= maxY; ++y)
+    {
+        float32 py = static_cast<float32>(y) + 0.5f;
+        float32* row = depthBuffer.data() + y * size;
+        for (int32 x = minX; x <= maxX; x += 4)
+        {
+            for (int32 i = 0; i < 4; ++i)
+            {
+                float32 px = static_cast<float32>(x + i) + 0.5f;
+                if (IsCovered(edgeA.At(px, py), topLeftA) && IsCovered(edgeB.At(px, py), topLeftB) && IsCovered(edgeC.At(px, py), topLeftC))
+                {
+                    float32 pixelDepth = depth.At(px, py);
+                    if (pixelDepth > row[x + i])
+                    {
+                        ++passedPixels;
+                        if (depthWrite)
+                        {
+                            row[x + i] = pixelDepth;
+                        }
+                    }
+                }
+            }
+        }
+    }
+#endif
+
+    return passedPixels;
+}
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+#include "Math/Matrix4.h"
+#include "Math/Vector.h"
+
+namespace DAVA
+{
+/**
+    Depth-only software rasterizer for occlusion tests on CPU.
+    Depth buffer stores interpolated 1/w of triangles, so it doesn't depend on clip range of projection matrix:
+    triangles are clipped by near plane and pixels further than far plane fail depth test.
+    Triangles are drawn without face culling and with top-left fill rule, so pixels on edge shared by two triangles
+    are counted once. Four pixels of a row are processed at once with SSE
+    (scalar code is used on other platforms). Rasterizer isn't thread-safe, use one instance per thread.
+*/
+class OcclusionRasterizer
+{
+public:
+    /** Create rasterizer with square depth buffer, `size` is rounded up to multiple of 4. */
+    explicit OcclusionRasterizer(uint32 size);
+
+    uint32 GetSize() const;
+
+    /** Clear depth buffer and set transformation of the following triangles. */
+    void Begin(const Matrix4& viewProjection, float32 zNear, float32 zFar);
+
+    /**
+        Draw triangle list `vertices` (three vertices per triangle) with depth test.
+        Return count of pixels passed depth test, the same as occlusion query does.
+    */
+    uint32 DrawTriangles(const Vector3* vertices, uint32 verticesCount, bool depthWrite);
+
+private:
+    struct ScreenVertex
+    {
+        float32 x;
+        float32 y;
+        float32 invW;
+    };
+
+    uint32 DrawClippedTriangle(const Vector4* clipVertices, bool depthWrite);
+    uint32 RasterizeTriangle(const ScreenVertex& a, const ScreenVertex& b, const ScreenVertex& c, bool depthWrite);
+    ScreenVertex ToScreen(const Vector4& clipVertex) const;
+
+    uint32 size = 0;
+    Vector<float32> depthBuffer;
+    Matrix4 viewProjection;
+    float32 zNear = 1.0f;
+    float32 clearDepth = 0.0f;
+};
+
+inline uint32 OcclusionRasterizer::GetSize() const
+{
+    return size;
+}
+}
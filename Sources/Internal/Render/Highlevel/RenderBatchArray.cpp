@@ -4,6 +4,15 @@
 
 namespace DAVA
 {
+namespace RenderBatchArrayDetails
+{
+// Batches are drawn in descending order of keys, radix sort is ascending, so it sorts inverted keys
+inline uint64 MakeSortItemKey(uint32 high, uint32 low)
+{
+    return ~((static_cast<uint64>(high) << 32) | low);
+}
+}
+
 RenderBatchArray::RenderBatchArray()
     : sortFlags(0)
 {
@@ -11,37 +20,31 @@ RenderBatchArray::RenderBatchArray()
     //renderBatchArray.reserve(4096);
 }
 
-bool RenderBatchArray::MaterialCompareFunction(const RenderBatch* a, const RenderBatch* b)
-{
-    return a->layerSortingKey > b->layerSortingKey;
-}
-
 void RenderBatchArray::Sort(Camera* camera)
 {
+    using namespace RenderBatchArrayDetails;
+
     // Need sort
     sortFlags |= SORT_REQUIRED;
 
     if ((sortFlags & SORT_THIS_FRAME) == SORT_THIS_FRAME)
     {
+        uint32 count = static_cast<uint32>(renderBatchArray.size());
+        sortItems.resize(count);
+
+        // Layer and pass are not part of the key: there is separate array for each layer of each pass.
         if (sortFlags & SORT_BY_MATERIAL)
         {
-            //Vector3 cameraPosition = camera->GetPosition();
-
-            for (RenderBatch* batch : renderBatchArray)
+            for (uint32 i = 0; i < count; ++i)
             {
-                //pointer_size renderObjectId = (pointer_size)batch->GetRenderObject();
-                //RenderObject * renderObject = batch->GetRenderObject();
-                //Vector3 position = renderObject->GetWorldBoundingBox().GetCenter();
-                //float32 distance = (position - cameraPosition).Length();
-                //uint32 distanceBits = (0xFFFF - ((uint32)distance) & 0xFFFF);
-                uint32 materialIndex = batch->GetMaterial()->GetSortingKey();
-                //VI: sorting key has the following layout: (m:8)(s:4)(d:20)
-                //batch->layerSortingKey = (pointer_size)((materialIndex << 20) | (batch->GetSortingKey() << 28) | (distanceBits));
-                batch->layerSortingKey = static_cast<pointer_size>((materialIndex & 0x0FFFFFFF) | (batch->GetSortingKey() << 28));
-                //batch->layerSortingKey = (pointer_size)((batch->GetMaterial()->GetSortingKey() << 20) | (batch->GetSortingKey() << 28) | (renderObjectId & 0x000FFFFF));
+                RenderBatch* batch = renderBatchArray[i];
+                NMaterial* material = batch->GetMaterial();
+                //VI: sorting key has the following layout: (s:4)(m:28)(shader:16)(texture set:16)
+                uint32 materialBits = (material->GetSortingKey() & 0x0FFFFFFF) | (batch->GetSortingKey() << 28);
+                sortItems[i] = { MakeSortItemKey(materialBits, material->GetStateSortingKey()), i };
             }
 
-            std::sort(renderBatchArray.begin(), renderBatchArray.end(), MaterialCompareFunction);
+            SortItems();
 
             sortFlags &= ~SORT_REQUIRED;
         }
@@ -50,15 +53,17 @@ void RenderBatchArray::Sort(Camera* camera)
             Vector3 cameraPosition = camera->GetPosition();
             Vector3 cameraDirection = camera->GetDirection();
 
-            for (RenderBatch* batch : renderBatchArray)
+            for (uint32 i = 0; i < count; ++i)
             {
+                RenderBatch* batch = renderBatchArray[i];
                 Vector3 delta = batch->GetRenderObject()->GetWorldMatrixPtr()->GetTranslationVector() - cameraPosition;
                 uint32 distance = delta.DotProduct(cameraDirection) < 0 ? 0 : (static_cast<uint32>(delta.Length() * 1000.0f)); //x1000.0f is to prevent resorting of nearby objects (still 26 km range)
                 distance = distance + 31 - batch->GetSortingOffset();
-                batch->layerSortingKey = (distance & 0x0fffffff) | (batch->GetSortingKey() << 28);
+                // (s:4)(d:28)(0:32), batches with equal keys keep their order
+                sortItems[i] = { MakeSortItemKey((distance & 0x0fffffff) | (batch->GetSortingKey() << 28), 0), i };
             }
 
-            std::stable_sort(renderBatchArray.begin(), renderBatchArray.end(), MaterialCompareFunction);
+            SortItems();
 
             sortFlags |= SORT_REQUIRED;
         }
@@ -66,20 +71,38 @@ void RenderBatchArray::Sort(Camera* camera)
         {
             Vector3 cameraPosition = camera->GetPosition();
 
-            for (RenderBatch* batch : renderBatchArray)
+            for (uint32 i = 0; i < count; ++i)
             {
+                RenderBatch* batch = renderBatchArray[i];
                 RenderObject* renderObject = batch->GetRenderObject();
                 Vector3 position = renderObject->GetWorldBoundingBox().GetCenter();
                 uint32 distance = static_cast<uint32>((position - cameraPosition).Length() * 100.0f) + 31 - batch->GetSortingOffset();
                 uint32 distanceBits = 0x0fffffff - distance & 0x0fffffff;
 
-                batch->layerSortingKey = distanceBits | (batch->GetSortingKey() << 28);
+                // (s:4)(d:28)(shader:16)(texture set:16)
+                sortItems[i] = { MakeSortItemKey(distanceBits | (batch->GetSortingKey() << 28), batch->GetMaterial()->GetStateSortingKey()), i };
             }
 
-            std::sort(renderBatchArray.begin(), renderBatchArray.end(), MaterialCompareFunction);
+            SortItems();
 
             sortFlags |= SORT_REQUIRED;
         }
     }
 }
+
+void RenderBatchArray::SortItems()
+{
+    uint32 count = static_cast<uint32>(sortItems.size());
+    sortBuffer.resize(count);
+    RadixSort64(sortItems.data(), sortBuffer.data(), count);
+
+    sortedBatches.resize(count);
+    for (uint32 i = 0; i < count; ++i)
+    {
+        RenderBatch* batch = renderBatchArray[sortItems[i].index];
+        batch->layerSortingKey = static_cast<pointer_size>(~sortItems[i].key >> 32);
+        sortedBatches[i] = batch;
+    }
+    renderBatchArray.swap(sortedBatches);
+}
 };
@@ -2,6 +2,7 @@
 
 #include "Base/BaseTypes.h"
 #include "Base/FastName.h"
+#include "Base/Radix/RadixSort64.h"
 #include "Reflection/Reflection.h"
 #include "Render/Highlevel/RenderBatch.h"
 
@@ -33,9 +34,15 @@ public:
     inline void SetSortingFlags(uint32 flags);
 
 private:
+    void SortItems();
+
     Vector<RenderBatch*> renderBatchArray;
     uint32 sortFlags;
-    static bool MaterialCompareFunction(const RenderBatch* a, const RenderBatch* b);
+
+    // buffers of Sort are kept between frames to avoid reallocations
+    Vector<RadixSortItem64> sortItems;
+    Vector<RadixSortItem64> sortBuffer;
+    Vector<RenderBatch*> sortedBatches;
 };
 
 inline void RenderBatchArray::Clear()
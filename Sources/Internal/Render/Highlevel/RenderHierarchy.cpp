@@ -79,12 +79,23 @@ bool LinearRenderHierarchy::RayTrace(const Ray3& ray, RayTraceCollision& collisi
         }
     }
 
+    return RayTraceObjects(ray, broadPhaseCollisions, ignoreObjects, 1.0f, collision);
+}
+
+bool RenderHierarchy::RayTraceObjects(const Ray3& ray, const Vector<BroadPhaseCollision>& broadPhaseCollisions,
+                                      const Vector<RenderObject*>& ignoreObjects, float32 maxT, RayTraceCollision& collision)
+{
     bool intersectionFound = false;
-    float32 closestT = 1.0f;
+    float32 closestT = maxT;
 
     for (auto& pair : broadPhaseCollisions)
     {
         RenderObject* ro = pair.second;
+        if (std::find(std::begin(ignoreObjects), std::end(ignoreObjects), ro)
+            != std::end(ignoreObjects))
+        {
+            continue;
+        }
 
         if (pair.first > closestT)
             break;
@@ -102,7 +113,7 @@ bool LinearRenderHierarchy::RayTrace(const Ray3& ray, RayTraceCollision& collisi
 
             if (geo)
             {
-                GeometryOctTree* geometryOctTree = geo->octTree;
+                GeometryOctTree* geometryOctTree = geo->GetGeometryOctTree();
                 if (geometryOctTree)
                 {
                     float32 currentT;
@@ -144,7 +155,6 @@ bool LinearRenderHierarchy::RayTrace(const Ray3& ray, RayTraceCollision& collisi
             }
         }
     }
-
     return intersectionFound;
 }
 };
@@ -51,6 +51,14 @@ public:
     {
     }
     virtual const AABBox3& GetWorldBoundingBox() const = 0;
+
+protected:
+    /**
+        Narrow phase of ray tracing: find the closest intersection of `ray` with geometry of objects from `broadPhaseCollisions`,
+        sorted by distance to their bounding boxes. Intersections further than `maxT` are ignored.
+    */
+    static bool RayTraceObjects(const Ray3& ray, const Vector<BroadPhaseCollision>& broadPhaseCollisions,
+                                const Vector<RenderObject*>& ignoreObjects, float32 maxT, RayTraceCollision& collision);
 };
 
 class LinearRenderHierarchy : public RenderHierarchy
@@ -415,6 +415,15 @@ void RenderObject::PrepareToRender(Camera* camera)
 {
 }
 
+void RenderObject::ReserveRenderData(Camera* camera)
+{
+    PrepareToRender(camera);
+}
+
+void RenderObject::FillRenderData()
+{
+}
+
 void RenderObject::SetLodIndex(int32 _lodIndex)
 {
     if (lodIndex != _lodIndex)
@@ -80,6 +80,7 @@ public:
         VISIBLE_REFLECTION = 1 << 10,
         VISIBLE_REFRACTION = 1 << 11,
         VISIBLE_QUALITY = 1 << 12,
+        DEFERRED_RENDER_DATA = 1 << 13, //if set with CUSTOM_PREPARE_TO_RENDER, render pass calls ReserveRenderData and later FillRenderData instead of PrepareToRender
 
         TRANSFORM_UPDATED = 1 << 15,
     };
@@ -186,6 +187,8 @@ public:
     inline uint16 GetStaticOcclusionIndex() const;
     inline void SetStaticOcclusionIndex(uint16 index);
     virtual void PrepareToRender(Camera* camera); //objects passed all tests and is going to be rendered this frame - by default calculates final matrix
+    virtual void ReserveRenderData(Camera* camera); //same as PrepareToRender, but buffers are only allocated and batches are set up, by default calls PrepareToRender
+    virtual void FillRenderData(); //fills buffers allocated by ReserveRenderData, is called for different objects from several threads at once
 
     void SetLodIndex(const int32 lodIndex);
     void SetSwitchIndex(const int32 switchIndex);
@@ -19,9 +19,18 @@
 #include "Scene3D/Systems/QualitySettingsSystem.h"
 #include "Debug/ProfilerGPU.h"
 #include "Debug/ProfilerMarkerNames.h"
+#include "Engine/Engine.h"
+#include "Engine/EngineContext.h"
+#include "Job/JobManager.h"
 
 namespace DAVA
 {
+namespace RenderPassDetails
+{
+// Min count of objects with deferred render data to fill it in the worker-threads
+const uint32 PARALLEL_MIN_DEFERRED_OBJECTS_COUNT = 8;
+}
+
 RenderPass::RenderPass(const FastName& _name)
     : passName(_name)
 {
@@ -121,7 +130,7 @@ void RenderPass::PrepareVisibilityArrays(Camera* camera, RenderSystem* renderSys
         currVisibilityCriteria &= ~RenderObject::VISIBLE_STATIC_OCCLUSION;
 
     visibilityArray.clear();
-    renderSystem->GetRenderHierarchy()->Clip(camera, visibilityArray, currVisibilityCriteria);
+    renderSystem->Clip(camera, visibilityArray, currVisibilityCriteria);
 
     ClearLayersArrays();
     PrepareLayersArrays(visibilityArray, camera);
@@ -133,9 +142,18 @@ void RenderPass::PrepareLayersArrays(const Vector<RenderObject*> objectsArray, C
     for (size_t ro = 0; ro < size; ++ro)
     {
         RenderObject* renderObject = objectsArray[ro];
-        if (renderObject->GetFlags() & RenderObject::CUSTOM_PREPARE_TO_RENDER)
+        uint32 flags = renderObject->GetFlags();
+        if (flags & RenderObject::CUSTOM_PREPARE_TO_RENDER)
         {
-            renderObject->PrepareToRender(camera);
+            if (flags & RenderObject::DEFERRED_RENDER_DATA)
+            {
+                renderObject->ReserveRenderData(camera);
+                deferredRenderDataObjects.push_back(renderObject);
+            }
+            else
+            {
+                renderObject->PrepareToRender(camera);
+            }
         }
 
         uint32 batchCount = renderObject->GetActiveRenderBatchCount();
@@ -151,6 +169,31 @@ void RenderPass::PrepareLayersArrays(const Vector<RenderObject*> objectsArray, C
             }
         }
     }
+    FillDeferredRenderData();
+}
+
+void RenderPass::FillDeferredRenderData()
+{
+    uint32 count = static_cast<uint32>(deferredRenderDataObjects.size());
+    JobManager* jobManager = GetEngineContext()->jobManager;
+    if (nullptr != jobManager && jobManager->GetWorkersCount() > 0 && count >= RenderPassDetails::PARALLEL_MIN_DEFERRED_OBJECTS_COUNT)
+    {
+        // buffers are reserved by objects beforehand and don't intersect, so they can be filled concurrently
+        jobManager->ParallelFor(0, count, [this](uint32 begin, uint32 end) {
+            for (uint32 i = begin; i < end; ++i)
+            {
+                deferredRenderDataObjects[i]->FillRenderData();
+            }
+        });
+    }
+    else
+    {
+        for (RenderObject* renderObject : deferredRenderDataObjects)
+        {
+            renderObject->FillRenderData();
+        }
+    }
+    deferredRenderDataObjects.clear();
 }
 
 void RenderPass::DrawLayers(Camera* camera)
@@ -443,7 +486,7 @@ void WaterReflectionRenderPass::Draw(RenderSystem* renderSystem)
     SetupCameraParams(currMainCamera, currDrawCamera, &clipPlane);
 
     visibilityArray.clear();
-    renderSystem->GetRenderHierarchy()->Clip(currMainCamera, visibilityArray, RenderObject::CLIPPING_VISIBILITY_CRITERIA | RenderObject::VISIBLE_REFLECTION);
+    renderSystem->Clip(currMainCamera, visibilityArray, RenderObject::CLIPPING_VISIBILITY_CRITERIA | RenderObject::VISIBLE_REFLECTION);
     ClearLayersArrays();
     PrepareLayersArrays(visibilityArray, currMainCamera);
 
@@ -495,7 +538,7 @@ void WaterRefractionRenderPass::Draw(RenderSystem* renderSystem)
     SetupCameraParams(currMainCamera, currDrawCamera, &clipPlane);
 
     visibilityArray.clear();
-    renderSystem->GetRenderHierarchy()->Clip(currMainCamera, visibilityArray, RenderObject::CLIPPING_VISIBILITY_CRITERIA | RenderObject::VISIBLE_REFRACTION);
+    renderSystem->Clip(currMainCamera, visibilityArray, RenderObject::CLIPPING_VISIBILITY_CRITERIA | RenderObject::VISIBLE_REFRACTION);
     ClearLayersArrays();
     PrepareLayersArrays(visibilityArray, currMainCamera);
 
@@ -11,6 +11,9 @@
 #include "Render/Highlevel/Camera.h"
 #include "Render/Highlevel/Light.h"
 #include "Render/Highlevel/VisibilityQuadTree.h"
+#include "Render/Highlevel/BVHRenderHierarchy.h"
+#include "Render/Highlevel/CullingSystem.h"
+#include "Render/Renderer.h"
 #include "Render/ShaderCache.h"
 
 #include "Utils/Utils.h"
@@ -40,6 +43,38 @@ RenderSystem::~RenderSystem()
     SafeDelete(geoDecalManager);
 }
 
+void RenderSystem::SetRenderHierarchyType(eRenderHierarchyType type)
+{
+    if (renderHierarchyType == type)
+        return;
+
+    for (RenderObject* renderObject : renderObjectArray)
+    {
+        renderHierarchy->RemoveRenderObject(renderObject);
+    }
+    SafeDelete(renderHierarchy);
+
+    renderHierarchyType = type;
+    if (type == RENDER_HIERARCHY_BVH)
+    {
+        renderHierarchy = new BVHRenderHierarchy();
+    }
+    else
+    {
+        renderHierarchy = new QuadTree(10);
+    }
+
+    for (RenderObject* renderObject : renderObjectArray)
+    {
+        renderHierarchy->AddRenderObject(renderObject);
+    }
+
+    if (hierarchyInitialized)
+    {
+        renderHierarchy->Initialize();
+    }
+}
+
 void RenderSystem::RenderPermanent(RenderObject* renderObject)
 {
     DVASSERT(renderObject->GetRemoveIndex() == static_cast<uint32>(-1));
@@ -50,6 +85,12 @@ void RenderSystem::RenderPermanent(RenderObject* renderObject)
     renderObject->SetRemoveIndex(static_cast<uint32>(renderObjectArray.size() - 1));
 
     AddRenderObject(renderObject);
+    lightGrid.UpdateObject(renderObject);
+
+    if (cullingSystem != nullptr)
+    {
+        cullingSystem->AddObject(renderObject);
+    }
 }
 
 void RenderSystem::RemoveFromRender(RenderObject* renderObject)
@@ -59,6 +100,11 @@ void RenderSystem::RemoveFromRender(RenderObject* renderObject)
     FindAndRemoveExchangingWithLast(markedObjects, renderObject);
     renderObject->RemoveFlag(RenderObject::MARKED_FOR_UPDATE);
 
+    if (cullingSystem != nullptr)
+    {
+        cullingSystem->RemoveObject(renderObject);
+    }
+
     RenderObject* lastRenderObject = renderObjectArray[renderObjectArray.size() - 1];
     renderObjectArray[renderObject->GetRemoveIndex()] = lastRenderObject;
     renderObjectArray.pop_back();
@@ -66,10 +112,34 @@ void RenderSystem::RemoveFromRender(RenderObject* renderObject)
     renderObject->SetRemoveIndex(-1);
 
     RemoveRenderObject(renderObject);
+    lightGrid.RemoveObject(renderObject);
 
     renderObject->Release();
 }
 
+void RenderSystem::Clip(Camera* camera, Vector<RenderObject*>& visibilityArray, uint32 visibilityCriteria)
+{
+    // quad tree can be replaced with batched test of all objects, BVH skips whole subtrees outside of frustum
+    if (cullingSystem != nullptr && renderHierarchyType != RENDER_HIERARCHY_BVH &&
+        Renderer::GetOptions()->IsOptionEnabled(RenderOptions::BATCHED_CULLING))
+    {
+        cullingSystem->Clip(camera, visibilityArray, visibilityCriteria);
+    }
+    else
+    {
+        renderHierarchy->Clip(camera, visibilityArray, visibilityCriteria);
+    }
+}
+
+void RenderSystem::SetCullingSystem(CullingSystem* cullingSystem_)
+{
+    cullingSystem = cullingSystem_;
+    if (cullingSystem != nullptr)
+    {
+        cullingSystem->RebuildObjects();
+    }
+}
+
 void RenderSystem::AddRenderObject(RenderObject* renderObject)
 {
     renderObject->RecalculateWorldBoundingBox();
@@ -202,7 +272,7 @@ void RenderSystem::MarkForUpdate(RenderObject* renderObject)
 
 void RenderSystem::MarkForUpdate(Light* lightNode)
 {
-    movedLights.push_back(lightNode);
+    changedLights.push_back(lightNode);
 }
 
 void RenderSystem::RegisterForUpdate(IRenderUpdatable* updatable)
@@ -226,53 +296,21 @@ void RenderSystem::UnregisterFromUpdate(IRenderUpdatable* updatable)
 
 void RenderSystem::UpdateNearestLights(RenderObject* renderObject)
 {
-    Light* nearestLight = nullptr;
-    float32 squareMinDistance = std::numeric_limits<float>::max();
-    Vector3 position = renderObject->GetWorldBoundingBox().GetCenter();
-
-    if (lights.size() == 1)
-    {
-        nearestLight = (lights.front() && lights.front()->IsDynamic()) ? lights.front() : nullptr;
-    }
-    else
-    {
-        for (Light* light : lights)
-        {
-            if (light->IsDynamic())
-            {
-                const Vector3& lightPosition = light->GetPosition();
-                float32 squareDistanceToLight = (position - lightPosition).SquareLength();
-                if ((!nearestLight) || (squareDistanceToLight < squareMinDistance))
-                {
-                    squareMinDistance = squareDistanceToLight;
-                    nearestLight = light;
-                }
-            }
-        }
-    }
-
-    renderObject->SetLight(0, nearestLight);
-}
-
-void RenderSystem::FindNearestLights()
-{
-    size_t size = renderObjectArray.size();
-    for (size_t k = 0; k < size; ++k)
-    {
-        UpdateNearestLights(renderObjectArray[k]);
-    }
+    lightGrid.UpdateObject(renderObject);
 }
 
 void RenderSystem::AddLight(Light* light)
 {
+    // added lights are put to grid in Update, at once for all lights of loaded scene
     lights.push_back(SafeRetain(light));
-    FindNearestLights();
+    changedLights.push_back(light);
 }
 
 void RenderSystem::RemoveLight(Light* light)
 {
     FindAndRemoveExchangingWithLast(lights, light);
-    FindNearestLights();
+    changedLights.erase(std::remove(changedLights.begin(), changedLights.end(), light), changedLights.end());
+    lightGrid.RemoveLight(light);
 
     SafeRelease(light);
 }
@@ -299,6 +337,8 @@ void RenderSystem::Update(float32 timeElapsed)
     {
         obj->RecalculateWorldBoundingBox();
         UpdateNearestLights(obj);
+        if (cullingSystem != nullptr)
+            cullingSystem->UpdateObject(obj);
 
         if (obj->GetTreeNodeIndex() != QuadTree::INVALID_TREE_NODE_INDEX)
             renderHierarchy->ObjectUpdated(obj);
@@ -309,11 +349,19 @@ void RenderSystem::Update(float32 timeElapsed)
 
     renderHierarchy->Update();
 
-    if (movedLights.size() > 0 || forceUpdateLights)
+    if (forceUpdateLights)
     {
-        FindNearestLights();
+        // flags of lights could be changed, so all lights are put to grid again
+        lightGrid.UpdateLights(lights);
         forceUpdateLights = false;
-        movedLights.clear();
+        changedLights.clear();
+    }
+    else if (changedLights.size() > 0)
+    {
+        std::sort(changedLights.begin(), changedLights.end());
+        changedLights.erase(std::unique(changedLights.begin(), changedLights.end()), changedLights.end());
+        lightGrid.UpdateLights(changedLights);
+        changedLights.clear();
     }
 
     uint32 size = static_cast<uint32>(objectsForUpdate.size());
@@ -5,6 +5,7 @@
 #include "Render/Highlevel/IRenderUpdatable.h"
 #include "Render/Highlevel/VisibilityQuadTree.h"
 #include "Render/Highlevel/GeoDecalManager.h"
+#include "Render/Highlevel/LightGrid.h"
 #include "Render/RenderHelper.h"
 
 namespace DAVA
@@ -19,10 +20,17 @@ class Light;
 class ParticleEmitterSystem;
 class RenderHierarchy;
 class NMaterial;
+class CullingSystem;
 
 class RenderSystem
 {
 public:
+    enum eRenderHierarchyType
+    {
+        RENDER_HIERARCHY_QUADTREE = 0,
+        RENDER_HIERARCHY_BVH
+    };
+
     RenderSystem();
     virtual ~RenderSystem();
 
@@ -31,6 +39,12 @@ public:
      */
     inline RenderHierarchy* GetRenderHierarchy() const;
 
+    /**
+        \brief Replace render hierarchy with hierarchy of given type. Objects already registered in the system are moved to the new hierarchy.
+     */
+    void SetRenderHierarchyType(eRenderHierarchyType type);
+    inline eRenderHierarchyType GetRenderHierarchyType() const;
+
     /**
         \brief Register render objects for permanent rendering
      */
@@ -41,6 +55,21 @@ public:
      */
     void RemoveFromRender(RenderObject* renderObject);
 
+    /**
+        \brief Get all render objects registered in the system
+     */
+    inline const Vector<RenderObject*>& GetRenderObjects() const;
+
+    /**
+        \brief Append objects with all of `visibilityCriteria` flags which are visible from `camera` to `visibilityArray`.
+        Render hierarchy is traversed, unless RenderOptions::BATCHED_CULLING is enabled, culling system is set
+        and hierarchy isn't BVH, then all objects are tested by culling system.
+     */
+    void Clip(Camera* camera, Vector<RenderObject*>& visibilityArray, uint32 visibilityCriteria);
+    /** Set system which boxes are kept in sync with render objects, boxes are filled from current objects. */
+    void SetCullingSystem(CullingSystem* cullingSystem);
+    inline CullingSystem* GetCullingSystem() const;
+
     /**
         \brief Register batch
      */
@@ -85,6 +114,11 @@ public:
     void SetForceUpdateLights();
     void UpdateNearestLights(RenderObject* renderObject);
 
+    /**
+        \brief Get spatial index of dynamic lights used to find the nearest light of render objects.
+     */
+    inline const LightGrid& GetLightGrid() const;
+
     void SetMainRenderTarget(rhi::HTexture color, rhi::HTexture depthStencil, rhi::LoadAction colorLoadAction, const Color& clearColor);
     void SetMainPassProperties(uint32 priority, const Rect& viewport, uint32 width, uint32 height, PixelFormat format);
     void SetAntialiasingAllowed(bool allowed);
@@ -115,7 +149,6 @@ public:
     DAVA_DEPRECATED(rhi::RenderPassConfig& GetMainPassConfig());
 
 private:
-    void FindNearestLights();
     void AddRenderObject(RenderObject* renderObject);
     void RemoveRenderObject(RenderObject* renderObject);
     void PrebuildMaterial(NMaterial* material);
@@ -126,12 +159,15 @@ private:
     Vector<IRenderUpdatable*> objectsForUpdate;
     Vector<RenderObject*> objectsForPermanentUpdate;
     Vector<RenderObject*> markedObjects;
-    Vector<Light*> movedLights;
+    Vector<Light*> changedLights; ///< Added and moved lights, put to light grid in Update.
     Vector<RenderObject*> renderObjectArray;
     Vector<Light*> lights;
+    LightGrid lightGrid;
 
     RenderPass* mainRenderPass = nullptr;
     RenderHierarchy* renderHierarchy = nullptr;
+    CullingSystem* cullingSystem = nullptr;
+    eRenderHierarchyType renderHierarchyType = RENDER_HIERARCHY_QUADTREE;
     Camera* mainCamera = nullptr;
     Camera* drawCamera = nullptr;
     NMaterial* globalMaterial = nullptr;
@@ -148,6 +184,26 @@ inline RenderHierarchy* RenderSystem::GetRenderHierarchy() const
     return renderHierarchy;
 }
 
+inline const Vector<RenderObject*>& RenderSystem::GetRenderObjects() const
+{
+    return renderObjectArray;
+}
+
+inline CullingSystem* RenderSystem::GetCullingSystem() const
+{
+    return cullingSystem;
+}
+
+inline const LightGrid& RenderSystem::GetLightGrid() const
+{
+    return lightGrid;
+}
+
+inline RenderSystem::eRenderHierarchyType RenderSystem::GetRenderHierarchyType() const
+{
+    return renderHierarchyType;
+}
+
 inline void RenderSystem::SetMainCamera(Camera* _camera)
 {
     SafeRelease(mainCamera);
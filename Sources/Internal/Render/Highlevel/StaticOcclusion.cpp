@@ -12,9 +12,49 @@
 #include "Render/2D/Systems/RenderSystem2D.h"
 #include "Engine/Engine.h"
 #include "Engine/EngineContext.h"
+#include "Base/ScopedPtr.h"
+#include "Job/JobManager.h"
+#include "Render/3D/PolygonGroup.h"
+#include "Render/Highlevel/Frustum.h"
+#include "Render/Highlevel/Heightmap.h"
+#include "Render/Highlevel/OcclusionRasterizer.h"
+#include "Render/Highlevel/RenderHierarchy.h"
+#include "Render/Highlevel/RenderLayer.h"
+#include "Render/Highlevel/RenderSystem.h"
+#include "Render/Material/FXCache.h"
+#include "Render/Material/NMaterial.h"
+#include "Scene3D/Systems/QualitySettingsSystem.h"
 
 namespace DAVA
 {
+namespace StaticOcclusionDetails
+{
+// Size of software depth buffer, pixel thresholds are scaled from size of GPU render target
+const uint32 SOFTWARE_RASTERIZER_SIZE = 256;
+// Max count of landscape quads per side drawn by software rasterizer
+const uint32 SOFTWARE_LANDSCAPE_GRID_SIZE = 256;
+// Count of camera configs rendered by one job
+const uint32 SOFTWARE_CONFIGS_PER_JOB = 8;
+// Clip range of software projection, rasterizer doesn't depend on it, but frustum should be built with the same one
+const bool SOFTWARE_ZERO_BASE_CLIP_RANGE = false;
+
+// Forward pass of material fx as described by its template, nullptr if fx has no such pass.
+// Unlike PreBuildMaterial, it doesn't compile shaders and doesn't acquire render states.
+const RenderPassDescriptor* GetForwardPassTemplate(NMaterial* material)
+{
+    const FastName& quality = QualitySettingsSystem::Instance()->GetCurMaterialQuality(material->GetQualityGroup());
+    const FXDescriptor& fxTemplate = FXCache::GetFXTemplate(material->GetEffectiveFXName(), quality);
+    for (const RenderPassDescriptor& pass : fxTemplate.renderPassDescriptors)
+    {
+        if (pass.passName == PASS_FORWARD)
+        {
+            return &pass;
+        }
+    }
+    return nullptr;
+}
+}
+
 StaticOcclusion::StaticOcclusion()
 {
     for (uint32 k = 0; k < 6; ++k)
@@ -36,7 +76,10 @@ StaticOcclusion::~StaticOcclusion()
 void StaticOcclusion::StartBuildOcclusion(StaticOcclusionData* _currentData, RenderSystem* _renderSystem, Landscape* _landscape, uint32 _occlusionPixelThreshold, uint32 _occlusionPixelThresholdForSpeedtree)
 {
     lastInfoMessage = "Preparing to build static occlusion...";
-    staticOcclusionRenderPass = new StaticOcclusionRenderPass(PASS_FORWARD);
+    if (!softwareRasterization)
+    {
+        staticOcclusionRenderPass = new StaticOcclusionRenderPass(PASS_FORWARD);
+    }
 
     currentData = _currentData;
     occlusionAreaRect = currentData->bbox;
@@ -59,6 +102,21 @@ void StaticOcclusion::StartBuildOcclusion(StaticOcclusionData* _currentData, Ren
 
     occlusionPixelThreshold = _occlusionPixelThreshold;
     occlusionPixelThresholdForSpeedtree = _occlusionPixelThresholdForSpeedtree;
+
+    if (softwareRasterization)
+    {
+        PrepareSoftwareOccluders();
+    }
+}
+
+void StaticOcclusion::SetSoftwareRasterizationEnabled(bool enabled)
+{
+    softwareRasterization = enabled;
+}
+
+bool StaticOcclusion::IsSoftwareRasterizationEnabled() const
+{
+    return softwareRasterization;
 }
 
 AABBox3 StaticOcclusion::GetCellBox(uint32 x, uint32 y, uint32 z)
@@ -97,6 +155,11 @@ void StaticOcclusion::AdvanceToNextBlock()
 
 bool StaticOcclusion::ProcessBlock()
 {
+    if (softwareRasterization)
+    {
+        return ProcessBlockInSoftware();
+    }
+
     if (!ProcessRecorderQueries())
     {
         RenderCurrentBlock();
@@ -371,6 +434,253 @@ bool StaticOcclusion::ProcessRecorderQueries()
     return occlusionFrameResults.empty();
 }
 
+void StaticOcclusion::PrepareSoftwareOccluders()
+{
+    using namespace StaticOcclusionDetails;
+
+    softwareOccluders.clear();
+
+    Vector<RenderObject*> renderObjects;
+    RenderHierarchy* renderHierarchy = renderSystem->GetRenderHierarchy();
+    renderHierarchy->GetAllObjectsInBBox(renderHierarchy->GetWorldBoundingBox(), renderObjects);
+
+    const float32 pixelsScale = static_cast<float32>(SOFTWARE_RASTERIZER_SIZE * SOFTWARE_RASTERIZER_SIZE) /
+    static_cast<float32>(StaticOcclusionRenderPass::RENDER_TARGET_SIZE * StaticOcclusionRenderPass::RENDER_TARGET_SIZE);
+    const uint32 visibilityCriteria = RenderObject::CLIPPING_VISIBILITY_CRITERIA & ~RenderObject::VISIBLE_STATIC_OCCLUSION;
+
+    for (RenderObject* renderObject : renderObjects)
+    {
+        uint32 flags = renderObject->GetFlags();
+        if ((flags & visibilityCriteria) != visibilityCriteria)
+            continue;
+
+        RenderObject::eType objectType = renderObject->GetType();
+        if (objectType == RenderObject::TYPE_LANDSCAPE)
+        {
+            AddLandscapeOccluder(static_cast<Landscape*>(renderObject));
+            continue;
+        }
+
+        // objects with custom geometry (particles, vegetation, etc.) have no static polygon groups
+        if (objectType == RenderObject::TYPE_PARTICLE_EMITTER || (flags & RenderObject::CUSTOM_PREPARE_TO_RENDER) != 0)
+            continue;
+
+        // the same as StaticOcclusionRenderPass::ShouldDisableDepthWrite
+        bool isSwitchObject = false;
+        for (uint32 i = 0; i < renderObject->GetRenderBatchCount(); ++i)
+        {
+            int32 lodIndex = -1;
+            int32 switchIndex = -1;
+            renderObject->GetRenderBatch(i, lodIndex, switchIndex);
+            isSwitchObject |= (switchIndex > 0);
+        }
+
+        const Matrix4& worldMatrix = *renderObject->GetWorldMatrixPtr();
+        uint16 occlusionIndex = renderObject->GetStaticOcclusionIndex();
+        uint32 pixelThreshold = (objectType == RenderObject::TYPE_SPEED_TREE) ? occlusionPixelThresholdForSpeedtree : occlusionPixelThreshold;
+
+        for (uint32 i = 0; i < renderObject->GetActiveRenderBatchCount(); ++i)
+        {
+            RenderBatch* batch = renderObject->GetActiveRenderBatch(i);
+            NMaterial* material = batch->GetMaterial();
+            PolygonGroup* polygonGroup = batch->GetPolygonGroup();
+            if (material == nullptr)
+                continue;
+
+            // only layers of StaticOcclusionRenderPass are drawn
+            const RenderPassDescriptor* forwardPass = GetForwardPassTemplate(material);
+            if (forwardPass == nullptr || forwardPass->renderLayer > RenderLayer::RENDER_LAYER_AFTER_TRANSLUCENT_ID)
+                continue;
+
+            if (polygonGroup == nullptr || polygonGroup->vertexArray == nullptr || polygonGroup->indexArray == nullptr || polygonGroup->GetPrimitiveType() != rhi::PRIMITIVE_TRIANGLELIST)
+                continue;
+
+            int32 startIndex = static_cast<int32>(batch->startIndex);
+            int32 endIndex = Min(startIndex + polygonGroup->GetPrimitiveCount() * 3, polygonGroup->GetIndexCount());
+            if (endIndex <= startIndex)
+                continue;
+
+            softwareOccluders.emplace_back();
+            SoftwareOccluder& occluder = softwareOccluders.back();
+            occluder.objectBox = renderObject->GetWorldBoundingBox();
+            occluder.pixelThreshold = static_cast<float32>(pixelThreshold) * pixelsScale;
+            occluder.occlusionIndex = occlusionIndex;
+            occluder.isOcclusionObject = (occlusionIndex != INVALID_STATIC_OCCLUSION_INDEX);
+            // alpha-tested and alpha-blended as render variant of material defines them
+            const static FastName ALPHATEST_DEFINE("ALPHATEST");
+            bool isAlphaTested = forwardPass->templateDefines.count(ALPHATEST_DEFINE) != 0;
+            occluder.depthWrite = !isSwitchObject && !isAlphaTested && !forwardPass->hasBlend;
+
+            occluder.vertices.resize(endIndex - startIndex);
+            for (int32 k = startIndex; k < endIndex; ++k)
+            {
+                int32 index = 0;
+                Vector3 position;
+                polygonGroup->GetIndex(k, index);
+                polygonGroup->GetCoord(index, position);
+                occluder.vertices[k - startIndex] = position * worldMatrix;
+            }
+        }
+    }
+}
+
+void StaticOcclusion::AddLandscapeOccluder(Landscape* landscapeObject)
+{
+    using namespace StaticOcclusionDetails;
+
+    Heightmap* heightmap = landscapeObject->GetHeightmap();
+    if (heightmap == nullptr || heightmap->Size() == 0)
+        return;
+
+    int32 heightmapSize = heightmap->Size();
+    int32 step = Max(1, heightmapSize / static_cast<int32>(SOFTWARE_LANDSCAPE_GRID_SIZE));
+    int32 pointsCount = (heightmapSize + step - 1) / step + 1;
+
+    const AABBox3& bbox = landscapeObject->GetBoundingBox();
+    const Matrix4& worldMatrix = *landscapeObject->GetWorldMatrixPtr();
+    Vector<Vector3> points;
+    points.reserve(pointsCount * pointsCount);
+    for (int32 y = 0; y < pointsCount; ++y)
+    {
+        for (int32 x = 0; x < pointsCount; ++x)
+        {
+            uint16 heightmapX = static_cast<uint16>(Min(x * step, heightmapSize));
+            uint16 heightmapY = static_cast<uint16>(Min(y * step, heightmapSize));
+            points.push_back(heightmap->GetPoint(heightmapX, heightmapY, bbox) * worldMatrix);
+        }
+    }
+
+    softwareOccluders.emplace_back();
+    SoftwareOccluder& occluder = softwareOccluders.back();
+    occluder.objectBox = landscapeObject->GetWorldBoundingBox();
+    occluder.isLandscape = true;
+    occluder.vertices.reserve((pointsCount - 1) * (pointsCount - 1) * 6);
+    for (int32 y = 0; y + 1 < pointsCount; ++y)
+    {
+        for (int32 x = 0; x + 1 < pointsCount; ++x)
+        {
+            const Vector3& p00 = points[x + y * pointsCount];
+            const Vector3& p10 = points[x + 1 + y * pointsCount];
+            const Vector3& p01 = points[x + (y + 1) * pointsCount];
+            const Vector3& p11 = points[x + 1 + (y + 1) * pointsCount];
+            occluder.vertices.insert(occluder.vertices.end(), { p00, p10, p11, p00, p11, p01 });
+        }
+    }
+}
+
+bool StaticOcclusion::ProcessBlockInSoftware()
+{
+    using namespace StaticOcclusionDetails;
+
+    AdvanceToNextBlock();
+    if (currentFrameZ >= zBlockCount) // all blocks processed
+    {
+        UpdateInfoString();
+        return true;
+    }
+
+    BuildRenderPassConfigsForCurrentBlock();
+
+    // matrices are built as cameras build them, but with clip range of software rasterization instead of render device one
+    const Camera* camera = cameras[0];
+    float32 zNear = camera->GetZNear();
+    float32 zFar = camera->GetZFar();
+    Matrix4 projection;
+    projection.BuildPerspective(camera->GetXMin(), camera->GetXMax(), camera->GetYMin(), camera->GetYMax(), zNear, zFar, SOFTWARE_ZERO_BASE_CLIP_RANGE);
+
+    uint32 configsCount = static_cast<uint32>(renderPassConfigs.size());
+    Vector<Matrix4> viewProjections(configsCount);
+    for (uint32 i = 0; i < configsCount; ++i)
+    {
+        const RenderPassCameraConfig& config = renderPassConfigs[i];
+        Matrix4 view;
+        view.BuildLookAtMatrix(config.position, config.position + config.direction, config.up);
+        viewProjections[i] = view * projection;
+    }
+
+    Vector<Vector<uint16>> visibleObjects(configsCount);
+    auto renderConfigs = [&](uint32 begin, uint32 end) {
+        OcclusionRasterizer rasterizer(SOFTWARE_RASTERIZER_SIZE);
+        ScopedPtr<Frustum> frustum(new Frustum());
+        for (uint32 i = begin; i < end; ++i)
+        {
+            RenderInSoftware(viewProjections[i], SOFTWARE_ZERO_BASE_CLIP_RANGE, renderPassConfigs[i].position, zNear, zFar, rasterizer, frustum, visibleObjects[i]);
+        }
+    };
+
+    JobManager* jobManager = GetEngineContext()->jobManager;
+    if (nullptr != jobManager && jobManager->GetWorkersCount() > 0)
+    {
+        jobManager->ParallelFor(0, configsCount, renderConfigs, SOFTWARE_CONFIGS_PER_JOB);
+    }
+    else
+    {
+        renderConfigs(0, configsCount);
+    }
+
+    uint32 blockIndex = currentFrameX + currentFrameY * xBlockCount + currentFrameZ * xBlockCount * yBlockCount;
+    for (const Vector<uint16>& configVisibleObjects : visibleObjects)
+    {
+        for (uint16 objectIndex : configVisibleObjects)
+        {
+            currentData->EnableVisibilityForObject(blockIndex, objectIndex);
+        }
+    }
+    renderPassConfigs.clear();
+
+    auto currentTime = SystemTimer::GetNs();
+    stats.buildDuration += static_cast<double>(currentTime - stats.blockProcessingTime) / 1e+9;
+    stats.blockProcessingTime = currentTime;
+
+    UpdateInfoString();
+    return false;
+}
+
+void StaticOcclusion::RenderInSoftware(const Matrix4& viewProjection, bool zeroBaseClipRange, const Vector3& cameraPosition, float32 zNear, float32 zFar,
+                                       OcclusionRasterizer& rasterizer, Frustum* frustum, Vector<uint16>& visibleObjects) const
+{
+    frustum->Build(viewProjection, zeroBaseClipRange);
+    rasterizer.Begin(viewProjection, zNear, zFar);
+
+    // landscape is drawn first, meshes are drawn from near to far, as StaticOcclusionRenderPass does
+    Vector<std::pair<uint32, uint32>> meshesOrder;
+    for (uint32 i = 0; i < static_cast<uint32>(softwareOccluders.size()); ++i)
+    {
+        const SoftwareOccluder& occluder = softwareOccluders[i];
+        if (!frustum->IsInside(occluder.objectBox))
+            continue;
+
+        if (occluder.isLandscape)
+        {
+            rasterizer.DrawTriangles(occluder.vertices.data(), static_cast<uint32>(occluder.vertices.size()), true);
+        }
+        else
+        {
+            uint32 distanceKey = static_cast<uint32>((occluder.objectBox.GetCenter() - cameraPosition).SquareLength() * 100.0f);
+            meshesOrder.emplace_back(distanceKey, i);
+        }
+    }
+    std::sort(meshesOrder.begin(), meshesOrder.end());
+
+    // pixels are summed over all batches of object, as samples of occlusion queries in the same frame
+    UnorderedMap<uint16, uint32> samplesPassed;
+    for (const std::pair<uint32, uint32>& mesh : meshesOrder)
+    {
+        const SoftwareOccluder& occluder = softwareOccluders[mesh.second];
+        uint32 pixels = rasterizer.DrawTriangles(occluder.vertices.data(), static_cast<uint32>(occluder.vertices.size()), occluder.depthWrite);
+        if (occluder.isOcclusionObject && pixels > 0)
+        {
+            uint32& objectPixels = samplesPassed[occluder.occlusionIndex];
+            bool wasVisible = static_cast<float32>(objectPixels) > occluder.pixelThreshold;
+            objectPixels += pixels;
+            if (!wasVisible && static_cast<float32>(objectPixels) > occluder.pixelThreshold)
+            {
+                visibleObjects.push_back(occluder.occlusionIndex);
+            }
+        }
+    }
+}
+
 // helper function, see implementation below
 namespace helper
 {
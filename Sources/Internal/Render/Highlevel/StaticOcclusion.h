@@ -18,6 +18,8 @@ class RenderSystem;
 class Scene;
 class Sprite;
 class Landscape;
+class OcclusionRasterizer;
+class Frustum;
 
 class StaticOcclusionData
 {
@@ -64,6 +66,12 @@ public:
     StaticOcclusion();
     ~StaticOcclusion();
 
+    // Build occlusion on CPU: occluders are drawn by OcclusionRasterizer in the worker threads instead of GPU
+    // with occlusion queries. Materials are read from fx templates and matrices are built with own clip range,
+    // so no shaders are compiled and render device isn't used. Should be set before StartBuildOcclusion.
+    void SetSoftwareRasterizationEnabled(bool enabled);
+    bool IsSoftwareRasterizationEnabled() const;
+
     void StartBuildOcclusion(StaticOcclusionData* currentData, RenderSystem* renderSystem, Landscape* landscape, uint32 occlusionPixelThreshold, uint32 occlusionPixelThresholdForSpeedtree);
     bool ProcessBlock(); // returns true if finished building
     void AdvanceToNextBlock();
@@ -102,6 +110,24 @@ private:
     bool RenderCurrentBlock(); // returns true, if all passes for block completed
     bool PerformRender(const RenderPassCameraConfig&);
 
+    // Geometry of render batch in world space, drawn by software rasterizer
+    struct SoftwareOccluder
+    {
+        Vector<Vector3> vertices; // triangle list
+        AABBox3 objectBox; // world bounding box of render object, used for culling and drawing order as in StaticOcclusionRenderPass
+        float32 pixelThreshold = 0.0f;
+        uint16 occlusionIndex = 0;
+        bool isOcclusionObject = false;
+        bool isLandscape = false;
+        bool depthWrite = true;
+    };
+
+    void PrepareSoftwareOccluders();
+    void AddLandscapeOccluder(Landscape* landscape);
+    bool ProcessBlockInSoftware(); // returns true if finished building
+    void RenderInSoftware(const Matrix4& viewProjection, bool zeroBaseClipRange, const Vector3& cameraPosition, float32 zNear, float32 zFar,
+                          OcclusionRasterizer& rasterizer, Frustum* frustum, Vector<uint16>& visibleObjects) const;
+
 private:
     std::array<Camera*, 6> cameras;
     StaticOcclusionRenderPass* staticOcclusionRenderPass = nullptr;
@@ -121,6 +147,8 @@ private:
     uint32 currentFrameZ = 0;
     uint32 occlusionPixelThreshold = 0;
     uint32 occlusionPixelThresholdForSpeedtree = 0;
+    bool softwareRasterization = false;
+    Vector<SoftwareOccluder> softwareOccluders;
 };
 };
 
@@ -9,7 +9,7 @@
 
 namespace DAVA
 {
-const uint32 OCCLUSION_RENDER_TARGET_SIZE = 1024;
+const uint32 OCCLUSION_RENDER_TARGET_SIZE = StaticOcclusionRenderPass::RENDER_TARGET_SIZE;
 
 StaticOcclusionRenderPass::StaticOcclusionRenderPass(const FastName& name)
     : RenderPass(name)
@@ -20,6 +20,8 @@ class StaticOcclusionData;
 class StaticOcclusionRenderPass : public RenderPass
 {
 public:
+    static const uint32 RENDER_TARGET_SIZE = 1024;
+
     StaticOcclusionRenderPass(const FastName& name);
     ~StaticOcclusionRenderPass();
 
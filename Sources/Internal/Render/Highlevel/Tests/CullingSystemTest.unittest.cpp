@@ -0,0 +1,415 @@
+#include "UnitTests/UnitTests.h"
+
+#include "Base/ScopedPtr.h"
+#include "Logger/Logger.h"
+#include "Render/Highlevel/Camera.h"
+#include "Render/Highlevel/CullingSystem.h"
+#include "Render/Highlevel/Frustum.h"
+#include "Render/Highlevel/RenderObject.h"
+#include "Render/Highlevel/RenderSystem.h"
+#include "Render/Renderer.h"
+#include "Concurrency/Thread.h"
+#include "Scene3D/Scene.h"
+#include "Time/SystemTimer.h"
+#include "Utils/Random.h"
+
+#include <algorithm>
+
+namespace CullingSystemTestDetails
+{
+using namespace DAVA;
+
+const uint32 BOXES_COUNT = 100003; // not multiple of 4 to test tail of last batch
+const uint32 ITERATIONS_COUNT = 20;
+const uint32 LEVEL_OBJECTS_COUNT = 20000;
+
+void GenerateBoxes(uint32 count, Vector<AABBox3>& boxes)
+{
+    Random random(12345);
+    boxes.resize(count);
+    for (AABBox3& box : boxes)
+    {
+        Vector3 center(random.RandFloat32InBounds(-500.0f, 500.0f), random.RandFloat32InBounds(-500.0f, 500.0f), random.RandFloat32InBounds(-50.0f, 50.0f));
+        Vector3 halfSize(random.RandFloat32InBounds(0.1f, 10.0f), random.RandFloat32InBounds(0.1f, 10.0f), random.RandFloat32InBounds(0.1f, 10.0f));
+        box = AABBox3(center - halfSize, center + halfSize);
+    }
+}
+
+void SetupCamera(Camera* camera)
+{
+    camera->SetupPerspective(70.0f, 1.0f, 1.0f, 400.0f);
+    camera->SetUp(Vector3(0.0f, 0.0f, 1.0f));
+    camera->SetPosition(Vector3(0.0f, 0.0f, 20.0f));
+    camera->SetTarget(Vector3(100.0f, 100.0f, 0.0f));
+}
+
+void SetupFrustum(Frustum* frustum)
+{
+    ScopedPtr<Camera> camera(new Camera());
+    SetupCamera(camera);
+    frustum->Build(camera->GetViewProjMatrix(), false);
+}
+
+// objects of game level: buildings, trees and props standing on ground of 2x2 km, several of them are much bigger
+void GenerateLevelBoxes(uint32 count, Vector<AABBox3>& boxes)
+{
+    Random random(54321);
+    boxes.resize(count);
+    for (uint32 i = 0; i < count; ++i)
+    {
+        float32 size = (i % 100 == 0) ? random.RandFloat32InBounds(50.0f, 200.0f) : random.RandFloat32InBounds(0.5f, 15.0f);
+        Vector3 position(random.RandFloat32InBounds(-1000.0f, 1000.0f), random.RandFloat32InBounds(-1000.0f, 1000.0f), 0.0f);
+        boxes[i] = AABBox3(position - Vector3(size, size, 0.0f), position + Vector3(size, size, size * 2.0f));
+    }
+}
+
+// render objects registered in render system of scene, objects are released by RemoveObjects
+class SceneObjects
+{
+public:
+    SceneObjects(RenderSystem* renderSystem_, const Vector<AABBox3>& boxes)
+        : renderSystem(renderSystem_)
+        , transforms(boxes.size(), Matrix4::IDENTITY)
+    {
+        for (size_t i = 0; i < boxes.size(); ++i)
+        {
+            RenderObject* object = new RenderObject();
+            object->SetAABBox(boxes[i]);
+            object->SetWorldMatrixPtr(&transforms[i]);
+            renderSystem->RenderPermanent(object);
+            objects.push_back(object);
+        }
+    }
+
+    ~SceneObjects()
+    {
+        for (RenderObject* object : objects)
+        {
+            renderSystem->RemoveFromRender(object);
+            SafeRelease(object);
+        }
+    }
+
+    RenderSystem* renderSystem;
+    Vector<Matrix4> transforms;
+    Vector<RenderObject*> objects;
+};
+
+Vector<RenderObject*> SortedObjects(Vector<RenderObject*> objects)
+{
+    std::sort(objects.begin(), objects.end());
+    return objects;
+}
+
+// boxes of culling system are world boxes of render objects with the same indices
+bool BoxesMatchObjects(const CullingSystem::BoundingBoxes& boxes, const Vector<RenderObject*>& objects)
+{
+    if (boxes.count != objects.size())
+        return false;
+
+    for (uint32 i = 0; i < boxes.count; ++i)
+    {
+        const AABBox3& box = objects[i]->GetWorldBoundingBox();
+        if (boxes.minX[i] != box.min.x || boxes.minY[i] != box.min.y || boxes.minZ[i] != box.min.z ||
+            boxes.maxX[i] != box.max.x || boxes.maxY[i] != box.max.y || boxes.maxZ[i] != box.max.z)
+            return false;
+    }
+    return true;
+}
+}
+
+DAVA_TESTCLASS (CullingSystemTest)
+{
+    DAVA_TEST (ClipBoxesMatchesFrustum)
+    {
+        using namespace DAVA;
+        using namespace CullingSystemTestDetails;
+
+        ScopedPtr<Frustum> frustum(new Frustum());
+        SetupFrustum(frustum);
+
+        Vector<AABBox3> boxes;
+        GenerateBoxes(BOXES_COUNT, boxes);
+
+        CullingSystem::BoundingBoxes soaBoxes;
+        soaBoxes.Resize(BOXES_COUNT);
+        for (uint32 i = 0; i < BOXES_COUNT; ++i)
+        {
+            soaBoxes.Set(i, boxes[i]);
+        }
+
+        Vector<uint32> scalarVisible;
+        for (uint32 i = 0; i < BOXES_COUNT; ++i)
+        {
+            if (frustum->IsInside(boxes[i]))
+            {
+                scalarVisible.push_back(i);
+            }
+        }
+
+        Vector<uint32> batchedVisible;
+        CullingSystem::ClipBoxes(frustum, soaBoxes, 0, BOXES_COUNT, batchedVisible);
+
+        TEST_VERIFY(!scalarVisible.empty());
+        TEST_VERIFY(scalarVisible == batchedVisible);
+    }
+
+    DAVA_TEST (SceneClipsWithCullingSystem)
+    {
+        using namespace DAVA;
+        using namespace CullingSystemTestDetails;
+
+        ScopedPtr<Scene> scene(new Scene());
+        RenderSystem* renderSystem = scene->GetRenderSystem();
+        TEST_VERIFY(scene->cullingSystem != nullptr);
+        TEST_VERIFY(renderSystem->GetCullingSystem() == scene->cullingSystem);
+
+        Vector<AABBox3> boxes;
+        GenerateBoxes(5000, boxes);
+        SceneObjects sceneObjects(renderSystem, boxes);
+        renderSystem->Update(0.0f);
+
+        ScopedPtr<Camera> camera(new Camera());
+        SetupCamera(camera);
+        camera->GetFrustum()->Build(camera->GetViewProjMatrix(), false);
+
+        Vector<RenderObject*> expectedVisible;
+        for (RenderObject* object : sceneObjects.objects)
+        {
+            if (camera->GetFrustum()->IsInside(object->GetWorldBoundingBox()))
+            {
+                expectedVisible.push_back(object);
+            }
+        }
+        TEST_VERIFY(!expectedVisible.empty());
+        expectedVisible = SortedObjects(expectedVisible);
+
+        // quad tree is used by default, culling system is opt-in
+        RenderOptions* options = Renderer::GetOptions();
+        bool batchedCulling = options->IsOptionEnabled(RenderOptions::BATCHED_CULLING);
+        TEST_VERIFY(!RenderOptions().IsOptionEnabled(RenderOptions::BATCHED_CULLING));
+        for (bool enabled : { false, true })
+        {
+            options->SetOption(RenderOptions::BATCHED_CULLING, enabled);
+            Vector<RenderObject*> visible;
+            renderSystem->Clip(camera, visible, RenderObject::CLIPPING_VISIBILITY_CRITERIA);
+            TEST_VERIFY(SortedObjects(visible) == expectedVisible);
+        }
+        options->SetOption(RenderOptions::BATCHED_CULLING, batchedCulling);
+    }
+
+    DAVA_TEST (BoxesFollowRenderObjects)
+    {
+        using namespace DAVA;
+        using namespace CullingSystemTestDetails;
+
+        ScopedPtr<Scene> scene(new Scene());
+        RenderSystem* renderSystem = scene->GetRenderSystem();
+        CullingSystem* cullingSystem = scene->cullingSystem;
+
+        Vector<AABBox3> boxes;
+        GenerateBoxes(1000, boxes);
+        SceneObjects sceneObjects(renderSystem, boxes);
+        TEST_VERIFY(BoxesMatchObjects(cullingSystem->GetBoundingBoxes(), renderSystem->GetRenderObjects()));
+
+        // move some objects in front of camera
+        ScopedPtr<Camera> camera(new Camera());
+        SetupCamera(camera);
+        camera->GetFrustum()->Build(camera->GetViewProjMatrix(), false);
+        Vector<RenderObject*> movedObjects;
+        for (uint32 i = 0; i < sceneObjects.objects.size(); i += 10)
+        {
+            RenderObject* object = sceneObjects.objects[i];
+            sceneObjects.transforms[i].SetTranslationVector(Vector3(50.0f, 50.0f, 0.0f) - object->GetBoundingBox().GetCenter());
+            renderSystem->MarkForUpdate(object);
+            movedObjects.push_back(object);
+        }
+        renderSystem->Update(0.0f);
+        TEST_VERIFY(BoxesMatchObjects(cullingSystem->GetBoundingBoxes(), renderSystem->GetRenderObjects()));
+
+        Vector<RenderObject*> visible;
+        cullingSystem->Clip(camera, visible, RenderObject::CLIPPING_VISIBILITY_CRITERIA);
+        std::sort(visible.begin(), visible.end());
+        TEST_VERIFY(std::all_of(movedObjects.begin(), movedObjects.end(), [&visible](RenderObject* object) {
+            return std::binary_search(visible.begin(), visible.end(), object);
+        }));
+
+        // removed objects are replaced with the last ones, as in render system
+        for (uint32 i = 0; i < 100; ++i)
+        {
+            renderSystem->RemoveFromRender(sceneObjects.objects[i * 7]);
+        }
+        TEST_VERIFY(BoxesMatchObjects(cullingSystem->GetBoundingBoxes(), renderSystem->GetRenderObjects()));
+        for (uint32 i = 0; i < 100; ++i)
+        {
+            renderSystem->RenderPermanent(sceneObjects.objects[i * 7]);
+        }
+        TEST_VERIFY(BoxesMatchObjects(cullingSystem->GetBoundingBoxes(), renderSystem->GetRenderObjects()));
+
+        // culling system set later gets boxes of all objects
+        CullingSystem otherSystem(scene);
+        renderSystem->SetCullingSystem(&otherSystem);
+        TEST_VERIFY(BoxesMatchObjects(otherSystem.GetBoundingBoxes(), renderSystem->GetRenderObjects()));
+        renderSystem->SetCullingSystem(cullingSystem);
+    }
+
+    DAVA_TEST (ClipFromSeveralThreads)
+    {
+        using namespace DAVA;
+        using namespace CullingSystemTestDetails;
+
+        ScopedPtr<Scene> scene(new Scene());
+        Vector<AABBox3> boxes;
+        GenerateBoxes(20000, boxes);
+        SceneObjects sceneObjects(scene->GetRenderSystem(), boxes);
+        // threads clip by themselves, without jobs of worker-threads
+        scene->cullingSystem->SetParallelCullingEnabled(false);
+
+        // two cameras look in opposite directions, e.g. main and reflection passes
+        Array<ScopedPtr<Camera>, 2> cameras = { { ScopedPtr<Camera>(new Camera()), ScopedPtr<Camera>(new Camera()) } };
+        Array<Vector<RenderObject*>, 2> expectedVisible;
+        for (uint32 c = 0; c < 2; ++c)
+        {
+            SetupCamera(cameras[c]);
+            cameras[c]->SetTarget(c == 0 ? Vector3(100.0f, 100.0f, 0.0f) : Vector3(-100.0f, -100.0f, 0.0f));
+            cameras[c]->GetFrustum()->Build(cameras[c]->GetViewProjMatrix(), false);
+            scene->cullingSystem->Clip(cameras[c], expectedVisible[c], RenderObject::CLIPPING_VISIBILITY_CRITERIA);
+            TEST_VERIFY(!expectedVisible[c].empty());
+        }
+        TEST_VERIFY(SortedObjects(expectedVisible[0]) != SortedObjects(expectedVisible[1]));
+
+        Array<uint32, 2> mismatchCount = { { 0, 0 } };
+        Vector<ScopedPtr<Thread>> threads;
+        for (uint32 c = 0; c < 2; ++c)
+        {
+            threads.emplace_back(Thread::Create([&scene, &cameras, &expectedVisible, &mismatchCount, c]() {
+                for (uint32 i = 0; i < ITERATIONS_COUNT; ++i)
+                {
+                    Vector<RenderObject*> visible;
+                    scene->cullingSystem->Clip(cameras[c], visible, RenderObject::CLIPPING_VISIBILITY_CRITERIA);
+                    if (visible != expectedVisible[c])
+                        ++mismatchCount[c];
+                }
+            }));
+            threads.back()->Start();
+        }
+        for (ScopedPtr<Thread>& thread : threads)
+        {
+            thread->Join();
+        }
+        TEST_VERIFY(mismatchCount[0] == 0 && mismatchCount[1] == 0);
+    }
+
+    DAVA_TEST (QuadTreeClipBenchmark)
+    {
+        using namespace DAVA;
+        using namespace CullingSystemTestDetails;
+
+        ScopedPtr<Scene> scene(new Scene());
+        RenderSystem* renderSystem = scene->GetRenderSystem();
+        Vector<AABBox3> boxes;
+        GenerateLevelBoxes(LEVEL_OBJECTS_COUNT, boxes);
+        SceneObjects sceneObjects(renderSystem, boxes);
+        renderSystem->Update(0.0f);
+
+        // camera walks over the level at height of player and turns around
+        const uint32 viewsCount = 16;
+        Vector<ScopedPtr<Camera>> cameras;
+        for (uint32 v = 0; v < viewsCount; ++v)
+        {
+            float32 angle = PI_2 * v / viewsCount;
+            Vector3 position(-800.0f + 100.0f * v, -400.0f + 50.0f * v, 2.0f);
+            ScopedPtr<Camera> camera(new Camera());
+            camera->SetupPerspective(70.0f, 16.0f / 9.0f, 1.0f, 1500.0f);
+            camera->SetUp(Vector3(0.0f, 0.0f, 1.0f));
+            camera->SetPosition(position);
+            camera->SetTarget(position + Vector3(std::cos(angle), std::sin(angle), -0.05f));
+            camera->GetFrustum()->Build(camera->GetViewProjMatrix(), false);
+            cameras.push_back(camera);
+        }
+
+        uint32 mismatchCount = 0;
+        uint32 visibleCount = 0;
+        for (ScopedPtr<Camera>& camera : cameras)
+        {
+            Vector<RenderObject*> treeVisible;
+            Vector<RenderObject*> batchedVisible;
+            renderSystem->GetRenderHierarchy()->Clip(camera, treeVisible, RenderObject::CLIPPING_VISIBILITY_CRITERIA);
+            scene->cullingSystem->Clip(camera, batchedVisible, RenderObject::CLIPPING_VISIBILITY_CRITERIA);
+            mismatchCount += (SortedObjects(treeVisible) != SortedObjects(batchedVisible)) ? 1 : 0;
+            visibleCount += static_cast<uint32>(treeVisible.size());
+        }
+        TEST_VERIFY(mismatchCount == 0);
+
+        Vector<RenderObject*> visible;
+        visible.reserve(LEVEL_OBJECTS_COUNT);
+        int64 treeTime = 0;
+        int64 batchedTime = 0;
+        for (bool batched : { false, true })
+        {
+            int64 startTime = SystemTimer::GetUs();
+            for (uint32 iteration = 0; iteration < ITERATIONS_COUNT; ++iteration)
+            {
+                for (ScopedPtr<Camera>& camera : cameras)
+                {
+                    visible.clear();
+                    if (batched)
+                        scene->cullingSystem->Clip(camera, visible, RenderObject::CLIPPING_VISIBILITY_CRITERIA);
+                    else
+                        renderSystem->GetRenderHierarchy()->Clip(camera, visible, RenderObject::CLIPPING_VISIBILITY_CRITERIA);
+                }
+            }
+            (batched ? batchedTime : treeTime) = (SystemTimer::GetUs() - startTime) / (ITERATIONS_COUNT * viewsCount);
+        }
+
+        Logger::Info("Clipping of level with %u objects (%u visible per view): QuadTree %lld us, CullingSystem %lld us",
+                     LEVEL_OBJECTS_COUNT, visibleCount / viewsCount, treeTime, batchedTime);
+    }
+
+    DAVA_TEST (ClipBoxesBenchmark)
+    {
+        using namespace DAVA;
+        using namespace CullingSystemTestDetails;
+
+        ScopedPtr<Frustum> frustum(new Frustum());
+        SetupFrustum(frustum);
+
+        Vector<AABBox3> boxes;
+        GenerateBoxes(BOXES_COUNT, boxes);
+
+        CullingSystem::BoundingBoxes soaBoxes;
+        soaBoxes.Resize(BOXES_COUNT);
+        for (uint32 i = 0; i < BOXES_COUNT; ++i)
+        {
+            soaBoxes.Set(i, boxes[i]);
+        }
+
+        Vector<uint32> visible;
+        visible.reserve(BOXES_COUNT);
+
+        int64 startTime = SystemTimer::GetUs();
+        for (uint32 iteration = 0; iteration < ITERATIONS_COUNT; ++iteration)
+        {
+            visible.clear();
+            for (uint32 i = 0; i < BOXES_COUNT; ++i)
+            {
+                if (frustum->IsInside(boxes[i]))
+                {
+                    visible.push_back(i);
+                }
+            }
+        }
+        int64 scalarTime = (SystemTimer::GetUs() - startTime) / ITERATIONS_COUNT;
+
+        startTime = SystemTimer::GetUs();
+        for (uint32 iteration = 0; iteration < ITERATIONS_COUNT; ++iteration)
+        {
+            visible.clear();
+            CullingSystem::ClipBoxes(frustum, soaBoxes, 0, BOXES_COUNT, visible);
+        }
+        int64 batchedTime = (SystemTimer::GetUs() - startTime) / ITERATIONS_COUNT;
+
+        Logger::Info("Culling of %u boxes: Frustum::IsInside %lld us, CullingSystem::ClipBoxes %lld us",
+                     BOXES_COUNT, scalarTime, batchedTime);
+    }
+};
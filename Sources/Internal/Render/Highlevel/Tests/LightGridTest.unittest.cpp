@@ -0,0 +1,369 @@
+#include "UnitTests/UnitTests.h"
+
+#include "Base/RefPtr.h"
+#include "Logger/Logger.h"
+#include "Render/Highlevel/Light.h"
+#include "Render/Highlevel/LightGrid.h"
+#include "Render/Highlevel/RenderObject.h"
+#include "Time/SystemTimer.h"
+#include "Utils/Random.h"
+
+namespace LightGridTestDetails
+{
+using namespace DAVA;
+
+const uint32 LIGHTS_COUNT = 500;
+const uint32 POSITIONS_COUNT = 20000;
+const float32 LEVEL_SIZE = 2000.0f;
+const uint32 MOVED_LIGHTS_COUNT = 100;
+
+Vector3 RandomPosition(Random& random)
+{
+    return Vector3(random.RandFloat32InBounds(-LEVEL_SIZE * 0.5f, LEVEL_SIZE * 0.5f), random.RandFloat32InBounds(-LEVEL_SIZE * 0.5f, LEVEL_SIZE * 0.5f), random.RandFloat32InBounds(0.0f, 50.0f));
+}
+
+Vector<RefPtr<Light>> CreateLights(Random& random, uint32 count)
+{
+    Vector<RefPtr<Light>> lights;
+    for (uint32 i = 0; i < count; ++i)
+    {
+        RefPtr<Light> light(new Light());
+        light->SetPosition(RandomPosition(random));
+        light->SetDynamic(i % 5 != 0);
+        lights.push_back(light);
+    }
+    return lights;
+}
+
+// render objects at given positions, transforms should outlive objects
+class Objects
+{
+public:
+    Objects(Random& random, uint32 count)
+        : transforms(count, Matrix4::IDENTITY)
+    {
+        for (uint32 i = 0; i < count; ++i)
+        {
+            RefPtr<RenderObject> object(new RenderObject());
+            object->SetAABBox(AABBox3(Vector3(-1.0f, -1.0f, -1.0f), Vector3(1.0f, 1.0f, 1.0f)));
+            object->SetWorldMatrixPtr(&transforms[i]);
+            objects.push_back(object);
+            Move(i, RandomPosition(random));
+        }
+    }
+
+    void Move(uint32 index, const Vector3& position)
+    {
+        transforms[index].SetTranslationVector(position);
+        objects[index]->RecalculateWorldBoundingBox();
+    }
+
+    Vector<Matrix4> transforms;
+    Vector<RefPtr<RenderObject>> objects;
+};
+
+// the same as RenderSystem did before grid was introduced
+Light* FindNearestLightBruteForce(const Vector<RefPtr<Light>>& lights, const Vector3& position)
+{
+    Light* nearestLight = nullptr;
+    float32 squareMinDistance = std::numeric_limits<float32>::max();
+    for (const RefPtr<Light>& light : lights)
+    {
+        if (light->IsDynamic())
+        {
+            float32 squareDistance = (position - light->GetPosition()).SquareLength();
+            if (squareDistance < squareMinDistance)
+            {
+                squareMinDistance = squareDistance;
+                nearestLight = light.Get();
+            }
+        }
+    }
+    return nearestLight;
+}
+
+bool IsNearestLight(const Vector<RefPtr<Light>>& lights, const Vector3& position, Light* light)
+{
+    Light* expected = FindNearestLightBruteForce(lights, position);
+    if (expected == nullptr || light == nullptr)
+    {
+        return expected == light;
+    }
+    // lights at the same distance are equally good
+    return (position - expected->GetPosition()).SquareLength() == (position - light->GetPosition()).SquareLength();
+}
+
+bool HasNearestLights(const Vector<RefPtr<Light>>& lights, const Objects& objects)
+{
+    for (const RefPtr<RenderObject>& object : objects.objects)
+    {
+        if (!IsNearestLight(lights, object->GetWorldBoundingBox().GetCenter(), object->GetLight(0)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// the same as RenderSystem did for changed light before objects were put to grid: all objects are checked
+void UpdateLightsOfAllObjects(const LightGrid& lightsGrid, const Vector<RefPtr<RenderObject>>& objects, Light* changedLight)
+{
+    for (const RefPtr<RenderObject>& object : objects)
+    {
+        Light* currentLight = object->GetLight(0);
+        Vector3 position = object->GetWorldBoundingBox().GetCenter();
+        if (currentLight == changedLight)
+        {
+            object->SetLight(0, lightsGrid.FindNearestLight(position));
+        }
+        else if (currentLight == nullptr || (position - changedLight->GetPosition()).SquareLength() < (position - currentLight->GetPosition()).SquareLength())
+        {
+            object->SetLight(0, changedLight);
+        }
+    }
+}
+}
+
+DAVA_TESTCLASS (LightGridTest)
+{
+    BEGIN_FILES_COVERED_BY_TESTS()
+    FIND_FILES_IN_TARGET(DavaFramework)
+    DECLARE_COVERED_FILES("LightGrid.cpp")
+    END_FILES_COVERED_BY_TESTS();
+
+    DAVA_TEST (FindsNearestLight)
+    {
+        using namespace DAVA;
+        using namespace LightGridTestDetails;
+
+        Random random(12345);
+        Vector<RefPtr<Light>> lights = CreateLights(random, 50);
+
+        LightGrid grid(20.0f);
+        TEST_VERIFY(grid.FindNearestLight(Vector3()) == nullptr);
+
+        for (const RefPtr<Light>& light : lights)
+        {
+            grid.UpdateLight(light.Get());
+        }
+        TEST_VERIFY(grid.GetLightsCount() == 40);
+
+        auto verifyPositions = [&]() {
+            for (uint32 i = 0; i < 1000; ++i)
+            {
+                // some positions are far outside of lights bounds
+                Vector3 position = RandomPosition(random) * ((i % 10 == 0) ? 10.0f : 1.0f);
+                TEST_VERIFY(IsNearestLight(lights, position, grid.FindNearestLight(position)));
+            }
+        };
+        verifyPositions();
+
+        // move some lights, switch some of them to static and back
+        for (uint32 i = 0; i < lights.size(); i += 3)
+        {
+            lights[i]->SetPosition(RandomPosition(random));
+            lights[i]->SetDynamic(!lights[i]->IsDynamic());
+            grid.UpdateLight(lights[i].Get());
+        }
+        verifyPositions();
+
+        grid.SetCellSize(200.0f);
+        verifyPositions();
+
+        for (const RefPtr<Light>& light : lights)
+        {
+            grid.RemoveLight(light.Get());
+        }
+        TEST_VERIFY(grid.GetLightsCount() == 0);
+        TEST_VERIFY(grid.FindNearestLight(Vector3()) == nullptr);
+    }
+
+    DAVA_TEST (FindNearestLightBenchmark)
+    {
+        using namespace DAVA;
+        using namespace LightGridTestDetails;
+
+        Random random(54321);
+        Vector<RefPtr<Light>> lights = CreateLights(random, LIGHTS_COUNT);
+        Vector<Vector3> positions(POSITIONS_COUNT);
+        for (Vector3& position : positions)
+        {
+            position = RandomPosition(random);
+        }
+
+        int64 startTime = SystemTimer::GetUs();
+        Vector<Light*> bruteForceLights(POSITIONS_COUNT);
+        for (uint32 i = 0; i < POSITIONS_COUNT; ++i)
+        {
+            bruteForceLights[i] = FindNearestLightBruteForce(lights, positions[i]);
+        }
+        int64 bruteForceTime = SystemTimer::GetUs() - startTime;
+
+        startTime = SystemTimer::GetUs();
+        LightGrid grid;
+        for (const RefPtr<Light>& light : lights)
+        {
+            grid.UpdateLight(light.Get());
+        }
+        Vector<Light*> gridLights(POSITIONS_COUNT);
+        for (uint32 i = 0; i < POSITIONS_COUNT; ++i)
+        {
+            gridLights[i] = grid.FindNearestLight(positions[i]);
+        }
+        int64 gridTime = SystemTimer::GetUs() - startTime;
+
+        for (uint32 i = 0; i < POSITIONS_COUNT; ++i)
+        {
+            TEST_VERIFY(IsNearestLight(lights, positions[i], gridLights[i]));
+        }
+
+        Logger::Info("Nearest of %u lights for %u objects: %lld us with loop over lights, %lld us with LightGrid (including build)",
+                     LIGHTS_COUNT, POSITIONS_COUNT, bruteForceTime, gridTime);
+    }
+
+    DAVA_TEST (ObjectsKeepNearestLight)
+    {
+        using namespace DAVA;
+        using namespace LightGridTestDetails;
+
+        Random random(23456);
+        Vector<RefPtr<Light>> lights = CreateLights(random, 50);
+        Objects objects(random, 2000);
+
+        LightGrid grid(20.0f);
+        for (const RefPtr<RenderObject>& object : objects.objects)
+        {
+            grid.UpdateObject(object.Get());
+            TEST_VERIFY(object->GetLight(0) == nullptr);
+        }
+        TEST_VERIFY(grid.GetObjectsCount() == 2000);
+
+        // all lights at once, like on loading
+        Vector<Light*> changedLights;
+        for (const RefPtr<Light>& light : lights)
+        {
+            changedLights.push_back(light.Get());
+        }
+        grid.UpdateLights(changedLights);
+        TEST_VERIFY(grid.GetLightsCount() == 40);
+        TEST_VERIFY(HasNearestLights(lights, objects));
+
+        // move lights one by one, switch some of them to static and back
+        for (uint32 i = 0; i < lights.size(); i += 3)
+        {
+            lights[i]->SetPosition(RandomPosition(random));
+            lights[i]->SetDynamic(!lights[i]->IsDynamic());
+            grid.UpdateLight(lights[i].Get());
+            TEST_VERIFY(HasNearestLights(lights, objects));
+        }
+
+        // several lights at once
+        changedLights.clear();
+        for (uint32 i = 1; i < lights.size(); i += 10)
+        {
+            lights[i]->SetPosition(RandomPosition(random));
+            changedLights.push_back(lights[i].Get());
+        }
+        grid.UpdateLights(changedLights);
+        TEST_VERIFY(HasNearestLights(lights, objects));
+
+        // some objects are moved far outside of lights bounds
+        for (uint32 i = 0; i < objects.objects.size(); i += 7)
+        {
+            objects.Move(i, RandomPosition(random) * ((i % 10 == 0) ? 10.0f : 1.0f));
+            grid.UpdateObject(objects.objects[i].Get());
+        }
+        TEST_VERIFY(HasNearestLights(lights, objects));
+
+        for (uint32 i = 2; i < lights.size(); i += 4)
+        {
+            grid.RemoveLight(lights[i].Get());
+            lights[i]->SetDynamic(false);
+            TEST_VERIFY(HasNearestLights(lights, objects));
+        }
+
+        grid.SetCellSize(200.0f);
+        TEST_VERIFY(grid.GetObjectsCount() == 2000);
+        TEST_VERIFY(HasNearestLights(lights, objects));
+
+        RenderObject* removedObject = objects.objects.back().Get();
+        grid.RemoveObject(removedObject);
+        TEST_VERIFY(removedObject->GetLight(0) == nullptr);
+        TEST_VERIFY(grid.GetObjectsCount() == 1999);
+
+        grid.Clear();
+        TEST_VERIFY(grid.GetLightsCount() == 0);
+        TEST_VERIFY(grid.GetObjectsCount() == 0);
+        for (const RefPtr<RenderObject>& object : objects.objects)
+        {
+            TEST_VERIFY(object->GetLight(0) == nullptr);
+        }
+    }
+
+    DAVA_TEST (MovedLightsBenchmark)
+    {
+        using namespace DAVA;
+        using namespace LightGridTestDetails;
+
+        Random random(65432);
+        Vector<RefPtr<Light>> lights = CreateLights(random, LIGHTS_COUNT);
+        Objects objects(random, POSITIONS_COUNT);
+        Objects gridObjects(random, 0);
+        for (const RefPtr<RenderObject>& object : objects.objects)
+        {
+            RefPtr<RenderObject> gridObject(new RenderObject());
+            gridObject->SetAABBox(object->GetBoundingBox());
+            gridObject->SetWorldMatrixPtr(object->GetWorldMatrixPtr());
+            gridObject->RecalculateWorldBoundingBox();
+            gridObjects.objects.push_back(gridObject);
+        }
+
+        LightGrid lightsGrid;
+        LightGrid grid;
+        Vector<Light*> allLights;
+        for (const RefPtr<Light>& light : lights)
+        {
+            allLights.push_back(light.Get());
+        }
+        lightsGrid.UpdateLights(allLights);
+        grid.UpdateLights(allLights);
+        for (uint32 i = 0; i < POSITIONS_COUNT; ++i)
+        {
+            objects.objects[i]->SetLight(0, lightsGrid.FindNearestLight(objects.objects[i]->GetWorldBoundingBox().GetCenter()));
+            grid.UpdateObject(gridObjects.objects[i].Get());
+        }
+
+        // light moves a bit, like carried by unit
+        Vector<Light*> movedLights;
+        for (uint32 i = 0; i < MOVED_LIGHTS_COUNT; ++i)
+        {
+            Light* light = lights[(i * 7) % LIGHTS_COUNT].Get();
+            if (light->IsDynamic())
+            {
+                light->SetPosition(light->GetPosition() + Vector3(random.RandFloat32InBounds(-20.0f, 20.0f), random.RandFloat32InBounds(-20.0f, 20.0f), 0.0f));
+                movedLights.push_back(light);
+            }
+        }
+
+        int64 startTime = SystemTimer::GetUs();
+        for (Light* light : movedLights)
+        {
+            lightsGrid.UpdateLight(light);
+            UpdateLightsOfAllObjects(lightsGrid, objects.objects, light);
+        }
+        int64 allObjectsTime = SystemTimer::GetUs() - startTime;
+
+        startTime = SystemTimer::GetUs();
+        for (Light* light : movedLights)
+        {
+            grid.UpdateLight(light);
+        }
+        int64 gridTime = SystemTimer::GetUs() - startTime;
+
+        TEST_VERIFY(HasNearestLights(lights, objects));
+        TEST_VERIFY(HasNearestLights(lights, gridObjects));
+
+        Logger::Info("%u moved of %u lights for %u objects: %lld us with check of all objects, %lld us with objects in LightGrid",
+                     static_cast<uint32>(movedLights.size()), LIGHTS_COUNT, POSITIONS_COUNT, allObjectsTime, gridTime);
+    }
+};
@@ -0,0 +1,194 @@
+#include "UnitTests/UnitTests.h"
+
+#include "Base/ScopedPtr.h"
+#include "Logger/Logger.h"
+#include "Render/Highlevel/Camera.h"
+#include "Render/Highlevel/OcclusionRasterizer.h"
+#include "Time/SystemTimer.h"
+#include "Utils/Random.h"
+
+namespace OcclusionRasterizerTestDetails
+{
+using namespace DAVA;
+
+const uint32 RASTERIZER_SIZE = 256;
+const float32 Z_NEAR = 1.0f;
+const float32 Z_FAR = 2500.0f;
+const uint32 BENCHMARK_TRIANGLES_COUNT = 100000;
+const uint32 GRID_SIZE = 17;
+
+// camera looks along +y axis, as cameras of static occlusion do
+Matrix4 CreateViewProjection()
+{
+    ScopedPtr<Camera> camera(new Camera());
+    camera->SetupPerspective(90.0f, 1.0f, Z_NEAR, Z_FAR);
+    camera->SetUp(Vector3(0.0f, 0.0f, 1.0f));
+    camera->SetPosition(Vector3(0.0f, 0.0f, 0.0f));
+    camera->SetTarget(Vector3(0.0f, 1.0f, 0.0f));
+    return camera->GetViewProjMatrix();
+}
+
+// quad in xz plane facing camera at distance `y`
+Vector<Vector3> CreateQuad(float32 y, float32 halfSize)
+{
+    Vector3 a(-halfSize, y, -halfSize);
+    Vector3 b(halfSize, y, -halfSize);
+    Vector3 c(halfSize, y, halfSize);
+    Vector3 d(-halfSize, y, halfSize);
+    return { a, b, c, a, c, d };
+}
+
+uint32 DrawQuad(OcclusionRasterizer& rasterizer, const Vector<Vector3>& quad, bool depthWrite)
+{
+    return rasterizer.DrawTriangles(quad.data(), static_cast<uint32>(quad.size()), depthWrite);
+}
+
+// grid of quads in xz plane at distance `y` and further, with randomly shifted inner vertices
+Vector<Vector3> CreateGrid(Random& random, float32 y, float32 halfSize)
+{
+    float32 cellSize = 2.0f * halfSize / static_cast<float32>(GRID_SIZE - 1);
+    Vector<Vector3> vertices;
+    for (uint32 i = 0; i < GRID_SIZE; ++i)
+    {
+        for (uint32 j = 0; j < GRID_SIZE; ++j)
+        {
+            Vector3 vertex(-halfSize + cellSize * static_cast<float32>(i), y, -halfSize + cellSize * static_cast<float32>(j));
+            if (i > 0 && i < GRID_SIZE - 1 && j > 0 && j < GRID_SIZE - 1)
+            {
+                float32 shift = cellSize * 0.25f;
+                vertex += Vector3(random.RandFloat32InBounds(-shift, shift), random.RandFloat32InBounds(0.0f, y), random.RandFloat32InBounds(-shift, shift));
+            }
+            vertices.push_back(vertex);
+        }
+    }
+
+    Vector<Vector3> triangles;
+    for (uint32 i = 0; i + 1 < GRID_SIZE; ++i)
+    {
+        for (uint32 j = 0; j + 1 < GRID_SIZE; ++j)
+        {
+            const Vector3& a = vertices[i * GRID_SIZE + j];
+            const Vector3& b = vertices[(i + 1) * GRID_SIZE + j];
+            const Vector3& c = vertices[(i + 1) * GRID_SIZE + j + 1];
+            const Vector3& d = vertices[i * GRID_SIZE + j + 1];
+            triangles.insert(triangles.end(), { a, b, c, a, c, d });
+        }
+    }
+    return triangles;
+}
+}
+
+DAVA_TESTCLASS (OcclusionRasterizerTest)
+{
+    BEGIN_FILES_COVERED_BY_TESTS()
+    FIND_FILES_IN_TARGET(DavaFramework)
+    DECLARE_COVERED_FILES("OcclusionRasterizer.cpp")
+    END_FILES_COVERED_BY_TESTS();
+
+    DAVA_TEST (DepthTest)
+    {
+        using namespace DAVA;
+        using namespace OcclusionRasterizerTestDetails;
+
+        OcclusionRasterizer rasterizer(RASTERIZER_SIZE);
+        rasterizer.Begin(CreateViewProjection(), Z_NEAR, Z_FAR);
+
+        const uint32 allPixels = RASTERIZER_SIZE * RASTERIZER_SIZE;
+        TEST_VERIFY(DrawQuad(rasterizer, CreateQuad(100.0f, 1000.0f), true) == allPixels);
+
+        // occluded by the first quad
+        TEST_VERIFY(DrawQuad(rasterizer, CreateQuad(200.0f, 1000.0f), true) == 0);
+
+        // nearer quad without depth write passes, but doesn't occlude
+        TEST_VERIFY(DrawQuad(rasterizer, CreateQuad(50.0f, 1000.0f), false) == allPixels);
+        TEST_VERIFY(DrawQuad(rasterizer, CreateQuad(75.0f, 1000.0f), true) == allPixels);
+
+        // quad covering central quarter of the view
+        TEST_VERIFY(DrawQuad(rasterizer, CreateQuad(20.0f, 10.0f), true) == allPixels / 4);
+
+        // further than far plane
+        rasterizer.Begin(CreateViewProjection(), Z_NEAR, Z_FAR);
+        TEST_VERIFY(DrawQuad(rasterizer, CreateQuad(Z_FAR * 2.0f, Z_FAR * 4.0f), true) == 0);
+
+        // behind camera
+        TEST_VERIFY(DrawQuad(rasterizer, CreateQuad(-100.0f, 1000.0f), true) == 0);
+    }
+
+    DAVA_TEST (NearPlaneClipping)
+    {
+        using namespace DAVA;
+        using namespace OcclusionRasterizerTestDetails;
+
+        OcclusionRasterizer rasterizer(RASTERIZER_SIZE);
+        rasterizer.Begin(CreateViewProjection(), Z_NEAR, Z_FAR);
+
+        // floor under camera from behind it to far distance covers lower half of the view
+        Vector3 a(-1000.0f, -1000.0f, -1.0f);
+        Vector3 b(1000.0f, -1000.0f, -1.0f);
+        Vector3 c(1000.0f, 1000.0f, -1.0f);
+        Vector3 d(-1000.0f, 1000.0f, -1.0f);
+        Vector<Vector3> floor = { a, b, c, a, c, d };
+
+        const uint32 halfPixels = RASTERIZER_SIZE * RASTERIZER_SIZE / 2;
+        TEST_VERIFY(DrawQuad(rasterizer, floor, true) == halfPixels);
+
+        // the same floor raised above camera covers upper half
+        for (Vector3& v : floor)
+        {
+            v.z = 1.0f;
+        }
+        TEST_VERIFY(DrawQuad(rasterizer, floor, true) == halfPixels);
+    }
+
+    DAVA_TEST (SharedEdgesAreCoveredOnce)
+    {
+        using namespace DAVA;
+        using namespace OcclusionRasterizerTestDetails;
+
+        Random random;
+        random.Seed(12345);
+
+        // without depth write each pixel passes once for each triangle covering it
+        OcclusionRasterizer rasterizer(RASTERIZER_SIZE);
+        rasterizer.Begin(CreateViewProjection(), Z_NEAR, Z_FAR);
+        Vector<Vector3> grid = CreateGrid(random, 100.0f, 1000.0f);
+        TEST_VERIFY(DrawQuad(rasterizer, grid, false) == RASTERIZER_SIZE * RASTERIZER_SIZE);
+
+        // the same grid laid as floor under camera, its triangles are clipped by near plane
+        for (Vector3& v : grid)
+        {
+            v = Vector3(v.x, v.z, -1.0f);
+        }
+        TEST_VERIFY(DrawQuad(rasterizer, grid, false) == RASTERIZER_SIZE * RASTERIZER_SIZE / 2);
+    }
+
+    DAVA_TEST (RasterizationBenchmark)
+    {
+        using namespace DAVA;
+        using namespace OcclusionRasterizerTestDetails;
+
+        Random random;
+        random.Seed(12345);
+
+        Vector<Vector3> triangles;
+        triangles.reserve(BENCHMARK_TRIANGLES_COUNT * 3);
+        for (uint32 i = 0; i < BENCHMARK_TRIANGLES_COUNT; ++i)
+        {
+            Vector3 center(random.RandFloat32InBounds(-500.0f, 500.0f), random.RandFloat32InBounds(-100.0f, 1000.0f), random.RandFloat32InBounds(-500.0f, 500.0f));
+            for (uint32 k = 0; k < 3; ++k)
+            {
+                triangles.push_back(center + Vector3(random.RandFloat32InBounds(-10.0f, 10.0f), random.RandFloat32InBounds(-10.0f, 10.0f), random.RandFloat32InBounds(-10.0f, 10.0f)));
+            }
+        }
+
+        OcclusionRasterizer rasterizer(RASTERIZER_SIZE);
+        int64 startTime = SystemTimer::GetUs();
+        rasterizer.Begin(CreateViewProjection(), Z_NEAR, Z_FAR);
+        uint32 passedPixels = rasterizer.DrawTriangles(triangles.data(), static_cast<uint32>(triangles.size()), true);
+        int64 drawTime = SystemTimer::GetUs() - startTime;
+
+        TEST_VERIFY(passedPixels > 0);
+        Logger::Info("OcclusionRasterizer: %u triangles drawn to %ux%u depth buffer in %lld us, %u pixels passed",
+                     BENCHMARK_TRIANGLES_COUNT, RASTERIZER_SIZE, RASTERIZER_SIZE, drawTime, passedPixels);
+    }
+};
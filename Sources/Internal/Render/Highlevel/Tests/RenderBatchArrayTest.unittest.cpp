@@ -0,0 +1,289 @@
+#include "UnitTests/UnitTests.h"
+
+#include "Base/Radix/RadixSort64.h"
+#include "Base/RefPtr.h"
+#include "Logger/Logger.h"
+#include "Render/Highlevel/Camera.h"
+#include "Render/Highlevel/RenderBatch.h"
+#include "Render/Highlevel/RenderBatchArray.h"
+#include "Render/Highlevel/RenderObject.h"
+#include "Render/Material/NMaterial.h"
+#include "Time/SystemTimer.h"
+#include "Utils/Random.h"
+
+namespace RenderBatchArrayTestDetails
+{
+using namespace DAVA;
+
+const uint32 BENCHMARK_BATCHES_COUNT = 20000;
+const uint32 BENCHMARK_ITERATIONS_COUNT = 20;
+const uint32 MATERIALS_COUNT = 64;
+
+// Batches placed at random distances from camera, several batches share the same position
+struct TestBatches
+{
+    TestBatches(uint32 count)
+    {
+        Random random(12345);
+        for (uint32 i = 0; i < MATERIALS_COUNT; ++i)
+        {
+            RefPtr<NMaterial> parent(new NMaterial());
+            RefPtr<NMaterial> material(new NMaterial());
+            material->SetParent(parent.Get());
+            materials.push_back(material);
+        }
+
+        matrices.resize(count);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            float32 distance = static_cast<float32>(random.Rand(count / 4));
+            matrices[i] = Matrix4::MakeTranslation(Vector3(distance, 0.0f, 0.0f));
+
+            RefPtr<RenderObject> renderObject(new RenderObject());
+            renderObject->SetWorldMatrixPtr(&matrices[i]);
+            renderObjects.push_back(renderObject);
+
+            RefPtr<RenderBatch> batch(new RenderBatch());
+            batch->SetRenderObject(renderObject.Get());
+            batch->SetMaterial(materials[random.Rand(MATERIALS_COUNT - 1)].Get());
+            batch->SetSortingKey(random.Rand(1) * 10);
+            batches.push_back(batch);
+        }
+
+        camera.ConstructInplace();
+        camera->SetPosition(Vector3(-1.0f, 0.0f, 0.0f));
+        camera->SetDirection(Vector3(1.0f, 0.0f, 0.0f));
+    }
+
+    void Fill(RenderBatchArray& array, uint32 sortingFlags)
+    {
+        array.Clear();
+        array.SetSortingFlags(sortingFlags);
+        for (const RefPtr<RenderBatch>& batch : batches)
+        {
+            array.AddRenderBatch(batch.Get());
+        }
+    }
+
+    Vector<Matrix4> matrices;
+    Vector<RefPtr<NMaterial>> materials;
+    Vector<RefPtr<RenderObject>> renderObjects;
+    Vector<RefPtr<RenderBatch>> batches;
+    RefPtr<Camera> camera;
+};
+
+Vector<RadixSortItem64> GenerateItems(uint32 count, uint32 keysCount)
+{
+    Random random(54321);
+    Vector<RadixSortItem64> items(count);
+    for (uint32 i = 0; i < count; ++i)
+    {
+        uint64 key = random.Rand(keysCount);
+        items[i] = { key * 0x0123456789ULL, i };
+    }
+    return items;
+}
+
+bool IsSameOrder(const Vector<RadixSortItem64>& a, const Vector<RadixSortItem64>& b)
+{
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](const RadixSortItem64& x, const RadixSortItem64& y) {
+               return x.key == y.key && x.index == y.index;
+           });
+}
+
+Vector<RadixSortItem64> StableSort(Vector<RadixSortItem64> items)
+{
+    std::stable_sort(items.begin(), items.end(), [](const RadixSortItem64& a, const RadixSortItem64& b) { return a.key < b.key; });
+    return items;
+}
+
+Vector<RadixSortItem64> RadixSort(Vector<RadixSortItem64> items)
+{
+    Vector<RadixSortItem64> buffer(items.size());
+    RadixSort64(items.data(), buffer.data(), static_cast<uint32>(items.size()));
+    return items;
+}
+}
+
+DAVA_TESTCLASS (RenderBatchArrayTest)
+{
+    BEGIN_FILES_COVERED_BY_TESTS()
+    FIND_FILES_IN_TARGET(DavaFramework)
+    DECLARE_COVERED_FILES("RadixSort64.cpp")
+    DECLARE_COVERED_FILES("RenderBatchArray.cpp")
+    END_FILES_COVERED_BY_TESTS();
+
+    DAVA_TEST (RadixSortIsStable)
+    {
+        using namespace DAVA;
+        using namespace RenderBatchArrayTestDetails;
+
+        for (uint32 count : { 0, 1, 7, 32, 1000, 20000 })
+        {
+            for (uint32 keysCount : { 1, 10, 100000 })
+            {
+                Vector<RadixSortItem64> items = GenerateItems(count, keysCount);
+                Vector<RadixSortItem64> sorted = StableSort(items);
+                TEST_VERIFY(IsSameOrder(RadixSort(items), sorted));
+
+                // nearly sorted input is finished by insertion sort
+                if (count > 1)
+                {
+                    std::swap(sorted[count / 3], sorted[count / 2]);
+                    TEST_VERIFY(IsSameOrder(RadixSort(sorted), StableSort(sorted)));
+                }
+            }
+        }
+    }
+
+    DAVA_TEST (SortKeepsKeysOrder)
+    {
+        using namespace DAVA;
+        using namespace RenderBatchArrayTestDetails;
+
+        TestBatches testBatches(1000);
+        RenderBatchArray array;
+
+        // back to front sorting keeps order of batches with equal keys
+        testBatches.Fill(array, RenderBatchArray::SORT_ENABLED | RenderBatchArray::SORT_BY_DISTANCE_BACK_TO_FRONT);
+        Vector<RenderBatch*> reference(array.GetRenderBatchCount());
+        for (uint32 i = 0; i < array.GetRenderBatchCount(); ++i)
+        {
+            reference[i] = array.Get(i);
+        }
+
+        array.Sort(testBatches.camera.Get());
+        std::stable_sort(reference.begin(), reference.end(), [](const RenderBatch* a, const RenderBatch* b) { return a->layerSortingKey > b->layerSortingKey; });
+        for (uint32 i = 0; i < array.GetRenderBatchCount(); ++i)
+        {
+            TEST_VERIFY(array.Get(i) == reference[i]);
+        }
+
+        // material sorting groups batches of the same material, each test material has its own parent
+        testBatches.Fill(array, RenderBatchArray::SORT_ENABLED | RenderBatchArray::SORT_BY_MATERIAL);
+        array.Sort(testBatches.camera.Get());
+        for (uint32 i = 1; i < array.GetRenderBatchCount(); ++i)
+        {
+            RenderBatch* previous = array.Get(i - 1);
+            RenderBatch* batch = array.Get(i);
+            TEST_VERIFY(previous->layerSortingKey >= batch->layerSortingKey);
+            TEST_VERIFY(previous->layerSortingKey != batch->layerSortingKey || previous->GetMaterial() == batch->GetMaterial());
+        }
+    }
+
+    DAVA_TEST (StateSortGroupsShadersAndTextureSets)
+    {
+        using namespace DAVA;
+        using namespace RenderBatchArrayTestDetails;
+
+        // batches of materials of one parent differ only by shader and texture set of active variant,
+        // shader pointers and texture set handles are never dereferenced by keys
+        const uint32 shadersCount = 2;
+        const uint32 textureSetsCount = 3;
+        const uint32 batchesCount = 240;
+        const uint32 materialBits = 0x01234567;
+
+        Vector<uint32> stateKeys;
+        for (uint32 shader = 0; shader < shadersCount; ++shader)
+        {
+            for (uint32 textureSet = 0; textureSet < textureSetsCount; ++textureSet)
+            {
+                const ShaderDescriptor* shaderDescriptor = reinterpret_cast<const ShaderDescriptor*>(static_cast<pointer_size>(shader + 1) << 4);
+                uint32 stateKey = NMaterial::MakeStateSortingKey(shaderDescriptor, rhi::HTextureSet(textureSet + 1));
+                for (uint32 key : stateKeys)
+                {
+                    TEST_VERIFY(key != stateKey);
+                }
+                // shader is more significant than texture set
+                if (!stateKeys.empty() && textureSet == 0)
+                {
+                    TEST_VERIFY(stateKey > stateKeys.back());
+                }
+                stateKeys.push_back(stateKey);
+            }
+        }
+
+        // the same layout as material sorting of RenderBatchArray: material in high half, state in low one, descending order
+        Vector<RadixSortItem64> items(batchesCount);
+        for (uint32 i = 0; i < batchesCount; ++i)
+        {
+            uint32 stateKey = stateKeys[(i * 7) % stateKeys.size()];
+            items[i] = { ~((static_cast<uint64>(materialBits) << 32) | stateKey), i };
+        }
+        Vector<RadixSortItem64> sorted = RadixSort(items);
+        TEST_VERIFY(IsSameOrder(sorted, StableSort(items)));
+
+        // each combination of shader and texture set forms exactly one run of batches
+        uint32 runsCount = 1;
+        for (uint32 i = 1; i < batchesCount; ++i)
+        {
+            uint64 previousKey = ~sorted[i - 1].key;
+            uint64 key = ~sorted[i].key;
+            TEST_VERIFY((previousKey >> 32) == materialBits && (key >> 32) == materialBits);
+            TEST_VERIFY(previousKey >= key);
+            runsCount += (previousKey != key) ? 1 : 0;
+        }
+        TEST_VERIFY(runsCount == shadersCount * textureSetsCount);
+    }
+
+    DAVA_TEST (SortBenchmark)
+    {
+        using namespace DAVA;
+        using namespace RenderBatchArrayTestDetails;
+
+        TestBatches testBatches(BENCHMARK_BATCHES_COUNT);
+        RenderBatchArray array;
+
+        for (uint32 sortingFlags : { RenderBatchArray::SORT_BY_MATERIAL, RenderBatchArray::SORT_BY_DISTANCE_BACK_TO_FRONT })
+        {
+            // reference: comparison sort of batches by keys computed in the same way, as it was done before
+            int64 comparisonSortTime = 0;
+            for (uint32 i = 0; i < BENCHMARK_ITERATIONS_COUNT; ++i)
+            {
+                testBatches.Fill(array, RenderBatchArray::SORT_ENABLED | sortingFlags);
+                array.Sort(testBatches.camera.Get());
+
+                Vector<RenderBatch*> batches(array.GetRenderBatchCount());
+                for (uint32 b = 0; b < array.GetRenderBatchCount(); ++b)
+                {
+                    batches[b] = testBatches.batches[b].Get();
+                }
+
+                auto compare = [](const RenderBatch* a, const RenderBatch* b) { return a->layerSortingKey > b->layerSortingKey; };
+                int64 startTime = SystemTimer::GetUs();
+                if (sortingFlags == RenderBatchArray::SORT_BY_MATERIAL)
+                {
+                    std::sort(batches.begin(), batches.end(), compare);
+                }
+                else
+                {
+                    std::stable_sort(batches.begin(), batches.end(), compare);
+                }
+                comparisonSortTime += SystemTimer::GetUs() - startTime;
+            }
+
+            int64 radixSortTime = 0;
+            for (uint32 i = 0; i < BENCHMARK_ITERATIONS_COUNT; ++i)
+            {
+                testBatches.Fill(array, RenderBatchArray::SORT_ENABLED | sortingFlags);
+
+                int64 startTime = SystemTimer::GetUs();
+                array.Sort(testBatches.camera.Get());
+                radixSortTime += SystemTimer::GetUs() - startTime;
+            }
+
+            // sorting of already sorted array, e.g. for the same visible batches in the next frame
+            int64 coherentSortTime = 0;
+            for (uint32 i = 0; i < BENCHMARK_ITERATIONS_COUNT; ++i)
+            {
+                int64 startTime = SystemTimer::GetUs();
+                array.Sort(testBatches.camera.Get());
+                coherentSortTime += SystemTimer::GetUs() - startTime;
+            }
+
+            Logger::Info("RenderBatchArray sort of %u batches by %s: %lld us with comparison sort of keys, %lld us with keys computation and radix sort, %lld us for sorted array",
+                         BENCHMARK_BATCHES_COUNT, (sortingFlags == RenderBatchArray::SORT_BY_MATERIAL) ? "material" : "distance",
+                         comparisonSortTime / BENCHMARK_ITERATIONS_COUNT, radixSortTime / BENCHMARK_ITERATIONS_COUNT, coherentSortTime / BENCHMARK_ITERATIONS_COUNT);
+        }
+    }
+};
@@ -0,0 +1,316 @@
+#include "UnitTests/UnitTests.h"
+
+#include "Base/ScopedPtr.h"
+#include "Logger/Logger.h"
+#include "Render/Highlevel/BVHRenderHierarchy.h"
+#include "Render/Highlevel/Camera.h"
+#include "Render/Highlevel/GeometryGenerator.h"
+#include "Render/Highlevel/RenderBatch.h"
+#include "Render/Highlevel/RenderObject.h"
+#include "Render/Highlevel/VisibilityOctTree.h"
+#include "Render/Highlevel/VisibilityQuadTree.h"
+#include "Time/SystemTimer.h"
+#include "Utils/Random.h"
+
+namespace RenderHierarchyTestDetails
+{
+using namespace DAVA;
+
+const uint32 OBJECTS_COUNT = 50000;
+const uint32 ITERATIONS_COUNT = 20;
+const uint32 RAYS_COUNT = 1000;
+
+/*
+    Scene of objects scattered over 2000x2000 area, each 10th object is a tall pillar
+    to get vertical content, that is bad for quadtree.
+*/
+struct TestScene
+{
+    TestScene(uint32 count)
+        : random(4321)
+    {
+        transforms.resize(count);
+        objects.resize(count);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            float32 height = (i % 10 == 0) ? random.RandFloat32InBounds(50.0f, 300.0f) : random.RandFloat32InBounds(0.5f, 5.0f);
+            Vector3 halfSize(random.RandFloat32InBounds(0.5f, 5.0f), random.RandFloat32InBounds(0.5f, 5.0f), height);
+            transforms[i] = Matrix4::MakeTranslation(RandomPosition());
+
+            objects[i] = new RenderObject();
+            objects[i]->SetAABBox(AABBox3(-halfSize, halfSize));
+            objects[i]->SetWorldMatrixPtr(&transforms[i]);
+            objects[i]->RecalculateWorldBoundingBox();
+        }
+    }
+
+    ~TestScene()
+    {
+        for (RenderObject* object : objects)
+        {
+            SafeRelease(object);
+        }
+    }
+
+    Vector3 RandomPosition()
+    {
+        return Vector3(random.RandFloat32InBounds(-1000.0f, 1000.0f), random.RandFloat32InBounds(-1000.0f, 1000.0f), random.RandFloat32InBounds(0.0f, 20.0f));
+    }
+
+    void Fill(RenderHierarchy* hierarchy)
+    {
+        for (RenderObject* object : objects)
+        {
+            hierarchy->AddRenderObject(object);
+        }
+        hierarchy->Initialize();
+    }
+
+    void Clear(RenderHierarchy* hierarchy)
+    {
+        for (RenderObject* object : objects)
+        {
+            hierarchy->RemoveRenderObject(object);
+        }
+    }
+
+    void MoveObjects(uint32 step, const Vector<RenderHierarchy*>& hierarchies)
+    {
+        for (uint32 i = 0; i < objects.size(); i += step)
+        {
+            transforms[i] = Matrix4::MakeTranslation(RandomPosition());
+            objects[i]->RecalculateWorldBoundingBox();
+            for (RenderHierarchy* hierarchy : hierarchies)
+            {
+                hierarchy->ObjectUpdated(objects[i]);
+            }
+        }
+        for (RenderHierarchy* hierarchy : hierarchies)
+        {
+            hierarchy->Update();
+        }
+    }
+
+    Random random;
+    Vector<Matrix4> transforms;
+    Vector<RenderObject*> objects;
+};
+
+void SetupCamera(Camera* camera, const Vector3& position, const Vector3& target)
+{
+    camera->SetupPerspective(70.0f, 1.0f, 1.0f, 800.0f);
+    camera->SetUp(Vector3(0.0f, 0.0f, 1.0f));
+    camera->SetPosition(position);
+    camera->SetTarget(target);
+    camera->GetViewProjMatrix(); // rebuild frustum
+}
+
+Vector<RenderObject*> Sorted(Vector<RenderObject*> objects)
+{
+    std::sort(objects.begin(), objects.end());
+    return objects;
+}
+
+int64 MeasureClip(RenderHierarchy* hierarchy, Camera* camera)
+{
+    Vector<RenderObject*> visible;
+    int64 startTime = SystemTimer::GetUs();
+    for (uint32 iteration = 0; iteration < ITERATIONS_COUNT; ++iteration)
+    {
+        visible.clear();
+        hierarchy->Clip(camera, visible, RenderObject::CLIPPING_VISIBILITY_CRITERIA);
+    }
+    return (SystemTimer::GetUs() - startTime) / ITERATIONS_COUNT;
+}
+
+int64 MeasureRayTrace(RenderHierarchy* hierarchy, const Vector<Ray3>& rays)
+{
+    RayTraceCollision collision;
+    Vector<RenderObject*> ignoreObjects;
+    int64 startTime = SystemTimer::GetUs();
+    for (const Ray3& ray : rays)
+    {
+        hierarchy->RayTrace(ray, collision, ignoreObjects);
+    }
+    return SystemTimer::GetUs() - startTime;
+}
+}
+
+DAVA_TESTCLASS (RenderHierarchyTest)
+{
+    DAVA_TEST (BVHMatchesLinearHierarchy)
+    {
+        using namespace DAVA;
+        using namespace RenderHierarchyTestDetails;
+
+        TestScene scene(10000);
+        ScopedPtr<Camera> camera(new Camera());
+        SetupCamera(camera, Vector3(0.0f, 0.0f, 50.0f), Vector3(300.0f, 200.0f, 0.0f));
+
+        // methods of LinearRenderHierarchy are accessible only through base class
+        LinearRenderHierarchy linearHierarchy;
+        RenderHierarchy& linear = linearHierarchy;
+        BVHRenderHierarchy bvh;
+        Vector<RenderHierarchy*> hierarchies = { &linear, &bvh };
+        for (RenderHierarchy* hierarchy : hierarchies)
+        {
+            scene.Fill(hierarchy);
+        }
+
+        AABBox3 queryBox(Vector3(-200.0f, -150.0f, -10.0f), Vector3(100.0f, 50.0f, 30.0f));
+        for (uint32 frame = 0; frame < 4; ++frame)
+        {
+            Vector<RenderObject*> linearVisible;
+            Vector<RenderObject*> bvhVisible;
+            linear.Clip(camera, linearVisible, RenderObject::CLIPPING_VISIBILITY_CRITERIA);
+            bvh.Clip(camera, bvhVisible, RenderObject::CLIPPING_VISIBILITY_CRITERIA);
+            TEST_VERIFY(!linearVisible.empty());
+            TEST_VERIFY(Sorted(linearVisible) == Sorted(bvhVisible));
+
+            Vector<RenderObject*> linearInBox;
+            Vector<RenderObject*> bvhInBox;
+            linear.GetAllObjectsInBBox(queryBox, linearInBox);
+            bvh.GetAllObjectsInBBox(queryBox, bvhInBox);
+            TEST_VERIFY(Sorted(linearInBox) == Sorted(bvhInBox));
+
+            // move part of objects, so some leaves are refitted and tree is rebuilt
+            scene.MoveObjects(3 + frame, hierarchies);
+        }
+
+        // remove half of objects
+        for (uint32 i = 0; i < scene.objects.size(); i += 2)
+        {
+            linear.RemoveRenderObject(scene.objects[i]);
+            bvh.RemoveRenderObject(scene.objects[i]);
+        }
+
+        Vector<RenderObject*> linearVisible;
+        Vector<RenderObject*> bvhVisible;
+        linear.Clip(camera, linearVisible, RenderObject::CLIPPING_VISIBILITY_CRITERIA);
+        bvh.Clip(camera, bvhVisible, RenderObject::CLIPPING_VISIBILITY_CRITERIA);
+        TEST_VERIFY(Sorted(linearVisible) == Sorted(bvhVisible));
+        TEST_VERIFY(bvh.GetObjectsCount() == scene.objects.size() / 2);
+
+        for (uint32 i = 1; i < scene.objects.size(); i += 2)
+        {
+            linear.RemoveRenderObject(scene.objects[i]);
+            bvh.RemoveRenderObject(scene.objects[i]);
+        }
+        TEST_VERIFY(bvh.GetObjectsCount() == 0);
+    }
+
+    DAVA_TEST (RayTraceIsSameInAllHierarchies)
+    {
+        using namespace DAVA;
+        using namespace RenderHierarchyTestDetails;
+
+        // unit boxes along x axis, geometry oct trees are not built in advance
+        const uint32 boxesCount = 3;
+        Vector<Matrix4> transforms(boxesCount);
+        Vector<RenderObject*> boxes(boxesCount);
+        Map<FastName, float32> dimensions = { { FastName("segments.x"), 1.0f }, { FastName("segments.y"), 1.0f }, { FastName("segments.z"), 1.0f } };
+        for (uint32 i = 0; i < boxesCount; ++i)
+        {
+            ScopedPtr<PolygonGroup> geometry(GeometryGenerator::GenerateBox(AABBox3(Vector3(-1.0f, -1.0f, -1.0f), Vector3(1.0f, 1.0f, 1.0f)), dimensions));
+            geometry->RecalcAABBox();
+            ScopedPtr<RenderBatch> batch(new RenderBatch());
+            batch->SetPolygonGroup(geometry);
+
+            transforms[i] = Matrix4::MakeTranslation(Vector3(10.0f * (i + 1), 0.0f, 0.0f));
+            boxes[i] = new RenderObject();
+            boxes[i]->AddRenderBatch(batch);
+            boxes[i]->SetWorldMatrixPtr(&transforms[i]);
+            boxes[i]->RecalculateWorldBoundingBox();
+        }
+
+        LinearRenderHierarchy linearHierarchy;
+        VisibilityOctTree octTree;
+        QuadTree quadTree(10);
+        BVHRenderHierarchy bvh;
+        std::pair<const char*, RenderHierarchy*> hierarchies[] = { { "Linear", &linearHierarchy }, { "OctTree", &octTree }, { "QuadTree", &quadTree }, { "BVH", &bvh } };
+
+        // linear hierarchy traces segment of ray within [0, 1], so direction covers all boxes
+        Ray3 ray(Vector3(0.0f, 0.0f, 0.0f), Vector3(100.0f, 0.0f, 0.0f));
+        for (auto& hierarchy : hierarchies)
+        {
+            RenderHierarchy* h = hierarchy.second;
+            for (RenderObject* box : boxes)
+            {
+                h->AddRenderObject(box);
+            }
+            h->Initialize();
+
+            // ignored objects are skipped, the closest of the rest is hit at its near face
+            Vector<RenderObject*> ignoreObjects;
+            for (uint32 i = 0; i < boxesCount; ++i)
+            {
+                RayTraceCollision collision;
+                bool found = h->RayTrace(ray, collision, ignoreObjects);
+                TEST_VERIFY_WITH_MESSAGE(found, hierarchy.first);
+                TEST_VERIFY_WITH_MESSAGE(collision.renderObject == boxes[i], hierarchy.first);
+                TEST_VERIFY_WITH_MESSAGE(FLOAT_EQUAL_EPS(collision.t, (10.0f * (i + 1) - 1.0f) / 100.0f, 0.0001f), hierarchy.first);
+                ignoreObjects.push_back(boxes[i]);
+            }
+
+            RayTraceCollision collision;
+            TEST_VERIFY_WITH_MESSAGE(!h->RayTrace(ray, collision, ignoreObjects), hierarchy.first);
+
+            for (RenderObject* box : boxes)
+            {
+                h->RemoveRenderObject(box);
+            }
+        }
+
+        for (RenderObject* box : boxes)
+        {
+            SafeRelease(box);
+        }
+    }
+
+    DAVA_TEST (BVHAndQuadTreeBenchmark)
+    {
+        using namespace DAVA;
+        using namespace RenderHierarchyTestDetails;
+
+        TestScene scene(OBJECTS_COUNT);
+        ScopedPtr<Camera> camera(new Camera());
+        SetupCamera(camera, Vector3(-900.0f, -900.0f, 100.0f), Vector3(0.0f, 0.0f, 0.0f));
+
+        Vector<Ray3> rays;
+        rays.reserve(RAYS_COUNT);
+        for (uint32 i = 0; i < RAYS_COUNT; ++i)
+        {
+            Vector3 from = scene.RandomPosition();
+            Vector3 to = scene.RandomPosition();
+            rays.emplace_back(from, to - from);
+        }
+
+        QuadTree quadTree(10);
+        BVHRenderHierarchy bvh;
+        std::pair<const char*, RenderHierarchy*> hierarchies[] = { { "QuadTree", &quadTree }, { "BVH", &bvh } };
+        for (auto& hierarchy : hierarchies)
+        {
+            int64 startTime = SystemTimer::GetUs();
+            scene.Fill(hierarchy.second);
+            int64 buildTime = SystemTimer::GetUs() - startTime;
+
+            int64 clipTime = MeasureClip(hierarchy.second, camera);
+            int64 rayTraceTime = MeasureRayTrace(hierarchy.second, rays);
+
+            // move each 10th object every frame
+            startTime = SystemTimer::GetUs();
+            for (uint32 frame = 0; frame < ITERATIONS_COUNT; ++frame)
+            {
+                scene.MoveObjects(10, { hierarchy.second });
+            }
+            int64 updateTime = (SystemTimer::GetUs() - startTime) / ITERATIONS_COUNT;
+
+            int64 clipAfterUpdateTime = MeasureClip(hierarchy.second, camera);
+
+            Logger::Info("%s with %u objects: build %lld us, clip %lld us, %u rays trace %lld us, update of 10%% objects %lld us, clip after updates %lld us",
+                         hierarchy.first, OBJECTS_COUNT, buildTime, clipTime, RAYS_COUNT, rayTraceTime, updateTime, clipAfterUpdateTime);
+
+            scene.Clear(hierarchy.second);
+        }
+    }
+};
@@ -595,78 +595,7 @@ bool QuadTree::RayTrace(const Ray3& ray, RayTraceCollision& collision, const Vec
     localRayBoxTraceCount = 0;
     BroadPhaseCollisions(ray, broadPhaseCollisions);
 
-    // TODO: Remove duplication of this code in SpatialTree and RenderHierarchy
-    bool intersectionFound = false;
-    float32 closestT = FLOAT_MAX;
-
-    for (auto& pair : broadPhaseCollisions)
-    {
-        RenderObject* ro = pair.second;
-        if (std::find(std::begin(ignoreObjects), std::end(ignoreObjects), ro)
-            != std::end(ignoreObjects))
-        {
-            continue;
-        }
-
-        if (pair.first > closestT)
-            break;
-
-        Vector3 rayOrigin = ray.origin * ro->GetInverseWorldTransform();
-        Vector3 rayDirection = MultiplyVectorMat3x3(ray.direction, ro->GetInverseWorldTransform());
-        Ray3Optimized rayInObjectSpace(rayOrigin, rayDirection);
-
-        uint32 activeBatchesCount = ro->GetActiveRenderBatchCount();
-        for (uint32 bi = 0; bi < activeBatchesCount; ++bi)
-        {
-            RenderBatch* rb = ro->GetActiveRenderBatch(bi);
-            DVASSERT(rb != nullptr);
-            PolygonGroup* geo = rb->GetPolygonGroup();
-
-            if (geo)
-            {
-                GeometryOctTree* geometryOctTree = geo->GetGeometryOctTree();
-                if (geometryOctTree)
-                {
-                    float32 currentT;
-                    uint32 currentTriangleIndex;
-
-                    if (geometryOctTree->IntersectionWithRay(rayInObjectSpace, currentT, currentTriangleIndex))
-                    {
-                        if (currentT < closestT)
-                        {
-                            intersectionFound = true;
-                            closestT = currentT;
-
-                            collision.renderObject = ro;
-                            collision.geometry = geo;
-                            collision.t = currentT;
-                            collision.triangleIndex = currentTriangleIndex;
-                        }
-                    }
-                }
-            }
-        }
-
-        if (ro->GetType() == RenderObject::TYPE_LANDSCAPE)
-        {
-            Landscape* landscape = static_cast<Landscape*>(ro);
-            float32 currentT;
-            if (landscape->RayTrace(rayInObjectSpace, currentT))
-            {
-                if (currentT < closestT)
-                {
-                    intersectionFound = true;
-                    closestT = currentT;
-
-                    collision.renderObject = ro;
-                    collision.geometry = 0;
-                    collision.t = currentT;
-                    collision.triangleIndex = 0;
-                }
-            }
-        }
-    }
-    return intersectionFound;
+    return RayTraceObjects(ray, broadPhaseCollisions, ignoreObjects, FLOAT_MAX, collision);
 }
 
 void QuadTree::Update()
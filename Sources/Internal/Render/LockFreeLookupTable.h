@@ -0,0 +1,188 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+#include "Concurrency/Atomic.h"
+#include "Debug/DVAssert.h"
+
+namespace DAVA
+{
+/*
+    Open-addressing table of objects by 64-bit hash. Entries are only added (by one thread at a time,
+    callers serialize Add), so readers search it without locks: object is published before its key, and grown
+    table replaces current one only after it's filled. Replaced tables are kept, as readers may still use them.
+    Hash doesn't identify object: objects with equal hashes are all kept, and Find checks the whole key of object.
+*/
+template <typename T>
+class LockFreeLookupTable
+{
+public:
+    static const uint32 INITIAL_CAPACITY = 512;
+
+    LockFreeLookupTable(uint32 capacity = INITIAL_CAPACITY);
+
+    /**
+        Return object added with `hash`, for which `isSameKey(object)` is true, or nullptr.
+        Can be called concurrently with Add.
+    */
+    template <typename Fn>
+    T* Find(uint64 hash, Fn isSameKey) const;
+    /** Add object with non-zero `hash`. Object with the same key shouldn't be in table yet. */
+    void Add(uint64 hash, T* object);
+
+    /** Count and capacity are for the thread, that adds objects. */
+    uint32 GetCount() const;
+    uint32 GetCapacity() const;
+
+private:
+    class Table
+    {
+    public:
+        Table(uint32 capacity);
+
+        template <typename Fn>
+        T* Find(uint64 hash, Fn isSameKey) const;
+        void Insert(uint64 hash, T* object);
+        bool IsFull() const;
+        uint32 GetCount() const;
+        uint32 GetCapacity() const;
+
+        template <typename Fn>
+        void ForEach(Fn fn) const;
+
+    private:
+        struct Entry
+        {
+            Atomic<uint64> key;
+            Atomic<T*> object;
+        };
+
+        std::unique_ptr<Entry[]> entries;
+        uint32 capacity = 0;
+        uint32 count = 0;
+    };
+
+    Atomic<Table*> current;
+    Vector<std::unique_ptr<Table>> tables; // current table is the last one
+};
+
+template <typename T>
+LockFreeLookupTable<T>::Table::Table(uint32 capacity_)
+    : entries(new Entry[capacity_])
+    , capacity(capacity_)
+{
+    DVASSERT(capacity > 0 && (capacity & (capacity - 1)) == 0);
+}
+
+template <typename T>
+template <typename Fn>
+T* LockFreeLookupTable<T>::Table::Find(uint64 hash, Fn isSameKey) const
+{
+    uint32 mask = capacity - 1;
+    for (uint32 i = uint32(hash) & mask;; i = (i + 1) & mask)
+    {
+        uint64 key = entries[i].key.Get();
+        if (key == hash)
+        {
+            T* object = entries[i].object.Get();
+            if (isSameKey(object))
+                return object;
+        }
+        else if (key == 0)
+        {
+            return nullptr;
+        }
+    }
+}
+
+template <typename T>
+void LockFreeLookupTable<T>::Table::Insert(uint64 hash, T* object)
+{
+    DVASSERT(hash != 0 && !IsFull());
+
+    uint32 mask = capacity - 1;
+    uint32 i = uint32(hash) & mask;
+    while (entries[i].key.Get() != 0)
+    {
+        i = (i + 1) & mask;
+    }
+
+    entries[i].object.Set(object);
+    entries[i].key.Set(hash);
+    ++count;
+}
+
+template <typename T>
+bool LockFreeLookupTable<T>::Table::IsFull() const
+{
+    return 2 * (count + 1) > capacity;
+}
+
+template <typename T>
+uint32 LockFreeLookupTable<T>::Table::GetCount() const
+{
+    return count;
+}
+
+template <typename T>
+uint32 LockFreeLookupTable<T>::Table::GetCapacity() const
+{
+    return capacity;
+}
+
+template <typename T>
+template <typename Fn>
+void LockFreeLookupTable<T>::Table::ForEach(Fn fn) const
+{
+    for (uint32 i = 0; i < capacity; ++i)
+    {
+        uint64 key = entries[i].key.Get();
+        if (key != 0)
+            fn(key, entries[i].object.Get());
+    }
+}
+
+template <typename T>
+LockFreeLookupTable<T>::LockFreeLookupTable(uint32 capacity)
+    : current(nullptr)
+{
+    tables.emplace_back(new Table(capacity));
+    current.Set(tables.back().get());
+}
+
+template <typename T>
+template <typename Fn>
+T* LockFreeLookupTable<T>::Find(uint64 hash, Fn isSameKey) const
+{
+    return current.Get()->Find(hash, isSameKey);
+}
+
+template <typename T>
+void LockFreeLookupTable<T>::Add(uint64 hash, T* object)
+{
+    Table* table = current.Get();
+    if (table->IsFull())
+    {
+        std::unique_ptr<Table> grownTable(new Table(table->GetCapacity() * 2));
+        table->ForEach([&grownTable](uint64 key, T* object) {
+            grownTable->Insert(key, object);
+        });
+        table = grownTable.get();
+        tables.push_back(std::move(grownTable));
+    }
+
+    table->Insert(hash, object);
+    current.Set(table);
+}
+
+template <typename T>
+uint32 LockFreeLookupTable<T>::GetCount() const
+{
+    return current.Get()->GetCount();
+}
+
+template <typename T>
+uint32 LockFreeLookupTable<T>::GetCapacity() const
+{
+    return current.Get()->GetCapacity();
+}
+}
@@ -1,5 +1,6 @@
 #include "FXCache.h"
 #include "Render/ShaderCache.h"
+#include "Render/LockFreeLookupTable.h"
 #include "Render/Material/NMaterialNames.h"
 #include "Render/Highlevel/RenderLayer.h"
 #include "Render/Highlevel/RenderPassNames.h"
@@ -16,7 +17,8 @@ namespace DAVA
 {
 namespace FXCacheDetails
 {
-Map<Vector<size_t>, FXDescriptor> fxDescriptors;
+LockFreeLookupTable<FXDescriptor> fxDescriptors; //by variant hash of fx and quality
+Vector<std::unique_ptr<FXDescriptor>> fxDescriptorsList;
 Map<std::pair<FastName, FastName>, FXDescriptor> oldTemplateMap;
 
 FXDescriptor defaultFX;
@@ -26,7 +28,9 @@ Mutex fxCacheMutex;
 
 namespace FXCache
 {
-const FXDescriptor& LoadFXFromOldTemplate(const FastName& fxName, UnorderedMap<FastName, int32>& defines, const Vector<size_t>& key, const FastName& quality);
+const FXDescriptor& LoadFXFromOldTemplate(const FastName& fxName, UnorderedMap<FastName, int32>& defines, uint64 variantHash, const FastName& quality);
+const FXDescriptor& LoadOldTempalte(const FastName& fxName, const FastName& quality);
+UnorderedMap<FastName, int32> BuildPassDefines(const RenderPassDescriptor& pass, const UnorderedMap<FastName, int32>& defines);
 
 void Initialize()
 {
@@ -71,18 +75,81 @@ const FXDescriptor& GetFXDescriptor(const FastName& fxName, UnorderedMap<FastNam
         return FXCacheDetails::defaultFX;
     }
 
-    Vector<size_t> key = ShaderDescriptorCache::BuildFlagsKey(fxName, defines);
+    return GetFXDescriptor(fxName, defines, quality, BuildVariantHash(fxName, defines, quality));
+}
+
+const FXDescriptor& GetFXDescriptor(const FastName& fxName, UnorderedMap<FastName, int32>& defines, const FastName& quality, uint64 variantHash)
+{
+    using namespace FXCacheDetails;
+
+    DVASSERT(initialized);
+    DVASSERT(variantHash == BuildVariantHash(fxName, defines, quality));
+
+    if (!fxName.IsValid())
+    {
+        return FXCacheDetails::defaultFX;
+    }
+
+    //hash doesn't identify variant, so the whole key of found descriptor is compared
+    auto isSameVariant = [&fxName, &defines, &quality](const FXDescriptor* descriptor) {
+        return descriptor->fxName == fxName && descriptor->quality == quality && descriptor->defines == defines;
+    };
 
-    if (quality.IsValid()) //quality made as part of fx key
-        key.push_back(ShaderDescriptorCache::GetUniqueFlagKey(quality));
+    const FXDescriptor* descriptor = fxDescriptors.Find(variantHash, isSameVariant);
+    if (descriptor != nullptr)
+        return *descriptor;
 
     LockGuard<Mutex> guard(FXCacheDetails::fxCacheMutex);
-    auto it = fxDescriptors.find(key);
-    if (it != fxDescriptors.end())
-        return it->second;
+
+    //descriptor could be loaded by another thread while we were waiting for lock
+    descriptor = fxDescriptors.Find(variantHash, isSameVariant);
+    if (descriptor != nullptr)
+        return *descriptor;
 
     //not found - load new
-    return LoadFXFromOldTemplate(fxName, defines, key, quality);
+    return LoadFXFromOldTemplate(fxName, defines, variantHash, quality);
+}
+
+uint64 BuildVariantHash(const FastName& fxName, const UnorderedMap<FastName, int32>& defines, const FastName& quality)
+{
+    //quality made as part of fx key
+    uint64 qualityHash = uint64(ShaderDescriptorCache::GetUniqueFlagKey(quality)) * 0x9e3779b97f4a7c15ull;
+    uint64 hash = ShaderDescriptorCache::BuildVariantHash(fxName, defines) ^ qualityHash;
+    return (hash != 0) ? hash : 1;
+}
+
+Vector<ShaderDescriptorCache::ShaderVariant> GetShaderVariants(const FastName& fxName, const UnorderedMap<FastName, int32>& defines, const FastName& quality)
+{
+    using namespace FXCacheDetails;
+
+    DVASSERT(initialized);
+
+    Vector<ShaderDescriptorCache::ShaderVariant> variants;
+    if (!fxName.IsValid())
+        return variants; //default fx is compiled on initialization
+
+    LockGuard<Mutex> guard(FXCacheDetails::fxCacheMutex);
+    const FXDescriptor& fxTemplate = LoadOldTempalte(fxName, quality);
+    for (const RenderPassDescriptor& pass : fxTemplate.renderPassDescriptors)
+    {
+        variants.push_back({ pass.shaderFileName, BuildPassDefines(pass, defines) });
+    }
+    return variants;
+}
+
+const FXDescriptor& GetFXTemplate(const FastName& fxName, const FastName& quality)
+{
+    using namespace FXCacheDetails;
+
+    DVASSERT(initialized);
+
+    if (!fxName.IsValid())
+    {
+        return FXCacheDetails::defaultFX;
+    }
+
+    LockGuard<Mutex> guard(FXCacheDetails::fxCacheMutex);
+    return LoadOldTempalte(fxName, quality);
 }
 
 const FXDescriptor& LoadOldTempalte(const FastName& fxName, const FastName& quality)
@@ -361,38 +428,49 @@ const FXDescriptor& LoadOldTempalte(const FastName& fxName, const FastName& qual
     return oldTemplateMap[std::make_pair(fxName, quality)] = target;
 }
 
-const FXDescriptor& LoadFXFromOldTemplate(const FastName& fxName, UnorderedMap<FastName, int32>& defines, const Vector<size_t>& key, const FastName& quality)
+UnorderedMap<FastName, int32> BuildPassDefines(const RenderPassDescriptor& pass, const UnorderedMap<FastName, int32>& defines)
 {
-    //the stuff below is old old legacy carried from RenderTechnique and NMaterialTemplate
+    UnorderedMap<FastName, int32> shaderDefines = defines;
+    for (auto& templateDefine : pass.templateDefines)
+    {
+        if (templateDefine.second == 0)
+            shaderDefines.erase(templateDefine.first);
+        else
+            shaderDefines[templateDefine.first] = templateDefine.second;
+    }
 
-    FXDescriptor target = LoadOldTempalte(fxName, quality); //we copy it to new fxdescr as single template can be compiled to many descriptors
-    target.defines = defines; //combine
-    for (auto& pass : target.renderPassDescriptors)
+    if (pass.hasBlend)
     {
-        UnorderedMap<FastName, int32> shaderDefines = defines;
-        for (auto& templateDefine : pass.templateDefines)
-        {
-            if (templateDefine.second == 0)
-                shaderDefines.erase(templateDefine.first);
-            else
-                shaderDefines[templateDefine.first] = templateDefine.second;
-        }
+        if (shaderDefines.find(NMaterialFlagName::FLAG_BLENDING) == shaderDefines.end())
+            shaderDefines[NMaterialFlagName::FLAG_BLENDING] = BLENDING_ALPHABLEND;
+    }
+    else
+    {
+        shaderDefines.erase(NMaterialFlagName::FLAG_BLENDING);
+    }
 
-        if (pass.hasBlend)
-        {
-            if (shaderDefines.find(NMaterialFlagName::FLAG_BLENDING) == shaderDefines.end())
-                shaderDefines[NMaterialFlagName::FLAG_BLENDING] = BLENDING_ALPHABLEND;
-        }
-        else
-        {
-            shaderDefines.erase(NMaterialFlagName::FLAG_BLENDING);
-        }
+    return shaderDefines;
+}
 
+const FXDescriptor& LoadFXFromOldTemplate(const FastName& fxName, UnorderedMap<FastName, int32>& defines, uint64 variantHash, const FastName& quality)
+{
+    //the stuff below is old old legacy carried from RenderTechnique and NMaterialTemplate
+
+    std::unique_ptr<FXDescriptor> target(new FXDescriptor(LoadOldTempalte(fxName, quality))); //we copy it to new fxdescr as single template can be compiled to many descriptors
+    target->fxName = fxName; //key of descriptor, even if template failed to load and default fx was copied
+    target->quality = quality;
+    target->defines = defines; //combine
+    for (auto& pass : target->renderPassDescriptors)
+    {
+        UnorderedMap<FastName, int32> shaderDefines = BuildPassDefines(pass, defines);
         pass.shader = ShaderDescriptorCache::GetShaderDescriptor(pass.shaderFileName, shaderDefines);
         pass.depthStencilState = rhi::AcquireDepthStencilState(pass.depthStateDescriptor);
     }
 
-    return FXCacheDetails::fxDescriptors[key] = target;
+    //descriptor is published after it's filled, readers don't lock
+    FXCacheDetails::fxDescriptors.Add(variantHash, target.get());
+    FXCacheDetails::fxDescriptorsList.push_back(std::move(target));
+    return *FXCacheDetails::fxDescriptorsList.back();
 }
 }
 }
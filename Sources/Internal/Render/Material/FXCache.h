@@ -2,6 +2,7 @@
 #define __DAVAENGINE_FXCACHE_H__
 
 #include "Render/Shader.h"
+#include "Render/ShaderCache.h"
 #include "Render/RHI/rhi_Type.h"
 #include "Render/Highlevel/RenderLayer.h"
 
@@ -27,6 +28,7 @@ struct FXDescriptor
 
     //for storing and further debug simplification
     FastName fxName;
+    FastName quality;
     UnorderedMap<FastName, int32> defines = UnorderedMap<FastName, int32>(16);
 };
 
@@ -36,6 +38,18 @@ void Initialize();
 void Uninitialize();
 void Clear();
 const FXDescriptor& GetFXDescriptor(const FastName& fxName, UnorderedMap<FastName, int32>& defines, const FastName& quality = NMaterialQualityName::DEFAULT_QUALITY_NAME);
+
+//the same as above with `variantHash` precomputed by BuildVariantHash, descriptors which are already loaded are looked up without locks
+const FXDescriptor& GetFXDescriptor(const FastName& fxName, UnorderedMap<FastName, int32>& defines, const FastName& quality, uint64 variantHash);
+
+//hash of fx variant, which doesn't depend on order of defines and is never 0
+uint64 BuildVariantHash(const FastName& fxName, const UnorderedMap<FastName, int32>& defines, const FastName& quality);
+
+//shader variants of all passes of fx, the same as GetFXDescriptor would request, but without creating shaders and render states
+Vector<ShaderDescriptorCache::ShaderVariant> GetShaderVariants(const FastName& fxName, const UnorderedMap<FastName, int32>& defines, const FastName& quality = NMaterialQualityName::DEFAULT_QUALITY_NAME);
+
+//passes of fx as they are described by template (layers, blending, template defines), without shaders and render states
+const FXDescriptor& GetFXTemplate(const FastName& fxName, const FastName& quality = NMaterialQualityName::DEFAULT_QUALITY_NAME);
 }
 }
 
@@ -764,18 +764,25 @@ void NMaterial::InvalidateRenderVariants()
     // release existing descriptor?
     ClearLocalBuffers(); // to avoid using incorrect buffers in certain situations (e.g chaning parent)
     needRebuildVariants = true;
+    fxVariantHash = 0;
     for (auto& child : children)
         child->InvalidateRenderVariants();
 }
 
 void NMaterial::PreCacheFX()
 {
+    const FastName& quality = QualitySettingsSystem::Instance()->GetCurMaterialQuality(GetQualityGroup());
+    if (fxVariantHash != 0 && fxVariantQuality == quality)
+    {
+        return; // fx variant is already requested since last change of flags
+    }
+
     UnorderedMap<FastName, int32> flags(16);
     CollectMaterialFlags(flags);
     flags.erase(NMaterialFlagName::FLAG_ILLUMINATION_USED);
     flags.erase(NMaterialFlagName::FLAG_ILLUMINATION_SHADOW_CASTER);
     flags.erase(NMaterialFlagName::FLAG_ILLUMINATION_SHADOW_RECEIVER);
-    FXCache::GetFXDescriptor(GetEffectiveFXName(), flags, QualitySettingsSystem::Instance()->GetCurMaterialQuality(GetQualityGroup()));
+    FXCache::GetFXDescriptor(GetEffectiveFXName(), flags, quality, GetFXVariantHash(flags, quality));
 }
 
 void NMaterial::PreCacheFXWithFlags(const UnorderedMap<FastName, int32>& extraFlags, const FastName& extraFxName)
@@ -813,6 +820,17 @@ void NMaterial::PreCacheFXVariations(const Vector<FastName>& fxNames, const Vect
     }
 }
 
+void NMaterial::CollectShaderVariants(Vector<ShaderDescriptorCache::ShaderVariant>& variants)
+{
+    UnorderedMap<FastName, int32> flags(16);
+    CollectMaterialFlags(flags);
+    flags.erase(NMaterialFlagName::FLAG_ILLUMINATION_USED);
+    flags.erase(NMaterialFlagName::FLAG_ILLUMINATION_SHADOW_CASTER);
+    flags.erase(NMaterialFlagName::FLAG_ILLUMINATION_SHADOW_RECEIVER);
+    Vector<ShaderDescriptorCache::ShaderVariant> fxVariants = FXCache::GetShaderVariants(GetEffectiveFXName(), flags, QualitySettingsSystem::Instance()->GetCurMaterialQuality(GetQualityGroup()));
+    variants.insert(variants.end(), fxVariants.begin(), fxVariants.end());
+}
+
 void NMaterial::RebuildRenderVariants()
 {
     InvalidateBufferBindings();
@@ -822,7 +840,8 @@ void NMaterial::RebuildRenderVariants()
     flags.erase(NMaterialFlagName::FLAG_ILLUMINATION_USED);
     flags.erase(NMaterialFlagName::FLAG_ILLUMINATION_SHADOW_CASTER);
     flags.erase(NMaterialFlagName::FLAG_ILLUMINATION_SHADOW_RECEIVER);
-    const FXDescriptor& fxDescr = FXCache::GetFXDescriptor(GetEffectiveFXName(), flags, QualitySettingsSystem::Instance()->GetCurMaterialQuality(GetQualityGroup()));
+    const FastName& quality = QualitySettingsSystem::Instance()->GetCurMaterialQuality(GetQualityGroup());
+    const FXDescriptor& fxDescr = FXCache::GetFXDescriptor(GetEffectiveFXName(), flags, quality, GetFXVariantHash(flags, quality));
 
     if (fxDescr.renderPassDescriptors.size() == 0)
     {
@@ -859,6 +878,16 @@ void NMaterial::RebuildRenderVariants()
     needRebuildTextures = true;
 }
 
+uint64 NMaterial::GetFXVariantHash(const UnorderedMap<FastName, int32>& flags, const FastName& quality)
+{
+    if (fxVariantHash == 0 || fxVariantQuality != quality)
+    {
+        fxVariantHash = FXCache::BuildVariantHash(GetEffectiveFXName(), flags, quality);
+        fxVariantQuality = quality;
+    }
+    return fxVariantHash;
+}
+
 void NMaterial::CollectMaterialFlags(UnorderedMap<FastName, int32>& target)
 {
     if (parent)
@@ -7,6 +7,7 @@
 #include "NMaterialStateDynamicPropertiesInsp.h"
 #include "NMaterialStateDynamicTexturesInsp.h"
 #include "Render/Shader.h"
+#include "Render/ShaderCache.h"
 #include "Scene3D/DataNode.h"
 
 #include "MemoryManager/MemoryProfiler.h"
@@ -158,6 +159,10 @@ public:
 
     inline uint32 GetRenderLayerID() const;
     inline uint32 GetSortingKey() const;
+    // key of shader and texture set of active variant, batches with equal keys can be drawn without state changes
+    inline uint32 GetStateSortingKey() const;
+    // batches are grouped by shader first, then by texture set
+    inline static uint32 MakeStateSortingKey(const ShaderDescriptor* shader, rhi::HTextureSet textureSet);
 
     //Configs managment
     uint32 GetConfigCount() const;
@@ -187,6 +192,8 @@ public:
     void PreCacheFX();
     void PreCacheFXWithFlags(const UnorderedMap<FastName, int32>& extraFlags, const FastName& extraFxName = FastName());
     void PreCacheFXVariations(const Vector<FastName>& fxNames, const Vector<FastName>& flags);
+    // shader variants requested by material on rebuild, used to precompile shader cache offline
+    void CollectShaderVariants(Vector<ShaderDescriptorCache::ShaderVariant>& variants);
 
     static const float32 DEFAULT_LIGHTMAP_SIZE;
 
@@ -204,6 +211,7 @@ private:
     void RebuildBindings();
     void RebuildTextureBindings();
     void RebuildRenderVariants();
+    uint64 GetFXVariantHash(const UnorderedMap<FastName, int32>& flags, const FastName& quality);
 
     bool NeedLocalOverride(UniquePropertyLayout propertyLayout);
     void ClearLocalBuffers();
@@ -243,6 +251,10 @@ private:
     // this is for render passes - not used right now - only active variant instance
     UnorderedMap<FastName, RenderVariantInstance*> renderVariants;
 
+    // hash of fx variant for current fx name, flags and quality, flags and fx name are changed only with invalidation of variants
+    uint64 fxVariantHash = 0;
+    FastName fxVariantQuality;
+
     uint32 sortingKey = 0;
     bool needRebuildBindings = true;
     bool needRebuildTextures = true;
@@ -286,6 +298,19 @@ uint32 NMaterial::GetSortingKey() const
 {
     return sortingKey;
 }
+uint32 NMaterial::GetStateSortingKey() const
+{
+    if (activeVariantInstance)
+        return MakeStateSortingKey(activeVariantInstance->shader, activeVariantInstance->textureSet);
+    else
+        return 0;
+}
+uint32 NMaterial::MakeStateSortingKey(const ShaderDescriptor* shader, rhi::HTextureSet textureSet)
+{
+    uint32 shaderBits = static_cast<uint32>(reinterpret_cast<pointer_size>(shader) >> 4) & 0xFFFF;
+    uint32 textureSetBits = static_cast<uint32>(textureSet) & 0xFFFF;
+    return (shaderBits << 16) | textureSetBits;
+}
 
 inline uint32 NMaterial::GetCurrentConfigIndex() const
 {
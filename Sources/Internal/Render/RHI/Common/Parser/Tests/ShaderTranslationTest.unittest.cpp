@@ -0,0 +1,130 @@
+#include "UnitTests/UnitTests.h"
+
+#include "FileSystem/FileSystem.h"
+#include "Logger/Logger.h"
+#include "Render/RHI/rhi_ShaderSource.h"
+#include "Render/RHI/Common/Parser/sl_Parser.h"
+#include "Render/RHI/Common/Parser/sl_Tree.h"
+#include "Time/SystemTimer.h"
+
+namespace ShaderTranslationTestDetails
+{
+using namespace DAVA;
+
+const uint32 ITERATIONS_COUNT = 5;
+const rhi::Api TARGET_APIS[] = { rhi::RHI_GLES2, rhi::RHI_DX11, rhi::RHI_METAL };
+
+struct ShaderFile
+{
+    String name;
+    String text;
+    rhi::ProgType progType;
+};
+
+Vector<ShaderFile> LoadShaders()
+{
+    Vector<ShaderFile> shaders;
+    Vector<FilePath> files = FileSystem::Instance()->EnumerateFilesInDirectory("~res:/Materials/Shaders/");
+    for (const FilePath& path : files)
+    {
+        String fileName = path.GetFilename();
+        bool isVertex = (fileName.find("-vp.sl") != String::npos);
+        bool isFragment = (fileName.find("-fp.sl") != String::npos);
+        if (isVertex || isFragment)
+        {
+            ShaderFile shader;
+            shader.name = path.GetAbsolutePathname();
+            shader.text = FileSystem::Instance()->ReadFileContents(path);
+            shader.progType = isVertex ? rhi::PROG_VERTEX : rhi::PROG_FRAGMENT;
+            shaders.push_back(shader);
+        }
+    }
+    return shaders;
+}
+
+// water shaders require shading mode, which is otherwise selected by lighting defines
+const std::vector<std::string> SHADER_DEFINES = { "MATERIAL_TEXTURE", "1", "SHADING", "0" };
+
+const char* SMALL_SHADER =
+"fragment_in\n"
+"{\n"
+"    float2 uv : TEXCOORD0;\n"
+"};\n"
+"fragment_out\n"
+"{\n"
+"    float4 color : SV_TARGET0;\n"
+"};\n"
+"uniform sampler2D albedo;\n"
+"[material][a] property float4 tint = float4(1,1,1,1);\n"
+"fragment_out fp_main(fragment_in input)\n"
+"{\n"
+"    fragment_out output;\n"
+"    float4 texel = tex2D(albedo, input.uv);\n"
+"    output.color = texel * tint;\n"
+"    return output;\n"
+"}\n";
+}
+
+DAVA_TESTCLASS (ShaderTranslationTest)
+{
+    DAVA_TEST (TreeIsAllocatedByFewBlocks)
+    {
+        using namespace DAVA;
+        using namespace ShaderTranslationTestDetails;
+
+        sl::Allocator allocator;
+        sl::HLSLParser parser(&allocator, "<shader>", SMALL_SHADER, strlen(SMALL_SHADER));
+        sl::HLSLTree tree(&allocator);
+        TEST_VERIFY(parser.Parse(&tree));
+
+        // nodes, strings and strings hash-table
+        TEST_VERIFY(tree.GetMemoryBlocksCount() <= 3);
+
+        // identifiers are interned, so equal names share the same pointer
+        const char* name = tree.AddString("texel");
+        TEST_VERIFY(tree.GetContainsString("texel"));
+        TEST_VERIFY(tree.AddString("texel") == name);
+        TEST_VERIFY(!tree.GetContainsString("no_such_identifier"));
+    }
+
+    DAVA_TEST (TranslateShippedShadersBenchmark)
+    {
+        using namespace DAVA;
+        using namespace ShaderTranslationTestDetails;
+
+        Vector<ShaderFile> shaders = LoadShaders();
+        TEST_VERIFY(!shaders.empty());
+
+        uint64 sourceSize = 0;
+        for (const ShaderFile& shader : shaders)
+        {
+            sourceSize += shader.text.size();
+        }
+
+        for (rhi::Api api : TARGET_APIS)
+        {
+            uint32 failedCount = 0;
+            int64 startTime = SystemTimer::GetUs();
+            for (uint32 iteration = 0; iteration < ITERATIONS_COUNT; ++iteration)
+            {
+                for (const ShaderFile& shader : shaders)
+                {
+                    rhi::ShaderSource source(shader.name.c_str());
+                    if (!source.Construct(shader.progType, shader.text.c_str(), SHADER_DEFINES, api) || source.GetSourceCode(api).empty())
+                    {
+                        ++failedCount;
+                    }
+                }
+            }
+            int64 time = std::max(SystemTimer::GetUs() - startTime, int64(1));
+
+            uint32 translationsCount = ITERATIONS_COUNT * uint32(shaders.size());
+            float64 seconds = float64(time) / 1000000.0;
+            Logger::Info("Translation of %u shaders to api %d: %lld us, %.1f shaders/s, %.2f MB/s",
+                         uint32(shaders.size()), int32(api), time / ITERATIONS_COUNT,
+                         translationsCount / seconds, float64(sourceSize * ITERATIONS_COUNT) / (1024.0 * 1024.0) / seconds);
+
+            TEST_VERIFY(failedCount == 0);
+        }
+    }
+};
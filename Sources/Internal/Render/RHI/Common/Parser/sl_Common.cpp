@@ -68,43 +68,180 @@ int String_ToIntegerHex(const char* str, char** endptr)
     return strtol(str, endptr, 16);
 }
 
+MemoryArena::MemoryArena(Allocator* allocator, size_t blockSize)
+    : allocator(allocator)
+    , blockSize(blockSize)
+    , firstBlock(NULL)
+    , currentOffset(0)
+    , blocksCount(0)
+{
+}
+
+MemoryArena::~MemoryArena()
+{
+    Block* block = firstBlock;
+    while (block != NULL)
+    {
+        Block* next = block->next;
+        allocator->Delete(reinterpret_cast<char*>(block));
+        block = next;
+    }
+}
+
+char* MemoryArena::GetBlockData(Block* block) const
+{
+    return reinterpret_cast<char*>(block) + sizeof(Block);
+}
+
+MemoryArena::Block* MemoryArena::AllocateBlock(size_t size)
+{
+    Block* block = reinterpret_cast<Block*>(allocator->New<char>(sizeof(Block) + size));
+    block->size = size;
+    block->next = NULL;
+    ++blocksCount;
+    return block;
+}
+
+void* MemoryArena::Allocate(size_t size, size_t alignment)
+{
+    DVASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+    size_t offset = (currentOffset + alignment - 1) & ~(alignment - 1);
+    if (firstBlock == NULL || offset + size > firstBlock->size)
+    {
+        if (size > blockSize / 4)
+        {
+            // big allocation gets its own block behind current one, so free space of current block isn't lost
+            Block* block = AllocateBlock(size);
+            if (firstBlock != NULL)
+            {
+                block->next = firstBlock->next;
+                firstBlock->next = block;
+            }
+            else
+            {
+                firstBlock = block;
+                currentOffset = size;
+            }
+            return GetBlockData(block);
+        }
+
+        // current block is always first one in list
+        Block* block = AllocateBlock(blockSize);
+        block->next = firstBlock;
+        firstBlock = block;
+        offset = 0;
+    }
+
+    currentOffset = offset + size;
+    return GetBlockData(firstBlock) + offset;
+}
+
+int MemoryArena::GetBlocksCount() const
+{
+    return blocksCount;
+}
+
+namespace StringPoolDetails
+{
+const size_t STRINGS_BLOCK_SIZE = 16 * 1024;
+const int INITIAL_CAPACITY = 256;
+
+// FNV-1a
+DAVA::uint32 Hash(const char* string)
+{
+    DAVA::uint32 hash = 2166136261u;
+    for (const char* c = string; *c; ++c)
+    {
+        hash ^= DAVA::uint8(*c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+}
+
 StringPool::StringPool(Allocator* allocator)
-    : stringArray(allocator)
+    : allocator(allocator)
+    , stringsArena(allocator, StringPoolDetails::STRINGS_BLOCK_SIZE)
+    , entries(NULL)
+    , capacity(0)
+    , count(0)
 {
+    Rehash(StringPoolDetails::INITIAL_CAPACITY);
 }
 
 StringPool::~StringPool()
 {
-    for (int i = 0; i < stringArray.GetSize(); i++)
+    allocator->Delete(entries);
+}
+
+int StringPool::FindEntry(const char* string, DAVA::uint32 hash) const
+{
+    // capacity is power of two, and table is never full, so search always ends on empty entry
+    int mask = capacity - 1;
+    int i = int(hash) & mask;
+    while (entries[i].string != NULL)
     {
-        ::free(stringArray[i]);
+        if (entries[i].hash == hash && strcmp(entries[i].string, string) == 0)
+            break;
+        i = (i + 1) & mask;
     }
+    return i;
 }
 
-const char* StringPool::AddString(const char* string)
+void StringPool::Rehash(int newCapacity)
 {
-    for (int i = 0; i < stringArray.GetSize(); i++)
+    Entry* oldEntries = entries;
+    int oldCapacity = capacity;
+
+    entries = allocator->New<Entry>(newCapacity);
+    capacity = newCapacity;
+    for (int i = 0; i < capacity; ++i)
     {
-        if (String_Equal(stringArray[i], string))
-            return stringArray[i];
+        entries[i].string = NULL;
+        entries[i].hash = 0;
     }
-#if _MSC_VER
-    char* dup = _strdup(string);
-#else
-    char* dup = strdup(string);
-#endif
-    stringArray.PushBack(dup);
-    return dup;
+
+    for (int i = 0; i < oldCapacity; ++i)
+    {
+        if (oldEntries[i].string != NULL)
+            entries[FindEntry(oldEntries[i].string, oldEntries[i].hash)] = oldEntries[i];
+    }
+
+    if (oldEntries != NULL)
+        allocator->Delete(oldEntries);
+}
+
+const char* StringPool::AddString(const char* string)
+{
+    DAVA::uint32 hash = StringPoolDetails::Hash(string);
+    int i = FindEntry(string, hash);
+    if (entries[i].string != NULL)
+        return entries[i].string;
+
+    size_t length = strlen(string);
+    char* copy = static_cast<char*>(stringsArena.Allocate(length + 1, 1));
+    memcpy(copy, string, length + 1);
+
+    entries[i].string = copy;
+    entries[i].hash = hash;
+    ++count;
+
+    // keep load factor below 1/2
+    if (count * 2 > capacity)
+        Rehash(capacity * 2);
+
+    return copy;
 }
 
 bool StringPool::GetContainsString(const char* string) const
 {
-    for (int i = 0; i < stringArray.GetSize(); i++)
-    {
-        if (String_Equal(stringArray[i], string))
-            return true;
-    }
-    return false;
+    return entries[FindEntry(string, StringPoolDetails::Hash(string))].string != NULL;
+}
+
+int StringPool::GetBlocksCount() const
+{
+    return stringsArena.GetBlocksCount() + 1;
 }
 
 } // namespace sl
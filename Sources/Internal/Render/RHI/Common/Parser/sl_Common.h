@@ -144,8 +144,10 @@ private:
             int new_buffer_size;
             if (capacity == 0)
             {
-                // first allocation is exact
+                // first allocation reserves few items, so short arrays aren't reallocated on each PushBack
                 new_buffer_size = new_size;
+                if (new_buffer_size < s_minCapacity)
+                    new_buffer_size = s_minCapacity;
             }
             else
             {
@@ -181,23 +183,74 @@ private:
     }
 
 private:
+    static const int s_minCapacity = 8;
+
     Allocator* allocator; // @@ Do we really have to keep a pointer to this?
     T* buffer;
     int m_size;
     int capacity;
 };
 
-// Engine/StringPool.h
+/**
+    Linear allocator, which takes memory from `allocator` by big blocks and releases all of them at once on destruction.
+    Allocations bigger than block size get dedicated blocks.
+*/
+class MemoryArena
+{
+public:
+    MemoryArena(Allocator* allocator, size_t blockSize);
+    ~MemoryArena();
+
+    MemoryArena(const MemoryArena&) = delete;
+    MemoryArena& operator=(const MemoryArena&) = delete;
+
+    void* Allocate(size_t size, size_t alignment = sizeof(void*));
+    int GetBlocksCount() const;
+
+private:
+    struct Block
+    {
+        Block* next;
+        size_t size;
+    };
+
+    char* GetBlockData(Block* block) const;
+    Block* AllocateBlock(size_t size);
+
+    Allocator* allocator;
+    size_t blockSize;
+    Block* firstBlock;
+    size_t currentOffset;
+    int blocksCount;
+};
 
-// @@ Implement this with a hash table!
+/**
+    Interned strings: equal strings added to pool share the same pointer, so they can be compared by pointer.
+    Strings are stored in memory arena and are looked up in open-addressing hash table.
+*/
 struct StringPool
 {
     StringPool(Allocator* allocator);
     ~StringPool();
     const char* AddString(const char* string);
     bool GetContainsString(const char* string) const;
+    int GetBlocksCount() const;
 
-    Array<char*> stringArray;
+private:
+    struct Entry
+    {
+        const char* string;
+        DAVA::uint32 hash;
+    };
+
+    int FindEntry(const char* string, DAVA::uint32 hash) const;
+    void Rehash(int newCapacity);
+
+    Allocator* allocator;
+    MemoryArena stringsArena;
+    Entry* entries;
+    int capacity;
+    int count;
 };
 
 enum Target
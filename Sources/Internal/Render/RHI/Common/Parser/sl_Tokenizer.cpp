@@ -11,6 +11,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
+#include <algorithm>
 
 namespace sl
 {
@@ -95,6 +96,40 @@ static const char* _reservedWords[] =
   "color_mask7"
 };
 
+static const int _numReservedWords = sizeof(_reservedWords) / sizeof(const char*);
+
+/** Returns index of reserved word or -1, words are searched by binary search in sorted index */
+static int FindReservedWord(const char* identifier)
+{
+    struct SortedIndex
+    {
+        SortedIndex()
+        {
+            for (int i = 0; i < _numReservedWords; ++i)
+                word[i] = i;
+            std::sort(word, word + _numReservedWords, [](int l, int r) { return strcmp(_reservedWords[l], _reservedWords[r]) < 0; });
+        }
+        int word[_numReservedWords];
+    };
+    static const SortedIndex index;
+
+    int first = 0;
+    int last = _numReservedWords;
+    while (first < last)
+    {
+        int middle = (first + last) / 2;
+        int cmp = strcmp(_reservedWords[index.word[middle]], identifier);
+        if (cmp == 0)
+            return index.word[middle];
+
+        if (cmp < 0)
+            first = middle + 1;
+        else
+            last = middle;
+    }
+    return -1;
+}
+
 static bool GetIsSymbol(char c)
 {
     switch (c)
@@ -267,17 +302,8 @@ void HLSLTokenizer::Next()
     memcpy(m_identifier, start, length);
     m_identifier[length] = 0;
 
-    const int numReservedWords = sizeof(_reservedWords) / sizeof(const char*);
-    for (int i = 0; i < numReservedWords; ++i)
-    {
-        if (strcmp(_reservedWords[i], m_identifier) == 0)
-        {
-            m_token = 256 + i;
-            return;
-        }
-    }
-
-    m_token = HLSLToken_Identifier;
+    int reservedWord = FindReservedWord(m_identifier);
+    m_token = (reservedWord != -1) ? 256 + reservedWord : HLSLToken_Identifier;
 }
 
 void HLSLTokenizer::ScanString()
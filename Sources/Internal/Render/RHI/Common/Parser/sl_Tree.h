@@ -793,7 +793,7 @@ public:
     template <class T>
     T* AddNode(const char* fileName, int line)
     {
-        HLSLNode* node = new (AllocateMemory(sizeof(T))) T();
+        HLSLNode* node = new (m_nodesArena.Allocate(sizeof(T), alignof(T))) T();
         node->nodeType = T::s_type;
         node->fileName = fileName;
         node->line = line;
@@ -813,26 +813,16 @@ public:
     bool GetExpressionValue(HLSLExpression* expression, int& value);
     //bool GetExpressionValue(HLSLExpression * expression, float & value);
 
-private:
-    void* AllocateMemory(size_t size);
-    void AllocatePage();
+    /** Returns count of memory blocks allocated for nodes and strings of the tree. */
+    int GetMemoryBlocksCount() const;
 
 private:
-    static const size_t s_nodePageSize = 1024 * 4;
-
-    struct NodePage
-    {
-        NodePage* next;
-        char buffer[s_nodePageSize];
-    };
+    static const size_t s_nodesBlockSize = 64 * 1024;
 
     Allocator* m_allocator;
+    MemoryArena m_nodesArena;
     StringPool m_stringPool;
     HLSLRoot* m_root;
-
-    NodePage* m_firstPage;
-    NodePage* m_currentPage;
-    size_t m_currentPageOffset;
 };
 
 class HLSLTreeVisitor
@@ -8,10 +8,13 @@
 using DAVA::Logger;
 #include "FileSystem/DynamicMemoryFile.h"
 #include "FileSystem/FileSystem.h"
+#include "FileSystem/UnmanagedMemoryFile.h"
+#include "FileSystem/Private/MappedFile.h"
 using DAVA::DynamicMemoryFile;
 #include "Utils/Utils.h"
 #include "Utils/StringFormat.h"
 #include "Debug/ProfilerCPU.h"
+#include "Time/SystemTimer.h"
 #include "Concurrency/Mutex.h"
 #include "Concurrency/LockGuard.h"
 using DAVA::Mutex;
@@ -42,10 +45,14 @@ public:
         ClearCache();
     }
 
+    // shaders may be constructed from several threads at once, and pre-processor always calls
+    // Open-Size-Read-Close in sequence, so callback is locked from Open till Close
     bool Open(const char* file_name) override
     {
         bool success = false;
 
+        fileMutex.Lock();
+
         for (size_t k = 0; k != _file.size(); ++k)
         {
             if (_file[k].name == file_name)
@@ -88,6 +95,9 @@ public:
             }
         }
 
+        if (!success)
+            fileMutex.Unlock();
+
         return success;
     }
 
@@ -95,6 +105,8 @@ public:
     {
         _cur_data = nullptr;
         _cur_data_sz = 0;
+
+        fileMutex.Unlock();
     }
 
     unsigned Size() const override
@@ -112,11 +124,13 @@ public:
 
     void AddIncludeDirectory(const char* dir)
     {
+        LockGuard<Mutex> guard(fileMutex);
         inclDir.emplace_back(dir);
     }
 
     void ClearCache()
     {
+        LockGuard<Mutex> guard(fileMutex);
         for (size_t k = 0; k != _file.size(); ++k)
         {
             ::free(_file[k].data);
@@ -136,6 +150,7 @@ private:
     unsigned _cur_data_sz;
 
     std::vector<std::string> inclDir;
+    Mutex fileMutex;
 };
 
 static ShaderFileCallback ShaderSourceFileCallback("~res:/Materials/Shaders");
@@ -169,6 +184,13 @@ bool ShaderSource::Construct(ProgType progType, const char* srcText)
 //------------------------------------------------------------------------------
 
 bool ShaderSource::Construct(ProgType progType, const char* srcText, const std::vector<std::string>& defines)
+{
+    return ShaderSource::Construct(progType, srcText, defines, HostApi());
+}
+
+//------------------------------------------------------------------------------
+
+bool ShaderSource::Construct(ProgType progType, const char* srcText, const std::vector<std::string>& defines, Api targetApi)
 {
     bool success = false;
     DAVA::PreProc pre_proc(&ShaderSourceFileCallback);
@@ -257,7 +279,7 @@ bool ShaderSource::Construct(ProgType progType, const char* srcText, const std::
                 InlineFunctions();
 
             // ugly workaround to save some memory
-            GetSourceCode(HostApi());
+            GetSourceCode(targetApi);
             delete ast;
             ast = nullptr;
         }
@@ -1742,10 +1764,10 @@ const DAVA::String& ShaderSource::GetSourceCode(Api targetApi) const
 
     if (code[targetApi].empty() && (ast != nullptr))
     {
-        static sl::Allocator alloc;
-        static sl::HLSLGenerator hlsl_gen(&alloc);
-        static sl::GLESGenerator gles_gen(&alloc);
-        static sl::MSLGenerator mtl_gen(&alloc);
+        sl::Allocator alloc;
+        sl::HLSLGenerator hlsl_gen(&alloc);
+        sl::GLESGenerator gles_gen(&alloc);
+        sl::MSLGenerator mtl_gen(&alloc);
 
         bool codeGenerated = false;
         const char* main = (type == PROG_VERTEX) ? "vp_main" : "fp_main";
@@ -2047,14 +2069,22 @@ const ShaderSource* ShaderSourceCache::Get(FastName uid, uint32 srcHash)
 
 //------------------------------------------------------------------------------
 const ShaderSource* ShaderSourceCache::Add(const char* filename, FastName uid, ProgType progType, const char* srcText, const std::vector<std::string>& defines)
+{
+    return ShaderSourceCache::Add(filename, uid, progType, srcText, defines, HostApi());
+}
+
+//------------------------------------------------------------------------------
+
+const ShaderSource* ShaderSourceCache::Add(const char* filename, FastName uid, ProgType progType, const char* srcText, const std::vector<std::string>& defines, Api targetApi)
 {
     ShaderSource* src = new ShaderSource(filename);
 
-    if (src->Construct(progType, srcText, defines))
+    // construction is done outside of lock, so sources can be translated in parallel
+    if (src->Construct(progType, srcText, defines, targetApi))
     {
         LockGuard<Mutex> guard(shaderSourceEntryMutex);
 
-        uint32 api = HostApi();
+        uint32 api = targetApi;
         uint32 srcHash = DAVA::HashValue_N(srcText, unsigned(strlen(srcText)));
 
         bool doAdd = true;
@@ -2103,6 +2133,20 @@ void ShaderSourceCache::Clear()
 
 //------------------------------------------------------------------------------
 
+std::vector<ShaderSourceCache::EntryDesc> ShaderSourceCache::GetEntries()
+{
+    LockGuard<Mutex> guard(shaderSourceEntryMutex);
+
+    std::vector<EntryDesc> entries;
+    entries.reserve(Entry.size());
+    for (std::vector<entry_t>::const_iterator e = Entry.begin(), e_end = Entry.end(); e != e_end; ++e)
+        entries.push_back({ e->uid, Api(e->api), e->srcHash, e->src });
+
+    return entries;
+}
+
+//------------------------------------------------------------------------------
+
 void ShaderSourceCache::Save(const char* fileName)
 {
     using namespace DAVA;
@@ -2153,16 +2197,27 @@ void ShaderSourceCache::Load(const char* fileName)
 {
     using namespace DAVA;
 
-    ScopedPtr<File> file(File::Create(fileName, File::READ | File::OPEN));
+    // cache is read with lots of small reads, so it is mapped into memory when possible
+    std::shared_ptr<MappedFile> mappedFile = MappedFile::Create(fileName);
+    ScopedPtr<File> file;
+    if (mappedFile && mappedFile->GetSize() <= std::numeric_limits<uint32>::max())
+        file = new UnmanagedMemoryFile(mappedFile->GetData(), uint32(mappedFile->GetSize()));
+    else
+        file = File::Create(fileName, File::READ | File::OPEN);
 
     if (file)
     {
         Clear();
 
+        int64 loadStartTime = SystemTimer::GetMs();
         bool success = true;
         SCOPE_EXIT
         {
-            if (!success)
+            if (success)
+            {
+                Logger::Info("cached-shaders loaded in %lld ms", SystemTimer::GetMs() - loadStartTime);
+            }
+            else
             {
                 Clear();
                 Logger::Warning("ShaderSource-Cache failed to load, ignoring cached shaders\n");
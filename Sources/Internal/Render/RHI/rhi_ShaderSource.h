@@ -72,6 +72,7 @@ public:
     ~ShaderSource();
 
     bool Construct(ProgType progType, const char* srcText, const std::vector<std::string>& defines);
+    bool Construct(ProgType progType, const char* srcText, const std::vector<std::string>& defines, Api targetApi);
     void InlineFunctions();
     bool Construct(ProgType progType, const char* srcText);
     bool Load(Api api, DAVA::File* in);
@@ -122,11 +123,24 @@ ShaderSourceCache
 public:
     static const ShaderSource* Get(FastName uid, uint32 srcHash);
     static const ShaderSource* Add(const char* filename, FastName uid, ProgType progType, const char* srcText, const std::vector<std::string>& defines);
+    // adds source translated for `targetApi` instead of host api, may be called from several threads (e.g. by offline shader-cache builder)
+    static const ShaderSource* Add(const char* filename, FastName uid, ProgType progType, const char* srcText, const std::vector<std::string>& defines, Api targetApi);
 
     static void Clear();
     static void Save(const char* fileName);
     static void Load(const char* fileName);
 
+    struct
+    EntryDesc
+    {
+        FastName uid;
+        Api api;
+        uint32 srcHash;
+        const ShaderSource* src; // valid until entry is replaced or cache is cleared
+    };
+    // descriptions of all cached sources, e.g. to compare saved cache with the loaded one
+    static std::vector<EntryDesc> GetEntries();
+
 private:
     struct
     entry_t
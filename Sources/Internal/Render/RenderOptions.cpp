@@ -45,7 +45,9 @@ FastName optionsNames[RenderOptions::OPTIONS_COUNT] =
   FastName("Draw Nondef Glyph"),
   FastName("Highlight Hard Controls"),
   FastName("Debug Draw Rich Items"),
-  FastName("Debug Draw Particles")
+  FastName("Debug Draw Particles"),
+
+  FastName("Batched Culling")
 };
 
 RenderOptions::RenderOptions()
@@ -69,6 +71,8 @@ RenderOptions::RenderOptions()
     options[DEBUG_DRAW_RICH_ITEMS] = false;
 
     options[DEBUG_DRAW_PARTICLES] = false;
+
+    options[BATCHED_CULLING] = false;
 }
 
 bool RenderOptions::IsOptionEnabled(RenderOption option)
@@ -56,6 +56,8 @@ public:
 
         DEBUG_DRAW_PARTICLES,
 
+        BATCHED_CULLING,
+
         OPTIONS_COUNT
     };
 
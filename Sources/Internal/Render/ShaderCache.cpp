@@ -1,7 +1,11 @@
 #include "Render/ShaderCache.h"
+#include "Render/LockFreeLookupTable.h"
 #include "Render/RHI/rhi_ShaderCache.h"
 #include "FileSystem/FileSystem.h"
 #include "Concurrency/LockGuard.h"
+#include "Engine/Engine.h"
+#include "Engine/EngineContext.h"
+#include "Job/JobManager.h"
 #include "Logger/Logger.h"
 #include "Utils/StringFormat.h"
 #include "Render/RHI/rhi_ShaderSource.h"
@@ -26,11 +30,29 @@ struct ShaderSourceCode
 
 namespace
 {
-Map<Vector<size_t>, ShaderDescriptor*> shaderDescriptors;
+LockFreeLookupTable<ShaderDescriptor> shaderDescriptors;
+Vector<ShaderDescriptor*> shaderDescriptorsList;
 Map<FastName, ShaderSourceCode> shaderSourceCodes;
 Mutex shaderCacheMutex;
 bool loadingNotifyEnabled = false;
 bool initialized = false;
+
+// splitmix64 finalizer
+uint64 MixHash(uint64 value)
+{
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ull;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebull;
+    value ^= value >> 31;
+    return value;
+}
+
+void AddDescriptor(uint64 hash, ShaderDescriptor* descriptor)
+{
+    shaderDescriptors.Add(hash, descriptor);
+    shaderDescriptorsList.push_back(descriptor);
+}
 }
 
 void Initialize()
@@ -59,9 +81,9 @@ void ClearDynamicBindigs()
 
     LockGuard<Mutex> guard(shaderCacheMutex);
 
-    for (auto& it : shaderDescriptors)
+    for (ShaderDescriptor* descriptor : shaderDescriptorsList)
     {
-        it.second->ClearDynamicBindings();
+        descriptor->ClearDynamicBindings();
     }
 }
 
@@ -71,26 +93,17 @@ size_t GetUniqueFlagKey(FastName flagName)
     return reinterpret_cast<size_t>(flagName.c_str());
 }
 
-Vector<size_t> BuildFlagsKey(const FastName& name, const UnorderedMap<FastName, int32>& defines)
+uint64 BuildVariantHash(const FastName& name, const UnorderedMap<FastName, int32>& defines)
 {
-    Vector<size_t> key;
-
-    key.reserve(defines.size() * 2 + 1);
+    // hashes of defines are summed, so result doesn't depend on order of iteration
+    uint64 definesHash = 0;
     for (const auto& define : defines)
     {
-        key.emplace_back(GetUniqueFlagKey(define.first));
-        key.emplace_back(define.second);
+        definesHash += MixHash(MixHash(uint64(GetUniqueFlagKey(define.first))) ^ uint64(uint32(define.second)));
     }
 
-    // reinterpret cast to pairs and sort them
-    using SizeTPair = std::pair<size_t, size_t>;
-    SizeTPair* begin = reinterpret_cast<SizeTPair*>(key.data());
-    std::sort(begin, begin + key.size() / 2, [](const SizeTPair& l, const SizeTPair& r) {
-        return l.first < r.first;
-    });
-
-    key.push_back(GetUniqueFlagKey(name));
-    return key;
+    uint64 hash = MixHash(uint64(GetUniqueFlagKey(name)) + definesHash);
+    return (hash != 0) ? hash : 1;
 }
 
 void LoadFromSource(const String& source, ShaderSourceCode& sourceCode)
@@ -189,20 +202,10 @@ void SetLoadingNotifyEnabled(bool enable)
 #define LOG_TRACE_USAGE(...)
 #endif
 
-ShaderDescriptor* GetShaderDescriptor(const FastName& name, const UnorderedMap<FastName, int32>& defines)
+// Sorted list of define names and values for pre-processor, and resource name used in program uids
+String BuildProgramDefines(const FastName& name, const UnorderedMap<FastName, int32>& defines, Vector<String>& progDefines)
 {
-    DVASSERT(initialized);
-
-    LockGuard<Mutex> guard(shaderCacheMutex);
-
-    Vector<size_t> key = BuildFlagsKey(name, defines);
-
-    auto descriptorIt = shaderDescriptors.find(key);
-    if (descriptorIt != shaderDescriptors.end())
-        return descriptorIt->second;
-
-    //not found - create new shader
-    Vector<String> progDefines;
+    progDefines.clear();
     progDefines.reserve(defines.size() * 2);
     String resName(name.c_str());
     resName += "  defines: ";
@@ -231,6 +234,35 @@ ShaderDescriptor* GetShaderDescriptor(const FastName& name, const UnorderedMap<F
     for (size_t i = 0; i != progDefines.size(); i += 2)
         resName += Format("%s = %s, ", progDefines[i + 0].c_str(), progDefines[i + 1].c_str());
 
+    return resName;
+}
+
+ShaderDescriptor* GetShaderDescriptor(const FastName& name, const UnorderedMap<FastName, int32>& defines)
+{
+    DVASSERT(initialized);
+
+    uint64 variantHash = BuildVariantHash(name, defines);
+
+    // hash doesn't identify variant, so name and defines of found descriptor are compared too
+    auto isSameVariant = [&name, &defines](const ShaderDescriptor* descriptor) {
+        return descriptor->sourceName == name && descriptor->defines == defines;
+    };
+
+    ShaderDescriptor* descriptor = shaderDescriptors.Find(variantHash, isSameVariant);
+    if (descriptor != nullptr)
+        return descriptor;
+
+    LockGuard<Mutex> guard(shaderCacheMutex);
+
+    // descriptor could be created by another thread while we were waiting for lock
+    descriptor = shaderDescriptors.Find(variantHash, isSameVariant);
+    if (descriptor != nullptr)
+        return descriptor;
+
+    //not found - create new shader
+    Vector<String> progDefines;
+    String resName = BuildProgramDefines(name, defines, progDefines);
+
     if (loadingNotifyEnabled)
     {
         Logger::Error("Forbidden call to GetShaderDescriptor %s", resName.c_str());
@@ -276,7 +308,7 @@ ShaderDescriptor* GetShaderDescriptor(const FastName& name, const UnorderedMap<F
         res->sourceName = name;
         res->defines = defines;
         res->valid = false;
-        shaderDescriptors[key] = res;
+        AddDescriptor(variantHash, res);
         return res;
     }
 
@@ -338,10 +370,79 @@ ShaderDescriptor* GetShaderDescriptor(const FastName& name, const UnorderedMap<F
         DAVA::Logger::Info("  fprog-uid = %s", fProgUid.c_str());
     }
 
-    shaderDescriptors[key] = res;
+    AddDescriptor(variantHash, res);
     return res;
 }
 
+PrecompileReport PrecompileShaders(const Vector<ShaderVariant>& variants, rhi::Api targetApi, bool parallel)
+{
+    DVASSERT(initialized);
+
+    struct ProgramTask
+    {
+        FastName uid;
+        rhi::ProgType progType;
+        const FilePath* sourcePath;
+        const char* sourceText;
+        Vector<String> progDefines;
+        bool constructed;
+    };
+
+    LockGuard<Mutex> guard(shaderCacheMutex);
+
+    //sources are loaded and uids are built serially, only translation is done in parallel
+    Vector<ProgramTask> tasks;
+    tasks.reserve(variants.size() * 2);
+    Set<FastName> processedUids;
+    for (const ShaderVariant& variant : variants)
+    {
+        Vector<String> progDefines;
+        String resName = BuildProgramDefines(variant.sourceName, variant.defines, progDefines);
+
+        FastName vProgUid(String("vSource: ") + resName);
+        if (!processedUids.insert(vProgUid).second)
+            continue;
+
+        const ShaderSourceCode& sourceCode = GetSourceCode(variant.sourceName);
+        tasks.push_back({ vProgUid, rhi::PROG_VERTEX, &sourceCode.vertexProgSourcePath, sourceCode.vertexProgText.data(), progDefines, false });
+        tasks.push_back({ FastName(String("fSource: ") + resName), rhi::PROG_FRAGMENT, &sourceCode.fragmentProgSourcePath, sourceCode.fragmentProgText.data(), progDefines, false });
+    }
+
+    auto constructPrograms = [&tasks, targetApi](uint32 begin, uint32 end) {
+        for (uint32 i = begin; i < end; ++i)
+        {
+            ProgramTask& task = tasks[i];
+            task.constructed = (rhi::ShaderSourceCache::Add(task.sourcePath->GetFrameworkPath().c_str(), task.uid, task.progType, task.sourceText, task.progDefines, targetApi) != nullptr);
+        }
+    };
+
+    JobManager* jobManager = GetEngineContext()->jobManager;
+    if (parallel && jobManager != nullptr && jobManager->GetWorkersCount() > 0)
+    {
+        //translation of single program is long enough, so programs are distributed one by one
+        jobManager->ParallelFor(0, uint32(tasks.size()), constructPrograms, 1);
+    }
+    else
+    {
+        constructPrograms(0, uint32(tasks.size()));
+    }
+
+    PrecompileReport report;
+    report.uniqueCount = uint32(tasks.size() / 2);
+    for (size_t i = 0; i < tasks.size(); i += 2)
+    {
+        if (tasks[i].constructed && tasks[i + 1].constructed)
+        {
+            ++report.compiledCount;
+        }
+        else
+        {
+            Logger::Error("failed to precompile \"%s\"", tasks[i].uid.c_str());
+        }
+    }
+    return report;
+}
+
 void ReloadShaders()
 {
     DVASSERT(initialized);
@@ -351,9 +452,8 @@ void ReloadShaders()
     rhi::ShaderSource::PurgeIncludesCache();
 
     //reload shaders
-    for (auto& shaderDescr : shaderDescriptors)
+    for (ShaderDescriptor* shader : shaderDescriptorsList)
     {
-        ShaderDescriptor* shader = shaderDescr.second;
 
         /*Sources*/
         ShaderSourceCode sourceCode = GetSourceCode(shader->sourceName);
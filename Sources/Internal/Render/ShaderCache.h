@@ -16,8 +16,29 @@ void ClearDynamicBindigs();
 void ReloadShaders();
 
 void SetLoadingNotifyEnabled(bool enable);
+/** Descriptors, which are already created, are looked up by variant hash without locks. */
 ShaderDescriptor* GetShaderDescriptor(const FastName& name, const UnorderedMap<FastName, int32>& defines);
-Vector<size_t> BuildFlagsKey(const FastName& name, const UnorderedMap<FastName, int32>& defines);
+/** Return hash of shader variant, which doesn't depend on order of defines and is never 0. */
+uint64 BuildVariantHash(const FastName& name, const UnorderedMap<FastName, int32>& defines);
 size_t GetUniqueFlagKey(FastName flagName);
+
+struct ShaderVariant
+{
+    FastName sourceName;
+    UnorderedMap<FastName, int32> defines;
+};
+
+struct PrecompileReport
+{
+    uint32 uniqueCount = 0; //variants with different programs, materials often share them
+    uint32 compiledCount = 0; //unique variants translated successfully
+};
+
+/**
+    Translate programs of shader variants for `targetApi` and put them into rhi::ShaderSourceCache
+    with the same uids, which GetShaderDescriptor uses, so saved cache is used by runtime without translation.
+    Programs are translated in parallel by JobManager if `parallel` is set, pipeline-states are not created.
+*/
+PrecompileReport PrecompileShaders(const Vector<ShaderVariant>& variants, rhi::Api targetApi, bool parallel = true);
 };
 };
@@ -0,0 +1,308 @@
+#include "UnitTests/UnitTests.h"
+
+#include "Base/ScopedPtr.h"
+#include "Concurrency/Atomic.h"
+#include "Concurrency/Thread.h"
+#include "Logger/Logger.h"
+#include "Render/LockFreeLookupTable.h"
+#include "Render/Material/FXCache.h"
+#include "Render/Material/NMaterialNames.h"
+#include "Render/ShaderCache.h"
+#include "Time/SystemTimer.h"
+
+namespace ShaderDescriptorCacheTestDetails
+{
+using namespace DAVA;
+
+const uint32 LOOKUPS_COUNT = 200000;
+const uint32 LOADER_THREADS_COUNT = 4;
+const uint32 TABLE_ENTRIES_COUNT = 20000;
+const uint32 TABLE_ENTRIES_BATCH = 500;
+
+const FastName SHADER_NAME("~res:/Materials/Shaders/Default/materials");
+const FastName& FX_NAME = NMaterialName::TEXTURED_OPAQUE;
+const FastName VARIANT_FLAGS[] = { FastName("VERTEX_FOG"), FastName("ALPHATEST"), FastName("VERTEX_COLOR") };
+
+struct Variant
+{
+    UnorderedMap<FastName, int32> defines;
+    ShaderDescriptor* descriptor = nullptr;
+    uint64 fxVariantHash = 0;
+    const FXDescriptor* fxDescriptor = nullptr;
+};
+
+Vector<Variant> CreateVariants()
+{
+    const uint32 flagsCount = uint32(sizeof(VARIANT_FLAGS) / sizeof(VARIANT_FLAGS[0]));
+
+    Vector<Variant> variants(1 << flagsCount);
+    for (uint32 i = 0; i < uint32(variants.size()); ++i)
+    {
+        Variant& variant = variants[i];
+        variant.defines[FastName("MATERIAL_TEXTURE")] = 1;
+        for (uint32 f = 0; f < flagsCount; ++f)
+        {
+            if ((i & (1 << f)) != 0)
+                variant.defines[VARIANT_FLAGS[f]] = 1;
+        }
+        variant.descriptor = ShaderDescriptorCache::GetShaderDescriptor(SHADER_NAME, variant.defines);
+
+        // like NMaterial does, hash of fx variant is computed once and passed to every lookup
+        variant.fxVariantHash = FXCache::BuildVariantHash(FX_NAME, variant.defines, NMaterialQualityName::DEFAULT_QUALITY_NAME);
+        variant.fxDescriptor = &FXCache::GetFXDescriptor(FX_NAME, variant.defines, NMaterialQualityName::DEFAULT_QUALITY_NAME, variant.fxVariantHash);
+    }
+    return variants;
+}
+
+// return count of lookups, which returned wrong descriptor
+uint32 LookupVariants(Vector<Variant>& variants, uint32 count, uint32 seed)
+{
+    uint32 mismatchCount = 0;
+    for (uint32 i = 0; i < count; ++i)
+    {
+        Variant& variant = variants[(i + seed) % variants.size()];
+        if (ShaderDescriptorCache::GetShaderDescriptor(SHADER_NAME, variant.defines) != variant.descriptor)
+            ++mismatchCount;
+    }
+    return mismatchCount;
+}
+
+// the same for fx descriptors, looked up as NMaterial does it on rebuild of render variants
+uint32 LookupFXVariants(Vector<Variant>& variants, uint32 count, uint32 seed)
+{
+    uint32 mismatchCount = 0;
+    for (uint32 i = 0; i < count; ++i)
+    {
+        Variant& variant = variants[(i + seed) % variants.size()];
+        const FXDescriptor& fxDescriptor = FXCache::GetFXDescriptor(FX_NAME, variant.defines, NMaterialQualityName::DEFAULT_QUALITY_NAME, variant.fxVariantHash);
+        if (&fxDescriptor != variant.fxDescriptor)
+            ++mismatchCount;
+    }
+    return mismatchCount;
+}
+
+// time of `lookup` in one thread and in LOADER_THREADS_COUNT threads, in microseconds
+template <typename Fn>
+std::pair<int64, int64> MeasureLookups(Vector<Variant>& variants, Fn lookup, Atomic<uint32>& mismatchCount)
+{
+    int64 startTime = SystemTimer::GetUs();
+    uint32 mismatch = lookup(variants, LOOKUPS_COUNT, 0);
+    int64 singleThreadTime = std::max(SystemTimer::GetUs() - startTime, int64(1));
+    while (mismatch-- > 0)
+        mismatchCount.Increment();
+
+    Vector<ScopedPtr<Thread>> threads;
+    for (uint32 t = 0; t < LOADER_THREADS_COUNT; ++t)
+    {
+        threads.emplace_back(Thread::Create([&variants, &lookup, &mismatchCount, t]() {
+            uint32 mismatch = lookup(variants, LOOKUPS_COUNT, t);
+            while (mismatch-- > 0)
+                mismatchCount.Increment();
+        }));
+    }
+
+    startTime = SystemTimer::GetUs();
+    for (ScopedPtr<Thread>& thread : threads)
+    {
+        thread->Start();
+    }
+    for (ScopedPtr<Thread>& thread : threads)
+    {
+        thread->Join();
+    }
+    int64 threadsTime = std::max(SystemTimer::GetUs() - startTime, int64(1));
+
+    return std::make_pair(singleThreadTime, threadsTime);
+}
+
+// keys are spread like variant hashes are, and are never 0
+uint64 GetTableKey(uint32 index)
+{
+    return (uint64(index) + 1) * 0x9e3779b97f4a7c15ull;
+}
+
+struct TableEntry
+{
+    uint32 index = 0;
+};
+
+// entries are found by their index, as descriptors are found by their variant
+struct IsEntry
+{
+    uint32 index;
+    bool operator()(const TableEntry* entry) const
+    {
+        return entry->index == index;
+    }
+};
+}
+
+DAVA_TESTCLASS (ShaderDescriptorCacheTest)
+{
+    DAVA_TEST (VariantHashDoesntDependOnDefinesOrder)
+    {
+        using namespace DAVA;
+        using namespace ShaderDescriptorCacheTestDetails;
+
+        UnorderedMap<FastName, int32> defines(4);
+        defines[FastName("MATERIAL_TEXTURE")] = 1;
+        defines[FastName("VERTEX_FOG")] = 1;
+        defines[FastName("BLENDING")] = 2;
+
+        UnorderedMap<FastName, int32> reversedDefines(64);
+        reversedDefines[FastName("BLENDING")] = 2;
+        reversedDefines[FastName("VERTEX_FOG")] = 1;
+        reversedDefines[FastName("MATERIAL_TEXTURE")] = 1;
+
+        uint64 hash = ShaderDescriptorCache::BuildVariantHash(SHADER_NAME, defines);
+        TEST_VERIFY(hash != 0);
+        TEST_VERIFY(hash == ShaderDescriptorCache::BuildVariantHash(SHADER_NAME, reversedDefines));
+        TEST_VERIFY(hash != ShaderDescriptorCache::BuildVariantHash(FastName("~res:/Materials/Shaders/Default/water"), defines));
+
+        reversedDefines[FastName("BLENDING")] = 1;
+        TEST_VERIFY(hash != ShaderDescriptorCache::BuildVariantHash(SHADER_NAME, reversedDefines));
+
+        reversedDefines.erase(FastName("BLENDING"));
+        TEST_VERIFY(hash != ShaderDescriptorCache::BuildVariantHash(SHADER_NAME, reversedDefines));
+    }
+
+    DAVA_TEST (LookupBenchmark)
+    {
+        using namespace DAVA;
+        using namespace ShaderDescriptorCacheTestDetails;
+
+        // descriptors are created on main thread, loader threads only look them up
+        Vector<Variant> variants = CreateVariants();
+        for (const Variant& variant : variants)
+        {
+            TEST_VERIFY(variant.descriptor != nullptr);
+            TEST_VERIFY(variant.fxDescriptor != nullptr && variant.fxDescriptor->fxName == FX_NAME);
+        }
+
+        Atomic<uint32> mismatchCount(0);
+        std::pair<int64, int64> shaderTime = MeasureLookups(variants, LookupVariants, mismatchCount);
+        std::pair<int64, int64> fxTime = MeasureLookups(variants, LookupFXVariants, mismatchCount);
+        TEST_VERIFY(mismatchCount.Get() == 0);
+
+        Logger::Info("Shader descriptor lookups: %.0f per second in 1 thread, %.0f per second in %u threads",
+                     LOOKUPS_COUNT * 1000000.0 / shaderTime.first,
+                     LOOKUPS_COUNT * LOADER_THREADS_COUNT * 1000000.0 / shaderTime.second, LOADER_THREADS_COUNT);
+        Logger::Info("FX descriptor lookups: %.0f per second in 1 thread, %.0f per second in %u threads",
+                     LOOKUPS_COUNT * 1000000.0 / fxTime.first,
+                     LOOKUPS_COUNT * LOADER_THREADS_COUNT * 1000000.0 / fxTime.second, LOADER_THREADS_COUNT);
+    }
+
+    DAVA_TEST (FXVariantsWithEqualHashesAreDistinguished)
+    {
+        using namespace DAVA;
+        using namespace ShaderDescriptorCacheTestDetails;
+
+        UnorderedMap<FastName, int32> defines(4);
+        defines[FastName("MATERIAL_TEXTURE")] = 1;
+        UnorderedMap<FastName, int32> otherDefines(defines);
+        otherDefines[FastName("VERTEX_FOG")] = 1;
+
+        // variants are found by their full key, not only by hash
+        uint64 hash = FXCache::BuildVariantHash(FX_NAME, defines, NMaterialQualityName::DEFAULT_QUALITY_NAME);
+        const FXDescriptor& descriptor = FXCache::GetFXDescriptor(FX_NAME, defines, NMaterialQualityName::DEFAULT_QUALITY_NAME, hash);
+        const FXDescriptor& otherDescriptor = FXCache::GetFXDescriptor(FX_NAME, otherDefines);
+        TEST_VERIFY(&descriptor != &otherDescriptor);
+        TEST_VERIFY(descriptor.defines == defines);
+        TEST_VERIFY(otherDescriptor.defines == otherDefines);
+        TEST_VERIFY(&descriptor == &FXCache::GetFXDescriptor(FX_NAME, defines));
+
+        // hashes of variants collide rarely, so collision is made up in table itself
+        LockFreeLookupTable<TableEntry> table(8);
+        Array<TableEntry, 3> entries;
+        for (uint32 i = 0; i < uint32(entries.size()); ++i)
+        {
+            entries[i].index = i;
+            table.Add(GetTableKey(0), &entries[i]);
+        }
+        for (uint32 i = 0; i < uint32(entries.size()); ++i)
+        {
+            TEST_VERIFY(table.Find(GetTableKey(0), IsEntry{ i }) == &entries[i]);
+        }
+        TEST_VERIFY(table.Find(GetTableKey(0), IsEntry{ uint32(entries.size()) }) == nullptr);
+        TEST_VERIFY(table.Find(GetTableKey(1), IsEntry{ 0 }) == nullptr);
+    }
+
+    DAVA_TEST (TableGrowsWhileRead)
+    {
+        using namespace DAVA;
+        using namespace ShaderDescriptorCacheTestDetails;
+
+        Vector<TableEntry> entries(TABLE_ENTRIES_COUNT + 1);
+        for (uint32 i = 0; i < uint32(entries.size()); ++i)
+        {
+            entries[i].index = i;
+        }
+        LockFreeLookupTable<TableEntry> table(8);
+
+        // readers look up entries, which are already published, while writer adds next ones and table grows many times
+        Atomic<uint32> publishedCount(0);
+        Atomic<uint32> readsCount(0);
+        Atomic<uint32> mismatchCount(0);
+        Atomic<uint32> readersDone(0);
+        Vector<ScopedPtr<Thread>> readers;
+        for (uint32 t = 0; t < LOADER_THREADS_COUNT; ++t)
+        {
+            readers.emplace_back(Thread::Create([&table, &entries, &publishedCount, &readsCount, &mismatchCount, &readersDone, t]() {
+                uint32 mismatch = 0;
+                uint32 index = t;
+                uint32 published = 0;
+                while (published < TABLE_ENTRIES_COUNT)
+                {
+                    published = publishedCount.Get();
+                    if (published > 0)
+                    {
+                        index = (index * 1103515245 + 12345) % published;
+                        if (table.Find(GetTableKey(index), IsEntry{ index }) != &entries[index])
+                            ++mismatch;
+                        readsCount.Increment();
+                    }
+                }
+                while (mismatch-- > 0)
+                    mismatchCount.Increment();
+                readersDone.Increment();
+            }));
+        }
+
+        for (ScopedPtr<Thread>& reader : readers)
+        {
+            reader->Start();
+        }
+        for (uint32 i = 0; i < TABLE_ENTRIES_COUNT; ++i)
+        {
+            table.Add(GetTableKey(i), &entries[i]);
+            publishedCount.Set(i + 1);
+
+            // readers get time to read between batches even if threads don't run simultaneously
+            if ((i + 1) % TABLE_ENTRIES_BATCH == 0)
+            {
+                uint32 reads = readsCount.Get() + LOADER_THREADS_COUNT;
+                while (readsCount.Get() < reads)
+                {
+                    Thread::Yield();
+                }
+            }
+        }
+        for (ScopedPtr<Thread>& reader : readers)
+        {
+            reader->Join();
+        }
+
+        TEST_VERIFY(readersDone.Get() == LOADER_THREADS_COUNT);
+        TEST_VERIFY(mismatchCount.Get() == 0);
+        TEST_VERIFY(table.GetCount() == TABLE_ENTRIES_COUNT);
+        TEST_VERIFY(table.GetCapacity() >= 2 * TABLE_ENTRIES_COUNT);
+
+        bool allFound = true;
+        for (uint32 i = 0; i < TABLE_ENTRIES_COUNT; ++i)
+        {
+            allFound &= (table.Find(GetTableKey(i), IsEntry{ i }) == &entries[i]);
+        }
+        TEST_VERIFY(allFound);
+        TEST_VERIFY(table.Find(GetTableKey(TABLE_ENTRIES_COUNT), IsEntry{ TABLE_ENTRIES_COUNT }) == nullptr);
+    }
+};
@@ -56,6 +56,7 @@ public:
 private:
     friend class AnimationSystem;
     friend class TransformSystem;
+    friend class TransformStorage;
     AnimationData* animation;
     float32 time;
     float32 animationTimeScale;
@@ -58,6 +58,10 @@ protected:
     SimpleMotion* simpleMotion = nullptr;
     uint32 simpleMotionRepeatsCount = 0;
 
+    //time and count of frames skipped by update throttle of MotionSystem
+    float32 skippedUpdateTime = 0.f;
+    uint32 skippedUpdatesCount = 0;
+
     DAVA_VIRTUAL_REFLECTION(MotionComponent, Component);
 
     friend class MotionSystem;
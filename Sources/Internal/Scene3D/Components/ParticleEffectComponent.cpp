@@ -151,13 +151,7 @@ void ParticleEffectComponent::StopWhenEmpty(bool value /*= true*/)
 
 void ParticleEffectComponent::ClearGroup(ParticleGroup& group)
 {
-    Particle* current = group.head;
-    while (current)
-    {
-        Particle* next = current->next;
-        delete current;
-        current = next;
-    }
+    group.particles.Clear();
     group.layer->Release();
     group.emitter->Release();
 }
@@ -522,11 +516,9 @@ float32 ParticleEffectComponent::GetLayerActiveParticlesSquare(ParticleLayer* la
     {
         if (it->layer == layer)
         {
-            Particle* currParticle = it->head;
-            while (currParticle)
+            for (const Vector2& size : it->particles.currSize)
             {
-                square += currParticle->currSize.x * currParticle->currSize.y;
-                currParticle = currParticle->next;
+                square += size.x * size.y;
             }
         }
     }
@@ -50,8 +50,10 @@ private:
     Matrix4 worldMatrix = Matrix4::IDENTITY;
     Transform* parentTransform = nullptr;
     Entity* parent = nullptr; //Entity::parent should be removed
+    uint32 storageIndex = static_cast<uint32>(-1); //index of entry in TransformStorage of the scene
 
     friend class TransformSystem;
+    friend class TransformStorage;
     friend class FTransformComponent;
 
     DAVA_VIRTUAL_REFLECTION(TransformComponent, Component);
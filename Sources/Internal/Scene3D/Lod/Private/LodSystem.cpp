@@ -1,5 +1,6 @@
 #include "Scene3D/Lod/LodSystem.h"
 #include "Debug/DVAssert.h"
+#include "Entity/ComponentUtils.h"
 #include "Scene3D/Entity.h"
 #include "Scene3D/Components/RenderComponent.h"
 #include "Scene3D/Components/TransformComponent.h"
@@ -17,6 +18,9 @@ namespace DAVA
 LodSystem::LodSystem(Scene* scene)
     : SceneSystem(scene)
 {
+    // lod index is set to render objects and particle effects
+    SetComponentsAccess(ComponentUtils::MakeMask<TransformComponent>(), ComponentUtils::MakeMask<LodComponent, RenderComponent, ParticleEffectComponent>());
+
     scene->GetEventSystem()->RegisterSystemForEvent(this, EventSystem::START_PARTICLE_EFFECT);
     scene->GetEventSystem()->RegisterSystemForEvent(this, EventSystem::STOP_PARTICLE_EFFECT);
     scene->GetEventSystem()->RegisterSystemForEvent(this, EventSystem::LOD_DISTANCE_CHANGED);
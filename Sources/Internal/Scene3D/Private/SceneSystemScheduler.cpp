@@ -0,0 +1,243 @@
+#include "Scene3D/SceneSystemScheduler.h"
+
+#include "Concurrency/LockGuard.h"
+#include "Concurrency/UniqueLock.h"
+#include "Engine/Engine.h"
+#include "Entity/SceneSystem.h"
+#include "Job/JobManager.h"
+#include "Time/SystemTimer.h"
+
+namespace DAVA
+{
+void SceneSystemScheduler::Process(const Vector<SceneSystem*>& systems, const Function<void(SceneSystem*)>& processFn_)
+{
+    if (!IsGraphActual(systems))
+    {
+        BuildGraph(systems);
+    }
+
+    int64 startTime = SystemTimer::GetUs();
+
+    processFn = &processFn_;
+    jobManager = GetEngineContext()->jobManager;
+    if (parallelProcessingEnabled && nullptr != jobManager && jobManager->GetWorkersCount() > 0 && nodes.size() > 1)
+    {
+        ProcessParallel();
+    }
+    else
+    {
+        ProcessSerial();
+    }
+    processFn = nullptr;
+
+    UpdateStatistics(SystemTimer::GetUs() - startTime);
+}
+
+bool SceneSystemScheduler::IsConflicting(const SceneSystem* a, const SceneSystem* b)
+{
+    if (!a->HasComponentsAccess() || !b->HasComponentsAccess())
+    {
+        return true;
+    }
+
+    const ComponentMask& writeA = a->GetWriteComponents();
+    const ComponentMask& writeB = b->GetWriteComponents();
+    return (writeA & (b->GetReadComponents() | writeB)).any() || (writeB & a->GetReadComponents()).any();
+}
+
+bool SceneSystemScheduler::IsGraphActual(const Vector<SceneSystem*>& systems) const
+{
+    if (systems.size() != nodes.size())
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < systems.size(); ++i)
+    {
+        if (systems[i] != nodes[i].system)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void SceneSystemScheduler::BuildGraph(const Vector<SceneSystem*>& systems)
+{
+    uint32 count = static_cast<uint32>(systems.size());
+
+    nodes.clear();
+    nodes.resize(count);
+    unfinishedDependencies.reset(new Atomic<uint32>[count]);
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        Node& node = nodes[i];
+        node.system = systems[i];
+        node.mainThreadRequired = !node.system->HasComponentsAccess() || node.system->IsMainThreadRequired();
+
+        for (uint32 j = 0; j < i; ++j)
+        {
+            if (IsConflicting(nodes[j].system, node.system))
+            {
+                node.dependencies.push_back(j);
+                nodes[j].dependents.push_back(i);
+            }
+        }
+    }
+}
+
+void SceneSystemScheduler::ProcessSerial()
+{
+    // systems order is a valid topological order of the graph
+    for (Node& node : nodes)
+    {
+        node.startTime = SystemTimer::GetUs();
+        (*processFn)(node.system);
+        node.endTime = SystemTimer::GetUs();
+    }
+}
+
+void SceneSystemScheduler::ProcessParallel()
+{
+    uint32 count = static_cast<uint32>(nodes.size());
+    for (uint32 i = 0; i < count; ++i)
+    {
+        unfinishedDependencies[i] = static_cast<uint32>(nodes[i].dependencies.size());
+    }
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        if (nodes[i].dependencies.empty())
+        {
+            ScheduleNode(i);
+        }
+    }
+
+    // Main thread processes its systems as soon as they are ready, while workers process theirs, and sleeps otherwise.
+    // Worker node schedules its dependents before it's counted as finished, so when no worker node is running
+    // and no system is queued for main thread, all systems are processed: the first unprocessed system
+    // would have all its dependencies processed and would be scheduled.
+    while (true)
+    {
+        uint32 index = 0;
+        {
+            UniqueLock<Mutex> lock(mainThreadQueueMutex);
+            while (mainThreadQueue.empty() && runningWorkerNodes > 0)
+            {
+                mainThreadQueueCondition.Wait(lock);
+            }
+
+            if (mainThreadQueue.empty())
+            {
+                break;
+            }
+
+            index = mainThreadQueue.back();
+            mainThreadQueue.pop_back();
+        }
+
+        ProcessNode(index);
+    }
+
+    // finished worker jobs may be still returning from notification
+    jobManager->WaitWorkerJobs(&jobGroup);
+}
+
+void SceneSystemScheduler::ProcessNode(uint32 index)
+{
+    Node& node = nodes[index];
+    node.startTime = SystemTimer::GetUs();
+    (*processFn)(node.system);
+    node.endTime = SystemTimer::GetUs();
+
+    for (uint32 dependent : node.dependents)
+    {
+        if (unfinishedDependencies[dependent].Decrement() == 0)
+        {
+            ScheduleNode(dependent);
+        }
+    }
+}
+
+void SceneSystemScheduler::ScheduleNode(uint32 index)
+{
+    if (nodes[index].mainThreadRequired)
+    {
+        {
+            LockGuard<Mutex> lock(mainThreadQueueMutex);
+            mainThreadQueue.push_back(index);
+        }
+        mainThreadQueueCondition.NotifyOne();
+    }
+    else
+    {
+        {
+            LockGuard<Mutex> lock(mainThreadQueueMutex);
+            ++runningWorkerNodes;
+        }
+
+        auto processOnWorker = [this, index]() {
+            ProcessNode(index);
+
+            bool lastWorkerNode = false;
+            {
+                LockGuard<Mutex> lock(mainThreadQueueMutex);
+                lastWorkerNode = (--runningWorkerNodes == 0);
+            }
+            if (lastWorkerNode)
+            {
+                mainThreadQueueCondition.NotifyOne();
+            }
+        };
+        jobManager->CreateWorkerJob(processOnWorker, &jobGroup);
+    }
+}
+
+void SceneSystemScheduler::UpdateStatistics(int64 processTime)
+{
+    lastFrameStatistics.processTime = processTime;
+    lastFrameStatistics.systemsTime = 0;
+    lastFrameStatistics.criticalPathTime = 0;
+    lastFrameStatistics.criticalPath.clear();
+
+    // Longest chain of dependent systems: `pathTime[i]` is time of the longest chain ending with system `i`,
+    // dependencies always precede system in `nodes`, so one pass is enough
+    uint32 count = static_cast<uint32>(nodes.size());
+    Vector<int64> pathTime(count, 0);
+    Vector<uint32> pathPrevious(count, count);
+    uint32 pathEnd = count;
+    for (uint32 i = 0; i < count; ++i)
+    {
+        const Node& node = nodes[i];
+        int64 time = node.endTime - node.startTime;
+        lastFrameStatistics.systemsTime += time;
+
+        for (uint32 dependency : node.dependencies)
+        {
+            if (pathTime[dependency] > pathTime[i])
+            {
+                pathTime[i] = pathTime[dependency];
+                pathPrevious[i] = dependency;
+            }
+        }
+        pathTime[i] += time;
+
+        if (pathEnd == count || pathTime[i] > pathTime[pathEnd])
+        {
+            pathEnd = i;
+        }
+    }
+
+    for (uint32 i = pathEnd; i != count; i = pathPrevious[i])
+    {
+        lastFrameStatistics.criticalPath.emplace_back(nodes[i].system, nodes[i].endTime - nodes[i].startTime);
+    }
+    std::reverse(lastFrameStatistics.criticalPath.begin(), lastFrameStatistics.criticalPath.end());
+
+    if (pathEnd != count)
+    {
+        lastFrameStatistics.criticalPathTime = pathTime[pathEnd];
+    }
+}
+}
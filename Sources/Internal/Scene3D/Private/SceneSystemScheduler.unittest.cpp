@@ -0,0 +1,257 @@
+#include "UnitTests/UnitTests.h"
+
+#include "Base/ScopedPtr.h"
+#include "Concurrency/Atomic.h"
+#include "Concurrency/Thread.h"
+#include "Engine/Engine.h"
+#include "Entity/ComponentUtils.h"
+#include "Entity/SceneSystem.h"
+#include "Job/JobManager.h"
+#include "Logger/Logger.h"
+#include "Scene3D/Components/SoundComponent.h"
+#include "Scene3D/Components/TransformComponent.h"
+#include "Scene3D/Components/WaveComponent.h"
+#include "Scene3D/Components/WindComponent.h"
+#include "Scene3D/Scene.h"
+#include "Scene3D/SceneSystemScheduler.h"
+#include "Time/SystemTimer.h"
+
+namespace SceneSystemSchedulerTestDetails
+{
+using namespace DAVA;
+
+const uint32 BENCHMARK_SYSTEMS_COUNT = 8;
+const uint32 BENCHMARK_FRAMES_COUNT = 20;
+const int64 BENCHMARK_SYSTEM_TIME = 500; // us
+const int64 LONG_SYSTEM_TIME = 50000; // us
+
+class TestSystem : public SceneSystem
+{
+public:
+    TestSystem(Scene* scene, int64 processTime_ = 0)
+        : SceneSystem(scene)
+        , processTime(processTime_)
+    {
+    }
+
+    void PrepareForRemove() override
+    {
+    }
+
+    void Process(float32 timeElapsed) override
+    {
+        startIndex = sequence->Increment();
+        processedOnMainThread = Thread::IsMainThread();
+
+        int64 endTime = SystemTimer::GetUs() + processTime;
+        while (SystemTimer::GetUs() < endTime)
+        {
+        }
+
+        finishIndex = sequence->Increment();
+    }
+
+    Atomic<uint32>* sequence = nullptr;
+    int64 processTime = 0;
+    uint32 startIndex = 0;
+    uint32 finishIndex = 0;
+    bool processedOnMainThread = false;
+};
+
+// Wind and wave systems are independent, speed tree reads both of them, sound requires main thread
+Vector<TestSystem*> CreateSystems(Scene* scene, Atomic<uint32>* sequence, int64 processTime)
+{
+    Vector<TestSystem*> systems;
+    for (uint32 i = 0; i < 5; ++i)
+    {
+        systems.push_back(new TestSystem(scene, processTime));
+        systems.back()->sequence = sequence;
+    }
+
+    systems[0]->SetComponentsAccess(ComponentMask(), ComponentUtils::MakeMask<WindComponent>());
+    systems[1]->SetComponentsAccess(ComponentMask(), ComponentUtils::MakeMask<WaveComponent>());
+    systems[2]->SetComponentsAccess(ComponentUtils::MakeMask<TransformComponent>(), ComponentUtils::MakeMask<SoundComponent>(), true);
+    systems[3]->SetComponentsAccess(ComponentUtils::MakeMask<WindComponent, WaveComponent>(), ComponentUtils::MakeMask<TransformComponent>());
+    // systems[4] doesn't declare access
+
+    return systems;
+}
+
+void ProcessSystems(SceneSystemScheduler& scheduler, const Vector<TestSystem*>& testSystems)
+{
+    Vector<SceneSystem*> systems(testSystems.begin(), testSystems.end());
+    scheduler.Process(systems, [](SceneSystem* system) { system->Process(0.016f); });
+}
+}
+
+DAVA_TESTCLASS (SceneSystemSchedulerTest)
+{
+    BEGIN_FILES_COVERED_BY_TESTS()
+    FIND_FILES_IN_TARGET(DavaFramework)
+    DECLARE_COVERED_FILES("SceneSystemScheduler.cpp")
+    END_FILES_COVERED_BY_TESTS();
+
+    DAVA_TEST (DependenciesFollowComponentsAccess)
+    {
+        using namespace DAVA;
+        using namespace SceneSystemSchedulerTestDetails;
+
+        ScopedPtr<Scene> scene(new Scene(0));
+        Atomic<uint32> sequence;
+        Vector<TestSystem*> systems = CreateSystems(scene, &sequence, 0);
+
+        SceneSystemScheduler scheduler;
+        ProcessSystems(scheduler, systems);
+
+        TEST_VERIFY(!SceneSystemScheduler::IsConflicting(systems[0], systems[1]));
+        TEST_VERIFY(!SceneSystemScheduler::IsConflicting(systems[1], systems[2]));
+        TEST_VERIFY(SceneSystemScheduler::IsConflicting(systems[0], systems[3]));
+        TEST_VERIFY(SceneSystemScheduler::IsConflicting(systems[2], systems[3]));
+        TEST_VERIFY(SceneSystemScheduler::IsConflicting(systems[0], systems[4]));
+
+        TEST_VERIFY(scheduler.GetDependencies(0).empty());
+        TEST_VERIFY(scheduler.GetDependencies(1).empty());
+        TEST_VERIFY(scheduler.GetDependencies(2).empty());
+        TEST_VERIFY((scheduler.GetDependencies(3) == Vector<uint32>{ 0, 1, 2 }));
+        TEST_VERIFY((scheduler.GetDependencies(4) == Vector<uint32>{ 0, 1, 2, 3 }));
+
+        for (TestSystem* system : systems)
+        {
+            delete system;
+        }
+    }
+
+    DAVA_TEST (ParallelProcessingKeepsDependencies)
+    {
+        using namespace DAVA;
+        using namespace SceneSystemSchedulerTestDetails;
+
+        ScopedPtr<Scene> scene(new Scene(0));
+        Atomic<uint32> sequence;
+        Vector<TestSystem*> systems = CreateSystems(scene, &sequence, 100);
+
+        for (bool parallelProcessing : { false, true })
+        {
+            SceneSystemScheduler scheduler;
+            scheduler.SetParallelProcessingEnabled(parallelProcessing);
+            ProcessSystems(scheduler, systems);
+
+            for (uint32 i = 0; i < systems.size(); ++i)
+            {
+                for (uint32 dependency : scheduler.GetDependencies(i))
+                {
+                    TEST_VERIFY(systems[dependency]->finishIndex < systems[i]->startIndex);
+                }
+            }
+
+            // systems without declared access and systems which require main thread are processed on the calling thread
+            TEST_VERIFY(systems[2]->processedOnMainThread);
+            TEST_VERIFY(systems[4]->processedOnMainThread);
+
+            const SceneSystemScheduler::FrameStatistics& statistics = scheduler.GetLastFrameStatistics();
+            TEST_VERIFY(!statistics.criticalPath.empty());
+            TEST_VERIFY(statistics.criticalPath.back().first == systems[4]);
+            TEST_VERIFY(statistics.criticalPathTime <= statistics.systemsTime);
+        }
+
+        for (TestSystem* system : systems)
+        {
+            delete system;
+        }
+    }
+
+    DAVA_TEST (MainThreadSystemDoesntWaitUnrelatedWorkers)
+    {
+        using namespace DAVA;
+        using namespace SceneSystemSchedulerTestDetails;
+
+        // two workers are needed to process both worker systems at the same time
+        if (GetEngineContext()->jobManager->GetWorkersCount() < 2)
+        {
+            return;
+        }
+
+        ScopedPtr<Scene> scene(new Scene(0));
+        Atomic<uint32> sequence;
+
+        // main thread system depends on the short worker system only, so it's processed while the long one is processed
+        Vector<TestSystem*> systems = { new TestSystem(scene, 0), new TestSystem(scene, LONG_SYSTEM_TIME), new TestSystem(scene, 0) };
+        systems[0]->SetComponentsAccess(ComponentMask(), ComponentUtils::MakeMask<WindComponent>());
+        systems[1]->SetComponentsAccess(ComponentMask(), ComponentUtils::MakeMask<WaveComponent>());
+        systems[2]->SetComponentsAccess(ComponentUtils::MakeMask<WindComponent>(), ComponentUtils::MakeMask<SoundComponent>(), true);
+        for (TestSystem* system : systems)
+        {
+            system->sequence = &sequence;
+        }
+
+        SceneSystemScheduler scheduler;
+        ProcessSystems(scheduler, systems);
+
+        TEST_VERIFY((scheduler.GetDependencies(2) == Vector<uint32>{ 0 }));
+        TEST_VERIFY(systems[2]->processedOnMainThread);
+        TEST_VERIFY(systems[0]->finishIndex < systems[2]->startIndex);
+        TEST_VERIFY(systems[2]->finishIndex < systems[1]->finishIndex);
+
+        for (TestSystem* system : systems)
+        {
+            delete system;
+        }
+    }
+
+    DAVA_TEST (SceneUpdateUsesScheduler)
+    {
+        using namespace DAVA;
+
+        ScopedPtr<Scene> scene(new Scene());
+        scene->Update(0.016f);
+
+        const SceneSystemScheduler::FrameStatistics& statistics = scene->GetSystemScheduler()->GetLastFrameStatistics();
+        TEST_VERIFY(!statistics.criticalPath.empty());
+        TEST_VERIFY(statistics.criticalPathTime <= statistics.systemsTime);
+    }
+
+    DAVA_TEST (ProcessBenchmark)
+    {
+        using namespace DAVA;
+        using namespace SceneSystemSchedulerTestDetails;
+
+        ScopedPtr<Scene> scene(new Scene(0));
+        Atomic<uint32> sequence;
+
+        // each system writes one of four components, so there are four independent chains of systems
+        Vector<TestSystem*> systems;
+        Vector<const Type*> componentTypes = { Type::Instance<WindComponent>(), Type::Instance<WaveComponent>(), Type::Instance<SoundComponent>(), Type::Instance<TransformComponent>() };
+        for (uint32 i = 0; i < BENCHMARK_SYSTEMS_COUNT; ++i)
+        {
+            ComponentMask writeMask;
+            writeMask.set(ComponentUtils::GetRuntimeId(componentTypes[i % componentTypes.size()]));
+
+            systems.push_back(new TestSystem(scene, BENCHMARK_SYSTEM_TIME));
+            systems.back()->sequence = &sequence;
+            systems.back()->SetComponentsAccess(ComponentMask(), writeMask);
+        }
+
+        for (bool parallelProcessing : { false, true })
+        {
+            SceneSystemScheduler scheduler;
+            scheduler.SetParallelProcessingEnabled(parallelProcessing);
+
+            int64 startTime = SystemTimer::GetUs();
+            for (uint32 frame = 0; frame < BENCHMARK_FRAMES_COUNT; ++frame)
+            {
+                ProcessSystems(scheduler, systems);
+            }
+            int64 frameTime = (SystemTimer::GetUs() - startTime) / BENCHMARK_FRAMES_COUNT;
+
+            const SceneSystemScheduler::FrameStatistics& statistics = scheduler.GetLastFrameStatistics();
+            Logger::Info("SceneSystemScheduler %s processing of %u systems: %lld us per frame, critical path %lld us of %lld us",
+                         parallelProcessing ? "parallel" : "serial", BENCHMARK_SYSTEMS_COUNT, frameTime,
+                         statistics.criticalPathTime, statistics.systemsTime);
+        }
+
+        for (TestSystem* system : systems)
+        {
+            delete system;
+        }
+    }
+};
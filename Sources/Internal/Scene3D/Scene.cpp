@@ -6,6 +6,7 @@
 #include "Entity/ComponentUtils.h"
 #include "FileSystem/FileSystem.h"
 #include "Render/3D/StaticMesh.h"
+#include "Render/Highlevel/CullingSystem.h"
 #include "Render/Highlevel/Landscape.h"
 #include "Render/Highlevel/Light.h"
 #include "Render/Highlevel/RenderPass.h"
@@ -38,6 +39,7 @@
 #include "Scene3D/Lod/LodComponent.h"
 #include "Scene3D/Lod/LodSystem.h"
 #include "Scene3D/SceneFileV2.h"
+#include "Scene3D/SceneSystemScheduler.h"
 #include "Scene3D/Systems/ActionUpdateSystem.h"
 #include "Scene3D/Systems/AnimationSystem.h"
 #include "Scene3D/Systems/DebugRenderSystem.h"
@@ -198,6 +200,8 @@ Scene::Scene(uint32 _systemsMask /* = SCENE_SYSTEM_ALL_MASK */)
     static uint32 idCounter = 0;
     sceneId = ++idCounter;
 
+    systemScheduler = new SceneSystemScheduler();
+
     CreateComponents();
     CreateSystems();
 
@@ -334,6 +338,11 @@ void Scene::CreateSystems()
     {
         renderUpdateSystem = new RenderUpdateSystem(this);
         AddSystem(renderUpdateSystem, ComponentUtils::MakeMask<TransformComponent>() | ComponentUtils::MakeMask<RenderComponent>(), SCENE_SYSTEM_REQUIRE_PROCESS);
+
+        // objects are clipped by render passes at draw time with RenderOptions::BATCHED_CULLING, so system isn't processed
+        cullingSystem = new CullingSystem(this);
+        AddSystem(cullingSystem, ComponentMask());
+        renderSystem->SetCullingSystem(cullingSystem);
     }
 
     if (SCENE_SYSTEM_UPDATEBLE_FLAG & systemsMask)
@@ -415,6 +424,7 @@ Scene::~Scene()
 
     transformSystem = nullptr;
     renderUpdateSystem = nullptr;
+    cullingSystem = nullptr;
     lodSystem = nullptr;
     debugRenderSystem = nullptr;
     particleEffectSystem = nullptr;
@@ -477,6 +487,7 @@ Scene::~Scene()
 
     SafeDelete(eventSystem);
     SafeDelete(renderSystem);
+    SafeDelete(systemScheduler);
 }
 
 void Scene::RegisterEntity(Entity* entity)
@@ -690,26 +701,7 @@ void Scene::Update(float32 timeElapsed)
         fixedUpdate.lastTime -= fixedUpdate.constantTime;
     }
 
-    for (SceneSystem* system : systemsToProcess)
-    {
-        if ((systemsMask & SCENE_SYSTEM_UPDATEBLE_FLAG) && system == transformSystem)
-        {
-            updatableSystem->UpdatePreTransform(timeElapsed);
-            transformSystem->Process(timeElapsed);
-            updatableSystem->UpdatePostTransform(timeElapsed);
-        }
-        else if (system == lodSystem)
-        {
-            if (Renderer::GetOptions()->IsOptionEnabled(RenderOptions::UPDATE_LODS))
-            {
-                lodSystem->Process(timeElapsed);
-            }
-        }
-        else
-        {
-            system->Process(timeElapsed);
-        }
-    }
+    systemScheduler->Process(systemsToProcess, [this, timeElapsed](SceneSystem* system) { ProcessSystem(system, timeElapsed); });
 
     if (transformSingleComponent)
     {
@@ -726,6 +718,27 @@ void Scene::Update(float32 timeElapsed)
     sceneGlobalTime += timeElapsed;
 }
 
+void Scene::ProcessSystem(SceneSystem* system, float32 timeElapsed)
+{
+    if ((systemsMask & SCENE_SYSTEM_UPDATEBLE_FLAG) && system == transformSystem)
+    {
+        updatableSystem->UpdatePreTransform(timeElapsed);
+        transformSystem->Process(timeElapsed);
+        updatableSystem->UpdatePostTransform(timeElapsed);
+    }
+    else if (system == lodSystem)
+    {
+        if (Renderer::GetOptions()->IsOptionEnabled(RenderOptions::UPDATE_LODS))
+        {
+            lodSystem->Process(timeElapsed);
+        }
+    }
+    else
+    {
+        system->Process(timeElapsed);
+    }
+}
+
 void Scene::Draw()
 {
     DAVA_PROFILER_CPU_SCOPE(ProfilerCPUMarkerName::SCENE_DRAW)
@@ -800,6 +813,11 @@ EventSystem* Scene::GetEventSystem() const
     return eventSystem;
 }
 
+SceneSystemScheduler* Scene::GetSystemScheduler() const
+{
+    return systemScheduler;
+}
+
 RenderSystem* Scene::GetRenderSystem() const
 {
     return renderSystem;
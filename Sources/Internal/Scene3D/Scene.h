@@ -30,6 +30,7 @@ class QuadTree;
 class Component;
 class RenderSystem;
 class RenderUpdateSystem;
+class CullingSystem;
 class TransformSystem;
 class DebugRenderSystem;
 class EventSystem;
@@ -57,6 +58,7 @@ class TransformSingleComponent;
 class MotionSingleComponent;
 class PhysicsSystem;
 class CollisionSingleComponent;
+class SceneSystemScheduler;
 
 class UIEvent;
 class RenderPass;
@@ -159,6 +161,7 @@ public:
 
     TransformSystem* transformSystem = nullptr;
     RenderUpdateSystem* renderUpdateSystem = nullptr;
+    CullingSystem* cullingSystem = nullptr;
     LodSystem* lodSystem = nullptr;
     DebugRenderSystem* debugRenderSystem = nullptr;
     EventSystem* eventSystem = nullptr;
@@ -227,6 +230,7 @@ public:
     void CreateSystems();
 
     EventSystem* GetEventSystem() const;
+    SceneSystemScheduler* GetSystemScheduler() const;
     RenderSystem* GetRenderSystem() const;
     AnimationSystem* GetAnimationSystem() const;
     ParticleEffectDebugDrawSystem* GetParticleEffectDebugDrawSystem() const;
@@ -263,6 +267,8 @@ protected:
 
     bool RemoveSystem(Vector<SceneSystem*>& storage, SceneSystem* system);
 
+    void ProcessSystem(SceneSystem* system, float32 timeElapsed);
+
     uint32 systemsMask;
     uint32 maxEntityIDCounter;
 
@@ -275,6 +281,8 @@ protected:
     Camera* mainCamera;
     Camera* drawCamera;
 
+    SceneSystemScheduler* systemScheduler = nullptr;
+
     struct FixedUpdate
     {
         float32 constantTime = 0.016f;
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+#include "Concurrency/Atomic.h"
+#include "Concurrency/ConditionVariable.h"
+#include "Concurrency/Mutex.h"
+#include "Debug/DVAssert.h"
+#include "Functional/Function.h"
+#include "Job/JobGroup.h"
+
+namespace DAVA
+{
+class JobManager;
+class SceneSystem;
+
+/**
+    \ingroup systems
+    \brief Processes scene systems concurrently according to components they access.
+
+    Scheduler builds dependency graph of systems: system depends on each preceding system it conflicts with,
+    i.e. one of them writes components read or written by other one (see SceneSystem::SetComponentsAccess).
+    System without declared access conflicts with all systems. So order of conflicting systems is kept,
+    and independent systems are processed at the same time on worker threads.
+    Systems without declared access and systems which require main thread are processed on the calling thread
+    as soon as their dependencies are processed, while workers keep processing other systems.
+*/
+class SceneSystemScheduler
+{
+public:
+    struct FrameStatistics
+    {
+        int64 processTime = 0; ///< Wall time of processing all systems, in microseconds.
+        int64 systemsTime = 0; ///< Sum of systems processing time, i.e. time of serial processing.
+        int64 criticalPathTime = 0; ///< Processing time of the longest chain of dependent systems.
+        Vector<std::pair<SceneSystem*, int64>> criticalPath; ///< Systems of the longest chain with their processing time.
+    };
+
+    SceneSystemScheduler() = default;
+    SceneSystemScheduler(const SceneSystemScheduler&) = delete;
+    SceneSystemScheduler& operator=(const SceneSystemScheduler&) = delete;
+
+    /** Enable processing of independent systems in worker threads. Enabled by default. */
+    void SetParallelProcessingEnabled(bool enabled);
+    bool IsParallelProcessingEnabled() const;
+
+    /**
+        Call `processFn` for each system from `systems` respecting dependencies between them.
+        Order of `systems` defines order of conflicting systems. Dependency graph is rebuilt when `systems` are changed.
+    */
+    void Process(const Vector<SceneSystem*>& systems, const Function<void(SceneSystem*)>& processFn);
+
+    /** Return statistics of the last Process call. */
+    const FrameStatistics& GetLastFrameStatistics() const;
+
+    /** Return indices of systems which system with `index` waits for. Valid until `systems` passed to Process are changed. */
+    const Vector<uint32>& GetDependencies(uint32 index) const;
+
+    /** Return true if systems `a` and `b` can't be processed at the same time. */
+    static bool IsConflicting(const SceneSystem* a, const SceneSystem* b);
+
+private:
+    struct Node
+    {
+        SceneSystem* system = nullptr;
+        Vector<uint32> dependencies;
+        Vector<uint32> dependents;
+        bool mainThreadRequired = false;
+        int64 startTime = 0;
+        int64 endTime = 0;
+    };
+
+    bool IsGraphActual(const Vector<SceneSystem*>& systems) const;
+    void BuildGraph(const Vector<SceneSystem*>& systems);
+
+    void ProcessSerial();
+    void ProcessParallel();
+    void ProcessNode(uint32 index);
+    void ScheduleNode(uint32 index);
+
+    void UpdateStatistics(int64 processTime);
+
+    Vector<Node> nodes;
+    std::unique_ptr<Atomic<uint32>[]> unfinishedDependencies;
+
+    const Function<void(SceneSystem*)>* processFn = nullptr;
+    JobManager* jobManager = nullptr;
+    JobGroup jobGroup;
+    Vector<uint32> mainThreadQueue;
+    uint32 runningWorkerNodes = 0; // scheduled to workers and not finished yet, guarded by mainThreadQueueMutex
+    Mutex mainThreadQueueMutex;
+    ConditionVariable mainThreadQueueCondition; // signaled when main thread node is queued or the last worker node is finished
+
+    FrameStatistics lastFrameStatistics;
+    bool parallelProcessingEnabled = true;
+};
+
+inline void SceneSystemScheduler::SetParallelProcessingEnabled(bool enabled)
+{
+    parallelProcessingEnabled = enabled;
+}
+
+inline bool SceneSystemScheduler::IsParallelProcessingEnabled() const
+{
+    return parallelProcessingEnabled;
+}
+
+inline const SceneSystemScheduler::FrameStatistics& SceneSystemScheduler::GetLastFrameStatistics() const
+{
+    return lastFrameStatistics;
+}
+
+inline const Vector<uint32>& SceneSystemScheduler::GetDependencies(uint32 index) const
+{
+    DVASSERT(index < nodes.size());
+    return nodes[index].dependencies;
+}
+}
@@ -1,6 +1,7 @@
 #include "SkeletonAnimation.h"
 
 #include "Animation/AnimationClip.h"
+#include "Animation/AnimationKernels.h"
 #include "Animation/AnimationTrack.h"
 
 namespace DAVA
@@ -34,6 +35,7 @@ void SkeletonAnimation::BindSkeleton(const SkeletonComponent* skeleton)
     for (SkeletonAnimationClip& clip : animationClips)
     {
         clip.boundTracks.clear();
+        clip.boundChannelCursors.clear();
 
         uint32 trackCount = clip.animationClip->GetTrackCount();
         uint32 jointCount = skeleton->GetJointsCount();
@@ -48,6 +50,7 @@ void SkeletonAnimation::BindSkeleton(const SkeletonComponent* skeleton)
             if (track != nullptr)
             {
                 clip.boundTracks.emplace_back(std::make_pair(j, track));
+                clip.boundChannelCursors.resize(clip.boundChannelCursors.size() + track->GetChannelsCount());
                 maxJointIndex = Max(maxJointIndex, j);
             }
         }
@@ -83,13 +86,31 @@ void SkeletonAnimation::EvaluatePose(float32 animationLocalTime, SkeletonPose* o
 
     SkeletonAnimationClip* clip = FindClip(animationLocalTime);
 
-    uint32 boundTrackCount = uint32(clip->boundTracks.size());
-    for (uint32 t = 0; t < boundTrackCount; ++t)
+    //find keys of all channels, then interpolate them at once
+    channelsBatch.Clear();
+    uint32 channelIndex = 0;
+    for (const auto& boundTrack : clip->boundTracks)
     {
-        uint32 jointIndex = clip->boundTracks[t].first;
-        const AnimationTrack* track = clip->boundTracks[t].second;
+        const AnimationTrack* track = boundTrack.second;
+        for (uint32 c = 0; c < track->GetChannelsCount(); ++c, ++channelIndex)
+        {
+            const AnimationChannel& channel = track->GetChannel(c);
+            channelsBatch.Add(channel, channel.FindSegment(animationLocalTime, clip->boundChannelCursors[channelIndex]));
+        }
+    }
+    channelsBatch.Interpolate();
+
+    channelIndex = 0;
+    for (const auto& boundTrack : clip->boundTracks)
+    {
+        const AnimationTrack* track = boundTrack.second;
 
-        outPose->SetTransform(jointIndex, EvaluateJointTransform(animationLocalTime, track));
+        JointTransform transform;
+        for (uint32 c = 0; c < track->GetChannelsCount(); ++c, ++channelIndex)
+        {
+            ApplyChannelValue(track->GetChannelTarget(c), channelsBatch.GetValue(channelIndex), transform);
+        }
+        outPose->SetTransform(boundTrack.first, transform);
     }
 }
 
@@ -137,41 +158,25 @@ float32 SkeletonAnimation::GetDuration() const
 
 //////////////////////////////////////////////////////////////////////////
 
-JointTransform SkeletonAnimation::EvaluateJointTransform(float32 time, const AnimationTrack* track)
+void SkeletonAnimation::ApplyChannelValue(AnimationTrack::eChannelTarget target, const float32* value, JointTransform& transform)
 {
-    static const uint32 MAX_CHANNEL_VALUE_SIZE = 4;
-    DVASSERT(MAX_CHANNEL_VALUE_SIZE >= track->GetMaxChannelValueSize());
-
-    JointTransform transform;
-    Array<float32, MAX_CHANNEL_VALUE_SIZE> workData;
-    for (uint32 c = 0; c < track->GetChannelsCount(); ++c)
+    switch (target)
     {
-        track->Evaluate(time, c, workData.data(), uint32(workData.size()));
+    case AnimationTrack::CHANNEL_TARGET_POSITION:
+        transform.SetPosition(Vector3(value));
+        break;
 
-        AnimationTrack::eChannelTarget target = track->GetChannelTarget(c);
-        switch (target)
-        {
-        case AnimationTrack::CHANNEL_TARGET_POSITION:
-            DVASSERT(track->GetChannelValueSize(c) == 3);
-            transform.SetPosition(Vector3(workData.data()));
-            break;
-
-        case AnimationTrack::CHANNEL_TARGET_ORIENTATION:
-            DVASSERT(track->GetChannelValueSize(c) == 4);
-            transform.SetOrientation(Quaternion(workData.data()));
-            break;
+    case AnimationTrack::CHANNEL_TARGET_ORIENTATION:
+        transform.SetOrientation(Quaternion(value));
+        break;
 
-        case AnimationTrack::CHANNEL_TARGET_SCALE:
-            DVASSERT(track->GetChannelValueSize(c) == 1);
-            transform.SetScale(*workData.data());
-            break;
+    case AnimationTrack::CHANNEL_TARGET_SCALE:
+        transform.SetScale(*value);
+        break;
 
-        default:
-            break;
-        }
+    default:
+        break;
     }
-
-    return transform;
 }
 
 void SkeletonAnimation::EvaluateRootPosition(SkeletonAnimationClip* clip, float32 animationLocalTime, Vector3* outPosition)
@@ -180,7 +185,7 @@ void SkeletonAnimation::EvaluateRootPosition(SkeletonAnimationClip* clip, float3
 
     if (clip->rootNodePositionChannel != std::numeric_limits<uint32>::max() && clip->rootNodeTrack != nullptr)
     {
-        clip->rootNodeTrack->Evaluate(GetClipLocalTime(clip, animationLocalTime), clip->rootNodePositionChannel, outPosition->data, uint32(Vector3::AXIS_COUNT));
+        clip->rootNodeTrack->Evaluate(GetClipLocalTime(clip, animationLocalTime), clip->rootNodePositionChannel, clip->rootNodeCursor, outPosition->data, uint32(Vector3::AXIS_COUNT));
     }
 }
 
@@ -203,4 +208,101 @@ float32 SkeletonAnimation::GetClipLocalTime(SkeletonAnimationClip* clip, float32
     return clip->clipStartTimestamp + animationLocalTime - clip->animationStartTimestamp;
 }
 
+//////////////////////////////////////////////////////////////////////////
+
+void SkeletonAnimation::ChannelsBatch::Clear()
+{
+    samples.clear();
+    keyValues.clear();
+
+    lerpValues0.clear();
+    lerpValues1.clear();
+    lerpFactors.clear();
+
+    for (uint32 i = 0; i < 4; ++i)
+    {
+        slerpValues0[i].clear();
+        slerpValues1[i].clear();
+    }
+    slerpFactors.clear();
+}
+
+void SkeletonAnimation::ChannelsBatch::Add(const AnimationChannel& channel, const AnimationChannel::Segment& segment)
+{
+    Sample sample;
+
+    uint32 dimension = channel.GetDimension();
+    if (segment.singleKey)
+    {
+        //time is out of keys range, value is taken from key as is
+        sample.index = uint32(keyValues.size());
+        keyValues.insert(keyValues.end(), segment.value0.begin(), segment.value0.begin() + dimension);
+    }
+    else
+    {
+        switch (channel.GetInterpolation())
+        {
+        case AnimationChannel::INTERPOLATION_LINEAR:
+            sample.source = SOURCE_LERP;
+            sample.index = uint32(lerpValues0.size());
+            lerpValues0.insert(lerpValues0.end(), segment.value0.begin(), segment.value0.begin() + dimension);
+            lerpValues1.insert(lerpValues1.end(), segment.value1.begin(), segment.value1.begin() + dimension);
+            lerpFactors.insert(lerpFactors.end(), dimension, segment.factor);
+            break;
+
+        case AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR:
+            DVASSERT(dimension == 4); //should be quaternion
+            sample.source = SOURCE_SLERP;
+            sample.index = uint32(slerpFactors.size());
+            for (uint32 i = 0; i < 4; ++i)
+            {
+                slerpValues0[i].push_back(segment.value0[i]);
+                slerpValues1[i].push_back(segment.value1[i]);
+            }
+            slerpFactors.push_back(segment.factor);
+            break;
+
+        default:
+            DVASSERT(false, "Bezier not supported yet");
+            sample.index = uint32(keyValues.size());
+            keyValues.insert(keyValues.end(), segment.value0.begin(), segment.value0.begin() + dimension);
+            break;
+        }
+    }
+
+    samples.push_back(sample);
+}
+
+void SkeletonAnimation::ChannelsBatch::Interpolate()
+{
+    lerpResults.resize(lerpValues0.size());
+    AnimationKernels::Lerp(lerpResults.data(), lerpValues0.data(), lerpValues1.data(), lerpFactors.data(), uint32(lerpFactors.size()));
+
+    AnimationKernels::QuaternionArrays q0 = { slerpValues0[0].data(), slerpValues0[1].data(), slerpValues0[2].data(), slerpValues0[3].data() };
+    AnimationKernels::QuaternionArrays q1 = { slerpValues1[0].data(), slerpValues1[1].data(), slerpValues1[2].data(), slerpValues1[3].data() };
+    AnimationKernels::Slerp(q0, q0, q1, slerpFactors.data(), uint32(slerpFactors.size()));
+
+    //quaternions are stored by components, so they are gathered back to samples order
+    for (Sample& sample : samples)
+    {
+        if (sample.source == SOURCE_SLERP)
+        {
+            uint32 index = sample.index;
+            sample.index = uint32(lerpResults.size());
+            for (uint32 i = 0; i < 4; ++i)
+            {
+                lerpResults.push_back(slerpValues0[i][index]);
+            }
+        }
+    }
+}
+
+const float32* SkeletonAnimation::ChannelsBatch::GetValue(uint32 sampleIndex) const
+{
+    DVASSERT(sampleIndex < samples.size());
+
+    const Sample& sample = samples[sampleIndex];
+    return (sample.source == SOURCE_KEY) ? keyValues.data() + sample.index : lerpResults.data() + sample.index;
+}
+
 } //ns
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Animation/AnimationChannel.h"
 #include "Base/BaseTypes.h"
 #include "Scene3D/Components/SkeletonComponent.h"
 
@@ -31,20 +32,57 @@ protected:
         UnorderedSet<uint32> jointsIgnoreMask;
 
         Vector<std::pair<uint32, const AnimationTrack*>> boundTracks; //[jointIndex, track]
+        Vector<AnimationChannel::Cursor> boundChannelCursors; //for each channel of each bound track, in the same order
         const AnimationTrack* rootNodeTrack = nullptr; //for root-node transform extraction
         uint32 rootNodePositionChannel = std::numeric_limits<uint32>::max();
+        AnimationChannel::Cursor rootNodeCursor;
 
         float32 duration = 0.f;
         float32 clipStartTimestamp = 0.f;
         float32 animationStartTimestamp = 0.f;
     };
 
-    static JointTransform EvaluateJointTransform(float32 time, const AnimationTrack* track);
+    //Values of channels sampled at some time. Interpolation of all values is performed at once by AnimationKernels
+    struct ChannelsBatch
+    {
+        enum eSource : uint8
+        {
+            SOURCE_KEY = 0,
+            SOURCE_LERP,
+            SOURCE_SLERP
+        };
+
+        struct Sample
+        {
+            uint32 index = 0;
+            eSource source = SOURCE_KEY;
+        };
+
+        void Clear();
+        void Add(const AnimationChannel& channel, const AnimationChannel::Segment& segment);
+        void Interpolate();
+        const float32* GetValue(uint32 sampleIndex) const;
+
+        Vector<Sample> samples;
+        Vector<float32> keyValues;
+
+        Vector<float32> lerpValues0;
+        Vector<float32> lerpValues1;
+        Vector<float32> lerpFactors;
+        Vector<float32> lerpResults;
+
+        Array<Vector<float32>, 4> slerpValues0; //x, y, z, w. Results are written here
+        Array<Vector<float32>, 4> slerpValues1;
+        Vector<float32> slerpFactors;
+    };
+
+    static void ApplyChannelValue(AnimationTrack::eChannelTarget target, const float32* value, JointTransform& transform);
     void EvaluateRootPosition(SkeletonAnimationClip* clip, float32 animationLocalTime, Vector3* outPosition);
     SkeletonAnimationClip* FindClip(float32 animationTime);
     float32 GetClipLocalTime(SkeletonAnimationClip* clip, float32 animationLocalTime);
 
     Vector<SkeletonAnimationClip> animationClips;
+    ChannelsBatch channelsBatch;
     uint32 maxJointIndex = 0;
 };
 
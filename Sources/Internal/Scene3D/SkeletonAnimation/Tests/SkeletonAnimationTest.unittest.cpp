@@ -0,0 +1,468 @@
+#include "UnitTests/UnitTests.h"
+
+#include "Animation/AnimationChannel.h"
+#include "Animation/AnimationChannelEncoder.h"
+#include "Animation/AnimationClip.h"
+#include "Animation/AnimationKernels.h"
+#include "Animation/AnimationTrack.h"
+#include "FileSystem/File.h"
+#include "FileSystem/FileSystem.h"
+#include "Logger/Logger.h"
+#include "Scene3D/Components/SkeletonComponent.h"
+#include "Scene3D/Entity.h"
+#include "Scene3D/Scene.h"
+#include "Scene3D/SkeletonAnimation/SkeletonAnimation.h"
+#include "Scene3D/SkeletonAnimation/SkeletonPose.h"
+#include "Time/SystemTimer.h"
+#include "Utils/CRC32.h"
+
+#include <random>
+
+namespace SkeletonAnimationTestDetails
+{
+using namespace DAVA;
+
+// Benchmark settings
+const uint32 SKELETONS_COUNT = 1000;
+const uint32 JOINTS_COUNT = 64;
+const uint32 FRAMES_COUNT = 30;
+const float32 FRAME_TIME = 1.0f / 30.0f;
+
+const uint32 KEYS_COUNT = 300;
+const float32 CLIP_DURATION = 10.0f;
+
+template <typename T>
+void Write(Vector<uint8>& data, const T& value)
+{
+    const uint8* bytes = reinterpret_cast<const uint8*>(&value);
+    data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+void WriteAlignedString(Vector<uint8>& data, const String& str)
+{
+    data.insert(data.end(), str.begin(), str.end());
+    data.push_back(0);
+    while (data.size() & 0x3)
+    {
+        data.push_back(0);
+    }
+}
+
+Vector<float32> CreateKeyValue(std::mt19937& random, uint32 dimension, AnimationChannel::eInterpolation interpolation)
+{
+    std::uniform_real_distribution<float32> distribution(-1.0f, 1.0f);
+    Vector<float32> value(dimension);
+    for (float32& v : value)
+    {
+        v = distribution(random);
+    }
+
+    if (interpolation == AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR)
+    {
+        Quaternion q(value.data());
+        q.Normalize();
+        value.assign(q.data, q.data + 4);
+    }
+    return value;
+}
+
+// Keys are placed with random intervals in [0, CLIP_DURATION]
+void WriteChannel(Vector<uint8>& data, std::mt19937& random, uint32 dimension, AnimationChannel::eInterpolation interpolation)
+{
+    Write(data, uint32(AnimationChannel::ANIMATION_CHANNEL_DATA_SIGNATURE));
+    Write(data, uint8(dimension));
+    Write(data, uint8(interpolation));
+    Write(data, uint16(0));
+    Write(data, KEYS_COUNT);
+
+    std::uniform_real_distribution<float32> intervals(0.5f, 1.5f);
+    Vector<float32> times(KEYS_COUNT);
+    float32 time = 0.0f;
+    for (float32& t : times)
+    {
+        t = time;
+        time += intervals(random);
+    }
+
+    for (float32 t : times)
+    {
+        Write(data, t * CLIP_DURATION / time);
+        for (float32 v : CreateKeyValue(random, dimension, interpolation))
+        {
+            Write(data, v);
+        }
+    }
+}
+
+Vector<uint8> CreateTrackData(std::mt19937& random)
+{
+    Vector<uint8> data;
+    Write(data, uint32(AnimationTrack::ANIMATION_TRACK_DATA_SIGNATURE));
+    Write(data, uint32(3));
+
+    Write(data, uint32(AnimationTrack::CHANNEL_TARGET_POSITION));
+    WriteChannel(data, random, 3, AnimationChannel::INTERPOLATION_LINEAR);
+
+    Write(data, uint32(AnimationTrack::CHANNEL_TARGET_ORIENTATION));
+    WriteChannel(data, random, 4, AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR);
+
+    Write(data, uint32(AnimationTrack::CHANNEL_TARGET_SCALE));
+    WriteChannel(data, random, 1, AnimationChannel::INTERPOLATION_LINEAR);
+
+    return data;
+}
+
+String GetJointUID(uint32 jointIndex)
+{
+    return Format("joint%u", jointIndex);
+}
+
+// Write clip in format described in 'AnimationBinaryFormat.md'
+bool WriteClip(const FilePath& path)
+{
+    std::mt19937 random(1234);
+
+    Vector<uint8> data;
+    Write(data, CLIP_DURATION);
+    Write(data, JOINTS_COUNT);
+    for (uint32 j = 0; j < JOINTS_COUNT; ++j)
+    {
+        WriteAlignedString(data, GetJointUID(j));
+        WriteAlignedString(data, GetJointUID(j));
+
+        Vector<uint8> track = CreateTrackData(random);
+        data.insert(data.end(), track.begin(), track.end());
+    }
+    Write(data, uint32(0)); //markers count
+
+    AnimationClip::FileHeader header;
+    header.signature = AnimationClip::ANIMATION_CLIP_FILE_SIGNATURE;
+    header.version = 1;
+    header.crc32 = CRC32::ForBuffer(data);
+    header.dataSize = uint32(data.size());
+
+    FileSystem::Instance()->CreateDirectory(path.GetDirectory(), true);
+    ScopedPtr<File> file(File::Create(path, File::CREATE | File::WRITE));
+    return file && file->Write(&header) == sizeof(header) && file->Write(data.data(), header.dataSize) == header.dataSize;
+}
+
+Vector<SkeletonComponent::Joint> CreateJoints()
+{
+    Vector<SkeletonComponent::Joint> joints(JOINTS_COUNT);
+    for (uint32 j = 0; j < JOINTS_COUNT; ++j)
+    {
+        joints[j].uid = FastName(GetJointUID(j));
+        joints[j].name = joints[j].uid;
+        joints[j].parentIndex = (j == 0) ? SkeletonComponent::INVALID_JOINT_INDEX : j - 1;
+    }
+    return joints;
+}
+
+// Smooth dense curves, like sampled by exporter at 30 fps
+Vector<AnimationChannelEncoder::Key> CreateSampledKeys(AnimationTrack::eChannelTarget target)
+{
+    Vector<AnimationChannelEncoder::Key> keys(KEYS_COUNT);
+    for (uint32 k = 0; k < KEYS_COUNT; ++k)
+    {
+        float32 t = k * FRAME_TIME;
+        keys[k].time = t;
+        if (target == AnimationTrack::CHANNEL_TARGET_POSITION)
+        {
+            keys[k].value = { std::sin(0.5f * t), 0.5f * std::cos(0.3f * t), 0.1f * t, 0.f };
+        }
+        else if (target == AnimationTrack::CHANNEL_TARGET_ORIENTATION)
+        {
+            Vector3 axis(std::cos(0.2f * t), std::sin(0.2f * t), 1.f);
+            axis.Normalize();
+            Quaternion q = Quaternion::MakeRotation(axis, 0.8f * t);
+            keys[k].value = { q.x, q.y, q.z, q.w };
+        }
+        else
+        {
+            keys[k].value = { 1.f + 0.2f * std::sin(0.4f * t), 0.f, 0.f, 0.f };
+        }
+    }
+    return keys;
+}
+
+bool IsEqual(const JointTransform& t0, const JointTransform& t1)
+{
+    const float32 epsilon = 1e-5f;
+    for (uint32 i = 0; i < 4; ++i)
+    {
+        if (Abs(t0.GetOrientation().data[i] - t1.GetOrientation().data[i]) > epsilon)
+            return false;
+    }
+    return (t0.GetPosition() - t1.GetPosition()).Length() < epsilon && Abs(t0.GetScale() - t1.GetScale()) < epsilon;
+}
+}
+
+DAVA_TESTCLASS (SkeletonAnimationTest)
+{
+    DAVA_TEST (CursorMatchesKeySearch)
+    {
+        using namespace DAVA;
+        using namespace SkeletonAnimationTestDetails;
+
+        std::mt19937 random(4321);
+        Vector<uint8> data = CreateTrackData(random);
+        AnimationTrack track;
+        TEST_VERIFY(track.Bind(data.data()) == data.size());
+        TEST_VERIFY(track.GetChannelsCount() == 3);
+
+        // sequential playback, seeks backward and times out of keys range
+        Vector<float32> times;
+        for (float32 time = -1.0f; time < CLIP_DURATION + 1.0f; time += FRAME_TIME)
+        {
+            times.push_back(time);
+        }
+        std::uniform_real_distribution<float32> seeks(-1.0f, CLIP_DURATION + 1.0f);
+        for (uint32 i = 0; i < 100; ++i)
+        {
+            times.push_back(seeks(random));
+        }
+
+        for (uint32 c = 0; c < track.GetChannelsCount(); ++c)
+        {
+            AnimationChannel::Cursor cursor;
+            bool equal = true;
+            for (float32 time : times)
+            {
+                float32 expected[4] = {};
+                float32 value[4] = {};
+                track.Evaluate(time, c, expected, 4);
+                track.Evaluate(time, c, cursor, value, 4);
+                equal &= (Memcmp(expected, value, sizeof(float32) * track.GetChannelValueSize(c)) == 0);
+            }
+            TEST_VERIFY(equal);
+        }
+    }
+
+    DAVA_TEST (KernelsMatchScalarCode)
+    {
+        using namespace DAVA;
+        using namespace SkeletonAnimationTestDetails;
+
+        const uint32 count = 1023; // not multiple of SIMD width, so scalar tail is covered too
+        std::mt19937 random(1234);
+        std::uniform_real_distribution<float32> factors(0.0f, 1.0f);
+
+        Array<Vector<float32>, 4> q0;
+        Array<Vector<float32>, 4> q1;
+        Vector<float32> t(count);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            Vector<float32> value0 = CreateKeyValue(random, 4, AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR);
+            Vector<float32> value1 = (i % 8 == 0) ? value0 : CreateKeyValue(random, 4, AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR);
+            for (uint32 k = 0; k < 4; ++k)
+            {
+                q0[k].push_back(value0[k]);
+                q1[k].push_back(value1[k]);
+            }
+            t[i] = factors(random);
+        }
+
+        Vector<float32> lerpResult(count);
+        AnimationKernels::Lerp(lerpResult.data(), q0[0].data(), q1[0].data(), t.data(), count);
+
+        Array<Vector<float32>, 4> slerpResult = { Vector<float32>(count), Vector<float32>(count), Vector<float32>(count), Vector<float32>(count) };
+        AnimationKernels::QuaternionArrays result = { slerpResult[0].data(), slerpResult[1].data(), slerpResult[2].data(), slerpResult[3].data() };
+        AnimationKernels::QuaternionArrays from = { q0[0].data(), q0[1].data(), q0[2].data(), q0[3].data() };
+        AnimationKernels::QuaternionArrays to = { q1[0].data(), q1[1].data(), q1[2].data(), q1[3].data() };
+        AnimationKernels::Slerp(result, from, to, t.data(), count);
+
+        bool lerpEqual = true;
+        bool slerpEqual = true;
+        for (uint32 i = 0; i < count; ++i)
+        {
+            lerpEqual &= (lerpResult[i] == Lerp(q0[0][i], q1[0][i], t[i]));
+
+            Quaternion q(q1[0][i], q1[1][i], q1[2][i], q1[3][i]);
+            q.Slerp(Quaternion(q0[0][i], q0[1][i], q0[2][i], q0[3][i]), q, t[i]);
+            q.Normalize();
+            slerpEqual &= (q == Quaternion(slerpResult[0][i], slerpResult[1][i], slerpResult[2][i], slerpResult[3][i]));
+        }
+        TEST_VERIFY(lerpEqual);
+        TEST_VERIFY(slerpEqual);
+    }
+
+    DAVA_TEST (CompressedChannelsMatchSource)
+    {
+        using namespace DAVA;
+        using namespace SkeletonAnimationTestDetails;
+
+        struct ChannelSettings
+        {
+            AnimationTrack::eChannelTarget target;
+            uint32 dimension;
+            AnimationChannel::eInterpolation interpolation;
+            AnimationChannel::eCompression compression;
+            float32 maxError;
+        };
+        const ChannelSettings settings[] = {
+            { AnimationTrack::CHANNEL_TARGET_POSITION, 3, AnimationChannel::INTERPOLATION_LINEAR, AnimationChannel::COMPRESSION_QUANTIZED, 0.0005f },
+            { AnimationTrack::CHANNEL_TARGET_ORIENTATION, 4, AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR, AnimationChannel::COMPRESSION_SMALLEST_THREE, 0.001f },
+            { AnimationTrack::CHANNEL_TARGET_SCALE, 1, AnimationChannel::INTERPOLATION_LINEAR, AnimationChannel::COMPRESSION_QUANTIZED, 0.0005f },
+        };
+
+        uint32 sourceDataSize = 0;
+        uint32 encodedDataSize = 0;
+        for (const ChannelSettings& s : settings)
+        {
+            Vector<AnimationChannelEncoder::Key> keys = CreateSampledKeys(s.target);
+            Vector<uint8> data;
+            AnimationChannelEncoder::Report report = AnimationChannelEncoder::Encode(keys, s.dimension, s.interpolation, s.compression, s.maxError, data);
+
+            AnimationChannel channel;
+            TEST_VERIFY(channel.Bind(data.data()) == data.size());
+            TEST_VERIFY(channel.GetCompression() == s.compression);
+            TEST_VERIFY(report.compression == s.compression);
+            TEST_VERIFY(channel.GetKeysCount() == report.encodedKeysCount);
+            TEST_VERIFY(report.encodedKeysCount < report.sourceKeysCount);
+
+            // error of reduction and quantization together stays within tolerance
+            float32 maxError = 0.f;
+            AnimationChannel::Cursor cursor;
+            for (const AnimationChannelEncoder::Key& key : keys)
+            {
+                float32 value[AnimationChannel::MAX_DIMENSION] = {};
+                channel.Evaluate(key.time, cursor, value, AnimationChannel::MAX_DIMENSION);
+                maxError = Max(maxError, AnimationChannelEncoder::GetError(value, key.value.data(), s.dimension, s.interpolation));
+            }
+            TEST_VERIFY(maxError <= s.maxError);
+            TEST_VERIFY(Abs(maxError - report.maxError) < 1e-6f);
+
+            Logger::Info("Animation channel %u: %u keys reduced to %u, %u bytes compressed to %u bytes, max error %f",
+                         uint32(s.target), report.sourceKeysCount, report.encodedKeysCount, report.sourceDataSize, report.encodedDataSize, report.maxError);
+
+            sourceDataSize += report.sourceDataSize;
+            encodedDataSize += report.encodedDataSize;
+        }
+        TEST_VERIFY(sourceDataSize >= 3 * encodedDataSize);
+
+        // constant channel is stored as single key
+        Vector<AnimationChannelEncoder::Key> keys = CreateSampledKeys(AnimationTrack::CHANNEL_TARGET_SCALE);
+        for (AnimationChannelEncoder::Key& key : keys)
+        {
+            key.value[0] = 2.f;
+        }
+        Vector<uint8> data;
+        AnimationChannelEncoder::Report report = AnimationChannelEncoder::Encode(keys, 1, AnimationChannel::INTERPOLATION_LINEAR, AnimationChannel::COMPRESSION_QUANTIZED, 0.0005f, data);
+        TEST_VERIFY(report.encodedKeysCount == 1);
+
+        AnimationChannel channel;
+        TEST_VERIFY(channel.Bind(data.data()) == data.size());
+        float32 scale = 0.f;
+        channel.Evaluate(CLIP_DURATION * 0.5f, &scale, 1);
+        TEST_VERIFY(scale == 2.f);
+
+        // range of channel is too wide to quantize values with required error, so it is written uncompressed
+        keys = CreateSampledKeys(AnimationTrack::CHANNEL_TARGET_POSITION);
+        for (AnimationChannelEncoder::Key& key : keys)
+        {
+            key.value[2] *= 10000.f;
+        }
+        data.clear();
+        report = AnimationChannelEncoder::Encode(keys, 3, AnimationChannel::INTERPOLATION_LINEAR, AnimationChannel::COMPRESSION_QUANTIZED, 0.0005f, data);
+        TEST_VERIFY(report.compression == AnimationChannel::COMPRESSION_NONE);
+        TEST_VERIFY(report.maxError <= 0.0005f);
+        TEST_VERIFY(report.encodedKeysCount < report.sourceKeysCount);
+        TEST_VERIFY(channel.Bind(data.data()) == data.size());
+        TEST_VERIFY(channel.GetCompression() == AnimationChannel::COMPRESSION_NONE);
+    }
+
+    DAVA_TEST (BatchedPoseBenchmark)
+    {
+        using namespace DAVA;
+        using namespace SkeletonAnimationTestDetails;
+
+        FilePath clipPath("~doc:/TestData/SkeletonAnimationTest/clip.anim");
+        TEST_VERIFY(WriteClip(clipPath));
+        ScopedPtr<AnimationClip> clip(AnimationClip::Load(clipPath));
+        TEST_VERIFY(clip);
+        if (!clip)
+        {
+            return;
+        }
+
+        ScopedPtr<Scene> scene(new Scene(0));
+        ScopedPtr<Entity> entity(new Entity());
+        scene->AddNode(entity);
+        SkeletonComponent* skeleton = new SkeletonComponent();
+        entity->AddComponent(skeleton);
+        skeleton->SetJoints(CreateJoints());
+
+        // all instances share one clip, each instance keeps its own cursors
+        Vector<std::unique_ptr<SkeletonAnimation>> animations(SKELETONS_COUNT);
+        for (std::unique_ptr<SkeletonAnimation>& animation : animations)
+        {
+            animation.reset(new SkeletonAnimation());
+            animation->AddAnimationClip(clip);
+            animation->BindSkeleton(skeleton);
+        }
+
+        // batched pose is compared with separate evaluation of each channel
+        bool equal = true;
+        SkeletonPose pose;
+        for (float32 time = -0.5f; time < CLIP_DURATION + 0.5f; time += 0.1f)
+        {
+            animations[0]->EvaluatePose(time, &pose);
+            for (uint32 j = 0; j < JOINTS_COUNT; ++j)
+            {
+                const AnimationTrack* track = clip->FindTrack(GetJointUID(j).c_str());
+                float32 position[3], orientation[4], scale;
+                track->Evaluate(time, 0, position, 3);
+                track->Evaluate(time, 1, orientation, 4);
+                track->Evaluate(time, 2, &scale, 1);
+
+                JointTransform expected;
+                expected.SetPosition(Vector3(position));
+                expected.SetOrientation(Quaternion(orientation));
+                expected.SetScale(scale);
+                equal &= IsEqual(pose.GetJointTransform(j), expected);
+            }
+        }
+        TEST_VERIFY(equal);
+
+        // skeletons play the same clip with different phases
+        int64 startTime = SystemTimer::GetUs();
+        for (uint32 frame = 0; frame < FRAMES_COUNT; ++frame)
+        {
+            for (uint32 i = 0; i < SKELETONS_COUNT; ++i)
+            {
+                float32 time = std::fmod(i * 0.37f + frame * FRAME_TIME, CLIP_DURATION);
+                animations[i]->EvaluatePose(time, &pose);
+            }
+        }
+        int64 batchedTime = (SystemTimer::GetUs() - startTime) / FRAMES_COUNT;
+
+        // evaluation of channels one by one, with binary search of keys
+        startTime = SystemTimer::GetUs();
+        for (uint32 frame = 0; frame < FRAMES_COUNT; ++frame)
+        {
+            for (uint32 i = 0; i < SKELETONS_COUNT; ++i)
+            {
+                float32 time = std::fmod(i * 0.37f + frame * FRAME_TIME, CLIP_DURATION);
+                for (uint32 t = 0; t < clip->GetTrackCount(); ++t)
+                {
+                    const AnimationTrack* track = clip->GetTrack(t);
+                    JointTransform transform;
+                    float32 value[4];
+                    track->Evaluate(time, 0, value, 4);
+                    transform.SetPosition(Vector3(value));
+                    track->Evaluate(time, 1, value, 4);
+                    transform.SetOrientation(Quaternion(value));
+                    track->Evaluate(time, 2, value, 4);
+                    transform.SetScale(value[0]);
+                    pose.SetTransform(t, transform);
+                }
+            }
+        }
+        int64 separateTime = (SystemTimer::GetUs() - startTime) / FRAMES_COUNT;
+
+        Logger::Info("SkeletonAnimation sampling of %u skeletons with %u joints: batched %lld us, per channel %lld us per frame",
+                     SKELETONS_COUNT, JOINTS_COUNT, batchedTime, separateTime);
+
+        FileSystem::Instance()->DeleteFile(clipPath);
+    }
+};
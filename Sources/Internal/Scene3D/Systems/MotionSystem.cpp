@@ -2,11 +2,18 @@
 
 #include "Debug/ProfilerCPU.h"
 #include "Debug/ProfilerMarkerNames.h"
+#include "Engine/Engine.h"
+#include "Engine/EngineContext.h"
+#include "Job/JobManager.h"
+#include "Render/Highlevel/Camera.h"
+#include "Render/Highlevel/Frustum.h"
+#include "Render/Highlevel/RenderObject.h"
 #include "Scene3D/Entity.h"
 #include "Scene3D/Scene.h"
 #include "Scene3D/Components/ComponentHelpers.h"
 #include "Scene3D/Components/MotionComponent.h"
 #include "Scene3D/Components/SingleComponents/MotionSingleComponent.h"
+#include "Scene3D/Lod/LodComponent.h"
 #include "Scene3D/Systems/EventSystem.h"
 #include "Scene3D/Systems/GlobalEventSystem.h"
 #include "Scene3D/SkeletonAnimation/MotionLayer.h"
@@ -14,6 +21,15 @@
 
 namespace DAVA
 {
+namespace MotionSystemDetails
+{
+const uint32 PARALLEL_MIN_COMPONENTS_COUNT = 8;
+
+const int32 HALF_RATE_LOD = 1;
+const uint32 HALF_RATE_UPDATE_INTERVAL = 2;
+const uint32 INVISIBLE_UPDATE_INTERVAL = 8;
+}
+
 MotionSystem::MotionSystem(Scene* scene)
     : SceneSystem(scene)
 {
@@ -118,20 +134,99 @@ void MotionSystem::Process(float32 timeElapsed)
 
     motionSingleComponent->Clear();
 
+    motionUpdates.clear();
     for (MotionComponent* component : activeComponents)
     {
-        UpdateMotionLayers(component, timeElapsed);
+        component->skippedUpdateTime += timeElapsed;
+        ++component->skippedUpdatesCount;
+
+        uint32 updateInterval = updateThrottleEnabled ? GetUpdateInterval(component) : 1;
+        if (component->skippedUpdatesCount >= updateInterval)
+        {
+            MotionUpdate update;
+            update.component = component;
+            update.dTime = component->skippedUpdateTime;
+            motionUpdates.push_back(update);
+
+            component->skippedUpdateTime = 0.f;
+            component->skippedUpdatesCount = 0;
+        }
+        else
+        {
+            //root offset is applied only at frames with update
+            component->rootOffsetDelta = Vector3();
+        }
+    }
+
+    uint32 updatesCount = uint32(motionUpdates.size());
+    JobManager* jobManager = GetEngineContext()->jobManager;
+    uint32 workersCount = (parallelUpdateEnabled && nullptr != jobManager) ? jobManager->GetWorkersCount() : 0;
+    if (workersCount > 0 && updatesCount >= MotionSystemDetails::PARALLEL_MIN_COMPONENTS_COUNT)
+    {
+        jobManager->ParallelFor(0, updatesCount, [this](uint32 begin, uint32 end) {
+            for (uint32 i = begin; i < end; ++i)
+            {
+                UpdateMotionLayers(motionUpdates[i]);
+            }
+        });
+    }
+    else
+    {
+        for (MotionUpdate& update : motionUpdates)
+        {
+            UpdateMotionLayers(update);
+        }
+    }
+
+    //events are collected in order of components to keep results independent of threads scheduling
+    for (const MotionUpdate& update : motionUpdates)
+    {
+        CollectMotionEvents(update);
+    }
+}
+
+uint32 MotionSystem::GetUpdateInterval(MotionComponent* motionComponent) const
+{
+    using namespace MotionSystemDetails;
+
+    Entity* entity = motionComponent->GetEntity();
+
+    RenderObject* renderObject = GetRenderObject(entity);
+    if (renderObject != nullptr)
+    {
+        if ((renderObject->GetFlags() & RenderObject::VISIBILITY_CRITERIA) != RenderObject::VISIBILITY_CRITERIA)
+            return INVISIBLE_UPDATE_INTERVAL;
+
+        Camera* camera = GetScene()->GetCurrentCamera();
+        if (camera != nullptr && !camera->GetFrustum()->IsInside(renderObject->GetWorldBoundingBox()))
+            return INVISIBLE_UPDATE_INTERVAL;
+    }
+
+    LodComponent* lodComponent = GetLodComponent(entity);
+    if (lodComponent != nullptr)
+    {
+        int32 currentLod = lodComponent->GetCurrentLod();
+        if (currentLod == LodComponent::INVALID_LOD_LAYER)
+            return INVISIBLE_UPDATE_INTERVAL;
+
+        if (currentLod >= HALF_RATE_LOD)
+            return HALF_RATE_UPDATE_INTERVAL;
     }
+
+    return 1;
 }
 
-void MotionSystem::UpdateMotionLayers(MotionComponent* motionComponent, float32 dTime)
+void MotionSystem::UpdateMotionLayers(MotionUpdate& update)
 {
+    MotionComponent* motionComponent = update.component;
     DVASSERT(motionComponent);
 
     SkeletonComponent* skeleton = GetSkeletonComponent(motionComponent->GetEntity());
     if (skeleton != nullptr && (motionComponent->GetMotionLayersCount() != 0 || (motionComponent->simpleMotion != nullptr && motionComponent->simpleMotion->IsPlaying())))
     {
-        dTime *= motionComponent->playbackRate;
+        update.layersUpdated = true;
+
+        float32 dTime = update.dTime * motionComponent->playbackRate;
         SkeletonPose resultPose = skeleton->GetDefaultPose();
 
         uint32 motionLayersCount = motionComponent->GetMotionLayersCount();
@@ -141,12 +236,6 @@ void MotionSystem::UpdateMotionLayers(MotionComponent* motionComponent, float32
 
             motionLayer->Update(dTime);
 
-            for (const auto& motionEnd : motionLayer->GetEndedMotions())
-                motionSingleComponent->animationEnd.insert(MotionSingleComponent::AnimationInfo(motionComponent, motionLayer->GetName(), motionEnd));
-
-            for (const auto& motionMarker : motionLayer->GetReachedMarkers())
-                motionSingleComponent->animationMarkerReached.insert(MotionSingleComponent::AnimationInfo(motionComponent, motionLayer->GetName(), motionMarker.first, motionMarker.second));
-
             const SkeletonPose& pose = motionLayer->GetCurrentSkeletonPose();
             MotionLayer::eMotionBlend blendMode = motionLayer->GetBlendMode();
             switch (blendMode)
@@ -170,8 +259,7 @@ void MotionSystem::UpdateMotionLayers(MotionComponent* motionComponent, float32
         if (simpleMotion != nullptr && simpleMotion->IsPlaying())
         {
             simpleMotion->Update(dTime);
-            if (!simpleMotion->IsPlaying())
-                motionSingleComponent->simpleMotionFinished.emplace_back(motionComponent);
+            update.simpleMotionFinished = !simpleMotion->IsPlaying();
 
             simpleMotion->EvaluatePose(&resultPose);
         }
@@ -179,4 +267,27 @@ void MotionSystem::UpdateMotionLayers(MotionComponent* motionComponent, float32
         skeleton->ApplyPose(resultPose);
     }
 }
+
+void MotionSystem::CollectMotionEvents(const MotionUpdate& update)
+{
+    if (!update.layersUpdated)
+        return;
+
+    MotionComponent* motionComponent = update.component;
+
+    uint32 motionLayersCount = motionComponent->GetMotionLayersCount();
+    for (uint32 l = 0; l < motionLayersCount; ++l)
+    {
+        MotionLayer* motionLayer = motionComponent->GetMotionLayer(l);
+
+        for (const auto& motionEnd : motionLayer->GetEndedMotions())
+            motionSingleComponent->animationEnd.insert(MotionSingleComponent::AnimationInfo(motionComponent, motionLayer->GetName(), motionEnd));
+
+        for (const auto& motionMarker : motionLayer->GetReachedMarkers())
+            motionSingleComponent->animationMarkerReached.insert(MotionSingleComponent::AnimationInfo(motionComponent, motionLayer->GetName(), motionMarker.first, motionMarker.second));
+    }
+
+    if (update.simpleMotionFinished)
+        motionSingleComponent->simpleMotionFinished.emplace_back(motionComponent);
+}
 }
\ No newline at end of file
@@ -26,14 +26,62 @@ public:
     void ImmediateEvent(Component* component, uint32 event) override;
     void Process(float32 timeElapsed) override;
 
+    /** Enable update of motions in worker threads, each motion component is updated by one thread. Enabled by default. */
+    void SetParallelUpdateEnabled(bool enabled);
+    bool IsParallelUpdateEnabled() const;
+
+    /**
+        Enable reduced update rate of skeletons, which are distant or invisible.
+        Skeletons with lod greater than zero are updated every second frame, skeletons out of camera frustum,
+        hidden or beyond the last lod are updated every eighth frame. Time of skipped frames is accumulated,
+        so motions keep their speed. Disabled by default.
+    */
+    void SetUpdateThrottleEnabled(bool enabled);
+    bool IsUpdateThrottleEnabled() const;
+
 protected:
     void SetScene(Scene* scene) override;
 
 private:
-    void UpdateMotionLayers(MotionComponent* motionComponent, float32 dTime);
+    struct MotionUpdate
+    {
+        MotionComponent* component = nullptr;
+        float32 dTime = 0.f;
+        bool layersUpdated = false;
+        bool simpleMotionFinished = false;
+    };
+
+    uint32 GetUpdateInterval(MotionComponent* motionComponent) const;
+
+    //doesn't change shared state, so different components can be updated concurrently
+    void UpdateMotionLayers(MotionUpdate& update);
+    void CollectMotionEvents(const MotionUpdate& update);
 
     Vector<MotionComponent*> activeComponents;
+    Vector<MotionUpdate> motionUpdates;
     MotionSingleComponent* motionSingleComponent = nullptr;
+    bool parallelUpdateEnabled = true;
+    bool updateThrottleEnabled = false;
 };
 
+inline void MotionSystem::SetParallelUpdateEnabled(bool enabled)
+{
+    parallelUpdateEnabled = enabled;
+}
+
+inline bool MotionSystem::IsParallelUpdateEnabled() const
+{
+    return parallelUpdateEnabled;
+}
+
+inline void MotionSystem::SetUpdateThrottleEnabled(bool enabled)
+{
+    updateThrottleEnabled = enabled;
+}
+
+inline bool MotionSystem::IsUpdateThrottleEnabled() const
+{
+    return updateThrottleEnabled;
+}
+
 } //ns
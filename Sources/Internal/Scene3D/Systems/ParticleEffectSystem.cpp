@@ -6,6 +6,7 @@
 #include "Scene3D/Components/ParticleEffectComponent.h"
 #include "Scene3D/Components/TransformComponent.h"
 #include "Particles/ParticleEmitter.h"
+#include "Particles/ParticleForceSimplified.h"
 #include "Particles/ParticlesRandom.h"
 #include "Particles/ParticleForces.h"
 #include "Particles/ParticleForce.h"
@@ -25,11 +26,16 @@
 #include "Scene3D/Systems/QualitySettingsSystem.h"
 #include "Engine/Engine.h"
 #include "Engine/EngineContext.h"
+#include "Job/JobManager.h"
 
 namespace DAVA
 {
 namespace ParticleEffectSystemDetails
 {
+// Effects are updated in worker threads only if there are enough of them, otherwise jobs cost more than update
+const uint32 PARALLEL_MIN_EFFECTS_COUNT = 16;
+const uint32 CHUNKS_PER_THREAD = 4;
+
 Matrix3 GenerateEmitterRotationMatrix(Vector3 vector, float32 power)
 {
     Vector3 axis(vector.y, -vector.x, 0);
@@ -132,6 +138,8 @@ ParticleEffectSystem::ParticleEffectSystem(Scene* scene, bool _is2DMode)
 
     particleBaseMaterial = new NMaterial();
     particleBaseMaterial->SetFXName(NMaterialName::PARTICLES);
+
+    updateContexts.resize(1);
 }
 
 ParticleEffectSystem::~ParticleEffectSystem()
@@ -203,7 +211,7 @@ void ParticleEffectSystem::PrebuildMaterials(ParticleEffectComponent* component)
     }
 }
 
-void ParticleEffectSystem::RunEmitter(ParticleEffectComponent* effect, ParticleEmitter* emitter, const Vector3& spawnPosition, int32 positionSource)
+void ParticleEffectSystem::RunEmitter(ParticleEffectComponent* effect, ParticleEmitter* emitter, const Vector3& spawnPosition, int32 positionSource, bool deferMaterials)
 {
     for (ParticleLayer* layer : emitter->layers)
     {
@@ -219,37 +227,62 @@ void ParticleEffectSystem::RunEmitter(ParticleEffectComponent* effect, ParticleE
         group.positionSource = positionSource;
         group.loopLayerStartTime = group.layer->startTime;
         group.loopDuration = group.layer->endTime;
+        group.randomSequenceOffset = effect->effectData.random.Rand();
 
-        if (layer->sprite && (layer->type != ParticleLayer::TYPE_SUPEREMITTER_PARTICLES))
-        {
-            DAVA::Texture* flowmap = layer->flowmap.get() != nullptr ? layer->flowmap->GetTexture(0) : nullptr;
-            DAVA::Texture* noise = layer->noise.get() != nullptr ? layer->noise->GetTexture(0) : nullptr;
-            DAVA::Texture* alphaRemap = layer->alphaRemapSprite.get() != nullptr ? layer->alphaRemapSprite->GetTexture(0) : nullptr;
-            ParticleEffectSystem::MaterialData matData = {};
-            matData.texture = layer->sprite->GetTexture(0);
-            matData.enableFog = layer->enableFog;
-            matData.enableFrameBlend = layer->enableFrameBlend && layer->type != ParticleLayer::TYPE_PARTICLE_STRIPE;
-            matData.flowmap = flowmap;
-            matData.enableFlowAnimation = layer->enableFlowAnimation;
-            matData.enableFlow = layer->enableFlow;
-            matData.enableNoise = layer->enableNoise;
-            matData.noise = noise;
-            matData.useFresnelToAlpha = layer->useFresnelToAlpha;
-            matData.blending = layer->blending;
-            matData.enableAlphaRemap = layer->enableAlphaRemap;
-            matData.alphaRemapTexture = alphaRemap;
-            matData.usePerspectiveMapping = layer->usePerspectiveMapping && layer->type == ParticleLayer::TYPE_PARTICLE_STRIPE;
-            matData.useThreePointGradient = layer->useThreePointGradient;
-            uintptr_t layerIdPtr = reinterpret_cast<uintptr_t>(layer);
-            matData.layerId = static_cast<uint64>(layerIdPtr);
-
-            group.material = AcquireMaterial(matData);
-        }
+        if (deferMaterials)
+            group.materialPending = true;
+        else
+            group.material = AcquireLayerMaterial(layer);
 
         effect->effectData.groups.push_back(group);
     }
 }
 
+NMaterial* ParticleEffectSystem::AcquireLayerMaterial(ParticleLayer* layer)
+{
+    if (!layer->sprite || layer->type == ParticleLayer::TYPE_SUPEREMITTER_PARTICLES)
+        return nullptr;
+
+    DAVA::Texture* flowmap = layer->flowmap.get() != nullptr ? layer->flowmap->GetTexture(0) : nullptr;
+    DAVA::Texture* noise = layer->noise.get() != nullptr ? layer->noise->GetTexture(0) : nullptr;
+    DAVA::Texture* alphaRemap = layer->alphaRemapSprite.get() != nullptr ? layer->alphaRemapSprite->GetTexture(0) : nullptr;
+    ParticleEffectSystem::MaterialData matData = {};
+    matData.texture = layer->sprite->GetTexture(0);
+    matData.enableFog = layer->enableFog;
+    matData.enableFrameBlend = layer->enableFrameBlend && layer->type != ParticleLayer::TYPE_PARTICLE_STRIPE;
+    matData.flowmap = flowmap;
+    matData.enableFlowAnimation = layer->enableFlowAnimation;
+    matData.enableFlow = layer->enableFlow;
+    matData.enableNoise = layer->enableNoise;
+    matData.noise = noise;
+    matData.useFresnelToAlpha = layer->useFresnelToAlpha;
+    matData.blending = layer->blending;
+    matData.enableAlphaRemap = layer->enableAlphaRemap;
+    matData.alphaRemapTexture = alphaRemap;
+    matData.usePerspectiveMapping = layer->usePerspectiveMapping && layer->type == ParticleLayer::TYPE_PARTICLE_STRIPE;
+    matData.useThreePointGradient = layer->useThreePointGradient;
+    uintptr_t layerIdPtr = reinterpret_cast<uintptr_t>(layer);
+    matData.layerId = static_cast<uint64>(layerIdPtr);
+
+    return AcquireMaterial(matData);
+}
+
+void ParticleEffectSystem::AcquirePendingMaterials(EffectUpdateContext& context)
+{
+    for (ParticleEffectComponent* effect : context.pendingMaterialEffects)
+    {
+        for (ParticleGroup& group : effect->effectData.groups)
+        {
+            if (group.materialPending)
+            {
+                group.material = AcquireLayerMaterial(group.layer);
+                group.materialPending = false;
+            }
+        }
+    }
+    context.pendingMaterialEffects.clear();
+}
+
 void ParticleEffectSystem::RunEffect(ParticleEffectComponent* effect)
 {
     if (QualitySettingsSystem::Instance()->IsOptionEnabled(QualitySettingsSystem::QUALITY_OPTION_DISABLE_EFFECTS))
@@ -267,6 +300,9 @@ void ParticleEffectSystem::RunEffect(ParticleEffectComponent* effect)
         effect->effectData.infoSources.resize(1);
     }
 
+    // random values of effect are taken from its own generator, so they don't depend on threads scheduling
+    effect->effectData.random.Seed(Rand());
+
     for (const auto& instance : effect->emitterInstances)
     {
         RunEmitter(effect, instance->GetEmitter(), instance->GetSpawnPosition());
@@ -405,10 +441,9 @@ void ParticleEffectSystem::Process(float32 timeElapsed)
     float32 speedMult = 1.0f + (perfSettings->GetPsPerformanceSpeedMult() - 1.0f) * (1 - currPSValue);
     float32 shortEffectTime = timeElapsed * speedMult;
 
-    size_t componentsCount = activeComponents.size();
-    for (size_t i = 0; i < componentsCount; i++)
+    updatedEffects.clear();
+    for (ParticleEffectComponent* effect : activeComponents)
     {
-        ParticleEffectComponent* effect = activeComponents[i];
         if (effect->activeLodLevel != effect->desiredLodLevel)
             UpdateActiveLod(effect);
         if (effect->state == ParticleEffectComponent::STATE_STARTING)
@@ -416,10 +451,16 @@ void ParticleEffectSystem::Process(float32 timeElapsed)
             RunEffect(effect);
         }
 
-        if (effect->isPaused)
-            continue;
-        UpdateEffect(effect, timeElapsed * effect->playbackSpeed, shortEffectTime * effect->playbackSpeed);
+        if (!effect->isPaused)
+            updatedEffects.push_back(effect);
+    }
+
+    UpdateEffects(updatedEffects, timeElapsed, shortEffectTime);
 
+    // effects are restarted and stopped after update of all of them, as it changes list of active effects
+    completedEffects.clear();
+    for (ParticleEffectComponent* effect : updatedEffects)
+    {
         bool effectEnded = effect->stopWhenEmpty ? effect->effectData.groups.empty() : (effect->time > effect->effectDuration);
         if (effectEnded)
         {
@@ -441,11 +482,8 @@ void ParticleEffectSystem::Process(float32 timeElapsed)
         {
             effect->effectData.infoSources.resize(1);
             RemoveFromActive(effect);
-            componentsCount--;
-            i--;
             effect->state = ParticleEffectComponent::STATE_STOPPED;
-            if (!effect->playbackComplete.IsEmpty())
-                effect->playbackComplete(effect->GetEntity(), 0);
+            completedEffects.push_back(effect);
         }
         else
         {
@@ -454,6 +492,54 @@ void ParticleEffectSystem::Process(float32 timeElapsed)
                 scene->GetRenderSystem()->MarkForUpdate(effect->effectRenderObject);
         }
     }
+
+    // callbacks are called at the end, as they can start or stop other effects
+    for (ParticleEffectComponent* effect : completedEffects)
+    {
+        if (!effect->playbackComplete.IsEmpty())
+            effect->playbackComplete(effect->GetEntity(), 0);
+    }
+}
+
+void ParticleEffectSystem::UpdateEffects(const Vector<ParticleEffectComponent*>& effects, float32 timeElapsed, float32 shortEffectTime)
+{
+    uint32 effectsCount = static_cast<uint32>(effects.size());
+    JobManager* jobManager = GetEngineContext()->jobManager;
+    uint32 workersCount = (parallelUpdateEnabled && nullptr != jobManager) ? jobManager->GetWorkersCount() : 0;
+    if (workersCount > 0 && effectsCount >= ParticleEffectSystemDetails::PARALLEL_MIN_EFFECTS_COUNT)
+    {
+        // Effects don't share mutable state during update, so each of them can be updated in its own thread.
+        // Each chunk of effects has its own context, contexts are processed in the order of chunks
+        // to keep results independent of threads scheduling
+        uint32 chunksCount = Min(effectsCount, (workersCount + 1) * ParticleEffectSystemDetails::CHUNKS_PER_THREAD);
+        uint32 grainSize = (effectsCount + chunksCount - 1) / chunksCount;
+        chunksCount = (effectsCount + grainSize - 1) / grainSize;
+        if (updateContexts.size() < chunksCount)
+        {
+            updateContexts.resize(chunksCount);
+        }
+
+        jobManager->ParallelFor(0, effectsCount, [this, &effects, timeElapsed, shortEffectTime, grainSize](uint32 begin, uint32 end) {
+            EffectUpdateContext& context = updateContexts[begin / grainSize];
+            for (uint32 i = begin; i < end; ++i)
+            {
+                ParticleEffectComponent* effect = effects[i];
+                UpdateEffect(effect, timeElapsed * effect->playbackSpeed, shortEffectTime * effect->playbackSpeed, context);
+            }
+        }, grainSize);
+
+        for (uint32 i = 0; i < chunksCount; ++i)
+        {
+            AcquirePendingMaterials(updateContexts[i]);
+        }
+    }
+    else
+    {
+        for (ParticleEffectComponent* effect : effects)
+        {
+            UpdateEffect(effect, timeElapsed * effect->playbackSpeed, shortEffectTime * effect->playbackSpeed);
+        }
+    }
 }
 
 void ParticleEffectSystem::UpdateActiveLod(ParticleEffectComponent* effect)
@@ -474,42 +560,30 @@ void ParticleEffectSystem::UpdateActiveLod(ParticleEffectComponent* effect)
             ParticleGroup& group = *it;
             if (group.layer->degradeStrategy == ParticleLayer::DEGRADE_REMOVE)
             {
-                Particle* current = group.head;
-                while (current)
-                {
-                    Particle* next = current->next;
-                    delete current;
-                    current = next;
-                }
-                group.head = nullptr;
+                group.particles.Clear();
+                group.activeParticleCount = 0;
             }
             else if (group.layer->degradeStrategy == ParticleLayer::DEGRADE_CUT_PARTICLES)
             {
-                Particle* current = group.head;
-                Particle* prev = nullptr;
-                int32 i = 0;
-                while (current)
+                //cut every second particle, going backwards only kept particles are moved to places of removed ones
+                for (uint32 i = group.particles.GetCount() / 2; i > 0; --i)
                 {
-                    Particle* next = current->next;
-                    if (i % 2) //cut every second particle
-                    {
-                        delete current;
-                        group.activeParticleCount--;
-                        if (prev)
-                            prev->next = next;
-                        else
-                            group.head = next;
-                    }
-                    prev = current;
-                    current = next;
-                    i++;
+                    group.particles.Remove(2 * i - 1);
                 }
+                group.activeParticleCount = static_cast<int32>(group.particles.GetCount());
             }
         }
     }
 }
 
 void ParticleEffectSystem::UpdateEffect(ParticleEffectComponent* effect, float32 deltaTime, float32 shortEffectTime)
+{
+    EffectUpdateContext& context = updateContexts[0];
+    UpdateEffect(effect, deltaTime, shortEffectTime, context);
+    AcquirePendingMaterials(context);
+}
+
+void ParticleEffectSystem::UpdateEffect(ParticleEffectComponent* effect, float32 deltaTime, float32 shortEffectTime, EffectUpdateContext& context)
 {
     effect->time += deltaTime;
     const Matrix4* worldTransformPtr;
@@ -526,12 +600,15 @@ void ParticleEffectSystem::UpdateEffect(ParticleEffectComponent* effect, float32
 
     AABBox3 bbox;
     List<ParticleGroup>::iterator it = effect->effectData.groups.begin();
-    Random* random = GetEngineContext()->random;
+    ParticlesRandom::Generator& random = effect->effectData.random;
     bool isInverseCalculated = false;
+    GroupUpdateContext& groupContext = context.group;
+    UpdateBuffers& buffers = context.buffers;
+    groupContext.world = worldTransformPtr;
     while (it != effect->effectData.groups.end())
     {
         ParticleGroup& group = *it;
-        group.activeParticleCount = 0;
+        ParticlePool& particles = group.particles;
         float32 dt = group.emitter->shortEffect ? shortEffectTime : deltaTime;
         group.time += dt;
         float32 groupEndTime = group.layer->isLooped ? group.layer->loopEndTime : group.layer->endTime;
@@ -543,132 +620,114 @@ void ParticleEffectSystem::UpdateEffect(ParticleEffectComponent* effect, float32
         if ((!group.finishingGroup) && (group.layer->isLooped) && (currLoopTime > group.loopDuration)) //restart loop
         {
             group.loopStartTime = group.time;
-            group.loopLayerStartTime = group.layer->deltaTime + group.layer->deltaVariation * static_cast<float32>(random->RandFloat());
-            group.loopDuration = group.loopLayerStartTime + (group.layer->endTime - group.layer->startTime) + group.layer->loopVariation * static_cast<float32>(random->RandFloat());
+            group.loopLayerStartTime = group.layer->deltaTime + group.layer->deltaVariation * random.RandFloat();
+            group.loopDuration = group.loopLayerStartTime + (group.layer->endTime - group.layer->startTime) + group.layer->loopVariation * random.RandFloat();
             currLoopTime = 0;
         }
 
-        //prepare forces as they will now actually change in time even for already generated particles
-        static Vector<Vector3> currSimplifiedForceValues;
-        int32 simplifiedForcesCount;
-
-        static Vector<ParticleForce*> effectAlignCurrForces;
-        static Vector<ParticleForce*> worldAlignCurrForces;
-        uint32 forcesCountWorldAlign = 0;
-        uint32 effectAlignForcesCount = 0;
+        UpdateParticlesLife(group, dt);
 
-        static Matrix4 invWorld;
-        if (group.head)
+        //prepare forces as they will now actually change in time even for already generated particles
+        groupContext.dt = dt;
+        groupContext.layerOverLife = currLoopTimeNormalized;
+        groupContext.simplifiedForceValues.clear();
+        groupContext.effectAlignForces.clear();
+        groupContext.worldAlignForces.clear();
+        groupContext.worldAlignForcePositions.clear();
+
+        uint32 count = particles.GetCount();
+        if (count > 0)
         {
-            simplifiedForcesCount = static_cast<int32>(group.layer->GetSimplifiedParticleForces().size());
-            if (simplifiedForcesCount)
+            for (ParticleForceSimplified* force : group.layer->GetSimplifiedParticleForces())
             {
-                currSimplifiedForceValues.resize(simplifiedForcesCount);
-                for (int32 i = 0; i < simplifiedForcesCount; ++i)
-                {
-                    if (group.layer->GetSimplifiedParticleForces()[i]->force)
-                        currSimplifiedForceValues[i] = group.layer->GetSimplifiedParticleForces()[i]->force->GetValue(currLoopTime);
-                    else
-                        currSimplifiedForceValues[i] = Vector3(0, 0, 0);
-                }
+                if (force->force)
+                    groupContext.simplifiedForceValues.push_back(force->force->GetValue(currLoopTime));
+                else
+                    groupContext.simplifiedForceValues.push_back(Vector3(0, 0, 0));
             }
 
-            uint32 allForcesCount = static_cast<uint32>(group.layer->GetParticleForces().size());
-            if (allForcesCount > 0)
+            for (ParticleForce* currForce : group.layer->GetParticleForces())
             {
-                effectAlignCurrForces.resize(allForcesCount);
-                worldAlignCurrForces.resize(allForcesCount);
-                for (uint32 i = 0; i < allForcesCount; ++i)
-                {
-                    DAVA::ParticleForce* currForce = group.layer->GetParticleForces()[i];
-                    if (currForce->isGlobal)
-                        continue;
+                if (currForce->isGlobal)
+                    continue;
 
-                    if (currForce->worldAlign)
-                    {
-                        currForce->worldPosition = currForce->position + worldTransformPtr->GetTranslationVector(); // Ignore emitter rotation.
-                        worldAlignCurrForces[forcesCountWorldAlign] = currForce;
-                        ++forcesCountWorldAlign;
-                    }
-                    else
+                if (currForce->worldAlign)
+                {
+                    groupContext.worldAlignForces.push_back(currForce);
+                    groupContext.worldAlignForcePositions.push_back(currForce->position + worldTransformPtr->GetTranslationVector()); // Ignore emitter rotation.
+                }
+                else
+                {
+                    groupContext.effectAlignForces.push_back(currForce);
+                    if (!isInverseCalculated)
                     {
-                        effectAlignCurrForces[effectAlignForcesCount] = currForce;
-                        ++effectAlignForcesCount;
-                        if (!isInverseCalculated)
-                        {
-                            invWorld = GetInverseWithRemovedScale(*worldTransformPtr);
-                            isInverseCalculated = true;
-                        }
+                        groupContext.invWorld = GetInverseWithRemovedScale(*worldTransformPtr);
+                        isInverseCalculated = true;
                     }
                 }
             }
-        }
 
-        Particle* current = group.head;
-        Particle* prev = nullptr;
-
-        while (current)
-        {
-            current->life += dt;
-            if (current->life >= current->lifeTime)
-            {
-                Particle* next = current->next;
-                if (prev == nullptr)
-                    group.head = next;
-                else
-                    prev->next = next;
-                delete current;
-                current = next;
-                continue;
-            }
-            group.activeParticleCount++;
-
-            float32 overLifeTime = current->life / current->lifeTime;
+            buffers.Resize(count);
+            ParticleKernels::Divide(buffers.overLife.data(), particles.life.data(), particles.lifeTime.data(), count);
+            const float32* overLife = buffers.overLife.data();
 
             if (group.layer->type != ParticleLayer::TYPE_PARTICLE_STRIPE)
             {
-                UpdateRegularParticleData(effect, current, group, overLifeTime, simplifiedForcesCount, currSimplifiedForceValues, dt, bbox, effectAlignCurrForces, effectAlignForcesCount, worldAlignCurrForces, forcesCountWorldAlign, *worldTransformPtr, invWorld, currLoopTimeNormalized);
+                UpdateRegularParticles(effect, group, context, bbox);
             }
 
             if (group.layer->type == ParticleLayer::TYPE_SUPEREMITTER_PARTICLES)
             {
-                effect->effectData.infoSources[current->positionTarget].position = current->position;
-                effect->effectData.infoSources[current->positionTarget].size = current->currSize;
+                for (uint32 i = 0; i < count; ++i)
+                {
+                    ParentInfo& info = effect->effectData.infoSources[particles.positionTarget[i]];
+                    info.position = particles.GetPosition(i);
+                    info.size = particles.currSize[i];
+                }
             }
 
             if (group.layer->enableNoise && group.layer->noise.get() != nullptr)
             {
-                if (group.layer->noiseScaleOverLife != nullptr)
-                    current->currNoiseScale = current->baseNoiseScale * group.layer->noiseScaleOverLife->GetValue(overLifeTime);
-
-                DAVA::float32 overLifeScale = 1.0f;
-                if (group.layer->noiseUScrollSpeedOverLife != nullptr)
+                for (uint32 i = 0; i < count; ++i)
                 {
-                    overLifeScale = group.layer->noiseUScrollSpeedOverLife->GetValue(overLifeTime);
-                }
-                current->currNoiseUOffset += current->baseNoiseUScrollSpeed * overLifeScale * deltaTime;
+                    if (group.layer->noiseScaleOverLife != nullptr)
+                        particles.currNoiseScale[i] = particles.baseNoiseScale[i] * group.layer->noiseScaleOverLife->GetValue(overLife[i]);
 
-                overLifeScale = 1.0f;
-                if (group.layer->noiseVScrollSpeedOverLife != nullptr)
-                {
-                    overLifeScale = group.layer->noiseVScrollSpeedOverLife->GetValue(overLifeTime);
+                    DAVA::float32 overLifeScale = 1.0f;
+                    if (group.layer->noiseUScrollSpeedOverLife != nullptr)
+                    {
+                        overLifeScale = group.layer->noiseUScrollSpeedOverLife->GetValue(overLife[i]);
+                    }
+                    particles.currNoiseUOffset[i] += particles.baseNoiseUScrollSpeed[i] * overLifeScale * deltaTime;
+
+                    overLifeScale = 1.0f;
+                    if (group.layer->noiseVScrollSpeedOverLife != nullptr)
+                    {
+                        overLifeScale = group.layer->noiseVScrollSpeedOverLife->GetValue(overLife[i]);
+                    }
+                    particles.currNoiseVOffset[i] += particles.baseNoiseVScrollSpeed[i] * overLifeScale * deltaTime;
                 }
-                current->currNoiseVOffset += current->baseNoiseVScrollSpeed * overLifeScale * deltaTime;
             }
 
             if (group.layer->enableAlphaRemap && group.layer->alphaRemapSprite.get() != nullptr && group.layer->alphaRemapOverLife != nullptr)
             {
-                float32 lookup = overLifeTime * group.layer->alphaRemapLoopCount;
-                float32 intPart;
-                current->alphaRemap = group.layer->alphaRemapOverLife->GetValue(modff(lookup, &intPart));
+                for (uint32 i = 0; i < count; ++i)
+                {
+                    float32 lookup = overLife[i] * group.layer->alphaRemapLoopCount;
+                    float32 intPart;
+                    particles.alphaRemap[i] = group.layer->alphaRemapOverLife->GetValue(modff(lookup, &intPart));
+                }
             }
 
             if (group.layer->type == ParticleLayer::TYPE_PARTICLE_STRIPE)
-                UpdateStripe(current, effect->effectData, group, deltaTime, bbox, currSimplifiedForceValues, simplifiedForcesCount, group.layer->IsLodActive(effect->activeLodLevel));
-
-            prev = current;
-            current = current->next;
+            {
+                for (uint32 i = 0; i < count; ++i)
+                {
+                    UpdateStripe(particles, i, effect->effectData, group, deltaTime, bbox, groupContext.simplifiedForceValues, group.layer->IsLodActive(effect->activeLodLevel));
+                }
+            }
         }
+
         bool allowParticleGeneration = !group.finishingGroup;
         allowParticleGeneration &= (currLoopTime > group.loopLayerStartTime);
         allowParticleGeneration &= group.visibleLod;
@@ -676,13 +735,13 @@ void ParticleEffectSystem::UpdateEffect(ParticleEffectComponent* effect, float32
         {
             if (group.layer->type == ParticleLayer::TYPE_SINGLE_PARTICLE || group.layer->type == ParticleLayer::TYPE_PARTICLE_STRIPE)
             {
-                if (!group.head)
+                if (particles.IsEmpty())
                 {
-                    current = GenerateNewParticle(effect, group, currLoopTime, *worldTransformPtr);
+                    uint32 index = GenerateNewParticle(effect, group, currLoopTime, *worldTransformPtr, context);
                     if (group.layer->GetInheritPosition())
-                        AddParticleToBBox(current->position + effect->effectData.infoSources[group.positionSource].position, current->currRadius, bbox);
+                        AddParticleToBBox(particles.GetPosition(index) + effect->effectData.infoSources[group.positionSource].position, particles.currRadius[index], bbox);
                     else
-                        AddParticleToBBox(current->position, current->currRadius, bbox);
+                        AddParticleToBBox(particles.GetPosition(index), particles.currRadius[index], bbox);
                 }
             }
             else
@@ -692,23 +751,23 @@ void ParticleEffectSystem::UpdateEffect(ParticleEffectComponent* effect, float32
                 if (group.layer->number)
                     newParticles = group.layer->number->GetValue(currLoopTime);
                 if (group.layer->numberVariation)
-                    newParticles += group.layer->numberVariation->GetValue(currLoopTime) * static_cast<float32>(random->RandFloat());
+                    newParticles += group.layer->numberVariation->GetValue(currLoopTime) * random.RandFloat();
                 newParticles *= dt;
                 group.particlesToGenerate += newParticles;
 
                 while (group.particlesToGenerate >= 1.0f)
                 {
                     group.particlesToGenerate -= 1.0f;
-                    current = GenerateNewParticle(effect, group, currLoopTime, *worldTransformPtr);
+                    uint32 index = GenerateNewParticle(effect, group, currLoopTime, *worldTransformPtr, context);
                     if (group.layer->GetInheritPosition())
-                        AddParticleToBBox(current->position + effect->effectData.infoSources[group.positionSource].position, current->currRadius, bbox);
+                        AddParticleToBBox(particles.GetPosition(index) + effect->effectData.infoSources[group.positionSource].position, particles.currRadius[index], bbox);
                     else
-                        AddParticleToBBox(current->position, current->currRadius, bbox);
+                        AddParticleToBBox(particles.GetPosition(index), particles.currRadius[index], bbox);
                 }
             }
         }
 
-        if (group.finishingGroup && (group.head == nullptr))
+        if (group.finishingGroup && particles.IsEmpty())
         {
             DAVA::SafeRelease(group.emitter);
             DAVA::SafeRelease(group.layer);
@@ -727,12 +786,14 @@ void ParticleEffectSystem::UpdateEffect(ParticleEffectComponent* effect, float32
     effect->effectRenderObject->SetAABBox(bbox);
 }
 
-void ParticleEffectSystem::UpdateStripe(Particle* particle, ParticleEffectData& effectData, ParticleGroup& group, float32 dt, AABBox3& bbox, const Vector<Vector3>& currForceValues, int32 forcesCount, bool isActive)
+void ParticleEffectSystem::UpdateStripe(const ParticlePool& particles, uint32 index, ParticleEffectData& effectData, ParticleGroup& group, float32 dt, AABBox3& bbox, const Vector<Vector3>& currForceValues, bool isActive)
 {
     ParticleLayer* layer = group.layer;
     StripeData& data = group.stripe;
     Vector3 prevBasePosition = data.baseNode.position;
-    data.baseNode.position = particle->position;
+    Vector3 particleSpeed = particles.GetSpeed(index);
+    int32 forcesCount = static_cast<int32>(currForceValues.size());
+    data.baseNode.position = particles.GetPosition(index);
     data.isActive = isActive;
 
     if (layer->GetInheritPosition())
@@ -745,7 +806,7 @@ void ParticleEffectSystem::UpdateStripe(Particle* particle, ParticleEffectData&
         data.baseNode.position = effectData.infoSources[group.positionSource].position;
     }
 
-    data.baseNode.speed = particle->speed;
+    data.baseNode.speed = particleSpeed;
 
     bool shouldInsert = data.stripeNodes.empty() || (data.baseNode.position - data.stripeNodes.front().position).SquareLength() > layer->stripeVertexSpawnStep * layer->stripeVertexSpawnStep;
 
@@ -814,7 +875,7 @@ void ParticleEffectSystem::UpdateStripe(Particle* particle, ParticleEffectData&
         else
         {
             float32 delta = (data.baseNode.position - prevBasePosition).Length();
-            if (particle->speed.DotProduct(data.baseNode.position - prevBasePosition) <= 0)
+            if (particleSpeed.DotProduct(data.baseNode.position - prevBasePosition) <= 0)
             {
                 data.uvOffset -= delta;
             }
@@ -833,212 +894,361 @@ void ParticleEffectSystem::AddParticleToBBox(const Vector3& position, float radi
     bbox.AddPoint(position + sz);
 }
 
-Particle* ParticleEffectSystem::GenerateNewParticle(ParticleEffectComponent* effect, ParticleGroup& group, float32 currLoopTime, const Matrix4& worldTransform)
+uint32 ParticleEffectSystem::GenerateNewParticle(ParticleEffectComponent* effect, ParticleGroup& group, float32 currLoopTime, const Matrix4& worldTransform, EffectUpdateContext& context)
 {
-    Particle* particle = new Particle();
-    particle->life = 0.0f;
+    ParticlesRandom::Generator& random = effect->effectData.random;
+    ParticlePool& particles = group.particles;
+    uint32 index = particles.Add();
+    particles.life[index] = 0.0f;
 
-    particle->color = Color();
+    particles.color[index] = Color();
     if (group.layer->colorRandom)
     {
-        particle->color = group.layer->colorRandom->GetValue(static_cast<float32>(GetEngineContext()->random->RandFloat()));
+        particles.color[index] = group.layer->colorRandom->GetValue(random.RandFloat());
     }
     if (group.emitter->colorOverLife)
     {
-        particle->color *= group.emitter->colorOverLife->GetValue(group.time);
+        particles.color[index] *= group.emitter->colorOverLife->GetValue(group.time);
     }
 
-    particle->lifeTime = 0.0f;
+    particles.lifeTime[index] = 0.0f;
     if (group.layer->life)
-        particle->lifeTime += group.layer->life->GetValue(currLoopTime);
+        particles.lifeTime[index] += group.layer->life->GetValue(currLoopTime);
     if (group.layer->lifeVariation)
-        particle->lifeTime += (group.layer->lifeVariation->GetValue(currLoopTime) * static_cast<float32>(GetEngineContext()->random->RandFloat()));
+        particles.lifeTime[index] += (group.layer->lifeVariation->GetValue(currLoopTime) * random.RandFloat());
 
     // Flow.
-    particle->baseFlowSpeed = 0.0f;
+    float32 flowSpeed = 0.0f;
     if (group.layer->flowSpeed)
-        particle->baseFlowSpeed += group.layer->flowSpeed->GetValue(currLoopTime);
+        flowSpeed += group.layer->flowSpeed->GetValue(currLoopTime);
     if (group.layer->flowSpeedVariation)
-        particle->baseFlowSpeed += (group.layer->flowSpeedVariation->GetValue(currLoopTime) * static_cast<float32>(GetEngineContext()->random->RandFloat()));
-    particle->currFlowSpeed = particle->baseFlowSpeed;
+        flowSpeed += (group.layer->flowSpeedVariation->GetValue(currLoopTime) * random.RandFloat());
+    particles.currFlowSpeed[index] = flowSpeed;
 
-    particle->baseFlowOffset = 0.0f;
+    float32 flowOffset = 0.0f;
     if (group.layer->flowOffset)
-        particle->baseFlowOffset += group.layer->flowOffset->GetValue(currLoopTime);
+        flowOffset += group.layer->flowOffset->GetValue(currLoopTime);
     if (group.layer->flowOffsetVariation)
-        particle->baseFlowOffset += (group.layer->flowOffsetVariation->GetValue(currLoopTime) * static_cast<float32>(GetEngineContext()->random->RandFloat()));
-    particle->currFlowOffset = particle->baseFlowOffset;
+        flowOffset += (group.layer->flowOffsetVariation->GetValue(currLoopTime) * random.RandFloat());
+    particles.currFlowOffset[index] = flowOffset;
 
     // Noise.
-    particle->baseNoiseScale = 0.0f;
+    particles.baseNoiseScale[index] = 0.0f;
     if (group.layer->noiseScale)
-        particle->baseNoiseScale += group.layer->noiseScale->GetValue(currLoopTime);
+        particles.baseNoiseScale[index] += group.layer->noiseScale->GetValue(currLoopTime);
     if (group.layer->noiseScaleVariation)
-        particle->baseNoiseScale += (group.layer->noiseScaleVariation->GetValue(currLoopTime) * static_cast<float32>(GetEngineContext()->random->RandFloat()));
-    particle->currNoiseScale = particle->baseNoiseScale;
+        particles.baseNoiseScale[index] += (group.layer->noiseScaleVariation->GetValue(currLoopTime) * random.RandFloat());
+    particles.currNoiseScale[index] = particles.baseNoiseScale[index];
 
-    particle->baseNoiseUScrollSpeed = 0.0f;
+    particles.baseNoiseUScrollSpeed[index] = 0.0f;
     if (group.layer->noiseUScrollSpeed)
-        particle->baseNoiseUScrollSpeed += group.layer->noiseUScrollSpeed->GetValue(currLoopTime);
+        particles.baseNoiseUScrollSpeed[index] += group.layer->noiseUScrollSpeed->GetValue(currLoopTime);
     if (group.layer->noiseUScrollSpeedVariation)
-        particle->baseNoiseUScrollSpeed += (group.layer->noiseUScrollSpeedVariation->GetValue(currLoopTime) * static_cast<float32>(GetEngineContext()->random->RandFloat()));
-    particle->currNoiseUOffset = particle->baseNoiseUScrollSpeed;
+        particles.baseNoiseUScrollSpeed[index] += (group.layer->noiseUScrollSpeedVariation->GetValue(currLoopTime) * random.RandFloat());
+    particles.currNoiseUOffset[index] = particles.baseNoiseUScrollSpeed[index];
 
-    particle->baseNoiseVScrollSpeed = 0.0f;
+    particles.baseNoiseVScrollSpeed[index] = 0.0f;
     if (group.layer->noiseVScrollSpeed)
-        particle->baseNoiseVScrollSpeed += group.layer->noiseVScrollSpeed->GetValue(currLoopTime);
+        particles.baseNoiseVScrollSpeed[index] += group.layer->noiseVScrollSpeed->GetValue(currLoopTime);
     if (group.layer->noiseVScrollSpeedVariation)
-        particle->baseNoiseVScrollSpeed += (group.layer->noiseVScrollSpeedVariation->GetValue(currLoopTime) * static_cast<float32>(GetEngineContext()->random->RandFloat()));
-    particle->currNoiseVOffset = particle->baseNoiseVScrollSpeed;
+        particles.baseNoiseVScrollSpeed[index] += (group.layer->noiseVScrollSpeedVariation->GetValue(currLoopTime) * random.RandFloat());
+    particles.currNoiseVOffset[index] = particles.baseNoiseVScrollSpeed[index];
 
     // size
-    particle->baseSize = Vector2(1.0f, 1.0f);
+    particles.baseSize[index] = Vector2(1.0f, 1.0f);
     if (group.layer->size)
-        particle->baseSize = group.layer->size->GetValue(currLoopTime);
+        particles.baseSize[index] = group.layer->size->GetValue(currLoopTime);
     if (group.layer->sizeVariation)
-        particle->baseSize += (group.layer->sizeVariation->GetValue(currLoopTime) * static_cast<float32>(GetEngineContext()->random->RandFloat()));
-    particle->baseSize *= effect->effectData.infoSources[group.positionSource].size;
+        particles.baseSize[index] += (group.layer->sizeVariation->GetValue(currLoopTime) * random.RandFloat());
+    particles.baseSize[index] *= effect->effectData.infoSources[group.positionSource].size;
 
-    particle->currSize = particle->baseSize;
+    particles.currSize[index] = particles.baseSize[index];
     if (group.layer->sizeOverLifeXY)
-        particle->currSize *= group.layer->sizeOverLifeXY->GetValue(0);
-    Vector2 pivotSize = particle->currSize * group.layer->layerPivotSizeOffsets;
-    particle->currRadius = pivotSize.Length();
+        particles.currSize[index] *= group.layer->sizeOverLifeXY->GetValue(0);
+    Vector2 pivotSize = particles.currSize[index] * group.layer->layerPivotSizeOffsets;
+    particles.currRadius[index] = pivotSize.Length();
 
-    particle->angle = 0.0f;
-    particle->spin = 0.0f;
+    particles.angle[index] = 0.0f;
+    particles.spin[index] = 0.0f;
     if (group.layer->angle)
-        particle->angle = DegToRad(group.layer->angle->GetValue(currLoopTime));
+        particles.angle[index] = DegToRad(group.layer->angle->GetValue(currLoopTime));
     if (group.layer->angleVariation)
-        particle->angle += DegToRad(group.layer->angleVariation->GetValue(currLoopTime) * static_cast<float32>(GetEngineContext()->random->RandFloat()));
+        particles.angle[index] += DegToRad(group.layer->angleVariation->GetValue(currLoopTime) * random.RandFloat());
     if (group.layer->spin)
-        particle->spin = DegToRad(group.layer->spin->GetValue(currLoopTime));
+        particles.spin[index] = DegToRad(group.layer->spin->GetValue(currLoopTime));
     if (group.layer->spinVariation)
-        particle->spin += DegToRad(group.layer->spinVariation->GetValue(currLoopTime) * static_cast<float32>(GetEngineContext()->random->RandFloat()));
+        particles.spin[index] += DegToRad(group.layer->spinVariation->GetValue(currLoopTime) * random.RandFloat());
     if (group.layer->randomSpinDirection)
     {
-        int32 dir = Rand() & 1;
-        particle->spin *= (dir)*2 - 1;
+        int32 dir = random.Rand() & 1;
+        particles.spin[index] *= (dir)*2 - 1;
     }
-    particle->frame = 0;
-    particle->animTime = 0;
+    particles.frame[index] = 0;
+    particles.animTime[index] = 0;
     if (group.layer->randomFrameOnStart && group.layer->sprite)
     {
-        particle->frame = static_cast<int32>(static_cast<float32>(GetEngineContext()->random->RandFloat()) * static_cast<float32>(group.layer->sprite->GetFrameCount()));
+        particles.frame[index] = static_cast<int32>(random.RandFloat() * static_cast<float32>(group.layer->sprite->GetFrameCount()));
     }
 
-    PrepareEmitterParameters(particle, group, worldTransform);
+    Vector3 position;
+    Vector3 speed;
+    PrepareEmitterParameters(group, worldTransform, random, position, speed);
 
     float32 vel = 0.0f;
     if (group.layer->velocity)
         vel += group.layer->velocity->GetValue(currLoopTime);
     if (group.layer->velocityVariation)
-        vel += (group.layer->velocityVariation->GetValue(currLoopTime) * static_cast<float32>(GetEngineContext()->random->RandFloat()));
-    particle->speed *= vel;
+        vel += (group.layer->velocityVariation->GetValue(currLoopTime) * random.RandFloat());
+    speed *= vel;
 
     if (!group.layer->GetInheritPosition()) //just generate at correct position
     {
-        particle->position += effect->effectData.infoSources[group.positionSource].position;
+        position += effect->effectData.infoSources[group.positionSource].position;
     }
 
-    particle->next = group.head;
-    group.head = particle;
+    particles.SetPosition(index, position);
+    particles.SetSpeed(index, speed);
+    particles.seed[index] = random.Rand();
     group.activeParticleCount++;
     if (group.layer->type == ParticleLayer::TYPE_SUPEREMITTER_PARTICLES)
     {
         ParentInfo info;
-        info.position = particle->position;
-        info.size = particle->currSize;
+        info.position = position;
+        info.size = particles.currSize[index];
         effect->effectData.infoSources.push_back(info);
-        particle->positionTarget = static_cast<int32>(effect->effectData.infoSources.size() - 1);
+        particles.positionTarget[index] = static_cast<int32>(effect->effectData.infoSources.size() - 1);
         ParticleEmitter* innerEmitter = group.layer->innerEmitter->GetEmitter();
         if (innerEmitter)
-            RunEmitter(effect, innerEmitter, Vector3(0, 0, 0), particle->positionTarget);
+        {
+            // effects can be updated in parallel, so materials are acquired after update
+            RunEmitter(effect, innerEmitter, Vector3(0, 0, 0), particles.positionTarget[index], true);
+            if (context.pendingMaterialEffects.empty() || context.pendingMaterialEffects.back() != effect)
+                context.pendingMaterialEffects.push_back(effect);
+        }
     }
 
     group.particlesGenerated++;
-    return particle;
+    return index;
 }
 
-void ParticleEffectSystem::UpdateRegularParticleData(ParticleEffectComponent* effect, Particle* particle, const ParticleGroup& group, float32 overLife, int32 simplifiedForcesCount, Vector<Vector3>& currSimplifiedForceValues, float32 dt, AABBox3& bbox, const Vector<ParticleForce*>& effectAlignForces, uint32 effectAlignForcesCount, const Vector<ParticleForce*>& worldAlignForces, uint32 worldAlignForcesCount, const Matrix4& world, const Matrix4& invWorld, float32 layerOverLife)
+void ParticleEffectSystem::UpdateBuffers::Resize(uint32 count)
 {
-    float32 currVelocityOverLife = 1.0f;
-    if (group.layer->velocityOverLife)
-        currVelocityOverLife = group.layer->velocityOverLife->GetValue(overLife);
-    Vector3 prevParticlePosition = particle->position;
-    particle->position += particle->speed * (currVelocityOverLife * dt);
+    if (overLife.size() < count)
+    {
+        overLife.resize(count);
+        scale.resize(count);
+        accelerationX.resize(count);
+        accelerationY.resize(count);
+        accelerationZ.resize(count);
+        prevPositionX.resize(count);
+        prevPositionY.resize(count);
+        prevPositionZ.resize(count);
+    }
+}
 
-    float32 currSpinOverLife = 1.0f;
-    if (group.layer->spinOverLife)
-        currSpinOverLife = group.layer->spinOverLife->GetValue(overLife);
-    particle->angle += particle->spin * currSpinOverLife * dt;
+void ParticleEffectSystem::UpdateParticlesLife(ParticleGroup& group, float32 dt)
+{
+    ParticlePool& particles = group.particles;
+    ParticleKernels::Add(particles.life.data(), dt, particles.GetCount());
 
-    Vector3 acceleration(0.0f, 0.0f, 0.0f);
-    for (int32 i = 0; i < simplifiedForcesCount; ++i)
+    // go backwards, so particles moved to places of removed ones are already checked
+    for (uint32 i = particles.GetCount(); i-- > 0;)
     {
-        acceleration += (group.layer->GetSimplifiedParticleForces()[i]->forceOverLife) ? (currSimplifiedForceValues[i] * group.layer->GetSimplifiedParticleForces()[i]->forceOverLife->GetValue(overLife)) : currSimplifiedForceValues[i];
+        if (particles.life[i] >= particles.lifeTime[i])
+            particles.Remove(i);
     }
+    group.activeParticleCount = static_cast<int32>(particles.GetCount());
+}
 
-    for (uint32 i = 0; i < worldAlignForcesCount; ++i)
-        ParticleForces::ApplyForce(worldAlignForces[i], particle->speed, particle->position, dt, overLife, layerOverLife, Vector3(0.0f, 0.0f, -1.0f), particle, prevParticlePosition, worldAlignForces[i]->worldPosition);
+void ParticleEffectSystem::UpdateRegularParticles(ParticleEffectComponent* effect, ParticleGroup& group, EffectUpdateContext& effectContext, AABBox3& bbox)
+{
+    const GroupUpdateContext& context = effectContext.group;
+    UpdateBuffers& buffers = effectContext.buffers;
+    ParticleLayer* layer = group.layer;
+    ParticlePool& particles = group.particles;
+    uint32 count = particles.GetCount();
+    float32 dt = context.dt;
+    const float32* overLife = buffers.overLife.data();
+    float32* scale = buffers.scale.data();
+
+    bool applyForces = !context.worldAlignForces.empty() || !context.effectAlignForces.empty() || (layer->applyGlobalForces && !globalForces.empty());
+    if (applyForces)
+    {
+        std::copy(particles.positionX.begin(), particles.positionX.end(), buffers.prevPositionX.begin());
+        std::copy(particles.positionY.begin(), particles.positionY.end(), buffers.prevPositionY.begin());
+        std::copy(particles.positionZ.begin(), particles.positionZ.end(), buffers.prevPositionZ.begin());
+    }
 
-    if (effectAlignForcesCount > 0)
+    if (layer->velocityOverLife)
+    {
+        for (uint32 i = 0; i < count; ++i)
+            scale[i] = layer->velocityOverLife->GetValue(overLife[i]) * dt;
+        ParticleKernels::MultiplyAdd(particles.positionX.data(), particles.speedX.data(), scale, count);
+        ParticleKernels::MultiplyAdd(particles.positionY.data(), particles.speedY.data(), scale, count);
+        ParticleKernels::MultiplyAdd(particles.positionZ.data(), particles.speedZ.data(), scale, count);
+    }
+    else
     {
-        Vector3 effectSpacePosition;
-        Vector3 prevEffectSpacePosition;
-        Vector3 effectSpaceSpeed;
-        effectSpacePosition = particle->position * invWorld;
-        effectSpaceSpeed = particle->speed * Matrix3(invWorld);
-        if (group.layer->GetPlaneCollisiontForcesCount() > 0)
-            prevEffectSpacePosition = prevParticlePosition * invWorld;
+        ParticleKernels::MultiplyAdd(particles.positionX.data(), particles.speedX.data(), dt, count);
+        ParticleKernels::MultiplyAdd(particles.positionY.data(), particles.speedY.data(), dt, count);
+        ParticleKernels::MultiplyAdd(particles.positionZ.data(), particles.speedZ.data(), dt, count);
+    }
 
-        for (uint32 i = 0; i < effectAlignForcesCount; ++i)
-            ParticleForces::ApplyForce(effectAlignForces[i], effectSpaceSpeed, effectSpacePosition, dt, overLife, layerOverLife, -Vector3(invWorld._20, invWorld._21, invWorld._22), particle, prevEffectSpacePosition, effectAlignForces[i]->position);
+    if (layer->spinOverLife)
+    {
+        for (uint32 i = 0; i < count; ++i)
+            scale[i] = layer->spinOverLife->GetValue(overLife[i]) * dt;
+        ParticleKernels::MultiplyAdd(particles.angle.data(), particles.spin.data(), scale, count);
+    }
+    else
+    {
+        ParticleKernels::MultiplyAdd(particles.angle.data(), particles.spin.data(), dt, count);
+    }
 
-        particle->speed = effectSpaceSpeed * Matrix3(world);
-        if (group.layer->GetAlterPositionForcesCount() > 0)
-            particle->position = effectSpacePosition * world;
+    // acceleration of simplified forces is calculated before other forces change particles, but is applied after them
+    const Vector<ParticleForceSimplified*>& simplifiedForces = layer->GetSimplifiedParticleForces();
+    Vector3 constantAcceleration(0.0f, 0.0f, 0.0f);
+    bool hasAccelerationOverLife = false;
+    for (size_t f = 0; f < simplifiedForces.size(); ++f)
+    {
+        if (simplifiedForces[f]->forceOverLife)
+            hasAccelerationOverLife = true;
+        else
+            constantAcceleration += context.simplifiedForceValues[f];
     }
 
-    if (group.layer->applyGlobalForces)
-        ApplyGlobalForces(particle, dt, overLife, layerOverLife, prevParticlePosition);
+    if (hasAccelerationOverLife)
+    {
+        for (uint32 i = 0; i < count; ++i)
+        {
+            Vector3 acceleration = constantAcceleration;
+            for (size_t f = 0; f < simplifiedForces.size(); ++f)
+            {
+                if (simplifiedForces[f]->forceOverLife)
+                    acceleration += context.simplifiedForceValues[f] * simplifiedForces[f]->forceOverLife->GetValue(overLife[i]);
+            }
+            buffers.accelerationX[i] = acceleration.x;
+            buffers.accelerationY[i] = acceleration.y;
+            buffers.accelerationZ[i] = acceleration.z;
+        }
+    }
 
-    particle->speed += acceleration * dt;
+    if (applyForces)
+    {
+        ApplyForces(group, effectContext);
+    }
 
-    if (group.layer->sizeOverLifeXY)
+    if (hasAccelerationOverLife)
     {
-        particle->currSize = particle->baseSize * group.layer->sizeOverLifeXY->GetValue(overLife);
-        Vector2 pivotSize = particle->currSize * group.layer->layerPivotSizeOffsets;
-        particle->currRadius = pivotSize.Length();
+        ParticleKernels::MultiplyAdd(particles.speedX.data(), buffers.accelerationX.data(), dt, count);
+        ParticleKernels::MultiplyAdd(particles.speedY.data(), buffers.accelerationY.data(), dt, count);
+        ParticleKernels::MultiplyAdd(particles.speedZ.data(), buffers.accelerationZ.data(), dt, count);
+    }
+    else if (!simplifiedForces.empty())
+    {
+        Vector3 speedDelta = constantAcceleration * dt;
+        ParticleKernels::Add(particles.speedX.data(), speedDelta.x, count);
+        ParticleKernels::Add(particles.speedY.data(), speedDelta.y, count);
+        ParticleKernels::Add(particles.speedZ.data(), speedDelta.z, count);
     }
-    if (group.layer->GetInheritPosition())
-        AddParticleToBBox(particle->position + effect->effectData.infoSources[group.positionSource].position, particle->currRadius, bbox);
-    else
-        AddParticleToBBox(particle->position, particle->currRadius, bbox);
 
-    if (group.layer->frameOverLifeEnabled && group.layer->sprite)
+    if (layer->sizeOverLifeXY)
     {
-        float32 animDelta = group.layer->frameOverLifeFPS;
-        if (group.layer->animSpeedOverLife)
-            animDelta *= group.layer->animSpeedOverLife->GetValue(overLife);
-        particle->animTime += animDelta * dt;
+        for (uint32 i = 0; i < count; ++i)
+        {
+            particles.currSize[i] = particles.baseSize[i] * layer->sizeOverLifeXY->GetValue(overLife[i]);
+            Vector2 pivotSize = particles.currSize[i] * layer->layerPivotSizeOffsets;
+            particles.currRadius[i] = pivotSize.Length();
+        }
+    }
 
-        while (particle->animTime > 1.0f)
+    AABBox3 particlesBox;
+    ParticleKernels::AddCubesToBox(particles.positionX.data(), particles.positionY.data(), particles.positionZ.data(), particles.currRadius.data(), count, particlesBox);
+    if (layer->GetInheritPosition())
+    {
+        const Vector3& offset = effect->effectData.infoSources[group.positionSource].position;
+        particlesBox.min += offset;
+        particlesBox.max += offset;
+    }
+    bbox.AddAABBox(particlesBox);
+
+    if (layer->frameOverLifeEnabled && layer->sprite)
+    {
+        int32 framesCount = layer->sprite->GetFrameCount();
+        for (uint32 i = 0; i < count; ++i)
         {
-            particle->frame++;
-            particle->animTime -= 1.0f;
-            if (particle->frame >= group.layer->sprite->GetFrameCount())
+            float32 animDelta = layer->frameOverLifeFPS;
+            if (layer->animSpeedOverLife)
+                animDelta *= layer->animSpeedOverLife->GetValue(overLife[i]);
+            particles.animTime[i] += animDelta * dt;
+
+            while (particles.animTime[i] > 1.0f)
             {
-                if (group.layer->loopSpriteAnimation)
-                    particle->frame = 0;
-                else
-                    particle->frame = group.layer->sprite->GetFrameCount() - 1;
+                particles.frame[i]++;
+                particles.animTime[i] -= 1.0f;
+                if (particles.frame[i] >= framesCount)
+                {
+                    if (layer->loopSpriteAnimation)
+                        particles.frame[i] = 0;
+                    else
+                        particles.frame[i] = framesCount - 1;
+                }
             }
         }
     }
 }
 
-void ParticleEffectSystem::ApplyGlobalForces(Particle* particle, float32 dt, float32 overLife, float32 layerOverLife, Vector3 prevParticlePosition)
+void ParticleEffectSystem::ApplyForces(ParticleGroup& group, EffectUpdateContext& effectContext)
+{
+    const GroupUpdateContext& context = effectContext.group;
+    const UpdateBuffers& buffers = effectContext.buffers;
+    ParticlePool& particles = group.particles;
+    uint32 count = particles.GetCount();
+    float32 dt = context.dt;
+    const Matrix4& world = *context.world;
+    const Matrix4& invWorld = context.invWorld;
+    Matrix3 worldRotation(world);
+    Matrix3 invWorldRotation(invWorld);
+    Vector3 worldDown(0.0f, 0.0f, -1.0f);
+    Vector3 effectDown = -Vector3(invWorld._20, invWorld._21, invWorld._22);
+    bool transformPrevPosition = group.layer->GetPlaneCollisiontForcesCount() > 0;
+    bool transformPosition = group.layer->GetAlterPositionForcesCount() > 0;
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        float32 overLife = buffers.overLife[i];
+        Vector3 position = particles.GetPosition(i);
+        Vector3 speed = particles.GetSpeed(i);
+        Vector3 prevPosition(buffers.prevPositionX[i], buffers.prevPositionY[i], buffers.prevPositionZ[i]);
+
+        for (size_t f = 0; f < context.worldAlignForces.size(); ++f)
+            ParticleForces::ApplyForce(context.worldAlignForces[f], speed, position, dt, overLife, context.layerOverLife, worldDown, particles, i, prevPosition, context.worldAlignForcePositions[f]);
+
+        if (!context.effectAlignForces.empty())
+        {
+            Vector3 effectSpacePosition = position * invWorld;
+            Vector3 effectSpaceSpeed = speed * invWorldRotation;
+            Vector3 prevEffectSpacePosition;
+            if (transformPrevPosition)
+                prevEffectSpacePosition = prevPosition * invWorld;
+
+            for (ParticleForce* force : context.effectAlignForces)
+                ParticleForces::ApplyForce(force, effectSpaceSpeed, effectSpacePosition, dt, overLife, context.layerOverLife, effectDown, particles, i, prevEffectSpacePosition, force->position);
+
+            speed = effectSpaceSpeed * worldRotation;
+            if (transformPosition)
+                position = effectSpacePosition * world;
+        }
+
+        if (group.layer->applyGlobalForces)
+            ApplyGlobalForces(particles, i, position, speed, dt, overLife, context.layerOverLife, prevPosition);
+
+        particles.SetPosition(i, position);
+        particles.SetSpeed(i, speed);
+    }
+}
+
+void ParticleEffectSystem::ApplyGlobalForces(ParticlePool& particles, uint32 index, Vector3& position, Vector3& speed, float32 dt, float32 overLife, float32 layerOverLife, const Vector3& prevParticlePosition)
 {
     for (auto& forcePair : globalForces)
     {
@@ -1049,8 +1259,8 @@ void ParticleEffectSystem::ApplyGlobalForces(Particle* particle, float32 dt, flo
         for (ParticleForce* force : forcePair.second.worldAlignForces)
         {
             Vector3 forceWorldPosition = worldTransformPtr->GetTranslationVector() + force->position;
-            if (force->isInfinityRange || (forceWorldPosition - particle->position).SquareLength() < force->GetSquaredRadius())
-                ParticleForces::ApplyForce(force, particle->speed, particle->position, dt, overLife, layerOverLife, Vector3(0.0f, 0.0f, -1.0f), particle, prevParticlePosition, forceWorldPosition);
+            if (force->isInfinityRange || (forceWorldPosition - position).SquareLength() < force->GetSquaredRadius())
+                ParticleForces::ApplyForce(force, speed, position, dt, overLife, layerOverLife, Vector3(0.0f, 0.0f, -1.0f), particles, index, prevParticlePosition, forceWorldPosition);
         }
 
         if (!forcePair.second.effectAlignForces.empty())
@@ -1064,7 +1274,7 @@ void ParticleEffectSystem::ApplyGlobalForces(Particle* particle, float32 dt, flo
                     break;
                 }
                 Vector3 forceWorldPosition = worldTransformPtr->GetTranslationVector() + force->position; // Do not rotate global forces if force position is not zero.
-                float32 sqrDist = (forceWorldPosition - particle->position).SquareLength();
+                float32 sqrDist = (forceWorldPosition - position).SquareLength();
                 if (sqrDist < force->GetSquaredRadius())
                 {
                     inForceBoundingSphere = true;
@@ -1076,29 +1286,27 @@ void ParticleEffectSystem::ApplyGlobalForces(Particle* particle, float32 dt, flo
 
             Matrix4 invWorld = GetInverseWithRemovedScale(*worldTransformPtr);
 
-            Vector3 effectSpacePosition = particle->position * invWorld;
+            Vector3 effectSpacePosition = position * invWorld;
             Vector3 prevEffectSpacePosition = prevParticlePosition * invWorld;
-            Vector3 effectSpaceSpeed = particle->speed * Matrix3(invWorld);
+            Vector3 effectSpaceSpeed = speed * Matrix3(invWorld);
             bool transformPosition = false;
             for (ParticleForce* force : forcePair.second.effectAlignForces)
             {
                 if (force->CanAlterPosition())
                     transformPosition = true;
-                ParticleForces::ApplyForce(force, effectSpaceSpeed, effectSpacePosition, dt, overLife, layerOverLife, -Vector3(invWorld._20, invWorld._21, invWorld._22), particle, prevEffectSpacePosition, force->position);
+                ParticleForces::ApplyForce(force, effectSpaceSpeed, effectSpacePosition, dt, overLife, layerOverLife, -Vector3(invWorld._20, invWorld._21, invWorld._22), particles, index, prevEffectSpacePosition, force->position);
             }
-            particle->speed = effectSpaceSpeed * Matrix3(*worldTransformPtr);
+            speed = effectSpaceSpeed * Matrix3(*worldTransformPtr);
             if (transformPosition)
-                particle->position = effectSpacePosition * (*worldTransformPtr);
+                position = effectSpacePosition * (*worldTransformPtr);
         }
     }
 }
 
-void ParticleEffectSystem::PrepareEmitterParameters(Particle* particle, ParticleGroup& group, const Matrix4& worldTransform)
+void ParticleEffectSystem::PrepareEmitterParameters(ParticleGroup& group, const Matrix4& worldTransform, ParticlesRandom::Generator& random, Vector3& position, Vector3& speed)
 {
     //calculate position new particle position in emitter space (for point leave it V3(0,0,0))
-    uintptr_t uptr = reinterpret_cast<uintptr_t>(&group);
-    uint32 offset = static_cast<uint32>(uptr);
-    uint32 ind = group.particlesGenerated + offset;
+    uint32 ind = group.particlesGenerated + group.randomSequenceOffset;
 
     bool isCircleEmitter = group.emitter->emitterType == ParticleEmitter::EMITTER_ONCIRCLE_VOLUME || group.emitter->emitterType == ParticleEmitter::EMITTER_ONCIRCLE_EDGES;
     bool isSphereEmitter = group.emitter->emitterType == ParticleEmitter::EMITTER_SPHERE;
@@ -1109,7 +1317,7 @@ void ParticleEffectSystem::PrepareEmitterParameters(Particle* particle, Particle
         if (group.emitter->size)
         {
             Vector3 currSize = group.emitter->size->GetValue(group.time);
-            particle->position = Vector3(currSize.x * (ParticlesRandom::VanDerCorputRnd(ind, 3) - 0.5f), currSize.y * (ParticlesRandom::VanDerCorputRnd(ind, 2) - 0.5f), currSize.z * (ParticlesRandom::VanDerCorputRnd(ind, 5) - 0.5f));
+            position = Vector3(currSize.x * (ParticlesRandom::VanDerCorputRnd(ind, 3) - 0.5f), currSize.y * (ParticlesRandom::VanDerCorputRnd(ind, 2) - 0.5f), currSize.z * (ParticlesRandom::VanDerCorputRnd(ind, 5) - 0.5f));
         }
     }
     else if (isCircleEmitter)
@@ -1128,13 +1336,13 @@ void ParticleEffectSystem::PrepareEmitterParameters(Particle* particle, Particle
         float32 curAngle = angleBase + angleVariation * ParticlesRandom::VanDerCorputRnd(ind, 3);
         if (group.emitter->emitterType == ParticleEmitter::EMITTER_ONCIRCLE_VOLUME)
         {
-            float32 rndRadiusNorm = std::sqrt(static_cast<float32>(GetEngineContext()->random->RandFloat())); // Better distribution on circle.
+            float32 rndRadiusNorm = std::sqrt(random.RandFloat()); // Better distribution on circle.
             curRadius = Lerp(innerRadius, curRadius, rndRadiusNorm);
         }
         float32 sinAngle = 0.0f;
         float32 cosAngle = 0.0f;
         SinCosFast(curAngle, sinAngle, cosAngle);
-        particle->position = Vector3(curRadius * cosAngle, curRadius * sinAngle, 0.0f);
+        position = Vector3(curRadius * cosAngle, curRadius * sinAngle, 0.0f);
     }
     else if (isSphereEmitter)
     {
@@ -1148,7 +1356,7 @@ void ParticleEffectSystem::PrepareEmitterParameters(Particle* particle, Particle
         float32 phi = std::acos(2.0f * v - 1.0f);
         if (!group.emitter->generateOnSurface)
         {
-            float32 rndRadiusNorm = std::sqrt(static_cast<float32>(GetEngineContext()->random->RandFloat())); // Better distribution on circle.
+            float32 rndRadiusNorm = std::sqrt(random.RandFloat()); // Better distribution on circle.
             curRadius = Lerp(innerRadius, curRadius, rndRadiusNorm);
         }
         float32 cosPhi = 0.0f;
@@ -1159,7 +1367,7 @@ void ParticleEffectSystem::PrepareEmitterParameters(Particle* particle, Particle
         float32 x = radTimesSinTheta * cosPhi;
         float32 y = radTimesSinTheta * sinPhi;
         float32 z = curRadius * std::cos(theta);
-        particle->position = Vector3(x, y, z);
+        position = Vector3(x, y, z);
     }
 
     //current emission vector and it's length
@@ -1180,11 +1388,11 @@ void ParticleEffectSystem::PrepareEmitterParameters(Particle* particle, Particle
     if ((isCircleEmitter && group.emitter->shockwaveMode != ParticleEmitter::SHOCKWAVE_DISABLED)
         || (isSphereEmitter && group.emitter->shockwaveMode == ParticleEmitter::SHOCKWAVE_NORMAL))
     {
-        particle->speed = particle->position;
-        float32 spl = particle->speed.SquareLength();
+        speed = position;
+        float32 spl = speed.SquareLength();
         if (spl > EPSILON)
         {
-            particle->speed *= currVelPower / std::sqrt(spl);
+            speed *= currVelPower / std::sqrt(spl);
         }
     }
     else if (isSphereEmitter && group.emitter->shockwaveMode == ParticleEmitter::SHOCKWAVE_HORIZONTAL)
@@ -1202,7 +1410,7 @@ void ParticleEffectSystem::PrepareEmitterParameters(Particle* particle, Particle
         else
             sinTheta = 1.0f; // theta = pi * 0.5
 
-        float32 phi = static_cast<float32>(GetEngineContext()->random->RandFloat()) * PI_2;
+        float32 phi = random.RandFloat() * PI_2;
         float32 cosPhi = 0.0f;
         float32 sinPhi = 0.0f;
         SinCosFast(phi, sinPhi, cosPhi);
@@ -1210,7 +1418,7 @@ void ParticleEffectSystem::PrepareEmitterParameters(Particle* particle, Particle
         Vector3 newVel;
         newVel = Vector3(cosPhi * sinTheta, sinPhi * sinTheta, cosTheta);
         newVel *= currVelPower;
-        particle->speed = newVel;
+        speed = newVel;
     }
     else
     {
@@ -1219,10 +1427,10 @@ void ParticleEffectSystem::PrepareEmitterParameters(Particle* particle, Particle
             float32 theta = ParticlesRandom::VanDerCorputRnd(ind, 3) * DegToRad(group.emitter->emissionRange->GetValue(group.time)) * 0.5f;
             float32 phi = ParticlesRandom::VanDerCorputRnd(ind, 4) * PI_2;
             float32 sinTheta = std::sin(theta);
-            particle->speed = Vector3(currVelPower * std::cos(phi) * sinTheta, currVelPower * std::sin(phi) * sinTheta, currVelPower * std::cos(theta));
+            speed = Vector3(currVelPower * std::cos(phi) * sinTheta, currVelPower * std::sin(phi) * sinTheta, currVelPower * std::cos(theta));
         }
         else
-            particle->speed = Vector3(0, 0, currVelPower);
+            speed = Vector3(0, 0, currVelPower);
     }
 
     //now transform position and speed by emissionVector and worldTransfrom rotations - preserving length
@@ -1233,19 +1441,19 @@ void ParticleEffectSystem::PrepareEmitterParameters(Particle* particle, Particle
     {
         if (currEmissionVector.z < 0)
         {
-            particle->position = particle->position * PIRotationAroundX;
+            position = position * PIRotationAroundX;
 
             if (!hasCustomEmissionVector)
-                particle->speed = particle->speed * PIRotationAroundX;
+                speed = speed * PIRotationAroundX;
         }
     }
     else
     {
         Matrix3 rotation = ParticleEffectSystemDetails::GenerateEmitterRotationMatrix(currEmissionVector, currEmissionPower);
-        particle->position = particle->position * rotation;
+        position = position * rotation;
 
         if (!hasCustomEmissionVector)
-            particle->speed = particle->speed * rotation;
+            speed = speed * rotation;
     }
 
     if (hasCustomEmissionVector)
@@ -1253,16 +1461,16 @@ void ParticleEffectSystem::PrepareEmitterParameters(Particle* particle, Particle
         if ((std::abs(currVelVector.x) < EPSILON) && (std::abs(currVelVector.y) < EPSILON))
         {
             if (currVelVector.z < 0)
-                particle->speed = particle->speed * PIRotationAroundX;
+                speed = speed * PIRotationAroundX;
         }
         else
         {
-            particle->speed = particle->speed * ParticleEffectSystemDetails::GenerateEmitterRotationMatrix(currVelVector, currVelPower);
+            speed = speed * ParticleEffectSystemDetails::GenerateEmitterRotationMatrix(currVelVector, currVelPower);
         }
     }
-    particle->position += group.spawnPosition;
-    TransformPerserveLength(particle->speed, newTransform);
-    TransformPerserveLength(particle->position, newTransform); //note - from now emitter position is not effected by scale anymore (artist request)
+    position += group.spawnPosition;
+    TransformPerserveLength(speed, newTransform);
+    TransformPerserveLength(position, newTransform); //note - from now emitter position is not effected by scale anymore (artist request)
 }
 
 void ParticleEffectSystem::SetGlobalExtertnalValue(const String& name, float32 value)
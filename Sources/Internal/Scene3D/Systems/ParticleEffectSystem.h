@@ -79,6 +79,10 @@ public:
     inline void SetAllowLodDegrade(bool allowDegrade);
     inline bool GetAllowLodDegrade() const;
 
+    /** Enable update of effects in worker threads, each effect is updated by one thread. Enabled by default. */
+    inline void SetParallelUpdateEnabled(bool enabled);
+    inline bool IsParallelUpdateEnabled() const;
+
     inline const Vector<std::pair<MaterialData, NMaterial*>>& GetMaterialInstances() const;
 
     void PrebuildMaterials(ParticleEffectComponent* component);
@@ -90,22 +94,68 @@ protected:
 
     void UpdateActiveLod(ParticleEffectComponent* effect);
     void UpdateEffect(ParticleEffectComponent* effect, float32 deltaTime, float32 shortEffectTime);
-    Particle* GenerateNewParticle(ParticleEffectComponent* effect, ParticleGroup& group, float32 currLoopTime, const Matrix4& worldTransform);
-    void UpdateRegularParticleData(ParticleEffectComponent* effect, Particle* particle, const ParticleGroup& group, float32 overLife, int32 simplifiedForcesCount, Vector<Vector3>& currSimplifiedForceValues, float32 dt, AABBox3& bbox, const Vector<ParticleForce*>& effectAlignForces, uint32 effectAlignForcesCount, const Vector<ParticleForce*>& worldAlignForces, uint32 worldAlignForcesCount, const Matrix4& world, const Matrix4& invWorld, float32 layerOverLife);
 
-    void PrepareEmitterParameters(Particle* particle, ParticleGroup& group, const Matrix4& worldTransform);
+    void PrepareEmitterParameters(ParticleGroup& group, const Matrix4& worldTransform, ParticlesRandom::Generator& random, Vector3& position, Vector3& speed);
     void AddParticleToBBox(const Vector3& position, float radius, AABBox3& bbox);
 
-    void RunEmitter(ParticleEffectComponent* effect, ParticleEmitter* emitter, const Vector3& spawnPosition, int32 positionSource = 0);
+    /** Start groups of emitter layers. If `deferMaterials` is set, materials are not acquired, groups are marked with `materialPending` instead. */
+    void RunEmitter(ParticleEffectComponent* effect, ParticleEmitter* emitter, const Vector3& spawnPosition, int32 positionSource = 0, bool deferMaterials = false);
 
 private:
-    void ApplyGlobalForces(Particle* particle, float32 dt, float32 overLife, float32 layerOverLife, Vector3 prevParticlePosition);
-    void UpdateStripe(Particle* particle, ParticleEffectData& effectData, ParticleGroup& group, float32 dt, AABBox3& bbox, const Vector<Vector3>& currForceValues, int32 forcesCount, bool isActive);
+    // Values shared by all particles of group during update
+    struct GroupUpdateContext
+    {
+        const Matrix4* world = nullptr;
+        Matrix4 invWorld;
+        float32 dt = 0.0f;
+        float32 layerOverLife = 0.0f;
+        Vector<Vector3> simplifiedForceValues;
+        Vector<ParticleForce*> effectAlignForces;
+        Vector<ParticleForce*> worldAlignForces;
+        Vector<Vector3> worldAlignForcePositions;
+    };
+
+    // Per-particle temporary values of group being updated
+    struct UpdateBuffers
+    {
+        Vector<float32> overLife;
+        Vector<float32> scale;
+        Vector<float32> accelerationX;
+        Vector<float32> accelerationY;
+        Vector<float32> accelerationZ;
+        Vector<float32> prevPositionX;
+        Vector<float32> prevPositionY;
+        Vector<float32> prevPositionZ;
+
+        void Resize(uint32 count);
+    };
+
+    // Temporary data of effect update. Effects updated concurrently use different contexts
+    struct EffectUpdateContext
+    {
+        GroupUpdateContext group;
+        UpdateBuffers buffers;
+        Vector<ParticleEffectComponent*> pendingMaterialEffects; // effects with groups started during update
+    };
+
+    void UpdateEffects(const Vector<ParticleEffectComponent*>& effects, float32 timeElapsed, float32 shortEffectTime);
+    void UpdateEffect(ParticleEffectComponent* effect, float32 deltaTime, float32 shortEffectTime, EffectUpdateContext& context);
+    uint32 GenerateNewParticle(ParticleEffectComponent* effect, ParticleGroup& group, float32 currLoopTime, const Matrix4& worldTransform, EffectUpdateContext& context);
+    NMaterial* AcquireLayerMaterial(ParticleLayer* layer);
+    void AcquirePendingMaterials(EffectUpdateContext& context);
+    void UpdateParticlesLife(ParticleGroup& group, float32 dt);
+    void UpdateRegularParticles(ParticleEffectComponent* effect, ParticleGroup& group, EffectUpdateContext& context, AABBox3& bbox);
+    void ApplyForces(ParticleGroup& group, EffectUpdateContext& context);
+    void ApplyGlobalForces(ParticlePool& particles, uint32 index, Vector3& position, Vector3& speed, float32 dt, float32 overLife, float32 layerOverLife, const Vector3& prevParticlePosition);
+    void UpdateStripe(const ParticlePool& particles, uint32 index, ParticleEffectData& effectData, ParticleGroup& group, float32 dt, AABBox3& bbox, const Vector<Vector3>& currForceValues, bool isActive);
     void SimulateEffect(ParticleEffectComponent* effect);
     void FillEmitterRadiuses(const ParticleGroup& group, float32& radius, float32& innerRadius);
 
     Map<String, float32> globalExternalValues;
     Vector<ParticleEffectComponent*> activeComponents;
+    Vector<ParticleEffectComponent*> updatedEffects;
+    Vector<ParticleEffectComponent*> completedEffects;
+    Vector<EffectUpdateContext> updateContexts;
 
     struct EffectGlobalForcesData
     {
@@ -123,6 +173,7 @@ private: //materials stuff
 
     bool allowLodDegrade;
     bool is2DMode;
+    bool parallelUpdateEnabled = true;
 };
 
 inline const Vector<std::pair<ParticleEffectSystem::MaterialData, NMaterial*>>& ParticleEffectSystem::GetMaterialInstances() const
@@ -139,4 +190,14 @@ inline bool ParticleEffectSystem::GetAllowLodDegrade() const
 {
     return allowLodDegrade;
 }
+
+inline void ParticleEffectSystem::SetParallelUpdateEnabled(bool enabled)
+{
+    parallelUpdateEnabled = enabled;
+}
+
+inline bool ParticleEffectSystem::IsParallelUpdateEnabled() const
+{
+    return parallelUpdateEnabled;
+}
 };
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include "Scene3D/Systems/Private/TransformStorage.h"
+
+#include "Debug/DVAssert.h"
+#include "Math/TransformUtils.h"
+#include "Scene3D/Components/AnimationComponent.h"
+#include "Scene3D/Components/ComponentHelpers.h"
+#include "Scene3D/Components/TransformComponent.h"
+#include "Scene3D/Entity.h"
+
+namespace DAVA
+{
+Transform TransformStorage::GetLocalTransform(TransformComponent* tc)
+{
+    AnimationComponent* animComp = GetAnimationComponent(tc->GetEntity());
+    if (animComp)
+    {
+        return Transform(animComp->animationTransform) * tc->GetLocalTransform();
+    }
+
+    return tc->GetLocalTransform();
+}
+
+void TransformStorage::Rebuild(Entity* root)
+{
+    Clear();
+
+    // pre-order traversal, so each parent is placed before its children
+    Vector<std::pair<Entity*, uint32>> stack;
+    stack.emplace_back(root, INVALID_INDEX);
+    while (!stack.empty())
+    {
+        Entity* entity = stack.back().first;
+        uint32 parentIndex = stack.back().second;
+        stack.pop_back();
+
+        TransformComponent* tc = entity->GetComponent<TransformComponent>();
+        uint32 index = GetSize();
+        tc->storageIndex = index;
+
+        components.push_back(tc);
+        localTransforms.push_back(GetLocalTransform(tc));
+        worldTransforms.push_back(tc->worldTransform);
+        parentIndices.push_back((tc->parentTransform != nullptr) ? parentIndex : INVALID_INDEX);
+        dirtyFlags.push_back(0);
+
+        for (int32 i = entity->GetChildrenCount() - 1; i >= 0; --i)
+        {
+            stack.emplace_back(entity->GetChild(i), index);
+        }
+    }
+}
+
+void TransformStorage::Clear()
+{
+    localTransforms.clear();
+    worldTransforms.clear();
+    parentIndices.clear();
+    dirtyFlags.clear();
+    components.clear();
+    firstDirtyIndex = INVALID_INDEX;
+}
+
+void TransformStorage::MarkAllDirty()
+{
+    if (!components.empty())
+    {
+        std::fill(dirtyFlags.begin(), dirtyFlags.end(), uint8(1));
+        firstDirtyIndex = 0;
+    }
+}
+
+void TransformStorage::MarkLocalChanged(uint32 index)
+{
+    DVASSERT(index < GetSize());
+
+    TransformComponent* tc = components[index];
+    localTransforms[index] = GetLocalTransform(tc);
+    if (parentIndices[index] == INVALID_INDEX)
+    {
+        // transform of the root is maintained by component itself
+        worldTransforms[index] = tc->worldTransform;
+    }
+
+    dirtyFlags[index] = 1;
+    firstDirtyIndex = Min(firstDirtyIndex, index);
+}
+
+void TransformStorage::Update(Vector<Entity*>& changedEntities)
+{
+    if (firstDirtyIndex == INVALID_INDEX)
+    {
+        return;
+    }
+
+    // Entries before the first dirty one are clean and their world transforms are final.
+    // Parent always goes before child, so when child is reached its parent is already updated.
+    uint32 size = GetSize();
+    for (uint32 i = firstDirtyIndex; i < size; ++i)
+    {
+        uint32 parentIndex = parentIndices[i];
+        if (parentIndex != INVALID_INDEX)
+        {
+            dirtyFlags[i] |= dirtyFlags[parentIndex];
+            if (dirtyFlags[i])
+            {
+                worldTransforms[i] = localTransforms[i] * worldTransforms[parentIndex];
+            }
+        }
+    }
+
+    for (uint32 i = firstDirtyIndex; i < size; ++i)
+    {
+        if (dirtyFlags[i] && parentIndices[i] != INVALID_INDEX)
+        {
+            TransformComponent* tc = components[i];
+            tc->worldTransform = worldTransforms[i];
+            tc->worldMatrix = TransformUtils::ToMatrix(worldTransforms[i]);
+            changedEntities.push_back(tc->GetEntity());
+        }
+    }
+
+    std::fill(dirtyFlags.begin() + firstDirtyIndex, dirtyFlags.end(), uint8(0));
+    firstDirtyIndex = INVALID_INDEX;
+}
+}
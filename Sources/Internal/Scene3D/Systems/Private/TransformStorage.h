@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+#include "Math/Transform.h"
+
+namespace DAVA
+{
+class Entity;
+class TransformComponent;
+
+/**
+    Scene-level storage of transforms in structure-of-arrays layout.
+    Entries are sorted in hierarchy order (parent always goes before its children), so world
+    transforms are recalculated by a single linear sweep without touching entities and components.
+    TransformComponent keeps index of its entry in the storage.
+*/
+class TransformStorage final
+{
+public:
+    static const uint32 INVALID_INDEX = static_cast<uint32>(-1);
+
+    /** Fill storage with all entities of hierarchy with root `root`. Entries are not marked dirty. */
+    void Rebuild(Entity* root);
+    void Clear();
+
+    void MarkAllDirty();
+
+    /** Reload local transform of entry `index` from its component and mark it dirty. */
+    void MarkLocalChanged(uint32 index);
+
+    /**
+        Recalculate world transforms of dirty entries and their descendants.
+        Components of changed entries are updated, their entities are appended to `changedEntities` in hierarchy order.
+    */
+    void Update(Vector<Entity*>& changedEntities);
+
+    uint32 GetSize() const;
+
+private:
+    static Transform GetLocalTransform(TransformComponent* tc);
+
+    Vector<Transform> localTransforms;
+    Vector<Transform> worldTransforms;
+    Vector<uint32> parentIndices;
+    Vector<uint8> dirtyFlags;
+    Vector<TransformComponent*> components;
+
+    uint32 firstDirtyIndex = INVALID_INDEX;
+};
+
+inline uint32 TransformStorage::GetSize() const
+{
+    return static_cast<uint32>(components.size());
+}
+}
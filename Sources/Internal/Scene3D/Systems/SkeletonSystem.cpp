@@ -3,6 +3,9 @@
 #include "Animation/AnimationTrack.h"
 #include "Debug/ProfilerCPU.h"
 #include "Debug/ProfilerMarkerNames.h"
+#include "Engine/Engine.h"
+#include "Engine/EngineContext.h"
+#include "Job/JobManager.h"
 #include "Render/Highlevel/SkinnedMesh.h"
 #include "Scene3D/Entity.h"
 #include "Scene3D/Components/ComponentHelpers.h"
@@ -16,6 +19,11 @@
 
 namespace DAVA
 {
+namespace SkeletonSystemDetails
+{
+const uint32 PARALLEL_MIN_SKELETONS_COUNT = 8;
+}
+
 SkeletonSystem::SkeletonSystem(Scene* scene)
     : SceneSystem(scene)
 {
@@ -72,6 +80,7 @@ void SkeletonSystem::Process(float32 timeElapsed)
     UpdateTestSkeletons();
 #endif
 
+    skeletonUpdates.clear();
     for (int32 i = 0, sz = static_cast<int32>(entities.size()); i < sz; ++i)
     {
         SkeletonComponent* component = GetSkeletonComponent(entities[i]);
@@ -85,16 +94,57 @@ void SkeletonSystem::Process(float32 timeElapsed)
 
             if (component->startJoint != SkeletonComponent::INVALID_JOINT_INDEX)
             {
-                UpdateJointTransforms(component);
+                SkeletonUpdate update;
+                update.skeleton = component;
+
                 RenderObject* ro = GetRenderObject(entities[i]);
                 if (ro != nullptr && (RenderObject::TYPE_SKINNED_MESH == ro->GetType()))
                 {
-                    UpdateSkinnedMesh(component, static_cast<SkinnedMesh*>(ro));
+                    update.skinnedMesh = static_cast<SkinnedMesh*>(ro);
                 }
+
+                skeletonUpdates.push_back(update);
+            }
+        }
+    }
+
+    //skeletons don't share data, so joints and skinned meshes are updated concurrently; render system is marked serially
+    uint32 updatesCount = static_cast<uint32>(skeletonUpdates.size());
+    JobManager* jobManager = GetEngineContext()->jobManager;
+    uint32 workersCount = (parallelUpdateEnabled && nullptr != jobManager) ? jobManager->GetWorkersCount() : 0;
+    if (workersCount > 0 && updatesCount >= SkeletonSystemDetails::PARALLEL_MIN_SKELETONS_COUNT)
+    {
+        jobManager->ParallelFor(0, updatesCount, [this](uint32 begin, uint32 end) {
+            for (uint32 i = begin; i < end; ++i)
+            {
+                UpdateJointTransforms(skeletonUpdates[i].skeleton);
+                if (skeletonUpdates[i].skinnedMesh != nullptr)
+                {
+                    UpdateSkinnedMeshData(skeletonUpdates[i].skeleton, skeletonUpdates[i].skinnedMesh);
+                }
+            }
+        });
+    }
+    else
+    {
+        for (const SkeletonUpdate& update : skeletonUpdates)
+        {
+            UpdateJointTransforms(update.skeleton);
+            if (update.skinnedMesh != nullptr)
+            {
+                UpdateSkinnedMeshData(update.skeleton, update.skinnedMesh);
             }
         }
     }
 
+    for (const SkeletonUpdate& update : skeletonUpdates)
+    {
+        if (update.skinnedMesh != nullptr)
+        {
+            GetScene()->GetRenderSystem()->MarkForUpdate(update.skinnedMesh);
+        }
+    }
+
     DrawSkeletons(GetScene()->renderSystem->GetDebugDrawer());
 }
 
@@ -183,6 +233,13 @@ void SkeletonSystem::UpdateJointTransforms(SkeletonComponent* skeleton)
 }
 
 void SkeletonSystem::UpdateSkinnedMesh(SkeletonComponent* skeleton, SkinnedMesh* skinnedMeshObject)
+{
+    UpdateSkinnedMeshData(skeleton, skinnedMeshObject);
+
+    GetScene()->GetRenderSystem()->MarkForUpdate(skinnedMeshObject);
+}
+
+void SkeletonSystem::UpdateSkinnedMeshData(SkeletonComponent* skeleton, SkinnedMesh* skinnedMeshObject)
 {
     DVASSERT(!skeleton->configUpdated);
 
@@ -199,8 +256,6 @@ void SkeletonSystem::UpdateSkinnedMesh(SkeletonComponent* skeleton, SkinnedMesh*
 
     skinnedMeshObject->UpdateJointTransforms(skeleton->finalTransforms);
     skinnedMeshObject->SetBoundingBox(resBox); //TODO: *Skinning* decide on bbox calculation
-
-    GetScene()->GetRenderSystem()->MarkForUpdate(skinnedMeshObject);
 }
 
 void SkeletonSystem::RebuildSkeleton(SkeletonComponent* skeleton)
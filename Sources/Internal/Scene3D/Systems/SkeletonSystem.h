@@ -27,16 +27,39 @@ public:
     void UpdateSkinnedMesh(SkeletonComponent* skeleton, SkinnedMesh* skinnedMeshObject);
     void DrawSkeletons(RenderHelper* drawer);
 
+    /** Enable update of joint transforms and skinned meshes in worker threads, each skeleton is updated by one thread. Enabled by default. */
+    void SetParallelUpdateEnabled(bool enabled);
+    bool IsParallelUpdateEnabled() const;
+
 private:
+    struct SkeletonUpdate
+    {
+        SkeletonComponent* skeleton = nullptr;
+        SkinnedMesh* skinnedMesh = nullptr;
+    };
+
     void UpdateJointTransforms(SkeletonComponent* skeleton);
+    void UpdateSkinnedMeshData(SkeletonComponent* skeleton, SkinnedMesh* skinnedMeshObject);
 
     void RebuildSkeleton(SkeletonComponent* skeleton);
 
     void UpdateTestSkeletons(float32 timeElapsed);
 
     Vector<Entity*> entities;
+    Vector<SkeletonUpdate> skeletonUpdates;
+    bool parallelUpdateEnabled = true;
 };
 
+inline void SkeletonSystem::SetParallelUpdateEnabled(bool enabled)
+{
+    parallelUpdateEnabled = enabled;
+}
+
+inline bool SkeletonSystem::IsParallelUpdateEnabled() const
+{
+    return parallelUpdateEnabled;
+}
+
 } //ns
 
 #endif
@@ -1,3 +1,4 @@
+#include "Entity/ComponentUtils.h"
 #include "Scene3D/Systems/EventSystem.h"
 #include "Scene3D/Entity.h"
 #include "Scene3D/Scene.h"
@@ -25,6 +26,9 @@ SoundUpdateSystem::AutoTriggerSound::AutoTriggerSound(Entity* _owner, SoundEvent
 SoundUpdateSystem::SoundUpdateSystem(Scene* scene)
     : SceneSystem(scene)
 {
+    // sound events are not thread-safe
+    SetComponentsAccess(ComponentUtils::MakeMask<TransformComponent>(), ComponentUtils::MakeMask<SoundComponent>(), true);
+
     scene->GetEventSystem()->RegisterSystemForEvent(this, EventSystem::SOUND_COMPONENT_CHANGED);
 }
 
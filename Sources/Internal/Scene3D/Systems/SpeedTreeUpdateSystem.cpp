@@ -1,9 +1,12 @@
 #include "SpeedTreeUpdateSystem.h"
+#include "Entity/ComponentUtils.h"
 #include "Scene3D/Entity.h"
 #include "Scene3D/Components/ComponentHelpers.h"
 #include "Scene3D/Components/RenderComponent.h"
 #include "Scene3D/Components/TransformComponent.h"
 #include "Scene3D/Components/SpeedTreeComponent.h"
+#include "Scene3D/Components/WaveComponent.h"
+#include "Scene3D/Components/WindComponent.h"
 #include "Scene3D/Components/SingleComponents/TransformSingleComponent.h"
 #include "Scene3D/Systems/WindSystem.h"
 #include "Scene3D/Systems/WaveSystem.h"
@@ -25,6 +28,9 @@ namespace DAVA
 SpeedTreeUpdateSystem::SpeedTreeUpdateSystem(Scene* scene)
     : SceneSystem(scene)
 {
+    // wind and wave forces are read from wind and wave systems, animation params are set to tree render objects
+    SetComponentsAccess(ComponentUtils::MakeMask<TransformComponent, WindComponent, WaveComponent>(), ComponentUtils::MakeMask<SpeedTreeComponent, RenderComponent>());
+
     RenderOptions* options = Renderer::GetOptions();
     options->AddObserver(this);
     isAnimationEnabled = options->IsOptionEnabled(RenderOptions::SPEEDTREE_ANIMATIONS);
@@ -36,7 +42,7 @@ SpeedTreeUpdateSystem::SpeedTreeUpdateSystem(Scene* scene)
 
 SpeedTreeUpdateSystem::~SpeedTreeUpdateSystem()
 {
-    DVASSERT(allTrees.size() == 0);
+    DVASSERT(allTrees.GetEntitiesCount() == 0);
 
     Renderer::GetOptions()->RemoveObserver(this);
 }
@@ -55,25 +61,29 @@ void SpeedTreeUpdateSystem::AddEntity(Entity* entity)
     SpeedTreeComponent* component = GetSpeedTreeComponent(entity);
     DVASSERT(component != nullptr);
     component->leafTime = static_cast<float32>(GetEngineContext()->random->RandFloat(1000.f));
-    allTrees.push_back(component);
+    allTrees.AddEntity(entity);
 }
 
 void SpeedTreeUpdateSystem::RemoveEntity(Entity* entity)
 {
-    uint32 treeCount = static_cast<uint32>(allTrees.size());
-    for (uint32 i = 0; i < treeCount; ++i)
-    {
-        if (allTrees[i]->entity == entity)
-        {
-            RemoveExchangingWithLast(allTrees, i);
-            break;
-        }
-    }
+    allTrees.RemoveEntity(entity);
+}
+
+void SpeedTreeUpdateSystem::RegisterComponent(Entity* entity, Component* component)
+{
+    SceneSystem::RegisterComponent(entity, component);
+    allTrees.MarkEntityChanged(entity);
+}
+
+void SpeedTreeUpdateSystem::UnregisterComponent(Entity* entity, Component* component)
+{
+    SceneSystem::UnregisterComponent(entity, component);
+    allTrees.MarkEntityChanged(entity);
 }
 
 void SpeedTreeUpdateSystem::PrepareForRemove()
 {
-    allTrees.clear();
+    allTrees.Clear();
 }
 
 void SpeedTreeUpdateSystem::UpdateAnimationFlag(Entity* entity)
@@ -116,15 +126,12 @@ void SpeedTreeUpdateSystem::Process(float32 timeElapsed)
     WaveSystem* waveSystem = GetScene()->waveSystem;
 
     //Update trees
-    uint32 treeCount = static_cast<uint32>(allTrees.size());
-    for (uint32 i = 0; i < treeCount; ++i)
-    {
-        SpeedTreeComponent* component = allTrees[i];
-        DVASSERT(GetRenderObject(component->GetEntity())->GetType() == RenderObject::TYPE_SPEED_TREE);
-        SpeedTreeObject* treeObject = static_cast<SpeedTreeObject*>(GetRenderObject(component->GetEntity()));
+    allTrees.ForEach<SpeedTreeComponent, RenderComponent>([windSystem, waveSystem, timeElapsed](Entity* entity, SpeedTreeComponent* component, RenderComponent* renderComponent) {
+        DVASSERT(renderComponent->GetRenderObject()->GetType() == RenderObject::TYPE_SPEED_TREE);
+        SpeedTreeObject* treeObject = static_cast<SpeedTreeObject*>(renderComponent->GetRenderObject());
 
         if (component->GetMaxAnimatedLOD() < treeObject->GetLodIndex())
-            continue;
+            return;
 
         const Vector3& treePosition = component->wtPosition;
         Vector3 wind3D = windSystem->GetWind(treePosition) + waveSystem->GetWaveDisturbance(treePosition);
@@ -151,7 +158,7 @@ void SpeedTreeUpdateSystem::Process(float32 timeElapsed)
 
         Vector2 localOffset = MultiplyVectorMat2x2(component->oscOffset * component->GetTrunkOscillationAmplitude(), component->wtInvMx);
         treeObject->SetTreeAnimationParams(localOffset, leafOscillationParams);
-    }
+    });
 }
 
 void SpeedTreeUpdateSystem::HandleEvent(Observable* observable)
@@ -162,27 +169,20 @@ void SpeedTreeUpdateSystem::HandleEvent(Observable* observable)
     {
         isAnimationEnabled = options->IsOptionEnabled(RenderOptions::SPEEDTREE_ANIMATIONS);
 
-        uint32 treeCount = static_cast<uint32>(allTrees.size());
-        for (uint32 i = 0; i < treeCount; ++i)
-        {
-            UpdateAnimationFlag(allTrees[i]->entity);
-        }
+        allTrees.ForEach<SpeedTreeComponent>([this](Entity* entity, SpeedTreeComponent* component) {
+            UpdateAnimationFlag(entity);
+        });
     }
 }
 
 void SpeedTreeUpdateSystem::SceneDidLoaded()
 {
-    for (auto tree : allTrees)
-    {
-        auto renderComponent = GetRenderComponent(tree->entity);
-        if (renderComponent != nullptr)
+    allTrees.ForEach<RenderComponent>([](Entity* entity, RenderComponent* renderComponent) {
+        RenderObject* ro = renderComponent->GetRenderObject();
+        if (ro != nullptr)
         {
-            auto ro = renderComponent->GetRenderObject();
-            if (ro != nullptr)
-            {
-                ro->RecalcBoundingBox();
-            }
+            ro->RecalcBoundingBox();
         }
-    }
+    });
 }
 };
\ No newline at end of file
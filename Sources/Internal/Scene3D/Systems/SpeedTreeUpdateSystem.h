@@ -4,6 +4,7 @@
 #include "Base/BaseTypes.h"
 #include "Base/BaseMath.h"
 #include "Base/Observer.h"
+#include "Entity/ArchetypeStorage.h"
 #include "Entity/SceneSystem.h"
 
 namespace DAVA
@@ -19,6 +20,8 @@ public:
 
     void AddEntity(Entity* entity) override;
     void RemoveEntity(Entity* entity) override;
+    void RegisterComponent(Entity* entity, Component* component) override;
+    void UnregisterComponent(Entity* entity, Component* component) override;
     void PrepareForRemove() override;
     void ImmediateEvent(Component* component, uint32 event) override;
     void Process(float32 timeElapsed) override;
@@ -31,7 +34,7 @@ protected:
     void UpdateAnimationFlag(Entity* entity);
 
 private:
-    Vector<SpeedTreeComponent*> allTrees;
+    ArchetypeStorage allTrees; ///< Tree entities with their speed tree and render components.
 
     bool isAnimationEnabled;
     bool isVegetationAnimationEnabled;
@@ -191,6 +191,7 @@ void StaticOcclusionBuildSystem::StartBuildOcclusion()
     if (nullptr == staticOcclusion)
         staticOcclusion = new StaticOcclusion();
 
+    staticOcclusion->SetSoftwareRasterizationEnabled(softwareRasterizationEnabled);
     staticOcclusion->StartBuildOcclusion(&data, GetScene()->GetRenderSystem(), landscape, occlusionComponent->GetOcclusionPixelThreshold(), occlusionComponent->GetOcclusionPixelThresholdForSpeedtree());
 }
 
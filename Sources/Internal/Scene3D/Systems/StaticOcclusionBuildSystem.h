@@ -32,6 +32,10 @@ public:
 
     void SetCamera(Camera* camera);
 
+    // Build occlusion with software rasterizer on CPU, without compiling shaders and rendering frames
+    void SetSoftwareRasterizationEnabled(bool enabled);
+    bool IsSoftwareRasterizationEnabled() const;
+
     void Build();
     void Cancel();
 
@@ -55,6 +59,7 @@ private:
     StaticOcclusionDataComponent* componentInProgress = nullptr;
     uint32 activeIndex = -1;
     uint32 objectsCount = 0;
+    bool softwareRasterizationEnabled = false;
 };
 
 inline void StaticOcclusionBuildSystem::SetCamera(Camera* _camera)
@@ -62,6 +67,16 @@ inline void StaticOcclusionBuildSystem::SetCamera(Camera* _camera)
     camera = _camera;
 }
 
+inline void StaticOcclusionBuildSystem::SetSoftwareRasterizationEnabled(bool enabled)
+{
+    softwareRasterizationEnabled = enabled;
+}
+
+inline bool StaticOcclusionBuildSystem::IsSoftwareRasterizationEnabled() const
+{
+    return softwareRasterizationEnabled;
+}
+
 } // ns
 
 #endif /* __DAVAENGINE_SCENE3D_STATIC_OCCLUSION_SYSTEM_H__ */
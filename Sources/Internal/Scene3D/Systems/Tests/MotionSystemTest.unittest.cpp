@@ -0,0 +1,302 @@
+#include "UnitTests/UnitTests.h"
+
+#include "Animation/AnimationChannelEncoder.h"
+#include "Animation/AnimationClip.h"
+#include "Animation/AnimationTrack.h"
+#include "Engine/Engine.h"
+#include "Engine/EngineContext.h"
+#include "FileSystem/File.h"
+#include "FileSystem/FileSystem.h"
+#include "Job/JobManager.h"
+#include "Logger/Logger.h"
+#include "Render/Highlevel/RenderObject.h"
+#include "Scene3D/Components/MotionComponent.h"
+#include "Scene3D/Components/RenderComponent.h"
+#include "Scene3D/Components/SingleComponents/MotionSingleComponent.h"
+#include "Scene3D/Components/SkeletonComponent.h"
+#include "Scene3D/Entity.h"
+#include "Scene3D/Scene.h"
+#include "Scene3D/Systems/MotionSystem.h"
+#include "Scene3D/Systems/SkeletonSystem.h"
+#include "Time/SystemTimer.h"
+#include "Utils/CRC32.h"
+
+namespace MotionSystemTestDetails
+{
+using namespace DAVA;
+
+// Benchmark scene settings
+const uint32 SKELETONS_COUNT = 500;
+const uint32 JOINTS_COUNT = 64;
+const uint32 FRAMES_COUNT = 30;
+const float32 FRAME_TIME = 1.0f / 30.0f;
+
+const uint32 KEYS_COUNT = 60;
+const float32 CLIP_DURATION = 2.0f;
+
+const uint32 SCENE_SYSTEMS = Scene::SCENE_SYSTEM_TRANSFORM_FLAG | Scene::SCENE_SYSTEM_MOTION_FLAG | Scene::SCENE_SYSTEM_SKELETON_FLAG;
+
+template <typename T>
+void Write(Vector<uint8>& data, const T& value)
+{
+    const uint8* bytes = reinterpret_cast<const uint8*>(&value);
+    data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+void WriteAlignedString(Vector<uint8>& data, const String& str)
+{
+    data.insert(data.end(), str.begin(), str.end());
+    data.push_back(0);
+    while (data.size() & 0x3)
+    {
+        data.push_back(0);
+    }
+}
+
+String GetJointUID(uint32 jointIndex)
+{
+    return Format("joint%u", jointIndex);
+}
+
+Vector<AnimationChannelEncoder::Key> CreateKeys(uint32 jointIndex, AnimationTrack::eChannelTarget target)
+{
+    Vector<AnimationChannelEncoder::Key> keys(KEYS_COUNT);
+    for (uint32 k = 0; k < KEYS_COUNT; ++k)
+    {
+        float32 t = CLIP_DURATION * k / (KEYS_COUNT - 1);
+        keys[k].time = t;
+        if (target == AnimationTrack::CHANNEL_TARGET_POSITION)
+        {
+            keys[k].value = { 0.f, 0.f, 1.f + 0.1f * std::sin(3.f * t + jointIndex), 0.f };
+        }
+        else
+        {
+            Quaternion q = Quaternion::MakeRotation(Vector3(0.f, 1.f, 0.f), 0.3f * std::sin(2.f * t + jointIndex));
+            keys[k].value = { q.x, q.y, q.z, q.w };
+        }
+    }
+    return keys;
+}
+
+// Write clip in format described in 'AnimationBinaryFormat.md'
+bool WriteClip(const FilePath& path)
+{
+    Vector<uint8> data;
+    Write(data, CLIP_DURATION);
+    Write(data, JOINTS_COUNT);
+    for (uint32 j = 0; j < JOINTS_COUNT; ++j)
+    {
+        WriteAlignedString(data, GetJointUID(j));
+        WriteAlignedString(data, GetJointUID(j));
+
+        Write(data, uint32(AnimationTrack::ANIMATION_TRACK_DATA_SIGNATURE));
+        Write(data, uint32(2));
+
+        Write(data, uint32(AnimationTrack::CHANNEL_TARGET_POSITION));
+        AnimationChannelEncoder::Encode(CreateKeys(j, AnimationTrack::CHANNEL_TARGET_POSITION), 3, AnimationChannel::INTERPOLATION_LINEAR, AnimationChannel::COMPRESSION_QUANTIZED, 0.0001f, data);
+
+        Write(data, uint32(AnimationTrack::CHANNEL_TARGET_ORIENTATION));
+        AnimationChannelEncoder::Encode(CreateKeys(j, AnimationTrack::CHANNEL_TARGET_ORIENTATION), 4, AnimationChannel::INTERPOLATION_SPHERICAL_LINEAR, AnimationChannel::COMPRESSION_SMALLEST_THREE, 0.0001f, data);
+    }
+    Write(data, uint32(0)); //markers count
+
+    AnimationClip::FileHeader header;
+    header.signature = AnimationClip::ANIMATION_CLIP_FILE_SIGNATURE;
+    header.version = 1;
+    header.crc32 = CRC32::ForBuffer(data);
+    header.dataSize = uint32(data.size());
+
+    FileSystem::Instance()->CreateDirectory(path.GetDirectory(), true);
+    ScopedPtr<File> file(File::Create(path, File::CREATE | File::WRITE));
+    return file && file->Write(&header) == sizeof(header) && file->Write(data.data(), header.dataSize) == header.dataSize;
+}
+
+Vector<SkeletonComponent::Joint> CreateJoints()
+{
+    Vector<SkeletonComponent::Joint> joints(JOINTS_COUNT);
+    for (uint32 j = 0; j < JOINTS_COUNT; ++j)
+    {
+        joints[j].uid = FastName(GetJointUID(j));
+        joints[j].name = joints[j].uid;
+        joints[j].parentIndex = (j == 0) ? SkeletonComponent::INVALID_JOINT_INDEX : j - 1;
+    }
+    return joints;
+}
+
+// Skeletons play the clip with different rates, hidden skeletons have render object without VISIBLE flag
+Vector<SkeletonComponent*> AddSkeletons(Scene* scene, const FilePath& clipPath, uint32 count, bool hidden)
+{
+    Vector<SkeletonComponent*> skeletons;
+    for (uint32 i = 0; i < count; ++i)
+    {
+        ScopedPtr<Entity> entity(new Entity());
+
+        SkeletonComponent* skeleton = new SkeletonComponent();
+        skeleton->SetJoints(CreateJoints());
+        entity->AddComponent(skeleton);
+        skeletons.push_back(skeleton);
+
+        MotionComponent* motion = new MotionComponent();
+        motion->SetDescriptorPath(clipPath);
+        motion->SetPlaybackRate(1.0f + 0.01f * i);
+        entity->AddComponent(motion);
+
+        if (hidden)
+        {
+            ScopedPtr<RenderObject> renderObject(new RenderObject());
+            renderObject->RemoveFlag(RenderObject::VISIBLE);
+            entity->AddComponent(new RenderComponent(renderObject));
+        }
+
+        scene->AddNode(entity);
+        scene->motionSingleComponent->startSimpleMotion.push_back(motion);
+    }
+    return skeletons;
+}
+
+Vector<JointTransform> GetObjectSpaceTransforms(const Vector<SkeletonComponent*>& skeletons)
+{
+    Vector<JointTransform> transforms;
+    for (SkeletonComponent* skeleton : skeletons)
+    {
+        for (uint32 j = 0; j < skeleton->GetJointsCount(); ++j)
+        {
+            transforms.push_back(skeleton->GetJointObjectSpaceTransform(j));
+        }
+    }
+    return transforms;
+}
+
+bool IsEqual(const Vector<JointTransform>& transforms0, const Vector<JointTransform>& transforms1, float32 epsilon)
+{
+    if (transforms0.size() != transforms1.size())
+        return false;
+
+    for (size_t i = 0; i < transforms0.size(); ++i)
+    {
+        const JointTransform& t0 = transforms0[i];
+        const JointTransform& t1 = transforms1[i];
+        for (uint32 k = 0; k < 4; ++k)
+        {
+            if (Abs(t0.GetOrientation().data[k] - t1.GetOrientation().data[k]) > epsilon)
+                return false;
+        }
+        if ((t0.GetPosition() - t1.GetPosition()).Length() > epsilon || Abs(t0.GetScale() - t1.GetScale()) > epsilon)
+            return false;
+    }
+    return true;
+}
+}
+
+DAVA_TESTCLASS (MotionSystemTest)
+{
+    DAVA_TEST (ParallelUpdateMatchesSerial)
+    {
+        using namespace DAVA;
+        using namespace MotionSystemTestDetails;
+
+        FilePath clipPath("~doc:/TestData/MotionSystemTest/clip.anim");
+        TEST_VERIFY(WriteClip(clipPath));
+
+        // skeletons don't share mutable data, so the result doesn't depend on threads scheduling
+        Vector<JointTransform> results[2];
+        for (bool parallelUpdate : { false, true })
+        {
+            ScopedPtr<Scene> scene(new Scene(SCENE_SYSTEMS));
+            scene->motionSystem->SetParallelUpdateEnabled(parallelUpdate);
+            scene->skeletonSystem->SetParallelUpdateEnabled(parallelUpdate);
+
+            Vector<SkeletonComponent*> skeletons = AddSkeletons(scene, clipPath, 32, false);
+            for (uint32 frame = 0; frame < 10; ++frame)
+            {
+                scene->Update(FRAME_TIME);
+            }
+            results[parallelUpdate ? 1 : 0] = GetObjectSpaceTransforms(skeletons);
+        }
+        TEST_VERIFY(!results[0].empty());
+        TEST_VERIFY(IsEqual(results[0], results[1], 0.0f));
+
+        FileSystem::Instance()->DeleteFile(clipPath);
+    }
+
+    DAVA_TEST (ThrottledUpdateKeepsTime)
+    {
+        using namespace DAVA;
+        using namespace MotionSystemTestDetails;
+
+        FilePath clipPath("~doc:/TestData/MotionSystemTest/clip.anim");
+        TEST_VERIFY(WriteClip(clipPath));
+
+        ScopedPtr<Scene> scene(new Scene(SCENE_SYSTEMS));
+        Vector<SkeletonComponent*> skeletons = AddSkeletons(scene, clipPath, 4, true);
+
+        ScopedPtr<Scene> throttledScene(new Scene(SCENE_SYSTEMS));
+        throttledScene->motionSystem->SetUpdateThrottleEnabled(true);
+        Vector<SkeletonComponent*> throttledSkeletons = AddSkeletons(throttledScene, clipPath, 4, true);
+
+        // invisible skeletons are updated every eighth frame with time of all skipped frames
+        scene->Update(FRAME_TIME);
+        throttledScene->Update(FRAME_TIME);
+        Vector<JointTransform> skippedPose = GetObjectSpaceTransforms(throttledSkeletons);
+        for (uint32 frame = 1; frame < 7; ++frame)
+        {
+            scene->Update(FRAME_TIME);
+            throttledScene->Update(FRAME_TIME);
+        }
+        TEST_VERIFY(IsEqual(skippedPose, GetObjectSpaceTransforms(throttledSkeletons), 0.0f));
+        TEST_VERIFY(!IsEqual(GetObjectSpaceTransforms(skeletons), GetObjectSpaceTransforms(throttledSkeletons), 1e-4f));
+
+        scene->Update(FRAME_TIME);
+        throttledScene->Update(FRAME_TIME);
+        TEST_VERIFY(IsEqual(GetObjectSpaceTransforms(skeletons), GetObjectSpaceTransforms(throttledSkeletons), 1e-4f));
+
+        FileSystem::Instance()->DeleteFile(clipPath);
+    }
+
+    DAVA_TEST (UpdateBenchmark)
+    {
+        using namespace DAVA;
+        using namespace MotionSystemTestDetails;
+
+        FilePath clipPath("~doc:/TestData/MotionSystemTest/clip.anim");
+        TEST_VERIFY(WriteClip(clipPath));
+
+        JobManager* jobManager = GetEngineContext()->jobManager;
+        uint32 workersCount = (jobManager != nullptr) ? jobManager->GetWorkersCount() : 0;
+
+        struct BenchmarkSettings
+        {
+            const char* name;
+            bool parallelUpdate;
+            bool throttledUpdate;
+        };
+        const BenchmarkSettings benchmarks[] = {
+            { "serial", false, false },
+            { "parallel", true, false },
+            { "parallel throttled (invisible)", true, true },
+        };
+
+        for (const BenchmarkSettings& settings : benchmarks)
+        {
+            ScopedPtr<Scene> scene(new Scene(SCENE_SYSTEMS));
+            scene->motionSystem->SetParallelUpdateEnabled(settings.parallelUpdate);
+            scene->motionSystem->SetUpdateThrottleEnabled(settings.throttledUpdate);
+            scene->skeletonSystem->SetParallelUpdateEnabled(settings.parallelUpdate);
+
+            AddSkeletons(scene, clipPath, SKELETONS_COUNT, settings.throttledUpdate);
+            scene->Update(FRAME_TIME);
+
+            int64 startTime = SystemTimer::GetUs();
+            for (uint32 frame = 0; frame < FRAMES_COUNT; ++frame)
+            {
+                scene->Update(FRAME_TIME);
+            }
+            int64 frameTime = (SystemTimer::GetUs() - startTime) / FRAMES_COUNT;
+
+            Logger::Info("MotionSystem and SkeletonSystem %s update of %u skeletons with %u joints (%u workers): %lld us per frame, %.2f us per skeleton",
+                         settings.name, SKELETONS_COUNT, JOINTS_COUNT, workersCount, frameTime, float32(frameTime) / SKELETONS_COUNT);
+        }
+
+        FileSystem::Instance()->DeleteFile(clipPath);
+    }
+};
@@ -0,0 +1,272 @@
+#include "UnitTests/UnitTests.h"
+
+#include "Base/RefPtr.h"
+#include "Logger/Logger.h"
+#include "Particles/ParticleEmitter.h"
+#include "Particles/ParticleForce.h"
+#include "Particles/ParticleForceSimplified.h"
+#include "Particles/ParticleLayer.h"
+#include "Particles/ParticlePool.h"
+#include "Scene3D/Scene.h"
+#include "Scene3D/Entity.h"
+#include "Scene3D/Components/ParticleEffectComponent.h"
+#include "Scene3D/Components/TransformComponent.h"
+#include "Scene3D/Systems/ParticleEffectSystem.h"
+#include "Time/SystemTimer.h"
+#include "Utils/Random.h"
+
+#include <random>
+
+namespace ParticleEffectSystemTestDetails
+{
+using namespace DAVA;
+
+// Benchmark scene settings
+const uint32 EFFECTS_COUNT = 200;
+const uint32 FRAMES_COUNT = 60;
+const float32 FRAME_TIME = 1.0f / 30.0f;
+
+// Kernels are checked on arrays, which size is not multiple of SIMD width, so scalar tail is covered too
+const uint32 KERNEL_ARRAY_SIZE = 1023;
+
+Vector<float32> CreateRandomArray(std::mt19937& random, uint32 size, float32 minValue, float32 maxValue)
+{
+    std::uniform_real_distribution<float32> distribution(minValue, maxValue);
+    Vector<float32> values(size);
+    for (float32& value : values)
+    {
+        value = distribution(random);
+    }
+    return values;
+}
+
+template <typename T>
+RefPtr<PropertyLine<T>> CreateValueLine(const T& value)
+{
+    return RefPtr<PropertyLine<T>>(new PropertyLineValue<T>(value));
+}
+
+template <typename T>
+RefPtr<PropertyLine<T>> CreateKeyframesLine(const T& startValue, const T& endValue)
+{
+    PropertyLineKeyframes<T>* line = new PropertyLineKeyframes<T>();
+    line->AddValue(0.0f, startValue);
+    line->AddValue(1.0f, endValue);
+    return RefPtr<PropertyLine<T>>(line);
+}
+
+ParticleEmitter* CreateEmitter()
+{
+    ParticleEmitter* emitter = new ParticleEmitter();
+    emitter->lifeTime = 100.0f;
+
+    ScopedPtr<ParticleLayer> layer(new ParticleLayer());
+    layer->life = CreateValueLine(2.0f);
+    layer->number = CreateValueLine(100.0f);
+    layer->velocity = CreateValueLine(5.0f);
+    layer->velocityOverLife = CreateKeyframesLine(1.0f, 0.2f);
+    layer->spin = CreateValueLine(1.0f);
+    layer->size = CreateValueLine(Vector2(1.0f, 1.0f));
+    layer->sizeOverLifeXY = CreateKeyframesLine(Vector2(1.0f, 1.0f), Vector2(2.0f, 0.5f));
+    layer->AddSimplifiedForce(new ParticleForceSimplified(CreateValueLine(Vector3(0.0f, 0.0f, -9.8f)), CreateKeyframesLine(1.0f, 0.0f)));
+
+    ScopedPtr<ParticleForce> drag(new ParticleForce(layer));
+    drag->type = ParticleForce::eType::DRAG_FORCE;
+    drag->forcePower = Vector3(0.5f, 0.5f, 0.5f);
+    layer->AddForce(drag);
+
+    emitter->AddLayer(layer);
+    return emitter;
+}
+
+void AddEffects(Scene* scene, uint32 count, Vector<ParticleEffectComponent*>& effects)
+{
+    for (uint32 i = 0; i < count; ++i)
+    {
+        ScopedPtr<Entity> entity(new Entity());
+        entity->GetComponent<TransformComponent>()->SetLocalTranslation(Vector3(static_cast<float32>(i % 20), static_cast<float32>(i / 20), 0.0f));
+
+        ParticleEffectComponent* effect = new ParticleEffectComponent();
+        ScopedPtr<ParticleEmitter> emitter(CreateEmitter());
+        effect->AddEmitterInstance(emitter);
+        entity->AddComponent(effect);
+
+        scene->AddNode(entity);
+        effects.push_back(effect);
+    }
+}
+
+// Simulate effects and return particles count and bounding box corners of each effect
+Vector<Vector3> SimulateEffects(bool parallelUpdate, uint32 framesCount)
+{
+    ScopedPtr<Scene> scene(new Scene(Scene::SCENE_SYSTEM_TRANSFORM_FLAG | Scene::SCENE_SYSTEM_PARTICLE_EFFECT_FLAG));
+    scene->particleEffectSystem->SetParallelUpdateEnabled(parallelUpdate);
+
+    Vector<ParticleEffectComponent*> effects;
+    AddEffects(scene, EFFECTS_COUNT, effects);
+
+    Random::Instance()->Seed(4321);
+    for (ParticleEffectComponent* effect : effects)
+    {
+        effect->Start();
+    }
+    for (uint32 frame = 0; frame < framesCount; ++frame)
+    {
+        scene->Update(FRAME_TIME);
+    }
+
+    Vector<Vector3> result;
+    for (ParticleEffectComponent* effect : effects)
+    {
+        const AABBox3& bbox = effect->GetRenderObject()->GetBoundingBox();
+        result.emplace_back(static_cast<float32>(effect->GetActiveParticlesCount()), 0.0f, 0.0f);
+        result.push_back(bbox.min);
+        result.push_back(bbox.max);
+    }
+    return result;
+}
+}
+
+DAVA_TESTCLASS (ParticleEffectSystemTest)
+{
+    DAVA_TEST (KernelsMatchScalarCode)
+    {
+        using namespace DAVA;
+        using namespace ParticleEffectSystemTestDetails;
+
+        std::mt19937 random(1234);
+        Vector<float32> values = CreateRandomArray(random, KERNEL_ARRAY_SIZE, -10.0f, 10.0f);
+        Vector<float32> deltas = CreateRandomArray(random, KERNEL_ARRAY_SIZE, -10.0f, 10.0f);
+        Vector<float32> scales = CreateRandomArray(random, KERNEL_ARRAY_SIZE, 0.1f, 2.0f);
+
+        Vector<float32> result = values;
+        ParticleKernels::Add(result.data(), 0.5f, KERNEL_ARRAY_SIZE);
+        bool equal = true;
+        for (uint32 i = 0; i < KERNEL_ARRAY_SIZE; ++i)
+        {
+            equal &= FLOAT_EQUAL(result[i], values[i] + 0.5f);
+        }
+        TEST_VERIFY(equal);
+
+        result = values;
+        ParticleKernels::MultiplyAdd(result.data(), deltas.data(), FRAME_TIME, KERNEL_ARRAY_SIZE);
+        equal = true;
+        for (uint32 i = 0; i < KERNEL_ARRAY_SIZE; ++i)
+        {
+            equal &= FLOAT_EQUAL(result[i], values[i] + deltas[i] * FRAME_TIME);
+        }
+        TEST_VERIFY(equal);
+
+        result = values;
+        ParticleKernels::MultiplyAdd(result.data(), deltas.data(), scales.data(), KERNEL_ARRAY_SIZE);
+        equal = true;
+        for (uint32 i = 0; i < KERNEL_ARRAY_SIZE; ++i)
+        {
+            equal &= FLOAT_EQUAL(result[i], values[i] + deltas[i] * scales[i]);
+        }
+        TEST_VERIFY(equal);
+
+        ParticleKernels::Divide(result.data(), values.data(), scales.data(), KERNEL_ARRAY_SIZE);
+        equal = true;
+        for (uint32 i = 0; i < KERNEL_ARRAY_SIZE; ++i)
+        {
+            equal &= FLOAT_EQUAL(result[i], values[i] / scales[i]);
+        }
+        TEST_VERIFY(equal);
+
+        for (uint32 count : { 1u, 4u, 5u, KERNEL_ARRAY_SIZE })
+        {
+            AABBox3 bbox;
+            ParticleKernels::AddCubesToBox(values.data(), deltas.data(), scales.data(), scales.data(), count, bbox);
+
+            AABBox3 expectedBox;
+            for (uint32 i = 0; i < count; ++i)
+            {
+                Vector3 center(values[i], deltas[i], scales[i]);
+                Vector3 halfSize(scales[i], scales[i], scales[i]);
+                expectedBox.AddPoint(center - halfSize);
+                expectedBox.AddPoint(center + halfSize);
+            }
+            TEST_VERIFY(bbox.min == expectedBox.min && bbox.max == expectedBox.max);
+        }
+    }
+
+    DAVA_TEST (PoolRemovesBySwap)
+    {
+        using namespace DAVA;
+
+        ParticlePool pool;
+        TEST_VERIFY(pool.IsEmpty());
+
+        for (uint32 i = 0; i < 4; ++i)
+        {
+            uint32 index = pool.Add();
+            TEST_VERIFY(index == i);
+            pool.SetPosition(index, Vector3(static_cast<float32>(i), 0.0f, 0.0f));
+            pool.life[index] = 0.0f;
+            pool.lifeTime[index] = 1.0f;
+        }
+        TEST_VERIFY(pool.GetCount() == 4);
+        TEST_VERIFY(pool.positionX.size() == 4 && pool.seed.size() == 4);
+
+        // the last particle takes place of removed one
+        pool.Remove(1);
+        TEST_VERIFY(pool.GetCount() == 3);
+        TEST_VERIFY(pool.GetPosition(1) == Vector3(3.0f, 0.0f, 0.0f));
+        TEST_VERIFY(pool.GetPosition(2) == Vector3(2.0f, 0.0f, 0.0f));
+
+        pool.Kill(0);
+        TEST_VERIFY(pool.life[0] > pool.lifeTime[0]);
+
+        pool.Clear();
+        TEST_VERIFY(pool.IsEmpty() && pool.positionX.empty());
+    }
+
+    DAVA_TEST (ParallelUpdateMatchesSerial)
+    {
+        using namespace DAVA;
+        using namespace ParticleEffectSystemTestDetails;
+
+        // each effect takes random values from its own generator, so result doesn't depend on threads scheduling
+        Vector<Vector3> serialResult = SimulateEffects(false, 10);
+        Vector<Vector3> parallelResult = SimulateEffects(true, 10);
+        TEST_VERIFY(serialResult[0].x > 0.0f);
+        TEST_VERIFY(serialResult == parallelResult);
+    }
+
+    DAVA_TEST (UpdateBenchmark)
+    {
+        using namespace DAVA;
+        using namespace ParticleEffectSystemTestDetails;
+
+        for (bool parallelUpdate : { false, true })
+        {
+            ScopedPtr<Scene> scene(new Scene(Scene::SCENE_SYSTEM_TRANSFORM_FLAG | Scene::SCENE_SYSTEM_PARTICLE_EFFECT_FLAG));
+            scene->particleEffectSystem->SetParallelUpdateEnabled(parallelUpdate);
+
+            Vector<ParticleEffectComponent*> effects;
+            AddEffects(scene, EFFECTS_COUNT, effects);
+            for (ParticleEffectComponent* effect : effects)
+            {
+                effect->Start();
+            }
+
+            int64 startTime = SystemTimer::GetUs();
+            for (uint32 frame = 0; frame < FRAMES_COUNT; ++frame)
+            {
+                scene->Update(FRAME_TIME);
+            }
+            int64 frameTime = (SystemTimer::GetUs() - startTime) / FRAMES_COUNT;
+
+            int32 particlesCount = 0;
+            for (ParticleEffectComponent* effect : effects)
+            {
+                particlesCount += effect->GetActiveParticlesCount();
+            }
+            TEST_VERIFY(particlesCount > 0);
+
+            Logger::Info("ParticleEffectSystem %s update of %u effects with %d particles: %lld us per frame",
+                         parallelUpdate ? "parallel" : "serial", EFFECTS_COUNT, particlesCount, frameTime);
+        }
+    }
+};
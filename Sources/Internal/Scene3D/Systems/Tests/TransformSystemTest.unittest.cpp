@@ -0,0 +1,208 @@
+#include "UnitTests/UnitTests.h"
+
+#include "Base/RefPtr.h"
+#include "Logger/Logger.h"
+#include "Math/Transform.h"
+#include "Scene3D/Scene.h"
+#include "Scene3D/Entity.h"
+#include "Scene3D/Components/TransformComponent.h"
+#include "Scene3D/Components/SingleComponents/TransformSingleComponent.h"
+#include "Scene3D/Systems/TransformSystem.h"
+#include "Time/SystemTimer.h"
+
+namespace TransformSystemTestDetails
+{
+using namespace DAVA;
+
+// Benchmark scene settings: total count of entities and depth of hierarchy
+const uint32 ENTITIES_COUNT = 30000;
+const uint32 HIERARCHY_DEPTH = 6;
+const uint32 FRAMES_COUNT = 20;
+const uint32 LINEAR_ENTITIES_COUNT = 100000;
+
+/*
+    Build b-ary forest with `count` entities and approximately `depth` levels.
+    First `b` entities are attached to the scene, parent of entity `i` is entity `(i - b) / b`.
+*/
+void BuildHierarchy(Scene* scene, uint32 count, uint32 depth, Vector<Entity*>& entities)
+{
+    uint32 branching = Max(2u, static_cast<uint32>(std::ceil(std::pow(static_cast<float64>(count), 1.0 / depth))));
+
+    entities.reserve(count);
+    for (uint32 i = 0; i < count; ++i)
+    {
+        ScopedPtr<Entity> entity(new Entity());
+
+        TransformComponent* tc = entity->GetComponent<TransformComponent>();
+        tc->SetLocalTranslation(Vector3(static_cast<float32>(i % 17), static_cast<float32>(i % 5), 1.0f));
+        tc->SetLocalRotation(Quaternion::MakeRotation(Vector3::UnitZ, 0.01f * static_cast<float32>(i % 31)));
+
+        Entity* parent = (i < branching) ? scene : entities[(i - branching) / branching];
+        parent->AddNode(entity);
+        entities.push_back(entity);
+    }
+}
+
+void MoveRoots(Scene* scene, float32 offset)
+{
+    for (int32 i = 0; i < scene->GetChildrenCount(); ++i)
+    {
+        TransformComponent* tc = scene->GetChild(i)->GetComponent<TransformComponent>();
+        tc->SetLocalTranslation(Vector3(offset, static_cast<float32>(i), 0.0f));
+    }
+}
+
+void MoveEveryNth(const Vector<Entity*>& entities, uint32 n, float32 offset)
+{
+    for (size_t i = 0; i < entities.size(); i += n)
+    {
+        TransformComponent* tc = entities[i]->GetComponent<TransformComponent>();
+        tc->SetLocalTranslation(Vector3(offset, static_cast<float32>(i % 13), 0.0f));
+    }
+}
+
+void ProcessTransforms(Scene* scene)
+{
+    scene->transformSystem->Process(0.0f);
+    scene->transformSingleComponent->Clear();
+}
+}
+
+DAVA_TESTCLASS (TransformSystemTest)
+{
+    DAVA_TEST (ParallelUpdateMatchesSerial)
+    {
+        using namespace DAVA;
+        using namespace TransformSystemTestDetails;
+
+        ScopedPtr<Scene> serialScene(new Scene());
+        ScopedPtr<Scene> parallelScene(new Scene());
+        serialScene->transformSystem->SetParallelUpdateEnabled(false);
+        parallelScene->transformSystem->SetParallelUpdateEnabled(true);
+
+        Vector<Entity*> serialEntities;
+        Vector<Entity*> parallelEntities;
+        BuildHierarchy(serialScene, 5000, 5, serialEntities);
+        BuildHierarchy(parallelScene, 5000, 5, parallelEntities);
+
+        for (uint32 frame = 0; frame < 3; ++frame)
+        {
+            MoveRoots(serialScene, static_cast<float32>(frame));
+            MoveRoots(parallelScene, static_cast<float32>(frame));
+            ProcessTransforms(serialScene);
+            ProcessTransforms(parallelScene);
+
+            bool equal = true;
+            for (size_t i = 0; i < serialEntities.size(); ++i)
+            {
+                const Transform& serialTransform = serialEntities[i]->GetComponent<TransformComponent>()->GetWorldTransform();
+                const Transform& parallelTransform = parallelEntities[i]->GetComponent<TransformComponent>()->GetWorldTransform();
+                equal &= (serialTransform == parallelTransform);
+            }
+            TEST_VERIFY(equal);
+        }
+    }
+
+    DAVA_TEST (ParallelUpdateBenchmark)
+    {
+        using namespace DAVA;
+        using namespace TransformSystemTestDetails;
+
+        for (bool parallel : { false, true })
+        {
+            ScopedPtr<Scene> scene(new Scene());
+            scene->transformSystem->SetParallelUpdateEnabled(parallel);
+
+            Vector<Entity*> entities;
+            BuildHierarchy(scene, ENTITIES_COUNT, HIERARCHY_DEPTH, entities);
+            ProcessTransforms(scene);
+
+            int64 startTime = SystemTimer::GetUs();
+            for (uint32 frame = 0; frame < FRAMES_COUNT; ++frame)
+            {
+                MoveRoots(scene, static_cast<float32>(frame));
+                ProcessTransforms(scene);
+            }
+            int64 frameTime = (SystemTimer::GetUs() - startTime) / FRAMES_COUNT;
+
+            Logger::Info("TransformSystem %s update of %u entities (depth %u): %lld us per frame",
+                         parallel ? "parallel" : "serial", ENTITIES_COUNT, HIERARCHY_DEPTH, frameTime);
+        }
+    }
+
+    DAVA_TEST (LinearUpdateMatchesHierarchical)
+    {
+        using namespace DAVA;
+        using namespace TransformSystemTestDetails;
+
+        ScopedPtr<Scene> hierarchicalScene(new Scene());
+        ScopedPtr<Scene> linearScene(new Scene());
+        linearScene->transformSystem->SetLinearUpdateEnabled(true);
+
+        Vector<Entity*> hierarchicalEntities;
+        Vector<Entity*> linearEntities;
+        BuildHierarchy(hierarchicalScene, 5000, 5, hierarchicalEntities);
+        BuildHierarchy(linearScene, 5000, 5, linearEntities);
+
+        for (uint32 frame = 0; frame < 4; ++frame)
+        {
+            if (frame == 2)
+            {
+                // change hierarchy to force rebuild of storage
+                hierarchicalEntities[100]->AddNode(hierarchicalEntities[4000]);
+                linearEntities[100]->AddNode(linearEntities[4000]);
+            }
+
+            MoveEveryNth(hierarchicalEntities, 7, static_cast<float32>(frame));
+            MoveEveryNth(linearEntities, 7, static_cast<float32>(frame));
+            ProcessTransforms(hierarchicalScene);
+            ProcessTransforms(linearScene);
+
+            bool equal = true;
+            for (size_t i = 0; i < hierarchicalEntities.size(); ++i)
+            {
+                const Transform& hierarchicalTransform = hierarchicalEntities[i]->GetComponent<TransformComponent>()->GetWorldTransform();
+                const Transform& linearTransform = linearEntities[i]->GetComponent<TransformComponent>()->GetWorldTransform();
+                equal &= (hierarchicalTransform == linearTransform);
+            }
+            TEST_VERIFY(equal);
+        }
+    }
+
+    DAVA_TEST (LinearUpdateBenchmark)
+    {
+        using namespace DAVA;
+        using namespace TransformSystemTestDetails;
+
+        // before: hierarchical serial update, after: linear sweep over TransformStorage
+        for (bool linear : { false, true })
+        {
+            ScopedPtr<Scene> scene(new Scene());
+            scene->transformSystem->SetParallelUpdateEnabled(false);
+            scene->transformSystem->SetLinearUpdateEnabled(linear);
+
+            Vector<Entity*> entities;
+            BuildHierarchy(scene, LINEAR_ENTITIES_COUNT, HIERARCHY_DEPTH, entities);
+            ProcessTransforms(scene);
+
+            int64 startTime = SystemTimer::GetUs();
+            for (uint32 frame = 0; frame < FRAMES_COUNT; ++frame)
+            {
+                MoveRoots(scene, static_cast<float32>(frame));
+                ProcessTransforms(scene);
+            }
+            int64 allMovedTime = (SystemTimer::GetUs() - startTime) / FRAMES_COUNT;
+
+            startTime = SystemTimer::GetUs();
+            for (uint32 frame = 0; frame < FRAMES_COUNT; ++frame)
+            {
+                MoveEveryNth(entities, 10, static_cast<float32>(frame));
+                ProcessTransforms(scene);
+            }
+            int64 partMovedTime = (SystemTimer::GetUs() - startTime) / FRAMES_COUNT;
+
+            Logger::Info("TransformSystem %s update of %u entities: %lld us per frame with all moved, %lld us with every 10th moved",
+                         linear ? "linear" : "hierarchical", LINEAR_ENTITIES_COUNT, allMovedTime, partMovedTime);
+        }
+    }
+};
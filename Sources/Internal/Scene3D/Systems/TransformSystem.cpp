@@ -1,26 +1,50 @@
 #include "Debug/DVAssert.h"
 #include "Debug/ProfilerCPU.h"
 #include "Debug/ProfilerMarkerNames.h"
+#include "Engine/Engine.h"
+#include "Engine/EngineContext.h"
+#include "Job/JobManager.h"
 #include "Scene3D/Components/AnimationComponent.h"
 #include "Scene3D/Components/ComponentHelpers.h"
 #include "Math/Transform.h"
+#include "Math/TransformUtils.h"
 #include "Scene3D/Components/SingleComponents/TransformSingleComponent.h"
 #include "Scene3D/Components/TransformComponent.h"
 #include "Scene3D/Entity.h"
 #include "Scene3D/Scene.h"
 #include "Scene3D/Systems/TransformSystem.h"
+#include "Scene3D/Systems/Private/TransformStorage.h"
 
 namespace DAVA
 {
+namespace TransformSystemDetails
+{
+// Min count of independent dirty subtrees to update them in the worker-threads
+const uint32 MIN_PARALLEL_ROOTS_COUNT = 16;
+// Count of subtrees per worker-thread. Several subtrees per thread let JobManager balance uneven subtrees
+const uint32 ROOTS_PER_WORKER = 4;
+// Max count of hierarchy levels that can be updated serially to split few big subtrees into many small ones
+const uint32 MAX_SPLIT_LEVELS = 4;
+}
+
 TransformSystem::TransformSystem(Scene* scene)
     : SceneSystem(scene)
+    , storage(new TransformStorage())
 {
 }
 
+TransformSystem::~TransformSystem() = default;
+
 void TransformSystem::Process(float32 timeElapsed)
 {
     DAVA_PROFILER_CPU_SCOPE(ProfilerCPUMarkerName::SCENE_TRANSFORM_SYSTEM);
 
+    if (linearUpdateEnabled)
+    {
+        ProcessLinear();
+        return;
+    }
+
     TransformSingleComponent* tsc = GetScene()->transformSingleComponent;
     for (Entity* e : tsc->localTransformChanged)
     {
@@ -38,81 +62,129 @@ void TransformSystem::Process(float32 timeElapsed)
         HierarchicAddToUpdate(e);
     }
 
-    passedNodes = 0;
-    multipliedNodes = 0;
-
     uint32 size = static_cast<uint32>(updatableEntities.size());
     for (uint32 i = 0; i < size; ++i)
     {
         FindNodeThatRequireUpdate(updatableEntities[i]);
     }
     updatableEntities.clear();
+
+    changedEntities.clear();
+
+    JobManager* jobManager = GetEngineContext()->jobManager;
+    uint32 workersCount = (parallelUpdateEnabled && nullptr != jobManager) ? jobManager->GetWorkersCount() : 0;
+    if (workersCount > 0)
+    {
+        SplitUpdateRoots(workersCount * TransformSystemDetails::ROOTS_PER_WORKER);
+    }
+
+    uint32 rootsCount = static_cast<uint32>(updateRoots.size());
+    if (workersCount > 0 && rootsCount >= TransformSystemDetails::MIN_PARALLEL_ROOTS_COUNT)
+    {
+        // Subtrees don't intersect, so each of them can be updated in its own thread.
+        // Changed entities are collected per subtree and pushed in the order of subtrees
+        // to keep results independent of threads scheduling
+        if (rootChangedEntities.size() < rootsCount)
+        {
+            rootChangedEntities.resize(rootsCount);
+        }
+
+        jobManager->ParallelFor(0, rootsCount, [this](uint32 begin, uint32 end) {
+            Vector<Entity*> stack;
+            for (uint32 i = begin; i < end; ++i)
+            {
+                rootChangedEntities[i].clear();
+                TransformAllChildEntities(updateRoots[i], stack, rootChangedEntities[i]);
+            }
+        });
+
+        PushWorldChanged(changedEntities);
+        for (uint32 i = 0; i < rootsCount; ++i)
+        {
+            PushWorldChanged(rootChangedEntities[i]);
+        }
+    }
+    else
+    {
+        for (Entity* root : updateRoots)
+        {
+            TransformAllChildEntities(root, transformStack, changedEntities);
+        }
+        PushWorldChanged(changedEntities);
+    }
+
+    updateRoots.clear();
 }
 
 void TransformSystem::FindNodeThatRequireUpdate(Entity* entity)
 {
-    static const uint32 STACK_SIZE = 5000;
-    uint32 stackPosition = 0;
-    Entity* stack[STACK_SIZE];
-    stack[stackPosition++] = entity;
+    findStack.clear();
+    findStack.push_back(entity);
 
-    while (stackPosition > 0)
+    while (!findStack.empty())
     {
-        Entity* entity = stack[--stackPosition];
+        Entity* entity = findStack.back();
+        findStack.pop_back();
 
         if (entity->GetFlags() & Entity::TRANSFORM_NEED_UPDATE)
         {
-            TransformAllChildEntities(entity);
+            // whole subtree will be updated in TransformAllChildEntities()
+            updateRoots.push_back(entity);
         }
         else
         {
             entity->RemoveFlag(Entity::TRANSFORM_NEED_UPDATE | Entity::TRANSFORM_DIRTY);
 
-            // We already marked all children as non-dirty if we entered to TransformAllChildEntities()
             uint32 size = entity->GetChildrenCount();
             for (uint32 i = 0; i < size; ++i)
             {
                 Entity* childEntity = entity->GetChild(i);
                 if (childEntity->GetFlags() & Entity::TRANSFORM_DIRTY)
                 {
-                    DVASSERT(stackPosition < STACK_SIZE - 1);
-                    stack[stackPosition++] = childEntity;
+                    findStack.push_back(childEntity);
                 }
             }
         }
     }
-    DVASSERT(stackPosition == 0);
 }
 
-void TransformSystem::TransformAllChildEntities(Entity* entity)
+void TransformSystem::SplitUpdateRoots(uint32 minRootsCount)
 {
-    static const uint32 STACK_SIZE = 5000;
-    uint32 stackPosition = 0;
-    Entity* stack[STACK_SIZE];
-    stack[stackPosition++] = entity;
-
-    int32 localMultiplied = 0;
-
-    while (stackPosition > 0)
+    // Update top levels of subtrees breadth-first, until there are enough subtrees for all workers
+    for (uint32 level = 0; level < TransformSystemDetails::MAX_SPLIT_LEVELS && !updateRoots.empty() && updateRoots.size() < minRootsCount; ++level)
     {
-        Entity* entity = stack[--stackPosition];
-
-        TransformComponent* transform = entity->GetComponent<TransformComponent>();
-
-        if (transform->parentTransform)
+        nextUpdateRoots.clear();
+        for (Entity* entity : updateRoots)
         {
-            AnimationComponent* animComp = GetAnimationComponent(entity);
-            localMultiplied++;
-            if (animComp)
+            if (UpdateWorldTransform(entity))
             {
-                transform->worldTransform = Transform(animComp->animationTransform) * transform->localTransform * *(transform->parentTransform);
+                changedEntities.push_back(entity);
             }
-            else
+            entity->RemoveFlag(Entity::TRANSFORM_NEED_UPDATE | Entity::TRANSFORM_DIRTY);
+
+            uint32 size = entity->GetChildrenCount();
+            for (uint32 i = 0; i < size; ++i)
             {
-                transform->worldTransform = transform->localTransform * *(transform->parentTransform);
+                nextUpdateRoots.push_back(entity->GetChild(i));
             }
+        }
+        updateRoots.swap(nextUpdateRoots);
+    }
+}
+
+void TransformSystem::TransformAllChildEntities(Entity* entity, Vector<Entity*>& stack, Vector<Entity*>& changed)
+{
+    stack.clear();
+    stack.push_back(entity);
 
-            transform->MarkWorldChanged();
+    while (!stack.empty())
+    {
+        Entity* entity = stack.back();
+        stack.pop_back();
+
+        if (UpdateWorldTransform(entity))
+        {
+            changed.push_back(entity);
         }
 
         entity->RemoveFlag(Entity::TRANSFORM_NEED_UPDATE | Entity::TRANSFORM_DIRTY);
@@ -120,12 +192,131 @@ void TransformSystem::TransformAllChildEntities(Entity* entity)
         uint32 size = entity->GetChildrenCount();
         for (uint32 i = 0; i < size; ++i)
         {
-            DVASSERT(stackPosition < STACK_SIZE - 1);
-            stack[stackPosition++] = entity->GetChild(i);
+            stack.push_back(entity->GetChild(i));
+        }
+    }
+}
+
+bool TransformSystem::UpdateWorldTransform(Entity* entity)
+{
+    TransformComponent* transform = entity->GetComponent<TransformComponent>();
+    if (transform->parentTransform)
+    {
+        AnimationComponent* animComp = GetAnimationComponent(entity);
+        if (animComp)
+        {
+            transform->worldTransform = Transform(animComp->animationTransform) * transform->localTransform * *(transform->parentTransform);
+        }
+        else
+        {
+            transform->worldTransform = transform->localTransform * *(transform->parentTransform);
+        }
+        transform->worldMatrix = TransformUtils::ToMatrix(transform->worldTransform);
+
+        return true;
+    }
+
+    return false;
+}
+
+void TransformSystem::PushWorldChanged(const Vector<Entity*>& changed)
+{
+    TransformSingleComponent* tsc = GetScene()->transformSingleComponent;
+    for (Entity* entity : changed)
+    {
+        tsc->worldTransformChanged.Push(entity);
+    }
+}
+
+void TransformSystem::ProcessLinear()
+{
+    TransformSingleComponent* tsc = GetScene()->transformSingleComponent;
+    if (storageHierarchyChanged || !tsc->transformParentChanged.empty())
+    {
+        storage->Rebuild(GetScene());
+        storageHierarchyChanged = false;
+    }
+
+    if (storageFullUpdate)
+    {
+        storage->MarkAllDirty();
+        storageFullUpdate = false;
+    }
+    else
+    {
+        for (Entity* e : addedEntities)
+        {
+            storage->MarkLocalChanged(e->GetComponent<TransformComponent>()->storageIndex);
+        }
+        for (Entity* e : tsc->transformParentChanged)
+        {
+            storage->MarkLocalChanged(e->GetComponent<TransformComponent>()->storageIndex);
+        }
+        for (Entity* e : tsc->localTransformChanged)
+        {
+            storage->MarkLocalChanged(e->GetComponent<TransformComponent>()->storageIndex);
+        }
+        for (Entity* e : tsc->animationTransformChanged)
+        {
+            storage->MarkLocalChanged(e->GetComponent<TransformComponent>()->storageIndex);
+        }
+    }
+    addedEntities.clear();
+
+    changedEntities.clear();
+    storage->Update(changedEntities);
+    PushWorldChanged(changedEntities);
+}
+
+void TransformSystem::SetLinearUpdateEnabled(bool enabled)
+{
+    if (linearUpdateEnabled == enabled)
+    {
+        return;
+    }
+
+    linearUpdateEnabled = enabled;
+    if (linearUpdateEnabled)
+    {
+        // linear update doesn't use entity flags, so drop flags of pending entities
+        // and recalculate everything from storage
+        for (Entity* entity : updatableEntities)
+        {
+            ClearTransformFlags(entity);
+        }
+        updatableEntities.clear();
+        storageHierarchyChanged = true;
+        storageFullUpdate = true;
+    }
+    else
+    {
+        // world transforms of components are up to date, storage isn't needed anymore
+        storage->Clear();
+        addedEntities.clear();
+    }
+}
+
+void TransformSystem::ClearTransformFlags(Entity* entity)
+{
+    findStack.clear();
+    findStack.push_back(entity);
+
+    while (!findStack.empty())
+    {
+        Entity* entity = findStack.back();
+        findStack.pop_back();
+        entity->RemoveFlag(Entity::TRANSFORM_NEED_UPDATE | Entity::TRANSFORM_DIRTY);
+
+        uint32 size = entity->GetChildrenCount();
+        for (uint32 i = 0; i < size; ++i)
+        {
+            Entity* childEntity = entity->GetChild(i);
+            if (childEntity->GetFlags() & Entity::TRANSFORM_DIRTY)
+            {
+                findStack.push_back(childEntity);
+            }
         }
     }
-    DVASSERT(stackPosition == 0);
-    multipliedNodes += localMultiplied;
 }
 
 void TransformSystem::EntityNeedUpdate(Entity* entity)
@@ -153,12 +344,27 @@ void TransformSystem::HierarchicAddToUpdate(Entity* entity)
 
 void TransformSystem::AddEntity(Entity* entity)
 {
+    storageHierarchyChanged = true;
+    if (linearUpdateEnabled)
+    {
+        addedEntities.push_back(entity);
+        return;
+    }
+
     EntityNeedUpdate(entity);
     HierarchicAddToUpdate(entity);
 }
 
 void TransformSystem::RemoveEntity(Entity* entity)
 {
+    storageHierarchyChanged = true;
+    auto it = std::find(addedEntities.begin(), addedEntities.end(), entity);
+    if (it != addedEntities.end())
+    {
+        *it = addedEntities.back();
+        addedEntities.pop_back();
+    }
+
     //TODO: use hashmap
     uint32 size = static_cast<uint32>(updatableEntities.size());
     for (uint32 i = 0; i < size; ++i)
@@ -186,5 +392,9 @@ void TransformSystem::PrepareForRemove()
     }
 
     updatableEntities.clear();
+
+    storage->Clear();
+    addedEntities.clear();
+    storageHierarchyChanged = true;
 }
 };
@@ -11,12 +11,13 @@ namespace DAVA
 class Entity;
 class Transform;
 class TransformComponent;
-class Transform;
+class TransformStorage;
 
 class TransformSystem : public SceneSystem
 {
 public:
     TransformSystem(Scene* scene);
+    ~TransformSystem() override;
 
     void AddEntity(Entity* entity) override;
     void RemoveEntity(Entity* entity) override;
@@ -24,15 +25,61 @@ public:
     void PrepareForRemove() override;
     void Process(float32 timeElapsed) override;
 
+    /** Enable or disable update of independent dirty subtrees in the worker-threads. Enabled by default. */
+    void SetParallelUpdateEnabled(bool enabled);
+    bool IsParallelUpdateEnabled() const;
+
+    /**
+        Enable or disable update of world transforms by linear sweep over scene-level TransformStorage.
+        Sweep doesn't touch entities and components except changed ones, but storage is rebuilt
+        in frames when hierarchy changes. Disabled by default.
+    */
+    void SetLinearUpdateEnabled(bool enabled);
+    bool IsLinearUpdateEnabled() const;
+
 private:
     Vector<Entity*> updatableEntities;
 
+    // roots of subtrees, that should be fully recalculated in current frame
+    Vector<Entity*> updateRoots;
+    Vector<Entity*> nextUpdateRoots;
+    Vector<Entity*> findStack;
+    Vector<Entity*> transformStack;
+    Vector<Entity*> changedEntities;
+    Vector<Vector<Entity*>> rootChangedEntities;
+
     void EntityNeedUpdate(Entity* entity);
     void HierarchicAddToUpdate(Entity* entity);
     void FindNodeThatRequireUpdate(Entity* entity);
-    void TransformAllChildEntities(Entity* entity);
+    void SplitUpdateRoots(uint32 minRootsCount);
+    void TransformAllChildEntities(Entity* entity, Vector<Entity*>& stack, Vector<Entity*>& changed);
+    bool UpdateWorldTransform(Entity* entity);
+    void PushWorldChanged(const Vector<Entity*>& changed);
+
+    void ProcessLinear();
+    void ClearTransformFlags(Entity* entity);
+
+    std::unique_ptr<TransformStorage> storage;
+    Vector<Entity*> addedEntities;
+    bool storageHierarchyChanged = true;
+    bool storageFullUpdate = true;
 
-    int32 passedNodes;
-    int32 multipliedNodes;
+    bool parallelUpdateEnabled = true;
+    bool linearUpdateEnabled = false;
 };
+
+inline void TransformSystem::SetParallelUpdateEnabled(bool enabled)
+{
+    parallelUpdateEnabled = enabled;
+}
+
+inline bool TransformSystem::IsParallelUpdateEnabled() const
+{
+    return parallelUpdateEnabled;
+}
+
+inline bool TransformSystem::IsLinearUpdateEnabled() const
+{
+    return linearUpdateEnabled;
+}
 };
@@ -1,4 +1,5 @@
 #include "WaveSystem.h"
+#include "Entity/ComponentUtils.h"
 #include "Scene3D/Entity.h"
 #include "Scene3D/Components/ComponentHelpers.h"
 #include "Scene3D/Components/WaveComponent.h"
@@ -32,6 +33,8 @@ WaveSystem::WaveSystem(Scene* scene)
     :
     SceneSystem(scene)
 {
+    SetComponentsAccess(ComponentMask(), ComponentUtils::MakeMask<WaveComponent>());
+
     RenderOptions* options = Renderer::GetOptions();
     options->AddObserver(this);
     HandleEvent(options);
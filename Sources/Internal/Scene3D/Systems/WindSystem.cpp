@@ -1,5 +1,6 @@
 #include "Base/BaseMath.h"
 #include "WindSystem.h"
+#include "Entity/ComponentUtils.h"
 #include "Scene3D/Entity.h"
 #include "Scene3D/Components/ComponentHelpers.h"
 #include "Scene3D/Components/WindComponent.h"
@@ -30,6 +31,8 @@ WindSystem::WindSystem(Scene* scene)
     :
     SceneSystem(scene)
 {
+    SetComponentsAccess(ComponentMask(), ComponentUtils::MakeMask<WindComponent>());
+
     RenderOptions* options = Renderer::GetOptions();
     options->AddObserver(this);
     HandleEvent(options);
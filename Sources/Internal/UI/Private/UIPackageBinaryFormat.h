@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Base/BaseTypes.h"
+
+namespace DAVA
+{
+/**
+    Layout of compiled UI package (*.uib), which is the sequence of AbstractUIPackageBuilder calls
+    recorded while the package was loaded from yaml:
+
+        header: magic, format version, flags, size and CRC32 of source yaml
+        strings: count, then null-terminated strings prefixed with length
+        commands: size in bytes, then commands
+
+    Each command is an opcode followed by its arguments. Strings are referred by indices in strings table,
+    property values are written as value tag followed by value data.
+*/
+namespace UIPackageBinaryFormat
+{
+const uint32 MAGIC = 0x42504955; // "UIPB"
+const uint32 VERSION = 3;
+const uint32 INVALID_STRING = 0xFFFFFFFF;
+
+enum eFlags : uint32
+{
+    FLAG_SOURCE_REMOVED = 1 << 0, // yaml is removed by packer, compiled package is used without checking it
+};
+
+enum eCommand : uint8
+{
+    CMD_BEGIN_PACKAGE,
+    CMD_END_PACKAGE,
+    CMD_IMPORTED_PACKAGE,
+    CMD_STYLE_SHEET,
+    CMD_BEGIN_CONTROL_WITH_CLASS,
+    CMD_BEGIN_CONTROL_WITH_CUSTOM_CLASS,
+    CMD_BEGIN_CONTROL_WITH_PROTOTYPE,
+    CMD_BEGIN_CONTROL_WITH_PATH,
+    CMD_END_CONTROL,
+    CMD_BEGIN_CONTROL_PROPERTIES_SECTION,
+    CMD_END_CONTROL_PROPERTIES_SECTION,
+    CMD_BEGIN_COMPONENT_PROPERTIES_SECTION,
+    CMD_END_COMPONENT_PROPERTIES_SECTION,
+    CMD_PROPERTY,
+    CMD_DATA_BINDING,
+    CMD_CUSTOM_DATA,
+    CMD_LOAD_CONTROL_BY_NAME, // prototype loaded on demand, followed by its commands
+    CMD_END_LOAD_CONTROL_BY_NAME,
+};
+
+enum eValueTag : uint8
+{
+    VALUE_EMPTY,
+    VALUE_BOOL,
+    VALUE_INT32,
+    VALUE_UINT32,
+    VALUE_INT64,
+    VALUE_UINT64,
+    VALUE_FLOAT32,
+    VALUE_FASTNAME,
+    VALUE_STRING,
+    VALUE_WIDESTRING,
+    VALUE_VECTOR2,
+    VALUE_VECTOR3,
+    VALUE_VECTOR4,
+    VALUE_COLOR,
+    VALUE_RECT,
+    VALUE_FILEPATH,
+    VALUE_ENUM, // int32 reinterpreted to type of field
+};
+}
+}
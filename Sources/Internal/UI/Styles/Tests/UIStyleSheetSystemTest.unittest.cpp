@@ -0,0 +1,210 @@
+#include "UnitTests/UnitTests.h"
+
+#include "Base/RefPtr.h"
+#include "Engine/Engine.h"
+#include "Logger/Logger.h"
+#include "Time/SystemTimer.h"
+#include "UI/Styles/UIStyleSheet.h"
+#include "UI/Styles/UIStyleSheetSystem.h"
+#include "UI/UIControl.h"
+#include "UI/UIControlPackageContext.h"
+#include "UI/UIControlSystem.h"
+#include "UI/UIScreen.h"
+
+namespace UIStyleSheetSystemTestDetails
+{
+using namespace DAVA;
+
+const char* SELECTORS[] = {
+    ".panel .button",
+    ".button:selected",
+    "#label",
+    ".panel UIControl",
+    ".night .button",
+    "UIControl.day"
+};
+
+const int32 BENCHMARK_BUTTONS_COUNT = 500;
+
+RefPtr<UIControlPackageContext> CreatePackageContext()
+{
+    RefPtr<UIControlPackageContext> packageContext(new UIControlPackageContext());
+    for (const char* selector : SELECTORS)
+    {
+        RefPtr<UIStyleSheetPropertyTable> propertyTable(new UIStyleSheetPropertyTable());
+        propertyTable->SetProperties({});
+
+        RefPtr<UIStyleSheet> styleSheet(new UIStyleSheet());
+        styleSheet->SetSelectorChain(UIStyleSheetSelectorChain(selector));
+        styleSheet->SetPropertyTable(propertyTable.Get());
+        packageContext->AddStyleSheet(UIPriorityStyleSheet(styleSheet.Get()));
+    }
+    return packageContext;
+}
+
+Vector<const UIStyleSheet*> GetMatchedStyleSheets(UIControl* control)
+{
+    Vector<const UIStyleSheet*> result;
+    const Vector<UIPriorityStyleSheet>& styleSheets = control->GetPackageContext()->GetSortedStyleSheets();
+    for (int32 index : control->GetStyleSheetMatches().styleSheets)
+    {
+        result.push_back(styleSheets[index].GetStyleSheet());
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+Vector<const UIStyleSheet*> GetDebugStyleSheets(UIControl* control)
+{
+    UIStyleSheetProcessDebugData debugData;
+    GetEngineContext()->uiControlSystem->GetStyleSheetSystem()->DebugControl(control, &debugData);
+
+    Vector<const UIStyleSheet*> result;
+    for (const UIPriorityStyleSheet& styleSheet : debugData.styleSheets)
+    {
+        result.push_back(styleSheet.GetStyleSheet());
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+// compare results reused by style sheet system with full matching of all style sheets
+bool MatchesAreActual(UIControl* control)
+{
+    if (GetMatchedStyleSheets(control) != GetDebugStyleSheets(control))
+    {
+        return false;
+    }
+
+    for (const auto& child : control->GetChildren())
+    {
+        if (!MatchesAreActual(child.Get()))
+            return false;
+    }
+    return true;
+}
+}
+
+DAVA_TESTCLASS (UIStyleSheetSystemTest)
+{
+    BEGIN_FILES_COVERED_BY_TESTS()
+    FIND_FILES_IN_TARGET(DavaFramework)
+    DECLARE_COVERED_FILES("UIStyleSheetIndex.cpp")
+    DECLARE_COVERED_FILES("UIStyleSheetSystem.cpp")
+    END_FILES_COVERED_BY_TESTS();
+
+    DAVA::RefPtr<DAVA::UIScreen> screen;
+    DAVA::RefPtr<DAVA::UIControl> panel;
+    DAVA::RefPtr<DAVA::UIControl> button;
+    DAVA::RefPtr<DAVA::UIControl> label;
+
+    UIStyleSheetSystemTest()
+    {
+        using namespace DAVA;
+        using namespace UIStyleSheetSystemTestDetails;
+
+        screen = new UIScreen();
+        GetEngineContext()->uiControlSystem->SetScreen(screen.Get());
+        GetEngineContext()->uiControlSystem->Update();
+
+        panel = new UIControl();
+        panel->SetPackageContext(CreatePackageContext());
+        panel->AddClass(FastName("panel"));
+
+        button = new UIControl();
+        button->AddClass(FastName("button"));
+        panel->AddControl(button.Get());
+
+        label = new UIControl();
+        label->SetName("label");
+        button->AddControl(label.Get());
+
+        screen->AddControl(panel.Get());
+    }
+
+    ~UIStyleSheetSystemTest()
+    {
+        DAVA::GetEngineContext()->uiControlSystem->GetStyleSheetSystem()->ClearGlobalClasses();
+        DAVA::GetEngineContext()->uiControlSystem->Reset();
+    }
+
+    void UpdateSystem()
+    {
+        DAVA::GetEngineContext()->uiControlSystem->Update();
+    }
+
+    DAVA_TEST (MatchesAreUpdatedOnChanges)
+    {
+        using namespace DAVA;
+        using namespace UIStyleSheetSystemTestDetails;
+
+        UpdateSystem();
+        TEST_VERIFY(MatchesAreActual(panel.Get()));
+        TEST_VERIFY(GetMatchedStyleSheets(panel.Get()).size() == 0);
+        TEST_VERIFY(GetMatchedStyleSheets(button.Get()).size() == 2);
+        TEST_VERIFY(GetMatchedStyleSheets(label.Get()).size() == 1);
+
+        button->SetSelected(true, false);
+        UpdateSystem();
+        TEST_VERIFY(MatchesAreActual(panel.Get()));
+        TEST_VERIFY(GetMatchedStyleSheets(button.Get()).size() == 3);
+
+        panel->RemoveClass(FastName("panel"));
+        UpdateSystem();
+        TEST_VERIFY(MatchesAreActual(panel.Get()));
+        TEST_VERIFY(GetMatchedStyleSheets(button.Get()).size() == 1);
+        TEST_VERIFY(GetMatchedStyleSheets(label.Get()).size() == 1);
+
+        GetEngineContext()->uiControlSystem->GetStyleSheetSystem()->AddGlobalClass(FastName("night"));
+        UpdateSystem();
+        TEST_VERIFY(MatchesAreActual(panel.Get()));
+        TEST_VERIFY(GetMatchedStyleSheets(button.Get()).size() == 2);
+
+        // tagged global classes don't make controls dirty, so they are applied on next processing of control
+        GetEngineContext()->uiControlSystem->GetStyleSheetSystem()->SetGlobalTaggedClass(FastName("time"), FastName("day"));
+        label->SetName("caption");
+        UpdateSystem();
+        TEST_VERIFY(MatchesAreActual(label.Get()));
+        TEST_VERIFY(GetMatchedStyleSheets(label.Get()).size() == 1);
+
+        GetEngineContext()->uiControlSystem->GetStyleSheetSystem()->ResetGlobalTaggedClass(FastName("time"));
+        button->SetSelected(false, false);
+        UpdateSystem();
+        TEST_VERIFY(MatchesAreActual(panel.Get()));
+        TEST_VERIFY(GetMatchedStyleSheets(label.Get()).size() == 0);
+    }
+
+    DAVA_TEST (ProcessStateChangeBenchmark)
+    {
+        using namespace DAVA;
+        using namespace UIStyleSheetSystemTestDetails;
+
+        Vector<RefPtr<UIControl>> buttons;
+        for (int32 i = 0; i < BENCHMARK_BUTTONS_COUNT; ++i)
+        {
+            RefPtr<UIControl> benchmarkButton(new UIControl());
+            benchmarkButton->AddClass(FastName("button"));
+            panel->AddControl(benchmarkButton.Get());
+            buttons.push_back(benchmarkButton);
+        }
+        UpdateSystem();
+
+        UIStyleSheetSystem* system = GetEngineContext()->uiControlSystem->GetStyleSheetSystem();
+
+        int64 startTime = SystemTimer::GetUs();
+        system->ProcessControl(panel.Get(), true);
+        int64 fullTime = SystemTimer::GetUs() - startTime;
+
+        startTime = SystemTimer::GetUs();
+        for (const RefPtr<UIControl>& benchmarkButton : buttons)
+        {
+            benchmarkButton->SetSelected(true, false);
+        }
+        system->ProcessControl(panel.Get());
+        int64 incrementalTime = SystemTimer::GetUs() - startTime;
+
+        TEST_VERIFY(MatchesAreActual(panel.Get()));
+        Logger::Info("Style sheets processing of %d controls: %lld us for full matching, %lld us after state change",
+                     BENCHMARK_BUTTONS_COUNT + 3, fullTime, incrementalTime);
+    }
+};
@@ -0,0 +1,105 @@
+#include "UI/Styles/UIStyleSheetIndex.h"
+#include "UI/Styles/UIStyleSheet.h"
+#include "UI/UIControl.h"
+
+namespace DAVA
+{
+void UIStyleSheetIndex::Build(const Vector<UIPriorityStyleSheet>& styleSheets)
+{
+    Clear();
+
+    styleSheetInfos.resize(styleSheets.size());
+    for (int32 index = 0; index < static_cast<int32>(styleSheets.size()); ++index)
+    {
+        const UIStyleSheetSelectorChain& chain = styleSheets[index].GetStyleSheet()->GetSelectorChain();
+
+        StyleSheetInfo& info = styleSheetInfos[index];
+        info.selectorChainSize = chain.GetSize();
+        for (const UIStyleSheetSelector& selector : chain)
+        {
+            for (const FastName& clazz : selector.classes)
+            {
+                if (std::find(info.classes.begin(), info.classes.end(), clazz) == info.classes.end())
+                    info.classes.push_back(clazz);
+            }
+        }
+
+        if (chain.GetSize() == 0)
+        {
+            universalStyleSheets.push_back(index);
+            continue;
+        }
+
+        // the most selective part of rightmost selector is used as key
+        const UIStyleSheetSelector& selector = *chain.rbegin();
+        info.rightmostSelectorHasState = (selector.stateMask != 0);
+        if (selector.name.IsValid())
+        {
+            styleSheetsByName[selector.name].push_back(index);
+        }
+        else if (!selector.classes.empty())
+        {
+            styleSheetsByClass[selector.classes.front()].push_back(index);
+        }
+        else if (!selector.className.empty())
+        {
+            styleSheetsByType[selector.className].push_back(index);
+        }
+        else
+        {
+            universalStyleSheets.push_back(index);
+        }
+    }
+}
+
+void UIStyleSheetIndex::Clear()
+{
+    styleSheetsByName.clear();
+    styleSheetsByClass.clear();
+    styleSheetsByType.clear();
+    universalStyleSheets.clear();
+    styleSheetInfos.clear();
+}
+
+void UIStyleSheetIndex::CollectCandidates(const UIControl* control, const UIStyleSheetClassSet& globalClasses, Vector<int32>& candidates) const
+{
+    candidates.clear();
+    AddCandidates(universalStyleSheets, candidates);
+
+    if (!styleSheetsByName.empty() && control->GetName().IsValid())
+    {
+        auto it = styleSheetsByName.find(control->GetName());
+        if (it != styleSheetsByName.end())
+            AddCandidates(it->second, candidates);
+    }
+
+    if (!styleSheetsByType.empty())
+    {
+        auto it = styleSheetsByType.find(control->GetClassName());
+        if (it != styleSheetsByType.end())
+            AddCandidates(it->second, candidates);
+    }
+
+    if (!styleSheetsByClass.empty())
+    {
+        for (const UIStyleSheetClassSet* classSet : { &control->GetClasses(), &globalClasses })
+        {
+            for (const UIStyleSheetClass& clazz : classSet->GetClasses())
+            {
+                auto it = styleSheetsByClass.find(clazz.clazz);
+                if (it != styleSheetsByClass.end())
+                    AddCandidates(it->second, candidates);
+            }
+        }
+    }
+
+    // the same class may be set to control and be global, and style sheet system goes in order of priority
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+}
+
+void UIStyleSheetIndex::AddCandidates(const Vector<int32>& styleSheets, Vector<int32>& candidates) const
+{
+    candidates.insert(candidates.end(), styleSheets.begin(), styleSheets.end());
+}
+}
@@ -0,0 +1,58 @@
+#ifndef __DAVAENGINE_UI_STYLESHEET_INDEX_H__
+#define __DAVAENGINE_UI_STYLESHEET_INDEX_H__
+
+#include "Base/BaseTypes.h"
+#include "Base/FastName.h"
+#include "UI/Styles/UIPriorityStyleSheet.h"
+
+namespace DAVA
+{
+class UIControl;
+class UIStyleSheetClassSet;
+
+/**
+    Index of sorted style sheets of package by their rightmost selector (by control name, class or control type),
+    so style sheet system tries to match only style sheets which rightmost selector can match control.
+    Style sheets are referred by their indices in sorted list.
+*/
+class UIStyleSheetIndex
+{
+public:
+    struct StyleSheetInfo
+    {
+        int32 selectorChainSize = 0;
+        bool rightmostSelectorHasState = false;
+        Vector<FastName> classes; // classes from all selectors of chain
+    };
+
+    void Build(const Vector<UIPriorityStyleSheet>& styleSheets);
+    void Clear();
+
+    /** Collect sorted indices of style sheets, which rightmost selector may match control with given global classes. */
+    void CollectCandidates(const UIControl* control, const UIStyleSheetClassSet& globalClasses, Vector<int32>& candidates) const;
+
+    const StyleSheetInfo& GetStyleSheetInfo(int32 index) const;
+    int32 GetStyleSheetsCount() const;
+
+private:
+    void AddCandidates(const Vector<int32>& styleSheets, Vector<int32>& candidates) const;
+
+    UnorderedMap<FastName, Vector<int32>> styleSheetsByName;
+    UnorderedMap<FastName, Vector<int32>> styleSheetsByClass;
+    UnorderedMap<String, Vector<int32>> styleSheetsByType;
+    Vector<int32> universalStyleSheets;
+    Vector<StyleSheetInfo> styleSheetInfos;
+};
+
+inline const UIStyleSheetIndex::StyleSheetInfo& UIStyleSheetIndex::GetStyleSheetInfo(int32 index) const
+{
+    return styleSheetInfos[index];
+}
+
+inline int32 UIStyleSheetIndex::GetStyleSheetsCount() const
+{
+    return static_cast<int32>(styleSheetInfos.size());
+}
+};
+
+#endif
@@ -123,10 +123,29 @@ public:
     String GetClassesAsString() const;
     void SetClassesFromString(const String& classes);
 
+    const Vector<UIStyleSheetClass>& GetClasses() const;
+
 private:
     Vector<UIStyleSheetClass> classes;
 };
 
+inline const Vector<UIStyleSheetClass>& UIStyleSheetClassSet::GetClasses() const
+{
+    return classes;
+}
+
+/**
+    Style sheets matched to control by style sheet system, indices in sorted style sheets of package context.
+    Result is reused while control classes, name and parent are not changed.
+*/
+struct UIStyleSheetMatches
+{
+    Vector<int32> styleSheets;
+    uint32 packageContextVersion = 0;
+    uint32 globalClassesVersion = 0;
+    bool valid = false;
+};
+
 struct UIStyleSheetSourceInfo
 {
     UIStyleSheetSourceInfo() = default;
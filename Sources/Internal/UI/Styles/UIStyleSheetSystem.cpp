@@ -1,5 +1,6 @@
 #include "UI/Styles/UIStyleSheetSystem.h"
 #include "UI/Styles/UIStyleSheet.h"
+#include "UI/Styles/UIStyleSheetIndex.h"
 #include "UI/UIControl.h"
 #include "UI/UIControlPackageContext.h"
 #include "UI/Components/UIComponent.h"
@@ -19,6 +20,8 @@ namespace DAVA
 namespace
 {
 const int32 PROPERTY_ANIMATION_GROUP_OFFSET = 100000;
+const int32 NO_DIRTY_ANCESTOR_DISTANCE = std::numeric_limits<int32>::max() / 2;
+const size_t MAX_GLOBAL_CLASSES_CHANGES = 32;
 }
 
 struct ImmediatePropertySetter
@@ -146,27 +149,33 @@ void UIStyleSheetSystem::SetPopupContainer(const RefPtr<UIControl>& _popupContai
 }
 
 void UIStyleSheetSystem::ProcessControl(UIControl* control, bool styleSheetListChanged /* = false*/)
+{
+    ProcessControlRoot(control, styleSheetListChanged, styleSheetListChanged);
+}
+
+void UIStyleSheetSystem::DebugControl(UIControl* control, UIStyleSheetProcessDebugData* debugData)
+{
+    ProcessControlImpl(control, 0, 0, true, true, false, true, debugData);
+}
+
+void UIStyleSheetSystem::ProcessControlRoot(UIControl* control, bool styleSheetListChanged, bool rematchAll)
 {
 #if STYLESHEET_STATS
     uint64 startTime = SystemTimer::GetUs();
 #endif
-    ProcessControlImpl(control, 0, styleSheetListChanged, true, false, nullptr);
+    ProcessControlImpl(control, 0, GetDistanceFromDirtyAncestor(control), styleSheetListChanged, rematchAll, true, false, nullptr);
 #if STYLESHEET_STATS
     statsTime += SystemTimer::GetUs() - startTime;
 #endif
 }
 
-void UIStyleSheetSystem::DebugControl(UIControl* control, UIStyleSheetProcessDebugData* debugData)
-{
-    ProcessControlImpl(control, 0, true, false, true, debugData);
-}
-
-void UIStyleSheetSystem::ProcessControlImpl(UIControl* control, int32 distanceFromDirty, bool styleSheetListChanged, bool recursively, bool dryRun, UIStyleSheetProcessDebugData* debugData)
+void UIStyleSheetSystem::ProcessControlImpl(UIControl* control, int32 distanceFromDirty, int32 distanceFromDirtyAncestor, bool styleSheetListChanged, bool rematchAll, bool recursively, bool dryRun, UIStyleSheetProcessDebugData* debugData)
 {
     RefPtr<UIControlPackageContext> packageContext = control->GetPackageContext();
     const UIStyleSheetPropertyDataBase* propertyDB = UIStyleSheetPropertyDataBase::Instance();
 
-    if (control->IsStyleSheetDirty())
+    const bool selfDirty = control->IsStyleSheetDirty();
+    if (selfDirty)
     {
         distanceFromDirty = 0;
     }
@@ -186,32 +195,33 @@ void UIStyleSheetSystem::ProcessControlImpl(UIControl* control, int32 distanceFr
         statsStyleSheetCount += styleSheets.size();
 #endif
 
+        MatchStyleSheets(control, packageContext.Get(), distanceFromDirtyAncestor, selfDirty, rematchAll || dryRun);
+
         Array<const UIStyleSheetProperty*, UIStyleSheetPropertyDataBase::STYLE_SHEET_PROPERTY_COUNT> propertySources = {};
 
-        for (auto styleSheetIter = styleSheets.rbegin(); styleSheetIter != styleSheets.rend(); ++styleSheetIter)
+        // style sheets with higher priority are first in sorted list, so they are applied last
+        for (auto indexIter = matchedStyleSheets.rbegin(); indexIter != matchedStyleSheets.rend(); ++indexIter)
         {
-            const UIStyleSheet* styleSheet = styleSheetIter->GetStyleSheet();
+            const UIPriorityStyleSheet& priorityStyleSheet = styleSheets[*indexIter];
+            const UIStyleSheet* styleSheet = priorityStyleSheet.GetStyleSheet();
 
-            if (StyleSheetMatchesControl(styleSheet, control))
-            {
-                cascadeProperties |= styleSheet->GetPropertyTable()->GetPropertySet();
-
-                const Vector<UIStyleSheetProperty>& propertyTable = styleSheet->GetPropertyTable()->GetProperties();
-                for (const UIStyleSheetProperty& prop : propertyTable)
-                {
-                    propertySources[prop.propertyIndex] = &prop;
+            cascadeProperties |= styleSheet->GetPropertyTable()->GetPropertySet();
 
-                    if (debugData != nullptr)
-                    {
-                        debugData->propertySources[prop.propertyIndex] = styleSheet;
-                    }
-                }
+            const Vector<UIStyleSheetProperty>& propertyTable = styleSheet->GetPropertyTable()->GetProperties();
+            for (const UIStyleSheetProperty& prop : propertyTable)
+            {
+                propertySources[prop.propertyIndex] = &prop;
 
                 if (debugData != nullptr)
                 {
-                    debugData->styleSheets.push_back(*styleSheetIter);
+                    debugData->propertySources[prop.propertyIndex] = styleSheet;
                 }
             }
+
+            if (debugData != nullptr)
+            {
+                debugData->styleSheets.push_back(priorityStyleSheet);
+            }
         }
 
         const UIStyleSheetPropertySet propertiesToApply = cascadeProperties & (~localControlProperties);
@@ -251,6 +261,12 @@ void UIStyleSheetSystem::ProcessControlImpl(UIControl* control, int32 distanceFr
 
         if (!dryRun)
         {
+            UIStyleSheetMatches& matches = control->GetStyleSheetMatches();
+            matches.styleSheets.swap(matchedStyleSheets);
+            matches.packageContextVersion = packageContext->GetStyleSheetsVersion();
+            matches.globalClassesVersion = globalClassesVersion;
+            matches.valid = true;
+
             control->SetStyledPropertySet(propertiesToApply);
 
             if (propertiesToReset.any() || propertiesToApply.any())
@@ -268,17 +284,88 @@ void UIStyleSheetSystem::ProcessControlImpl(UIControl* control, int32 distanceFr
 
     if (recursively)
     {
+        const int32 childDistanceFromDirtyAncestor = selfDirty ? 1 : Min(distanceFromDirtyAncestor + 1, NO_DIRTY_ANCESTOR_DISTANCE);
         for (const auto& child : control->GetChildren())
         {
-            ProcessControlImpl(child.Get(), distanceFromDirty + 1, styleSheetListChanged, true, dryRun, debugData);
+            ProcessControlImpl(child.Get(), distanceFromDirty + 1, childDistanceFromDirtyAncestor, styleSheetListChanged, rematchAll, true, dryRun, debugData);
         }
     }
 }
 
+void UIStyleSheetSystem::MatchStyleSheets(UIControl* control, UIControlPackageContext* packageContext, int32 distanceFromDirtyAncestor, bool selfDirty, bool rematchAll)
+{
+    const Vector<UIPriorityStyleSheet>& styleSheets = packageContext->GetSortedStyleSheets();
+    const UIStyleSheetIndex& index = packageContext->GetStyleSheetIndex();
+    const UIStyleSheetMatches& matches = control->GetStyleSheetMatches();
+
+    // previous results are valid for style sheets which selectors can't be affected by changes since last processing
+    const bool matchesReusable = !rematchAll && matches.valid && matches.packageContextVersion == packageContext->GetStyleSheetsVersion() && CollectGlobalClassesChanges(matches.globalClassesVersion, changedGlobalClasses);
+
+    auto needsRematch = [&](int32 styleSheetIndex) {
+        if (!matchesReusable)
+            return true;
+
+        const UIStyleSheetIndex::StyleSheetInfo& info = index.GetStyleSheetInfo(styleSheetIndex);
+        if (info.selectorChainSize > distanceFromDirtyAncestor || (selfDirty && info.rightmostSelectorHasState))
+            return true;
+
+        for (const FastName& clazz : changedGlobalClasses)
+        {
+            if (std::find(info.classes.begin(), info.classes.end(), clazz) != info.classes.end())
+                return true;
+        }
+        return false;
+    };
+
+    matchedStyleSheets.clear();
+    if (matchesReusable)
+    {
+        for (int32 styleSheetIndex : matches.styleSheets)
+        {
+            if (!needsRematch(styleSheetIndex))
+                matchedStyleSheets.push_back(styleSheetIndex);
+        }
+    }
+
+    index.CollectCandidates(control, globalClasses, candidateStyleSheets);
+#if STYLESHEET_STATS
+    statsMatchesSkippedByIndex += static_cast<int32>(styleSheets.size() - candidateStyleSheets.size());
+#endif
+
+    for (int32 styleSheetIndex : candidateStyleSheets)
+    {
+        if (needsRematch(styleSheetIndex))
+        {
+            if (StyleSheetMatchesControl(styleSheets[styleSheetIndex].GetStyleSheet(), control))
+                matchedStyleSheets.push_back(styleSheetIndex);
+        }
+#if STYLESHEET_STATS
+        else
+        {
+            ++statsMatchesMemoized;
+        }
+#endif
+    }
+
+    std::sort(matchedStyleSheets.begin(), matchedStyleSheets.end());
+}
+
+int32 UIStyleSheetSystem::GetDistanceFromDirtyAncestor(const UIControl* control) const
+{
+    int32 distance = 1;
+    for (const UIControl* parent = control->GetParent(); parent != nullptr; parent = parent->GetParent(), ++distance)
+    {
+        if (parent->IsStyleSheetDirty())
+            return distance;
+    }
+    return NO_DIRTY_ANCESTOR_DISTANCE;
+}
+
 void UIStyleSheetSystem::AddGlobalClass(const FastName& clazz)
 {
     if (globalClasses.AddClass(clazz))
     {
+        AddGlobalClassChange(clazz);
         SetGlobalStyleSheetDirty();
     }
 }
@@ -287,6 +374,7 @@ void UIStyleSheetSystem::RemoveGlobalClass(const FastName& clazz)
 {
     if (globalClasses.RemoveClass(clazz))
     {
+        AddGlobalClassChange(clazz);
         SetGlobalStyleSheetDirty();
     }
 }
@@ -298,7 +386,13 @@ bool UIStyleSheetSystem::HasGlobalClass(const FastName& clazz) const
 
 void UIStyleSheetSystem::SetGlobalTaggedClass(const FastName& tag, const FastName& clazz)
 {
-    globalClasses.SetTaggedClass(tag, clazz);
+    FastName prevClass = globalClasses.GetTaggedClass(tag);
+    if (globalClasses.SetTaggedClass(tag, clazz))
+    {
+        if (prevClass.IsValid())
+            AddGlobalClassChange(prevClass);
+        AddGlobalClassChange(clazz);
+    }
 }
 
 FastName UIStyleSheetSystem::GetGlobalTaggedClass(const FastName& tag) const
@@ -308,20 +402,52 @@ FastName UIStyleSheetSystem::GetGlobalTaggedClass(const FastName& tag) const
 
 void UIStyleSheetSystem::ResetGlobalTaggedClass(const FastName& tag)
 {
-    globalClasses.ResetTaggedClass(tag);
+    FastName prevClass = globalClasses.GetTaggedClass(tag);
+    if (globalClasses.ResetTaggedClass(tag) && prevClass.IsValid())
+    {
+        AddGlobalClassChange(prevClass);
+    }
 }
 
 void UIStyleSheetSystem::ClearGlobalClasses()
 {
+    for (const UIStyleSheetClass& clazz : globalClasses.GetClasses())
+    {
+        AddGlobalClassChange(clazz.clazz);
+    }
     globalClasses.RemoveAllClasses();
 }
 
+void UIStyleSheetSystem::AddGlobalClassChange(const FastName& clazz)
+{
+    ++globalClassesVersion;
+    globalClassesChanges.push_back(clazz);
+    if (globalClassesChanges.size() > MAX_GLOBAL_CLASSES_CHANGES)
+    {
+        globalClassesChanges.pop_front();
+    }
+}
+
+bool UIStyleSheetSystem::CollectGlobalClassesChanges(uint32 sinceVersion, Vector<FastName>& changedClasses) const
+{
+    changedClasses.clear();
+
+    const uint32 changesCount = globalClassesVersion - sinceVersion;
+    if (changesCount > globalClassesChanges.size())
+        return false;
+
+    changedClasses.assign(globalClassesChanges.end() - changesCount, globalClassesChanges.end());
+    return true;
+}
+
 void UIStyleSheetSystem::ClearStats()
 {
     statsTime = 0;
     statsProcessedControls = 0;
     statsMatches = 0;
     statsStyleSheetCount = 0;
+    statsMatchesSkippedByIndex = 0;
+    statsMatchesMemoized = 0;
 }
 
 void UIStyleSheetSystem::DumpStats()
@@ -331,6 +457,8 @@ void UIStyleSheetSystem::DumpStats()
         Logger::Debug("%s %i %f %i %f", __FUNCTION__, statsProcessedControls,
                       static_cast<float>(statsTime / 1000000.0f), statsMatches,
                       static_cast<float>(statsStyleSheetCount / statsProcessedControls));
+        Logger::Debug("%s matches avoided: %i by selector index, %i by previous results", __FUNCTION__,
+                      statsMatchesSkippedByIndex, statsMatchesMemoized);
     }
 }
 
@@ -340,7 +468,8 @@ void UIStyleSheetSystem::ProcessControlHierarhy(UIControl* control)
     if ((control->IsVisible() || control->GetStyledPropertySet().test(propIndex))
         && control->IsStyleSheetDirty())
     {
-        ProcessControl(control, globalStyleSheetDirty);
+        // global classes changes are tracked separately, so previous matching results stay valid
+        ProcessControlRoot(control, globalStyleSheetDirty, false);
     }
 
     for (const auto& child : control->GetChildren())
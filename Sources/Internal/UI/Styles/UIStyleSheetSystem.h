@@ -13,6 +13,7 @@
 namespace DAVA
 {
 class UIControl;
+class UIControlPackageContext;
 class UIScreen;
 class UIScreenTransition;
 class UIStyleSheet;
@@ -64,8 +65,17 @@ private:
     void Process(float32 elapsedTime) override;
     void ForceProcessControl(float32 elapsedTime, UIControl* control) override;
 
-    void ProcessControlImpl(UIControl* control, int32 distanceFromDirty, bool styleSheetListChanged, bool recursively, bool dryRun, UIStyleSheetProcessDebugData* debugData);
+    void ProcessControlRoot(UIControl* control, bool styleSheetListChanged, bool rematchAll);
+    /**
+        'distanceFromDirtyAncestor' is distance to the nearest dirty parent of control, style sheets with shorter
+        selector chains can't be affected by dirty parents and their matching results can be reused.
+        'rematchAll' disables reuse of previous matching results.
+    */
+    void ProcessControlImpl(UIControl* control, int32 distanceFromDirty, int32 distanceFromDirtyAncestor, bool styleSheetListChanged, bool rematchAll, bool recursively, bool dryRun, UIStyleSheetProcessDebugData* debugData);
     void ProcessControlHierarhy(UIControl* root);
+    /** Fills 'matchedStyleSheets' with sorted indices of style sheets matching control. */
+    void MatchStyleSheets(UIControl* control, UIControlPackageContext* packageContext, int32 distanceFromDirtyAncestor, bool selfDirty, bool rematchAll);
+    int32 GetDistanceFromDirtyAncestor(const UIControl* control) const;
 
     bool StyleSheetMatchesControl(const UIStyleSheet* styleSheet, const UIControl* control);
     bool SelectorMatchesControl(const UIStyleSheetSelector& selector, const UIControl* control);
@@ -75,12 +85,24 @@ private:
     /** Sets 'globalStyleSheetDirty' flag for next 'Process()' call. Flag will reset automatically. */
     void SetGlobalStyleSheetDirty();
 
+    void AddGlobalClassChange(const FastName& clazz);
+    /** Returns false if changes log doesn't cover all changes since specified version. */
+    bool CollectGlobalClassesChanges(uint32 sinceVersion, Vector<FastName>& changedClasses) const;
+
     UIStyleSheetClassSet globalClasses;
+    Deque<FastName> globalClassesChanges;
+    uint32 globalClassesVersion = 0;
+
+    Vector<int32> candidateStyleSheets;
+    Vector<int32> matchedStyleSheets;
+    Vector<FastName> changedGlobalClasses;
 
     uint64 statsTime = 0;
     int32 statsProcessedControls = 0;
     int32 statsMatches = 0;
     int32 statsStyleSheetCount = 0;
+    int32 statsMatchesSkippedByIndex = 0;
+    int32 statsMatchesMemoized = 0;
     bool dirty = false;
     bool needUpdate = false;
     bool globalStyleSheetDirty = false;
@@ -0,0 +1,282 @@
+#include "UnitTests/UnitTests.h"
+
+#include "Base/RefPtr.h"
+#include "Base/ScopedPtr.h"
+#include "Engine/Engine.h"
+#include "FileSystem/File.h"
+#include "FileSystem/FileSystem.h"
+#include "Logger/Logger.h"
+#include "MemoryManager/MemoryManager.h"
+#include "Time/SystemTimer.h"
+#include "UI/DefaultUIPackageBuilder.h"
+#include "UI/Text/UITextComponent.h"
+#include "UI/UIControl.h"
+#include "UI/UIControlPackageContext.h"
+#include "UI/UIControlSystem.h"
+#include "UI/UIPackage.h"
+#include "UI/UIPackageBinaryReader.h"
+#include "UI/UIPackageBinaryWriter.h"
+#include "UI/UIPackageLoader.h"
+
+namespace UIPackageBinaryTestDetails
+{
+using namespace DAVA;
+
+const char* PACKAGES[] = {
+    "UITextTest.yaml",
+    "UIStaticTextLegacyTest.yaml",
+    "UIRichContentTest.yaml",
+    "UIDataBinindingCell.yaml",
+    "Empty.yaml",
+    "Flow/Screen.yaml",
+    "Flow/View1.yaml",
+    "Flow/View2.yaml",
+    "Flow/SubView1.yaml"
+};
+
+const int32 BENCHMARK_ITERATIONS_COUNT = 50;
+
+const String SOURCE_DIR = "~res:/UI/";
+const String COMPILED_DIR = "~doc:/UIPackageBinaryTest/";
+
+FilePath GetSourcePackagePath(const char* package)
+{
+    return FilePath(SOURCE_DIR + package);
+}
+
+FilePath GetCompiledPackagePath(const char* package)
+{
+    String fileName(package);
+    std::replace(fileName.begin(), fileName.end(), '/', '_');
+    return FilePath(COMPILED_DIR + fileName);
+}
+
+// compiled package is placed next to yaml, so yaml is copied to writable directory first
+bool CompilePackage(const char* package)
+{
+    FilePath packagePath = GetCompiledPackagePath(package);
+    return FileSystem::Instance()->CopyFile(GetSourcePackagePath(package), packagePath, true) &&
+    UIPackageBinaryWriter::Compile(packagePath, UIPackageBinaryReader::GetBinaryPath(packagePath));
+}
+
+RefPtr<UIPackage> LoadPackage(const FilePath& packagePath)
+{
+    DefaultUIPackageBuilder builder;
+    if (UIPackageLoader().LoadPackage(packagePath, &builder))
+        return RefPtr<UIPackage>::ConstructWithRetain(builder.GetPackage());
+    return RefPtr<UIPackage>();
+}
+
+bool IsEqualControls(UIControl* a, UIControl* b)
+{
+    if (a->GetName() != b->GetName() || String(a->GetClassName()) != String(b->GetClassName()) ||
+        a->GetPosition() != b->GetPosition() || a->GetSize() != b->GetSize() ||
+        a->GetComponentCount() != b->GetComponentCount() || a->GetChildren().size() != b->GetChildren().size())
+    {
+        return false;
+    }
+
+    UITextComponent* textA = a->GetComponent<UITextComponent>();
+    UITextComponent* textB = b->GetComponent<UITextComponent>();
+    if ((textA == nullptr) != (textB == nullptr) || (textA != nullptr && textA->GetText() != textB->GetText()))
+    {
+        return false;
+    }
+
+    auto childA = a->GetChildren().begin();
+    auto childB = b->GetChildren().begin();
+    for (; childA != a->GetChildren().end(); ++childA, ++childB)
+    {
+        if (!IsEqualControls(childA->Get(), childB->Get()))
+            return false;
+    }
+    return true;
+}
+
+bool IsEqualControls(const Vector<RefPtr<UIControl>>& a, const Vector<RefPtr<UIControl>>& b)
+{
+    if (a.size() != b.size())
+        return false;
+
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        if (!IsEqualControls(a[i].Get(), b[i].Get()))
+            return false;
+    }
+    return true;
+}
+
+// number of allocations made since application start, available only with memory profiling
+uint32 GetAllocationsCount()
+{
+#if defined(DAVA_MEMORY_PROFILING_ENABLE)
+    MemoryManager* memoryManager = MemoryManager::Instance();
+    Vector<uint8> buffer(memoryManager->CalcCurStatSize());
+    memoryManager->GetCurStat(0, buffer.data(), static_cast<uint32>(buffer.size()));
+    return reinterpret_cast<const MMCurStat*>(buffer.data())->statGeneral.nextBlockNo;
+#else
+    return 0;
+#endif
+}
+}
+
+DAVA_TESTCLASS (UIPackageBinaryTest)
+{
+    BEGIN_FILES_COVERED_BY_TESTS()
+    FIND_FILES_IN_TARGET(DavaFramework)
+    DECLARE_COVERED_FILES("UIPackageBinaryReader.cpp")
+    DECLARE_COVERED_FILES("UIPackageBinaryWriter.cpp")
+    END_FILES_COVERED_BY_TESTS();
+
+    UIPackageBinaryTest()
+    {
+        using namespace UIPackageBinaryTestDetails;
+        DAVA::FileSystem::Instance()->CreateDirectory(DAVA::FilePath(COMPILED_DIR), true);
+    }
+
+    ~UIPackageBinaryTest()
+    {
+        using namespace UIPackageBinaryTestDetails;
+        DAVA::FileSystem::Instance()->DeleteDirectory(DAVA::FilePath(COMPILED_DIR), true);
+        DAVA::GetEngineContext()->uiControlSystem->Reset();
+    }
+
+    DAVA_TEST (CompiledPackagesMatchYaml)
+    {
+        using namespace DAVA;
+        using namespace UIPackageBinaryTestDetails;
+
+        for (const char* package : PACKAGES)
+        {
+            TEST_VERIFY(CompilePackage(package));
+
+            FilePath packagePath = GetCompiledPackagePath(package);
+            TEST_VERIFY(UIPackageBinaryReader(nullptr).Open(packagePath));
+
+            RefPtr<UIPackage> yamlPackage = LoadPackage(GetSourcePackagePath(package));
+            RefPtr<UIPackage> compiledPackage = LoadPackage(packagePath);
+            TEST_VERIFY(yamlPackage.Valid() && compiledPackage.Valid());
+            if (yamlPackage.Valid() && compiledPackage.Valid())
+            {
+                TEST_VERIFY(IsEqualControls(yamlPackage->GetPrototypes(), compiledPackage->GetPrototypes()));
+                TEST_VERIFY(IsEqualControls(yamlPackage->GetControls(), compiledPackage->GetControls()));
+                TEST_VERIFY(yamlPackage->GetControlPackageContext()->GetSortedStyleSheets().size() ==
+                            compiledPackage->GetControlPackageContext()->GetSortedStyleSheets().size());
+            }
+        }
+    }
+
+    DAVA_TEST (OutdatedPackageIsNotUsed)
+    {
+        using namespace DAVA;
+        using namespace UIPackageBinaryTestDetails;
+
+        const char* package = PACKAGES[0];
+        TEST_VERIFY(CompilePackage(package));
+
+        FilePath packagePath = GetCompiledPackagePath(package);
+        {
+            ScopedPtr<File> file(File::Create(packagePath, File::APPEND | File::WRITE));
+            TEST_VERIFY(file);
+            if (file)
+            {
+                file->WriteNonTerminatedString("\n# changed after compilation\n");
+            }
+        }
+        TEST_VERIFY(!UIPackageBinaryReader(nullptr).Open(packagePath));
+
+        // yaml is still loaded
+        RefPtr<UIPackage> yamlPackage = LoadPackage(packagePath);
+        TEST_VERIFY(yamlPackage.Valid() && !yamlPackage->GetControls().empty());
+    }
+
+    DAVA_TEST (ChangeOfSameSizeIsDetected)
+    {
+        using namespace DAVA;
+        using namespace UIPackageBinaryTestDetails;
+
+        const char* package = PACKAGES[0];
+        TEST_VERIFY(CompilePackage(package));
+
+        FilePath packagePath = GetCompiledPackagePath(package);
+        TEST_VERIFY(UIPackageBinaryReader(nullptr).Open(packagePath));
+
+        // change may be done in the same second as compilation, so content of yaml is compared instead of its modification date
+        Vector<uint8> content;
+        TEST_VERIFY(FileSystem::Instance()->ReadFileContents(packagePath, content) && !content.empty());
+        content.back() = (content.back() == '\n') ? ' ' : '\n';
+        {
+            ScopedPtr<File> file(File::Create(packagePath, File::CREATE | File::WRITE));
+            TEST_VERIFY(file && file->Write(content.data(), uint32(content.size())) == content.size());
+        }
+        TEST_VERIFY(!UIPackageBinaryReader(nullptr).Open(packagePath));
+    }
+
+    DAVA_TEST (PackageWithRemovedSourceIsUsed)
+    {
+        using namespace DAVA;
+        using namespace UIPackageBinaryTestDetails;
+
+        const char* package = PACKAGES[0];
+        TEST_VERIFY(CompilePackage(package));
+
+        // yaml is required for package compiled without removal of source
+        FilePath packagePath = GetCompiledPackagePath(package);
+        FilePath binaryPath = UIPackageBinaryReader::GetBinaryPath(packagePath);
+        TEST_VERIFY(FileSystem::Instance()->DeleteFile(packagePath));
+        TEST_VERIFY(!UIPackageBinaryReader(nullptr).Open(packagePath));
+
+        TEST_VERIFY(FileSystem::Instance()->CopyFile(GetSourcePackagePath(package), packagePath, true));
+        TEST_VERIFY(UIPackageBinaryWriter::Compile(packagePath, binaryPath, true));
+        TEST_VERIFY(FileSystem::Instance()->DeleteFile(packagePath));
+        TEST_VERIFY(UIPackageBinaryReader(nullptr).Open(packagePath));
+
+        RefPtr<UIPackage> yamlPackage = LoadPackage(GetSourcePackagePath(package));
+        RefPtr<UIPackage> compiledPackage = LoadPackage(packagePath);
+        TEST_VERIFY(yamlPackage.Valid() && compiledPackage.Valid());
+        if (yamlPackage.Valid() && compiledPackage.Valid())
+        {
+            TEST_VERIFY(IsEqualControls(yamlPackage->GetControls(), compiledPackage->GetControls()));
+        }
+    }
+
+    DAVA_TEST (LoadBenchmark)
+    {
+        using namespace DAVA;
+        using namespace UIPackageBinaryTestDetails;
+
+        uint64 yamlSize = 0;
+        uint64 compiledSize = 0;
+        for (const char* package : PACKAGES)
+        {
+            TEST_VERIFY(CompilePackage(package));
+
+            uint64 size = 0;
+            FileSystem::Instance()->GetFileSize(GetSourcePackagePath(package), size);
+            yamlSize += size;
+            FileSystem::Instance()->GetFileSize(UIPackageBinaryReader::GetBinaryPath(GetCompiledPackagePath(package)), size);
+            compiledSize += size;
+        }
+
+        for (bool compiled : { false, true })
+        {
+            uint32 startAllocations = GetAllocationsCount();
+            int64 startTime = SystemTimer::GetUs();
+            for (int32 i = 0; i < BENCHMARK_ITERATIONS_COUNT; ++i)
+            {
+                for (const char* package : PACKAGES)
+                {
+                    RefPtr<UIPackage> loadedPackage = LoadPackage(compiled ? GetCompiledPackagePath(package) : GetSourcePackagePath(package));
+                    TEST_VERIFY(loadedPackage.Valid());
+                }
+            }
+            int64 time = SystemTimer::GetUs() - startTime;
+            uint32 allocations = GetAllocationsCount() - startAllocations;
+
+            uint32 packagesCount = static_cast<uint32>(sizeof(PACKAGES) / sizeof(PACKAGES[0]));
+            Logger::Info("Loading of %u UI packages from %s (%llu bytes): %lld us, %u allocations (0 without memory profiling)",
+                         packagesCount, compiled ? "compiled packages" : "yaml", compiled ? compiledSize : yamlSize,
+                         time / BENCHMARK_ITERATIONS_COUNT, allocations / BENCHMARK_ITERATIONS_COUNT);
+        }
+    }
+};
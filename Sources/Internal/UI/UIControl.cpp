@@ -139,6 +139,7 @@ void UIControl::SetParent(UIControl* newParent)
         parent->UnregisterInputProcessors(inputProcessorsCount);
     }
     parent = newParent;
+    styleSheetMatches.valid = false;
     if (parent)
     {
         PropagateParentWithContext(newParent->packageContext ? newParent : newParent->parentWithContext);
@@ -272,6 +273,7 @@ void UIControl::SetName(const FastName& name_)
 
     name = name_;
 
+    styleSheetMatches.valid = false;
     SetStyleSheetDirty();
 }
 
@@ -2205,6 +2207,7 @@ void UIControl::AddClass(const FastName& clazz)
 {
     if (classes.AddClass(clazz))
     {
+        styleSheetMatches.valid = false;
         SetStyleSheetDirty();
     }
 }
@@ -2213,6 +2216,7 @@ void UIControl::RemoveClass(const FastName& clazz)
 {
     if (classes.RemoveClass(clazz))
     {
+        styleSheetMatches.valid = false;
         SetStyleSheetDirty();
     }
 }
@@ -2226,6 +2230,7 @@ void UIControl::SetTaggedClass(const FastName& tag, const FastName& clazz)
 {
     if (classes.SetTaggedClass(tag, clazz))
     {
+        styleSheetMatches.valid = false;
         SetStyleSheetDirty();
     }
 }
@@ -2239,6 +2244,7 @@ void UIControl::ResetTaggedClass(const FastName& tag)
 {
     if (classes.ResetTaggedClass(tag))
     {
+        styleSheetMatches.valid = false;
         SetStyleSheetDirty();
     }
 }
@@ -2251,9 +2257,15 @@ String UIControl::GetClassesAsString() const
 void UIControl::SetClassesFromString(const String& classesStr)
 {
     classes.SetClassesFromString(classesStr);
+    styleSheetMatches.valid = false;
     SetStyleSheetDirty();
 }
 
+const UIStyleSheetClassSet& UIControl::GetClasses() const
+{
+    return classes;
+}
+
 const UIStyleSheetPropertySet& UIControl::GetLocalPropertySet() const
 {
     return localProperties;
@@ -2313,6 +2325,11 @@ void UIControl::ResetStyleSheetDirty()
     styleSheetDirty = false;
 }
 
+UIStyleSheetMatches& UIControl::GetStyleSheetMatches()
+{
+    return styleSheetMatches;
+}
+
 void UIControl::SetLayoutDirty()
 {
     layoutDirty = true;
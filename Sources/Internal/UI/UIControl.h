@@ -1055,6 +1055,7 @@ public:
 
     String GetClassesAsString() const;
     void SetClassesFromString(const String& classes);
+    const UIStyleSheetClassSet& GetClasses() const;
 
     const UIStyleSheetPropertySet& GetLocalPropertySet() const;
     void SetLocalPropertySet(const UIStyleSheetPropertySet& set);
@@ -1070,6 +1071,9 @@ public:
     void SetStyleSheetDirty();
     void ResetStyleSheetDirty();
 
+    /** Style sheets matched at last processing, used by UIStyleSheetSystem. */
+    UIStyleSheetMatches& GetStyleSheetMatches();
+
     bool IsLayoutDirty() const;
     void SetLayoutDirty();
     void ResetLayoutDirty();
@@ -1091,6 +1095,7 @@ private:
     UIStyleSheetClassSet classes;
     UIStyleSheetPropertySet localProperties;
     UIStyleSheetPropertySet styledProperties;
+    UIStyleSheetMatches styleSheetMatches;
     RefPtr<UIControlPackageContext> packageContext;
     UIControl* parentWithContext = nullptr;
 
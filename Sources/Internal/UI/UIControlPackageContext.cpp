@@ -3,6 +3,16 @@
 
 namespace DAVA
 {
+namespace UIControlPackageContextDetails
+{
+uint32 lastStyleSheetsVersion = 0;
+}
+
+UIControlPackageContext::UIControlPackageContext()
+{
+    UpdateStyleSheetsVersion();
+}
+
 UIControlPackageContext::~UIControlPackageContext()
 {
 }
@@ -10,6 +20,7 @@ UIControlPackageContext::~UIControlPackageContext()
 void UIControlPackageContext::AddStyleSheet(const UIPriorityStyleSheet& styleSheet)
 {
     styleSheetsSorted = false;
+    UpdateStyleSheetsVersion();
 
     auto it = std::find_if(styleSheets.begin(), styleSheets.end(), [&styleSheet](UIPriorityStyleSheet& ss) {
         return ss.GetStyleSheet() == styleSheet.GetStyleSheet();
@@ -31,7 +42,10 @@ void UIControlPackageContext::AddStyleSheet(const UIPriorityStyleSheet& styleShe
 void UIControlPackageContext::RemoveAllStyleSheets()
 {
     styleSheets.clear();
+    styleSheetIndex.Clear();
+    styleSheetsSorted = false;
     maxStyleSheetHierarchyDepth = 0;
+    UpdateStyleSheetsVersion();
 }
 
 const Vector<UIPriorityStyleSheet>& UIControlPackageContext::GetSortedStyleSheets()
@@ -39,14 +53,31 @@ const Vector<UIPriorityStyleSheet>& UIControlPackageContext::GetSortedStyleSheet
     if (!styleSheetsSorted)
     {
         std::sort(styleSheets.begin(), styleSheets.end());
+        styleSheetIndex.Build(styleSheets);
         styleSheetsSorted = true;
     }
 
     return styleSheets;
 }
 
+const UIStyleSheetIndex& UIControlPackageContext::GetStyleSheetIndex()
+{
+    GetSortedStyleSheets();
+    return styleSheetIndex;
+}
+
 int32 UIControlPackageContext::GetMaxStyleSheetHierarchyDepth() const
 {
     return maxStyleSheetHierarchyDepth;
 }
+
+uint32 UIControlPackageContext::GetStyleSheetsVersion() const
+{
+    return styleSheetsVersion;
+}
+
+void UIControlPackageContext::UpdateStyleSheetsVersion()
+{
+    styleSheetsVersion = ++UIControlPackageContextDetails::lastStyleSheetsVersion;
+}
 }
\ No newline at end of file
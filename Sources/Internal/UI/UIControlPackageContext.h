@@ -4,6 +4,7 @@
 #include "Base/BaseObject.h"
 #include "Base/BaseTypes.h"
 #include "UI/Styles/UIPriorityStyleSheet.h"
+#include "UI/Styles/UIStyleSheetIndex.h"
 
 namespace DAVA
 {
@@ -16,17 +17,28 @@ protected:
     virtual ~UIControlPackageContext();
 
 public:
+    UIControlPackageContext();
+
     void AddStyleSheet(const UIPriorityStyleSheet& styleSheet);
     void RemoveAllStyleSheets();
 
     const Vector<UIPriorityStyleSheet>& GetSortedStyleSheets();
+    /** Index of style sheets returned by GetSortedStyleSheets. */
+    const UIStyleSheetIndex& GetStyleSheetIndex();
 
     int32 GetMaxStyleSheetHierarchyDepth() const;
 
+    /** Version is changed on each change of style sheets list and is unique among all contexts. */
+    uint32 GetStyleSheetsVersion() const;
+
 private:
+    void UpdateStyleSheetsVersion();
+
     Vector<UIPriorityStyleSheet> styleSheets;
+    UIStyleSheetIndex styleSheetIndex;
     bool styleSheetsSorted = false;
     int32 maxStyleSheetHierarchyDepth = 0;
+    uint32 styleSheetsVersion = 0;
 };
 };
 
@@ -0,0 +1,639 @@
+#include "UI/UIPackageBinaryReader.h"
+#include "UI/Private/UIPackageBinaryFormat.h"
+
+#include "Base/ScopedPtr.h"
+#include "FileSystem/File.h"
+#include "FileSystem/FileSystem.h"
+#include "FileSystem/YamlNode.h"
+#include "FileSystem/YamlParser.h"
+#include "Logger/Logger.h"
+#include "Reflection/ReflectedTypeDB.h"
+#include "UI/Styles/UIStyleSheetPropertyDataBase.h"
+#include "Utils/CRC32.h"
+#include "Utils/UTF8Utils.h"
+
+namespace DAVA
+{
+namespace UIPackageBinaryReaderDetails
+{
+const ReflectedStructure::Field* FindField(const ReflectedType* type, const FastName& name)
+{
+    if (type != nullptr && type->GetStructure() != nullptr)
+    {
+        for (const std::unique_ptr<ReflectedStructure::Field>& field : type->GetStructure()->fields)
+        {
+            if (field->name == name)
+                return field.get();
+        }
+    }
+    return nullptr;
+}
+
+// file is read by chunks, so it's not loaded into memory as a whole
+bool IsSameContent(const FilePath& path, uint32 size, uint32 crc)
+{
+    ScopedPtr<File> file(File::Create(path, File::OPEN | File::READ));
+    if (!file || file->GetSize() != size)
+        return false;
+
+    CRC32 contentCrc;
+    Array<uint8, 4096> buffer;
+    uint32 readSize = 0;
+    while ((readSize = file->Read(buffer.data(), static_cast<uint32>(buffer.size()))) > 0)
+    {
+        contentCrc.AddData(buffer.data(), readSize);
+    }
+    return contentCrc.Done() == crc;
+}
+}
+
+UIPackageBinaryReader::UIPackageBinaryReader(AbstractUIPackageLoader* importLoader_)
+    : importLoader(importLoader_)
+{
+}
+
+UIPackageBinaryReader::~UIPackageBinaryReader()
+{
+}
+
+FilePath UIPackageBinaryReader::GetBinaryPath(const FilePath& packagePath)
+{
+    return FilePath::CreateWithNewExtension(packagePath, ".uib");
+}
+
+bool UIPackageBinaryReader::Open(const FilePath& packagePath_)
+{
+    using namespace UIPackageBinaryFormat;
+
+    packagePath = FilePath();
+    data.clear();
+    strings.clear();
+    position = 0;
+    commandsBegin = 0;
+    commandsEnd = 0;
+
+    FileSystem* fileSystem = FileSystem::Instance();
+    FilePath binaryPath = GetBinaryPath(packagePath_);
+    if (!fileSystem->Exists(binaryPath) || !fileSystem->ReadFileContents(binaryPath, data))
+        return false;
+
+    commandsEnd = data.size();
+
+    uint32 magic = 0;
+    uint32 version = 0;
+    uint32 flags = 0;
+    uint32 sourceSize = 0;
+    uint32 sourceCrc = 0;
+    uint32 stringsCount = 0;
+    if (!ReadData(magic) || !ReadData(version) || !ReadData(flags) || !ReadData(sourceSize) || !ReadData(sourceCrc) || !ReadData(stringsCount) ||
+        magic != MAGIC || version != VERSION)
+    {
+        Logger::Warning("[UIPackageBinaryReader::Open] Wrong format of %s", binaryPath.GetStringValue().c_str());
+        return false;
+    }
+
+    // content of yaml is compared, as copying and packing of resources don't keep modification dates
+    if ((flags & FLAG_SOURCE_REMOVED) == 0 && !UIPackageBinaryReaderDetails::IsSameContent(packagePath_, sourceSize, sourceCrc))
+    {
+        Logger::Warning("[UIPackageBinaryReader::Open] %s is outdated or its yaml is missing", binaryPath.GetStringValue().c_str());
+        return false;
+    }
+
+    // strings are null-terminated in file, so they are used in place
+    strings.reserve(stringsCount);
+    for (uint32 i = 0; i < stringsCount; i++)
+    {
+        uint32 length = 0;
+        if (!ReadData(length) || position + length >= data.size() || data[position + length] != 0)
+            return false;
+
+        strings.push_back(reinterpret_cast<const char*>(data.data() + position));
+        position += length + 1;
+    }
+
+    uint32 commandsSize = 0;
+    if (!ReadData(commandsSize) || position + commandsSize != data.size())
+        return false;
+
+    commandsBegin = position;
+    packagePath = packagePath_;
+    return true;
+}
+
+bool UIPackageBinaryReader::LoadPackage(const FilePath& packagePath_, AbstractUIPackageBuilder* builder)
+{
+    if (packagePath != packagePath_ && !Open(packagePath_))
+        return false;
+
+    position = commandsBegin;
+    failed = false;
+    return ReplayCommands(builder, UIPackageBinaryFormat::CMD_END_PACKAGE) && !failed;
+}
+
+bool UIPackageBinaryReader::LoadControlByName(const FastName& name, AbstractUIPackageBuilder* builder)
+{
+    // prototypes are recorded right after control, which requested them
+    if (!IsNextPrototype(name))
+        return false;
+
+    bool result = false;
+    if (!ReplayPrototype(builder, result))
+    {
+        failed = true;
+        return false;
+    }
+    return result;
+}
+
+bool UIPackageBinaryReader::ReplayCommands(AbstractUIPackageBuilder* builder, uint8 endCommand)
+{
+    using namespace UIPackageBinaryFormat;
+    using namespace UIPackageBinaryReaderDetails;
+
+    const ReflectedType* sectionType = nullptr;
+
+    uint8 command = 0;
+    while (!failed && ReadData(command))
+    {
+        switch (command)
+        {
+        case CMD_BEGIN_PACKAGE:
+        {
+            int32 version = 0;
+            if (!ReadData(version))
+                return false;
+            builder->BeginPackage(packagePath, version);
+            break;
+        }
+
+        case CMD_END_PACKAGE:
+            builder->EndPackage();
+            return endCommand == CMD_END_PACKAGE;
+
+        case CMD_IMPORTED_PACKAGE:
+        {
+            String importedPackagePath;
+            if (!ReadString(importedPackagePath))
+                return false;
+            builder->ProcessImportedPackage(importedPackagePath, importLoader);
+            break;
+        }
+
+        case CMD_STYLE_SHEET:
+            if (!ReplayStyleSheet(builder))
+                return false;
+            break;
+
+        case CMD_BEGIN_CONTROL_WITH_CLASS:
+        {
+            FastName controlName;
+            String className;
+            if (!ReadFastName(controlName) || !ReadString(className))
+                return false;
+            builder->BeginControlWithClass(controlName, className);
+            break;
+        }
+
+        case CMD_BEGIN_CONTROL_WITH_CUSTOM_CLASS:
+        {
+            FastName controlName;
+            String customClassName;
+            String className;
+            if (!ReadFastName(controlName) || !ReadString(customClassName) || !ReadString(className))
+                return false;
+            builder->BeginControlWithCustomClass(controlName, customClassName, className);
+            break;
+        }
+
+        case CMD_BEGIN_CONTROL_WITH_PROTOTYPE:
+        {
+            FastName controlName;
+            String packageName;
+            FastName prototypeName;
+            uint8 hasCustomClass = 0;
+            String customClassName;
+            if (!ReadFastName(controlName) || !ReadString(packageName) || !ReadFastName(prototypeName) || !ReadData(hasCustomClass))
+                return false;
+            if (hasCustomClass != 0 && !ReadString(customClassName))
+                return false;
+            builder->BeginControlWithPrototype(controlName, packageName, prototypeName, hasCustomClass != 0 ? &customClassName : nullptr, this);
+            break;
+        }
+
+        case CMD_BEGIN_CONTROL_WITH_PATH:
+        {
+            String pathName;
+            if (!ReadString(pathName))
+                return false;
+            builder->BeginControlWithPath(pathName);
+            break;
+        }
+
+        case CMD_END_CONTROL:
+        {
+            uint8 controlPlace = 0;
+            if (!ReadData(controlPlace))
+                return false;
+            builder->EndControl(static_cast<AbstractUIPackageBuilder::eControlPlace>(controlPlace));
+            break;
+        }
+
+        case CMD_BEGIN_CONTROL_PROPERTIES_SECTION:
+        {
+            String name;
+            if (!ReadString(name))
+                return false;
+            sectionType = ReflectedTypeDB::GetByPermanentName(name);
+            builder->BeginControlPropertiesSection(name);
+            break;
+        }
+
+        case CMD_END_CONTROL_PROPERTIES_SECTION:
+            builder->EndControlPropertiesSection();
+            sectionType = nullptr;
+            break;
+
+        case CMD_BEGIN_COMPONENT_PROPERTIES_SECTION:
+        {
+            String componentName;
+            uint32 componentIndex = 0;
+            if (!ReadString(componentName) || !ReadData(componentIndex))
+                return false;
+
+            const ReflectedType* componentRef = ReflectedTypeDB::GetByPermanentName(componentName);
+            if (componentRef == nullptr)
+            {
+                Logger::Error("[UIPackageBinaryReader::ReplayCommands] Unknown component %s", componentName.c_str());
+                return false;
+            }
+            sectionType = builder->BeginComponentPropertiesSection(componentRef->GetType(), componentIndex);
+            break;
+        }
+
+        case CMD_END_COMPONENT_PROPERTIES_SECTION:
+            builder->EndComponentPropertiesSection();
+            sectionType = nullptr;
+            break;
+
+        case CMD_PROPERTY:
+        {
+            FastName fieldName;
+            if (!ReadFastName(fieldName))
+                return false;
+
+            const ReflectedStructure::Field* field = FindField(sectionType, fieldName);
+            Any value;
+            if (!ReadValue(field, value))
+                return false;
+
+            if (field != nullptr)
+            {
+                builder->ProcessProperty(*field, value);
+            }
+            else
+            {
+                Logger::Warning("[UIPackageBinaryReader::ReplayCommands] Unknown property %s in %s", fieldName.c_str(), packagePath.GetStringValue().c_str());
+            }
+            break;
+        }
+
+        case CMD_DATA_BINDING:
+        {
+            String fieldName;
+            String expression;
+            int32 bindingMode = 0;
+            if (!ReadString(fieldName) || !ReadString(expression) || !ReadData(bindingMode))
+                return false;
+            builder->ProcessDataBinding(fieldName, expression, bindingMode);
+            break;
+        }
+
+        case CMD_CUSTOM_DATA:
+        {
+            String text;
+            if (!ReadString(text))
+                return false;
+
+            RefPtr<YamlParser> parser(YamlParser::CreateAndParseString(text));
+            if (parser.Valid() && parser->GetRootNode() != nullptr)
+            {
+                builder->ProcessCustomData(parser->GetRootNode());
+            }
+            break;
+        }
+
+        case CMD_LOAD_CONTROL_BY_NAME:
+        {
+            // prototype, which was requested while package was compiled, is loaded even if current builder didn't request it
+            bool result = false;
+            position -= sizeof(command);
+            if (!ReplayPrototype(builder, result))
+                return false;
+            break;
+        }
+
+        case CMD_END_LOAD_CONTROL_BY_NAME:
+            return endCommand == CMD_END_LOAD_CONTROL_BY_NAME;
+
+        default:
+            Logger::Error("[UIPackageBinaryReader::ReplayCommands] Unknown command %u in %s", command, packagePath.GetStringValue().c_str());
+            return false;
+        }
+    }
+
+    return false;
+}
+
+bool UIPackageBinaryReader::ReplayStyleSheet(AbstractUIPackageBuilder* builder)
+{
+    const UIStyleSheetPropertyDataBase* propertyDB = UIStyleSheetPropertyDataBase::Instance();
+
+    uint32 chainsCount = 0;
+    if (!ReadData(chainsCount))
+        return false;
+
+    Vector<UIStyleSheetSelectorChain> selectorChains;
+    selectorChains.reserve(chainsCount);
+    for (uint32 i = 0; i < chainsCount; i++)
+    {
+        String selector;
+        if (!ReadString(selector))
+            return false;
+        selectorChains.push_back(UIStyleSheetSelectorChain(selector));
+    }
+
+    uint32 propertiesCount = 0;
+    if (!ReadData(propertiesCount))
+        return false;
+
+    Vector<UIStyleSheetProperty> properties;
+    properties.reserve(propertiesCount);
+    for (uint32 i = 0; i < propertiesCount; i++)
+    {
+        FastName propertyName;
+        if (!ReadFastName(propertyName))
+            return false;
+
+        const ReflectedStructure::Field* field = nullptr;
+        uint32 propertyIndex = 0;
+        if (propertyDB->IsValidStyleSheetProperty(propertyName))
+        {
+            propertyIndex = propertyDB->GetStyleSheetPropertyIndex(propertyName);
+            field = propertyDB->GetStyleSheetPropertyByIndex(propertyIndex).field;
+        }
+
+        Any value;
+        uint8 transition = 0;
+        int32 transitionFunction = Interpolation::LINEAR;
+        float32 transitionTime = 0.0f;
+        if (!ReadValue(field, value) || !ReadData(transition) || !ReadData(transitionFunction) || !ReadData(transitionTime))
+            return false;
+
+        if (field != nullptr)
+        {
+            properties.push_back(UIStyleSheetProperty(propertyIndex, value, transition != 0, static_cast<Interpolation::FuncType>(transitionFunction), transitionTime));
+        }
+        else
+        {
+            Logger::Error("Unknown property name: %s", propertyName.c_str());
+        }
+    }
+
+    builder->ProcessStyleSheet(selectorChains, properties);
+    return true;
+}
+
+bool UIPackageBinaryReader::ReplayPrototype(AbstractUIPackageBuilder* builder, bool& result)
+{
+    uint8 command = 0;
+    FastName name;
+    uint8 loaded = 0;
+    if (!ReadData(command) || command != UIPackageBinaryFormat::CMD_LOAD_CONTROL_BY_NAME || !ReadFastName(name))
+        return false;
+
+    if (!ReplayCommands(builder, UIPackageBinaryFormat::CMD_END_LOAD_CONTROL_BY_NAME) || !ReadData(loaded))
+        return false;
+
+    result = (loaded != 0);
+    return true;
+}
+
+bool UIPackageBinaryReader::IsNextPrototype(const FastName& name)
+{
+    size_t savedPosition = position;
+
+    uint8 command = 0;
+    FastName nextName;
+    bool isPrototype = ReadData(command) && command == UIPackageBinaryFormat::CMD_LOAD_CONTROL_BY_NAME && ReadFastName(nextName) && nextName == name;
+
+    position = savedPosition;
+    return isPrototype;
+}
+
+bool UIPackageBinaryReader::ReadString(const char*& string)
+{
+    uint32 index = 0;
+    if (!ReadData(index) || index >= strings.size())
+        return false;
+
+    string = strings[index];
+    return true;
+}
+
+bool UIPackageBinaryReader::ReadString(String& string)
+{
+    const char* value = nullptr;
+    if (!ReadString(value))
+        return false;
+
+    string = value;
+    return true;
+}
+
+bool UIPackageBinaryReader::ReadFastName(FastName& name)
+{
+    uint32 index = 0;
+    if (!ReadData(index))
+        return false;
+
+    if (index == UIPackageBinaryFormat::INVALID_STRING)
+    {
+        name = FastName();
+        return true;
+    }
+
+    if (index >= strings.size())
+        return false;
+
+    name = FastName(strings[index]);
+    return true;
+}
+
+bool UIPackageBinaryReader::ReadValue(const ReflectedStructure::Field* field, Any& value)
+{
+    using namespace UIPackageBinaryFormat;
+
+    uint8 tag = 0;
+    if (!ReadData(tag))
+        return false;
+
+    switch (tag)
+    {
+    case VALUE_EMPTY:
+        value = Any();
+        return true;
+
+    case VALUE_BOOL:
+    {
+        uint8 v = 0;
+        if (!ReadData(v))
+            return false;
+        value = Any(v != 0);
+        return true;
+    }
+
+    case VALUE_INT32:
+    {
+        int32 v = 0;
+        if (!ReadData(v))
+            return false;
+        value = Any(v);
+        return true;
+    }
+
+    case VALUE_UINT32:
+    {
+        uint32 v = 0;
+        if (!ReadData(v))
+            return false;
+        value = Any(v);
+        return true;
+    }
+
+    case VALUE_INT64:
+    {
+        int64 v = 0;
+        if (!ReadData(v))
+            return false;
+        value = Any(v);
+        return true;
+    }
+
+    case VALUE_UINT64:
+    {
+        uint64 v = 0;
+        if (!ReadData(v))
+            return false;
+        value = Any(v);
+        return true;
+    }
+
+    case VALUE_FLOAT32:
+    {
+        float32 v = 0.0f;
+        if (!ReadData(v))
+            return false;
+        value = Any(v);
+        return true;
+    }
+
+    case VALUE_FASTNAME:
+    {
+        FastName v;
+        if (!ReadFastName(v))
+            return false;
+        value = Any(v);
+        return true;
+    }
+
+    case VALUE_STRING:
+    {
+        String v;
+        if (!ReadString(v))
+            return false;
+        value = Any(v);
+        return true;
+    }
+
+    case VALUE_WIDESTRING:
+    {
+        String v;
+        if (!ReadString(v))
+            return false;
+        value = Any(UTF8Utils::EncodeToWideString(v));
+        return true;
+    }
+
+    case VALUE_VECTOR2:
+    {
+        Vector2 v;
+        if (!ReadData(v.x) || !ReadData(v.y))
+            return false;
+        value = Any(v);
+        return true;
+    }
+
+    case VALUE_VECTOR3:
+    {
+        Vector3 v;
+        if (!ReadData(v.x) || !ReadData(v.y) || !ReadData(v.z))
+            return false;
+        value = Any(v);
+        return true;
+    }
+
+    case VALUE_VECTOR4:
+    {
+        Vector4 v;
+        if (!ReadData(v.x) || !ReadData(v.y) || !ReadData(v.z) || !ReadData(v.w))
+            return false;
+        value = Any(v);
+        return true;
+    }
+
+    case VALUE_COLOR:
+    {
+        Color v;
+        if (!ReadData(v.r) || !ReadData(v.g) || !ReadData(v.b) || !ReadData(v.a))
+            return false;
+        value = Any(v);
+        return true;
+    }
+
+    case VALUE_RECT:
+    {
+        Rect v;
+        if (!ReadData(v.x) || !ReadData(v.y) || !ReadData(v.dx) || !ReadData(v.dy))
+            return false;
+        value = Any(v);
+        return true;
+    }
+
+    case VALUE_FILEPATH:
+    {
+        String v;
+        if (!ReadString(v))
+            return false;
+        value = Any(FilePath(v));
+        return true;
+    }
+
+    case VALUE_ENUM:
+    {
+        int32 v = 0;
+        if (!ReadData(v))
+            return false;
+
+        // enums are stored as in yaml loader: int32 value with type of field
+        if (field != nullptr)
+            value = Any(v).ReinterpretCast(field->valueWrapper->GetType(ReflectedObject())->Decay());
+        else
+            value = Any(v);
+        return true;
+    }
+
+    default:
+        return false;
+    }
+}
+}
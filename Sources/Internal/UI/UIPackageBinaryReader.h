@@ -0,0 +1,65 @@
+#pragma once
+
+#include "UI/AbstractUIPackageBuilder.h"
+#include "FileSystem/FilePath.h"
+
+namespace DAVA
+{
+/**
+    Loads compiled UI package (see UIPackageBinaryWriter) by replaying recorded builder calls,
+    so neither yaml parsing nor tree of yaml nodes is needed. Compiled package is placed next to
+    yaml package with extension ".uib" and is used only while it's actual for yaml package.
+    Package is actual if size and CRC32 of yaml are the same as at compilation, yaml is read for that but isn't parsed.
+    Package compiled with removal of yaml is used as is.
+    Imported packages are loaded by importLoader.
+*/
+class UIPackageBinaryReader : public AbstractUIPackageLoader
+{
+public:
+    UIPackageBinaryReader(AbstractUIPackageLoader* importLoader);
+    ~UIPackageBinaryReader() override;
+
+    static FilePath GetBinaryPath(const FilePath& packagePath);
+
+    /** Read compiled package for packagePath. Returns false if there is no compiled package, it's corrupted or outdated. */
+    bool Open(const FilePath& packagePath);
+
+    bool LoadPackage(const FilePath& packagePath, AbstractUIPackageBuilder* builder) override;
+    bool LoadControlByName(const FastName& name, AbstractUIPackageBuilder* builder) override;
+
+private:
+    bool ReplayCommands(AbstractUIPackageBuilder* builder, uint8 endCommand);
+    bool ReplayStyleSheet(AbstractUIPackageBuilder* builder);
+    bool ReplayPrototype(AbstractUIPackageBuilder* builder, bool& result);
+    bool IsNextPrototype(const FastName& name);
+
+    bool ReadString(const char*& string);
+    bool ReadString(String& string);
+    bool ReadFastName(FastName& name);
+    bool ReadValue(const ReflectedStructure::Field* field, Any& value);
+
+    template <typename T>
+    bool ReadData(T& data);
+
+    AbstractUIPackageLoader* importLoader = nullptr;
+    FilePath packagePath;
+
+    Vector<uint8> data;
+    Vector<const char*> strings;
+    size_t commandsBegin = 0;
+    size_t commandsEnd = 0;
+    size_t position = 0;
+    bool failed = false;
+};
+
+template <typename T>
+bool UIPackageBinaryReader::ReadData(T& value)
+{
+    if (position + sizeof(T) > commandsEnd)
+        return false;
+
+    Memcpy(&value, data.data() + position, sizeof(T));
+    position += sizeof(T);
+    return true;
+}
+}
@@ -0,0 +1,450 @@
+#include "UI/UIPackageBinaryWriter.h"
+#include "UI/Private/UIPackageBinaryFormat.h"
+
+#include "Base/ScopedPtr.h"
+#include "Debug/DVAssert.h"
+#include "FileSystem/DynamicMemoryFile.h"
+#include "FileSystem/File.h"
+#include "FileSystem/FileSystem.h"
+#include "FileSystem/YamlEmitter.h"
+#include "FileSystem/YamlNode.h"
+#include "FileSystem/YamlParser.h"
+#include "Logger/Logger.h"
+#include "Reflection/ReflectedTypeDB.h"
+#include "UI/DefaultUIPackageBuilder.h"
+#include "UI/Styles/UIStyleSheetPropertyDataBase.h"
+#include "UI/UIPackage.h"
+#include "UI/UIPackageLoader.h"
+#include "Utils/CRC32.h"
+#include "Utils/UTF8Utils.h"
+
+namespace DAVA
+{
+UIPackageBinaryWriter::UIPackageBinaryWriter(AbstractUIPackageBuilder* builder_, AbstractUIPackageLoader* loader_)
+    : builder(builder_)
+    , loader(loader_)
+{
+}
+
+UIPackageBinaryWriter::~UIPackageBinaryWriter()
+{
+}
+
+bool UIPackageBinaryWriter::Compile(const FilePath& packagePath, const FilePath& binaryPath, bool sourceRemoved)
+{
+    RefPtr<YamlParser> parser(YamlParser::Create(packagePath));
+    if (!parser.Valid())
+    {
+        Logger::Error("[UIPackageBinaryWriter::Compile] Can't parse %s", packagePath.GetStringValue().c_str());
+        return false;
+    }
+
+    DefaultUIPackageBuilder packageBuilder;
+    UIPackageLoader packageLoader;
+    UIPackageBinaryWriter writer(&packageBuilder, &packageLoader);
+
+    // yaml is loaded directly, so previously compiled package is not used as source
+    YamlNode* rootNode = parser->GetRootNode();
+    if (rootNode != nullptr)
+    {
+        if (!packageLoader.LoadPackage(rootNode, packagePath, &writer))
+        {
+            Logger::Error("[UIPackageBinaryWriter::Compile] Can't load %s", packagePath.GetStringValue().c_str());
+            return false;
+        }
+    }
+    else
+    {
+        writer.BeginPackage(packagePath, UIPackage::CURRENT_VERSION);
+        writer.EndPackage();
+    }
+
+    if (writer.HasErrors())
+    {
+        Logger::Error("[UIPackageBinaryWriter::Compile] Package %s can't be compiled", packagePath.GetStringValue().c_str());
+        return false;
+    }
+
+    return writer.Save(binaryPath, packagePath, sourceRemoved);
+}
+
+bool UIPackageBinaryWriter::Save(const FilePath& binaryPath, const FilePath& sourcePath, bool sourceRemoved) const
+{
+    using namespace UIPackageBinaryFormat;
+
+    uint64 sourceSize = 0;
+    if (!FileSystem::Instance()->GetFileSize(sourcePath, sourceSize))
+    {
+        return false;
+    }
+    uint32 sourceCrc = CRC32::ForFile(sourcePath);
+    uint32 flags = sourceRemoved ? FLAG_SOURCE_REMOVED : 0;
+
+    ScopedPtr<File> file(File::Create(binaryPath, File::CREATE | File::WRITE));
+    if (!file)
+    {
+        Logger::Error("[UIPackageBinaryWriter::Save] Can't create %s", binaryPath.GetStringValue().c_str());
+        return false;
+    }
+
+    uint32 header[] = { MAGIC, VERSION, flags, static_cast<uint32>(sourceSize), sourceCrc };
+    bool written = (file->Write(header, sizeof(header)) == sizeof(header));
+
+    uint32 stringsCount = static_cast<uint32>(strings.size());
+    written = written && (file->Write(&stringsCount, sizeof(stringsCount)) == sizeof(stringsCount));
+
+    for (const String& string : strings)
+    {
+        uint32 length = static_cast<uint32>(string.size());
+        written = written && (file->Write(&length, sizeof(length)) == sizeof(length));
+        written = written && (file->Write(string.c_str(), length + 1) == length + 1);
+    }
+
+    uint32 commandsSize = static_cast<uint32>(commands.size());
+    written = written && (file->Write(&commandsSize, sizeof(commandsSize)) == sizeof(commandsSize));
+    written = written && (file->Write(commands.data(), commandsSize) == commandsSize);
+
+    if (!written)
+    {
+        Logger::Error("[UIPackageBinaryWriter::Save] Can't write %s", binaryPath.GetStringValue().c_str());
+    }
+    return written;
+}
+
+bool UIPackageBinaryWriter::HasErrors() const
+{
+    return hasErrors;
+}
+
+bool UIPackageBinaryWriter::LoadPackage(const FilePath& packagePath, AbstractUIPackageBuilder* builder_)
+{
+    return loader->LoadPackage(packagePath, builder_);
+}
+
+bool UIPackageBinaryWriter::LoadControlByName(const FastName& name, AbstractUIPackageBuilder* builder_)
+{
+    DVASSERT(builder_ == builder);
+
+    // calls of builder made while prototype is loaded are recorded inside of this command
+    WriteCommand(UIPackageBinaryFormat::CMD_LOAD_CONTROL_BY_NAME);
+    WriteFastName(name);
+    bool result = loader->LoadControlByName(name, this);
+    WriteCommand(UIPackageBinaryFormat::CMD_END_LOAD_CONTROL_BY_NAME);
+    WriteData(static_cast<uint8>(result));
+    return result;
+}
+
+void UIPackageBinaryWriter::BeginPackage(const FilePath& packagePath, int32 version)
+{
+    WriteCommand(UIPackageBinaryFormat::CMD_BEGIN_PACKAGE);
+    WriteData(version);
+    builder->BeginPackage(packagePath, version);
+}
+
+void UIPackageBinaryWriter::EndPackage()
+{
+    WriteCommand(UIPackageBinaryFormat::CMD_END_PACKAGE);
+    builder->EndPackage();
+}
+
+bool UIPackageBinaryWriter::ProcessImportedPackage(const String& packagePath, AbstractUIPackageLoader* loader_)
+{
+    WriteCommand(UIPackageBinaryFormat::CMD_IMPORTED_PACKAGE);
+    WriteString(packagePath);
+    return builder->ProcessImportedPackage(packagePath, loader_);
+}
+
+void UIPackageBinaryWriter::ProcessStyleSheet(const Vector<UIStyleSheetSelectorChain>& selectorChains, const Vector<UIStyleSheetProperty>& properties)
+{
+    const UIStyleSheetPropertyDataBase* propertyDB = UIStyleSheetPropertyDataBase::Instance();
+
+    WriteCommand(UIPackageBinaryFormat::CMD_STYLE_SHEET);
+    WriteData(static_cast<uint32>(selectorChains.size()));
+    for (const UIStyleSheetSelectorChain& chain : selectorChains)
+    {
+        WriteString(chain.ToString());
+    }
+
+    // properties are written by name, since their indices depend on registered components
+    WriteData(static_cast<uint32>(properties.size()));
+    for (const UIStyleSheetProperty& property : properties)
+    {
+        WriteString(propertyDB->GetStyleSheetPropertyByIndex(property.propertyIndex).GetFullName());
+        WriteValue(property.value);
+        WriteData(static_cast<uint8>(property.transition));
+        WriteData(static_cast<int32>(property.transitionFunction));
+        WriteData(property.transitionTime);
+    }
+
+    builder->ProcessStyleSheet(selectorChains, properties);
+}
+
+const ReflectedType* UIPackageBinaryWriter::BeginControlWithClass(const FastName& controlName, const String& className)
+{
+    WriteCommand(UIPackageBinaryFormat::CMD_BEGIN_CONTROL_WITH_CLASS);
+    WriteFastName(controlName);
+    WriteString(className);
+    return builder->BeginControlWithClass(controlName, className);
+}
+
+const ReflectedType* UIPackageBinaryWriter::BeginControlWithCustomClass(const FastName& controlName, const String& customClassName, const String& className)
+{
+    WriteCommand(UIPackageBinaryFormat::CMD_BEGIN_CONTROL_WITH_CUSTOM_CLASS);
+    WriteFastName(controlName);
+    WriteString(customClassName);
+    WriteString(className);
+    return builder->BeginControlWithCustomClass(controlName, customClassName, className);
+}
+
+const ReflectedType* UIPackageBinaryWriter::BeginControlWithPrototype(const FastName& controlName, const String& packageName, const FastName& prototypeName, const String* customClassName, AbstractUIPackageLoader* loader_)
+{
+    WriteCommand(UIPackageBinaryFormat::CMD_BEGIN_CONTROL_WITH_PROTOTYPE);
+    WriteFastName(controlName);
+    WriteString(packageName);
+    WriteFastName(prototypeName);
+    WriteData(static_cast<uint8>(customClassName != nullptr));
+    if (customClassName != nullptr)
+    {
+        WriteString(*customClassName);
+    }
+
+    // builder requests prototypes from writer, so they are recorded
+    return builder->BeginControlWithPrototype(controlName, packageName, prototypeName, customClassName, this);
+}
+
+const ReflectedType* UIPackageBinaryWriter::BeginControlWithPath(const String& pathName)
+{
+    WriteCommand(UIPackageBinaryFormat::CMD_BEGIN_CONTROL_WITH_PATH);
+    WriteString(pathName);
+    return builder->BeginControlWithPath(pathName);
+}
+
+const ReflectedType* UIPackageBinaryWriter::BeginUnknownControl(const FastName& controlName, const YamlNode* node)
+{
+    Logger::Error("[UIPackageBinaryWriter::BeginUnknownControl] Control %s has neither class nor prototype", controlName.c_str());
+    hasErrors = true;
+    return builder->BeginUnknownControl(controlName, node);
+}
+
+void UIPackageBinaryWriter::EndControl(eControlPlace controlPlace)
+{
+    WriteCommand(UIPackageBinaryFormat::CMD_END_CONTROL);
+    WriteData(static_cast<uint8>(controlPlace));
+    builder->EndControl(controlPlace);
+}
+
+void UIPackageBinaryWriter::BeginControlPropertiesSection(const String& name)
+{
+    WriteCommand(UIPackageBinaryFormat::CMD_BEGIN_CONTROL_PROPERTIES_SECTION);
+    WriteString(name);
+    builder->BeginControlPropertiesSection(name);
+}
+
+void UIPackageBinaryWriter::EndControlPropertiesSection()
+{
+    WriteCommand(UIPackageBinaryFormat::CMD_END_CONTROL_PROPERTIES_SECTION);
+    builder->EndControlPropertiesSection();
+}
+
+const ReflectedType* UIPackageBinaryWriter::BeginComponentPropertiesSection(const Type* componentType, uint32 componentIndex)
+{
+    const ReflectedType* componentRef = ReflectedTypeDB::GetByType(componentType);
+    if (componentRef == nullptr || componentRef->GetPermanentName().empty())
+    {
+        Logger::Error("[UIPackageBinaryWriter::BeginComponentPropertiesSection] Component %s has no permanent name", componentType->GetName());
+        hasErrors = true;
+    }
+    else
+    {
+        WriteCommand(UIPackageBinaryFormat::CMD_BEGIN_COMPONENT_PROPERTIES_SECTION);
+        WriteString(componentRef->GetPermanentName());
+        WriteData(componentIndex);
+    }
+    return builder->BeginComponentPropertiesSection(componentType, componentIndex);
+}
+
+void UIPackageBinaryWriter::EndComponentPropertiesSection()
+{
+    WriteCommand(UIPackageBinaryFormat::CMD_END_COMPONENT_PROPERTIES_SECTION);
+    builder->EndComponentPropertiesSection();
+}
+
+void UIPackageBinaryWriter::ProcessProperty(const ReflectedStructure::Field& field, const Any& value)
+{
+    WriteCommand(UIPackageBinaryFormat::CMD_PROPERTY);
+    WriteFastName(field.name);
+    WriteValue(value);
+    builder->ProcessProperty(field, value);
+}
+
+void UIPackageBinaryWriter::ProcessDataBinding(const String& fieldName, const String& expression, int32 bindingMode)
+{
+    WriteCommand(UIPackageBinaryFormat::CMD_DATA_BINDING);
+    WriteString(fieldName);
+    WriteString(expression);
+    WriteData(bindingMode);
+    builder->ProcessDataBinding(fieldName, expression, bindingMode);
+}
+
+void UIPackageBinaryWriter::ProcessCustomData(const YamlNode* customDataNode)
+{
+    // custom data is free-form, so it is kept as yaml text
+    ScopedPtr<DynamicMemoryFile> file(DynamicMemoryFile::Create(File::CREATE | File::WRITE));
+    if (YamlEmitter::SaveToYamlFile(customDataNode, file))
+    {
+        const Vector<uint8>& data = file->GetDataVector();
+        WriteCommand(UIPackageBinaryFormat::CMD_CUSTOM_DATA);
+        WriteString(String(data.begin(), data.end()));
+    }
+    else
+    {
+        Logger::Error("[UIPackageBinaryWriter::ProcessCustomData] Can't save custom data");
+        hasErrors = true;
+    }
+    builder->ProcessCustomData(customDataNode);
+}
+
+void UIPackageBinaryWriter::WriteCommand(uint8 command)
+{
+    WriteData(command);
+}
+
+void UIPackageBinaryWriter::WriteString(const String& string)
+{
+    auto it = stringIndices.find(string);
+    if (it == stringIndices.end())
+    {
+        it = stringIndices.emplace(string, static_cast<uint32>(strings.size())).first;
+        strings.push_back(string);
+    }
+    WriteData(it->second);
+}
+
+void UIPackageBinaryWriter::WriteFastName(const FastName& name)
+{
+    if (name.IsValid())
+    {
+        WriteString(String(name.c_str()));
+    }
+    else
+    {
+        WriteData(UIPackageBinaryFormat::INVALID_STRING);
+    }
+}
+
+void UIPackageBinaryWriter::WriteValue(const Any& value)
+{
+    using namespace UIPackageBinaryFormat;
+
+    if (value.IsEmpty())
+    {
+        WriteData(static_cast<uint8>(VALUE_EMPTY));
+        return;
+    }
+
+    const Type* type = value.GetType();
+    if (type->IsEnum())
+    {
+        WriteData(static_cast<uint8>(VALUE_ENUM));
+        WriteData(value.ReinterpretCast(Type::Instance<int32>()).Get<int32>());
+    }
+    else if (type == Type::Instance<bool>())
+    {
+        WriteData(static_cast<uint8>(VALUE_BOOL));
+        WriteData(static_cast<uint8>(value.Get<bool>()));
+    }
+    else if (type == Type::Instance<int32>())
+    {
+        WriteData(static_cast<uint8>(VALUE_INT32));
+        WriteData(value.Get<int32>());
+    }
+    else if (type == Type::Instance<uint32>())
+    {
+        WriteData(static_cast<uint8>(VALUE_UINT32));
+        WriteData(value.Get<uint32>());
+    }
+    else if (type == Type::Instance<int64>())
+    {
+        WriteData(static_cast<uint8>(VALUE_INT64));
+        WriteData(value.Get<int64>());
+    }
+    else if (type == Type::Instance<uint64>())
+    {
+        WriteData(static_cast<uint8>(VALUE_UINT64));
+        WriteData(value.Get<uint64>());
+    }
+    else if (type == Type::Instance<float32>())
+    {
+        WriteData(static_cast<uint8>(VALUE_FLOAT32));
+        WriteData(value.Get<float32>());
+    }
+    else if (type == Type::Instance<FastName>())
+    {
+        WriteData(static_cast<uint8>(VALUE_FASTNAME));
+        WriteFastName(value.Get<FastName>());
+    }
+    else if (type == Type::Instance<String>())
+    {
+        WriteData(static_cast<uint8>(VALUE_STRING));
+        WriteString(value.Get<String>());
+    }
+    else if (type == Type::Instance<WideString>())
+    {
+        WriteData(static_cast<uint8>(VALUE_WIDESTRING));
+        WriteString(UTF8Utils::EncodeToUTF8(value.Get<WideString>()));
+    }
+    else if (type == Type::Instance<Vector2>())
+    {
+        const Vector2& v = value.Get<Vector2>();
+        WriteData(static_cast<uint8>(VALUE_VECTOR2));
+        WriteData(v.x);
+        WriteData(v.y);
+    }
+    else if (type == Type::Instance<Vector3>())
+    {
+        const Vector3& v = value.Get<Vector3>();
+        WriteData(static_cast<uint8>(VALUE_VECTOR3));
+        WriteData(v.x);
+        WriteData(v.y);
+        WriteData(v.z);
+    }
+    else if (type == Type::Instance<Vector4>())
+    {
+        const Vector4& v = value.Get<Vector4>();
+        WriteData(static_cast<uint8>(VALUE_VECTOR4));
+        WriteData(v.x);
+        WriteData(v.y);
+        WriteData(v.z);
+        WriteData(v.w);
+    }
+    else if (type == Type::Instance<Color>())
+    {
+        const Color& c = value.Get<Color>();
+        WriteData(static_cast<uint8>(VALUE_COLOR));
+        WriteData(c.r);
+        WriteData(c.g);
+        WriteData(c.b);
+        WriteData(c.a);
+    }
+    else if (type == Type::Instance<Rect>())
+    {
+        const Rect& r = value.Get<Rect>();
+        WriteData(static_cast<uint8>(VALUE_RECT));
+        WriteData(r.x);
+        WriteData(r.y);
+        WriteData(r.dx);
+        WriteData(r.dy);
+    }
+    else if (type == Type::Instance<FilePath>())
+    {
+        WriteData(static_cast<uint8>(VALUE_FILEPATH));
+        WriteString(value.Get<FilePath>().GetStringValue());
+    }
+    else
+    {
+        Logger::Error("[UIPackageBinaryWriter::WriteValue] Unsupported value type %s", type->GetName());
+        WriteData(static_cast<uint8>(VALUE_EMPTY));
+        hasErrors = true;
+    }
+}
+}
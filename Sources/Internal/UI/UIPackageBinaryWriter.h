@@ -0,0 +1,82 @@
+#pragma once
+
+#include "UI/AbstractUIPackageBuilder.h"
+#include "FileSystem/FilePath.h"
+
+namespace DAVA
+{
+/**
+    Compiles yaml UI package into binary format loaded by UIPackageBinaryReader.
+    Writer is passed to UIPackageLoader as builder, records all calls and forwards them to the wrapped builder,
+    which provides reflected types of created controls and components. Prototypes loaded on demand are recorded
+    in place where they were requested, so reader can replay them without queue of yaml nodes.
+*/
+class UIPackageBinaryWriter : public AbstractUIPackageBuilder, public AbstractUIPackageLoader
+{
+public:
+    UIPackageBinaryWriter(AbstractUIPackageBuilder* builder, AbstractUIPackageLoader* loader);
+    ~UIPackageBinaryWriter() override;
+
+    /**
+        Load package from yaml with DefaultUIPackageBuilder and save recorded calls to binaryPath.
+        With `sourceRemoved` compiled package is used without checking yaml, which caller is to remove from resources.
+    */
+    static bool Compile(const FilePath& packagePath, const FilePath& binaryPath, bool sourceRemoved = false);
+
+    bool Save(const FilePath& binaryPath, const FilePath& sourcePath, bool sourceRemoved) const;
+    bool HasErrors() const;
+
+    // AbstractUIPackageLoader
+    bool LoadPackage(const FilePath& packagePath, AbstractUIPackageBuilder* builder) override;
+    bool LoadControlByName(const FastName& name, AbstractUIPackageBuilder* builder) override;
+
+    // AbstractUIPackageBuilder
+    void BeginPackage(const FilePath& packagePath, int32 version) override;
+    void EndPackage() override;
+
+    bool ProcessImportedPackage(const String& packagePath, AbstractUIPackageLoader* loader) override;
+    void ProcessStyleSheet(const Vector<UIStyleSheetSelectorChain>& selectorChains, const Vector<UIStyleSheetProperty>& properties) override;
+
+    const ReflectedType* BeginControlWithClass(const FastName& controlName, const String& className) override;
+    const ReflectedType* BeginControlWithCustomClass(const FastName& controlName, const String& customClassName, const String& className) override;
+    const ReflectedType* BeginControlWithPrototype(const FastName& controlName, const String& packageName, const FastName& prototypeName, const String* customClassName, AbstractUIPackageLoader* loader) override;
+    const ReflectedType* BeginControlWithPath(const String& pathName) override;
+    const ReflectedType* BeginUnknownControl(const FastName& controlName, const YamlNode* node) override;
+    void EndControl(eControlPlace controlPlace) override;
+
+    void BeginControlPropertiesSection(const String& name) override;
+    void EndControlPropertiesSection() override;
+
+    const ReflectedType* BeginComponentPropertiesSection(const Type* componentType, uint32 componentIndex) override;
+    void EndComponentPropertiesSection() override;
+
+    void ProcessProperty(const ReflectedStructure::Field& field, const Any& value) override;
+    void ProcessDataBinding(const String& fieldName, const String& expression, int32 bindingMode) override;
+
+    void ProcessCustomData(const YamlNode* customDataNode) override;
+
+private:
+    void WriteCommand(uint8 command);
+    void WriteString(const String& string);
+    void WriteFastName(const FastName& name);
+    void WriteValue(const Any& value);
+
+    template <typename T>
+    void WriteData(const T& data);
+
+    AbstractUIPackageBuilder* builder = nullptr;
+    AbstractUIPackageLoader* loader = nullptr;
+
+    Vector<uint8> commands;
+    Vector<String> strings;
+    UnorderedMap<String, uint32> stringIndices;
+    bool hasErrors = false;
+};
+
+template <typename T>
+void UIPackageBinaryWriter::WriteData(const T& data)
+{
+    const uint8* bytes = reinterpret_cast<const uint8*>(&data);
+    commands.insert(commands.end(), bytes, bytes + sizeof(T));
+}
+}
@@ -15,6 +15,7 @@
 #include "UI/Text/UITextComponent.h"
 #include "UI/UIControlHelpers.h"
 #include "UI/UIPackage.h"
+#include "UI/UIPackageBinaryReader.h"
 #include "UI/Components/UIComponent.h"
 #include "UI/DataBinding/UIDataBindingComponent.h"
 #include "UI/Layouts/UIAnchorComponent.h"
@@ -85,6 +86,11 @@ bool UIPackageLoader::LoadPackage(const FilePath& packagePath, AbstractUIPackage
         loadingQueue.clear();
     }
 
+    // compiled package is loaded by replaying builder calls without parsing yaml
+    UIPackageBinaryReader binaryReader(this);
+    if (binaryReader.Open(packagePath))
+        return binaryReader.LoadPackage(packagePath, builder);
+
     if (!FileSystem::Instance()->Exists(packagePath))
         return false;
 